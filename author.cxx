@@ -93,6 +93,7 @@ int main()
 
     initThreadQueue(0);
 
+    importModule(builtinModuleDescriptor());
     importModule(testModuleDescriptor());
     process();
 
@@ -0,0 +1,334 @@
+/* Copyright 2023 Tyler Riddle
+ *
+ * This file is part of Clypsalot. Clypsalot is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU Lesser General Public License as published by the Free Software Foundation, either version 3 of the License,
+ * or (at your option) any later version. Clypsalot is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along with Clypsalot. If not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+
+#include <atomic>
+#include <mutex>
+#include <sstream>
+#include <string_view>
+#include <unordered_map>
+
+#include <clypsalot/array.hxx>
+#include <clypsalot/error.hxx>
+#include <clypsalot/util.hxx>
+
+/// @file
+namespace Clypsalot
+{
+    static std::atomic_size_t liveBuffers = 0;
+    static std::atomic_size_t liveBytes = 0;
+    static std::atomic_size_t sharedBuffers = 0;
+    static std::atomic_size_t sharedBytes = 0;
+
+    /*
+     * The registry only holds weak references so it never keeps a buffer alive. Entries for
+     * buffers that have been destroyed are removed when they are found during a lookup and all of
+     * them are purged when there are a lot of them. The storage destructor does not touch the
+     * registry so a buffer can be released while the registry is locked.
+     */
+    template <ArrayValue T>
+    struct ArrayRegistry
+    {
+        std::mutex mutex;
+        std::unordered_multimap<std::size_t, std::weak_ptr<const ArrayStorage<T>>> entries;
+    };
+
+    template <ArrayValue T>
+    static ArrayRegistry<T>& arrayRegistry() noexcept
+    {
+        static ArrayRegistry<T> registry;
+        return registry;
+    }
+
+    template <ArrayValue T>
+    static std::size_t hashValues(const std::vector<T>& in_values) noexcept
+    {
+        const std::string_view bytes(reinterpret_cast<const char*>(in_values.data()), in_values.size() * sizeof(T));
+        return std::hash<std::string_view>()(bytes);
+    }
+
+    template <ArrayValue T>
+    ArrayStorage<T>::ArrayStorage(std::vector<T>&& in_values, const std::size_t in_hash) :
+        values(std::move(in_values)),
+        hash(in_hash)
+    {
+        liveBuffers++;
+        liveBytes += values.size() * sizeof(T);
+    }
+
+    template <ArrayValue T>
+    ArrayStorage<T>::~ArrayStorage() noexcept
+    {
+        liveBuffers--;
+        liveBytes -= values.size() * sizeof(T);
+    }
+
+    /**
+     * @brief Find or create the storage for a set of values.
+     *
+     * If an array with identical values is alive its storage is shared instead of keeping a
+     * second copy of the values.
+     */
+    template <ArrayValue T>
+    std::shared_ptr<const ArrayStorage<T>> internArray(std::vector<T>&& in_values)
+    {
+        auto& registry = arrayRegistry<T>();
+        const auto hash = hashValues(in_values);
+        std::scoped_lock lock(registry.mutex);
+        auto [iterator, last] = registry.entries.equal_range(hash);
+
+        while (iterator != last)
+        {
+            auto storage = iterator->second.lock();
+
+            if (! storage)
+            {
+                iterator = registry.entries.erase(iterator);
+                continue;
+            }
+
+            if (storage->values == in_values)
+            {
+                sharedBuffers++;
+                sharedBytes += in_values.size() * sizeof(T);
+                return storage;
+            }
+
+            ++iterator;
+        }
+
+        if (registry.entries.size() > 64 && registry.entries.size() > liveBuffers * 2)
+        {
+            std::erase_if(registry.entries, [](const auto& entry) { return entry.second.expired(); });
+        }
+
+        auto storage = std::make_shared<const ArrayStorage<T>>(std::move(in_values), hash);
+        registry.entries.emplace(hash, storage);
+        return storage;
+    }
+
+    /// @throws ValueError if the number of values is not a multiple of the number of columns.
+    template <ArrayValue T>
+    SharedTable<T>::SharedTable(std::vector<T> in_values, const std::size_t in_columns) :
+        m_columns(in_values.empty() ? 0 : in_columns)
+    {
+        if (! in_values.empty() && (in_columns == 0 || in_values.size() % in_columns != 0))
+        {
+            throw ValueError(makeString("Table with ", in_columns, " columns can not hold ", in_values.size(), " values"));
+        }
+
+        if (! in_values.empty()) this->m_storage = internArray(std::move(in_values));
+    }
+
+    /// @throws ValueError if the rows do not all have the same number of columns.
+    template <ArrayValue T>
+    SharedTable<T>::SharedTable(const std::vector<std::vector<T>>& in_rows)
+    {
+        const auto columns = in_rows.empty() ? 0 : in_rows.front().size();
+        std::vector<T> values;
+
+        values.reserve(in_rows.size() * columns);
+
+        for (const auto& row : in_rows)
+        {
+            if (row.size() != columns) throw ValueError("Table rows must all have the same number of columns");
+            values.insert(values.end(), row.begin(), row.end());
+        }
+
+        *this = SharedTable(std::move(values), columns);
+    }
+
+    ArrayMemoryStats arrayMemoryStats() noexcept
+    {
+        ArrayMemoryStats stats;
+
+        stats.buffers = liveBuffers;
+        stats.bytes = liveBytes;
+        stats.sharedBuffers = sharedBuffers;
+        stats.sharedBytes = sharedBytes;
+
+        return stats;
+    }
+
+    template <ArrayValue T>
+    static std::vector<T> parseValues(const std::string& in_string)
+    {
+        std::string text(in_string);
+        std::vector<T> values;
+
+        for (auto& c : text)
+        {
+            if (c == '[' || c == ']' || c == ',') c = ' ';
+        }
+
+        std::istringstream stream(text);
+        double value;
+
+        while (stream >> value)
+        {
+            values.push_back(static_cast<T>(value));
+        }
+
+        if (! stream.eof()) throw ValueError(makeString("Could not convert to array: ", in_string));
+
+        return values;
+    }
+
+    // Tables are written as nested lists like [[1, 2], [3, 4]] or with rows separated by a
+    // semicolon like 1 2; 3 4
+    template <ArrayValue T>
+    static std::vector<std::vector<T>> parseRows(const std::string& in_string)
+    {
+        std::vector<std::vector<T>> rows;
+        std::size_t depth = 0;
+        std::size_t start = 0;
+
+        for (std::size_t i = 0; i < in_string.size(); i++)
+        {
+            if (in_string[i] == '[')
+            {
+                if (++depth == 2) start = i + 1;
+            }
+            else if (in_string[i] == ']')
+            {
+                if (depth == 0) throw ValueError(makeString("Could not convert to table: ", in_string));
+                if (depth-- == 2) rows.push_back(parseValues<T>(in_string.substr(start, i - start)));
+            }
+        }
+
+        if (depth != 0) throw ValueError(makeString("Could not convert to table: ", in_string));
+        if (! rows.empty()) return rows;
+
+        std::istringstream stream(in_string);
+        std::string row;
+
+        while (std::getline(stream, row, ';'))
+        {
+            auto values = parseValues<T>(row);
+            if (! values.empty()) rows.push_back(std::move(values));
+        }
+
+        return rows;
+    }
+
+    template <ArrayValue T, ArrayValue U>
+    static bool convertVector(const std::any& in_value, std::vector<T>& out_values)
+    {
+        const auto vector = std::any_cast<std::vector<U>>(&in_value);
+
+        if (vector == nullptr) return false;
+
+        out_values.assign(vector->begin(), vector->end());
+        return true;
+    }
+
+    template <ArrayValue T, ArrayValue U>
+    static bool convertRows(const std::any& in_value, std::vector<std::vector<T>>& out_rows)
+    {
+        const auto rows = std::any_cast<std::vector<std::vector<U>>>(&in_value);
+
+        if (rows == nullptr) return false;
+
+        for (const auto& row : *rows)
+        {
+            out_rows.emplace_back(row.begin(), row.end());
+        }
+
+        return true;
+    }
+
+    template <ArrayValue T>
+    SharedArray<T> anyToArray(const std::any& in_value)
+    {
+        if (const auto array = std::any_cast<SharedArray<T>>(&in_value)) return *array;
+
+        std::vector<T> values;
+
+        if (convertVector<T, T>(in_value, values)) return values;
+        if (convertVector<T, float>(in_value, values)) return values;
+        if (convertVector<T, double>(in_value, values)) return values;
+        if (convertVector<T, int>(in_value, values)) return values;
+        if (anyIsStringType(in_value)) return parseValues<T>(anyToString(in_value));
+
+        throw ValueError(makeString("Can't convert ", typeName(in_value.type()), " to an array"));
+    }
+
+    template <ArrayValue T>
+    SharedTable<T> anyToTable(const std::any& in_value)
+    {
+        if (const auto table = std::any_cast<SharedTable<T>>(&in_value)) return *table;
+
+        std::vector<std::vector<T>> rows;
+
+        if (convertRows<T, T>(in_value, rows)) return rows;
+        if (convertRows<T, float>(in_value, rows)) return rows;
+        if (convertRows<T, double>(in_value, rows)) return rows;
+        if (convertRows<T, int>(in_value, rows)) return rows;
+        if (anyIsStringType(in_value)) return parseRows<T>(anyToString(in_value));
+
+        throw ValueError(makeString("Can't convert ", typeName(in_value.type()), " to a table"));
+    }
+
+    template <ArrayValue T>
+    static void writeValues(std::ostream& in_os, const std::span<const T> in_values) noexcept
+    {
+        in_os << "[";
+
+        for (std::size_t i = 0; i < in_values.size(); i++)
+        {
+            if (i > 0) in_os << ", ";
+            in_os << in_values[i];
+        }
+
+        in_os << "]";
+    }
+
+    template <ArrayValue T>
+    std::string toString(const SharedArray<T>& in_array) noexcept
+    {
+        std::ostringstream buffer;
+
+        writeValues(buffer, in_array.span());
+
+        return buffer.str();
+    }
+
+    template <ArrayValue T>
+    std::string toString(const SharedTable<T>& in_table) noexcept
+    {
+        std::ostringstream buffer;
+
+        buffer << "[";
+
+        for (std::size_t row = 0; row < in_table.rows(); row++)
+        {
+            if (row > 0) buffer << ", ";
+            writeValues(buffer, in_table.row(row));
+        }
+
+        buffer << "]";
+
+        return buffer.str();
+    }
+
+#define INSTANTIATE_ARRAY(type)\
+    template struct ArrayStorage<type>;\
+    template class SharedTable<type>;\
+    template std::shared_ptr<const ArrayStorage<type>> internArray(std::vector<type>&& in_values);\
+    template SharedArray<type> anyToArray(const std::any& in_value);\
+    template SharedTable<type> anyToTable(const std::any& in_value);\
+    template std::string toString(const SharedArray<type>& in_array) noexcept;\
+    template std::string toString(const SharedTable<type>& in_table) noexcept;
+
+    INSTANTIATE_ARRAY(float)
+    INSTANTIATE_ARRAY(double)
+    INSTANTIATE_ARRAY(int)
+}
@@ -0,0 +1,197 @@
+/* Copyright 2023 Tyler Riddle
+ *
+ * This file is part of Clypsalot. Clypsalot is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU Lesser General Public License as published by the Free Software Foundation, either version 3 of the License,
+ * or (at your option) any later version. Clypsalot is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along with Clypsalot. If not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <any>
+#include <concepts>
+#include <memory>
+#include <span>
+#include <string>
+#include <vector>
+
+/// @file
+namespace Clypsalot
+{
+    template <typename T>
+    concept ArrayValue = std::same_as<T, float> || std::same_as<T, double> || std::same_as<T, int>;
+
+    /// @brief A snapshot of the memory used by the array buffers of all the SharedArray and
+    /// SharedTable values.
+    struct ArrayMemoryStats
+    {
+        /// @brief The number of buffers that are alive.
+        std::size_t buffers = 0;
+        /// @brief The number of bytes used by the values in the buffers that are alive.
+        std::size_t bytes = 0;
+        /// @brief The number of times creating an array found an identical buffer to share.
+        std::size_t sharedBuffers = 0;
+        /// @brief The number of bytes that did not have to be allocated because a buffer was
+        /// shared.
+        std::size_t sharedBytes = 0;
+    };
+
+    /// @brief The immutable storage of an array. Identical storage is shared between every array
+    /// that has the same values.
+    template <ArrayValue T>
+    struct ArrayStorage
+    {
+        const std::vector<T> values;
+        const std::size_t hash;
+
+        ArrayStorage(std::vector<T>&& in_values, const std::size_t in_hash);
+        ArrayStorage(const ArrayStorage&) = delete;
+        ~ArrayStorage() noexcept;
+        void operator=(const ArrayStorage&) = delete;
+    };
+
+    template <ArrayValue T>
+    std::shared_ptr<const ArrayStorage<T>> internArray(std::vector<T>&& in_values);
+
+    /**
+     * @brief The reference counted immutable buffer shared by SharedArray and SharedTable.
+     *
+     * Copying or assigning only changes a reference count so a Property can be given a new
+     * buffer with out copying any values. A copy taken at the start of process() stays valid
+     * and unchanged for the whole period even if the Property is changed.
+     */
+    template <ArrayValue T>
+    class ArrayBuffer
+    {
+        protected:
+        std::shared_ptr<const ArrayStorage<T>> m_storage;
+
+        ArrayBuffer() noexcept = default;
+
+        ArrayBuffer(std::vector<T>&& in_values) :
+            m_storage(in_values.empty() ? nullptr : internArray(std::move(in_values)))
+        { }
+
+        public:
+        using ValueType = T;
+
+        const T* data() const noexcept
+        {
+            return m_storage ? m_storage->values.data() : nullptr;
+        }
+
+        std::size_t size() const noexcept
+        {
+            return m_storage ? m_storage->values.size() : 0;
+        }
+
+        bool empty() const noexcept
+        {
+            return size() == 0;
+        }
+
+        const T* begin() const noexcept
+        {
+            return data();
+        }
+
+        const T* end() const noexcept
+        {
+            return data() + size();
+        }
+
+        std::span<const T> span() const noexcept
+        {
+            return { data(), size() };
+        }
+
+        /// @brief True if both hold the same buffer instead of only having the same values.
+        bool shares(const ArrayBuffer& in_other) const noexcept
+        {
+            return m_storage == in_other.m_storage;
+        }
+
+        /// @brief The number of values that hold the same buffer.
+        long useCount() const noexcept
+        {
+            return m_storage.use_count();
+        }
+    };
+
+    /// @brief A one dimensional immutable array of values.
+    template <ArrayValue T>
+    class SharedArray : public ArrayBuffer<T>
+    {
+        public:
+        SharedArray() noexcept = default;
+
+        SharedArray(std::vector<T> in_values) :
+            ArrayBuffer<T>(std::move(in_values))
+        { }
+
+        SharedArray(const std::initializer_list<T> in_values) :
+            ArrayBuffer<T>(std::vector<T>(in_values))
+        { }
+
+        const T& operator[](const std::size_t in_index) const noexcept
+        {
+            return this->data()[in_index];
+        }
+
+        friend bool operator==(const SharedArray& in_lhs, const SharedArray& in_rhs) noexcept
+        {
+            if (in_lhs.shares(in_rhs)) return true;
+            return std::equal(in_lhs.begin(), in_lhs.end(), in_rhs.begin(), in_rhs.end());
+        }
+    };
+
+    /// @brief A two dimensional immutable table of values stored in row major order.
+    template <ArrayValue T>
+    class SharedTable : public ArrayBuffer<T>
+    {
+        std::size_t m_columns = 0;
+
+        public:
+        SharedTable() noexcept = default;
+        SharedTable(std::vector<T> in_values, const std::size_t in_columns);
+        SharedTable(const std::vector<std::vector<T>>& in_rows);
+
+        std::size_t rows() const noexcept
+        {
+            return m_columns ? this->size() / m_columns : 0;
+        }
+
+        std::size_t columns() const noexcept
+        {
+            return m_columns;
+        }
+
+        std::span<const T> row(const std::size_t in_row) const noexcept
+        {
+            return { this->data() + in_row * m_columns, m_columns };
+        }
+
+        const T& at(const std::size_t in_row, const std::size_t in_column) const noexcept
+        {
+            return this->data()[in_row * m_columns + in_column];
+        }
+
+        friend bool operator==(const SharedTable& in_lhs, const SharedTable& in_rhs) noexcept
+        {
+            if (in_lhs.m_columns != in_rhs.m_columns) return false;
+            if (in_lhs.shares(in_rhs)) return true;
+            return std::equal(in_lhs.begin(), in_lhs.end(), in_rhs.begin(), in_rhs.end());
+        }
+    };
+
+    ArrayMemoryStats arrayMemoryStats() noexcept;
+    template <ArrayValue T> SharedArray<T> anyToArray(const std::any& in_value);
+    template <ArrayValue T> SharedTable<T> anyToTable(const std::any& in_value);
+    template <ArrayValue T> std::string toString(const SharedArray<T>& in_array) noexcept;
+    template <ArrayValue T> std::string toString(const SharedTable<T>& in_table) noexcept;
+}
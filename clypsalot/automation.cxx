@@ -0,0 +1,366 @@
+/* Copyright 2023 Tyler Riddle
+ *
+ * This file is part of Clypsalot. Clypsalot is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU Lesser General Public License as published by the Free Software Foundation, either version 3 of the License,
+ * or (at your option) any later version. Clypsalot is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along with Clypsalot. If not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+#include <clypsalot/automation.hxx>
+#include <clypsalot/error.hxx>
+#include <clypsalot/macros.hxx>
+#include <clypsalot/thread.hxx>
+#include <clypsalot/util.hxx>
+
+/// @file
+namespace Clypsalot
+{
+    static bool exponentialIsValid(const double in_start, const double in_end) noexcept
+    {
+        if (in_start == 0 || in_end == 0) return false;
+        return (in_start > 0) == (in_end > 0);
+    }
+
+    void AutomationLane::reset(const double in_value) noexcept
+    {
+        m_start = in_value;
+        m_target = in_value;
+        m_begin = 0;
+        m_elapsed = 0;
+        m_length = 0;
+        m_curve = AutomationCurve::step;
+    }
+
+    void AutomationLane::start(const AutomationEvent& in_event) noexcept
+    {
+        m_start = value(in_event.offset);
+        m_target = in_event.value;
+        m_begin = in_event.offset;
+        m_elapsed = 0;
+        m_curve = in_event.curve;
+        m_length = m_curve == AutomationCurve::step ? 0 : in_event.duration;
+    }
+
+    void AutomationLane::finish(const std::size_t in_frames) noexcept
+    {
+        if (ramping())
+        {
+            m_elapsed += in_frames - m_begin;
+            m_begin = 0;
+
+            if (m_elapsed < m_length) return;
+        }
+
+        reset(m_target);
+    }
+
+    bool AutomationLane::bound() const noexcept
+    {
+        return m_property != nullptr;
+    }
+
+    bool AutomationLane::ramping() const noexcept
+    {
+        return m_length > 0 && m_elapsed < m_length;
+    }
+
+    /**
+     * @brief The value of the lane at a frame inside the current period.
+     *
+     * The lane only knows about the events that have been applied so the frame must not be
+     * before the frame given to the last Automation::apply() call.
+     */
+    double AutomationLane::value(const std::size_t in_frame) const noexcept
+    {
+        if (! ramping()) return m_target;
+
+        const auto position = m_elapsed + (in_frame > m_begin ? in_frame - m_begin : 0);
+
+        if (position >= m_length) return m_target;
+
+        const auto fraction = static_cast<double>(position) / m_length;
+
+        switch (m_curve)
+        {
+            case AutomationCurve::step: return m_target;
+            case AutomationCurve::linear: return interpolateLinear(m_start, m_target, fraction);
+            case AutomationCurve::exponential: return interpolateExponential(m_start, m_target, fraction);
+        }
+
+        FATAL_ERROR(makeString("Unhandled AutomationCurve value: ", m_curve));
+    }
+
+    /**
+     * @brief Write the per frame values of the lane for the frames [in_from, in_to) into a buffer.
+     *
+     * The ramps are computed incrementally so this is much cheaper than calling value() for
+     * every frame.
+     */
+    void AutomationLane::render(float* out_values, const std::size_t in_from, const std::size_t in_to) const noexcept
+    {
+        assert(in_from <= in_to);
+
+        const auto frames = in_to - in_from;
+        std::size_t frame = 0;
+
+        if (ramping())
+        {
+            const auto position = m_elapsed + (in_from > m_begin ? in_from - m_begin : 0);
+            const auto remaining = position < m_length ? std::min(m_length - position, frames) : 0;
+            auto current = value(in_from);
+
+            if (m_curve == AutomationCurve::exponential && exponentialIsValid(m_start, m_target))
+            {
+                const auto ratio = std::pow(m_target / m_start, 1.0 / m_length);
+
+                for (; frame < remaining; frame++)
+                {
+                    out_values[frame] = current;
+                    current *= ratio;
+                }
+            }
+            else
+            {
+                const auto increment = (m_target - m_start) / m_length;
+
+                for (; frame < remaining; frame++)
+                {
+                    out_values[frame] = current;
+                    current += increment;
+                }
+            }
+        }
+
+        std::fill(out_values + frame, out_values + frames, static_cast<float>(m_target));
+    }
+
+    Automation::Automation(const std::size_t in_capacity) :
+        m_queue(in_capacity)
+    {
+        m_pending.reserve(m_queue.capacity());
+    }
+
+    double Automation::read(const Property& in_property) noexcept
+    {
+        const auto& container = in_property.m_container;
+
+        switch (in_property.m_type)
+        {
+            case PropertyType::boolean: return std::get<Property::BooleanType>(container) ? 1 : 0;
+            case PropertyType::integer: return std::get<Property::IntegerType>(container);
+            case PropertyType::real: return std::get<Property::RealType>(container);
+            case PropertyType::size: return std::get<Property::SizeType>(container);
+            case PropertyType::doubleArray: break;
+            case PropertyType::doubleTable: break;
+            case PropertyType::file: break;
+            case PropertyType::integerArray: break;
+            case PropertyType::realArray: break;
+            case PropertyType::realTable: break;
+            case PropertyType::string: break;
+        }
+
+        FATAL_ERROR(makeString("Property type can not be automated: ", in_property.m_type));
+    }
+
+    void Automation::store(const AutomationLane& in_lane) noexcept
+    {
+        auto& property = *in_lane.m_property;
+        const auto value = in_lane.value(0);
+
+        assert(property.m_parent.haveLock());
+
+        switch (property.m_type)
+        {
+            case PropertyType::boolean: property.m_container = value >= 0.5; break;
+            case PropertyType::integer: property.m_container = static_cast<Property::IntegerType>(std::lround(value)); break;
+            case PropertyType::real: property.m_container = static_cast<Property::RealType>(value); break;
+            case PropertyType::size: property.m_container = static_cast<Property::SizeType>(std::max(std::lround(value), 0L)); break;
+            case PropertyType::doubleArray: FATAL_ERROR("Array property can not be automated");
+            case PropertyType::doubleTable: FATAL_ERROR("Table property can not be automated");
+            case PropertyType::file: FATAL_ERROR("File property can not be automated");
+            case PropertyType::integerArray: FATAL_ERROR("Array property can not be automated");
+            case PropertyType::realArray: FATAL_ERROR("Array property can not be automated");
+            case PropertyType::realTable: FATAL_ERROR("Table property can not be automated");
+            case PropertyType::string: FATAL_ERROR("String property can not be automated");
+        }
+
+        property.m_hasValue = true;
+    }
+
+    std::size_t Automation::capacity() const noexcept
+    {
+        return m_queue.capacity();
+    }
+
+    /**
+     * @brief Create a lane for every property with the Property::Automatable flag.
+     * @param in_properties All the properties of the Object indexed by their handles.
+     *
+     * This must be called while the Object is preparing because pushing events reads the lanes
+     * with out holding any lock.
+     */
+    void Automation::bind(const std::vector<Property*>& in_properties)
+    {
+        m_lanes.clear();
+        m_lanes.resize(in_properties.size());
+        m_pending.clear();
+
+        for (std::size_t handle = 0; handle < in_properties.size(); handle++)
+        {
+            const auto property = in_properties[handle];
+
+            if (! property->hasFlag(Property::Automatable)) continue;
+
+            assert(property->m_parent.haveLock());
+
+            auto& lane = m_lanes[handle];
+
+            lane.m_property = property;
+            lane.reset(read(*property));
+        }
+    }
+
+    /**
+     * @brief Queue an automation event with out blocking.
+     * @return false if the queue is full.
+     * @throws KeyError if the property handle does not refer to an automatable property.
+     *
+     * This is safe to call from any thread.
+     */
+    bool Automation::push(const AutomationEvent& in_event)
+    {
+        if (in_event.property >= m_lanes.size() || ! m_lanes[in_event.property].bound())
+        {
+            throw KeyError(makeString("Property handle is not automatable: ", in_event.property), std::to_string(in_event.property));
+        }
+
+        return m_queue.push(in_event);
+    }
+
+    const AutomationLane& Automation::lane(const Property::Handle in_handle) const
+    {
+        if (in_handle >= m_lanes.size() || ! m_lanes[in_handle].bound())
+        {
+            throw KeyError(makeString("Property handle is not automatable: ", in_handle), std::to_string(in_handle));
+        }
+
+        return m_lanes[in_handle];
+    }
+
+    /**
+     * @brief Take the queued events and prepare for processing a period.
+     *
+     * Events are kept sorted by offset with events that share an offset remaining in the order
+     * they were pushed. The storage for the pending events is reserved during construction so
+     * this never allocates.
+     */
+    void Automation::beginPeriod(const std::size_t in_frames) noexcept
+    {
+        AutomationEvent event;
+
+        m_frames = in_frames;
+        m_next = 0;
+
+        while (m_pending.size() < m_pending.capacity() && m_queue.pop(event))
+        {
+            const auto position = std::upper_bound(m_pending.begin(), m_pending.end(), event,
+                [](const AutomationEvent& lhs, const AutomationEvent& rhs) { return lhs.offset < rhs.offset; });
+
+            m_pending.insert(position, event);
+        }
+
+        for (auto& lane : m_lanes)
+        {
+            if (lane.bound() && ! lane.ramping()) lane.reset(read(*lane.m_property));
+        }
+    }
+
+    /**
+     * @brief Start every pending event with an offset at or before the given frame.
+     * @return The offset of the next pending event inside the period or the number of frames in
+     * the period if there are none. Processing the frames up to that offset in one block is sample
+     * accurate.
+     */
+    std::size_t Automation::apply(const std::size_t in_frame) noexcept
+    {
+        while (m_next < m_pending.size() && m_pending[m_next].offset <= in_frame && m_pending[m_next].offset < m_frames)
+        {
+            const auto& event = m_pending[m_next];
+
+            m_lanes[event.property].start(event);
+            m_next++;
+        }
+
+        if (m_next < m_pending.size()) return std::min(m_pending[m_next].offset, m_frames);
+        return m_frames;
+    }
+
+    /// @brief Apply any remaining events in the period and store the automated values.
+    void Automation::endPeriod() noexcept
+    {
+        if (m_frames > 0) apply(m_frames - 1);
+
+        for (auto& lane : m_lanes)
+        {
+            if (! lane.bound()) continue;
+
+            lane.finish(m_frames);
+            store(lane);
+        }
+
+        m_pending.erase(m_pending.begin(), m_pending.begin() + m_next);
+
+        for (auto& event : m_pending)
+        {
+            event.offset -= m_frames;
+        }
+
+        m_next = 0;
+        m_frames = 0;
+    }
+
+    double interpolateLinear(const double in_start, const double in_end, const double in_position) noexcept
+    {
+        return in_start + (in_end - in_start) * in_position;
+    }
+
+    /**
+     * @brief Interpolate along an exponential curve which is the natural curve for gains and
+     * frequencies.
+     *
+     * If the start and end do not share a sign or one of them is zero there is no exponential
+     * curve between them and the interpolation is linear instead.
+     */
+    double interpolateExponential(const double in_start, const double in_end, const double in_position) noexcept
+    {
+        if (! exponentialIsValid(in_start, in_end)) return interpolateLinear(in_start, in_end, in_position);
+
+        return in_start * std::pow(in_end / in_start, in_position);
+    }
+
+    std::string toString(const AutomationCurve in_curve) noexcept
+    {
+        switch (in_curve)
+        {
+            case AutomationCurve::step: return "step";
+            case AutomationCurve::linear: return "linear";
+            case AutomationCurve::exponential: return "exponential";
+        }
+
+        FATAL_ERROR(makeString("Unhandled AutomationCurve value: ", static_cast<int>(in_curve)));
+    }
+
+    std::ostream& operator<<(std::ostream& in_os, const AutomationCurve in_curve) noexcept
+    {
+        in_os << toString(in_curve);
+        return in_os;
+    }
+}
@@ -0,0 +1,109 @@
+/* Copyright 2023 Tyler Riddle
+ *
+ * This file is part of Clypsalot. Clypsalot is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU Lesser General Public License as published by the Free Software Foundation, either version 3 of the License,
+ * or (at your option) any later version. Clypsalot is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along with Clypsalot. If not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include <clypsalot/forward.hxx>
+#include <clypsalot/property.hxx>
+#include <clypsalot/queue.hxx>
+
+/// @file
+namespace Clypsalot
+{
+    enum class AutomationCurve : uint_fast8_t
+    {
+        step,
+        linear,
+        exponential,
+    };
+
+    /**
+     * @brief A timestamped change to the value of an automatable Property.
+     *
+     * The offset is the number of frames from the start of the next period the Object
+     * processes. Events with an offset past the end of that period are carried into the following
+     * periods. A step event sets the value at the offset while the linear and exponential curves
+     * move from the value the property has at the offset to the new value over duration frames.
+     */
+    struct AutomationEvent
+    {
+        std::size_t offset = 0;
+        Property::Handle property = 0;
+        double value = 0;
+        AutomationCurve curve = AutomationCurve::step;
+        std::size_t duration = 0;
+    };
+
+    /// @brief The automation state of a single Property inside of a period.
+    class AutomationLane
+    {
+        friend Automation;
+
+        Property* m_property = nullptr;
+        double m_start = 0;
+        double m_target = 0;
+        std::size_t m_begin = 0;
+        std::size_t m_elapsed = 0;
+        std::size_t m_length = 0;
+        AutomationCurve m_curve = AutomationCurve::step;
+
+        void reset(const double in_value) noexcept;
+        void start(const AutomationEvent& in_event) noexcept;
+        void finish(const std::size_t in_frames) noexcept;
+
+        public:
+        bool bound() const noexcept;
+        bool ramping() const noexcept;
+        double value(const std::size_t in_frame) const noexcept;
+        void render(float* out_values, const std::size_t in_from, const std::size_t in_to) const noexcept;
+    };
+
+    /**
+     * @brief The per Object stream of automation events.
+     *
+     * Producers on any thread push() events into a lock free queue. The Object drains the queue
+     * from inside process() with beginPeriod(), moves through the period with apply() and
+     * finishes with endPeriod() which stores the automated values back into the properties. The
+     * consumer side requires the Object lock which process() already holds.
+     */
+    class Automation
+    {
+        BoundedQueue<AutomationEvent> m_queue;
+        std::vector<AutomationEvent> m_pending;
+        std::vector<AutomationLane> m_lanes;
+        std::size_t m_frames = 0;
+        std::size_t m_next = 0;
+
+        static double read(const Property& in_property) noexcept;
+        void store(const AutomationLane& in_lane) noexcept;
+
+        public:
+        Automation(const std::size_t in_capacity);
+        Automation(const Automation&) = delete;
+        void operator=(const Automation&) = delete;
+        std::size_t capacity() const noexcept;
+        void bind(const std::vector<Property*>& in_properties);
+        bool push(const AutomationEvent& in_event);
+        const AutomationLane& lane(const Property::Handle in_handle) const;
+        void beginPeriod(const std::size_t in_frames) noexcept;
+        std::size_t apply(const std::size_t in_frame) noexcept;
+        void endPeriod() noexcept;
+    };
+
+    double interpolateLinear(const double in_start, const double in_end, const double in_position) noexcept;
+    double interpolateExponential(const double in_start, const double in_end, const double in_position) noexcept;
+    std::string toString(const AutomationCurve in_curve) noexcept;
+    std::ostream& operator<<(std::ostream& in_os, const AutomationCurve in_curve) noexcept;
+}
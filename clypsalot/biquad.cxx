@@ -0,0 +1,569 @@
+/* Copyright 2023 Tyler Riddle
+ *
+ * This file is part of Clypsalot. Clypsalot is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU Lesser General Public License as published by the Free Software Foundation, either version 3 of the License,
+ * or (at your option) any later version. Clypsalot is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along with Clypsalot. If not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <complex>
+#include <numbers>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define CLYPSALOT_X86_KERNELS
+#include <immintrin.h>
+#endif
+
+#include <clypsalot/biquad.hxx>
+#include <clypsalot/error.hxx>
+#include <clypsalot/macros.hxx>
+#include <clypsalot/transpose.hxx>
+#include <clypsalot/util.hxx>
+
+/// @file
+namespace Clypsalot
+{
+    // The kernels get the coefficients of a band as b0, b1, b2, a1 and a2.
+    static constexpr std::size_t kernelCoefficients = 5;
+
+    /*
+     * Every kernel computes y = b0 * x + s1, s1 = b1 * x + s2 - a1 * y and s2 = b2 * x - a2 * y
+     * in that order with out fused multiplies so all of the levels round the same way. The state
+     * of a row is the s1 of every lane followed by the s2 of every lane.
+     */
+    static void biquadScalar(const float* const* in_sources, float* const* out_dests, const std::size_t in_rows, const float* in_coefficients, float* io_state, const std::size_t in_frames) noexcept
+    {
+        const auto b0 = in_coefficients[0];
+        const auto b1 = in_coefficients[1];
+        const auto b2 = in_coefficients[2];
+        const auto a1 = in_coefficients[3];
+        const auto a2 = in_coefficients[4];
+
+        for (std::size_t row = 0; row < in_rows; row++)
+        {
+            const auto source = in_sources[row];
+            const auto dest = out_dests[row];
+            auto s1 = io_state[row * 2];
+            auto s2 = io_state[row * 2 + 1];
+
+            for (std::size_t frame = 0; frame < in_frames; frame++)
+            {
+                const auto x = source[frame];
+                const auto y = b0 * x + s1;
+
+                s1 = b1 * x + s2 - a1 * y;
+                s2 = b2 * x - a2 * y;
+                dest[frame] = y;
+            }
+
+            io_state[row * 2] = s1;
+            io_state[row * 2 + 1] = s2;
+        }
+    }
+
+#ifdef CLYPSALOT_X86_KERNELS
+    __attribute__((target("sse2")))
+    static inline __m128 biquadStepSse2(const __m128 (&in_c)[kernelCoefficients], const __m128 in_x, __m128& io_s1, __m128& io_s2) noexcept
+    {
+        const auto y = _mm_add_ps(_mm_mul_ps(in_c[0], in_x), io_s1);
+
+        io_s1 = _mm_sub_ps(_mm_add_ps(_mm_mul_ps(in_c[1], in_x), io_s2), _mm_mul_ps(in_c[3], y));
+        io_s2 = _mm_sub_ps(_mm_mul_ps(in_c[2], in_x), _mm_mul_ps(in_c[4], y));
+
+        return y;
+    }
+
+    __attribute__((target("sse2")))
+    static void biquadSse2(const float* const* in_sources, float* const* out_dests, const std::size_t in_rows, const float* in_coefficients, float* io_state, const std::size_t in_frames) noexcept
+    {
+        constexpr std::size_t lanes = 4;
+        __m128 c[kernelCoefficients];
+        std::size_t row = 0;
+
+        for (std::size_t i = 0; i < kernelCoefficients; i++) c[i] = _mm_set1_ps(in_coefficients[i]);
+
+        for (; row + 2 <= in_rows; row += 2)
+        {
+            const auto sourceA = in_sources[row];
+            const auto sourceB = in_sources[row + 1];
+            const auto destA = out_dests[row];
+            const auto destB = out_dests[row + 1];
+            const auto stateA = io_state + row * 2 * lanes;
+            const auto stateB = stateA + 2 * lanes;
+            auto s1A = _mm_loadu_ps(stateA);
+            auto s2A = _mm_loadu_ps(stateA + lanes);
+            auto s1B = _mm_loadu_ps(stateB);
+            auto s2B = _mm_loadu_ps(stateB + lanes);
+
+            for (std::size_t frame = 0; frame < in_frames * lanes; frame += lanes)
+            {
+                const auto yA = biquadStepSse2(c, _mm_loadu_ps(sourceA + frame), s1A, s2A);
+                const auto yB = biquadStepSse2(c, _mm_loadu_ps(sourceB + frame), s1B, s2B);
+
+                _mm_storeu_ps(destA + frame, yA);
+                _mm_storeu_ps(destB + frame, yB);
+            }
+
+            _mm_storeu_ps(stateA, s1A);
+            _mm_storeu_ps(stateA + lanes, s2A);
+            _mm_storeu_ps(stateB, s1B);
+            _mm_storeu_ps(stateB + lanes, s2B);
+        }
+
+        if (row == in_rows) return;
+
+        const auto source = in_sources[row];
+        const auto dest = out_dests[row];
+        const auto state = io_state + row * 2 * lanes;
+        auto s1 = _mm_loadu_ps(state);
+        auto s2 = _mm_loadu_ps(state + lanes);
+
+        for (std::size_t frame = 0; frame < in_frames * lanes; frame += lanes)
+        {
+            _mm_storeu_ps(dest + frame, biquadStepSse2(c, _mm_loadu_ps(source + frame), s1, s2));
+        }
+
+        _mm_storeu_ps(state, s1);
+        _mm_storeu_ps(state + lanes, s2);
+    }
+
+    __attribute__((target("avx2")))
+    static inline __m256 biquadStepAvx2(const __m256 (&in_c)[kernelCoefficients], const __m256 in_x, __m256& io_s1, __m256& io_s2) noexcept
+    {
+        const auto y = _mm256_add_ps(_mm256_mul_ps(in_c[0], in_x), io_s1);
+
+        io_s1 = _mm256_sub_ps(_mm256_add_ps(_mm256_mul_ps(in_c[1], in_x), io_s2), _mm256_mul_ps(in_c[3], y));
+        io_s2 = _mm256_sub_ps(_mm256_mul_ps(in_c[2], in_x), _mm256_mul_ps(in_c[4], y));
+
+        return y;
+    }
+
+    __attribute__((target("avx2")))
+    static void biquadAvx2(const float* const* in_sources, float* const* out_dests, const std::size_t in_rows, const float* in_coefficients, float* io_state, const std::size_t in_frames) noexcept
+    {
+        constexpr std::size_t lanes = 8;
+        __m256 c[kernelCoefficients];
+        std::size_t row = 0;
+
+        for (std::size_t i = 0; i < kernelCoefficients; i++) c[i] = _mm256_set1_ps(in_coefficients[i]);
+
+        for (; row + 2 <= in_rows; row += 2)
+        {
+            const auto sourceA = in_sources[row];
+            const auto sourceB = in_sources[row + 1];
+            const auto destA = out_dests[row];
+            const auto destB = out_dests[row + 1];
+            const auto stateA = io_state + row * 2 * lanes;
+            const auto stateB = stateA + 2 * lanes;
+            auto s1A = _mm256_loadu_ps(stateA);
+            auto s2A = _mm256_loadu_ps(stateA + lanes);
+            auto s1B = _mm256_loadu_ps(stateB);
+            auto s2B = _mm256_loadu_ps(stateB + lanes);
+
+            for (std::size_t frame = 0; frame < in_frames * lanes; frame += lanes)
+            {
+                const auto yA = biquadStepAvx2(c, _mm256_loadu_ps(sourceA + frame), s1A, s2A);
+                const auto yB = biquadStepAvx2(c, _mm256_loadu_ps(sourceB + frame), s1B, s2B);
+
+                _mm256_storeu_ps(destA + frame, yA);
+                _mm256_storeu_ps(destB + frame, yB);
+            }
+
+            _mm256_storeu_ps(stateA, s1A);
+            _mm256_storeu_ps(stateA + lanes, s2A);
+            _mm256_storeu_ps(stateB, s1B);
+            _mm256_storeu_ps(stateB + lanes, s2B);
+        }
+
+        if (row == in_rows) return;
+
+        const auto source = in_sources[row];
+        const auto dest = out_dests[row];
+        const auto state = io_state + row * 2 * lanes;
+        auto s1 = _mm256_loadu_ps(state);
+        auto s2 = _mm256_loadu_ps(state + lanes);
+
+        for (std::size_t frame = 0; frame < in_frames * lanes; frame += lanes)
+        {
+            _mm256_storeu_ps(dest + frame, biquadStepAvx2(c, _mm256_loadu_ps(source + frame), s1, s2));
+        }
+
+        _mm256_storeu_ps(state, s1);
+        _mm256_storeu_ps(state + lanes, s2);
+    }
+
+    // The low half of the register is one grouped8 row and the high half is the next.
+    __attribute__((target("avx512f")))
+    static inline __m512 loadRowsAvx512(const float* in_low, const float* in_high) noexcept
+    {
+        const auto low = _mm512_castps_pd(_mm512_castps256_ps512(_mm256_loadu_ps(in_low)));
+
+        return _mm512_castpd_ps(_mm512_insertf64x4(low, _mm256_castps_pd(_mm256_loadu_ps(in_high)), 1));
+    }
+
+    __attribute__((target("avx512f")))
+    static inline void storeRowsAvx512(float* out_low, float* out_high, const __m512 in_value) noexcept
+    {
+        _mm256_storeu_ps(out_low, _mm512_castps512_ps256(in_value));
+        _mm256_storeu_ps(out_high, _mm256_castpd_ps(_mm512_extractf64x4_pd(_mm512_castps_pd(in_value), 1)));
+    }
+
+    __attribute__((target("avx512f")))
+    static inline __m512 biquadStepAvx512(const __m512 (&in_c)[kernelCoefficients], const __m512 in_x, __m512& io_s1, __m512& io_s2) noexcept
+    {
+        const auto y = _mm512_add_ps(_mm512_mul_ps(in_c[0], in_x), io_s1);
+
+        io_s1 = _mm512_sub_ps(_mm512_add_ps(_mm512_mul_ps(in_c[1], in_x), io_s2), _mm512_mul_ps(in_c[3], y));
+        io_s2 = _mm512_sub_ps(_mm512_mul_ps(in_c[2], in_x), _mm512_mul_ps(in_c[4], y));
+
+        return y;
+    }
+
+    /*
+     * Works on grouped8 rows four at a time as two registers of two rows. A pair that is left
+     * over takes one register and a single row goes to the AVX2 kernel.
+     */
+    __attribute__((target("avx512f")))
+    static void biquadAvx512(const float* const* in_sources, float* const* out_dests, const std::size_t in_rows, const float* in_coefficients, float* io_state, const std::size_t in_frames) noexcept
+    {
+        constexpr std::size_t lanes = 8;
+        __m512 c[kernelCoefficients];
+        std::size_t row = 0;
+
+        for (std::size_t i = 0; i < kernelCoefficients; i++) c[i] = _mm512_set1_ps(in_coefficients[i]);
+
+        for (; row + 4 <= in_rows; row += 4)
+        {
+            const auto sources = in_sources + row;
+            const auto dests = out_dests + row;
+            const auto state = io_state + row * 2 * lanes;
+            auto s1A = loadRowsAvx512(state, state + 2 * lanes);
+            auto s2A = loadRowsAvx512(state + lanes, state + 3 * lanes);
+            auto s1B = loadRowsAvx512(state + 4 * lanes, state + 6 * lanes);
+            auto s2B = loadRowsAvx512(state + 5 * lanes, state + 7 * lanes);
+
+            for (std::size_t frame = 0; frame < in_frames * lanes; frame += lanes)
+            {
+                const auto yA = biquadStepAvx512(c, loadRowsAvx512(sources[0] + frame, sources[1] + frame), s1A, s2A);
+                const auto yB = biquadStepAvx512(c, loadRowsAvx512(sources[2] + frame, sources[3] + frame), s1B, s2B);
+
+                storeRowsAvx512(dests[0] + frame, dests[1] + frame, yA);
+                storeRowsAvx512(dests[2] + frame, dests[3] + frame, yB);
+            }
+
+            storeRowsAvx512(state, state + 2 * lanes, s1A);
+            storeRowsAvx512(state + lanes, state + 3 * lanes, s2A);
+            storeRowsAvx512(state + 4 * lanes, state + 6 * lanes, s1B);
+            storeRowsAvx512(state + 5 * lanes, state + 7 * lanes, s2B);
+        }
+
+        if (row + 2 <= in_rows)
+        {
+            const auto sources = in_sources + row;
+            const auto dests = out_dests + row;
+            const auto state = io_state + row * 2 * lanes;
+            auto s1 = loadRowsAvx512(state, state + 2 * lanes);
+            auto s2 = loadRowsAvx512(state + lanes, state + 3 * lanes);
+
+            for (std::size_t frame = 0; frame < in_frames * lanes; frame += lanes)
+            {
+                const auto y = biquadStepAvx512(c, loadRowsAvx512(sources[0] + frame, sources[1] + frame), s1, s2);
+
+                storeRowsAvx512(dests[0] + frame, dests[1] + frame, y);
+            }
+
+            storeRowsAvx512(state, state + 2 * lanes, s1);
+            storeRowsAvx512(state + lanes, state + 3 * lanes, s2);
+            row += 2;
+        }
+
+        if (row < in_rows) biquadAvx2(in_sources + row, out_dests + row, 1, in_coefficients, io_state + row * 2 * lanes, in_frames);
+    }
+#endif
+
+    bool BiquadCoefficients::identity() const noexcept
+    {
+        return *this == BiquadCoefficients();
+    }
+
+    /**
+     * @param in_level The highest level of vector instructions to use. It is limited to what the
+     * CPU supports.
+     * @throws ValueError if there are no channels.
+     */
+    BiquadCascade::BiquadCascade(const std::size_t in_channels, const std::size_t in_bands, const SimdLevel in_level) :
+        m_channels(in_channels),
+        m_bands(in_bands)
+    {
+        if (m_channels == 0) throw ValueError("Biquad channel count must be greater than zero");
+
+        [[maybe_unused]] const auto level = std::min(in_level, simdLevel());
+
+        m_kernel = biquadScalar;
+
+#ifdef CLYPSALOT_X86_KERNELS
+        if (level >= SimdLevel::avx512)
+        {
+            m_kernel = biquadAvx512;
+            m_level = SimdLevel::avx512;
+        }
+        else if (level >= SimdLevel::avx2)
+        {
+            m_kernel = biquadAvx2;
+            m_level = SimdLevel::avx2;
+        }
+        else if (level >= SimdLevel::sse2)
+        {
+            m_kernel = biquadSse2;
+            m_level = SimdLevel::sse2;
+        }
+#endif
+
+        m_layout = pcmSimdLayout(m_level);
+
+        const auto lanes = pcmLanes(m_layout);
+
+        m_rows = (m_channels + lanes - 1) / lanes;
+        m_coefficients.resize(m_bands);
+        m_kernelCoefficients.resize(m_bands * kernelCoefficients);
+        m_state.resize(m_bands * m_rows * 2 * lanes);
+        m_sources.resize(m_rows);
+        m_dests.resize(m_rows);
+
+        for (std::size_t band = 0; band < m_bands; band++)
+        {
+            coefficients(band, BiquadCoefficients());
+        }
+    }
+
+    std::size_t BiquadCascade::channels() const noexcept
+    {
+        return m_channels;
+    }
+
+    std::size_t BiquadCascade::bands() const noexcept
+    {
+        return m_bands;
+    }
+
+    /// @brief The level of the kernel that was picked.
+    SimdLevel BiquadCascade::level() const noexcept
+    {
+        return m_level;
+    }
+
+    /// @brief The layout buffers given to process() must have.
+    PcmLayout BiquadCascade::layout() const noexcept
+    {
+        return m_layout;
+    }
+
+    const BiquadCoefficients& BiquadCascade::coefficients(const std::size_t in_band) const noexcept
+    {
+        assert(in_band < m_bands);
+
+        return m_coefficients[in_band];
+    }
+
+    /// @brief Change the coefficients of a band. The state is kept so a change does not click
+    /// any more than the new response makes it.
+    void BiquadCascade::coefficients(const std::size_t in_band, const BiquadCoefficients& in_coefficients) noexcept
+    {
+        assert(in_band < m_bands);
+
+        const auto kernel = m_kernelCoefficients.data() + in_band * kernelCoefficients;
+
+        m_coefficients[in_band] = in_coefficients;
+        kernel[0] = in_coefficients.b0;
+        kernel[1] = in_coefficients.b1;
+        kernel[2] = in_coefficients.b2;
+        kernel[3] = in_coefficients.a1;
+        kernel[4] = in_coefficients.a2;
+    }
+
+    /// @brief Clear the state of every band as if the input had always been silent.
+    void BiquadCascade::reset() noexcept
+    {
+        std::fill(m_state.begin(), m_state.end(), 0.0f);
+    }
+
+    /**
+     * @brief Filter the first frames of every channel.
+     *
+     * Both buffers must be float32 in the layout of the cascade. The source and the destination
+     * can be the same buffer.
+     */
+    void BiquadCascade::process(const PcmBuffer& in_source, PcmBuffer& out_dest, const std::size_t in_frames) noexcept
+    {
+        assert(in_source.format() == PcmFormat::float32 && out_dest.format() == PcmFormat::float32);
+        assert(in_source.layout() == m_layout && out_dest.layout() == m_layout);
+        assert(in_source.channels() == m_channels && out_dest.channels() == m_channels);
+        assert(in_frames <= in_source.frames() && in_frames <= out_dest.frames());
+
+        const auto planar = m_layout == PcmLayout::planar;
+        const auto stateSize = m_rows * 2 * pcmLanes(m_layout);
+        [[maybe_unused]] const DenormalGuard guard;
+        bool filtered = false;
+
+        for (std::size_t row = 0; row < m_rows; row++)
+        {
+            m_sources[row] = planar ? in_source.channel<float>(row) : in_source.group<float>(row);
+            m_dests[row] = planar ? out_dest.channel<float>(row) : out_dest.group<float>(row);
+        }
+
+        for (std::size_t band = 0; band < m_bands; band++)
+        {
+            if (m_coefficients[band].identity()) continue;
+
+            // Only the first band reads the source and the rest work in place.
+            const auto sources = filtered ? m_dests.data() : m_sources.data();
+
+            m_kernel(sources, m_dests.data(), m_rows, m_kernelCoefficients.data() + band * kernelCoefficients, m_state.data() + band * stateSize, in_frames);
+            filtered = true;
+        }
+
+        if (! filtered && &in_source != &out_dest) out_dest.copy(in_source, in_frames);
+    }
+
+    /**
+     * @brief Design a biquad with the formulas from the Audio EQ Cookbook by Robert
+     * Bristow-Johnson.
+     * @param in_gain The gain in dB of a peak or shelf. Ignored by the other types.
+     * @param in_q The Q of the peak, notch or cutoff, or the slope of a shelf where 0.707 is the
+     * steepest with out overshoot.
+     * @throws ValueError if the frequency is not between 0 and half the rate or the Q is not
+     * positive.
+     *
+     * A peak or shelf with no gain passes the input through unchanged so it gets the identity
+     * coefficients which a BiquadCascade skips.
+     */
+    BiquadCoefficients designBiquad(const BiquadType in_type, const double in_rate, const double in_frequency, const double in_gain, const double in_q)
+    {
+        if (! (in_rate > 0)) throw ValueError("Biquad sample rate must be greater than zero");
+        if (! (in_frequency > 0 && in_frequency < in_rate / 2))
+        {
+            throw ValueError(makeString("Biquad frequency must be between 0 and ", in_rate / 2, ": ", in_frequency));
+        }
+        if (! (in_q > 0)) throw ValueError(makeString("Biquad Q must be greater than zero: ", in_q));
+
+        const auto shaped = in_type == BiquadType::peak || in_type == BiquadType::lowShelf || in_type == BiquadType::highShelf;
+
+        if (shaped && in_gain == 0) return BiquadCoefficients();
+
+        const auto omega = 2 * std::numbers::pi * in_frequency / in_rate;
+        const auto cosine = std::cos(omega);
+        const auto alpha = std::sin(omega) / (2 * in_q);
+        const auto amplitude = std::pow(10.0, in_gain / 40);
+        const auto shelf = 2 * std::sqrt(amplitude) * alpha;
+        double b0 = 1, b1 = 0, b2 = 0, a0 = 1, a1 = 0, a2 = 0;
+
+        switch (in_type)
+        {
+            case BiquadType::peak:
+                b0 = 1 + alpha * amplitude;
+                b1 = -2 * cosine;
+                b2 = 1 - alpha * amplitude;
+                a0 = 1 + alpha / amplitude;
+                a1 = -2 * cosine;
+                a2 = 1 - alpha / amplitude;
+                break;
+
+            case BiquadType::lowShelf:
+                b0 = amplitude * ((amplitude + 1) - (amplitude - 1) * cosine + shelf);
+                b1 = 2 * amplitude * ((amplitude - 1) - (amplitude + 1) * cosine);
+                b2 = amplitude * ((amplitude + 1) - (amplitude - 1) * cosine - shelf);
+                a0 = (amplitude + 1) + (amplitude - 1) * cosine + shelf;
+                a1 = -2 * ((amplitude - 1) + (amplitude + 1) * cosine);
+                a2 = (amplitude + 1) + (amplitude - 1) * cosine - shelf;
+                break;
+
+            case BiquadType::highShelf:
+                b0 = amplitude * ((amplitude + 1) + (amplitude - 1) * cosine + shelf);
+                b1 = -2 * amplitude * ((amplitude - 1) + (amplitude + 1) * cosine);
+                b2 = amplitude * ((amplitude + 1) + (amplitude - 1) * cosine - shelf);
+                a0 = (amplitude + 1) - (amplitude - 1) * cosine + shelf;
+                a1 = 2 * ((amplitude - 1) - (amplitude + 1) * cosine);
+                a2 = (amplitude + 1) - (amplitude - 1) * cosine - shelf;
+                break;
+
+            case BiquadType::lowPass:
+                b0 = (1 - cosine) / 2;
+                b1 = 1 - cosine;
+                b2 = (1 - cosine) / 2;
+                a0 = 1 + alpha;
+                a1 = -2 * cosine;
+                a2 = 1 - alpha;
+                break;
+
+            case BiquadType::highPass:
+                b0 = (1 + cosine) / 2;
+                b1 = -(1 + cosine);
+                b2 = (1 + cosine) / 2;
+                a0 = 1 + alpha;
+                a1 = -2 * cosine;
+                a2 = 1 - alpha;
+                break;
+
+            case BiquadType::notch:
+                b0 = 1;
+                b1 = -2 * cosine;
+                b2 = 1;
+                a0 = 1 + alpha;
+                a1 = -2 * cosine;
+                a2 = 1 - alpha;
+                break;
+        }
+
+        return { b0 / a0, b1 / a0, b2 / a0, a1 / a0, a2 / a0 };
+    }
+
+    /// @brief The gain of a biquad at a frequency as a ratio.
+    double biquadMagnitude(const BiquadCoefficients& in_coefficients, const double in_rate, const double in_frequency) noexcept
+    {
+        const auto z = std::polar(1.0, -2 * std::numbers::pi * in_frequency / in_rate);
+        const auto numerator = in_coefficients.b0 + (in_coefficients.b1 + in_coefficients.b2 * z) * z;
+        const auto denominator = 1.0 + (in_coefficients.a1 + in_coefficients.a2 * z) * z;
+
+        return std::abs(numerator / denominator);
+    }
+
+    /// @throws ValueError if the name is not a BiquadType.
+    BiquadType stringToBiquadType(const std::string& in_name)
+    {
+        for (const auto type : { BiquadType::peak, BiquadType::lowShelf, BiquadType::highShelf, BiquadType::lowPass, BiquadType::highPass, BiquadType::notch })
+        {
+            if (toString(type) == in_name) return type;
+        }
+
+        throw ValueError(makeString("Unknown biquad type: ", in_name));
+    }
+
+    std::string toString(const BiquadType in_type) noexcept
+    {
+        switch (in_type)
+        {
+            case BiquadType::peak: return "peak";
+            case BiquadType::lowShelf: return "lowShelf";
+            case BiquadType::highShelf: return "highShelf";
+            case BiquadType::lowPass: return "lowPass";
+            case BiquadType::highPass: return "highPass";
+            case BiquadType::notch: return "notch";
+        }
+
+        FATAL_ERROR(makeString("Unhandled BiquadType value: ", static_cast<int>(in_type)));
+    }
+
+    std::ostream& operator<<(std::ostream& in_os, const BiquadType in_type) noexcept
+    {
+        in_os << toString(in_type);
+        return in_os;
+    }
+}
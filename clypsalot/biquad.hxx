@@ -0,0 +1,103 @@
+/* Copyright 2023 Tyler Riddle
+ *
+ * This file is part of Clypsalot. Clypsalot is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU Lesser General Public License as published by the Free Software Foundation, either version 3 of the License,
+ * or (at your option) any later version. Clypsalot is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along with Clypsalot. If not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include <clypsalot/pcm.hxx>
+#include <clypsalot/simd.hxx>
+
+/// @file
+namespace Clypsalot
+{
+    /// @brief The responses a biquad can be designed for.
+    enum class BiquadType : uint_fast8_t
+    {
+        peak,
+        lowShelf,
+        highShelf,
+        lowPass,
+        highPass,
+        notch,
+    };
+
+    /// @brief The coefficients of a biquad normalized so a0 is 1.
+    struct BiquadCoefficients
+    {
+        double b0 = 1;
+        double b1 = 0;
+        double b2 = 0;
+        double a1 = 0;
+        double a2 = 0;
+
+        bool operator==(const BiquadCoefficients&) const noexcept = default;
+        bool identity() const noexcept;
+    };
+
+    /**
+     * @brief A cascade of biquads run in transposed direct form II over every channel of a
+     * float32 buffer.
+     *
+     * The channels are processed in the layout given by pcmSimdLayout() for the level of the
+     * kernel so every sample of a frame across a group of channels is a single vector and a
+     * band costs the same for all of the channels in a group as it does for one. Two groups are
+     * run side by side to hide the latency of the feedback and AVX-512 puts two grouped8 groups
+     * into each register. Every level gives the same result for the same input.
+     *
+     * The coefficients are shared by all of the channels. Bands with the identity coefficients
+     * are skipped. All the memory is allocated by the constructor so the coefficients can be
+     * changed between blocks with out allocating.
+     */
+    class BiquadCascade
+    {
+        public:
+        using Kernel = void (*)(const float* const* in_sources, float* const* out_dests, const std::size_t in_rows, const float* in_coefficients, float* io_state, const std::size_t in_frames) noexcept;
+
+        private:
+        const std::size_t m_channels;
+        const std::size_t m_bands;
+        SimdLevel m_level = SimdLevel::scalar;
+        PcmLayout m_layout = PcmLayout::planar;
+        std::size_t m_rows = 0;
+        Kernel m_kernel = nullptr;
+        std::vector<BiquadCoefficients> m_coefficients;
+        std::vector<float> m_kernelCoefficients;
+        std::vector<float> m_state;
+        std::vector<const float*> m_sources;
+        std::vector<float*> m_dests;
+
+        public:
+        BiquadCascade(const std::size_t in_channels, const std::size_t in_bands, const SimdLevel in_level = simdLevel());
+        BiquadCascade(const BiquadCascade&) = delete;
+        void operator=(const BiquadCascade&) = delete;
+        std::size_t channels() const noexcept;
+        std::size_t bands() const noexcept;
+        SimdLevel level() const noexcept;
+        PcmLayout layout() const noexcept;
+        const BiquadCoefficients& coefficients(const std::size_t in_band) const noexcept;
+        void coefficients(const std::size_t in_band, const BiquadCoefficients& in_coefficients) noexcept;
+        void reset() noexcept;
+        void process(const PcmBuffer& in_source, PcmBuffer& out_dest, const std::size_t in_frames) noexcept;
+    };
+
+    BiquadCoefficients designBiquad(const BiquadType in_type, const double in_rate, const double in_frequency, const double in_gain, const double in_q);
+    double biquadMagnitude(const BiquadCoefficients& in_coefficients, const double in_rate, const double in_frequency) noexcept;
+    BiquadType stringToBiquadType(const std::string& in_name);
+    std::string toString(const BiquadType in_type) noexcept;
+    std::ostream& operator<<(std::ostream& in_os, const BiquadType in_type) noexcept;
+}
@@ -0,0 +1,104 @@
+/* Copyright 2023 Tyler Riddle
+ *
+ * This file is part of Clypsalot. Clypsalot is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU Lesser General Public License as published by the Free Software Foundation, either version 3 of the License,
+ * or (at your option) any later version. Clypsalot is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along with Clypsalot. If not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+
+#include <clypsalot/compressor.hxx>
+#include <clypsalot/control.hxx>
+#include <clypsalot/convolver.hxx>
+#include <clypsalot/equalizer.hxx>
+#include <clypsalot/filesource.hxx>
+#include <clypsalot/gate.hxx>
+#include <clypsalot/module.hxx>
+#include <clypsalot/pcm.hxx>
+#include <clypsalot/pipe.hxx>
+#include <clypsalot/recorder.hxx>
+#include <clypsalot/replay.hxx>
+#include <clypsalot/shm.hxx>
+
+/// @file
+namespace Clypsalot
+{
+    static const std::initializer_list<PortTypeDescriptor> portTypeDescriptors
+    {
+        {
+            PcmPortType::typeName,
+            PcmPortType::singleton,
+            [] (const std::string& name, Object& parent) { return new PcmOutputPort(name, parent); },
+            [] (const std::string& name, Object& parent) { return new PcmInputPort(name, parent); },
+        },
+        {
+            ControlPortType::typeName,
+            ControlPortType::singleton,
+            [] (const std::string& name, Object& parent) { return new ControlOutputPort(name, parent); },
+            [] (const std::string& name, Object& parent) { return new ControlInputPort(name, parent); },
+        },
+    };
+
+    static const std::initializer_list<ObjectDescriptor> objectDescriptors
+    {
+        {
+            CompressorObject::kindName,
+            [] { return CompressorObject::make(); },
+        },
+        {
+            ConvolverObject::kindName,
+            [] { return ConvolverObject::make(); },
+        },
+        {
+            EqualizerObject::kindName,
+            [] { return EqualizerObject::make(); },
+        },
+        {
+            FileSourceObject::kindName,
+            [] { return FileSourceObject::make(); },
+        },
+        {
+            GateObject::kindName,
+            [] { return GateObject::make(); },
+        },
+        {
+            PipeSinkObject::kindName,
+            [] { return PipeSinkObject::make(); },
+        },
+        {
+            PipeSourceObject::kindName,
+            [] { return PipeSourceObject::make(); },
+        },
+        {
+            RecorderObject::kindName,
+            [] { return RecorderObject::make(); },
+        },
+        {
+            ReplayObject::kindName,
+            [] { return ReplayObject::make(); },
+        },
+        {
+            ShmSinkObject::kindName,
+            [] { return ShmSinkObject::make(); },
+        },
+        {
+            ShmSourceObject::kindName,
+            [] { return ShmSourceObject::make(); },
+        },
+    };
+
+    static const ModuleDescriptor moduleDescriptor
+    {
+        portTypeDescriptors,
+        objectDescriptors,
+    };
+
+    /// @brief The port types and objects that are part of the library itself.
+    const ModuleDescriptor* builtinModuleDescriptor()
+    {
+        return &moduleDescriptor;
+    }
+}
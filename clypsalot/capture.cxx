@@ -0,0 +1,319 @@
+/* Copyright 2023 Tyler Riddle
+ *
+ * This file is part of Clypsalot. Clypsalot is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU Lesser General Public License as published by the Free Software Foundation, either version 3 of the License,
+ * or (at your option) any later version. Clypsalot is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along with Clypsalot. If not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+
+
+#include <algorithm>
+#include <cassert>
+#include <cerrno>
+#include <cstring>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <clypsalot/capture.hxx>
+#include <clypsalot/error.hxx>
+#include <clypsalot/macros.hxx>
+#include <clypsalot/util.hxx>
+
+/// @file
+namespace Clypsalot
+{
+    // The header is rewritten with the totals when the capture is finished.
+    struct CaptureHeader
+    {
+        std::uint64_t magic = 0;
+        std::uint32_t version = 0;
+        std::uint32_t kind = 0;
+        std::uint32_t format = 0;
+        std::uint32_t layout = 0;
+        std::uint64_t channels = 0;
+        std::uint64_t blockSize = 0;
+        std::uint64_t rate = 0;
+        std::uint64_t records = 0;
+        std::uint64_t dropped = 0;
+        // 0 until the capture is finished.
+        std::uint64_t dataBytes = 0;
+    };
+
+    // The payload follows and is padded to a multiple of 8 bytes.
+    struct CaptureRecordHeader
+    {
+        std::uint64_t time = 0;
+        std::uint32_t count = 0;
+        std::uint32_t bytes = 0;
+    };
+
+    static_assert(sizeof(CaptureHeader) % 8 == 0);
+    static_assert(sizeof(CaptureRecordHeader) == 16);
+
+    // "CLYPCAPT" when read from the start of a file on a little endian host.
+    static constexpr std::uint64_t captureMagic = 0x5450414350594c43;
+    static constexpr std::uint32_t captureVersion = 1;
+    static constexpr std::byte capturePadding[8] = { };
+
+    static std::size_t padded(const std::size_t in_bytes) noexcept
+    {
+        return (in_bytes + 7) / 8 * 8;
+    }
+
+    static int createCapture(const std::filesystem::path& in_path)
+    {
+        const auto fd = open(in_path.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+
+        if (fd < 0) throw RuntimeError(makeString("Could not create capture ", in_path.string(), ": ", std::strerror(errno)));
+
+        return fd;
+    }
+
+    /**
+     * @throws RuntimeError if the file can not be created.
+     *
+     * An existing file is replaced.
+     */
+    LinkCapture::LinkCapture(const std::filesystem::path& in_path, const CaptureInfo& in_info, const std::size_t in_ringSize) :
+        m_info(in_info),
+        m_path(in_path),
+        m_start(std::chrono::steady_clock::now()),
+        m_fd(createCapture(in_path)),
+        m_writer(m_fd, in_ringSize, sizeof(CaptureHeader), in_ringSize / 4)
+    { }
+
+    // Write whatever is left in the ring and then the totals.
+    LinkCapture::~LinkCapture() noexcept
+    {
+        m_writer.finish(true);
+        m_writer.wait();
+
+        CaptureHeader header;
+
+        header.magic = captureMagic;
+        header.version = captureVersion;
+        header.kind = static_cast<std::uint32_t>(m_info.kind);
+        header.format = static_cast<std::uint32_t>(m_info.config.format);
+        header.layout = static_cast<std::uint32_t>(m_info.config.layout);
+        header.channels = m_info.config.channels;
+        header.blockSize = m_info.config.blockSize;
+        header.rate = m_info.config.rate;
+        header.records = records();
+        header.dropped = dropped();
+        header.dataBytes = m_writer.position() - sizeof(header);
+
+        if (const auto error = writeAt(m_fd, reinterpret_cast<const std::byte*>(&header), sizeof(header), 0)) m_writer.fail(error);
+
+        close(m_fd);
+    }
+
+    const CaptureInfo& LinkCapture::info() const noexcept
+    {
+        return m_info;
+    }
+
+    const std::filesystem::path& LinkCapture::path() const noexcept
+    {
+        return m_path;
+    }
+
+    /// @brief The number of records that went in to the ring.
+    std::size_t LinkCapture::records() const noexcept
+    {
+        return m_records.load(std::memory_order_relaxed);
+    }
+
+    /// @brief The number of records that were thrown away because the ring was full.
+    std::size_t LinkCapture::dropped() const noexcept
+    {
+        return m_dropped.load(std::memory_order_relaxed);
+    }
+
+    /// @brief The errno value of the first failure to write the file or 0. Records are thrown
+    /// away after a failure.
+    int LinkCapture::error() const noexcept
+    {
+        return m_writer.error();
+    }
+
+    bool LinkCapture::reserve(const std::size_t in_bytes) noexcept
+    {
+        if (m_writer.ring().space() >= in_bytes) return true;
+
+        m_dropped.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    void LinkCapture::committed() noexcept
+    {
+        m_records.fetch_add(1, std::memory_order_relaxed);
+        m_writer.commit();
+    }
+
+    /**
+     * @brief Record the first frames of a block.
+     * @return false if the record was dropped.
+     *
+     * Only the thread delivering to the link may call this. Empty blocks are not recorded.
+     */
+    bool LinkCapture::record(const PcmBuffer& in_buffer, const std::size_t in_frames) noexcept
+    {
+        assert(m_info.kind == CaptureKind::pcm);
+
+        if (in_frames == 0) return true;
+
+        const auto planar = in_buffer.layout() == PcmLayout::planar;
+        const auto rows = planar ? in_buffer.channels() : in_buffer.groups();
+        const auto rowBytes = in_frames * in_buffer.lanes() * pcmSampleSize(in_buffer.format());
+        const auto bytes = rows * rowBytes;
+        const auto time = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - m_start);
+        const CaptureRecordHeader header { static_cast<std::uint64_t>(time.count()), static_cast<std::uint32_t>(in_frames), static_cast<std::uint32_t>(bytes) };
+
+        if (! reserve(sizeof(header) + padded(bytes))) return false;
+
+        auto& ring = m_writer.ring();
+
+        // There is room for all of it so none of the writes can fail.
+        ring.write(reinterpret_cast<const std::byte*>(&header), sizeof(header));
+
+        for (std::size_t row = 0; row < rows; row++)
+        {
+            ring.write(planar ? in_buffer.channelData(row) : in_buffer.groupData(row), rowBytes);
+        }
+
+        ring.write(capturePadding, padded(bytes) - bytes);
+        committed();
+
+        return true;
+    }
+
+    /**
+     * @brief Record an event.
+     * @return false if the record was dropped.
+     *
+     * Only the thread delivering to the link may call this.
+     */
+    bool LinkCapture::record(const ControlEvent& in_event) noexcept
+    {
+        assert(m_info.kind == CaptureKind::control);
+
+        const auto time = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - m_start);
+        const CaptureRecordHeader header { static_cast<std::uint64_t>(time.count()), 1, sizeof(in_event) };
+
+        if (! reserve(sizeof(header) + padded(sizeof(in_event)))) return false;
+
+        auto& ring = m_writer.ring();
+
+        ring.write(reinterpret_cast<const std::byte*>(&header), sizeof(header));
+        ring.write(reinterpret_cast<const std::byte*>(&in_event), sizeof(in_event));
+        ring.write(capturePadding, padded(sizeof(in_event)) - sizeof(in_event));
+        committed();
+
+        return true;
+    }
+
+    /// @throws RuntimeError if the file can not be read.
+    /// @throws ValueError if the file is not a capture.
+    CaptureReader::CaptureReader(const std::filesystem::path& in_path) :
+        m_mapping(in_path)
+    {
+        CaptureHeader header;
+
+        if (m_mapping.bytes() < sizeof(header)) throw ValueError(makeString("Not a capture file: ", in_path.string()));
+
+        std::memcpy(&header, m_mapping.data(), sizeof(header));
+
+        if (header.magic != captureMagic) throw ValueError(makeString("Not a capture file: ", in_path.string()));
+        if (header.version != captureVersion) throw ValueError(makeString("Unsupported capture version ", header.version, ": ", in_path.string()));
+        if (header.kind > static_cast<std::uint32_t>(CaptureKind::control)) throw ValueError(makeString("Unknown capture kind ", header.kind, ": ", in_path.string()));
+
+        m_info.kind = static_cast<CaptureKind>(header.kind);
+
+        if (m_info.kind == CaptureKind::pcm)
+        {
+            if (header.format > static_cast<std::uint32_t>(PcmFormat::float64) || header.layout > static_cast<std::uint32_t>(PcmLayout::grouped8)
+                || header.channels == 0 || header.blockSize == 0)
+            {
+                throw ValueError(makeString("Invalid PCM capture: ", in_path.string()));
+            }
+
+            m_info.config.format = static_cast<PcmFormat>(header.format);
+            m_info.config.layout = static_cast<PcmLayout>(header.layout);
+            m_info.config.channels = header.channels;
+            m_info.config.blockSize = header.blockSize;
+            m_info.config.rate = header.rate;
+        }
+
+        m_records = header.records;
+        m_dropped = header.dropped;
+        m_begin = sizeof(header);
+        m_end = header.dataBytes > 0 ? std::min(m_begin + header.dataBytes, m_mapping.bytes()) : m_mapping.bytes();
+        m_position = m_begin;
+    }
+
+    const CaptureInfo& CaptureReader::info() const noexcept
+    {
+        return m_info;
+    }
+
+    /// @brief The number of records in a finished capture or 0 if it was not finished.
+    std::size_t CaptureReader::records() const noexcept
+    {
+        return m_records;
+    }
+
+    std::size_t CaptureReader::dropped() const noexcept
+    {
+        return m_dropped;
+    }
+
+    /// @return false once there are no more records.
+    bool CaptureReader::next(CaptureRecord& out_record) noexcept
+    {
+        CaptureRecordHeader header;
+
+        if (m_position + sizeof(header) > m_end) return false;
+
+        std::memcpy(&header, m_mapping.data() + m_position, sizeof(header));
+
+        // The part of the last window of an unfinished capture that was never written is zeros.
+        if (header.count == 0) return false;
+        if (m_position + sizeof(header) + header.bytes > m_end) return false;
+
+        out_record.time = header.time;
+        out_record.count = header.count;
+        out_record.data = m_mapping.data() + m_position + sizeof(header);
+        out_record.bytes = header.bytes;
+        m_position = std::min(m_position + sizeof(header) + padded(header.bytes), m_end);
+
+        return true;
+    }
+
+    /// @brief Go back to the first record.
+    void CaptureReader::rewind() noexcept
+    {
+        m_position = m_begin;
+    }
+
+    std::string toString(const CaptureKind in_kind) noexcept
+    {
+        switch (in_kind)
+        {
+            case CaptureKind::pcm: return "pcm";
+            case CaptureKind::control: return "control";
+        }
+
+        FATAL_ERROR(makeString("Unhandled CaptureKind value: ", static_cast<int>(in_kind)));
+    }
+
+    std::ostream& operator<<(std::ostream& in_os, const CaptureKind in_kind) noexcept
+    {
+        in_os << toString(in_kind);
+        return in_os;
+    }
+}
@@ -0,0 +1,123 @@
+/* Copyright 2023 Tyler Riddle
+ *
+ * This file is part of Clypsalot. Clypsalot is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU Lesser General Public License as published by the Free Software Foundation, either version 3 of the License,
+ * or (at your option) any later version. Clypsalot is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along with Clypsalot. If not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+
+#include <clypsalot/control.hxx>
+#include <clypsalot/io.hxx>
+#include <clypsalot/memory.hxx>
+#include <clypsalot/pcm.hxx>
+
+/// @file
+namespace Clypsalot
+{
+    enum class CaptureKind : std::uint32_t
+    {
+        pcm,
+        control,
+    };
+
+    /// @brief What a capture holds. The PCM settings are those of the output of the link and are
+    /// not used by control captures.
+    struct CaptureInfo
+    {
+        CaptureKind kind = CaptureKind::pcm;
+        PcmConfig config;
+    };
+
+    /**
+     * @brief A block or an event read from a capture file.
+     *
+     * The time is in nanoseconds since the capture started. A PCM record holds the frames of a
+     * block one channel or group of channels after the other in the layout of the link and a
+     * control record holds a single ControlEvent.
+     */
+    struct CaptureRecord
+    {
+        std::uint64_t time = 0;
+        std::size_t count = 0;
+        const std::byte* data = nullptr;
+        std::size_t bytes = 0;
+    };
+
+    /**
+     * @brief Write the traffic of a PortLink to a capture file.
+     *
+     * Recording only copies the block or event with a timestamp into the ring of a RingWriter so
+     * it can be left on in production. Writing starts once a quarter of the ring is used. When the
+     * ring does not have room the record is dropped and counted instead of holding up the output.
+     * The file is finished when the capture is destroyed.
+     */
+    class LinkCapture
+    {
+        const CaptureInfo m_info;
+        const std::filesystem::path m_path;
+        const std::chrono::steady_clock::time_point m_start;
+        const int m_fd;
+        std::atomic_size_t m_records = 0;
+        std::atomic_size_t m_dropped = 0;
+        RingWriter m_writer;
+
+        bool reserve(const std::size_t in_bytes) noexcept;
+        void committed() noexcept;
+
+        public:
+        static constexpr std::size_t defaultRingSize = 4 * 1024 * 1024;
+
+        LinkCapture(const std::filesystem::path& in_path, const CaptureInfo& in_info, const std::size_t in_ringSize = defaultRingSize);
+        LinkCapture(const LinkCapture&) = delete;
+        ~LinkCapture() noexcept;
+        void operator=(const LinkCapture&) = delete;
+        const CaptureInfo& info() const noexcept;
+        const std::filesystem::path& path() const noexcept;
+        std::size_t records() const noexcept;
+        std::size_t dropped() const noexcept;
+        int error() const noexcept;
+        bool record(const PcmBuffer& in_buffer, const std::size_t in_frames) noexcept;
+        bool record(const ControlEvent& in_event) noexcept;
+    };
+
+    /**
+     * @brief Read back the records of a capture file.
+     *
+     * The file is memory mapped. A capture that was not finished such as after a crash is read up
+     * to the last record that made it to the file.
+     */
+    class CaptureReader
+    {
+        FileMapping m_mapping;
+        CaptureInfo m_info;
+        std::size_t m_records = 0;
+        std::size_t m_dropped = 0;
+        std::size_t m_begin = 0;
+        std::size_t m_end = 0;
+        std::size_t m_position = 0;
+
+        public:
+        explicit CaptureReader(const std::filesystem::path& in_path);
+        const CaptureInfo& info() const noexcept;
+        std::size_t records() const noexcept;
+        std::size_t dropped() const noexcept;
+        bool next(CaptureRecord& out_record) noexcept;
+        void rewind() noexcept;
+    };
+
+    std::string toString(const CaptureKind in_kind) noexcept;
+    std::ostream& operator<<(std::ostream& in_os, const CaptureKind in_kind) noexcept;
+}
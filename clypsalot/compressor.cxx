@@ -0,0 +1,235 @@
+/* Copyright 2023 Tyler Riddle
+ *
+ * This file is part of Clypsalot. Clypsalot is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU Lesser General Public License as published by the Free Software Foundation, either version 3 of the License,
+ * or (at your option) any later version. Clypsalot is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along with Clypsalot. If not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+
+
+#include <cassert>
+#include <cmath>
+#include <utility>
+
+#include <clypsalot/compressor.hxx>
+#include <clypsalot/error.hxx>
+#include <clypsalot/logger.hxx>
+#include <clypsalot/pcm.hxx>
+#include <clypsalot/property.hxx>
+#include <clypsalot/util.hxx>
+
+/// @file
+namespace Clypsalot
+{
+    const std::string CompressorObject::kindName = "Compressor";
+    static const std::string channelsPropertyName = "Channels";
+    static const std::string sampleRatePropertyName = "Sample Rate";
+    static const std::string blockSizePropertyName = "Block Size";
+    static const std::string detectorPropertyName = "Detector";
+    static const std::string thresholdPropertyName = "Threshold";
+    static const std::string ratioPropertyName = "Ratio";
+    static const std::string kneePropertyName = "Knee";
+    static const std::string attackPropertyName = "Attack";
+    static const std::string releasePropertyName = "Release";
+    static const std::string makeupPropertyName = "Makeup";
+    static const std::string rmsWindowPropertyName = "RMS Window";
+    static const std::string lookaheadPropertyName = "Lookahead";
+    static const std::string sidechainPropertyName = "Sidechain";
+    static const std::string latencyPropertyName = "Latency";
+    static const std::string gainReductionPropertyName = "Gain Reduction";
+    static const std::string sidechainName = "sidechain";
+    static constexpr auto controlFlags = Property::Configurable | Property::PublicMutable;
+    static const PropertyList compressorProperties = {
+        { channelsPropertyName, PropertyType::size, Property::Configurable | Property::Required, nullptr },
+        { sampleRatePropertyName, PropertyType::size, Property::Configurable, 48000 },
+        { blockSizePropertyName, PropertyType::size, Property::Configurable, 256 },
+        // Levels are in dB and times are in milliseconds.
+        { detectorPropertyName, PropertyType::string, controlFlags, toString(CompressorDetector::peak) },
+        { thresholdPropertyName, PropertyType::real, controlFlags, -18.0 },
+        { ratioPropertyName, PropertyType::real, controlFlags, 4.0 },
+        { kneePropertyName, PropertyType::real, controlFlags, 6.0 },
+        { attackPropertyName, PropertyType::real, controlFlags, 10.0 },
+        { releasePropertyName, PropertyType::real, controlFlags, 100.0 },
+        { makeupPropertyName, PropertyType::real, controlFlags, 0.0 },
+        { rmsWindowPropertyName, PropertyType::real, controlFlags, 10.0 },
+        { lookaheadPropertyName, PropertyType::real, Property::Configurable, 0.0 },
+        { sidechainPropertyName, PropertyType::boolean, Property::Configurable, false },
+        // The delay added by the lookahead in frames.
+        { latencyPropertyName, PropertyType::size, Property::NoFlags, 0 },
+        // The most gain reduction of any channel during the last period in dB.
+        { gainReductionPropertyName, PropertyType::real, Property::NoFlags, 0.0 },
+    };
+
+    std::shared_ptr<CompressorObject> CompressorObject::make()
+    {
+        return _makeObject<CompressorObject>(kindName);
+    }
+
+    CompressorObject::CompressorObject(const std::string& in_kind) :
+        Object(in_kind)
+    {
+        std::scoped_lock lock(*this);
+
+        addProperties(compressorProperties);
+
+        m_input = static_cast<PcmInputPort*>(&addInput<PcmInputPort>("input"));
+        m_output = static_cast<PcmOutputPort*>(&addOutput<PcmOutputPort>("output"));
+        m_output->inPlace(m_input);
+        m_gainReduction = &propertyRealRef(gainReductionPropertyName);
+        m_controlProperties.detector = &property(propertyHandle(detectorPropertyName));
+        m_controlProperties.threshold = &property(propertyHandle(thresholdPropertyName));
+        m_controlProperties.ratio = &property(propertyHandle(ratioPropertyName));
+        m_controlProperties.knee = &property(propertyHandle(kneePropertyName));
+        m_controlProperties.attack = &property(propertyHandle(attackPropertyName));
+        m_controlProperties.release = &property(propertyHandle(releasePropertyName));
+        m_controlProperties.makeup = &property(propertyHandle(makeupPropertyName));
+        m_controlProperties.rmsWindow = &property(propertyHandle(rmsWindowPropertyName));
+    }
+
+    /// @throws RuntimeError if the Object was not configured.
+    const PcmCompressor& CompressorObject::compressor() const
+    {
+        assert(haveLock());
+
+        if (! m_compressor) throw RuntimeError("The compressor has not been configured");
+
+        return *m_compressor;
+    }
+
+    /// @brief The number of frames the output is behind the input.
+    std::size_t CompressorObject::latency() const noexcept
+    {
+        assert(haveLock());
+
+        return m_compressor ? m_compressor->latency() : 0;
+    }
+
+    /// @throws ValueError if the detector is unknown.
+    CompressorSettings CompressorObject::toSettings(const Controls& in_controls)
+    {
+        CompressorSettings settings;
+
+        settings.detector = stringToCompressorDetector(in_controls.detector);
+        settings.threshold = in_controls.threshold;
+        settings.ratio = in_controls.ratio;
+        settings.knee = in_controls.knee;
+        settings.attack = in_controls.attack;
+        settings.release = in_controls.release;
+        settings.makeup = in_controls.makeup;
+        settings.rmsWindow = in_controls.rmsWindow;
+
+        return settings;
+    }
+
+    void CompressorObject::readControls(Controls& out_controls) const
+    {
+        out_controls.detector = m_controlProperties.detector->stringValue();
+        out_controls.threshold = m_controlProperties.threshold->realValue();
+        out_controls.ratio = m_controlProperties.ratio->realValue();
+        out_controls.knee = m_controlProperties.knee->realValue();
+        out_controls.attack = m_controlProperties.attack->realValue();
+        out_controls.release = m_controlProperties.release->realValue();
+        out_controls.makeup = m_controlProperties.makeup->realValue();
+        out_controls.rmsWindow = m_controlProperties.rmsWindow->realValue();
+    }
+
+    /**
+     * @throws ValueError if there are no channels, a control is not valid or the sidechain was
+     * turned off after the sidechain input was added.
+     */
+    void CompressorObject::handleConfigure(const ObjectConfig& in_config)
+    {
+        assert(haveLock());
+
+        Object::handleConfigure(in_config);
+
+        const auto& channels = property(channelsPropertyName);
+
+        if (! channels.defined()) throw ValueError(makeString("Property is required: ", channelsPropertyName));
+
+        const auto rate = property(sampleRatePropertyName).sizeValue();
+        const auto blockSize = property(blockSizePropertyName).sizeValue();
+        const auto lookahead = property(lookaheadPropertyName).realValue();
+        const auto sidechain = property(sidechainPropertyName).booleanValue();
+
+        if (rate == 0) throw ValueError(makeString(sampleRatePropertyName, " must be greater than zero"));
+        if (blockSize == 0) throw ValueError(makeString(blockSizePropertyName, " must be greater than zero"));
+        if (! (lookahead >= 0)) throw ValueError(makeString(lookaheadPropertyName, " can not be negative: ", lookahead));
+        if (! sidechain && m_sidechain != nullptr) throw ValueError("The sidechain input can not be removed");
+
+        auto compressor = std::make_unique<PcmCompressor>(channels.sizeValue(), rate, std::lround(lookahead * rate / 1000));
+        const PcmConfig config = { PcmFormat::float32, compressor->channels(), blockSize, 0, rate, compressor->layout() };
+
+        readControls(m_read);
+        compressor->settings(toSettings(m_read));
+
+        if (sidechain && m_sidechain == nullptr) m_sidechain = static_cast<PcmInputPort*>(&addInput<PcmInputPort>(sidechainName));
+
+        m_input->config(config);
+        m_output->config(config);
+        if (m_sidechain != nullptr) m_sidechain->config(config);
+
+        propertySizeRef(latencyPropertyName) = compressor->latency();
+        *m_gainReduction = 0;
+        std::swap(m_current, m_read);
+        m_rejected.reset();
+        m_compressor = std::move(compressor);
+
+        OBJECT_LOGGER(debug, "Configured ", config.channels, " channels with ", m_compressor->level(), " kernels; latency=", m_compressor->latency());
+    }
+
+    /**
+     * @throws RuntimeError if the input has more frames than the block size or the sidechain has
+     * a different number of frames than the input.
+     */
+    ObjectProcessResult CompressorObject::process()
+    {
+        assert(haveLock());
+
+        const auto frames = m_input->frames();
+
+        if (frames > m_output->config().blockSize) throw RuntimeError(makeString("Input block is larger than ", blockSizePropertyName));
+        if (m_sidechain != nullptr && m_sidechain->frames() != frames)
+        {
+            throw RuntimeError(makeString("Sidechain has ", m_sidechain->frames(), " frames but the input has ", frames));
+        }
+
+        readControls(m_read);
+
+        // Controls that were rejected once are not checked or logged again until they change.
+        if (m_read != m_current && m_read != m_rejected)
+        {
+            try
+            {
+                m_compressor->settings(toSettings(m_read));
+                std::swap(m_current, m_read);
+            }
+            catch (const ValueError& e)
+            {
+                m_rejected = m_read;
+                OBJECT_LOGGER(warn, "Keeping the current settings: ", e.what());
+            }
+        }
+
+        auto& buffer = m_output->buffer();
+
+        if (m_sidechain != nullptr)
+        {
+            m_compressor->process(m_sidechain->buffer(), buffer, frames);
+            m_sidechain->consume();
+        }
+        else
+        {
+            m_compressor->process(buffer, frames);
+        }
+
+        *m_gainReduction = m_compressor->gainReduction();
+        m_output->commit(frames);
+
+        return ObjectProcessResult::finished;
+    }
+}
@@ -0,0 +1,90 @@
+/* Copyright 2023 Tyler Riddle
+ *
+ * This file is part of Clypsalot. Clypsalot is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU Lesser General Public License as published by the Free Software Foundation, either version 3 of the License,
+ * or (at your option) any later version. Clypsalot is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along with Clypsalot. If not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#include <memory>
+#include <optional>
+#include <string>
+
+#include <clypsalot/dynamics.hxx>
+#include <clypsalot/object.hxx>
+
+/// @file
+namespace Clypsalot
+{
+    /**
+     * @brief A compressor and limiter with an optional sidechain.
+     *
+     * The Sidechain property adds an input named "sidechain" whose level drives the gain
+     * reduction instead of the input's own. It has to deliver the same number of frames as the
+     * input every period. Lookahead is set when the Object is configured and the delay it adds
+     * is in the Latency property in frames so the graph can compensate. The other controls can
+     * be changed while the Object runs and take effect at the start of the next period. Controls
+     * that are not valid are logged and the current settings are kept until they are valid again.
+     */
+    class CompressorObject : public Object
+    {
+        // The controls as they were read which might not be valid.
+        struct Controls
+        {
+            std::string detector;
+            float threshold = 0;
+            float ratio = 0;
+            float knee = 0;
+            float attack = 0;
+            float release = 0;
+            float makeup = 0;
+            float rmsWindow = 0;
+
+            bool operator==(const Controls&) const noexcept = default;
+        };
+
+        struct ControlProperties
+        {
+            const Property* detector = nullptr;
+            const Property* threshold = nullptr;
+            const Property* ratio = nullptr;
+            const Property* knee = nullptr;
+            const Property* attack = nullptr;
+            const Property* release = nullptr;
+            const Property* makeup = nullptr;
+            const Property* rmsWindow = nullptr;
+        };
+
+        PcmInputPort* m_input = nullptr;
+        PcmInputPort* m_sidechain = nullptr;
+        PcmOutputPort* m_output = nullptr;
+        std::unique_ptr<PcmCompressor> m_compressor;
+        float* m_gainReduction = nullptr;
+        ControlProperties m_controlProperties;
+        Controls m_current;
+        Controls m_read;
+        std::optional<Controls> m_rejected;
+
+        static CompressorSettings toSettings(const Controls& in_controls);
+        void readControls(Controls& out_controls) const;
+
+        protected:
+        virtual void handleConfigure(const ObjectConfig& in_config) override;
+        virtual ObjectProcessResult process() override;
+
+        public:
+        static const std::string kindName;
+
+        static std::shared_ptr<CompressorObject> make();
+        CompressorObject(const std::string& in_kind);
+        const PcmCompressor& compressor() const;
+        std::size_t latency() const noexcept;
+    };
+}
@@ -0,0 +1,253 @@
+/* Copyright 2023 Tyler Riddle
+ *
+ * This file is part of Clypsalot. Clypsalot is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU Lesser General Public License as published by the Free Software Foundation, either version 3 of the License,
+ * or (at your option) any later version. Clypsalot is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along with Clypsalot. If not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <cassert>
+
+#include <clypsalot/capture.hxx>
+#include <clypsalot/control.hxx>
+#include <clypsalot/error.hxx>
+#include <clypsalot/macros.hxx>
+#include <clypsalot/object.hxx>
+#include <clypsalot/util.hxx>
+
+/// @file
+namespace Clypsalot
+{
+    const std::string ControlPortType::typeName = "control";
+    const ControlPortType ControlPortType::singleton = ControlPortType();
+
+    /// @brief The number of events a link holds when neither port asks for more.
+    static constexpr std::size_t defaultControlCapacity = 256;
+
+    [[noreturn]] static void controlLinkedError(const Port& in_port)
+    {
+        throw RuntimeError(makeString("Can not change the settings of a linked control port: ", in_port.name()));
+    }
+
+    ControlPortType::ControlPortType() :
+        PortType(typeName)
+    { }
+
+    /**
+     * @brief Create a link with room for the larger of the capacities the ports ask for.
+     * @throws TypeError if either port is not a control port.
+     * @throws RuntimeError if the input port already has a link.
+     */
+    PortLink* ControlPortType::makeLink(OutputPort& from, InputPort& to) const
+    {
+        auto output = dynamic_cast<ControlOutputPort*>(&from);
+        auto input = dynamic_cast<ControlInputPort*>(&to);
+
+        if (output == nullptr || input == nullptr)
+        {
+            throw TypeError("Incompatible port types when creating a link");
+        }
+
+        // Events from more than one output would need a queue with more than one producer.
+        if (input->links().size() > 0)
+        {
+            throw RuntimeError(makeString("Control input port can only have one link: ", input->name()));
+        }
+
+        const auto slots = std::max(output->capacity(), input->capacity());
+
+        return new ControlPortLink(*output, *input, slots ? slots : defaultControlCapacity);
+    }
+
+    ControlPortLink::ControlPortLink(ControlOutputPort& in_from, ControlInputPort& in_to, const std::size_t in_slots) :
+        RingPortLink(in_from, in_to, in_slots)
+    { }
+
+    std::unique_ptr<LinkCapture> ControlPortLink::makeCapture(const std::filesystem::path& in_path, const std::size_t in_ringSize) const
+    {
+        return std::make_unique<LinkCapture>(in_path, CaptureInfo { CaptureKind::control, { } }, in_ringSize);
+    }
+
+    ControlOutputPort::ControlOutputPort(const std::string& in_name, Object& in_parent) :
+        OutputPort(in_name, ControlPortType::singleton, in_parent)
+    { }
+
+    /// @brief The number of events the links of the port should hold or 0 for the default.
+    std::size_t ControlOutputPort::capacity() const noexcept
+    {
+        assert(m_parent.haveLock());
+
+        return m_capacity;
+    }
+
+    /// @throws RuntimeError if the port is linked.
+    void ControlOutputPort::capacity(const std::size_t in_capacity)
+    {
+        assert(m_parent.haveLock());
+
+        if (portLinks.size() > 0) controlLinkedError(*this);
+
+        m_capacity = in_capacity;
+    }
+
+    /**
+     * @brief Send an event to every link.
+     * @return false with out sending the event anywhere if any link is full.
+     *
+     * Events for a period must be pushed in the order of their offsets. An output with no links
+     * drops the event.
+     */
+    bool ControlOutputPort::push(const ControlEvent& in_event) noexcept
+    {
+        assert(m_parent.haveLock());
+
+        // Only this thread adds to the rings so a link with room now still has it below.
+        for (const auto link : portLinks)
+        {
+            if (static_cast<const ControlPortLink*>(link)->full()) return false;
+        }
+
+        for (const auto link : portLinks)
+        {
+            static_cast<ControlPortLink*>(link)->push(in_event);
+
+            if (const auto recording = link->capture()) recording->record(in_event);
+        }
+
+        return true;
+    }
+
+    /// @brief True if every link has room for another event.
+    bool ControlOutputPort::ready() const noexcept
+    {
+        assert(m_parent.haveLock());
+
+        for (const auto link : portLinks)
+        {
+            if (static_cast<const ControlPortLink*>(link)->full()) return false;
+        }
+
+        return true;
+    }
+
+    ControlInputPort::ControlInputPort(const std::string& in_name, Object& in_parent) :
+        InputPort(in_name, ControlPortType::singleton, in_parent)
+    { }
+
+    ControlPortLink& ControlInputPort::link() const noexcept
+    {
+        assert(portLinks.size() == 1);
+
+        return *static_cast<ControlPortLink*>(portLinks.front());
+    }
+
+    /// @brief The number of events the link of the port should hold or 0 for the default.
+    std::size_t ControlInputPort::capacity() const noexcept
+    {
+        assert(m_parent.haveLock());
+
+        return m_capacity;
+    }
+
+    /// @throws RuntimeError if the port is linked.
+    void ControlInputPort::capacity(const std::size_t in_capacity)
+    {
+        assert(m_parent.haveLock());
+
+        if (portLinks.size() > 0) controlLinkedError(*this);
+
+        m_capacity = in_capacity;
+    }
+
+    /**
+     * @brief True if the port does not hold up the parent when there are no events.
+     *
+     * An Object that only handles events leaves its inputs required so it is not scheduled until
+     * an event arrives. An Object that also processes audio makes them optional so it runs every
+     * period and handles whatever events have arrived.
+     */
+    bool ControlInputPort::optional() const noexcept
+    {
+        assert(m_parent.haveLock());
+
+        return m_optional;
+    }
+
+    void ControlInputPort::optional(const bool in_optional)
+    {
+        assert(m_parent.haveLock());
+
+        m_optional = in_optional;
+    }
+
+    std::size_t ControlInputPort::size() const noexcept
+    {
+        assert(m_parent.haveLock());
+
+        if (portLinks.size() == 0) return 0;
+
+        return link().size();
+    }
+
+    /// @brief The oldest event or nullptr if there are none.
+    const ControlEvent* ControlInputPort::front() const noexcept
+    {
+        assert(m_parent.haveLock());
+
+        if (portLinks.size() == 0) return nullptr;
+
+        return link().front();
+    }
+
+    /// @brief The oldest event if its offset is before the given frame or nullptr otherwise.
+    const ControlEvent* ControlInputPort::next(const std::size_t in_end) const noexcept
+    {
+        const auto event = front();
+
+        if (event == nullptr || event->offset >= in_end) return nullptr;
+
+        return event;
+    }
+
+    void ControlInputPort::pop() noexcept
+    {
+        assert(m_parent.haveLock());
+        assert(portLinks.size() == 1);
+
+        link().pop();
+    }
+
+    bool ControlInputPort::ready() const noexcept
+    {
+        assert(m_parent.haveLock());
+
+        if (m_optional) return true;
+        if (portLinks.size() == 0) return false;
+
+        return ! link().empty();
+    }
+
+    std::string toString(const ControlEventKind in_kind) noexcept
+    {
+        switch (in_kind)
+        {
+            case ControlEventKind::noteOn: return "note on";
+            case ControlEventKind::noteOff: return "note off";
+            case ControlEventKind::trigger: return "trigger";
+            case ControlEventKind::parameter: return "parameter";
+        }
+
+        FATAL_ERROR(makeString("Unhandled ControlEventKind value: ", static_cast<int>(in_kind)));
+    }
+
+    std::ostream& operator<<(std::ostream& in_os, const ControlEventKind in_kind) noexcept
+    {
+        in_os << toString(in_kind);
+        return in_os;
+    }
+}
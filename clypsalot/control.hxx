@@ -0,0 +1,112 @@
+/* Copyright 2023 Tyler Riddle
+ *
+ * This file is part of Clypsalot. Clypsalot is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU Lesser General Public License as published by the Free Software Foundation, either version 3 of the License,
+ * or (at your option) any later version. Clypsalot is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along with Clypsalot. If not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <type_traits>
+
+#include <clypsalot/port.hxx>
+
+/// @file
+namespace Clypsalot
+{
+    enum class ControlEventKind : std::uint8_t
+    {
+        noteOn,
+        noteOff,
+        trigger,
+        parameter,
+    };
+
+    /**
+     * @brief A small fixed size message carried by a control link.
+     *
+     * The offset is the frame inside the period of the receiver that the event applies to. The
+     * target is the note number for note events and the Property::Handle for parameter events and
+     * the value is the velocity or the new value of the parameter. Triggers can use the fields
+     * however the objects on both ends agree to.
+     */
+    struct ControlEvent
+    {
+        std::uint32_t offset = 0;
+        std::uint32_t target = 0;
+        float value = 0;
+        ControlEventKind kind = ControlEventKind::trigger;
+        std::uint8_t channel = 0;
+    };
+
+    static_assert(std::is_trivially_copyable_v<ControlEvent>);
+    static_assert(sizeof(ControlEvent) <= 16);
+
+    class ControlPortType : public PortType
+    {
+        public:
+        static const std::string typeName;
+        static const ControlPortType singleton;
+
+        ControlPortType();
+        virtual PortLink* makeLink(OutputPort& from, InputPort& to) const override;
+    };
+
+    /**
+     * @brief A link that carries control events in a lock free ring.
+     *
+     * The output copies every event into each of its links so the only thing shared between the
+     * two threads is the ring itself. The number of slots is fixed when the link is created.
+     */
+    class ControlPortLink : public RingPortLink<ControlEvent>
+    {
+        protected:
+        virtual std::unique_ptr<LinkCapture> makeCapture(const std::filesystem::path& in_path, const std::size_t in_ringSize) const override;
+
+        public:
+        ControlPortLink(ControlOutputPort& in_from, ControlInputPort& in_to, const std::size_t in_slots);
+    };
+
+    class ControlOutputPort : public OutputPort
+    {
+        std::size_t m_capacity = 0;
+
+        public:
+        ControlOutputPort(const std::string& in_name, Object& in_parent);
+        std::size_t capacity() const noexcept;
+        void capacity(const std::size_t in_capacity);
+        bool push(const ControlEvent& in_event) noexcept;
+        virtual bool ready() const noexcept override;
+    };
+
+    class ControlInputPort : public InputPort
+    {
+        std::size_t m_capacity = 0;
+        bool m_optional = false;
+
+        ControlPortLink& link() const noexcept;
+
+        public:
+        ControlInputPort(const std::string& in_name, Object& in_parent);
+        std::size_t capacity() const noexcept;
+        void capacity(const std::size_t in_capacity);
+        bool optional() const noexcept;
+        void optional(const bool in_optional);
+        std::size_t size() const noexcept;
+        const ControlEvent* front() const noexcept;
+        const ControlEvent* next(const std::size_t in_end) const noexcept;
+        void pop() noexcept;
+        virtual bool ready() const noexcept override;
+    };
+
+    std::string toString(const ControlEventKind in_kind) noexcept;
+    std::ostream& operator<<(std::ostream& in_os, const ControlEventKind in_kind) noexcept;
+}
@@ -0,0 +1,604 @@
+/* Copyright 2023 Tyler Riddle
+ *
+ * This file is part of Clypsalot. Clypsalot is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU Lesser General Public License as published by the Free Software Foundation, either version 3 of the License,
+ * or (at your option) any later version. Clypsalot is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along with Clypsalot. If not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <concepts>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define CLYPSALOT_X86_KERNELS
+#include <immintrin.h>
+#endif
+
+#include <clypsalot/convert.hxx>
+#include <clypsalot/error.hxx>
+#include <clypsalot/macros.hxx>
+#include <clypsalot/util.hxx>
+
+/// @file
+namespace Clypsalot
+{
+    template <PcmFormat F>
+    struct PcmCodec;
+
+    template <>
+    struct PcmCodec<PcmFormat::int16>
+    {
+        using Sample = std::int16_t;
+        static constexpr double scale = 32768.0;
+        static constexpr double maximum = 32767.0;
+    };
+
+    template <>
+    struct PcmCodec<PcmFormat::int24>
+    {
+        using Sample = std::int32_t;
+        static constexpr double scale = 8388608.0;
+        static constexpr double maximum = 8388607.0;
+    };
+
+    template <>
+    struct PcmCodec<PcmFormat::int32>
+    {
+        using Sample = std::int32_t;
+        static constexpr double scale = 2147483648.0;
+        static constexpr double maximum = 2147483647.0;
+    };
+
+    template <>
+    struct PcmCodec<PcmFormat::float32>
+    {
+        using Sample = float;
+    };
+
+    template <>
+    struct PcmCodec<PcmFormat::float64>
+    {
+        using Sample = double;
+    };
+
+    template <PcmFormat F>
+    using PcmCodecSample = typename PcmCodec<F>::Sample;
+
+    template <PcmFormat F>
+    constexpr bool pcmInteger = std::integral<PcmCodecSample<F>>;
+
+    static std::uint32_t nextRandom(std::uint32_t& io_state) noexcept
+    {
+        io_state ^= io_state << 13;
+        io_state ^= io_state >> 17;
+        io_state ^= io_state << 5;
+
+        return io_state;
+    }
+
+    /// @brief A uniform value in [0, 1) made from the top 23 bits of a random number.
+    static float uniformRandom(std::uint32_t& io_state) noexcept
+    {
+        return (nextRandom(io_state) >> 9) * (1.0f / 8388608.0f);
+    }
+
+    static float ditherNoise(const PcmDither in_dither, std::uint32_t& io_state) noexcept
+    {
+        switch (in_dither)
+        {
+            case PcmDither::none: return 0;
+            case PcmDither::rectangular: return uniformRandom(io_state) - 0.5f;
+            case PcmDither::triangular: return uniformRandom(io_state) - uniformRandom(io_state);
+        }
+
+        FATAL_ERROR(makeString("Unhandled PcmDither value: ", static_cast<int>(in_dither)));
+    }
+
+    template <PcmFormat F>
+    static double decodeSample(const PcmCodecSample<F> in_sample) noexcept
+    {
+        if constexpr (pcmInteger<F>) return in_sample / PcmCodec<F>::scale;
+        else return in_sample;
+    }
+
+    template <PcmFormat F>
+    static PcmCodecSample<F> encodeSample(const double in_value, const float in_noise) noexcept
+    {
+        if constexpr (pcmInteger<F>)
+        {
+            auto value = std::nearbyint(in_value * PcmCodec<F>::scale + in_noise);
+
+            // NaN is sent to the minimum like the vector kernels do.
+            if (value > PcmCodec<F>::maximum) value = PcmCodec<F>::maximum;
+            else if (! (value >= -PcmCodec<F>::scale)) value = -PcmCodec<F>::scale;
+
+            return static_cast<PcmCodecSample<F>>(value);
+        }
+        else
+        {
+            return static_cast<PcmCodecSample<F>>(in_value);
+        }
+    }
+
+    template <PcmFormat From, PcmFormat To>
+    static void convertScalar(const std::byte* in_source, std::byte* out_dest, const std::size_t in_samples, const PcmDither in_dither, std::uint32_t* io_random) noexcept
+    {
+        const auto source = reinterpret_cast<const PcmCodecSample<From>*>(in_source);
+        const auto dest = reinterpret_cast<PcmCodecSample<To>*>(out_dest);
+
+        for (std::size_t i = 0; i < in_samples; i++)
+        {
+            dest[i] = encodeSample<To>(decodeSample<From>(source[i]), ditherNoise(in_dither, io_random[0]));
+        }
+    }
+
+    template <PcmFormat From>
+    static PcmConverter::Kernel scalarKernel(const PcmFormat in_to) noexcept
+    {
+        switch (in_to)
+        {
+            case PcmFormat::int16: return convertScalar<From, PcmFormat::int16>;
+            case PcmFormat::int24: return convertScalar<From, PcmFormat::int24>;
+            case PcmFormat::int32: return convertScalar<From, PcmFormat::int32>;
+            case PcmFormat::float32: return convertScalar<From, PcmFormat::float32>;
+            case PcmFormat::float64: return convertScalar<From, PcmFormat::float64>;
+        }
+
+        FATAL_ERROR(makeString("Unhandled PcmFormat value: ", static_cast<int>(in_to)));
+    }
+
+    static PcmConverter::Kernel scalarKernel(const PcmFormat in_from, const PcmFormat in_to) noexcept
+    {
+        switch (in_from)
+        {
+            case PcmFormat::int16: return scalarKernel<PcmFormat::int16>(in_to);
+            case PcmFormat::int24: return scalarKernel<PcmFormat::int24>(in_to);
+            case PcmFormat::int32: return scalarKernel<PcmFormat::int32>(in_to);
+            case PcmFormat::float32: return scalarKernel<PcmFormat::float32>(in_to);
+            case PcmFormat::float64: return scalarKernel<PcmFormat::float64>(in_to);
+        }
+
+        FATAL_ERROR(makeString("Unhandled PcmFormat value: ", static_cast<int>(in_from)));
+    }
+
+#ifdef CLYPSALOT_X86_KERNELS
+    /*
+     * The vector kernels handle as many whole vectors as they can and hand the rest to the
+     * scalar kernel. Loads and stores are unaligned so the kernels work on any pointer but the
+     * channels of a PcmBuffer are always aligned. The noise generator runs one xorshift per lane
+     * and lane 0 continues into the scalar tail.
+     */
+
+    __attribute__((target("sse2")))
+    static __m128i nextRandomSse2(__m128i& io_state) noexcept
+    {
+        io_state = _mm_xor_si128(io_state, _mm_slli_epi32(io_state, 13));
+        io_state = _mm_xor_si128(io_state, _mm_srli_epi32(io_state, 17));
+        io_state = _mm_xor_si128(io_state, _mm_slli_epi32(io_state, 5));
+
+        return io_state;
+    }
+
+    __attribute__((target("sse2")))
+    static __m128 uniformRandomSse2(__m128i& io_state) noexcept
+    {
+        return _mm_mul_ps(_mm_cvtepi32_ps(_mm_srli_epi32(nextRandomSse2(io_state), 9)), _mm_set1_ps(1.0f / 8388608.0f));
+    }
+
+    __attribute__((target("sse2")))
+    static __m128 ditherNoiseSse2(const PcmDither in_dither, __m128i& io_state) noexcept
+    {
+        switch (in_dither)
+        {
+            case PcmDither::none: return _mm_setzero_ps();
+            case PcmDither::rectangular: return _mm_sub_ps(uniformRandomSse2(io_state), _mm_set1_ps(0.5f));
+            case PcmDither::triangular: return _mm_sub_ps(uniformRandomSse2(io_state), uniformRandomSse2(io_state));
+        }
+
+        FATAL_ERROR(makeString("Unhandled PcmDither value: ", static_cast<int>(in_dither)));
+    }
+
+    template <PcmFormat From>
+    __attribute__((target("sse2")))
+    static void integerToFloatSse2(const std::byte* in_source, std::byte* out_dest, const std::size_t in_samples, const PcmDither in_dither, std::uint32_t* io_random) noexcept
+    {
+        const auto source = reinterpret_cast<const PcmCodecSample<From>*>(in_source);
+        const auto dest = reinterpret_cast<float*>(out_dest);
+        const auto scale = _mm_set1_ps(static_cast<float>(1.0 / PcmCodec<From>::scale));
+        std::size_t i = 0;
+
+        for (; i + 4 <= in_samples; i += 4)
+        {
+            __m128i integers;
+
+            if constexpr (From == PcmFormat::int16)
+            {
+                const auto packed = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(source + i));
+                integers = _mm_srai_epi32(_mm_unpacklo_epi16(packed, packed), 16);
+            }
+            else
+            {
+                integers = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + i));
+            }
+
+            _mm_storeu_ps(dest + i, _mm_mul_ps(_mm_cvtepi32_ps(integers), scale));
+        }
+
+        convertScalar<From, PcmFormat::float32>(in_source + i * sizeof(*source), out_dest + i * sizeof(*dest), in_samples - i, in_dither, io_random);
+    }
+
+    template <PcmFormat To>
+    __attribute__((target("sse2")))
+    static void floatToIntegerSse2(const std::byte* in_source, std::byte* out_dest, const std::size_t in_samples, const PcmDither in_dither, std::uint32_t* io_random) noexcept
+    {
+        const auto source = reinterpret_cast<const float*>(in_source);
+        const auto dest = reinterpret_cast<PcmCodecSample<To>*>(out_dest);
+        const auto scale = _mm_set1_ps(static_cast<float>(PcmCodec<To>::scale));
+        const auto minimum = _mm_set1_ps(static_cast<float>(-PcmCodec<To>::scale));
+        const auto maximum = _mm_set1_ps(static_cast<float>(PcmCodec<To>::maximum));
+        auto random = _mm_load_si128(reinterpret_cast<const __m128i*>(io_random));
+        std::size_t i = 0;
+
+        for (; i + 4 <= in_samples; i += 4)
+        {
+            auto value = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(source + i), scale), ditherNoiseSse2(in_dither, random));
+            __m128i integers;
+
+            if constexpr (To == PcmFormat::int32)
+            {
+                // The maximum of int32 is not a float so values at or over 2^31 are fixed up
+                // after the conversion gives 0x80000000 for them.
+                integers = _mm_xor_si128(_mm_cvtps_epi32(value), _mm_castps_si128(_mm_cmpge_ps(value, scale)));
+            }
+            else
+            {
+                value = _mm_min_ps(_mm_max_ps(value, minimum), maximum);
+                integers = _mm_cvtps_epi32(value);
+            }
+
+            if constexpr (To == PcmFormat::int16)
+            {
+                _mm_storel_epi64(reinterpret_cast<__m128i*>(dest + i), _mm_packs_epi32(integers, integers));
+            }
+            else
+            {
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(dest + i), integers);
+            }
+        }
+
+        _mm_store_si128(reinterpret_cast<__m128i*>(io_random), random);
+        convertScalar<PcmFormat::float32, To>(in_source + i * sizeof(*source), out_dest + i * sizeof(*dest), in_samples - i, in_dither, io_random);
+    }
+
+    __attribute__((target("sse2")))
+    static void float64ToFloat32Sse2(const std::byte* in_source, std::byte* out_dest, const std::size_t in_samples, const PcmDither in_dither, std::uint32_t* io_random) noexcept
+    {
+        const auto source = reinterpret_cast<const double*>(in_source);
+        const auto dest = reinterpret_cast<float*>(out_dest);
+        std::size_t i = 0;
+
+        for (; i + 4 <= in_samples; i += 4)
+        {
+            const auto low = _mm_cvtpd_ps(_mm_loadu_pd(source + i));
+            const auto high = _mm_cvtpd_ps(_mm_loadu_pd(source + i + 2));
+
+            _mm_storeu_ps(dest + i, _mm_movelh_ps(low, high));
+        }
+
+        convertScalar<PcmFormat::float64, PcmFormat::float32>(in_source + i * sizeof(*source), out_dest + i * sizeof(*dest), in_samples - i, in_dither, io_random);
+    }
+
+    __attribute__((target("sse2")))
+    static void float32ToFloat64Sse2(const std::byte* in_source, std::byte* out_dest, const std::size_t in_samples, const PcmDither in_dither, std::uint32_t* io_random) noexcept
+    {
+        const auto source = reinterpret_cast<const float*>(in_source);
+        const auto dest = reinterpret_cast<double*>(out_dest);
+        std::size_t i = 0;
+
+        for (; i + 4 <= in_samples; i += 4)
+        {
+            const auto value = _mm_loadu_ps(source + i);
+
+            _mm_storeu_pd(dest + i, _mm_cvtps_pd(value));
+            _mm_storeu_pd(dest + i + 2, _mm_cvtps_pd(_mm_movehl_ps(value, value)));
+        }
+
+        convertScalar<PcmFormat::float32, PcmFormat::float64>(in_source + i * sizeof(*source), out_dest + i * sizeof(*dest), in_samples - i, in_dither, io_random);
+    }
+
+    __attribute__((target("avx2")))
+    static __m256i nextRandomAvx2(__m256i& io_state) noexcept
+    {
+        io_state = _mm256_xor_si256(io_state, _mm256_slli_epi32(io_state, 13));
+        io_state = _mm256_xor_si256(io_state, _mm256_srli_epi32(io_state, 17));
+        io_state = _mm256_xor_si256(io_state, _mm256_slli_epi32(io_state, 5));
+
+        return io_state;
+    }
+
+    __attribute__((target("avx2")))
+    static __m256 uniformRandomAvx2(__m256i& io_state) noexcept
+    {
+        return _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_srli_epi32(nextRandomAvx2(io_state), 9)), _mm256_set1_ps(1.0f / 8388608.0f));
+    }
+
+    __attribute__((target("avx2")))
+    static __m256 ditherNoiseAvx2(const PcmDither in_dither, __m256i& io_state) noexcept
+    {
+        switch (in_dither)
+        {
+            case PcmDither::none: return _mm256_setzero_ps();
+            case PcmDither::rectangular: return _mm256_sub_ps(uniformRandomAvx2(io_state), _mm256_set1_ps(0.5f));
+            case PcmDither::triangular: return _mm256_sub_ps(uniformRandomAvx2(io_state), uniformRandomAvx2(io_state));
+        }
+
+        FATAL_ERROR(makeString("Unhandled PcmDither value: ", static_cast<int>(in_dither)));
+    }
+
+    template <PcmFormat From>
+    __attribute__((target("avx2")))
+    static void integerToFloatAvx2(const std::byte* in_source, std::byte* out_dest, const std::size_t in_samples, const PcmDither in_dither, std::uint32_t* io_random) noexcept
+    {
+        const auto source = reinterpret_cast<const PcmCodecSample<From>*>(in_source);
+        const auto dest = reinterpret_cast<float*>(out_dest);
+        const auto scale = _mm256_set1_ps(static_cast<float>(1.0 / PcmCodec<From>::scale));
+        std::size_t i = 0;
+
+        for (; i + 8 <= in_samples; i += 8)
+        {
+            __m256i integers;
+
+            if constexpr (From == PcmFormat::int16)
+            {
+                integers = _mm256_cvtepi16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(source + i)));
+            }
+            else
+            {
+                integers = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(source + i));
+            }
+
+            _mm256_storeu_ps(dest + i, _mm256_mul_ps(_mm256_cvtepi32_ps(integers), scale));
+        }
+
+        convertScalar<From, PcmFormat::float32>(in_source + i * sizeof(*source), out_dest + i * sizeof(*dest), in_samples - i, in_dither, io_random);
+    }
+
+    template <PcmFormat To>
+    __attribute__((target("avx2")))
+    static void floatToIntegerAvx2(const std::byte* in_source, std::byte* out_dest, const std::size_t in_samples, const PcmDither in_dither, std::uint32_t* io_random) noexcept
+    {
+        const auto source = reinterpret_cast<const float*>(in_source);
+        const auto dest = reinterpret_cast<PcmCodecSample<To>*>(out_dest);
+        const auto scale = _mm256_set1_ps(static_cast<float>(PcmCodec<To>::scale));
+        const auto minimum = _mm256_set1_ps(static_cast<float>(-PcmCodec<To>::scale));
+        const auto maximum = _mm256_set1_ps(static_cast<float>(PcmCodec<To>::maximum));
+        auto random = _mm256_load_si256(reinterpret_cast<const __m256i*>(io_random));
+        std::size_t i = 0;
+
+        for (; i + 8 <= in_samples; i += 8)
+        {
+            auto value = _mm256_add_ps(_mm256_mul_ps(_mm256_loadu_ps(source + i), scale), ditherNoiseAvx2(in_dither, random));
+            __m256i integers;
+
+            if constexpr (To == PcmFormat::int32)
+            {
+                integers = _mm256_xor_si256(_mm256_cvtps_epi32(value), _mm256_castps_si256(_mm256_cmp_ps(value, scale, _CMP_GE_OQ)));
+            }
+            else
+            {
+                value = _mm256_min_ps(_mm256_max_ps(value, minimum), maximum);
+                integers = _mm256_cvtps_epi32(value);
+            }
+
+            if constexpr (To == PcmFormat::int16)
+            {
+                // The pack works inside each 128 bit lane so the halves have to be gathered.
+                const auto packed = _mm256_permute4x64_epi64(_mm256_packs_epi32(integers, integers), 0b1000);
+
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(dest + i), _mm256_castsi256_si128(packed));
+            }
+            else
+            {
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(dest + i), integers);
+            }
+        }
+
+        _mm256_store_si256(reinterpret_cast<__m256i*>(io_random), random);
+        convertScalar<PcmFormat::float32, To>(in_source + i * sizeof(*source), out_dest + i * sizeof(*dest), in_samples - i, in_dither, io_random);
+    }
+
+    __attribute__((target("avx2")))
+    static void float64ToFloat32Avx2(const std::byte* in_source, std::byte* out_dest, const std::size_t in_samples, const PcmDither in_dither, std::uint32_t* io_random) noexcept
+    {
+        const auto source = reinterpret_cast<const double*>(in_source);
+        const auto dest = reinterpret_cast<float*>(out_dest);
+        std::size_t i = 0;
+
+        for (; i + 8 <= in_samples; i += 8)
+        {
+            const auto low = _mm256_cvtpd_ps(_mm256_loadu_pd(source + i));
+            const auto high = _mm256_cvtpd_ps(_mm256_loadu_pd(source + i + 4));
+
+            _mm256_storeu_ps(dest + i, _mm256_set_m128(high, low));
+        }
+
+        convertScalar<PcmFormat::float64, PcmFormat::float32>(in_source + i * sizeof(*source), out_dest + i * sizeof(*dest), in_samples - i, in_dither, io_random);
+    }
+
+    __attribute__((target("avx2")))
+    static void float32ToFloat64Avx2(const std::byte* in_source, std::byte* out_dest, const std::size_t in_samples, const PcmDither in_dither, std::uint32_t* io_random) noexcept
+    {
+        const auto source = reinterpret_cast<const float*>(in_source);
+        const auto dest = reinterpret_cast<double*>(out_dest);
+        std::size_t i = 0;
+
+        for (; i + 8 <= in_samples; i += 8)
+        {
+            _mm256_storeu_pd(dest + i, _mm256_cvtps_pd(_mm_loadu_ps(source + i)));
+            _mm256_storeu_pd(dest + i + 4, _mm256_cvtps_pd(_mm_loadu_ps(source + i + 4)));
+        }
+
+        convertScalar<PcmFormat::float32, PcmFormat::float64>(in_source + i * sizeof(*source), out_dest + i * sizeof(*dest), in_samples - i, in_dither, io_random);
+    }
+
+    static PcmConverter::Kernel sse2Kernel(const PcmFormat in_from, const PcmFormat in_to) noexcept
+    {
+        if (in_to == PcmFormat::float32)
+        {
+            switch (in_from)
+            {
+                case PcmFormat::int16: return integerToFloatSse2<PcmFormat::int16>;
+                case PcmFormat::int24: return integerToFloatSse2<PcmFormat::int24>;
+                case PcmFormat::int32: return integerToFloatSse2<PcmFormat::int32>;
+                case PcmFormat::float32: return nullptr;
+                case PcmFormat::float64: return float64ToFloat32Sse2;
+            }
+        }
+        else if (in_from == PcmFormat::float32)
+        {
+            switch (in_to)
+            {
+                case PcmFormat::int16: return floatToIntegerSse2<PcmFormat::int16>;
+                case PcmFormat::int24: return floatToIntegerSse2<PcmFormat::int24>;
+                case PcmFormat::int32: return floatToIntegerSse2<PcmFormat::int32>;
+                case PcmFormat::float32: return nullptr;
+                case PcmFormat::float64: return float32ToFloat64Sse2;
+            }
+        }
+
+        return nullptr;
+    }
+
+    static PcmConverter::Kernel avx2Kernel(const PcmFormat in_from, const PcmFormat in_to) noexcept
+    {
+        if (in_to == PcmFormat::float32)
+        {
+            switch (in_from)
+            {
+                case PcmFormat::int16: return integerToFloatAvx2<PcmFormat::int16>;
+                case PcmFormat::int24: return integerToFloatAvx2<PcmFormat::int24>;
+                case PcmFormat::int32: return integerToFloatAvx2<PcmFormat::int32>;
+                case PcmFormat::float32: return nullptr;
+                case PcmFormat::float64: return float64ToFloat32Avx2;
+            }
+        }
+        else if (in_from == PcmFormat::float32)
+        {
+            switch (in_to)
+            {
+                case PcmFormat::int16: return floatToIntegerAvx2<PcmFormat::int16>;
+                case PcmFormat::int24: return floatToIntegerAvx2<PcmFormat::int24>;
+                case PcmFormat::int32: return floatToIntegerAvx2<PcmFormat::int32>;
+                case PcmFormat::float32: return nullptr;
+                case PcmFormat::float64: return float32ToFloat64Avx2;
+            }
+        }
+
+        return nullptr;
+    }
+#endif
+
+    /**
+     * @brief Pick the kernel for a pair of formats.
+     * @param in_level The highest level to use. It is limited to what the CPU supports.
+     */
+    PcmConverter::PcmConverter(const PcmFormat in_from, const PcmFormat in_to, const PcmDither in_dither, const SimdLevel in_level) noexcept :
+        m_from(in_from),
+        m_to(in_to),
+        m_dither(pcmDitherApplies(in_from, in_to) ? in_dither : PcmDither::none)
+    {
+        [[maybe_unused]] const auto level = std::min(in_level, simdLevel());
+
+        for (std::size_t i = 0; i < m_random.size(); i++)
+        {
+            m_random[i] = 0x9e3779b9u * static_cast<std::uint32_t>(i + 1);
+        }
+
+#ifdef CLYPSALOT_X86_KERNELS
+        if (level >= SimdLevel::avx2 && (m_kernel = avx2Kernel(m_from, m_to)) != nullptr)
+        {
+            m_level = SimdLevel::avx2;
+            return;
+        }
+
+        if (level >= SimdLevel::sse2 && (m_kernel = sse2Kernel(m_from, m_to)) != nullptr)
+        {
+            m_level = SimdLevel::sse2;
+            return;
+        }
+#endif
+
+        m_kernel = scalarKernel(m_from, m_to);
+    }
+
+    PcmFormat PcmConverter::from() const noexcept
+    {
+        return m_from;
+    }
+
+    PcmFormat PcmConverter::to() const noexcept
+    {
+        return m_to;
+    }
+
+    /// @brief The dither that is applied which is none if the conversion does not drop resolution.
+    PcmDither PcmConverter::dither() const noexcept
+    {
+        return m_dither;
+    }
+
+    /// @brief The level of the kernel that was picked.
+    SimdLevel PcmConverter::level() const noexcept
+    {
+        return m_level;
+    }
+
+    void PcmConverter::convert(const std::byte* in_source, std::byte* out_dest, const std::size_t in_samples) noexcept
+    {
+        m_kernel(in_source, out_dest, in_samples, m_dither, m_random.data());
+    }
+
+    /// @brief Convert the first frames of every channel.
+    void PcmConverter::convert(const PcmBuffer& in_source, PcmBuffer& out_dest, const std::size_t in_frames) noexcept
+    {
+        assert(in_source.format() == m_from);
+        assert(out_dest.format() == m_to);
+        assert(in_source.channels() == out_dest.channels());
+        assert(in_frames <= in_source.frames() && in_frames <= out_dest.frames());
+
+        for (std::size_t channel = 0; channel < in_source.channels(); channel++)
+        {
+            convert(in_source.channelData(channel), out_dest.channelData(channel), in_frames);
+        }
+    }
+
+    static unsigned int pcmResolution(const PcmFormat in_format) noexcept
+    {
+        switch (in_format)
+        {
+            case PcmFormat::int16: return 16;
+            case PcmFormat::int24: return 24;
+            case PcmFormat::int32: return 32;
+            case PcmFormat::float32: return 0;
+            case PcmFormat::float64: return 0;
+        }
+
+        FATAL_ERROR(makeString("Unhandled PcmFormat value: ", static_cast<int>(in_format)));
+    }
+
+    /// @brief True if a conversion between the formats drops resolution so dither is useful.
+    bool pcmDitherApplies(const PcmFormat in_from, const PcmFormat in_to) noexcept
+    {
+        const auto from = pcmResolution(in_from);
+        const auto to = pcmResolution(in_to);
+
+        if (to == 0) return false;
+        return from == 0 || from > to;
+    }
+}
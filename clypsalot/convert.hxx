@@ -0,0 +1,63 @@
+/* Copyright 2023 Tyler Riddle
+ *
+ * This file is part of Clypsalot. Clypsalot is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU Lesser General Public License as published by the Free Software Foundation, either version 3 of the License,
+ * or (at your option) any later version. Clypsalot is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along with Clypsalot. If not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include <clypsalot/pcm.hxx>
+#include <clypsalot/simd.hxx>
+
+/// @file
+namespace Clypsalot
+{
+    /**
+     * @brief Converts samples between two PCM formats.
+     *
+     * Conversions between float32 and every other format have vector kernels for each SimdLevel
+     * and the kernel is picked when the converter is created. The other pairs convert one sample
+     * at a time through double. Every kernel gives the same result for the same input when there
+     * is no dither. Values outside of the range of an integer format are clipped.
+     *
+     * Dither is only added when converting from a float format or from a wider integer format to
+     * an integer format. The converter keeps the state of the noise generator so a converter must
+     * not be used by more than one thread at a time.
+     */
+    class PcmConverter
+    {
+        public:
+        using Kernel = void (*)(const std::byte* in_source, std::byte* out_dest, const std::size_t in_samples, const PcmDither in_dither, std::uint32_t* io_random) noexcept;
+
+        private:
+        const PcmFormat m_from;
+        const PcmFormat m_to;
+        const PcmDither m_dither;
+        SimdLevel m_level = SimdLevel::scalar;
+        Kernel m_kernel = nullptr;
+        alignas(32) std::array<std::uint32_t, 8> m_random;
+
+        public:
+        PcmConverter(const PcmFormat in_from, const PcmFormat in_to, const PcmDither in_dither = PcmDither::none, const SimdLevel in_level = simdLevel()) noexcept;
+        PcmConverter(const PcmConverter&) = delete;
+        void operator=(const PcmConverter&) = delete;
+        PcmFormat from() const noexcept;
+        PcmFormat to() const noexcept;
+        PcmDither dither() const noexcept;
+        SimdLevel level() const noexcept;
+        void convert(const std::byte* in_source, std::byte* out_dest, const std::size_t in_samples) noexcept;
+        void convert(const PcmBuffer& in_source, PcmBuffer& out_dest, const std::size_t in_frames) noexcept;
+    };
+
+    bool pcmDitherApplies(const PcmFormat in_from, const PcmFormat in_to) noexcept;
+}
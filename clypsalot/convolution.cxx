@@ -0,0 +1,306 @@
+/* Copyright 2023 Tyler Riddle
+ *
+ * This file is part of Clypsalot. Clypsalot is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU Lesser General Public License as published by the Free Software Foundation, either version 3 of the License,
+ * or (at your option) any later version. Clypsalot is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along with Clypsalot. If not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+
+
+#include <algorithm>
+#include <cassert>
+
+#include <clypsalot/convolution.hxx>
+#include <clypsalot/error.hxx>
+#include <clypsalot/thread.hxx>
+#include <clypsalot/util.hxx>
+
+/// @file
+namespace Clypsalot
+{
+    /*
+     * Transform every partition of every channel of the impulse starting at a frame. The spectra
+     * are scaled by the size of the FFT so the inverse transforms give the convolution directly.
+     * Each spectrum is the real parts of the bins followed by the imaginary parts.
+     */
+    static std::vector<float> partitionImpulse(RealFft& io_fft, const PcmBuffer& in_impulse, const std::size_t in_length, const std::size_t in_start, const std::size_t in_partitions)
+    {
+        const auto partition = io_fft.size() / 2;
+        const auto bins = io_fft.bins();
+        const auto scale = 1.0f / io_fft.size();
+        std::vector<float> spectra(in_impulse.channels() * in_partitions * bins * 2);
+        std::vector<float> samples(io_fft.size());
+
+        for (std::size_t channel = 0; channel < in_impulse.channels(); channel++)
+        {
+            const auto impulse = in_impulse.channel<float>(channel);
+
+            for (std::size_t index = 0; index < in_partitions; index++)
+            {
+                const auto start = std::min(in_start + index * partition, in_length);
+                const auto frames = std::min(partition, in_length - start);
+                const auto spectrum = spectra.data() + (channel * in_partitions + index) * bins * 2;
+
+                std::fill(samples.begin(), samples.end(), 0.0f);
+                std::transform(impulse + start, impulse + start + frames, samples.begin(), [scale](const float sample) { return sample * scale; });
+                io_fft.forward(samples.data(), spectrum, spectrum + bins);
+            }
+        }
+
+        return spectra;
+    }
+
+    /*
+     * Slide a window of two partitions along by one, transform it into the newest slot of the
+     * history and sum the products of the history and the impulse partitions. The newest
+     * partition of the window is the last part of the inverse transform.
+     */
+    static void convolvePartitions(RealFft& io_fft, float* io_window, float* io_history, const std::size_t in_position, const std::size_t in_partitions, const float* in_impulse, float* io_sum, float* out_result) noexcept
+    {
+        const auto bins = io_fft.bins();
+        const auto newest = io_history + in_position * bins * 2;
+
+        io_fft.forward(io_window, newest, newest + bins);
+        std::fill_n(io_sum, bins * 2, 0.0f);
+
+        for (std::size_t index = 0; index < in_partitions; index++)
+        {
+            const auto slot = (in_position + in_partitions - index) % in_partitions;
+            const auto input = io_history + slot * bins * 2;
+            const auto impulse = in_impulse + index * bins * 2;
+
+            io_fft.multiplyAdd(input, input + bins, impulse, impulse + bins, io_sum, io_sum + bins);
+        }
+
+        io_fft.inverse(io_sum, io_sum + bins, out_result);
+    }
+
+    /**
+     * @param in_impulse A planar float32 buffer with the impulse in its first in_length frames.
+     * @param in_background If false the tail partitions are computed by process() when a job
+     * would have been started which gives the same result.
+     * @param in_level The highest level of vector instructions to use. It is limited to what the
+     * CPU supports.
+     * @throws ValueError if there are no channels, the block size is not a power of two, the
+     * impulse is empty or it has a number of channels other than 1 or the number of channels.
+     */
+    PcmConvolver::PcmConvolver(const PcmBuffer& in_impulse, const std::size_t in_length, const std::size_t in_channels, const std::size_t in_blockSize, const bool in_background, const SimdLevel in_level) :
+        m_channels(in_channels),
+        m_blockSize(in_blockSize),
+        m_length(in_length),
+        m_background(in_background),
+        m_impulseChannels(in_impulse.channels()),
+        m_headFft(in_blockSize * 2, in_level)
+    {
+        assert(in_impulse.format() == PcmFormat::float32);
+        assert(in_impulse.layout() == PcmLayout::planar);
+        assert(in_length <= in_impulse.frames());
+
+        if (m_channels == 0) throw ValueError("Convolver channel count must be greater than zero");
+        if (m_length == 0) throw ValueError("Impulse response can not be empty");
+        if (m_impulseChannels != 1 && m_impulseChannels != m_channels)
+        {
+            throw ValueError(makeString("Impulse response has ", m_impulseChannels, " channels but it must have 1 or ", m_channels));
+        }
+
+        const auto tailPartition = m_blockSize * tailRatio;
+        const auto headLength = tailPartition * 2;
+        const auto headBins = m_headFft.bins();
+
+        m_headPartitions = (std::min(m_length, headLength) + m_blockSize - 1) / m_blockSize;
+        m_headImpulse = partitionImpulse(m_headFft, in_impulse, m_length, 0, m_headPartitions);
+        m_headHistory.resize(m_channels * m_headPartitions * headBins * 2);
+        m_headWindow.resize(m_channels * m_blockSize * 2);
+        m_headSum.resize(headBins * 2);
+        m_headResult.resize(m_blockSize * 2);
+
+        if (m_length > headLength)
+        {
+            m_tailFft = std::make_unique<RealFft>(tailPartition * 2, in_level);
+
+            const auto tailBins = m_tailFft->bins();
+
+            m_tailPartitions = (m_length - headLength + tailPartition - 1) / tailPartition;
+            m_tailImpulse = partitionImpulse(*m_tailFft, in_impulse, m_length, headLength, m_tailPartitions);
+            m_tailHistory.resize(m_channels * m_tailPartitions * tailBins * 2);
+            m_tailWindow.resize(m_channels * tailPartition * 2);
+            m_tailSum.resize(tailBins * 2);
+            m_tailResult.resize(tailPartition * 2);
+
+            for (auto& buffer : m_tailInput) buffer.resize(m_channels * tailPartition);
+            for (auto& buffer : m_tailOutput) buffer.resize(m_channels * tailPartition);
+        }
+    }
+
+    PcmConvolver::~PcmConvolver() noexcept
+    {
+        waitForTail();
+    }
+
+    std::size_t PcmConvolver::channels() const noexcept
+    {
+        return m_channels;
+    }
+
+    /// @brief The number of frames in a block and in a head partition.
+    std::size_t PcmConvolver::blockSize() const noexcept
+    {
+        return m_blockSize;
+    }
+
+    /// @brief The number of frames in the impulse.
+    std::size_t PcmConvolver::length() const noexcept
+    {
+        return m_length;
+    }
+
+    SimdLevel PcmConvolver::level() const noexcept
+    {
+        return m_headFft.level();
+    }
+
+    std::size_t PcmConvolver::headPartitions() const noexcept
+    {
+        return m_headPartitions;
+    }
+
+    /// @brief The number of partitions of blockSize() * tailRatio frames computed by jobs.
+    std::size_t PcmConvolver::tailPartitions() const noexcept
+    {
+        return m_tailPartitions;
+    }
+
+    /// @brief Forget all the input.
+    void PcmConvolver::reset() noexcept
+    {
+        waitForTail();
+
+        for (auto buffer : { &m_headHistory, &m_headWindow, &m_tailHistory, &m_tailWindow, &m_tailInput[0], &m_tailInput[1], &m_tailOutput[0], &m_tailOutput[1] })
+        {
+            std::fill(buffer->begin(), buffer->end(), 0.0f);
+        }
+
+        m_headPosition = 0;
+        m_tailPosition = 0;
+        m_chunkFrames = 0;
+        m_filling = 0;
+        m_playing = 0;
+    }
+
+    // Runs on the ThreadQueue. The input being convolved, the output being written and the tail
+    // state are left alone by process() until the job is done.
+    void PcmConvolver::tail() noexcept
+    {
+        [[maybe_unused]] const DenormalGuard guard;
+        const auto partition = m_blockSize * tailRatio;
+        const auto bins = m_tailFft->bins();
+        const auto& input = m_tailInput[m_filling ^ 1];
+        auto& output = m_tailOutput[m_playing ^ 1];
+
+        for (std::size_t channel = 0; channel < m_channels; channel++)
+        {
+            const auto window = m_tailWindow.data() + channel * partition * 2;
+            const auto history = m_tailHistory.data() + channel * m_tailPartitions * bins * 2;
+            const auto impulse = m_tailImpulse.data() + (m_impulseChannels == 1 ? 0 : channel) * m_tailPartitions * bins * 2;
+
+            std::copy_n(window + partition, partition, window);
+            std::copy_n(input.data() + channel * partition, partition, window + partition);
+            convolvePartitions(*m_tailFft, window, history, m_tailPosition, m_tailPartitions, impulse, m_tailSum.data(), m_tailResult.data());
+            std::copy_n(m_tailResult.data() + partition, partition, output.data() + channel * partition);
+        }
+
+        m_tailPosition = (m_tailPosition + 1) % m_tailPartitions;
+
+        std::scoped_lock lock(m_mutex);
+
+        m_tailBusy = false;
+        m_tailDone.notify_all();
+    }
+
+    void PcmConvolver::waitForTail() noexcept
+    {
+        std::unique_lock lock(m_mutex);
+
+        m_tailDone.wait(lock, [this] { return ! m_tailBusy; });
+    }
+
+    /*
+     * The input that was just gathered is convolved in to the output that just finished playing
+     * while the output of the last job is played.
+     */
+    void PcmConvolver::startTail() noexcept
+    {
+        waitForTail();
+
+        m_filling ^= 1;
+        m_playing ^= 1;
+        m_chunkFrames = 0;
+
+        if (! m_background)
+        {
+            m_tailBusy = true;
+            tail();
+            return;
+        }
+
+        {
+            std::scoped_lock lock(m_mutex);
+            m_tailBusy = true;
+        }
+
+        threadQueuePost([this] { tail(); });
+    }
+
+    /// @brief Convolve the first frames of a buffer in place.
+    void PcmConvolver::process(PcmBuffer& io_buffer, const std::size_t in_frames) noexcept
+    {
+        assert(io_buffer.format() == PcmFormat::float32);
+        assert(io_buffer.layout() == PcmLayout::planar);
+        assert(io_buffer.channels() == m_channels);
+        assert(in_frames <= m_blockSize && in_frames <= io_buffer.frames());
+
+        [[maybe_unused]] const DenormalGuard guard;
+        const auto bins = m_headFft.bins();
+        const auto partition = m_blockSize * tailRatio;
+
+        for (std::size_t channel = 0; channel < m_channels; channel++)
+        {
+            const auto samples = io_buffer.channel<float>(channel);
+            const auto window = m_headWindow.data() + channel * m_blockSize * 2;
+            const auto history = m_headHistory.data() + channel * m_headPartitions * bins * 2;
+            const auto impulse = m_headImpulse.data() + (m_impulseChannels == 1 ? 0 : channel) * m_headPartitions * bins * 2;
+
+            std::copy_n(window + m_blockSize, m_blockSize, window);
+            std::copy_n(samples, in_frames, window + m_blockSize);
+            std::fill(window + m_blockSize + in_frames, window + m_blockSize * 2, 0.0f);
+            convolvePartitions(m_headFft, window, history, m_headPosition, m_headPartitions, impulse, m_headSum.data(), m_headResult.data());
+
+            const auto result = m_headResult.data() + m_blockSize;
+
+            if (m_tailFft)
+            {
+                const auto offset = channel * partition + m_chunkFrames;
+                const auto tailOutput = m_tailOutput[m_playing].data() + offset;
+
+                std::copy_n(window + m_blockSize, m_blockSize, m_tailInput[m_filling].data() + offset);
+
+                for (std::size_t frame = 0; frame < in_frames; frame++) samples[frame] = result[frame] + tailOutput[frame];
+            }
+            else
+            {
+                std::copy_n(result, in_frames, samples);
+            }
+        }
+
+        m_headPosition = (m_headPosition + 1) % m_headPartitions;
+
+        if (! m_tailFft) return;
+
+        m_chunkFrames += m_blockSize;
+        if (m_chunkFrames == partition) startTail();
+    }
+}
@@ -0,0 +1,101 @@
+/* Copyright 2023 Tyler Riddle
+ *
+ * This file is part of Clypsalot. Clypsalot is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU Lesser General Public License as published by the Free Software Foundation, either version 3 of the License,
+ * or (at your option) any later version. Clypsalot is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along with Clypsalot. If not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#include <array>
+#include <condition_variable>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include <clypsalot/fft.hxx>
+#include <clypsalot/pcm.hxx>
+#include <clypsalot/simd.hxx>
+
+/// @file
+namespace Clypsalot
+{
+    /**
+     * @brief Convolves every channel of a planar float32 buffer with a long impulse response.
+     *
+     * The impulse is cut in to two sets of uniform partitions that are convolved with overlap
+     * save in the frequency domain. The head covers the first 2 * tailRatio blocks of the
+     * impulse with partitions of one block which are computed by process() so there is no
+     * latency. The rest of the impulse is covered by partitions tailRatio times larger. Their
+     * input is gathered over tailRatio blocks and then convolved by a job on the ThreadQueue
+     * while the next tailRatio blocks are processed. The head is long enough that the result of
+     * a job is first needed one whole job later so the cost of a block does not grow with the
+     * length of the impulse. If a job is late process() waits for it.
+     *
+     * The impulse can have one channel which is used for every channel or one for each channel.
+     * Every block given to process() is taken to be blockSize() frames long with any frames
+     * after the ones given being silent. All the memory is allocated by the constructor.
+     */
+    class PcmConvolver
+    {
+        public:
+        /// @brief How many blocks make up a tail partition.
+        static constexpr std::size_t tailRatio = 8;
+
+        private:
+        const std::size_t m_channels;
+        const std::size_t m_blockSize;
+        const std::size_t m_length;
+        const bool m_background;
+        const std::size_t m_impulseChannels;
+        RealFft m_headFft;
+        std::unique_ptr<RealFft> m_tailFft;
+        std::size_t m_headPartitions = 0;
+        std::size_t m_tailPartitions = 0;
+        std::vector<float> m_headImpulse;
+        std::vector<float> m_headHistory;
+        std::vector<float> m_headWindow;
+        std::vector<float> m_headSum;
+        std::vector<float> m_headResult;
+        std::size_t m_headPosition = 0;
+        std::vector<float> m_tailImpulse;
+        std::vector<float> m_tailHistory;
+        std::vector<float> m_tailWindow;
+        std::vector<float> m_tailSum;
+        std::vector<float> m_tailResult;
+        std::array<std::vector<float>, 2> m_tailInput;
+        std::array<std::vector<float>, 2> m_tailOutput;
+        std::size_t m_tailPosition = 0;
+        std::size_t m_chunkFrames = 0;
+        std::size_t m_filling = 0;
+        std::size_t m_playing = 0;
+        std::mutex m_mutex;
+        std::condition_variable m_tailDone;
+        bool m_tailBusy = false;
+
+        void tail() noexcept;
+        void waitForTail() noexcept;
+        void startTail() noexcept;
+
+        public:
+        PcmConvolver(const PcmBuffer& in_impulse, const std::size_t in_length, const std::size_t in_channels, const std::size_t in_blockSize, const bool in_background = true, const SimdLevel in_level = simdLevel());
+        PcmConvolver(const PcmConvolver&) = delete;
+        ~PcmConvolver() noexcept;
+        void operator=(const PcmConvolver&) = delete;
+        std::size_t channels() const noexcept;
+        std::size_t blockSize() const noexcept;
+        std::size_t length() const noexcept;
+        SimdLevel level() const noexcept;
+        std::size_t headPartitions() const noexcept;
+        std::size_t tailPartitions() const noexcept;
+        void reset() noexcept;
+        void process(PcmBuffer& io_buffer, const std::size_t in_frames) noexcept;
+    };
+}
@@ -0,0 +1,139 @@
+/* Copyright 2023 Tyler Riddle
+ *
+ * This file is part of Clypsalot. Clypsalot is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU Lesser General Public License as published by the Free Software Foundation, either version 3 of the License,
+ * or (at your option) any later version. Clypsalot is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along with Clypsalot. If not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+
+
+#include <cassert>
+
+#include <clypsalot/convert.hxx>
+#include <clypsalot/convolver.hxx>
+#include <clypsalot/error.hxx>
+#include <clypsalot/logger.hxx>
+#include <clypsalot/memory.hxx>
+#include <clypsalot/pcm.hxx>
+#include <clypsalot/property.hxx>
+#include <clypsalot/util.hxx>
+#include <clypsalot/wav.hxx>
+
+/// @file
+namespace Clypsalot
+{
+    const std::string ConvolverObject::kindName = "Convolver";
+    static const std::string channelsPropertyName = "Channels";
+    static const std::string sampleRatePropertyName = "Sample Rate";
+    static const std::string blockSizePropertyName = "Block Size";
+    static const std::string impulsePropertyName = "Impulse";
+    static const std::string impulseLengthPropertyName = "Impulse Length";
+    static const PropertyList convolverProperties = {
+        { channelsPropertyName, PropertyType::size, Property::Configurable | Property::Required, nullptr },
+        { sampleRatePropertyName, PropertyType::size, Property::Configurable, 48000 },
+        { blockSizePropertyName, PropertyType::size, Property::Configurable, 256 },
+        { impulsePropertyName, PropertyType::file, Property::Configurable | Property::Required, nullptr },
+        // The number of frames in the impulse.
+        { impulseLengthPropertyName, PropertyType::size, Property::NoFlags, 0 },
+    };
+
+    std::shared_ptr<ConvolverObject> ConvolverObject::make()
+    {
+        return _makeObject<ConvolverObject>(kindName);
+    }
+
+    ConvolverObject::ConvolverObject(const std::string& in_kind) :
+        Object(in_kind)
+    {
+        std::scoped_lock lock(*this);
+
+        addProperties(convolverProperties);
+
+        m_input = static_cast<PcmInputPort*>(&addInput<PcmInputPort>("input"));
+        m_output = static_cast<PcmOutputPort*>(&addOutput<PcmOutputPort>("output"));
+        m_output->inPlace(m_input);
+    }
+
+    /// @throws RuntimeError if the Object was not configured.
+    const PcmConvolver& ConvolverObject::convolver() const
+    {
+        assert(haveLock());
+
+        if (! m_convolver) throw RuntimeError("The convolver has not been configured");
+
+        return *m_convolver;
+    }
+
+    /**
+     * @throws ValueError if there are no channels, the block size is not a power of two or the
+     * impulse is not a WAV file that fits the Object.
+     */
+    void ConvolverObject::handleConfigure(const ObjectConfig& in_config)
+    {
+        assert(haveLock());
+
+        Object::handleConfigure(in_config);
+
+        const auto& channels = property(channelsPropertyName);
+        const auto& file = property(impulsePropertyName);
+
+        if (! channels.defined()) throw ValueError(makeString("Property is required: ", channelsPropertyName));
+        if (! file.defined()) throw ValueError(makeString("Property is required: ", impulsePropertyName));
+
+        const auto rate = property(sampleRatePropertyName).sizeValue();
+        const auto blockSize = property(blockSizePropertyName).sizeValue();
+
+        if (rate == 0) throw ValueError(makeString(sampleRatePropertyName, " must be greater than zero"));
+        if (blockSize == 0) throw ValueError(makeString(blockSizePropertyName, " must be greater than zero"));
+
+        const FileMapping mapping(file.fileValue());
+
+        if (! isWavFile(mapping.data(), mapping.bytes())) throw ValueError(makeString("Impulse response is not a WAV file: ", file.fileValue()));
+
+        const auto info = readWavInfo(mapping.data(), mapping.bytes());
+
+        if (info.rate != rate) throw ValueError(makeString("Impulse response sample rate is ", info.rate, " but the ", sampleRatePropertyName, " is ", rate));
+
+        PcmBuffer samples(info.format, info.channels, info.frames);
+
+        readPcmFrames(samples, mapping.data() + info.dataOffset, info, info.frames);
+
+        if (info.format != PcmFormat::float32)
+        {
+            PcmBuffer converted(PcmFormat::float32, info.channels, info.frames);
+
+            PcmConverter(info.format, PcmFormat::float32).convert(samples, converted, info.frames);
+            samples = std::move(converted);
+        }
+
+        auto convolver = std::make_unique<PcmConvolver>(samples, info.frames, channels.sizeValue(), blockSize);
+        const PcmConfig config = { PcmFormat::float32, convolver->channels(), blockSize, 0, rate, PcmLayout::planar };
+
+        m_input->config(config);
+        m_output->config(config);
+        propertySizeRef(impulseLengthPropertyName) = info.frames;
+        m_convolver = std::move(convolver);
+
+        OBJECT_LOGGER(debug, "Configured ", config.channels, " channels with a ", info.frames, " frame impulse; head=",
+            m_convolver->headPartitions(), " tail=", m_convolver->tailPartitions(), " level=", m_convolver->level());
+    }
+
+    /// @throws RuntimeError if the input has more frames than the block size.
+    ObjectProcessResult ConvolverObject::process()
+    {
+        assert(haveLock());
+
+        const auto frames = m_input->frames();
+
+        if (frames > m_output->config().blockSize) throw RuntimeError(makeString("Input block is larger than ", blockSizePropertyName));
+
+        m_convolver->process(m_output->buffer(), frames);
+        m_output->commit(frames);
+
+        return ObjectProcessResult::finished;
+    }
+}
@@ -0,0 +1,51 @@
+/* Copyright 2023 Tyler Riddle
+ *
+ * This file is part of Clypsalot. Clypsalot is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU Lesser General Public License as published by the Free Software Foundation, either version 3 of the License,
+ * or (at your option) any later version. Clypsalot is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along with Clypsalot. If not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#include <memory>
+#include <string>
+
+#include <clypsalot/convolution.hxx>
+#include <clypsalot/object.hxx>
+
+/// @file
+namespace Clypsalot
+{
+    /**
+     * @brief Convolution with an impulse response read from a WAV file.
+     *
+     * The impulse is read and transformed when the Object is configured. It must have the sample
+     * rate of the Object and either one channel that is used for every channel or one for each
+     * channel. The block size must be a power of two and every input block is processed as a
+     * whole block so the output has no latency. The partitions past the first few blocks of the
+     * impulse are computed on the ThreadQueue.
+     */
+    class ConvolverObject : public Object
+    {
+        PcmInputPort* m_input = nullptr;
+        PcmOutputPort* m_output = nullptr;
+        std::unique_ptr<PcmConvolver> m_convolver;
+
+        protected:
+        virtual void handleConfigure(const ObjectConfig& in_config) override;
+        virtual ObjectProcessResult process() override;
+
+        public:
+        static const std::string kindName;
+
+        static std::shared_ptr<ConvolverObject> make();
+        ConvolverObject(const std::string& in_kind);
+        const PcmConvolver& convolver() const;
+    };
+}
@@ -0,0 +1,850 @@
+/* Copyright 2023 Tyler Riddle
+ *
+ * This file is part of Clypsalot. Clypsalot is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU Lesser General Public License as published by the Free Software Foundation, either version 3 of the License,
+ * or (at your option) any later version. Clypsalot is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along with Clypsalot. If not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+
+
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define CLYPSALOT_X86_KERNELS
+#include <immintrin.h>
+#endif
+
+#include <clypsalot/dynamics.hxx>
+#include <clypsalot/error.hxx>
+#include <clypsalot/macros.hxx>
+#include <clypsalot/transpose.hxx>
+#include <clypsalot/util.hxx>
+
+/// @file
+namespace Clypsalot
+{
+    // The state of a group is the envelope of every lane, then the mean square and then the most
+    // gain reduction seen by the current call.
+    static constexpr std::size_t compressorState = 3;
+    // The state of a gate group is the gain of every lane, then 1 for the lanes that are open,
+    // then the frames left to hold and then the most gain seen by the current call.
+    static constexpr std::size_t gateState = 4;
+    // Frames are counted in floats so the hold time is limited to what they count exactly.
+    static constexpr float maximumHoldFrames = 16777216.0f;
+    // Keeps the logarithm of silence finite.
+    static constexpr float minimumLevel = 1e-20f;
+    // dB per octave of amplitude and of power and octaves per dB of amplitude.
+    static constexpr float amplitudeDecibels = 6.020599913279624f;
+    static constexpr float powerDecibels = 3.010299956639812f;
+    static constexpr float decibelOctaves = 0.16609640474436813f;
+
+    /*
+     * log2() of a positive normal float from its exponent and an odd series in
+     * t = (m - 1) / (m + 1) for the mantissa m. The error is below 1e-5 octaves.
+     */
+    static constexpr float log2C1 = 2.8853900817779268f;
+    static constexpr float log2C3 = 0.9617966939259756f;
+    static constexpr float log2C5 = 0.5770780163555854f;
+    static constexpr float log2C7 = 0.41219858311113244f;
+
+    /*
+     * exp2() from the integer part in the exponent and the Taylor series of 2^f for the
+     * fraction. The relative error is below 2e-6 which is far less than a hundredth of a dB.
+     */
+    static constexpr float exp2C1 = 0.6931471805599453f;
+    static constexpr float exp2C2 = 0.2402265069591007f;
+    static constexpr float exp2C3 = 0.05550410866482158f;
+    static constexpr float exp2C4 = 0.009618129107628477f;
+    static constexpr float exp2C5 = 0.0013333558146428443f;
+    static constexpr float exp2C6 = 0.00015403530393381609f;
+    static constexpr float exp2C7 = 1.5252733804059841e-05f;
+
+    // A one pole smoother that takes the given time to get about 63% of the way to a new value.
+    static float timeCoefficient(const float in_milliseconds, const double in_rate) noexcept
+    {
+        if (in_milliseconds <= 0) return 0;
+        return std::exp(-1000 / (in_milliseconds * in_rate));
+    }
+
+    /*
+     * Every kernel does the same operations in the same order with out fused multiplies so the
+     * levels round the same way, including the approximations of log2() and exp2().
+     */
+    static inline float log2Scalar(const float in_value) noexcept
+    {
+        const auto bits = std::bit_cast<std::int32_t>(in_value);
+        const auto exponent = static_cast<float>((bits >> 23) - 127);
+        const auto mantissa = std::bit_cast<float>((bits & 0x007fffff) | 0x3f800000);
+        const auto t = (mantissa - 1) / (mantissa + 1);
+        const auto t2 = t * t;
+
+        return exponent + t * (log2C1 + t2 * (log2C3 + t2 * (log2C5 + t2 * log2C7)));
+    }
+
+    static inline float exp2Scalar(const float in_value) noexcept
+    {
+        const auto value = std::min(std::max(in_value, -126.0f), 126.0f);
+        auto integer = static_cast<std::int32_t>(value);
+
+        if (static_cast<float>(integer) > value) integer--;
+
+        const auto f = value - static_cast<float>(integer);
+        const auto series = 1 + f * (exp2C1 + f * (exp2C2 + f * (exp2C3 + f * (exp2C4 + f * (exp2C5 + f * (exp2C6 + f * exp2C7))))));
+
+        return series * std::bit_cast<float>((integer + 127) << 23);
+    }
+
+    static void compressorScalar(const float* in_key, float* io_samples, float* io_delay, const std::size_t in_delayFrames, std::size_t in_position, const PcmCompressor::Parameters& in_parameters, float* io_state, const std::size_t in_frames) noexcept
+    {
+        const auto& p = in_parameters;
+        const auto levelScale = p.rms ? powerDecibels : amplitudeDecibels;
+        auto envelope = io_state[0];
+        auto power = io_state[1];
+        auto reduction = io_state[2];
+
+        for (std::size_t frame = 0; frame < in_frames; frame++)
+        {
+            const auto key = in_key[frame];
+            const auto square = key * key;
+
+            power = square + p.rmsCoefficient * (power - square);
+
+            const auto detected = p.rms ? power : std::abs(key);
+            const auto level = log2Scalar(std::max(detected, minimumLevel)) * levelScale;
+            const auto over = level - p.threshold;
+            const auto kneeOver = over + p.halfKnee;
+            const auto soft = p.kneeFactor * (kneeOver * kneeOver);
+            const auto hard = p.ratioFactor * over;
+            const auto target = over > -p.halfKnee ? (over >= p.halfKnee ? hard : soft) : 0.0f;
+            const auto coefficient = target > envelope ? p.attack : p.release;
+
+            envelope = target + coefficient * (envelope - target);
+            reduction = std::max(reduction, envelope);
+
+            const auto gain = exp2Scalar((p.makeup - envelope) * decibelOctaves);
+            auto sample = io_samples[frame];
+
+            if (in_delayFrames > 0)
+            {
+                const auto delayed = io_delay[in_position];
+
+                io_delay[in_position] = sample;
+                sample = delayed;
+                if (++in_position == in_delayFrames) in_position = 0;
+            }
+
+            io_samples[frame] = sample * gain;
+        }
+
+        io_state[0] = envelope;
+        io_state[1] = power;
+        io_state[2] = reduction;
+    }
+
+#ifdef CLYPSALOT_X86_KERNELS
+    __attribute__((target("sse2")))
+    static inline __m128 selectSse2(const __m128 in_mask, const __m128 in_true, const __m128 in_false) noexcept
+    {
+        return _mm_or_ps(_mm_and_ps(in_mask, in_true), _mm_andnot_ps(in_mask, in_false));
+    }
+
+    __attribute__((target("sse2")))
+    static inline __m128 log2Sse2(const __m128 in_value) noexcept
+    {
+        const auto bits = _mm_castps_si128(in_value);
+        const auto exponent = _mm_cvtepi32_ps(_mm_sub_epi32(_mm_srli_epi32(bits, 23), _mm_set1_epi32(127)));
+        const auto mantissa = _mm_castsi128_ps(_mm_or_si128(_mm_and_si128(bits, _mm_set1_epi32(0x007fffff)), _mm_set1_epi32(0x3f800000)));
+        const auto one = _mm_set1_ps(1);
+        const auto t = _mm_div_ps(_mm_sub_ps(mantissa, one), _mm_add_ps(mantissa, one));
+        const auto t2 = _mm_mul_ps(t, t);
+        auto series = _mm_add_ps(_mm_set1_ps(log2C5), _mm_mul_ps(t2, _mm_set1_ps(log2C7)));
+
+        series = _mm_add_ps(_mm_set1_ps(log2C3), _mm_mul_ps(t2, series));
+        series = _mm_add_ps(_mm_set1_ps(log2C1), _mm_mul_ps(t2, series));
+
+        return _mm_add_ps(exponent, _mm_mul_ps(t, series));
+    }
+
+    __attribute__((target("sse2")))
+    static inline __m128 exp2Sse2(const __m128 in_value) noexcept
+    {
+        const auto value = _mm_min_ps(_mm_max_ps(in_value, _mm_set1_ps(-126)), _mm_set1_ps(126));
+        auto integer = _mm_cvttps_epi32(value);
+
+        // Adding the all ones mask subtracts one where truncating rounded up.
+        integer = _mm_add_epi32(integer, _mm_castps_si128(_mm_cmpgt_ps(_mm_cvtepi32_ps(integer), value)));
+
+        const auto f = _mm_sub_ps(value, _mm_cvtepi32_ps(integer));
+        auto series = _mm_add_ps(_mm_set1_ps(exp2C6), _mm_mul_ps(f, _mm_set1_ps(exp2C7)));
+
+        series = _mm_add_ps(_mm_set1_ps(exp2C5), _mm_mul_ps(f, series));
+        series = _mm_add_ps(_mm_set1_ps(exp2C4), _mm_mul_ps(f, series));
+        series = _mm_add_ps(_mm_set1_ps(exp2C3), _mm_mul_ps(f, series));
+        series = _mm_add_ps(_mm_set1_ps(exp2C2), _mm_mul_ps(f, series));
+        series = _mm_add_ps(_mm_set1_ps(exp2C1), _mm_mul_ps(f, series));
+        series = _mm_add_ps(_mm_set1_ps(1), _mm_mul_ps(f, series));
+
+        return _mm_mul_ps(series, _mm_castsi128_ps(_mm_slli_epi32(_mm_add_epi32(integer, _mm_set1_epi32(127)), 23)));
+    }
+
+    __attribute__((target("sse2")))
+    static void compressorSse2(const float* in_key, float* io_samples, float* io_delay, const std::size_t in_delayFrames, std::size_t in_position, const PcmCompressor::Parameters& in_parameters, float* io_state, const std::size_t in_frames) noexcept
+    {
+        constexpr std::size_t lanes = 4;
+        const auto& p = in_parameters;
+        const auto levelScale = _mm_set1_ps(p.rms ? powerDecibels : amplitudeDecibels);
+        const auto threshold = _mm_set1_ps(p.threshold);
+        const auto halfKnee = _mm_set1_ps(p.halfKnee);
+        const auto negativeHalfKnee = _mm_set1_ps(-p.halfKnee);
+        const auto kneeFactor = _mm_set1_ps(p.kneeFactor);
+        const auto ratioFactor = _mm_set1_ps(p.ratioFactor);
+        const auto makeup = _mm_set1_ps(p.makeup);
+        const auto attack = _mm_set1_ps(p.attack);
+        const auto release = _mm_set1_ps(p.release);
+        const auto rmsCoefficient = _mm_set1_ps(p.rmsCoefficient);
+        const auto absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff));
+        const auto minimum = _mm_set1_ps(minimumLevel);
+        const auto octaves = _mm_set1_ps(decibelOctaves);
+        auto envelope = _mm_loadu_ps(io_state);
+        auto power = _mm_loadu_ps(io_state + lanes);
+        auto reduction = _mm_loadu_ps(io_state + lanes * 2);
+
+        for (std::size_t frame = 0; frame < in_frames; frame++)
+        {
+            const auto key = _mm_loadu_ps(in_key + frame * lanes);
+            const auto square = _mm_mul_ps(key, key);
+
+            power = _mm_add_ps(square, _mm_mul_ps(rmsCoefficient, _mm_sub_ps(power, square)));
+
+            const auto detected = p.rms ? power : _mm_and_ps(key, absMask);
+            const auto level = _mm_mul_ps(log2Sse2(_mm_max_ps(detected, minimum)), levelScale);
+            const auto over = _mm_sub_ps(level, threshold);
+            const auto kneeOver = _mm_add_ps(over, halfKnee);
+            const auto soft = _mm_mul_ps(kneeFactor, _mm_mul_ps(kneeOver, kneeOver));
+            const auto hard = _mm_mul_ps(ratioFactor, over);
+            const auto target = _mm_and_ps(_mm_cmpgt_ps(over, negativeHalfKnee), selectSse2(_mm_cmpge_ps(over, halfKnee), hard, soft));
+            const auto coefficient = selectSse2(_mm_cmpgt_ps(target, envelope), attack, release);
+
+            envelope = _mm_add_ps(target, _mm_mul_ps(coefficient, _mm_sub_ps(envelope, target)));
+            reduction = _mm_max_ps(reduction, envelope);
+
+            const auto gain = exp2Sse2(_mm_mul_ps(_mm_sub_ps(makeup, envelope), octaves));
+            auto sample = _mm_loadu_ps(io_samples + frame * lanes);
+
+            if (in_delayFrames > 0)
+            {
+                const auto delayed = _mm_loadu_ps(io_delay + in_position * lanes);
+
+                _mm_storeu_ps(io_delay + in_position * lanes, sample);
+                sample = delayed;
+                if (++in_position == in_delayFrames) in_position = 0;
+            }
+
+            _mm_storeu_ps(io_samples + frame * lanes, _mm_mul_ps(sample, gain));
+        }
+
+        _mm_storeu_ps(io_state, envelope);
+        _mm_storeu_ps(io_state + lanes, power);
+        _mm_storeu_ps(io_state + lanes * 2, reduction);
+    }
+
+    __attribute__((target("avx2")))
+    static inline __m256 log2Avx2(const __m256 in_value) noexcept
+    {
+        const auto bits = _mm256_castps_si256(in_value);
+        const auto exponent = _mm256_cvtepi32_ps(_mm256_sub_epi32(_mm256_srli_epi32(bits, 23), _mm256_set1_epi32(127)));
+        const auto mantissa = _mm256_castsi256_ps(_mm256_or_si256(_mm256_and_si256(bits, _mm256_set1_epi32(0x007fffff)), _mm256_set1_epi32(0x3f800000)));
+        const auto one = _mm256_set1_ps(1);
+        const auto t = _mm256_div_ps(_mm256_sub_ps(mantissa, one), _mm256_add_ps(mantissa, one));
+        const auto t2 = _mm256_mul_ps(t, t);
+        auto series = _mm256_add_ps(_mm256_set1_ps(log2C5), _mm256_mul_ps(t2, _mm256_set1_ps(log2C7)));
+
+        series = _mm256_add_ps(_mm256_set1_ps(log2C3), _mm256_mul_ps(t2, series));
+        series = _mm256_add_ps(_mm256_set1_ps(log2C1), _mm256_mul_ps(t2, series));
+
+        return _mm256_add_ps(exponent, _mm256_mul_ps(t, series));
+    }
+
+    __attribute__((target("avx2")))
+    static inline __m256 exp2Avx2(const __m256 in_value) noexcept
+    {
+        const auto value = _mm256_min_ps(_mm256_max_ps(in_value, _mm256_set1_ps(-126)), _mm256_set1_ps(126));
+        auto integer = _mm256_cvttps_epi32(value);
+
+        integer = _mm256_add_epi32(integer, _mm256_castps_si256(_mm256_cmp_ps(_mm256_cvtepi32_ps(integer), value, _CMP_GT_OQ)));
+
+        const auto f = _mm256_sub_ps(value, _mm256_cvtepi32_ps(integer));
+        auto series = _mm256_add_ps(_mm256_set1_ps(exp2C6), _mm256_mul_ps(f, _mm256_set1_ps(exp2C7)));
+
+        series = _mm256_add_ps(_mm256_set1_ps(exp2C5), _mm256_mul_ps(f, series));
+        series = _mm256_add_ps(_mm256_set1_ps(exp2C4), _mm256_mul_ps(f, series));
+        series = _mm256_add_ps(_mm256_set1_ps(exp2C3), _mm256_mul_ps(f, series));
+        series = _mm256_add_ps(_mm256_set1_ps(exp2C2), _mm256_mul_ps(f, series));
+        series = _mm256_add_ps(_mm256_set1_ps(exp2C1), _mm256_mul_ps(f, series));
+        series = _mm256_add_ps(_mm256_set1_ps(1), _mm256_mul_ps(f, series));
+
+        return _mm256_mul_ps(series, _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_add_epi32(integer, _mm256_set1_epi32(127)), 23)));
+    }
+
+    __attribute__((target("avx2")))
+    static void compressorAvx2(const float* in_key, float* io_samples, float* io_delay, const std::size_t in_delayFrames, std::size_t in_position, const PcmCompressor::Parameters& in_parameters, float* io_state, const std::size_t in_frames) noexcept
+    {
+        constexpr std::size_t lanes = 8;
+        const auto& p = in_parameters;
+        const auto levelScale = _mm256_set1_ps(p.rms ? powerDecibels : amplitudeDecibels);
+        const auto threshold = _mm256_set1_ps(p.threshold);
+        const auto halfKnee = _mm256_set1_ps(p.halfKnee);
+        const auto negativeHalfKnee = _mm256_set1_ps(-p.halfKnee);
+        const auto kneeFactor = _mm256_set1_ps(p.kneeFactor);
+        const auto ratioFactor = _mm256_set1_ps(p.ratioFactor);
+        const auto makeup = _mm256_set1_ps(p.makeup);
+        const auto attack = _mm256_set1_ps(p.attack);
+        const auto release = _mm256_set1_ps(p.release);
+        const auto rmsCoefficient = _mm256_set1_ps(p.rmsCoefficient);
+        const auto absMask = _mm256_castsi256_ps(_mm256_set1_epi32(0x7fffffff));
+        const auto minimum = _mm256_set1_ps(minimumLevel);
+        const auto octaves = _mm256_set1_ps(decibelOctaves);
+        auto envelope = _mm256_loadu_ps(io_state);
+        auto power = _mm256_loadu_ps(io_state + lanes);
+        auto reduction = _mm256_loadu_ps(io_state + lanes * 2);
+
+        for (std::size_t frame = 0; frame < in_frames; frame++)
+        {
+            const auto key = _mm256_loadu_ps(in_key + frame * lanes);
+            const auto square = _mm256_mul_ps(key, key);
+
+            power = _mm256_add_ps(square, _mm256_mul_ps(rmsCoefficient, _mm256_sub_ps(power, square)));
+
+            const auto detected = p.rms ? power : _mm256_and_ps(key, absMask);
+            const auto level = _mm256_mul_ps(log2Avx2(_mm256_max_ps(detected, minimum)), levelScale);
+            const auto over = _mm256_sub_ps(level, threshold);
+            const auto kneeOver = _mm256_add_ps(over, halfKnee);
+            const auto soft = _mm256_mul_ps(kneeFactor, _mm256_mul_ps(kneeOver, kneeOver));
+            const auto hard = _mm256_mul_ps(ratioFactor, over);
+            const auto knee = _mm256_blendv_ps(soft, hard, _mm256_cmp_ps(over, halfKnee, _CMP_GE_OQ));
+            const auto target = _mm256_and_ps(_mm256_cmp_ps(over, negativeHalfKnee, _CMP_GT_OQ), knee);
+            const auto coefficient = _mm256_blendv_ps(release, attack, _mm256_cmp_ps(target, envelope, _CMP_GT_OQ));
+
+            envelope = _mm256_add_ps(target, _mm256_mul_ps(coefficient, _mm256_sub_ps(envelope, target)));
+            reduction = _mm256_max_ps(reduction, envelope);
+
+            const auto gain = exp2Avx2(_mm256_mul_ps(_mm256_sub_ps(makeup, envelope), octaves));
+            auto sample = _mm256_loadu_ps(io_samples + frame * lanes);
+
+            if (in_delayFrames > 0)
+            {
+                const auto delayed = _mm256_loadu_ps(io_delay + in_position * lanes);
+
+                _mm256_storeu_ps(io_delay + in_position * lanes, sample);
+                sample = delayed;
+                if (++in_position == in_delayFrames) in_position = 0;
+            }
+
+            _mm256_storeu_ps(io_samples + frame * lanes, _mm256_mul_ps(sample, gain));
+        }
+
+        _mm256_storeu_ps(io_state, envelope);
+        _mm256_storeu_ps(io_state + lanes, power);
+        _mm256_storeu_ps(io_state + lanes * 2, reduction);
+    }
+#endif
+
+    static void gateScalar(float* io_samples, const PcmGate::Parameters& in_parameters, float* io_state, const std::size_t in_frames) noexcept
+    {
+        const auto& p = in_parameters;
+        auto gain = io_state[0];
+        auto open = io_state[1] > 0;
+        auto hold = io_state[2];
+        auto peak = io_state[3];
+
+        for (std::size_t frame = 0; frame < in_frames; frame++)
+        {
+            const auto sample = io_samples[frame];
+            const auto level = std::abs(sample);
+            const auto sustain = level >= p.close;
+
+            hold = sustain ? p.holdFrames : std::max(hold - 1.0f, 0.0f);
+            open = level >= p.open || (open && (sustain || hold > 0));
+
+            const auto target = open ? 1.0f : p.floor;
+
+            gain = target > gain ? std::min(gain + p.attackStep, target) : std::max(gain - p.releaseStep, target);
+            peak = std::max(peak, gain);
+            io_samples[frame] = sample * gain;
+        }
+
+        io_state[0] = gain;
+        io_state[1] = open ? 1.0f : 0.0f;
+        io_state[2] = hold;
+        io_state[3] = peak;
+    }
+
+#ifdef CLYPSALOT_X86_KERNELS
+    __attribute__((target("sse2")))
+    static void gateSse2(float* io_samples, const PcmGate::Parameters& in_parameters, float* io_state, const std::size_t in_frames) noexcept
+    {
+        constexpr std::size_t lanes = 4;
+        const auto& p = in_parameters;
+        const auto openLevel = _mm_set1_ps(p.open);
+        const auto closeLevel = _mm_set1_ps(p.close);
+        const auto holdFrames = _mm_set1_ps(p.holdFrames);
+        const auto floor = _mm_set1_ps(p.floor);
+        const auto attackStep = _mm_set1_ps(p.attackStep);
+        const auto releaseStep = _mm_set1_ps(p.releaseStep);
+        const auto absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff));
+        const auto zero = _mm_setzero_ps();
+        const auto one = _mm_set1_ps(1.0f);
+        auto gain = _mm_loadu_ps(io_state);
+        auto open = _mm_cmpgt_ps(_mm_loadu_ps(io_state + lanes), zero);
+        auto hold = _mm_loadu_ps(io_state + lanes * 2);
+        auto peak = _mm_loadu_ps(io_state + lanes * 3);
+
+        for (std::size_t frame = 0; frame < in_frames; frame++)
+        {
+            const auto sample = _mm_loadu_ps(io_samples + frame * lanes);
+            const auto level = _mm_and_ps(sample, absMask);
+            const auto sustain = _mm_cmpge_ps(level, closeLevel);
+
+            hold = selectSse2(sustain, holdFrames, _mm_max_ps(_mm_sub_ps(hold, one), zero));
+            open = _mm_or_ps(_mm_cmpge_ps(level, openLevel), _mm_and_ps(open, _mm_or_ps(sustain, _mm_cmpgt_ps(hold, zero))));
+
+            const auto target = selectSse2(open, one, floor);
+            const auto rising = _mm_min_ps(_mm_add_ps(gain, attackStep), target);
+            const auto falling = _mm_max_ps(_mm_sub_ps(gain, releaseStep), target);
+
+            gain = selectSse2(_mm_cmpgt_ps(target, gain), rising, falling);
+            peak = _mm_max_ps(peak, gain);
+            _mm_storeu_ps(io_samples + frame * lanes, _mm_mul_ps(sample, gain));
+        }
+
+        _mm_storeu_ps(io_state, gain);
+        _mm_storeu_ps(io_state + lanes, _mm_and_ps(open, one));
+        _mm_storeu_ps(io_state + lanes * 2, hold);
+        _mm_storeu_ps(io_state + lanes * 3, peak);
+    }
+
+    __attribute__((target("avx2")))
+    static void gateAvx2(float* io_samples, const PcmGate::Parameters& in_parameters, float* io_state, const std::size_t in_frames) noexcept
+    {
+        constexpr std::size_t lanes = 8;
+        const auto& p = in_parameters;
+        const auto openLevel = _mm256_set1_ps(p.open);
+        const auto closeLevel = _mm256_set1_ps(p.close);
+        const auto holdFrames = _mm256_set1_ps(p.holdFrames);
+        const auto floor = _mm256_set1_ps(p.floor);
+        const auto attackStep = _mm256_set1_ps(p.attackStep);
+        const auto releaseStep = _mm256_set1_ps(p.releaseStep);
+        const auto absMask = _mm256_castsi256_ps(_mm256_set1_epi32(0x7fffffff));
+        const auto zero = _mm256_setzero_ps();
+        const auto one = _mm256_set1_ps(1.0f);
+        auto gain = _mm256_loadu_ps(io_state);
+        auto open = _mm256_cmp_ps(_mm256_loadu_ps(io_state + lanes), zero, _CMP_GT_OQ);
+        auto hold = _mm256_loadu_ps(io_state + lanes * 2);
+        auto peak = _mm256_loadu_ps(io_state + lanes * 3);
+
+        for (std::size_t frame = 0; frame < in_frames; frame++)
+        {
+            const auto sample = _mm256_loadu_ps(io_samples + frame * lanes);
+            const auto level = _mm256_and_ps(sample, absMask);
+            const auto sustain = _mm256_cmp_ps(level, closeLevel, _CMP_GE_OQ);
+
+            hold = _mm256_blendv_ps(_mm256_max_ps(_mm256_sub_ps(hold, one), zero), holdFrames, sustain);
+
+            const auto held = _mm256_or_ps(sustain, _mm256_cmp_ps(hold, zero, _CMP_GT_OQ));
+
+            open = _mm256_or_ps(_mm256_cmp_ps(level, openLevel, _CMP_GE_OQ), _mm256_and_ps(open, held));
+
+            const auto target = _mm256_blendv_ps(floor, one, open);
+            const auto rising = _mm256_min_ps(_mm256_add_ps(gain, attackStep), target);
+            const auto falling = _mm256_max_ps(_mm256_sub_ps(gain, releaseStep), target);
+
+            gain = _mm256_blendv_ps(falling, rising, _mm256_cmp_ps(target, gain, _CMP_GT_OQ));
+            peak = _mm256_max_ps(peak, gain);
+            _mm256_storeu_ps(io_samples + frame * lanes, _mm256_mul_ps(sample, gain));
+        }
+
+        _mm256_storeu_ps(io_state, gain);
+        _mm256_storeu_ps(io_state + lanes, _mm256_and_ps(open, one));
+        _mm256_storeu_ps(io_state + lanes * 2, hold);
+        _mm256_storeu_ps(io_state + lanes * 3, peak);
+    }
+#endif
+
+    /**
+     * @param in_lookahead The number of frames the audio is delayed by.
+     * @param in_level The highest level of vector instructions to use. It is limited to what the
+     * CPU supports.
+     * @throws ValueError if there are no channels or the rate is not positive.
+     *
+     * There is no kernel that is wider than AVX2 because the grouped8 layout already fills an
+     * AVX2 register and the kernel is not limited by the width of the vectors.
+     */
+    PcmCompressor::PcmCompressor(const std::size_t in_channels, const double in_rate, const std::size_t in_lookahead, const SimdLevel in_level) :
+        m_channels(in_channels),
+        m_rate(in_rate),
+        m_lookahead(in_lookahead)
+    {
+        if (m_channels == 0) throw ValueError("Compressor channel count must be greater than zero");
+        if (! (m_rate > 0)) throw ValueError("Compressor sample rate must be greater than zero");
+
+        [[maybe_unused]] const auto level = std::min(in_level, simdLevel());
+
+        m_kernel = compressorScalar;
+
+#ifdef CLYPSALOT_X86_KERNELS
+        if (level >= SimdLevel::avx2)
+        {
+            m_kernel = compressorAvx2;
+            m_level = SimdLevel::avx2;
+        }
+        else if (level >= SimdLevel::sse2)
+        {
+            m_kernel = compressorSse2;
+            m_level = SimdLevel::sse2;
+        }
+#endif
+
+        m_layout = pcmSimdLayout(m_level);
+
+        const auto lanes = pcmLanes(m_layout);
+        const auto groups = (m_channels + lanes - 1) / lanes;
+
+        m_state.resize(groups * compressorState * lanes);
+
+        if (m_lookahead > 0)
+        {
+            m_delayPool = PcmBufferPool::make({ PcmFormat::float32, m_channels, m_lookahead, 0, static_cast<std::size_t>(m_rate), m_layout }, 1);
+            m_delay = m_delayPool->acquire();
+        }
+
+        settings(m_settings);
+    }
+
+    std::size_t PcmCompressor::channels() const noexcept
+    {
+        return m_channels;
+    }
+
+    double PcmCompressor::rate() const noexcept
+    {
+        return m_rate;
+    }
+
+    SimdLevel PcmCompressor::level() const noexcept
+    {
+        return m_level;
+    }
+
+    /// @brief The layout the buffers given to process() must use.
+    PcmLayout PcmCompressor::layout() const noexcept
+    {
+        return m_layout;
+    }
+
+    /// @brief The number of frames the output is behind the input.
+    std::size_t PcmCompressor::latency() const noexcept
+    {
+        return m_lookahead;
+    }
+
+    const CompressorSettings& PcmCompressor::settings() const noexcept
+    {
+        return m_settings;
+    }
+
+    /**
+     * @brief Change the settings. The state is kept so the change is smooth.
+     * @throws ValueError if the ratio is less than 1, a time or the knee is negative or a level
+     * is not finite.
+     */
+    void PcmCompressor::settings(const CompressorSettings& in_settings)
+    {
+        const auto& s = in_settings;
+
+        if (! (s.ratio >= 1)) throw ValueError(makeString("Compressor ratio must be at least 1: ", s.ratio));
+        if (! (s.knee >= 0)) throw ValueError(makeString("Compressor knee can not be negative: ", s.knee));
+        if (! std::isfinite(s.threshold)) throw ValueError(makeString("Compressor threshold must be finite: ", s.threshold));
+        if (! std::isfinite(s.makeup)) throw ValueError(makeString("Compressor makeup gain must be finite: ", s.makeup));
+
+        for (const auto time : { s.attack, s.release, s.rmsWindow })
+        {
+            if (! (time >= 0)) throw ValueError(makeString("Compressor times can not be negative: ", time));
+        }
+
+        auto& p = m_parameters;
+
+        p.threshold = s.threshold;
+        p.halfKnee = s.knee / 2;
+        p.ratioFactor = 1 - 1 / s.ratio;
+        p.kneeFactor = s.knee > 0 ? p.ratioFactor / (2 * s.knee) : 0;
+        p.makeup = s.makeup;
+        p.attack = timeCoefficient(s.attack, m_rate);
+        p.release = timeCoefficient(s.release, m_rate);
+        p.rmsCoefficient = timeCoefficient(s.rmsWindow, m_rate);
+        p.rms = s.detector == CompressorDetector::rms;
+        m_settings = s;
+    }
+
+    /// @brief The most gain reduction in dB of any channel during the last call to process().
+    float PcmCompressor::gainReduction() const noexcept
+    {
+        return m_gainReduction;
+    }
+
+    /// @brief Forget the envelopes and clear the delay line.
+    void PcmCompressor::reset() noexcept
+    {
+        std::fill(m_state.begin(), m_state.end(), 0.0f);
+        m_position = 0;
+        m_gainReduction = 0;
+
+        if (! m_delay) return;
+
+        auto& delay = m_delay.writable();
+        const auto lanes = pcmLanes(m_layout);
+
+        for (std::size_t group = 0; group < delay.groups(); group++)
+        {
+            std::fill_n(delay.group<float>(group), m_lookahead * lanes, 0.0f);
+        }
+    }
+
+    /// @brief Compress a buffer using itself as the key.
+    void PcmCompressor::process(PcmBuffer& io_buffer, const std::size_t in_frames) noexcept
+    {
+        process(io_buffer, io_buffer, in_frames);
+    }
+
+    /**
+     * @brief Compress a buffer in place using the level of another buffer with the same
+     * channels, like a sidechain.
+     */
+    void PcmCompressor::process(const PcmBuffer& in_key, PcmBuffer& io_buffer, const std::size_t in_frames) noexcept
+    {
+        assert(in_key.format() == PcmFormat::float32 && io_buffer.format() == PcmFormat::float32);
+        assert(in_key.layout() == m_layout && io_buffer.layout() == m_layout);
+        assert(in_key.channels() == m_channels && io_buffer.channels() == m_channels);
+        assert(in_frames <= in_key.frames() && in_frames <= io_buffer.frames());
+
+        const auto lanes = pcmLanes(m_layout);
+        const auto groups = (m_channels + lanes - 1) / lanes;
+        [[maybe_unused]] const DenormalGuard guard;
+        float reduction = 0;
+
+        for (std::size_t group = 0; group < groups; group++)
+        {
+            const auto state = m_state.data() + group * compressorState * lanes;
+            const auto delay = m_delay ? m_delay.writable().group<float>(group) : nullptr;
+
+            std::fill_n(state + lanes * 2, lanes, 0.0f);
+            m_kernel(in_key.group<float>(group), io_buffer.group<float>(group), delay, m_lookahead, m_position, m_parameters, state, in_frames);
+
+            // The lanes past the last channel of the last group are padding.
+            for (std::size_t lane = 0; lane < lanes && group * lanes + lane < m_channels; lane++)
+            {
+                reduction = std::max(reduction, state[lanes * 2 + lane]);
+            }
+        }
+
+        if (m_lookahead > 0) m_position = (m_position + in_frames) % m_lookahead;
+        m_gainReduction = reduction;
+    }
+
+    /**
+     * @param in_level The highest level of vector instructions to use. It is limited to what the
+     * CPU supports.
+     * @throws ValueError if there are no channels or the rate is not positive.
+     *
+     * The gate starts closed.
+     */
+    PcmGate::PcmGate(const std::size_t in_channels, const double in_rate, const SimdLevel in_level) :
+        m_channels(in_channels),
+        m_rate(in_rate)
+    {
+        if (m_channels == 0) throw ValueError("Gate channel count must be greater than zero");
+        if (! (m_rate > 0)) throw ValueError("Gate sample rate must be greater than zero");
+
+        [[maybe_unused]] const auto level = std::min(in_level, simdLevel());
+
+        m_kernel = gateScalar;
+
+#ifdef CLYPSALOT_X86_KERNELS
+        if (level >= SimdLevel::avx2)
+        {
+            m_kernel = gateAvx2;
+            m_level = SimdLevel::avx2;
+        }
+        else if (level >= SimdLevel::sse2)
+        {
+            m_kernel = gateSse2;
+            m_level = SimdLevel::sse2;
+        }
+#endif
+
+        m_layout = pcmSimdLayout(m_level);
+
+        const auto lanes = pcmLanes(m_layout);
+        const auto groups = (m_channels + lanes - 1) / lanes;
+
+        m_state.resize(groups * gateState * lanes);
+        settings(m_settings);
+        reset();
+    }
+
+    std::size_t PcmGate::channels() const noexcept
+    {
+        return m_channels;
+    }
+
+    double PcmGate::rate() const noexcept
+    {
+        return m_rate;
+    }
+
+    SimdLevel PcmGate::level() const noexcept
+    {
+        return m_level;
+    }
+
+    /// @brief The layout the buffers given to process() must use.
+    PcmLayout PcmGate::layout() const noexcept
+    {
+        return m_layout;
+    }
+
+    const GateSettings& PcmGate::settings() const noexcept
+    {
+        return m_settings;
+    }
+
+    /**
+     * @brief Change the settings. The state is kept so the change is smooth.
+     * @throws ValueError if the hysteresis or a time is negative, the range is above 0 dB or the
+     * threshold is not finite.
+     */
+    void PcmGate::settings(const GateSettings& in_settings)
+    {
+        const auto& s = in_settings;
+
+        if (! std::isfinite(s.threshold)) throw ValueError(makeString("Gate threshold must be finite: ", s.threshold));
+        if (! (s.hysteresis >= 0) || std::isinf(s.hysteresis)) throw ValueError(makeString("Gate hysteresis must be finite and not negative: ", s.hysteresis));
+        if (! (s.range <= 0)) throw ValueError(makeString("Gate range can not be above 0 dB: ", s.range));
+
+        for (const auto time : { s.attack, s.hold, s.release })
+        {
+            if (! (time >= 0)) throw ValueError(makeString("Gate times can not be negative: ", time));
+        }
+
+        auto& p = m_parameters;
+        // A ramp over the full distance from the floor to unity in the given time. No time at
+        // all is an infinite step which the kernels clamp to the target.
+        const auto step = [&](const float in_milliseconds)
+        {
+            const auto frames = in_milliseconds * m_rate / 1000;
+            return frames > 0 ? static_cast<float>((1 - p.floor) / frames) : std::numeric_limits<float>::infinity();
+        };
+
+        p.open = std::pow(10.0f, s.threshold / 20);
+        p.close = std::pow(10.0f, (s.threshold - s.hysteresis) / 20);
+        p.holdFrames = std::min(static_cast<float>(std::round(s.hold * m_rate / 1000)), maximumHoldFrames);
+        p.floor = std::pow(10.0f, s.range / 20);
+        p.attackStep = step(s.attack);
+        p.releaseStep = step(s.release);
+        m_settings = s;
+    }
+
+    /**
+     * @brief True if the range closes the gate completely and every channel was fully closed
+     * for all of the last call to process() so the output was all zeros.
+     */
+    bool PcmGate::silent() const noexcept
+    {
+        return m_silent;
+    }
+
+    /// @brief Close the gate and forget the hold times.
+    void PcmGate::reset() noexcept
+    {
+        const auto lanes = pcmLanes(m_layout);
+
+        for (std::size_t offset = 0; offset < m_state.size(); offset += gateState * lanes)
+        {
+            std::fill_n(m_state.data() + offset, lanes, m_parameters.floor);
+            std::fill_n(m_state.data() + offset + lanes, lanes * (gateState - 1), 0.0f);
+        }
+
+        m_silent = m_parameters.floor == 0;
+    }
+
+    /**
+     * @brief Gate a buffer in place.
+     * @param in_silent True if the caller knows every sample is zero. If the gate is also fully
+     * closed and can not ramp up to a floor above zero nothing can change so the buffer is left
+     * alone.
+     */
+    void PcmGate::process(PcmBuffer& io_buffer, const std::size_t in_frames, const bool in_silent) noexcept
+    {
+        assert(io_buffer.format() == PcmFormat::float32);
+        assert(io_buffer.layout() == m_layout);
+        assert(io_buffer.channels() == m_channels);
+        assert(in_frames <= io_buffer.frames());
+
+        if (in_silent && m_silent && m_parameters.floor == 0) return;
+
+        const auto lanes = pcmLanes(m_layout);
+        const auto groups = (m_channels + lanes - 1) / lanes;
+        [[maybe_unused]] const DenormalGuard guard;
+        float peak = 0;
+
+        for (std::size_t group = 0; group < groups; group++)
+        {
+            const auto state = m_state.data() + group * gateState * lanes;
+
+            std::fill_n(state + lanes * 3, lanes, 0.0f);
+            m_kernel(io_buffer.group<float>(group), m_parameters, state, in_frames);
+
+            // The lanes past the last channel of the last group are padding.
+            for (std::size_t lane = 0; lane < lanes && group * lanes + lane < m_channels; lane++)
+            {
+                peak = std::max(peak, state[lanes * 3 + lane]);
+            }
+        }
+
+        m_silent = peak == 0;
+    }
+
+    CompressorDetector stringToCompressorDetector(const std::string& in_name)
+    {
+        for (const auto detector : { CompressorDetector::peak, CompressorDetector::rms })
+        {
+            if (toString(detector) == in_name) return detector;
+        }
+
+        throw ValueError(makeString("Unknown compressor detector: ", in_name));
+    }
+
+    std::string toString(const CompressorDetector in_detector) noexcept
+    {
+        switch (in_detector)
+        {
+            case CompressorDetector::peak: return "peak";
+            case CompressorDetector::rms: return "rms";
+        }
+
+        FATAL_ERROR(makeString("Unhandled CompressorDetector value: ", static_cast<int>(in_detector)));
+    }
+
+    std::ostream& operator<<(std::ostream& in_os, const CompressorDetector in_detector) noexcept
+    {
+        in_os << toString(in_detector);
+        return in_os;
+    }
+}
@@ -0,0 +1,199 @@
+/* Copyright 2023 Tyler Riddle
+ *
+ * This file is part of Clypsalot. Clypsalot is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU Lesser General Public License as published by the Free Software Foundation, either version 3 of the License,
+ * or (at your option) any later version. Clypsalot is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along with Clypsalot. If not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include <clypsalot/pcm.hxx>
+#include <clypsalot/simd.hxx>
+
+/// @file
+namespace Clypsalot
+{
+    /// @brief How a PcmCompressor measures the level of its key signal.
+    enum class CompressorDetector : uint_fast8_t
+    {
+        /// @brief The absolute value of every sample.
+        peak,
+        /// @brief The mean square averaged over the RMS window.
+        rms,
+    };
+
+    /// @brief The controls of a PcmCompressor. Levels are in dB and times in milliseconds.
+    struct CompressorSettings
+    {
+        CompressorDetector detector = CompressorDetector::peak;
+        float threshold = -18;
+        /// @brief The input dB above the threshold for each dB of output. A large ratio with
+        /// some lookahead is a limiter.
+        float ratio = 4;
+        /// @brief The width of the soft knee centered on the threshold. 0 is a hard knee.
+        float knee = 6;
+        float attack = 10;
+        float release = 100;
+        float makeup = 0;
+        float rmsWindow = 10;
+
+        bool operator==(const CompressorSettings&) const noexcept = default;
+    };
+
+    /**
+     * @brief A feed forward compressor working on every channel of a float32 buffer.
+     *
+     * The level of the key signal goes through a static gain curve in dB and the gain reduction
+     * is smoothed with separate attack and release times. Every channel has its own detector.
+     * The channels are processed in the layout given by pcmSimdLayout() for the level of the
+     * kernel so the detector, the gain curve and the envelope follower all run on a whole group
+     * of channels at once. Every level gives the same result for the same input.
+     *
+     * With lookahead the audio is delayed while the key is not so the gain is already reduced
+     * when a transient reaches the output. The delay line is a block taken from a PcmBufferPool
+     * that is created with the compressor so changing the settings and processing never
+     * allocate.
+     */
+    class PcmCompressor
+    {
+        public:
+        /// @brief The settings turned into what the kernels use.
+        struct Parameters
+        {
+            float threshold = 0;
+            float halfKnee = 0;
+            float kneeFactor = 0;
+            float ratioFactor = 0;
+            float makeup = 0;
+            float attack = 0;
+            float release = 0;
+            float rmsCoefficient = 0;
+            bool rms = false;
+        };
+
+        using Kernel = void (*)(const float* in_key, float* io_samples, float* io_delay, const std::size_t in_delayFrames, std::size_t in_position, const Parameters& in_parameters, float* io_state, const std::size_t in_frames) noexcept;
+
+        private:
+        const std::size_t m_channels;
+        const double m_rate;
+        const std::size_t m_lookahead;
+        SimdLevel m_level = SimdLevel::scalar;
+        PcmLayout m_layout = PcmLayout::planar;
+        Kernel m_kernel = nullptr;
+        CompressorSettings m_settings;
+        Parameters m_parameters;
+        std::vector<float> m_state;
+        std::shared_ptr<PcmBufferPool> m_delayPool;
+        SharedPcmBuffer m_delay;
+        std::size_t m_position = 0;
+        float m_gainReduction = 0;
+
+        public:
+        PcmCompressor(const std::size_t in_channels, const double in_rate, const std::size_t in_lookahead, const SimdLevel in_level = simdLevel());
+        PcmCompressor(const PcmCompressor&) = delete;
+        void operator=(const PcmCompressor&) = delete;
+        std::size_t channels() const noexcept;
+        double rate() const noexcept;
+        SimdLevel level() const noexcept;
+        PcmLayout layout() const noexcept;
+        std::size_t latency() const noexcept;
+        const CompressorSettings& settings() const noexcept;
+        void settings(const CompressorSettings& in_settings);
+        float gainReduction() const noexcept;
+        void reset() noexcept;
+        void process(PcmBuffer& io_buffer, const std::size_t in_frames) noexcept;
+        void process(const PcmBuffer& in_key, PcmBuffer& io_buffer, const std::size_t in_frames) noexcept;
+    };
+
+    /// @brief The controls of a PcmGate. Levels are in dB and times in milliseconds.
+    struct GateSettings
+    {
+        /// @brief The level that opens the gate.
+        float threshold = -40;
+        /// @brief How far below the threshold the level must fall before the gate starts to
+        /// close so a signal sitting on the threshold does not chatter.
+        float hysteresis = 6;
+        /// @brief The time to fade from fully closed to fully open.
+        float attack = 1;
+        /// @brief How long the gate stays open after the level falls below the close level.
+        float hold = 50;
+        /// @brief The time to fade from fully open to fully closed.
+        float release = 100;
+        /// @brief The gain of the closed gate. Negative infinity closes it completely.
+        float range = -std::numeric_limits<float>::infinity();
+
+        bool operator==(const GateSettings&) const noexcept = default;
+    };
+
+    /**
+     * @brief A noise gate working on every channel of a float32 buffer.
+     *
+     * Every channel has its own peak detector and gain. The channels are processed in the layout
+     * given by pcmSimdLayout() for the level of the kernel so the detector, the hysteresis and
+     * hold logic and the gain ramps run on a whole group of channels at once. Every level gives
+     * the same result for the same input.
+     *
+     * The gain moves in straight lines between the range and unity so a closing gate reaches
+     * true silence in the release time instead of decaying forever. When it has the gate can say
+     * so with silent() and skips the work on input that is already silent.
+     */
+    class PcmGate
+    {
+        public:
+        /// @brief The settings turned into what the kernels use.
+        struct Parameters
+        {
+            float open = 0;
+            float close = 0;
+            float holdFrames = 0;
+            float floor = 0;
+            float attackStep = 0;
+            float releaseStep = 0;
+        };
+
+        using Kernel = void (*)(float* io_samples, const Parameters& in_parameters, float* io_state, const std::size_t in_frames) noexcept;
+
+        private:
+        const std::size_t m_channels;
+        const double m_rate;
+        SimdLevel m_level = SimdLevel::scalar;
+        PcmLayout m_layout = PcmLayout::planar;
+        Kernel m_kernel = nullptr;
+        GateSettings m_settings;
+        Parameters m_parameters;
+        std::vector<float> m_state;
+        bool m_silent = false;
+
+        public:
+        PcmGate(const std::size_t in_channels, const double in_rate, const SimdLevel in_level = simdLevel());
+        PcmGate(const PcmGate&) = delete;
+        void operator=(const PcmGate&) = delete;
+        std::size_t channels() const noexcept;
+        double rate() const noexcept;
+        SimdLevel level() const noexcept;
+        PcmLayout layout() const noexcept;
+        const GateSettings& settings() const noexcept;
+        void settings(const GateSettings& in_settings);
+        bool silent() const noexcept;
+        void reset() noexcept;
+        void process(PcmBuffer& io_buffer, const std::size_t in_frames, const bool in_silent = false) noexcept;
+    };
+
+    CompressorDetector stringToCompressorDetector(const std::string& in_name);
+    std::string toString(const CompressorDetector in_detector) noexcept;
+    std::ostream& operator<<(std::ostream& in_os, const CompressorDetector in_detector) noexcept;
+}
@@ -0,0 +1,295 @@
+/* Copyright 2023 Tyler Riddle
+ *
+ * This file is part of Clypsalot. Clypsalot is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU Lesser General Public License as published by the Free Software Foundation, either version 3 of the License,
+ * or (at your option) any later version. Clypsalot is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along with Clypsalot. If not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+#include <clypsalot/equalizer.hxx>
+#include <clypsalot/error.hxx>
+#include <clypsalot/logger.hxx>
+#include <clypsalot/pcm.hxx>
+#include <clypsalot/property.hxx>
+#include <clypsalot/thread.hxx>
+#include <clypsalot/util.hxx>
+
+/// @file
+namespace Clypsalot
+{
+    const std::string EqualizerObject::kindName = "Equalizer";
+    static const std::string bandsPropertyName = "Bands";
+    static const std::string channelsPropertyName = "Channels";
+    static const std::string sampleRatePropertyName = "Sample Rate";
+    static const std::string blockSizePropertyName = "Block Size";
+    static const std::size_t defaultBands = 4;
+    static const PropertyList equalizerProperties = {
+        // Only read the first time the Object is configured.
+        { bandsPropertyName, PropertyType::size, Property::Configurable, defaultBands },
+        { channelsPropertyName, PropertyType::size, Property::Configurable | Property::Required, nullptr },
+        { sampleRatePropertyName, PropertyType::size, Property::Configurable, 48000 },
+        { blockSizePropertyName, PropertyType::size, Property::Configurable, 256 },
+    };
+
+    static std::string bandPropertyName(const std::size_t in_band, const char* in_name)
+    {
+        return makeString("Band ", in_band + 1, " ", in_name);
+    }
+
+    std::shared_ptr<EqualizerObject> EqualizerObject::make()
+    {
+        return _makeObject<EqualizerObject>(kindName);
+    }
+
+    EqualizerObject::EqualizerObject(const std::string& in_kind) :
+        Object(in_kind)
+    {
+        std::scoped_lock lock(*this);
+
+        addProperties(equalizerProperties);
+
+        m_input = static_cast<PcmInputPort*>(&addInput<PcmInputPort>("input"));
+        m_output = static_cast<PcmOutputPort*>(&addOutput<PcmOutputPort>("output"));
+        m_output->inPlace(m_input);
+    }
+
+    EqualizerObject::~EqualizerObject() noexcept
+    {
+        std::scoped_lock lock(*this);
+
+        waitForUpdate();
+    }
+
+    /// @throws RuntimeError if the Object was not configured.
+    const BiquadCascade& EqualizerObject::cascade() const
+    {
+        assert(haveLock());
+
+        if (! m_cascade) throw RuntimeError("The equalizer has not been configured");
+
+        return *m_cascade;
+    }
+
+    /// @brief True while new coefficients are being designed.
+    bool EqualizerObject::updating() const noexcept
+    {
+        assert(haveLock());
+
+        return m_updating;
+    }
+
+    /// @throws ValueError if Bands is 0 or more than maxBands.
+    void EqualizerObject::handleInit(const ObjectConfig& in_config)
+    {
+        assert(haveLock());
+
+        Object::handleInit(in_config);
+
+        auto bands = defaultBands;
+
+        // The band properties have to exist before the configuration is applied to them.
+        for (const auto& [name, value] : in_config)
+        {
+            if (name == bandsPropertyName) bands = std::get<Property::SizeType>(property(bandsPropertyName).convert(value));
+        }
+
+        if (bands == 0 || bands > maxBands) throw ValueError(makeString(bandsPropertyName, " must be between 1 and ", maxBands, ": ", bands));
+
+        // Configurations that leave Bands out, such as typed ones compiled after init(), must
+        // still match the bands that exist.
+        propertySizeRef(bandsPropertyName) = bands;
+
+        for (std::size_t band = 0; band < bands; band++)
+        {
+            // The bands are spread from 100 Hz to 10 kHz and start out flat.
+            const auto frequency = bands > 1 ? 100 * std::pow(100.0f, static_cast<float>(band) / (bands - 1)) : 1000.0f;
+            const auto flags = Property::Configurable | Property::PublicMutable;
+            BandProperties properties;
+
+            properties.type = &addProperty({ bandPropertyName(band, "Type"), PropertyType::string, flags, Clypsalot::toString(BiquadType::peak) });
+            properties.frequency = &addProperty({ bandPropertyName(band, "Frequency"), PropertyType::real, flags, frequency });
+            properties.gain = &addProperty({ bandPropertyName(band, "Gain"), PropertyType::real, flags, 0.0f });
+            properties.q = &addProperty({ bandPropertyName(band, "Q"), PropertyType::real, flags, 0.707f });
+            m_bandProperties.push_back(properties);
+        }
+    }
+
+    /**
+     * @throws ValueError if Bands changed since the Object was initialized, there are no channels or
+     * a band is not valid.
+     */
+    void EqualizerObject::handleConfigure(const ObjectConfig& in_config)
+    {
+        assert(haveLock());
+
+        Object::handleConfigure(in_config);
+        waitForUpdate();
+
+        const auto bands = m_bandProperties.size();
+        const auto& channels = property(channelsPropertyName);
+
+        if (property(bandsPropertyName).sizeValue() != bands)
+        {
+            throw ValueError(makeString(bandsPropertyName, " can only be set when the Object is initialized"));
+        }
+
+        if (! channels.defined()) throw ValueError(makeString("Property is required: ", channelsPropertyName));
+
+        const auto blockSize = property(blockSizePropertyName).sizeValue();
+
+        m_rate = property(sampleRatePropertyName).sizeValue();
+
+        if (m_rate == 0) throw ValueError(makeString(sampleRatePropertyName, " must be greater than zero"));
+        if (blockSize == 0) throw ValueError(makeString(blockSizePropertyName, " must be greater than zero"));
+
+        auto cascade = std::make_unique<BiquadCascade>(channels.sizeValue(), bands);
+        const PcmConfig config = { PcmFormat::float32, cascade->channels(), blockSize, 0, static_cast<std::size_t>(m_rate), cascade->layout() };
+
+        m_current.resize(bands);
+        m_read.resize(bands);
+        m_request.resize(bands);
+        m_designed.resize(bands);
+        // Sized here so remembering rejected bands copies into it instead of allocating. Bands
+        // that were read always have a type so the empty ones never match them.
+        m_rejected.assign(bands, BandSettings());
+        readBands(m_current);
+        checkBands(m_current);
+
+        for (std::size_t band = 0; band < bands; band++)
+        {
+            const auto& settings = m_current[band];
+
+            cascade->coefficients(band, designBiquad(stringToBiquadType(settings.type), m_rate, settings.frequency, settings.gain, settings.q));
+        }
+
+        m_input->config(config);
+        m_output->config(config);
+        m_cascade = std::move(cascade);
+        m_updated = false;
+
+        OBJECT_LOGGER(debug, "Configured ", bands, " bands for ", config.channels, " channels with ", m_cascade->level(), " kernels");
+    }
+
+    /// @brief Read the band properties. This does not allocate unless a type is too long to
+    /// be stored in place.
+    void EqualizerObject::readBands(std::vector<BandSettings>& out_settings) const
+    {
+        for (std::size_t band = 0; band < m_bandProperties.size(); band++)
+        {
+            const auto& properties = m_bandProperties[band];
+            auto& settings = out_settings[band];
+
+            settings.type = properties.type->stringValue();
+            settings.frequency = properties.frequency->realValue();
+            settings.gain = properties.gain->realValue();
+            settings.q = properties.q->realValue();
+        }
+    }
+
+    /**
+     * @throws ValueError if a band can not be designed.
+     *
+     * The checks are the ones designBiquad() makes so the designs done on the ThreadQueue can
+     * not fail.
+     */
+    void EqualizerObject::checkBands(const std::vector<BandSettings>& in_settings) const
+    {
+        for (std::size_t band = 0; band < in_settings.size(); band++)
+        {
+            const auto& settings = in_settings[band];
+
+            stringToBiquadType(settings.type);
+
+            if (! (settings.frequency > 0 && settings.frequency < m_rate / 2))
+            {
+                throw ValueError(makeString(bandPropertyName(band, "Frequency"), " must be between 0 and ", m_rate / 2, ": ", settings.frequency));
+            }
+
+            if (! (settings.q > 0)) throw ValueError(makeString(bandPropertyName(band, "Q"), " must be greater than zero: ", settings.q));
+        }
+    }
+
+    // Runs on the ThreadQueue. The request and the designs are left alone by the Object while
+    // the update is running.
+    void EqualizerObject::update() noexcept
+    {
+        for (std::size_t band = 0; band < m_request.size(); band++)
+        {
+            const auto& settings = m_request[band];
+
+            m_designed[band] = designBiquad(stringToBiquadType(settings.type), m_rate, settings.frequency, settings.gain, settings.q);
+        }
+
+        std::scoped_lock lock(*this);
+
+        m_updating = false;
+        m_updated = true;
+        m_updateDone.notify_all();
+    }
+
+    void EqualizerObject::waitForUpdate() noexcept
+    {
+        assert(haveLock());
+
+        m_updateDone.wait(*this, [this] { return ! m_updating; });
+    }
+
+    /// @throws RuntimeError if the input has more frames than the block size.
+    ObjectProcessResult EqualizerObject::process()
+    {
+        assert(haveLock());
+
+        const auto frames = m_input->frames();
+
+        if (frames > m_output->config().blockSize) throw RuntimeError(makeString("Input block is larger than ", blockSizePropertyName));
+
+        if (m_updated)
+        {
+            for (std::size_t band = 0; band < m_designed.size(); band++)
+            {
+                m_cascade->coefficients(band, m_designed[band]);
+            }
+
+            std::swap(m_current, m_request);
+            m_updated = false;
+        }
+
+        if (! m_updating)
+        {
+            readBands(m_read);
+
+            // Bands that were rejected once are not checked or logged again until they change.
+            if (m_read != m_current && m_read != m_rejected)
+            {
+                try
+                {
+                    checkBands(m_read);
+                    std::swap(m_request, m_read);
+                    m_updating = true;
+                    threadQueuePost([this] { update(); });
+                }
+                catch (const ValueError& e)
+                {
+                    std::copy(m_read.begin(), m_read.end(), m_rejected.begin());
+                    OBJECT_LOGGER(warn, "Keeping the current bands: ", e.what());
+                }
+            }
+        }
+
+        auto& buffer = m_output->buffer();
+
+        m_cascade->process(buffer, buffer, frames);
+        m_output->commit(frames);
+
+        return ObjectProcessResult::finished;
+    }
+}
@@ -0,0 +1,96 @@
+/* Copyright 2023 Tyler Riddle
+ *
+ * This file is part of Clypsalot. Clypsalot is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU Lesser General Public License as published by the Free Software Foundation, either version 3 of the License,
+ * or (at your option) any later version. Clypsalot is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along with Clypsalot. If not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#include <condition_variable>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <clypsalot/biquad.hxx>
+#include <clypsalot/object.hxx>
+
+/// @file
+namespace Clypsalot
+{
+    /**
+     * @brief A parametric equalizer made of a cascade of biquads.
+     *
+     * The number of bands is set with the Bands property the first time the Object is configured
+     * and each band gets Type, Frequency, Gain and Q properties named like "Band 1 Frequency".
+     * The band properties can be changed while the Object runs. A change is noticed at the start
+     * of a period and the new coefficients are designed by a job on the ThreadQueue so the trig
+     * never runs on the processing thread; the first period that starts after the job finished
+     * uses them. Bands that can not be designed, such as a Frequency at or above half the rate,
+     * are logged and the current coefficients are kept until the bands are valid again.
+     *
+     * The input asks for float32 in the layout the kernel wants so the link converts and
+     * transposes when it has to and the samples are filtered in place.
+     */
+    class EqualizerObject : public Object
+    {
+        struct BandSettings
+        {
+            std::string type;
+            float frequency = 0;
+            float gain = 0;
+            float q = 0;
+
+            bool operator==(const BandSettings&) const noexcept = default;
+        };
+
+        struct BandProperties
+        {
+            Property* type = nullptr;
+            Property* frequency = nullptr;
+            Property* gain = nullptr;
+            Property* q = nullptr;
+        };
+
+        PcmInputPort* m_input = nullptr;
+        PcmOutputPort* m_output = nullptr;
+        std::vector<BandProperties> m_bandProperties;
+        std::unique_ptr<BiquadCascade> m_cascade;
+        double m_rate = 0;
+        std::vector<BandSettings> m_current;
+        std::vector<BandSettings> m_read;
+        std::vector<BandSettings> m_request;
+        std::vector<BandSettings> m_rejected;
+        std::vector<BiquadCoefficients> m_designed;
+        bool m_updating = false;
+        bool m_updated = false;
+        std::condition_variable_any m_updateDone;
+
+        void readBands(std::vector<BandSettings>& out_settings) const;
+        void checkBands(const std::vector<BandSettings>& in_settings) const;
+        void update() noexcept;
+        void waitForUpdate() noexcept;
+
+        protected:
+        virtual void handleInit(const ObjectConfig& in_config) override;
+        virtual void handleConfigure(const ObjectConfig& in_config) override;
+        virtual ObjectProcessResult process() override;
+
+        public:
+        static const std::string kindName;
+        /// @brief The most bands an equalizer can have.
+        static constexpr std::size_t maxBands = 32;
+
+        static std::shared_ptr<EqualizerObject> make();
+        EqualizerObject(const std::string& in_kind);
+        virtual ~EqualizerObject() noexcept;
+        const BiquadCascade& cascade() const;
+        bool updating() const noexcept;
+    };
+}
@@ -0,0 +1,373 @@
+/* Copyright 2023 Tyler Riddle
+ *
+ * This file is part of Clypsalot. Clypsalot is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU Lesser General Public License as published by the Free Software Foundation, either version 3 of the License,
+ * or (at your option) any later version. Clypsalot is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along with Clypsalot. If not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+
+
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <cmath>
+#include <numbers>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define CLYPSALOT_X86_KERNELS
+#include <immintrin.h>
+#endif
+
+#include <clypsalot/error.hxx>
+#include <clypsalot/fft.hxx>
+#include <clypsalot/util.hxx>
+
+/// @file
+namespace Clypsalot
+{
+    /*
+     * One radix 2 stage of a Stockham FFT. The sequence is in_half * 2 blocks of in_stride
+     * elements. Block p is paired with block p + in_half and the sum and the twiddled
+     * difference go to blocks 2p and 2p + 1 of the output so the result comes out in order
+     * with out a bit reversal.
+     */
+    static void stageScalar(const float* in_real, const float* in_imaginary, float* out_real, float* out_imaginary, const float* in_twiddleReal, const float* in_twiddleImaginary, const std::size_t in_half, const std::size_t in_stride) noexcept
+    {
+        const auto s = in_stride;
+
+        for (std::size_t p = 0; p < in_half; p++)
+        {
+            const auto wr = in_twiddleReal[p * s];
+            const auto wi = in_twiddleImaginary[p * s];
+
+            for (std::size_t q = 0; q < s; q++)
+            {
+                const auto ar = in_real[q + s * p];
+                const auto ai = in_imaginary[q + s * p];
+                const auto br = in_real[q + s * (p + in_half)];
+                const auto bi = in_imaginary[q + s * (p + in_half)];
+                const auto dr = ar - br;
+                const auto di = ai - bi;
+
+                out_real[q + s * 2 * p] = ar + br;
+                out_imaginary[q + s * 2 * p] = ai + bi;
+                out_real[q + s * (2 * p + 1)] = dr * wr - di * wi;
+                out_imaginary[q + s * (2 * p + 1)] = dr * wi + di * wr;
+            }
+        }
+    }
+
+    static void multiplyScalar(const float* in_aReal, const float* in_aImaginary, const float* in_bReal, const float* in_bImaginary, float* io_real, float* io_imaginary, const std::size_t in_bins) noexcept
+    {
+        for (std::size_t bin = 0; bin < in_bins; bin++)
+        {
+            const auto ar = in_aReal[bin];
+            const auto ai = in_aImaginary[bin];
+            const auto br = in_bReal[bin];
+            const auto bi = in_bImaginary[bin];
+
+            io_real[bin] += ar * br - ai * bi;
+            io_imaginary[bin] += ar * bi + ai * br;
+        }
+    }
+
+#ifdef CLYPSALOT_X86_KERNELS
+    // The stride must be a multiple of 4.
+    __attribute__((target("sse2")))
+    static void stageSse2(const float* in_real, const float* in_imaginary, float* out_real, float* out_imaginary, const float* in_twiddleReal, const float* in_twiddleImaginary, const std::size_t in_half, const std::size_t in_stride) noexcept
+    {
+        const auto s = in_stride;
+
+        for (std::size_t p = 0; p < in_half; p++)
+        {
+            const auto wr = _mm_set1_ps(in_twiddleReal[p * s]);
+            const auto wi = _mm_set1_ps(in_twiddleImaginary[p * s]);
+
+            for (std::size_t q = 0; q < s; q += 4)
+            {
+                const auto ar = _mm_loadu_ps(in_real + q + s * p);
+                const auto ai = _mm_loadu_ps(in_imaginary + q + s * p);
+                const auto br = _mm_loadu_ps(in_real + q + s * (p + in_half));
+                const auto bi = _mm_loadu_ps(in_imaginary + q + s * (p + in_half));
+                const auto dr = _mm_sub_ps(ar, br);
+                const auto di = _mm_sub_ps(ai, bi);
+
+                _mm_storeu_ps(out_real + q + s * 2 * p, _mm_add_ps(ar, br));
+                _mm_storeu_ps(out_imaginary + q + s * 2 * p, _mm_add_ps(ai, bi));
+                _mm_storeu_ps(out_real + q + s * (2 * p + 1), _mm_sub_ps(_mm_mul_ps(dr, wr), _mm_mul_ps(di, wi)));
+                _mm_storeu_ps(out_imaginary + q + s * (2 * p + 1), _mm_add_ps(_mm_mul_ps(dr, wi), _mm_mul_ps(di, wr)));
+            }
+        }
+    }
+
+    __attribute__((target("sse2")))
+    static void multiplySse2(const float* in_aReal, const float* in_aImaginary, const float* in_bReal, const float* in_bImaginary, float* io_real, float* io_imaginary, const std::size_t in_bins) noexcept
+    {
+        const auto vectors = in_bins - in_bins % 4;
+
+        for (std::size_t bin = 0; bin < vectors; bin += 4)
+        {
+            const auto ar = _mm_loadu_ps(in_aReal + bin);
+            const auto ai = _mm_loadu_ps(in_aImaginary + bin);
+            const auto br = _mm_loadu_ps(in_bReal + bin);
+            const auto bi = _mm_loadu_ps(in_bImaginary + bin);
+            const auto real = _mm_sub_ps(_mm_mul_ps(ar, br), _mm_mul_ps(ai, bi));
+            const auto imaginary = _mm_add_ps(_mm_mul_ps(ar, bi), _mm_mul_ps(ai, br));
+
+            _mm_storeu_ps(io_real + bin, _mm_add_ps(_mm_loadu_ps(io_real + bin), real));
+            _mm_storeu_ps(io_imaginary + bin, _mm_add_ps(_mm_loadu_ps(io_imaginary + bin), imaginary));
+        }
+
+        multiplyScalar(in_aReal + vectors, in_aImaginary + vectors, in_bReal + vectors, in_bImaginary + vectors, io_real + vectors, io_imaginary + vectors, in_bins - vectors);
+    }
+
+    // The stride must be a multiple of 8.
+    __attribute__((target("avx2")))
+    static void stageAvx2(const float* in_real, const float* in_imaginary, float* out_real, float* out_imaginary, const float* in_twiddleReal, const float* in_twiddleImaginary, const std::size_t in_half, const std::size_t in_stride) noexcept
+    {
+        const auto s = in_stride;
+
+        for (std::size_t p = 0; p < in_half; p++)
+        {
+            const auto wr = _mm256_set1_ps(in_twiddleReal[p * s]);
+            const auto wi = _mm256_set1_ps(in_twiddleImaginary[p * s]);
+
+            for (std::size_t q = 0; q < s; q += 8)
+            {
+                const auto ar = _mm256_loadu_ps(in_real + q + s * p);
+                const auto ai = _mm256_loadu_ps(in_imaginary + q + s * p);
+                const auto br = _mm256_loadu_ps(in_real + q + s * (p + in_half));
+                const auto bi = _mm256_loadu_ps(in_imaginary + q + s * (p + in_half));
+                const auto dr = _mm256_sub_ps(ar, br);
+                const auto di = _mm256_sub_ps(ai, bi);
+
+                _mm256_storeu_ps(out_real + q + s * 2 * p, _mm256_add_ps(ar, br));
+                _mm256_storeu_ps(out_imaginary + q + s * 2 * p, _mm256_add_ps(ai, bi));
+                _mm256_storeu_ps(out_real + q + s * (2 * p + 1), _mm256_sub_ps(_mm256_mul_ps(dr, wr), _mm256_mul_ps(di, wi)));
+                _mm256_storeu_ps(out_imaginary + q + s * (2 * p + 1), _mm256_add_ps(_mm256_mul_ps(dr, wi), _mm256_mul_ps(di, wr)));
+            }
+        }
+    }
+
+    __attribute__((target("avx2")))
+    static void multiplyAvx2(const float* in_aReal, const float* in_aImaginary, const float* in_bReal, const float* in_bImaginary, float* io_real, float* io_imaginary, const std::size_t in_bins) noexcept
+    {
+        const auto vectors = in_bins - in_bins % 8;
+
+        for (std::size_t bin = 0; bin < vectors; bin += 8)
+        {
+            const auto ar = _mm256_loadu_ps(in_aReal + bin);
+            const auto ai = _mm256_loadu_ps(in_aImaginary + bin);
+            const auto br = _mm256_loadu_ps(in_bReal + bin);
+            const auto bi = _mm256_loadu_ps(in_bImaginary + bin);
+            const auto real = _mm256_sub_ps(_mm256_mul_ps(ar, br), _mm256_mul_ps(ai, bi));
+            const auto imaginary = _mm256_add_ps(_mm256_mul_ps(ar, bi), _mm256_mul_ps(ai, br));
+
+            _mm256_storeu_ps(io_real + bin, _mm256_add_ps(_mm256_loadu_ps(io_real + bin), real));
+            _mm256_storeu_ps(io_imaginary + bin, _mm256_add_ps(_mm256_loadu_ps(io_imaginary + bin), imaginary));
+        }
+
+        multiplyScalar(in_aReal + vectors, in_aImaginary + vectors, in_bReal + vectors, in_bImaginary + vectors, io_real + vectors, io_imaginary + vectors, in_bins - vectors);
+    }
+#endif
+
+    /**
+     * @param in_size The number of real samples which must be a power of two of at least 4.
+     * @param in_level The highest level of vector instructions to use. It is limited to what the
+     * CPU supports.
+     * @throws ValueError if the size is not valid.
+     *
+     * The twiddles are computed in double precision so the error does not grow with the size.
+     * AVX-512 uses the AVX2 kernels because the stages that are wide enough for them are already
+     * limited by memory for the sizes convolution uses.
+     */
+    RealFft::RealFft(const std::size_t in_size, const SimdLevel in_level) :
+        m_size(in_size)
+    {
+        if (m_size < 4 || ! std::has_single_bit(m_size)) throw ValueError(makeString("FFT size must be a power of two of at least 4: ", m_size));
+
+        [[maybe_unused]] const auto level = std::min(in_level, simdLevel());
+
+        m_stage = stageScalar;
+        m_multiply = multiplyScalar;
+
+#ifdef CLYPSALOT_X86_KERNELS
+        if (level >= SimdLevel::avx2)
+        {
+            m_stage = stageAvx2;
+            m_multiply = multiplyAvx2;
+            m_level = SimdLevel::avx2;
+            m_lanes = 8;
+        }
+        else if (level >= SimdLevel::sse2)
+        {
+            m_stage = stageSse2;
+            m_multiply = multiplySse2;
+            m_level = SimdLevel::sse2;
+            m_lanes = 4;
+        }
+#endif
+
+        const auto half = m_size / 2;
+
+        m_twiddleReal.resize(half / 2);
+        m_twiddleImaginary.resize(half / 2);
+
+        for (std::size_t k = 0; k < half / 2; k++)
+        {
+            const auto angle = -2 * std::numbers::pi * k / half;
+
+            m_twiddleReal[k] = std::cos(angle);
+            m_twiddleImaginary[k] = std::sin(angle);
+        }
+
+        m_splitReal.resize(half + 1);
+        m_splitImaginary.resize(half + 1);
+
+        for (std::size_t k = 0; k <= half; k++)
+        {
+            const auto angle = -2 * std::numbers::pi * k / m_size;
+
+            m_splitReal[k] = std::cos(angle);
+            m_splitImaginary[k] = std::sin(angle);
+        }
+
+        m_packedReal.resize(half);
+        m_packedImaginary.resize(half);
+        m_scratchReal.resize(half);
+        m_scratchImaginary.resize(half);
+    }
+
+    /// @brief The number of real samples.
+    std::size_t RealFft::size() const noexcept
+    {
+        return m_size;
+    }
+
+    /// @brief The number of bins in a spectrum which is half the size plus one.
+    std::size_t RealFft::bins() const noexcept
+    {
+        return m_size / 2 + 1;
+    }
+
+    SimdLevel RealFft::level() const noexcept
+    {
+        return m_level;
+    }
+
+    // The complex FFT of half the size in place.
+    void RealFft::transform(float* io_real, float* io_imaginary) noexcept
+    {
+        float* real = io_real;
+        float* imaginary = io_imaginary;
+        float* otherReal = m_scratchReal.data();
+        float* otherImaginary = m_scratchImaginary.data();
+        std::size_t stride = 1;
+
+        for (auto half = m_size / 4; half > 0; half /= 2)
+        {
+            const auto stage = stride >= m_lanes ? m_stage : stageScalar;
+
+            stage(real, imaginary, otherReal, otherImaginary, m_twiddleReal.data(), m_twiddleImaginary.data(), half, stride);
+            std::swap(real, otherReal);
+            std::swap(imaginary, otherImaginary);
+            stride *= 2;
+        }
+
+        if (real != io_real)
+        {
+            std::copy_n(real, m_size / 2, io_real);
+            std::copy_n(imaginary, m_size / 2, io_imaginary);
+        }
+    }
+
+    /**
+     * @brief Transform size() samples into a spectrum of bins() bins.
+     *
+     * The even samples are the real parts and the odd samples the imaginary parts of the
+     * sequence that goes through the complex FFT. Each bin of the two interleaved spectra is
+     * then pulled apart using the symmetry of the spectrum of real samples.
+     */
+    void RealFft::forward(const float* in_samples, float* out_real, float* out_imaginary) noexcept
+    {
+        const auto half = m_size / 2;
+        const auto zr = m_packedReal.data();
+        const auto zi = m_packedImaginary.data();
+
+        for (std::size_t n = 0; n < half; n++)
+        {
+            zr[n] = in_samples[2 * n];
+            zi[n] = in_samples[2 * n + 1];
+        }
+
+        transform(zr, zi);
+
+        for (std::size_t k = 0; k <= half; k++)
+        {
+            const auto index = k % half;
+            const auto mirror = (half - k) % half;
+            const auto evenReal = 0.5f * (zr[index] + zr[mirror]);
+            const auto evenImaginary = 0.5f * (zi[index] - zi[mirror]);
+            const auto oddReal = 0.5f * (zi[index] + zi[mirror]);
+            const auto oddImaginary = -0.5f * (zr[index] - zr[mirror]);
+            const auto wr = m_splitReal[k];
+            const auto wi = m_splitImaginary[k];
+
+            out_real[k] = evenReal + (oddReal * wr - oddImaginary * wi);
+            out_imaginary[k] = evenImaginary + (oddReal * wi + oddImaginary * wr);
+        }
+    }
+
+    /**
+     * @brief Transform a spectrum of bins() bins in to size() samples multiplied by size().
+     *
+     * The imaginary parts of the first and last bins are ignored because they are zero for any
+     * real signal. The inverse complex FFT is the forward one with the real and imaginary parts
+     * swapped on the way in and out.
+     */
+    void RealFft::inverse(const float* in_real, const float* in_imaginary, float* out_samples) noexcept
+    {
+        const auto half = m_size / 2;
+        const auto zr = m_packedReal.data();
+        const auto zi = m_packedImaginary.data();
+
+        for (std::size_t k = 0; k < half; k++)
+        {
+            const auto mirror = half - k;
+            const auto evenReal = in_real[k] + in_real[mirror];
+            const auto evenImaginary = in_imaginary[k] - in_imaginary[mirror];
+            const auto differenceReal = in_real[k] - in_real[mirror];
+            const auto differenceImaginary = in_imaginary[k] + in_imaginary[mirror];
+            const auto wr = m_splitReal[k];
+            const auto wi = -m_splitImaginary[k];
+            const auto oddReal = differenceReal * wr - differenceImaginary * wi;
+            const auto oddImaginary = differenceReal * wi + differenceImaginary * wr;
+
+            // Stored swapped for the inverse transform.
+            zi[k] = evenReal - oddImaginary;
+            zr[k] = evenImaginary + oddReal;
+        }
+
+        // The DC and Nyquist bins are real.
+        zi[0] = in_real[0] + in_real[half];
+        zr[0] = in_real[0] - in_real[half];
+
+        transform(zr, zi);
+
+        for (std::size_t n = 0; n < half; n++)
+        {
+            out_samples[2 * n] = zi[n];
+            out_samples[2 * n + 1] = zr[n];
+        }
+    }
+
+    /// @brief Multiply two spectra bin by bin and add the products to a third.
+    void RealFft::multiplyAdd(const float* in_aReal, const float* in_aImaginary, const float* in_bReal, const float* in_bImaginary, float* io_real, float* io_imaginary) const noexcept
+    {
+        m_multiply(in_aReal, in_aImaginary, in_bReal, in_bImaginary, io_real, io_imaginary, bins());
+    }
+}
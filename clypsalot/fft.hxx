@@ -0,0 +1,73 @@
+/* Copyright 2023 Tyler Riddle
+ *
+ * This file is part of Clypsalot. Clypsalot is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU Lesser General Public License as published by the Free Software Foundation, either version 3 of the License,
+ * or (at your option) any later version. Clypsalot is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along with Clypsalot. If not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include <clypsalot/simd.hxx>
+
+/// @file
+namespace Clypsalot
+{
+    /**
+     * @brief A fast Fourier transform of real samples with a power of two size.
+     *
+     * The samples are packed in to a complex sequence of half the size which is transformed by a
+     * radix 2 Stockham FFT and then split in to the spectrum of the real samples. Spectra are
+     * kept as separate arrays of real and imaginary parts holding the bins() bins from DC to
+     * Nyquist. Keeping the parts apart lets every butterfly of a stage with a stride of at least
+     * the width of a vector run across whole vectors with out any shuffling. The stages with a
+     * smaller stride and the split are scalar. Every level gives the same result for the same
+     * input.
+     *
+     * The inverse is not scaled so a round trip multiplies the samples by size(). The work
+     * arrays are allocated by the constructor so transforming never allocates but an instance
+     * can only be used by one thread at a time.
+     */
+    class RealFft
+    {
+        public:
+        using StageKernel = void (*)(const float* in_real, const float* in_imaginary, float* out_real, float* out_imaginary, const float* in_twiddleReal, const float* in_twiddleImaginary, const std::size_t in_half, const std::size_t in_stride) noexcept;
+        using MultiplyKernel = void (*)(const float* in_aReal, const float* in_aImaginary, const float* in_bReal, const float* in_bImaginary, float* io_real, float* io_imaginary, const std::size_t in_bins) noexcept;
+
+        private:
+        const std::size_t m_size;
+        SimdLevel m_level = SimdLevel::scalar;
+        std::size_t m_lanes = 1;
+        StageKernel m_stage = nullptr;
+        MultiplyKernel m_multiply = nullptr;
+        std::vector<float> m_twiddleReal;
+        std::vector<float> m_twiddleImaginary;
+        std::vector<float> m_splitReal;
+        std::vector<float> m_splitImaginary;
+        std::vector<float> m_packedReal;
+        std::vector<float> m_packedImaginary;
+        std::vector<float> m_scratchReal;
+        std::vector<float> m_scratchImaginary;
+
+        void transform(float* io_real, float* io_imaginary) noexcept;
+
+        public:
+        RealFft(const std::size_t in_size, const SimdLevel in_level = simdLevel());
+        RealFft(const RealFft&) = delete;
+        void operator=(const RealFft&) = delete;
+        std::size_t size() const noexcept;
+        std::size_t bins() const noexcept;
+        SimdLevel level() const noexcept;
+        void forward(const float* in_samples, float* out_real, float* out_imaginary) noexcept;
+        void inverse(const float* in_real, const float* in_imaginary, float* out_samples) noexcept;
+        void multiplyAdd(const float* in_aReal, const float* in_aImaginary, const float* in_bReal, const float* in_bImaginary, float* io_real, float* io_imaginary) const noexcept;
+    };
+}
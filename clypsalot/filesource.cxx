@@ -0,0 +1,274 @@
+/* Copyright 2023 Tyler Riddle
+ *
+ * This file is part of Clypsalot. Clypsalot is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU Lesser General Public License as published by the Free Software Foundation, either version 3 of the License,
+ * or (at your option) any later version. Clypsalot is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along with Clypsalot. If not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <limits>
+
+#include <clypsalot/error.hxx>
+#include <clypsalot/filesource.hxx>
+#include <clypsalot/logger.hxx>
+#include <clypsalot/property.hxx>
+#include <clypsalot/util.hxx>
+
+/// @file
+namespace Clypsalot
+{
+    const std::string FileSourceObject::kindName = "File Source";
+    static const std::string filePropertyName = "File";
+    static const std::string blockSizePropertyName = "Block Size";
+    static const std::string readaheadPropertyName = "Readahead";
+    static const std::string formatPropertyName = "Format";
+    static const std::string channelsPropertyName = "Channels";
+    static const std::string sampleRatePropertyName = "Sample Rate";
+    static const std::string dataOffsetPropertyName = "Data Offset";
+    static const PropertyList fileSourceProperties = {
+        { filePropertyName, PropertyType::file, Property::Configurable | Property::Required, nullptr },
+        { blockSizePropertyName, PropertyType::size, Property::Configurable, 256 },
+        // The number of blocks kept resident ahead of the playback position.
+        { readaheadPropertyName, PropertyType::size, Property::Configurable, 32 },
+        // The settings of a raw file which has no header to read them from.
+        { formatPropertyName, PropertyType::string, Property::Configurable, "float32" },
+        { channelsPropertyName, PropertyType::size, Property::Configurable, nullptr },
+        { sampleRatePropertyName, PropertyType::size, Property::Configurable, 0 },
+        { dataOffsetPropertyName, PropertyType::size, Property::Configurable, 0 },
+    };
+
+    std::shared_ptr<FileSourceObject> FileSourceObject::make()
+    {
+        return _makeObject<FileSourceObject>(kindName);
+    }
+
+    FileSourceObject::FileSourceObject(const std::string& in_kind) :
+        Object(in_kind)
+    {
+        std::scoped_lock lock(*this);
+
+        addProperties(fileSourceProperties);
+
+        m_blockSize = &propertySizeRef(blockSizePropertyName);
+        m_readahead = &propertySizeRef(readaheadPropertyName);
+        m_output = static_cast<PcmOutputPort*>(&addOutput<PcmOutputPort>("output"));
+    }
+
+    FileSourceObject::~FileSourceObject() noexcept
+    {
+        stopReader();
+    }
+
+    void FileSourceObject::stopReader() noexcept
+    {
+        if (! m_reader.joinable()) return;
+
+        m_reader.request_stop();
+        m_wanted = std::numeric_limits<std::size_t>::max();
+        m_wanted.notify_all();
+        m_reader.join();
+    }
+
+    /*
+     * Fault in the pages between the resident and wanted offsets whenever they differ. The Object
+     * reports that it is not ready while it waits for the pages of its next block and it can not
+     * be scheduled by a neighbour after that so it is scheduled from here.
+     */
+    void FileSourceObject::readAhead(std::stop_token in_token)
+    {
+        while (! in_token.stop_requested())
+        {
+            const auto wanted = m_wanted.load();
+            const auto resident = m_resident.load();
+
+            if (resident >= wanted)
+            {
+                m_wanted.wait(wanted);
+                continue;
+            }
+
+            m_mapping->prefetch(resident, wanted - resident);
+            m_resident = wanted;
+
+            if (m_starved.exchange(false))
+            {
+                std::scoped_lock lock(*this);
+
+                wakeObject(*this);
+            }
+        }
+    }
+
+    /*
+     * Move the readahead window so it ends a window past the given frame. The reader is woken once
+     * half of the window has been used so it faults in pages in batches or right away if the next
+     * block is not resident.
+     */
+    void FileSourceObject::want(const std::size_t in_frame) noexcept
+    {
+        const auto window = std::max<std::size_t>(*m_readahead, 1) * *m_blockSize;
+        const auto target = dataEnd(std::min(in_frame + window, m_info.frames));
+        const auto next = dataEnd(std::min(in_frame + *m_blockSize, m_info.frames));
+        const auto resident = m_resident.load();
+
+        m_wanted = target;
+
+        if (resident < next || (target - std::min(target, resident)) * 2 >= window * m_info.frameSize())
+        {
+            m_wanted.notify_one();
+        }
+    }
+
+    std::size_t FileSourceObject::dataEnd(const std::size_t in_frames) const noexcept
+    {
+        return m_info.dataOffset + in_frames * m_info.frameSize();
+    }
+
+    /**
+     * @throws ValueError if the File property is not set, the file is not a supported WAV file or
+     * the settings of a raw file are missing.
+     * @throws RuntimeError if the file can not be mapped.
+     */
+    void FileSourceObject::handleConfigure(const ObjectConfig& in_config)
+    {
+        assert(haveLock());
+
+        Object::handleConfigure(in_config);
+        stopReader();
+
+        const auto& file = property(filePropertyName);
+
+        if (! file.defined()) throw ValueError(makeString("Property is required: ", filePropertyName));
+        if (*m_blockSize == 0) throw ValueError(makeString(blockSizePropertyName, " must not be 0"));
+
+        auto mapping = std::make_shared<const FileMapping>(file.fileValue());
+
+        if (isWavFile(mapping->data(), mapping->bytes()))
+        {
+            m_info = readWavInfo(mapping->data(), mapping->bytes());
+        }
+        else
+        {
+            const auto& channels = property(channelsPropertyName);
+
+            if (! channels.defined() || channels.sizeValue() == 0)
+            {
+                throw ValueError(makeString("Property is required for a raw file: ", channelsPropertyName));
+            }
+
+            m_info = {};
+            m_info.format = stringToPcmFormat(property(formatPropertyName).stringValue());
+            m_info.sampleSize = m_info.format == PcmFormat::int24 ? 3 : pcmSampleSize(m_info.format);
+            m_info.channels = channels.sizeValue();
+            m_info.rate = property(sampleRatePropertyName).sizeValue();
+            m_info.dataOffset = std::min(property(dataOffsetPropertyName).sizeValue(), mapping->bytes());
+            m_info.frames = (mapping->bytes() - m_info.dataOffset) / m_info.frameSize();
+        }
+
+        const auto sampleSize = pcmSampleSize(m_info.format);
+        auto layout = pcmFileLayout(m_info.channels);
+
+        m_zeroCopy = m_info.sampleSize == sampleSize
+            && m_info.dataOffset % pcmAlignment == 0
+            && *m_blockSize % (pcmAlignment / sampleSize) == 0
+            && (m_info.channels == 1 || layout != PcmLayout::planar);
+
+        // A grouped layout only pays off when the blocks are not copied.
+        if (! m_zeroCopy) layout = PcmLayout::planar;
+
+        auto config = m_output->config();
+
+        config.format = m_info.format;
+        config.channels = m_info.channels;
+        config.blockSize = *m_blockSize;
+        config.rate = m_info.rate;
+        config.layout = layout;
+        m_output->config(config);
+
+        OBJECT_LOGGER(debug, "Opened ", m_info.container, " file; format=", m_info.format, " channels=", m_info.channels,
+            " frames=", m_info.frames, " zeroCopy=", m_zeroCopy);
+
+        // The first window is faulted in here so starting does not have to wait on the reader.
+        const auto end = dataEnd(std::min(std::max<std::size_t>(*m_readahead, 1) * *m_blockSize, m_info.frames));
+
+        mapping->prefetch(m_info.dataOffset, end - m_info.dataOffset);
+        m_mapping = std::move(mapping);
+        m_position = 0;
+        m_starved = false;
+        m_resident = end;
+        m_wanted = end;
+        m_reader = std::jthread([this] (std::stop_token token) { readAhead(token); });
+    }
+
+    ObjectProcessResult FileSourceObject::process()
+    {
+        assert(haveLock());
+
+        if (m_position >= m_info.frames) return ObjectProcessResult::endOfData;
+
+        const auto frames = std::min(*m_blockSize, m_info.frames - m_position);
+        const auto data = m_mapping->data() + dataEnd(m_position);
+
+        assert(m_resident >= dataEnd(m_position + frames));
+
+        // The last block is copied when it is short because the mapping ends with the file.
+        if (m_zeroCopy && frames == *m_blockSize)
+        {
+            m_output->commit(data, m_mapping, frames);
+        }
+        else
+        {
+            readPcmFrames(m_output->buffer(), data, m_info, frames);
+            m_output->commit(frames);
+        }
+
+        m_position += frames;
+        want(m_position);
+
+        return ObjectProcessResult::finished;
+    }
+
+    const PcmFileInfo& FileSourceObject::info() const noexcept
+    {
+        assert(haveLock());
+
+        return m_info;
+    }
+
+    /// @brief True if the blocks point into the mapping of the file instead of being copied.
+    bool FileSourceObject::zeroCopy() const noexcept
+    {
+        assert(haveLock());
+
+        return m_zeroCopy;
+    }
+
+    /// @brief The number of frames that have been delivered.
+    std::size_t FileSourceObject::position() const noexcept
+    {
+        assert(haveLock());
+
+        return m_position;
+    }
+
+    bool FileSourceObject::ready() const noexcept
+    {
+        if (! Object::ready()) return false;
+        if (m_position >= m_info.frames) return true;
+
+        const auto needed = dataEnd(std::min(m_position + *m_blockSize, m_info.frames));
+
+        if (m_resident >= needed) return true;
+
+        // The flag is raised before checking again so the reader can not miss it.
+        m_starved = true;
+        return m_resident >= needed;
+    }
+}
@@ -0,0 +1,73 @@
+/* Copyright 2023 Tyler Riddle
+ *
+ * This file is part of Clypsalot. Clypsalot is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU Lesser General Public License as published by the Free Software Foundation, either version 3 of the License,
+ * or (at your option) any later version. Clypsalot is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along with Clypsalot. If not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <stop_token>
+#include <thread>
+
+#include <clypsalot/memory.hxx>
+#include <clypsalot/object.hxx>
+#include <clypsalot/pcm.hxx>
+#include <clypsalot/wav.hxx>
+
+/// @file
+namespace Clypsalot
+{
+    /**
+     * @brief Play the samples of a WAV, RF64 or raw PCM file.
+     *
+     * The file is memory mapped and a reader thread faults in the pages ahead of the playback
+     * position so processing never waits on the disk. The Object is not ready until the pages of
+     * the next block are resident and the reader schedules it once they are.
+     *
+     * Files with 1, 4 or 8 interleaved channels are already laid out like a planar, grouped4 or
+     * grouped8 block. When the sample format also matches and the samples are aligned the blocks
+     * point straight into the mapping instead of being copied.
+     */
+    class FileSourceObject : public Object
+    {
+        std::size_t* m_blockSize = nullptr;
+        std::size_t* m_readahead = nullptr;
+        PcmOutputPort* m_output = nullptr;
+        std::shared_ptr<const FileMapping> m_mapping;
+        PcmFileInfo m_info;
+        bool m_zeroCopy = false;
+        std::size_t m_position = 0;
+        std::atomic_size_t m_wanted = 0;
+        std::atomic_size_t m_resident = 0;
+        mutable std::atomic_bool m_starved = false;
+        std::jthread m_reader;
+
+        void stopReader() noexcept;
+        void readAhead(std::stop_token in_token);
+        void want(const std::size_t in_frames) noexcept;
+        std::size_t dataEnd(const std::size_t in_frames) const noexcept;
+
+        protected:
+        virtual void handleConfigure(const ObjectConfig& in_config) override;
+        virtual ObjectProcessResult process() override;
+
+        public:
+        static const std::string kindName;
+
+        static std::shared_ptr<FileSourceObject> make();
+        FileSourceObject(const std::string& in_kind);
+        virtual ~FileSourceObject() noexcept;
+        const PcmFileInfo& info() const noexcept;
+        bool zeroCopy() const noexcept;
+        std::size_t position() const noexcept;
+        virtual bool ready() const noexcept override;
+    };
+}
@@ -28,9 +28,29 @@
 
 namespace Clypsalot
 {
+    class Automation;
+    class ByteRing;
+    class CaptureReader;
+    struct CaptureRecord;
+    struct AutomationEvent;
+    class AutomationLane;
+    class BiquadCascade;
+    struct ControlEvent;
+    class CompressorObject;
+    class ControlInputPort;
+    class ControlOutputPort;
+    class ControlPortLink;
+    class ConvolverObject;
+    class EqualizerObject;
     class Event;
     class EventSender;
+    class FileMapping;
+    class FileSourceObject;
+    class GateObject;
     class InputPort;
+    class IoService;
+    class LinkCapture;
+    struct IoRequest;
     class Lockable;
     class LogEngine;
     enum class LogSeverity : uint_fast8_t;
@@ -42,13 +62,42 @@ namespace Clypsalot
     enum class ObjectState : uint_fast8_t;
     struct ObjectStateChangedEvent;
     class OutputPort;
+    struct PcmBlock;
+    class PcmBuffer;
+    class PcmBufferPool;
+    class PcmCompressor;
+    class PcmConverter;
+    class PcmConvolver;
+    class PcmGate;
+    struct PcmFileInfo;
+    class PcmInputPort;
+    class PcmMatrix;
+    class PcmMixer;
+    class PcmOutputPort;
+    class PcmPortLink;
+    class PcmResampler;
+    class PcmTransposer;
+    class PipeObject;
+    class PipeSinkObject;
+    class PipeSourceObject;
     class Port;
     class PortLink;
     class PortType;
+    class Preset;
+    struct PresetBlock;
     struct PortTypeDescriptor;
     class Property;
+    class RealFft;
+    class RecorderObject;
+    class ReplayObject;
+    class ShmDevice;
+    class ShmObject;
+    class ShmRing;
+    class ShmSinkObject;
+    class ShmSourceObject;
     struct PropertyConfig;
     class SharedLockable;
+    class SharedPcmBuffer;
     class Subscription;
 
     // TODO Figure out if this should go into something like types.h or if it is appropriate here
@@ -0,0 +1,160 @@
+/* Copyright 2023 Tyler Riddle
+ *
+ * This file is part of Clypsalot. Clypsalot is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU Lesser General Public License as published by the Free Software Foundation, either version 3 of the License,
+ * or (at your option) any later version. Clypsalot is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along with Clypsalot. If not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+
+
+#include <cassert>
+#include <limits>
+
+#include <clypsalot/error.hxx>
+#include <clypsalot/gate.hxx>
+#include <clypsalot/logger.hxx>
+#include <clypsalot/pcm.hxx>
+#include <clypsalot/property.hxx>
+#include <clypsalot/util.hxx>
+
+/// @file
+namespace Clypsalot
+{
+    const std::string GateObject::kindName = "Noise Gate";
+    static const std::string channelsPropertyName = "Channels";
+    static const std::string sampleRatePropertyName = "Sample Rate";
+    static const std::string blockSizePropertyName = "Block Size";
+    static const std::string thresholdPropertyName = "Threshold";
+    static const std::string hysteresisPropertyName = "Hysteresis";
+    static const std::string attackPropertyName = "Attack";
+    static const std::string holdPropertyName = "Hold";
+    static const std::string releasePropertyName = "Release";
+    static const std::string rangePropertyName = "Range";
+    static constexpr auto controlFlags = Property::Configurable | Property::PublicMutable;
+    static const PropertyList gateProperties = {
+        { channelsPropertyName, PropertyType::size, Property::Configurable | Property::Required, nullptr },
+        { sampleRatePropertyName, PropertyType::size, Property::Configurable, 48000 },
+        { blockSizePropertyName, PropertyType::size, Property::Configurable, 256 },
+        // Levels are in dB and times are in milliseconds.
+        { thresholdPropertyName, PropertyType::real, controlFlags, -40.0 },
+        { hysteresisPropertyName, PropertyType::real, controlFlags, 6.0 },
+        { attackPropertyName, PropertyType::real, controlFlags, 1.0 },
+        { holdPropertyName, PropertyType::real, controlFlags, 50.0 },
+        { releasePropertyName, PropertyType::real, controlFlags, 100.0 },
+        { rangePropertyName, PropertyType::real, controlFlags, -std::numeric_limits<double>::infinity() },
+    };
+
+    std::shared_ptr<GateObject> GateObject::make()
+    {
+        return _makeObject<GateObject>(kindName);
+    }
+
+    GateObject::GateObject(const std::string& in_kind) :
+        Object(in_kind)
+    {
+        std::scoped_lock lock(*this);
+
+        addProperties(gateProperties);
+
+        m_input = static_cast<PcmInputPort*>(&addInput<PcmInputPort>("input"));
+        m_output = static_cast<PcmOutputPort*>(&addOutput<PcmOutputPort>("output"));
+        m_output->inPlace(m_input);
+        m_controlProperties.threshold = &property(propertyHandle(thresholdPropertyName));
+        m_controlProperties.hysteresis = &property(propertyHandle(hysteresisPropertyName));
+        m_controlProperties.attack = &property(propertyHandle(attackPropertyName));
+        m_controlProperties.hold = &property(propertyHandle(holdPropertyName));
+        m_controlProperties.release = &property(propertyHandle(releasePropertyName));
+        m_controlProperties.range = &property(propertyHandle(rangePropertyName));
+    }
+
+    /// @throws RuntimeError if the Object was not configured.
+    const PcmGate& GateObject::gate() const
+    {
+        assert(haveLock());
+
+        if (! m_gate) throw RuntimeError("The gate has not been configured");
+
+        return *m_gate;
+    }
+
+    GateSettings GateObject::readSettings() const
+    {
+        GateSettings settings;
+
+        settings.threshold = m_controlProperties.threshold->realValue();
+        settings.hysteresis = m_controlProperties.hysteresis->realValue();
+        settings.attack = m_controlProperties.attack->realValue();
+        settings.hold = m_controlProperties.hold->realValue();
+        settings.release = m_controlProperties.release->realValue();
+        settings.range = m_controlProperties.range->realValue();
+
+        return settings;
+    }
+
+    /// @throws ValueError if there are no channels or a control is not valid.
+    void GateObject::handleConfigure(const ObjectConfig& in_config)
+    {
+        assert(haveLock());
+
+        Object::handleConfigure(in_config);
+
+        const auto& channels = property(channelsPropertyName);
+
+        if (! channels.defined()) throw ValueError(makeString("Property is required: ", channelsPropertyName));
+
+        const auto rate = property(sampleRatePropertyName).sizeValue();
+        const auto blockSize = property(blockSizePropertyName).sizeValue();
+
+        if (rate == 0) throw ValueError(makeString(sampleRatePropertyName, " must be greater than zero"));
+        if (blockSize == 0) throw ValueError(makeString(blockSizePropertyName, " must be greater than zero"));
+
+        auto gate = std::make_unique<PcmGate>(channels.sizeValue(), rate);
+        const PcmConfig config = { PcmFormat::float32, gate->channels(), blockSize, 0, rate, gate->layout() };
+
+        gate->settings(readSettings());
+        gate->reset();
+
+        m_input->config(config);
+        m_output->config(config);
+        m_rejected.reset();
+        m_gate = std::move(gate);
+
+        OBJECT_LOGGER(debug, "Configured ", config.channels, " channels with ", m_gate->level(), " kernels");
+    }
+
+    /// @throws RuntimeError if the input has more frames than the block size.
+    ObjectProcessResult GateObject::process()
+    {
+        assert(haveLock());
+
+        const auto frames = m_input->frames();
+        const auto silent = m_input->silent();
+
+        if (frames > m_output->config().blockSize) throw RuntimeError(makeString("Input block is larger than ", blockSizePropertyName));
+
+        const auto settings = readSettings();
+
+        // Controls that were rejected once are not checked or logged again until they change.
+        if (settings != m_gate->settings() && settings != m_rejected)
+        {
+            try
+            {
+                m_gate->settings(settings);
+            }
+            catch (const ValueError& e)
+            {
+                m_rejected = settings;
+                OBJECT_LOGGER(warn, "Keeping the current settings: ", e.what());
+            }
+        }
+
+        m_gate->process(m_output->buffer(), frames, silent);
+        m_output->commit(frames, m_gate->silent());
+
+        return ObjectProcessResult::finished;
+    }
+}
@@ -0,0 +1,66 @@
+/* Copyright 2023 Tyler Riddle
+ *
+ * This file is part of Clypsalot. Clypsalot is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU Lesser General Public License as published by the Free Software Foundation, either version 3 of the License,
+ * or (at your option) any later version. Clypsalot is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along with Clypsalot. If not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#include <memory>
+#include <optional>
+#include <string>
+
+#include <clypsalot/dynamics.hxx>
+#include <clypsalot/object.hxx>
+
+/// @file
+namespace Clypsalot
+{
+    /**
+     * @brief A noise gate.
+     *
+     * Every control can be changed while the Object runs and takes effect at the start of the
+     * next period. Controls that are not valid are logged and the current settings are kept until
+     * they are valid again. When the range closes the gate completely and it stayed closed for a whole
+     * period the output is committed as silent so the Objects downstream can skip their work.
+     * Silent input to a closed gate costs nothing.
+     */
+    class GateObject : public Object
+    {
+        struct ControlProperties
+        {
+            const Property* threshold = nullptr;
+            const Property* hysteresis = nullptr;
+            const Property* attack = nullptr;
+            const Property* hold = nullptr;
+            const Property* release = nullptr;
+            const Property* range = nullptr;
+        };
+
+        PcmInputPort* m_input = nullptr;
+        PcmOutputPort* m_output = nullptr;
+        std::unique_ptr<PcmGate> m_gate;
+        ControlProperties m_controlProperties;
+        std::optional<GateSettings> m_rejected;
+
+        GateSettings readSettings() const;
+
+        protected:
+        virtual void handleConfigure(const ObjectConfig& in_config) override;
+        virtual ObjectProcessResult process() override;
+
+        public:
+        static const std::string kindName;
+
+        static std::shared_ptr<GateObject> make();
+        GateObject(const std::string& in_kind);
+        const PcmGate& gate() const;
+    };
+}
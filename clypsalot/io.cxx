@@ -0,0 +1,816 @@
+/* Copyright 2023 Tyler Riddle
+ *
+ * This file is part of Clypsalot. Clypsalot is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU Lesser General Public License as published by the Free Software Foundation, either version 3 of the License,
+ * or (at your option) any later version. Clypsalot is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along with Clypsalot. If not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+
+
+#include <algorithm>
+#include <cassert>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <ctime>
+#include <vector>
+
+#include <linux/futex.h>
+#include <linux/io_uring.h>
+#include <poll.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <clypsalot/error.hxx>
+#include <clypsalot/io.hxx>
+#include <clypsalot/logger.hxx>
+#include <clypsalot/macros.hxx>
+#include <clypsalot/thread.hxx>
+#include <clypsalot/util.hxx>
+
+/// @file
+namespace Clypsalot
+{
+    static IoService* ioServiceSingleton = nullptr;
+    static Mutex ioServiceSingletonMutex;
+
+    // These are newer than the kernel headers that are commonly installed.
+    static constexpr unsigned uringOpFutexWait = 51;
+    static constexpr unsigned futex2SizeU32 = 0x02;
+
+    static bool isWait(const IoOperation in_operation) noexcept
+    {
+        switch (in_operation)
+        {
+            case IoOperation::read: return false;
+            case IoOperation::write: return false;
+            case IoOperation::readable: return true;
+            case IoOperation::writable: return true;
+            case IoOperation::futexWait: return true;
+            case IoOperation::sleep: return true;
+        }
+
+        FATAL_ERROR(makeString("Unhandled IoOperation value: ", static_cast<int>(in_operation)));
+    }
+
+    static std::ptrdiff_t performIo(const IoRequest& in_request) noexcept
+    {
+        ssize_t result;
+
+        const auto fd = in_request.fd;
+        const auto data = in_request.data;
+        const auto bytes = in_request.bytes;
+        const auto offset = in_request.offset;
+
+        do
+        {
+            if (offset == IoRequest::currentOffset)
+            {
+                if (in_request.operation == IoOperation::read) result = read(fd, data, bytes);
+                else result = write(fd, data, bytes);
+            }
+            else if (in_request.operation == IoOperation::read) result = pread(fd, data, bytes, offset);
+            else result = pwrite(fd, data, bytes, offset);
+        }
+        while (result < 0 && errno == EINTR);
+
+        return result < 0 ? -errno : result;
+    }
+
+    /**
+     * @brief Make the IoService for a backend.
+     *
+     * If io_uring can not be set up the thread backend is used instead so the backend of the
+     * returned IoService is not always the one that was asked for.
+     */
+    std::unique_ptr<IoService> IoService::make(const IoBackend in_backend, const std::size_t in_depth)
+    {
+        if (in_backend == IoBackend::uring)
+        {
+            try
+            {
+                return std::make_unique<UringIoService>(in_depth);
+            }
+            catch (const RuntimeError& e)
+            {
+                LOGGER(debug, e.what(), "; using threads for I/O");
+            }
+        }
+
+        return std::make_unique<ThreadIoService>(in_depth);
+    }
+
+    IoService::IoService(const std::size_t in_depth) noexcept :
+        m_depth(std::max(in_depth, static_cast<std::size_t>(1)))
+    { }
+
+    // The request is finished before the completion function runs so the function is free to
+    // submit it again.
+    void IoService::complete(IoRequest& io_request, const std::ptrdiff_t in_result) noexcept
+    {
+        io_request.result = in_result;
+        m_inFlight.fetch_sub(1);
+        m_inFlight.notify_all();
+
+        if (m_owner != nullptr) m_owner->complete(io_request, in_result);
+        else io_request.complete(io_request);
+    }
+
+    // Requests handed to another IoService keep counting as in flight here and complete here.
+    void IoService::delegate(IoService& io_service) noexcept
+    {
+        io_service.m_owner = this;
+    }
+
+    // Wait for every request that is in flight to complete.
+    void IoService::drain() const noexcept
+    {
+        for (auto inFlight = m_inFlight.load(); inFlight > 0; inFlight = m_inFlight.load())
+        {
+            m_inFlight.wait(inFlight);
+        }
+    }
+
+    std::size_t IoService::depth() const noexcept
+    {
+        return m_depth;
+    }
+
+    /// @brief The number of requests that were submitted and have not completed yet.
+    std::size_t IoService::inFlight() const noexcept
+    {
+        return m_inFlight.load();
+    }
+
+    /**
+     * @brief Start a read or write. Safe to call from any thread including from inside a
+     * completion function.
+     * @return false if depth() requests are already in flight or the request could not be
+     * started in which case the completion function is never called.
+     */
+    bool IoService::submit(IoRequest& io_request) noexcept
+    {
+        assert(io_request.complete != nullptr);
+
+        if (m_inFlight.fetch_add(1) >= m_depth)
+        {
+            m_inFlight.fetch_sub(1);
+            return false;
+        }
+
+        if (! _submit(io_request))
+        {
+            m_inFlight.fetch_sub(1);
+            m_inFlight.notify_all();
+            return false;
+        }
+
+        return true;
+    }
+
+    /**
+     * @brief Stop a request that is in flight as soon as possible.
+     * @return false if the request could not be canceled.
+     *
+     * The completion function is still called and the result is -ECANCELED unless the request
+     * finished first. Reads and writes that already started are usually not canceled but waiting
+     * for a descriptor to be ready always is so this is how an Object stops waiting on a pipe.
+     */
+    bool IoService::cancel(IoRequest& io_request) noexcept
+    {
+        return _cancel(io_request);
+    }
+
+    /**
+     * @param in_uringFutexWait False to wait on futexes with threads even if io_uring can.
+     * @throws RuntimeError if io_uring is not available.
+     */
+    UringIoService::UringIoService(const std::size_t in_depth, const bool in_uringFutexWait) :
+        IoService(in_depth)
+    {
+        io_uring_params params;
+
+        std::memset(&params, 0, sizeof(params));
+
+        // One more entry than the depth leaves room for the request that wakes the completion
+        // thread when shutting down.
+        m_fd = syscall(__NR_io_uring_setup, depth() + 1, &params);
+
+        if (m_fd < 0) throw RuntimeError(makeString("Could not set up io_uring: ", std::strerror(errno)));
+
+        m_ringBytes = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+        m_completionRingBytes = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+        m_entriesBytes = params.sq_entries * sizeof(io_uring_sqe);
+
+        if (params.features & IORING_FEAT_SINGLE_MMAP)
+        {
+            m_ringBytes = std::max(m_ringBytes, m_completionRingBytes);
+            m_completionRingBytes = 0;
+        }
+
+        m_ring = mmap(nullptr, m_ringBytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, m_fd, IORING_OFF_SQ_RING);
+        if (m_ring == MAP_FAILED) m_ring = nullptr;
+
+        m_completionRing = m_ring;
+
+        if (m_ring != nullptr && m_completionRingBytes > 0)
+        {
+            m_completionRing = mmap(nullptr, m_completionRingBytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, m_fd, IORING_OFF_CQ_RING);
+            if (m_completionRing == MAP_FAILED) m_completionRing = nullptr;
+        }
+
+        if (m_completionRing != nullptr)
+        {
+            const auto entries = mmap(nullptr, m_entriesBytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, m_fd, IORING_OFF_SQES);
+            if (entries != MAP_FAILED) m_entries = static_cast<io_uring_sqe*>(entries);
+        }
+
+        if (m_entries == nullptr)
+        {
+            const auto error = errno;
+
+            unmap();
+            throw RuntimeError(makeString("Could not map the io_uring rings: ", std::strerror(error)));
+        }
+
+        const auto ring = static_cast<std::byte*>(m_ring);
+        const auto completionRing = static_cast<std::byte*>(m_completionRing);
+
+        m_submitTail = reinterpret_cast<unsigned*>(ring + params.sq_off.tail);
+        m_submitMask = reinterpret_cast<unsigned*>(ring + params.sq_off.ring_mask);
+        m_submitArray = reinterpret_cast<unsigned*>(ring + params.sq_off.array);
+        m_completeHead = reinterpret_cast<unsigned*>(completionRing + params.cq_off.head);
+        m_completeTail = reinterpret_cast<unsigned*>(completionRing + params.cq_off.tail);
+        m_completeMask = reinterpret_cast<unsigned*>(completionRing + params.cq_off.ring_mask);
+        m_completions = reinterpret_cast<io_uring_cqe*>(completionRing + params.cq_off.cqes);
+
+        if (! in_uringFutexWait || ! supports(uringOpFutexWait))
+        {
+            LOGGER(debug, "io_uring can not wait on futexes; using threads for futex waits");
+            m_futexThreads = std::make_unique<ThreadIoService>(depth());
+            delegate(*m_futexThreads);
+        }
+
+        m_completer = std::thread([this] { reap(); });
+    }
+
+    UringIoService::~UringIoService() noexcept
+    {
+        drain();
+        m_stopping = true;
+
+        // A no-op with out a request wakes the completion thread so it sees the flag.
+        io_uring_sqe wake;
+
+        std::memset(&wake, 0, sizeof(wake));
+        wake.opcode = IORING_OP_NOP;
+
+        if (! enter(wake)) FATAL_ERROR("Could not wake the io_uring completion thread");
+
+        m_completer.join();
+        unmap();
+    }
+
+    void UringIoService::unmap() noexcept
+    {
+        if (m_entries != nullptr) munmap(m_entries, m_entriesBytes);
+        if (m_completionRing != nullptr && m_completionRing != m_ring) munmap(m_completionRing, m_completionRingBytes);
+        if (m_ring != nullptr) munmap(m_ring, m_ringBytes);
+        if (m_fd >= 0) close(m_fd);
+
+        m_entries = nullptr;
+        m_completionRing = nullptr;
+        m_ring = nullptr;
+        m_fd = -1;
+    }
+
+    /*
+     * Every entry is handed to the kernel as soon as it is put in the submission ring so the ring
+     * never holds more than the one entry and its head does not need to be checked. If the kernel
+     * does not take the entry it is taken back out of the ring.
+     */
+    bool UringIoService::enter(io_uring_sqe& in_entry) noexcept
+    {
+        std::scoped_lock lock(m_submitMutex);
+        std::atomic_ref tail(*m_submitTail);
+        const auto position = tail.load(std::memory_order_relaxed);
+        const auto index = position & *m_submitMask;
+
+        m_entries[index] = in_entry;
+        m_submitArray[index] = index;
+        tail.store(position + 1, std::memory_order_release);
+
+        while (true)
+        {
+            const auto result = syscall(__NR_io_uring_enter, m_fd, 1, 0, 0, nullptr, 0);
+
+            if (result == 1) return true;
+            if (result < 0 && errno == EINTR) continue;
+
+            tail.store(position, std::memory_order_release);
+            return false;
+        }
+    }
+
+    bool UringIoService::supports(const unsigned in_opcode) const noexcept
+    {
+        constexpr std::size_t maxOps = 256;
+        std::vector<std::byte> storage(sizeof(io_uring_probe) + maxOps * sizeof(io_uring_probe_op));
+        const auto probe = reinterpret_cast<io_uring_probe*>(storage.data());
+
+        if (syscall(__NR_io_uring_register, m_fd, IORING_REGISTER_PROBE, probe, maxOps) < 0) return false;
+        if (in_opcode > probe->last_op) return false;
+
+        return probe->ops[in_opcode].flags & IO_URING_OP_SUPPORTED;
+    }
+
+    bool UringIoService::_submit(IoRequest& io_request) noexcept
+    {
+        io_uring_sqe entry;
+        __kernel_timespec deadline;
+
+        if (m_futexThreads && io_request.operation == IoOperation::futexWait) return m_futexThreads->submit(io_request);
+
+        std::memset(&entry, 0, sizeof(entry));
+        entry.fd = io_request.fd;
+        entry.user_data = reinterpret_cast<std::uintptr_t>(&io_request);
+
+        switch (io_request.operation)
+        {
+            case IoOperation::read:
+            case IoOperation::write:
+                entry.opcode = io_request.operation == IoOperation::read ? IORING_OP_READ : IORING_OP_WRITE;
+                entry.addr = reinterpret_cast<std::uintptr_t>(io_request.data);
+                entry.len = io_request.bytes;
+                // An offset of all ones is also how io_uring is told to use the file position.
+                entry.off = io_request.offset == IoRequest::currentOffset ? ~std::uint64_t(0) : io_request.offset;
+                break;
+
+            case IoOperation::readable:
+            case IoOperation::writable:
+                entry.opcode = IORING_OP_POLL_ADD;
+                entry.poll32_events = io_request.operation == IoOperation::readable ? POLLIN : POLLOUT;
+                break;
+
+            case IoOperation::futexWait:
+                entry.opcode = uringOpFutexWait;
+                entry.fd = futex2SizeU32;
+                entry.addr = reinterpret_cast<std::uintptr_t>(io_request.data);
+                entry.addr2 = io_request.offset;
+                entry.addr3 = FUTEX_BITSET_MATCH_ANY;
+                break;
+
+            case IoOperation::sleep:
+                // The kernel copies the time while the entry is submitted so it can be on the stack.
+                deadline.tv_sec = io_request.offset / 1000000000;
+                deadline.tv_nsec = io_request.offset % 1000000000;
+                entry.opcode = IORING_OP_TIMEOUT;
+                entry.fd = -1;
+                entry.addr = reinterpret_cast<std::uintptr_t>(&deadline);
+                entry.len = 1;
+                entry.timeout_flags = IORING_TIMEOUT_ABS;
+                break;
+        }
+
+        return enter(entry);
+    }
+
+    bool UringIoService::_cancel(IoRequest& io_request) noexcept
+    {
+        io_uring_sqe entry;
+
+        if (m_futexThreads && io_request.operation == IoOperation::futexWait) return m_futexThreads->cancel(io_request);
+
+        std::memset(&entry, 0, sizeof(entry));
+        entry.opcode = IORING_OP_ASYNC_CANCEL;
+        entry.addr = reinterpret_cast<std::uintptr_t>(&io_request);
+
+        return enter(entry);
+    }
+
+    // Run by the completion thread until the IoService is destroyed.
+    void UringIoService::reap() noexcept
+    {
+        std::atomic_ref head(*m_completeHead);
+        std::atomic_ref tail(*m_completeTail);
+
+        while (true)
+        {
+            auto position = head.load(std::memory_order_relaxed);
+            const auto end = tail.load(std::memory_order_acquire);
+
+            if (position == end)
+            {
+                if (m_stopping && inFlight() == 0) return;
+
+                syscall(__NR_io_uring_enter, m_fd, 0, 1, IORING_ENTER_GETEVENTS, nullptr, 0);
+                continue;
+            }
+
+            for (; position != end; position++)
+            {
+                const auto& completion = m_completions[position & *m_completeMask];
+                const auto request = reinterpret_cast<IoRequest*>(completion.user_data);
+                // A timeout that expires instead of being satisfied by completions is how a sleep ends.
+                const auto result = request != nullptr && request->operation == IoOperation::sleep && completion.res == -ETIME ? 0 : completion.res;
+
+                // The slot is given back first so completion functions can submit more.
+                head.store(position + 1, std::memory_order_release);
+
+                if (request != nullptr) complete(*request, result);
+            }
+        }
+    }
+
+    IoBackend UringIoService::backend() const noexcept
+    {
+        return IoBackend::uring;
+    }
+
+    /// @brief True if futex waits are done on threads because io_uring can not do them.
+    bool UringIoService::threadedFutexWait() const noexcept
+    {
+        return m_futexThreads != nullptr;
+    }
+
+    ThreadIoService::ThreadIoService(const std::size_t in_depth, const std::size_t in_threads) :
+        IoService(in_depth),
+        m_queue(depth() + std::max(in_threads, static_cast<std::size_t>(1)))
+    {
+        m_waits.reserve(depth());
+        m_workers.reserve(std::max(in_threads, static_cast<std::size_t>(1)));
+
+        while (m_workers.size() < m_workers.capacity())
+        {
+            m_workers.emplace_back([this] { worker(); });
+        }
+    }
+
+    // Each worker stops when it takes a null request out of the queue.
+    ThreadIoService::~ThreadIoService() noexcept
+    {
+        drain();
+
+        for (std::size_t i = 0; i < m_workers.size(); i++)
+        {
+            m_queue.push(nullptr);
+        }
+
+        m_pending.release(m_workers.size());
+
+        for (auto& worker : m_workers)
+        {
+            worker.join();
+        }
+    }
+
+    /*
+     * A push can still be finishing when the semaphore says it is there so taking it out of the
+     * queue is retried until it shows up.
+     */
+    void ThreadIoService::worker() noexcept
+    {
+        while (true)
+        {
+            IoRequest* request = nullptr;
+
+            m_pending.acquire();
+
+            while (! m_queue.pop(request))
+            {
+                std::this_thread::yield();
+            }
+
+            if (request == nullptr) return;
+
+            complete(*request, isWait(request->operation) ? wait(*request) : performIo(*request));
+        }
+    }
+
+    // The request is forgotten before it completes so canceling it can never see a stale entry.
+    std::ptrdiff_t ThreadIoService::wait(IoRequest& io_request) noexcept
+    {
+        pollfd descriptor { io_request.fd, static_cast<short>(io_request.operation == IoOperation::readable ? POLLIN : POLLOUT), 0 };
+        const timespec interval { 0, waitInterval * 1000000L };
+        std::ptrdiff_t result = 0;
+        auto done = false;
+
+        while (! done)
+        {
+            if (io_request.operation == IoOperation::sleep)
+            {
+                timespec now;
+
+                clock_gettime(CLOCK_MONOTONIC, &now);
+
+                const auto remaining = static_cast<std::int64_t>(io_request.offset) - (now.tv_sec * 1000000000L + now.tv_nsec);
+
+                if (remaining <= 0) done = true;
+                else std::this_thread::sleep_for(std::chrono::nanoseconds(std::min<std::int64_t>(remaining, waitInterval * 1000000L)));
+            }
+            else if (io_request.operation == IoOperation::futexWait)
+            {
+                const auto woken = syscall(SYS_futex, io_request.data, FUTEX_WAIT, static_cast<std::uint32_t>(io_request.offset), &interval, nullptr, 0);
+
+                done = woken == 0 || (errno != ETIMEDOUT && errno != EINTR);
+                if (woken < 0 && done) result = -errno;
+            }
+            else
+            {
+                const auto ready = ::poll(&descriptor, 1, waitInterval);
+
+                done = ready > 0 || (ready < 0 && errno != EINTR);
+                result = ready > 0 ? descriptor.revents : -errno;
+            }
+
+            std::scoped_lock lock(m_waitsMutex);
+            const auto wait = std::find_if(m_waits.begin(), m_waits.end(), [&] (const Wait& in_wait) { return in_wait.request == &io_request; });
+
+            assert(wait != m_waits.end());
+
+            if (! done && wait->canceled)
+            {
+                result = -ECANCELED;
+                done = true;
+            }
+
+            if (done) m_waits.erase(wait);
+        }
+
+        return result;
+    }
+
+    bool ThreadIoService::_submit(IoRequest& io_request) noexcept
+    {
+        if (isWait(io_request.operation))
+        {
+            std::scoped_lock lock(m_waitsMutex);
+            m_waits.push_back({ &io_request, false });
+        }
+
+        // The queue has room for every request that can be in flight.
+        if (! m_queue.push(&io_request)) return false;
+
+        m_pending.release();
+        return true;
+    }
+
+    bool ThreadIoService::_cancel(IoRequest& io_request) noexcept
+    {
+        std::scoped_lock lock(m_waitsMutex);
+
+        for (auto& wait : m_waits)
+        {
+            if (wait.request != &io_request) continue;
+
+            wait.canceled = true;
+            return true;
+        }
+
+        return false;
+    }
+
+    IoBackend ThreadIoService::backend() const noexcept
+    {
+        return IoBackend::threads;
+    }
+
+    /**
+     * @brief Write to a file starting at in_position.
+     *
+     * The ring holds at least in_capacity bytes. Writing starts once in_batch bytes are in it and
+     * in_capacity should be a multiple of in_alignment so a write never has to stop short of
+     * where the ring wraps around.
+     */
+    RingWriter::RingWriter(const int in_fd, const std::size_t in_capacity, const std::size_t in_position, const std::size_t in_batch, const std::size_t in_alignment, const Finished in_finished, void* in_context) :
+        m_ring(in_capacity),
+        m_fd(in_fd),
+        m_batch(in_batch),
+        m_alignment(in_alignment),
+        m_finishedFunction(in_finished),
+        m_context(in_context),
+        m_io(&ioService()),
+        m_position(in_position)
+    {
+        m_request.operation = IoOperation::write;
+        m_request.fd = m_fd;
+        m_request.complete = writeComplete;
+        m_request.context = this;
+    }
+
+    RingWriter::~RingWriter() noexcept
+    {
+        finish(true);
+        wait();
+    }
+
+    ByteRing& RingWriter::ring() noexcept
+    {
+        return m_ring;
+    }
+
+    const ByteRing& RingWriter::ring() const noexcept
+    {
+        return m_ring;
+    }
+
+    /// @brief The offset in the file the next write goes to. Once finished this is the end of the
+    /// data that was written.
+    std::size_t RingWriter::position() const noexcept
+    {
+        return m_position;
+    }
+
+    /// @brief The errno value of the first failure or 0. Safe to call from any thread.
+    int RingWriter::error() const noexcept
+    {
+        return m_error.load();
+    }
+
+    /// @brief Record a failure unless there already was one.
+    void RingWriter::fail(const int in_error) noexcept
+    {
+        auto expected = 0;
+
+        m_error.compare_exchange_strong(expected, in_error);
+    }
+
+    /// @brief Called by the producer after writing to the ring. This never blocks.
+    void RingWriter::commit() noexcept
+    {
+        if (m_ring.size() >= m_batch) startWriting(false);
+    }
+
+    /**
+     * @brief Write whatever is left in the ring and then call the finished function.
+     *
+     * Without in_wait this does not wait on the disk and if the IoService is full the rest is
+     * left for the next call. Calling this again after the writer finished does nothing.
+     */
+    void RingWriter::finish(const bool in_wait) noexcept
+    {
+        m_finishing = true;
+        startWriting(in_wait);
+    }
+
+    /// @brief Wait until the writer finished. finish() must have been called with in_wait.
+    void RingWriter::wait() noexcept
+    {
+        std::unique_lock lock(m_finishedMutex);
+        m_finishedCondition.wait(lock, [this] { return m_finished; });
+    }
+
+    void RingWriter::writeComplete(IoRequest& io_request) noexcept
+    {
+        auto& writer = *static_cast<RingWriter*>(io_request.context);
+        const auto result = io_request.result;
+
+        if (result < 0) writer.fail(-result);
+        else if (static_cast<std::size_t>(result) != io_request.bytes) writer.fail(EIO);
+        else writer.m_position += writer.m_chunk;
+
+        writer.m_ring.consume(writer.m_chunk);
+
+        // This runs on a thread of the IoService so it can wait for the disk.
+        if (writer.writeNext(true)) return;
+
+        writer.m_writing = false;
+        writer.startWriting(true);
+    }
+
+    /*
+     * Whoever sets the writing flag owns the consuming side of the ring until the flag is cleared
+     * which is either the producer or the completion of the last write. The ring is checked again
+     * after giving up the flag so data that came in during the mean time is not missed.
+     */
+    void RingWriter::startWriting(const bool in_wait) noexcept
+    {
+        while (! m_writing.exchange(true))
+        {
+            if (writeNext(in_wait)) return;
+
+            m_writing = false;
+
+            if (m_ring.size() < m_batch && ! m_finishing) return;
+        }
+    }
+
+    /*
+     * Submit the ring up to where it wraps around rounded down to the alignment. Once finishing
+     * the rest is written no matter how little there is. If the IoService is full the write is
+     * done right here when waiting is allowed.
+     *
+     * Returns true if the writing flag is still held because a write is in flight or the writer
+     * finished.
+     */
+    bool RingWriter::writeNext(const bool in_wait) noexcept
+    {
+        while (true)
+        {
+            const auto finishing = m_finishing.load();
+            const auto data = m_ring.peek();
+            const auto chunk = finishing ? data.size() : data.size() / m_alignment * m_alignment;
+
+            if (chunk > 0 && (finishing || m_ring.size() >= m_batch))
+            {
+                m_chunk = chunk;
+
+                if (m_error.load() != 0)
+                {
+                    m_ring.consume(m_chunk);
+                    continue;
+                }
+
+                m_request.data = const_cast<std::byte*>(data.data());
+                m_request.bytes = (m_chunk + m_alignment - 1) / m_alignment * m_alignment;
+                m_request.offset = m_position;
+
+                if (m_io->submit(m_request)) return true;
+                if (! in_wait) return false;
+
+                if (const auto error = writeAt(m_fd, m_request.data, m_request.bytes, m_request.offset)) fail(error);
+                else m_position += m_chunk;
+
+                m_ring.consume(m_chunk);
+
+                continue;
+            }
+
+            if (! finishing) return false;
+
+            if (m_finishedFunction != nullptr) m_finishedFunction(m_context, m_position);
+
+            std::scoped_lock lock(m_finishedMutex);
+            m_finished = true;
+            m_finishedCondition.notify_all();
+
+            return true;
+        }
+    }
+
+    void initIoService(const IoBackend in_backend)
+    {
+        std::scoped_lock lock(ioServiceSingletonMutex);
+        assert(ioServiceSingleton == nullptr);
+        ioServiceSingleton = IoService::make(in_backend).release();
+        LOGGER(verbose, "Using ", ioServiceSingleton->backend(), " for I/O");
+    }
+
+    void shutdownIoService()
+    {
+        std::scoped_lock lock(ioServiceSingletonMutex);
+        assert(ioServiceSingleton != nullptr);
+        delete ioServiceSingleton;
+        ioServiceSingleton = nullptr;
+    }
+
+    IoService& ioService()
+    {
+        std::scoped_lock lock(ioServiceSingletonMutex);
+        assert(ioServiceSingleton != nullptr);
+        return *ioServiceSingleton;
+    }
+
+    std::string toString(const IoBackend in_backend) noexcept
+    {
+        switch (in_backend)
+        {
+            case IoBackend::uring: return "io_uring";
+            case IoBackend::threads: return "threads";
+        }
+
+        FATAL_ERROR(makeString("Unhandled IoBackend value: ", static_cast<int>(in_backend)));
+    }
+
+    std::ostream& operator<<(std::ostream& in_os, const IoBackend in_backend) noexcept
+    {
+        in_os << toString(in_backend);
+        return in_os;
+    }
+
+    /// @brief Blocking pwrite() of all of the bytes.
+    /// @return 0 or the errno value of the failure.
+    int writeAt(const int in_fd, const std::byte* in_data, const std::size_t in_bytes, const std::size_t in_offset) noexcept
+    {
+        for (std::size_t done = 0; done < in_bytes;)
+        {
+            const auto result = pwrite(in_fd, in_data + done, in_bytes - done, in_offset + done);
+
+            if (result < 0)
+            {
+                if (errno == EINTR) continue;
+
+                return errno;
+            }
+
+            done += result;
+        }
+
+        return 0;
+    }
+}
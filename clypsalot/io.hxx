@@ -0,0 +1,273 @@
+/* Copyright 2023 Tyler Riddle
+ *
+ * This file is part of Clypsalot. Clypsalot is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU Lesser General Public License as published by the Free Software Foundation, either version 3 of the License,
+ * or (at your option) any later version. Clypsalot is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along with Clypsalot. If not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <semaphore>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <clypsalot/memory.hxx>
+#include <clypsalot/queue.hxx>
+
+struct io_uring_cqe;
+struct io_uring_sqe;
+
+/// @file
+namespace Clypsalot
+{
+    enum class IoBackend : uint_fast8_t
+    {
+        uring,
+        threads,
+    };
+
+    enum class IoOperation : uint_fast8_t
+    {
+        read,
+        write,
+        /// @brief Wait until the descriptor can be read from with out blocking.
+        readable,
+        /// @brief Wait until the descriptor can be written to with out blocking.
+        writable,
+        /**
+         * @brief Wait until the 32 bit futex word at data is woken or no longer holds the value
+         * in offset.
+         *
+         * The futex is not process private so it can be in memory that is shared with another
+         * process. The fd is not used.
+         */
+        futexWait,
+        /// @brief Wait until the std::chrono::steady_clock time in nanoseconds in offset. The fd
+        /// is not used.
+        sleep,
+    };
+
+    /**
+     * @brief A read or write that is submitted to an IoService.
+     *
+     * The request is owned by the caller and must stay alive and unchanged until the completion
+     * function has been called so submitting never allocates. The completion function is called
+     * from a thread of the IoService and must not block for long because it holds up every other
+     * completion. Objects usually lock themselves in it and call wakeObject().
+     */
+    struct IoRequest
+    {
+        using Complete = void (*)(IoRequest& io_request) noexcept;
+
+        /// @brief The offset that reads or writes at the file position such as for pipes.
+        static constexpr std::size_t currentOffset = std::numeric_limits<std::size_t>::max();
+
+        IoOperation operation = IoOperation::read;
+        int fd = -1;
+        std::byte* data = nullptr;
+        std::size_t bytes = 0;
+        std::size_t offset = 0;
+        Complete complete = nullptr;
+        void* context = nullptr;
+        /// @brief The number of bytes transferred, the poll events for readable and writable, 0
+        /// for a woken futex or a finished sleep or a negative errno value once complete.
+        std::ptrdiff_t result = 0;
+    };
+
+    /**
+     * @brief Asynchronous file I/O shared by the whole engine.
+     *
+     * Objects that read or write files submit their requests here instead of each running a
+     * blocking thread of their own. At most depth() requests can be in flight and submit() fails
+     * instead of blocking when that many are. Reads and writes are done with a single system call
+     * each so they can be short just like pread() and pwrite().
+     */
+    class IoService
+    {
+        const std::size_t m_depth;
+        IoService* m_owner = nullptr;
+        alignas(cacheLineSize) std::atomic_size_t m_inFlight = 0;
+
+        protected:
+        void complete(IoRequest& io_request, const std::ptrdiff_t in_result) noexcept;
+        void delegate(IoService& io_service) noexcept;
+        void drain() const noexcept;
+        virtual bool _submit(IoRequest& io_request) noexcept = 0;
+        virtual bool _cancel(IoRequest& io_request) noexcept = 0;
+
+        public:
+        static constexpr std::size_t defaultDepth = 256;
+
+        static std::unique_ptr<IoService> make(const IoBackend in_backend = IoBackend::uring, const std::size_t in_depth = defaultDepth);
+        IoService(const std::size_t in_depth) noexcept;
+        IoService(const IoService&) = delete;
+        virtual ~IoService() noexcept = default;
+        void operator=(const IoService&) = delete;
+        virtual IoBackend backend() const noexcept = 0;
+        std::size_t depth() const noexcept;
+        std::size_t inFlight() const noexcept;
+        bool submit(IoRequest& io_request) noexcept;
+        bool cancel(IoRequest& io_request) noexcept;
+    };
+
+    class ThreadIoService;
+
+    /**
+     * @brief An IoService on top of io_uring.
+     *
+     * The rings are used with raw system calls so there is no dependency on liburing. Submitting
+     * takes a short lock around the submission ring and enters the kernel once. A single thread
+     * waits for completions and calls the completion functions. Each operation is checked for
+     * when the rings are set up and io_uring can only wait on futexes on Linux 6.7 or newer, so
+     * on older kernels futex waits are handed to a ThreadIoService and everything else still
+     * goes through io_uring.
+     */
+    class UringIoService : public IoService
+    {
+        int m_fd = -1;
+        void* m_ring = nullptr;
+        std::size_t m_ringBytes = 0;
+        void* m_completionRing = nullptr;
+        std::size_t m_completionRingBytes = 0;
+        io_uring_sqe* m_entries = nullptr;
+        std::size_t m_entriesBytes = 0;
+        unsigned* m_submitTail = nullptr;
+        unsigned* m_submitMask = nullptr;
+        unsigned* m_submitArray = nullptr;
+        unsigned* m_completeHead = nullptr;
+        unsigned* m_completeTail = nullptr;
+        unsigned* m_completeMask = nullptr;
+        io_uring_cqe* m_completions = nullptr;
+        std::mutex m_submitMutex;
+        std::atomic_bool m_stopping = false;
+        std::thread m_completer;
+        std::unique_ptr<ThreadIoService> m_futexThreads;
+
+        bool enter(io_uring_sqe& in_entry) noexcept;
+        bool supports(const unsigned in_opcode) const noexcept;
+        void reap() noexcept;
+        void unmap() noexcept;
+
+        protected:
+        virtual bool _submit(IoRequest& io_request) noexcept override;
+        virtual bool _cancel(IoRequest& io_request) noexcept override;
+
+        public:
+        UringIoService(const std::size_t in_depth, const bool in_uringFutexWait = true);
+        virtual ~UringIoService() noexcept;
+        virtual IoBackend backend() const noexcept override;
+        bool threadedFutexWait() const noexcept;
+    };
+
+    /**
+     * @brief An IoService that does blocking I/O on a small pool of threads.
+     *
+     * This is used when io_uring is not available such as on old kernels or inside containers
+     * that filter it out. Waiting for a descriptor to be ready, on a futex or for a time takes up
+     * a thread the whole time and notices being canceled within waitInterval.
+     */
+    class ThreadIoService : public IoService
+    {
+        struct Wait
+        {
+            IoRequest* request = nullptr;
+            bool canceled = false;
+        };
+
+        BoundedQueue<IoRequest*> m_queue;
+        std::counting_semaphore<> m_pending { 0 };
+        std::mutex m_waitsMutex;
+        std::vector<Wait> m_waits;
+        std::vector<std::thread> m_workers;
+
+        void worker() noexcept;
+        std::ptrdiff_t wait(IoRequest& io_request) noexcept;
+
+        protected:
+        virtual bool _submit(IoRequest& io_request) noexcept override;
+        virtual bool _cancel(IoRequest& io_request) noexcept override;
+
+        public:
+        static constexpr std::size_t defaultThreads = 4;
+        static constexpr int waitInterval = 50;
+
+        ThreadIoService(const std::size_t in_depth, const std::size_t in_threads = defaultThreads);
+        virtual ~ThreadIoService() noexcept;
+        virtual IoBackend backend() const noexcept override;
+    };
+
+    /**
+     * @brief Drain a ByteRing in to a file with writes submitted to the IoService.
+     *
+     * A single producer fills ring() and calls commit() which never blocks. Once batch bytes are
+     * in the ring they are written out with each write started from the completion of the one
+     * before. Writes are a multiple of the alignment so the file can be opened with O_DIRECT and
+     * the last one is padded out with whatever the ring storage holds past the data. After a
+     * failure the ring is still emptied so the producer never stalls. Once finish() is called
+     * whatever is left is written and the finished function is called from the thread that did
+     * the last write. Destroying the writer finishes it and waits.
+     */
+    class RingWriter
+    {
+        public:
+        using Finished = void (*)(void* io_context, const std::size_t in_position) noexcept;
+
+        private:
+        ByteRing m_ring;
+        const int m_fd;
+        const std::size_t m_batch;
+        const std::size_t m_alignment;
+        const Finished m_finishedFunction;
+        void* const m_context;
+        IoService* m_io = nullptr;
+        IoRequest m_request;
+        std::size_t m_chunk = 0;
+        std::size_t m_position = 0;
+        std::atomic_bool m_writing = false;
+        std::atomic_bool m_finishing = false;
+        std::atomic_int m_error = 0;
+        bool m_finished = false;
+        std::mutex m_finishedMutex;
+        std::condition_variable m_finishedCondition;
+
+        static void writeComplete(IoRequest& io_request) noexcept;
+        void startWriting(const bool in_wait) noexcept;
+        bool writeNext(const bool in_wait) noexcept;
+
+        public:
+        RingWriter(const int in_fd, const std::size_t in_capacity, const std::size_t in_position, const std::size_t in_batch, const std::size_t in_alignment = 1, const Finished in_finished = nullptr, void* in_context = nullptr);
+        RingWriter(const RingWriter&) = delete;
+        ~RingWriter() noexcept;
+        void operator=(const RingWriter&) = delete;
+        ByteRing& ring() noexcept;
+        const ByteRing& ring() const noexcept;
+        std::size_t position() const noexcept;
+        int error() const noexcept;
+        void fail(const int in_error) noexcept;
+        void commit() noexcept;
+        void finish(const bool in_wait) noexcept;
+        void wait() noexcept;
+    };
+
+    void initIoService(const IoBackend in_backend = IoBackend::uring);
+    void shutdownIoService();
+    IoService& ioService();
+    std::string toString(const IoBackend in_backend) noexcept;
+    std::ostream& operator<<(std::ostream& in_os, const IoBackend in_backend) noexcept;
+    int writeAt(const int in_fd, const std::byte* in_data, const std::size_t in_bytes, const std::size_t in_offset) noexcept;
+}
@@ -10,6 +10,7 @@
  * <https://www.gnu.org/licenses/>.
  */
 
+#include <algorithm>
 #include <cassert>
 #include <cstring>
 #include <iostream>
@@ -69,25 +70,34 @@ namespace Clypsalot {
     /// @brief Set a new minimum severity on the log destination.
     void LogDestination::severity(const LogSeverity severity) noexcept
     {
-        std::scoped_lock lock(m_mutex);
+        std::unique_lock lock(m_mutex);
         m_minSeverity = severity;
+        lock.unlock();
+
+        logEngine().updateMinSeverity();
     }
 
-    /// @brief Returns true if the given severity is at least as severe as any of the
-    /// registered log destinations. Returns false otherwise.
-    bool LogEngine::shouldLog(const LogSeverity severity) noexcept
+    /// @brief Recalculate the least severe severity any of the destinations accept.
+    void LogEngine::updateMinSeverity() noexcept
     {
         std::shared_lock lock(m_mutex);
+        auto minSeverity = LogSeverity::fatal;
 
         for (const auto destination : m_destinations)
         {
-            if (severity >= destination->severity())
-            {
-                return true;
-            }
+            minSeverity = std::min(minSeverity, destination->severity());
         }
 
-        return false;
+        m_minSeverity.store(minSeverity, std::memory_order_relaxed);
+    }
+
+    /// @brief Returns true if the given severity is at least as severe as any of the
+    /// registered log destinations. Returns false otherwise.
+    ///
+    /// This does not lock anything so it is cheap enough to call before every log message.
+    bool LogEngine::shouldLog(const LogSeverity severity) noexcept
+    {
+        return severity >= m_minSeverity.load(std::memory_order_relaxed);
     }
 
     /// @brief Invoke LogDestination::handleLogEvent() on all registered log destinations
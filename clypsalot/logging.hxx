@@ -12,12 +12,15 @@
 
 #pragma once
 
+#include <atomic>
 #include <chrono>
+#include <concepts>
 #include <cstdint>
 #include <functional>
 #include <initializer_list>
 #include <string>
 #include <thread>
+#include <type_traits>
 #include <vector>
 
 #include <clypsalot/forward.hxx>
@@ -110,8 +113,13 @@ namespace Clypsalot {
     /// is a singleton instance of this object that is accessed via the logEngine() function.
     class LogEngine : private SharedLockable
     {
+        friend LogDestination;
+
         const LogEvent::Timestamp m_programStart = LogEvent::Clock::now();
         std::vector<LogDestination*> m_destinations;
+        std::atomic<LogSeverity> m_minSeverity = LogSeverity::fatal;
+
+        void updateMinSeverity() noexcept;
 
         public:
         LogEngine() = default;
@@ -129,8 +137,10 @@ namespace Clypsalot {
         T& makeDestination(Args&&... args) noexcept
         {
             auto destination = new T(args...);
-            std::scoped_lock lock(m_mutex);
+            std::unique_lock lock(m_mutex);
             m_destinations.push_back(destination);
+            lock.unlock();
+            updateMinSeverity();
             return *destination;
         }
     };
@@ -147,6 +157,22 @@ namespace Clypsalot {
     void deliverLogEvent(const char* source, const char* file, const uint32_t line, const LogSeverity severity, const std::string message) noexcept;
     void deliverLogEvent(const char* source, const char* file, const uint32_t line, const LogSeverity severity, const LogMessageGenerator& generator) noexcept;
     std::string toString(const LogSeverity severity) noexcept;
+
+    /**
+     * @brief The generator version of deliverLogEvent() for any callable.
+     *
+     * This checks the severity before the generator is wrapped in a LogMessageGenerator so log
+     * messages that are not going to be delivered never allocate memory.
+     */
+    template <std::invocable T>
+    requires (! std::same_as<std::remove_cvref_t<T>, LogMessageGenerator>)
+    void deliverLogEvent(const char* source, const char* file, const uint32_t line, const LogSeverity severity, T&& generator) noexcept
+    {
+        if (! logEngine().shouldLog(severity)) return;
+
+        deliverLogEvent(source, file, line, severity, LogMessageGenerator(std::forward<T>(generator)));
+    }
+
     /// @cond NO_DOCUMENT
     std::ostream& operator<<(std::ostream& os, const LogEvent& event) noexcept;
     std::ostream& operator<<(std::ostream& os, const LogSeverity severity) noexcept;
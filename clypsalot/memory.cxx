@@ -0,0 +1,371 @@
+/* Copyright 2023 Tyler Riddle
+ *
+ * This file is part of Clypsalot. Clypsalot is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU Lesser General Public License as published by the Free Software Foundation, either version 3 of the License,
+ * or (at your option) any later version. Clypsalot is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along with Clypsalot. If not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cerrno>
+#include <cstring>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <clypsalot/error.hxx>
+#include <clypsalot/macros.hxx>
+#include <clypsalot/memory.hxx>
+#include <clypsalot/util.hxx>
+
+/// @file
+namespace Clypsalot
+{
+    static std::atomic_size_t totalMappings = 0;
+    static std::atomic_size_t totalNormalBytes = 0;
+    static std::atomic_size_t totalHugeBytes = 0;
+    static std::atomic_size_t totalTransparentBytes = 0;
+
+    static std::size_t roundUp(const std::size_t in_value, const std::size_t in_multiple) noexcept
+    {
+        return (in_value + in_multiple - 1) / in_multiple * in_multiple;
+    }
+
+    static std::size_t pageSize() noexcept
+    {
+        static const auto size = static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+        return size;
+    }
+
+    static std::atomic_size_t& kindBytes(const PageKind in_kind) noexcept
+    {
+        switch (in_kind)
+        {
+            case PageKind::normal: return totalNormalBytes;
+            case PageKind::transparent: return totalTransparentBytes;
+            case PageKind::huge: return totalHugeBytes;
+        }
+
+        FATAL_ERROR(makeString("Unhandled PageKind value: ", static_cast<int>(in_kind)));
+    }
+
+    static void* mapAnonymous(const std::size_t in_bytes, const int in_flags) noexcept
+    {
+        return mmap(nullptr, in_bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | in_flags, -1, 0);
+    }
+
+    /**
+     * @brief Map at least the given number of bytes.
+     * @throws RuntimeError if the kernel will not create the mapping.
+     */
+    PageMapping::PageMapping(const std::size_t in_bytes)
+    {
+        if (in_bytes == 0) return;
+
+        if (in_bytes >= hugePageSize)
+        {
+            const auto bytes = roundUp(in_bytes, hugePageSize);
+
+            if (const auto data = mapAnonymous(bytes, MAP_HUGETLB | MAP_POPULATE); data != MAP_FAILED)
+            {
+                m_data = static_cast<std::byte*>(data);
+                m_bytes = bytes;
+                m_kind = PageKind::huge;
+            }
+            else
+            {
+                // Map an extra huge page so the mapping can be trimmed to start on a huge page
+                // boundary which the kernel needs to use transparent huge pages for all of it.
+                const auto reserved = bytes + hugePageSize;
+                const auto region = mapAnonymous(reserved, 0);
+
+                if (region == MAP_FAILED)
+                {
+                    throw RuntimeError(makeString("Could not map ", reserved, " bytes: ", std::strerror(errno)));
+                }
+
+                const auto start = reinterpret_cast<std::uintptr_t>(region);
+                const auto aligned = roundUp(start, hugePageSize);
+
+                if (aligned > start) munmap(region, aligned - start);
+                if (start + reserved > aligned + bytes) munmap(reinterpret_cast<void*>(aligned + bytes), start + reserved - aligned - bytes);
+
+                m_data = reinterpret_cast<std::byte*>(aligned);
+                m_bytes = bytes;
+                m_kind = madvise(m_data, m_bytes, MADV_HUGEPAGE) == 0 ? PageKind::transparent : PageKind::normal;
+            }
+        }
+        else
+        {
+            const auto bytes = roundUp(in_bytes, pageSize());
+            const auto data = mapAnonymous(bytes, 0);
+
+            if (data == MAP_FAILED)
+            {
+                throw RuntimeError(makeString("Could not map ", bytes, " bytes: ", std::strerror(errno)));
+            }
+
+            m_data = static_cast<std::byte*>(data);
+            m_bytes = bytes;
+        }
+
+        if (m_kind != PageKind::huge)
+        {
+            // Fault every page in now instead of on the processing thread.
+            for (std::size_t offset = 0; offset < m_bytes; offset += pageSize())
+            {
+                m_data[offset] = std::byte(0);
+            }
+        }
+
+        totalMappings.fetch_add(1, std::memory_order_relaxed);
+        kindBytes(m_kind).fetch_add(m_bytes, std::memory_order_relaxed);
+    }
+
+    PageMapping::PageMapping(PageMapping&& in_other) noexcept
+    {
+        *this = std::move(in_other);
+    }
+
+    PageMapping::~PageMapping() noexcept
+    {
+        if (m_data == nullptr) return;
+
+        munmap(m_data, m_bytes);
+        totalMappings.fetch_sub(1, std::memory_order_relaxed);
+        kindBytes(m_kind).fetch_sub(m_bytes, std::memory_order_relaxed);
+    }
+
+    PageMapping& PageMapping::operator=(PageMapping&& in_other) noexcept
+    {
+        std::swap(m_data, in_other.m_data);
+        std::swap(m_bytes, in_other.m_bytes);
+        std::swap(m_kind, in_other.m_kind);
+
+        return *this;
+    }
+
+    std::byte* PageMapping::data() const noexcept
+    {
+        return m_data;
+    }
+
+    /// @brief The size of the mapping which is the requested size rounded up to a whole page.
+    std::size_t PageMapping::bytes() const noexcept
+    {
+        return m_bytes;
+    }
+
+    PageKind PageMapping::kind() const noexcept
+    {
+        return m_kind;
+    }
+
+    /**
+     * @brief Map all of a file for reading.
+     * @throws RuntimeError if the file can not be opened or mapped.
+     */
+    FileMapping::FileMapping(const std::filesystem::path& in_path)
+    {
+        const auto descriptor = open(in_path.c_str(), O_RDONLY | O_CLOEXEC);
+
+        if (descriptor < 0)
+        {
+            throw RuntimeError(makeString("Could not open ", in_path.string(), ": ", std::strerror(errno)));
+        }
+
+        struct stat status;
+
+        if (fstat(descriptor, &status) != 0)
+        {
+            const auto error = errno;
+
+            close(descriptor);
+            throw RuntimeError(makeString("Could not stat ", in_path.string(), ": ", std::strerror(error)));
+        }
+
+        const auto bytes = static_cast<std::size_t>(status.st_size);
+
+        if (bytes > 0)
+        {
+            const auto data = mmap(nullptr, bytes, PROT_READ, MAP_SHARED, descriptor, 0);
+
+            if (data == MAP_FAILED)
+            {
+                const auto error = errno;
+
+                close(descriptor);
+                throw RuntimeError(makeString("Could not map ", in_path.string(), ": ", std::strerror(error)));
+            }
+
+            m_data = static_cast<std::byte*>(data);
+            m_bytes = bytes;
+            madvise(m_data, m_bytes, MADV_SEQUENTIAL);
+        }
+
+        // The mapping keeps the file open.
+        close(descriptor);
+    }
+
+    FileMapping::FileMapping(FileMapping&& in_other) noexcept
+    {
+        *this = std::move(in_other);
+    }
+
+    FileMapping::~FileMapping() noexcept
+    {
+        if (m_data != nullptr) munmap(m_data, m_bytes);
+    }
+
+    FileMapping& FileMapping::operator=(FileMapping&& in_other) noexcept
+    {
+        std::swap(m_data, in_other.m_data);
+        std::swap(m_bytes, in_other.m_bytes);
+
+        return *this;
+    }
+
+    const std::byte* FileMapping::data() const noexcept
+    {
+        return m_data;
+    }
+
+    /// @brief The size of the file when it was mapped.
+    std::size_t FileMapping::bytes() const noexcept
+    {
+        return m_bytes;
+    }
+
+    /**
+     * @brief Read a range of the file into memory and map it so touching it does not fault.
+     *
+     * This blocks until the pages are resident so it belongs on a thread that is not processing
+     * audio. Kernels that can not populate a range in one call get every page touched instead.
+     */
+    void FileMapping::prefetch(const std::size_t in_offset, const std::size_t in_bytes) const noexcept
+    {
+        if (in_offset >= m_bytes) return;
+
+        const auto start = in_offset / pageSize() * pageSize();
+        const auto end = std::min(roundUp(in_offset + in_bytes, pageSize()), roundUp(m_bytes, pageSize()));
+        const auto region = m_data + start;
+
+        madvise(region, end - start, MADV_WILLNEED);
+
+#ifdef MADV_POPULATE_READ
+        if (madvise(region, end - start, MADV_POPULATE_READ) == 0) return;
+#endif
+
+        for (auto offset = start; offset < std::min(end, m_bytes); offset += pageSize())
+        {
+            static_cast<void>(*static_cast<const volatile std::byte*>(m_data + offset));
+        }
+    }
+
+    ByteRing::ByteRing(const std::size_t in_capacity) :
+        m_memory(roundUp(std::max(in_capacity, static_cast<std::size_t>(1)), pageSize()))
+    { }
+
+    std::size_t ByteRing::capacity() const noexcept
+    {
+        return m_memory.bytes();
+    }
+
+    /// @brief The number of bytes waiting to be read. Exact when called by the producer or the
+    /// consumer except that the other side may have changed it by the time it is used.
+    std::size_t ByteRing::size() const noexcept
+    {
+        // The head is loaded first so it can never be past the tail that is loaded after it.
+        const auto head = m_head.load(std::memory_order_acquire);
+        const auto tail = m_tail.load(std::memory_order_acquire);
+
+        return tail - head;
+    }
+
+    std::size_t ByteRing::space() const noexcept
+    {
+        return capacity() - size();
+    }
+
+    /// @brief Append all of the bytes or none of them if they do not fit. Only the producer may
+    /// call this.
+    bool ByteRing::write(const std::byte* in_data, const std::size_t in_bytes) noexcept
+    {
+        const auto tail = m_tail.load(std::memory_order_relaxed);
+
+        if (capacity() - (tail - m_head.load(std::memory_order_acquire)) < in_bytes) return false;
+
+        const auto offset = tail % capacity();
+        const auto first = std::min(in_bytes, capacity() - offset);
+
+        std::memcpy(m_memory.data() + offset, in_data, first);
+        std::memcpy(m_memory.data(), in_data + first, in_bytes - first);
+        m_tail.store(tail + in_bytes, std::memory_order_release);
+
+        return true;
+    }
+
+    /**
+     * @brief The oldest bytes in the ring up to where the storage wraps around. Only the consumer
+     * may call this.
+     *
+     * Whatever is left after the wrap is returned by the next call once these have been consumed.
+     */
+    std::span<const std::byte> ByteRing::peek() const noexcept
+    {
+        const auto head = m_head.load(std::memory_order_relaxed);
+        const auto tail = m_tail.load(std::memory_order_acquire);
+        const auto offset = head % capacity();
+
+        return { m_memory.data() + offset, std::min(tail - head, capacity() - offset) };
+    }
+
+    /// @brief Release bytes that were read from peek(). Only the consumer may call this.
+    void ByteRing::consume(const std::size_t in_bytes) noexcept
+    {
+        const auto head = m_head.load(std::memory_order_relaxed);
+
+        assert(in_bytes <= m_tail.load(std::memory_order_acquire) - head);
+
+        m_head.store(head + in_bytes, std::memory_order_release);
+    }
+
+    MemoryStatistics memoryStatistics() noexcept
+    {
+        MemoryStatistics statistics;
+
+        statistics.mappings = totalMappings.load(std::memory_order_relaxed);
+        statistics.hugeBytes = totalHugeBytes.load(std::memory_order_relaxed);
+        statistics.transparentBytes = totalTransparentBytes.load(std::memory_order_relaxed);
+        statistics.bytes = totalNormalBytes.load(std::memory_order_relaxed) + statistics.hugeBytes + statistics.transparentBytes;
+
+        return statistics;
+    }
+
+    std::string toString(const PageKind in_kind) noexcept
+    {
+        switch (in_kind)
+        {
+            case PageKind::normal: return "normal";
+            case PageKind::transparent: return "transparent";
+            case PageKind::huge: return "huge";
+        }
+
+        FATAL_ERROR(makeString("Unhandled PageKind value: ", static_cast<int>(in_kind)));
+    }
+
+    std::ostream& operator<<(std::ostream& in_os, const PageKind in_kind) noexcept
+    {
+        in_os << toString(in_kind);
+        return in_os;
+    }
+}
@@ -0,0 +1,131 @@
+/* Copyright 2023 Tyler Riddle
+ *
+ * This file is part of Clypsalot. Clypsalot is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU Lesser General Public License as published by the Free Software Foundation, either version 3 of the License,
+ * or (at your option) any later version. Clypsalot is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along with Clypsalot. If not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <ostream>
+#include <span>
+#include <string>
+
+#include <clypsalot/queue.hxx>
+
+/// @file
+namespace Clypsalot
+{
+    /// @brief The size of the huge pages that are asked for when mapping memory.
+    constexpr std::size_t hugePageSize = 2 * 1024 * 1024;
+
+    enum class PageKind : uint_fast8_t
+    {
+        /// @brief The mapping uses the normal page size.
+        normal,
+        /// @brief The kernel was asked to back the mapping with transparent huge pages.
+        transparent,
+        /// @brief The mapping came from the reserved huge page pool.
+        huge,
+    };
+
+    /**
+     * @brief An anonymous memory mapping that is released when the instance is destroyed.
+     *
+     * Mappings of at least hugePageSize bytes are taken from the reserved huge page pool when it
+     * has room. When it does not the mapping is aligned to hugePageSize and the kernel is asked
+     * to use transparent huge pages for it. Smaller mappings use normal pages. The memory is
+     * zeroed and every page is touched when the mapping is created so no page faults happen when
+     * it is used later.
+     */
+    class PageMapping
+    {
+        std::byte* m_data = nullptr;
+        std::size_t m_bytes = 0;
+        PageKind m_kind = PageKind::normal;
+
+        public:
+        PageMapping() noexcept = default;
+        explicit PageMapping(const std::size_t in_bytes);
+        PageMapping(const PageMapping&) = delete;
+        PageMapping(PageMapping&& in_other) noexcept;
+        ~PageMapping() noexcept;
+        void operator=(const PageMapping&) = delete;
+        PageMapping& operator=(PageMapping&& in_other) noexcept;
+        std::byte* data() const noexcept;
+        std::size_t bytes() const noexcept;
+        PageKind kind() const noexcept;
+    };
+
+    /**
+     * @brief A read only mapping of a whole file that is released when the instance is destroyed.
+     *
+     * The kernel is told the file will be read from the start to the end so it reads ahead of
+     * the pages being used and drops the pages behind them first. Pages are only read in when
+     * they are touched unless prefetch() populated them ahead of time.
+     */
+    class FileMapping
+    {
+        std::byte* m_data = nullptr;
+        std::size_t m_bytes = 0;
+
+        public:
+        FileMapping() noexcept = default;
+        explicit FileMapping(const std::filesystem::path& in_path);
+        FileMapping(const FileMapping&) = delete;
+        FileMapping(FileMapping&& in_other) noexcept;
+        ~FileMapping() noexcept;
+        void operator=(const FileMapping&) = delete;
+        FileMapping& operator=(FileMapping&& in_other) noexcept;
+        const std::byte* data() const noexcept;
+        std::size_t bytes() const noexcept;
+        void prefetch(const std::size_t in_offset, const std::size_t in_bytes) const noexcept;
+    };
+
+    /**
+     * @brief A lock free stream of bytes with exactly one producer and one consumer.
+     *
+     * The storage is a PageMapping so it is page aligned and never faults once created. The
+     * capacity is rounded up to a whole number of pages which keeps every page sized read from the
+     * consumer side aligned. Writes either fit entirely or fail so the producer never blocks.
+     */
+    class ByteRing
+    {
+        PageMapping m_memory;
+        alignas(cacheLineSize) std::atomic_size_t m_head = 0;
+        alignas(cacheLineSize) std::atomic_size_t m_tail = 0;
+
+        public:
+        explicit ByteRing(const std::size_t in_capacity);
+        ByteRing(const ByteRing&) = delete;
+        void operator=(const ByteRing&) = delete;
+        std::size_t capacity() const noexcept;
+        std::size_t size() const noexcept;
+        std::size_t space() const noexcept;
+        bool write(const std::byte* in_data, const std::size_t in_bytes) noexcept;
+        std::span<const std::byte> peek() const noexcept;
+        void consume(const std::size_t in_bytes) noexcept;
+    };
+
+    /// @brief Totals for every PageMapping in the process.
+    struct MemoryStatistics
+    {
+        std::size_t mappings = 0;
+        std::size_t bytes = 0;
+        std::size_t hugeBytes = 0;
+        std::size_t transparentBytes = 0;
+    };
+
+    MemoryStatistics memoryStatistics() noexcept;
+    std::string toString(const PageKind in_kind) noexcept;
+    std::ostream& operator<<(std::ostream& in_os, const PageKind in_kind) noexcept;
+}
@@ -0,0 +1,219 @@
+/* Copyright 2023 Tyler Riddle
+ *
+ * This file is part of Clypsalot. Clypsalot is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU Lesser General Public License as published by the Free Software Foundation, either version 3 of the License,
+ * or (at your option) any later version. Clypsalot is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along with Clypsalot. If not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define CLYPSALOT_X86_KERNELS
+#include <immintrin.h>
+#endif
+
+#include <clypsalot/error.hxx>
+#include <clypsalot/mix.hxx>
+#include <clypsalot/util.hxx>
+
+/// @file
+namespace Clypsalot
+{
+    static void scaleScalar(float* out_dest, const float* in_source, const float in_gain, const std::size_t in_frames) noexcept
+    {
+        for (std::size_t i = 0; i < in_frames; i++)
+        {
+            out_dest[i] = in_source[i] * in_gain;
+        }
+    }
+
+    static void accumulateScalar(float* out_dest, const float* in_source, const float in_gain, const std::size_t in_frames) noexcept
+    {
+        for (std::size_t i = 0; i < in_frames; i++)
+        {
+            out_dest[i] += in_source[i] * in_gain;
+        }
+    }
+
+#ifdef CLYPSALOT_X86_KERNELS
+    __attribute__((target("sse2")))
+    static void scaleSse2(float* out_dest, const float* in_source, const float in_gain, const std::size_t in_frames) noexcept
+    {
+        const auto gain = _mm_set1_ps(in_gain);
+        std::size_t i = 0;
+
+        for (; i + 4 <= in_frames; i += 4)
+        {
+            _mm_storeu_ps(out_dest + i, _mm_mul_ps(_mm_loadu_ps(in_source + i), gain));
+        }
+
+        scaleScalar(out_dest + i, in_source + i, in_gain, in_frames - i);
+    }
+
+    __attribute__((target("sse2")))
+    static void accumulateSse2(float* out_dest, const float* in_source, const float in_gain, const std::size_t in_frames) noexcept
+    {
+        const auto gain = _mm_set1_ps(in_gain);
+        std::size_t i = 0;
+
+        for (; i + 4 <= in_frames; i += 4)
+        {
+            _mm_storeu_ps(out_dest + i, _mm_add_ps(_mm_loadu_ps(out_dest + i), _mm_mul_ps(_mm_loadu_ps(in_source + i), gain)));
+        }
+
+        accumulateScalar(out_dest + i, in_source + i, in_gain, in_frames - i);
+    }
+
+    __attribute__((target("avx2")))
+    static void scaleAvx2(float* out_dest, const float* in_source, const float in_gain, const std::size_t in_frames) noexcept
+    {
+        const auto gain = _mm256_set1_ps(in_gain);
+        std::size_t i = 0;
+
+        for (; i + 8 <= in_frames; i += 8)
+        {
+            _mm256_storeu_ps(out_dest + i, _mm256_mul_ps(_mm256_loadu_ps(in_source + i), gain));
+        }
+
+        scaleScalar(out_dest + i, in_source + i, in_gain, in_frames - i);
+    }
+
+    __attribute__((target("avx2")))
+    static void accumulateAvx2(float* out_dest, const float* in_source, const float in_gain, const std::size_t in_frames) noexcept
+    {
+        const auto gain = _mm256_set1_ps(in_gain);
+        std::size_t i = 0;
+
+        for (; i + 8 <= in_frames; i += 8)
+        {
+            _mm256_storeu_ps(out_dest + i, _mm256_add_ps(_mm256_loadu_ps(out_dest + i), _mm256_mul_ps(_mm256_loadu_ps(in_source + i), gain)));
+        }
+
+        accumulateScalar(out_dest + i, in_source + i, in_gain, in_frames - i);
+    }
+#endif
+
+    /**
+     * @param in_level The highest level of vector instructions to use. It is limited to what the
+     * CPU supports.
+     * @throws ValueError if the matrix is empty.
+     */
+    PcmMixer::PcmMixer(const PcmMatrix& in_matrix, const SimdLevel in_level) :
+        m_matrix(in_matrix)
+    {
+        if (m_matrix.empty()) throw ValueError("Mixer matrix can not be empty");
+
+        m_routes.reserve(m_matrix.inputs() * m_matrix.outputs());
+        m_firstRoute.resize(m_matrix.outputs() + 1);
+        updateRoutes();
+
+        [[maybe_unused]] const auto level = std::min(in_level, simdLevel());
+
+        m_scale = scaleScalar;
+        m_accumulate = accumulateScalar;
+
+#ifdef CLYPSALOT_X86_KERNELS
+        if (level >= SimdLevel::avx2)
+        {
+            m_scale = scaleAvx2;
+            m_accumulate = accumulateAvx2;
+            m_level = SimdLevel::avx2;
+        }
+        else if (level >= SimdLevel::sse2)
+        {
+            m_scale = scaleSse2;
+            m_accumulate = accumulateSse2;
+            m_level = SimdLevel::sse2;
+        }
+#endif
+    }
+
+    void PcmMixer::updateRoutes() noexcept
+    {
+        m_routes.clear();
+
+        for (std::size_t output = 0; output < m_matrix.outputs(); output++)
+        {
+            const auto row = m_matrix.row(output);
+
+            m_firstRoute[output] = m_routes.size();
+
+            for (std::size_t input = 0; input < m_matrix.inputs(); input++)
+            {
+                if (row[input] != 0) m_routes.push_back({ input, row[input] });
+            }
+        }
+
+        m_firstRoute[m_matrix.outputs()] = m_routes.size();
+    }
+
+    const PcmMatrix& PcmMixer::matrix() const noexcept
+    {
+        return m_matrix;
+    }
+
+    /**
+     * @brief Replace the matrix with one of the same size.
+     * @throws ValueError if the matrix is a different size.
+     *
+     * This does not allocate so it is safe to call between blocks on the processing thread.
+     */
+    void PcmMixer::matrix(const PcmMatrix& in_matrix)
+    {
+        if (in_matrix.inputs() != m_matrix.inputs() || in_matrix.outputs() != m_matrix.outputs())
+        {
+            throw ValueError(makeString("Mixer matrix must be ", m_matrix.outputs(), "x", m_matrix.inputs(), " but is ", in_matrix.outputs(), "x", in_matrix.inputs()));
+        }
+
+        m_matrix = in_matrix;
+        updateRoutes();
+    }
+
+    SimdLevel PcmMixer::level() const noexcept
+    {
+        return m_level;
+    }
+
+    /// @brief The number of non zero gains in the matrix.
+    std::size_t PcmMixer::routes() const noexcept
+    {
+        return m_routes.size();
+    }
+
+    void PcmMixer::process(const PcmBuffer& in_source, PcmBuffer& out_dest, const std::size_t in_frames) noexcept
+    {
+        assert(in_source.format() == PcmFormat::float32 && out_dest.format() == PcmFormat::float32);
+        assert(in_source.channels() == m_matrix.inputs() && out_dest.channels() == m_matrix.outputs());
+        assert(in_frames <= in_source.frames() && in_frames <= out_dest.frames());
+
+        for (std::size_t output = 0; output < m_matrix.outputs(); output++)
+        {
+            const auto first = m_firstRoute[output];
+            const auto last = m_firstRoute[output + 1];
+            const auto dest = out_dest.channel<float>(output);
+
+            if (first == last)
+            {
+                std::memset(dest, 0, in_frames * sizeof(float));
+                continue;
+            }
+
+            const auto& route = m_routes[first];
+
+            if (route.gain == 1) std::memcpy(dest, in_source.channel<float>(route.input), in_frames * sizeof(float));
+            else m_scale(dest, in_source.channel<float>(route.input), route.gain, in_frames);
+
+            for (auto i = first + 1; i < last; i++)
+            {
+                m_accumulate(dest, in_source.channel<float>(m_routes[i].input), m_routes[i].gain, in_frames);
+            }
+        }
+    }
+}
@@ -0,0 +1,64 @@
+/* Copyright 2023 Tyler Riddle
+ *
+ * This file is part of Clypsalot. Clypsalot is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU Lesser General Public License as published by the Free Software Foundation, either version 3 of the License,
+ * or (at your option) any later version. Clypsalot is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along with Clypsalot. If not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include <clypsalot/pcm.hxx>
+#include <clypsalot/simd.hxx>
+
+/// @file
+namespace Clypsalot
+{
+    /**
+     * @brief Mixes float32 channels through a PcmMatrix.
+     *
+     * The matrix is reduced to the list of non zero gains for every output channel. An output
+     * with no gains is cleared and an output that is a single input at unity gain is copied so
+     * routing and permutation matrices cost no more than a copy. Every other output is built by
+     * scaling and accumulating its inputs with vector instructions when the CPU has them. All the
+     * memory is allocated by the constructor so the matrix can be changed with out allocating.
+     */
+    class PcmMixer
+    {
+        public:
+        using ScaleKernel = void (*)(float* out_dest, const float* in_source, const float in_gain, const std::size_t in_frames) noexcept;
+
+        private:
+        struct Route
+        {
+            std::size_t input = 0;
+            float gain = 0;
+        };
+
+        PcmMatrix m_matrix;
+        std::vector<Route> m_routes;
+        std::vector<std::size_t> m_firstRoute;
+        SimdLevel m_level = SimdLevel::scalar;
+        ScaleKernel m_scale = nullptr;
+        ScaleKernel m_accumulate = nullptr;
+
+        void updateRoutes() noexcept;
+
+        public:
+        PcmMixer(const PcmMatrix& in_matrix, const SimdLevel in_level = simdLevel());
+        PcmMixer(const PcmMixer&) = delete;
+        void operator=(const PcmMixer&) = delete;
+        const PcmMatrix& matrix() const noexcept;
+        void matrix(const PcmMatrix& in_matrix);
+        SimdLevel level() const noexcept;
+        std::size_t routes() const noexcept;
+        void process(const PcmBuffer& in_source, PcmBuffer& out_dest, const std::size_t in_frames) noexcept;
+    };
+}
@@ -39,5 +39,6 @@ namespace Clypsalot
         const std::initializer_list<ObjectDescriptor>& objects;
     };
 
+    const ModuleDescriptor* builtinModuleDescriptor();
     void importModule(const ModuleDescriptor* module);
 }
@@ -16,6 +16,7 @@
 #include <clypsalot/error.hxx>
 #include <clypsalot/logger.hxx>
 #include <clypsalot/network.hxx>
+#include <clypsalot/preset.hxx>
 #include <clypsalot/util.hxx>
 
 using namespace std::placeholders;
@@ -200,4 +201,56 @@ namespace Clypsalot
         std::scoped_lock lock(m_mutex);
         _stop();
     }
+
+    /**
+     * @brief Apply every value in the Preset at the same period boundary.
+     * @throws RuntimeError if the Preset has an Object that is not part of the Network.
+     *
+     * All the objects in the Preset are locked and paused before any value is changed so no
+     * Object processes with a mix of old and new values. The objects are started again once every
+     * value has been applied.
+     */
+    void Network::recall(const Preset& preset)
+    {
+        std::scoped_lock lock(m_mutex);
+        const auto& blocks = preset.blocks();
+        std::vector<std::unique_lock<Object>> locks;
+        std::vector<SharedObject> startObjects;
+
+        for (const auto& block : blocks)
+        {
+            if (! _hasObject(block.object)) throw RuntimeError(makeString("Object is not registered with network: ", *block.object));
+        }
+
+        Finally finally([&startObjects]
+        {
+            for (const auto& object : startObjects)
+            {
+                startObject(object);
+            }
+        });
+
+        locks.reserve(blocks.size());
+        startObjects.reserve(blocks.size());
+
+        // The blocks are in Object id order so every caller locks the objects in the same order
+        for (const auto& block : blocks)
+        {
+            locks.emplace_back(*block.object);
+        }
+
+        for (const auto& block : blocks)
+        {
+            if (pauseObject(block.object)) startObjects.push_back(block.object);
+        }
+
+        LOGGER(debug, "Recalling preset with ", preset.size(), " values for ", blocks.size(), " objects");
+
+        for (const auto& block : blocks)
+        {
+            if (objectIsShutdown(block.object->state())) continue;
+
+            block.object->applyProperties(block.values);
+        }
+    }
 }
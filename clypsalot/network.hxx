@@ -66,5 +66,6 @@ namespace Clypsalot
         void start();
         void run();
         void stop();
+        void recall(const Preset& preset);
     };
 }
@@ -1,6 +1,7 @@
 #include <atomic>
 #include <cassert>
 
+#include <clypsalot/automation.hxx>
 #include <clypsalot/catalog.hxx>
 #include <clypsalot/error.hxx>
 #include <clypsalot/logger.hxx>
@@ -161,6 +162,16 @@ namespace Clypsalot
 
         if (endOfData()) return true;
 
+        if (! portsReady()) return false;
+
+        OBJECT_LOGGER(trace, "Ready");
+        return true;
+    }
+
+    bool Object::portsReady() const noexcept
+    {
+        assert(haveLock());
+
         for (const auto port : m_inputPorts)
         {
             if (! port->ready())
@@ -179,70 +190,76 @@ namespace Clypsalot
             }
         }
 
-        OBJECT_LOGGER(trace, "Ready");
         return true;
     }
 
-    std::vector<PortLink*> Object::links() const noexcept
+    /// @brief All the links of the output ports followed by all the links of the input ports.
+    const std::vector<PortLink*>& Object::links() const noexcept
     {
         assert(haveLock());
-        std::vector<PortLink*> allLinks;
 
-        for (const auto port : m_outputPorts)
-        {
-            for (const auto link : port->links())
-            {
-                allLinks.push_back(link);
-            }
-        }
+        return m_links;
+    }
 
-        for (const auto port : m_inputPorts)
-        {
-            for (const auto link : port->links())
-            {
-                allLinks.push_back(link);
-            }
-        }
+    /**
+     * @brief Every Object that is linked to this one with each Object present only once.
+     *
+     * The list is maintained as links are added and removed so this does not allocate or touch
+     * any reference counts.
+     */
+    const std::vector<Object*>& Object::neighbours() const noexcept
+    {
+        assert(haveLock());
 
-        return allLinks;
+        return m_neighbours;
     }
 
     std::vector<SharedObject> Object::linkedObjects() const noexcept
     {
         assert(haveLock());
 
-        std::map<SharedObject, bool> seenObjects;
         std::vector<SharedObject> linkedObjects;
 
-        for (const auto port : m_outputPorts)
+        linkedObjects.reserve(m_neighbours.size());
+
+        for (const auto neighbour : m_neighbours)
         {
-            for (const auto link : port->links())
-            {
-                auto toParent = link->to().parent().shared_from_this();
+            linkedObjects.push_back(neighbour->shared_from_this());
+        }
 
-                if (! seenObjects.contains(toParent))
-                {
-                    seenObjects[toParent] = true;
-                    linkedObjects.push_back(toParent);
-                }
-            }
+        return linkedObjects;
+    }
+
+    /// @brief Rebuild the cached links and neighbours. Called by Port when a link is added or
+    /// removed.
+    void Object::updateLinks() noexcept
+    {
+        assert(haveLock());
+
+        m_links.clear();
+        m_neighbours.clear();
+
+        for (const auto port : m_outputPorts)
+        {
+            m_links.insert(m_links.end(), port->links().begin(), port->links().end());
         }
 
         for (const auto port : m_inputPorts)
         {
-            for (const auto link : port->links())
-            {
-                auto fromParent = link->from().parent().shared_from_this();
+            m_links.insert(m_links.end(), port->links().begin(), port->links().end());
+        }
 
-                if (! seenObjects.contains(fromParent))
-                {
-                    seenObjects[fromParent] = true;
-                    linkedObjects.push_back(fromParent);
-                }
+        for (const auto link : m_links)
+        {
+            auto neighbour = &link->from().parent();
+
+            if (neighbour == this) neighbour = &link->to().parent();
+
+            if (std::find(m_neighbours.begin(), m_neighbours.end(), neighbour) == m_neighbours.end())
+            {
+                m_neighbours.push_back(neighbour);
             }
         }
-
-        return linkedObjects;
     }
 
     void Object::wait(const std::function<bool ()> tester)
@@ -315,7 +332,7 @@ namespace Clypsalot
         assert(m_state == ObjectState::initializing);
     }
 
-    void Object::configure(const ObjectConfig& config)
+    void Object::configure(const ObjectConfig& config, const PropertyValues& values)
     {
         assert(m_mutex.haveLock());
 
@@ -333,7 +350,13 @@ namespace Clypsalot
                 objectStateError(shared_from_this());
             }
 
+            for (const auto& [handle, value] : values)
+            {
+                property(handle).assign(value);
+            }
+
             handleConfigure(config);
+            if (m_automation) m_automation->bind(m_propertyHandles);
             state(ObjectState::paused);
         }
         catch (const std::exception& e)
@@ -347,6 +370,70 @@ namespace Clypsalot
         }
     }
 
+    void Object::configure(const ObjectConfig& config)
+    {
+        assert(m_mutex.haveLock());
+
+        configure(config, {});
+    }
+
+    /**
+     * @brief Configure the Object with values that were compiled ahead of time.
+     *
+     * The values skip the name lookups and std::any conversions of the ObjectConfig version
+     * which makes this the fast way to configure many objects of the same kind. Use
+     * compileConfig() on one of the objects to create the values.
+     *
+     * The values are only meaningful once the properties they refer to exist so the Object
+     * must already be initialized. Objects that create properties in handleInit() from their
+     * configuration need init() to be called with that configuration first.
+     *
+     * @throws ObjectStateError if the Object has not been initialized.
+     * @throws KeyError if a handle does not refer to a property.
+     * @throws TypeError if a value does not hold the type of its property.
+     */
+    void Object::configure(const PropertyValues& values)
+    {
+        assert(m_mutex.haveLock());
+
+        if (m_state == ObjectState::initializing) objectStateError(shared_from_this());
+
+        configure({}, values);
+    }
+
+    /**
+     * @brief Resolve the names and convert the values of a configuration once.
+     *
+     * Property handles are assigned in the order properties are added so the result can be
+     * given to configure() for every Object of the same kind that was created and initialized
+     * the same way.
+     *
+     * @throws ObjectStateError if the Object has not been initialized because properties that
+     * handleInit() creates would not be found.
+     * @throws KeyError if a name does not refer to a property.
+     */
+    PropertyValues Object::compileConfig(const ObjectConfig& config) const
+    {
+        assert(m_mutex.haveLock());
+
+        if (m_state == ObjectState::initializing)
+        {
+            objectStateError(std::const_pointer_cast<Object>(shared_from_this()));
+        }
+
+        PropertyValues values;
+
+        values.reserve(config.size());
+
+        for (const auto& [name, value] : config)
+        {
+            const auto handle = propertyHandle(name);
+            values.emplace_back(handle, m_propertyHandles[handle]->convert(value));
+        }
+
+        return values;
+    }
+
     void Object::handleConfigure(const ObjectConfig& config)
     {
         assert(m_mutex.haveLock());
@@ -355,8 +442,9 @@ namespace Clypsalot
         for (const auto& [name, value] : config)
         {
             OBJECT_LOGGER(trace, "Setting value for property: ", name);
-            property(name).set(value);
-            OBJECT_LOGGER(debug, "Configured property ", name, "=", property(name).valueToString());
+            auto& configProperty = property(name);
+            configProperty.set(value);
+            OBJECT_LOGGER(debug, "Configured property ", name, "=", configProperty.valueToString());
         }
     }
 
@@ -372,6 +460,17 @@ namespace Clypsalot
         stop();
     }
 
+    /**
+     * @brief Called with the lock held after a link was added to one of the ports.
+     *
+     * Anything that depends on the settings of the link is sized here so process() does not
+     * allocate. An exception removes the link again.
+     */
+    void Object::handleLinked(const PortLink&)
+    {
+        assert(m_mutex.haveLock());
+    }
+
     Property& Object::addProperty(const PropertyConfig& config)
     {
         assert(haveLock());
@@ -390,6 +489,7 @@ namespace Clypsalot
             throw KeyError(makeString("Duplicate property name: ", config.name), config.name);
         }
 
+        m_propertyHandles.push_back(&iterator->second);
         return iterator->second;
     }
 
@@ -422,6 +522,53 @@ namespace Clypsalot
         return m_properties.at(name);
     }
 
+    /**
+     * @brief Find the handle of a property.
+     *
+     * Handles are assigned in the order properties are added so every instance of an Object
+     * kind has the same handles. Resolve the handle once and use it where a lookup by name
+     * would be too expensive.
+     */
+    Property::Handle Object::propertyHandle(const std::string& name) const
+    {
+        assert(m_mutex.haveLock());
+
+        for (Property::Handle handle = 0; handle < m_propertyHandles.size(); handle++)
+        {
+            if (m_propertyHandles[handle]->name() == name) return handle;
+        }
+
+        throw KeyError(makeString("Unknown property name: ", name), name);
+    }
+
+    Property& Object::property(const Property::Handle handle)
+    {
+        assert(m_mutex.haveLock());
+
+        if (handle >= m_propertyHandles.size())
+        {
+            throw KeyError(makeString("Unknown property handle: ", handle), std::to_string(handle));
+        }
+
+        return *m_propertyHandles[handle];
+    }
+
+    /**
+     * @brief Set many properties from values that were resolved ahead of time.
+     * @throws KeyError if a handle does not refer to a property.
+     * @throws ImmutableError if a property is not public mutable.
+     * @throws TypeError if a value does not hold the type of its property.
+     */
+    void Object::applyProperties(const PropertyValues& values)
+    {
+        assert(m_mutex.haveLock());
+
+        for (const auto& [handle, value] : values)
+        {
+            property(handle).variant(value);
+        }
+    }
+
     const std::map<std::string, Property>& Object::properties() const noexcept
     {
         assert(haveLock());
@@ -436,6 +583,55 @@ namespace Clypsalot
         return property(name).sizeRef();
     }
 
+    float& Object::propertyRealRef(const std::string& name)
+    {
+        assert(m_mutex.haveLock());
+
+        return property(name).realRef();
+    }
+
+    /**
+     * @brief Give the Object a stream of automation events.
+     * @param capacity The number of events that can be queued before Object::automate() fails.
+     *
+     * Objects that want their Property::Automatable properties to be automated must call this
+     * while they are preparing and then use automation() from inside process().
+     */
+    void Object::enableAutomation(const size_t capacity)
+    {
+        assert(m_mutex.haveLock());
+
+        if (! objectIsPreparing(m_state))
+        {
+            objectStateError(shared_from_this());
+        }
+
+        m_automation = std::make_unique<Automation>(capacity);
+    }
+
+    Automation& Object::automation()
+    {
+        assert(m_mutex.haveLock());
+
+        if (! m_automation) throw RuntimeError(makeString(*this, " does not support automation"));
+
+        return *m_automation;
+    }
+
+    /**
+     * @brief Queue a timestamped property change for the Object to apply inside of process().
+     * @return false if the automation queue is full.
+     *
+     * This does not require the Object lock and never blocks so it is safe to call from any
+     * thread as long as the Object has been configured.
+     */
+    bool Object::automate(const AutomationEvent& event)
+    {
+        if (! m_automation) throw RuntimeError(makeString(*this, " does not support automation"));
+
+        return m_automation->push(event);
+    }
+
     void Object::start()
     {
         assert(m_mutex.haveLock());
@@ -474,7 +670,11 @@ namespace Clypsalot
         }
     }
 
-    ObjectProcessResult Object::execute()
+    /*
+     * When process() finishes the Object is left in the executing state so the scheduler can
+     * notify the neighbours before anything is able to pause the Object and change its links.
+     */
+    ObjectProcessResult Object::_execute()
     {
         assert(haveLock());
 
@@ -482,7 +682,8 @@ namespace Clypsalot
         {
             state(ObjectState::executing);
 
-            if (endOfData())
+            // Whatever was delivered before the end of the data is processed first.
+            if (endOfData() && ! portsReady())
             {
                 OBJECT_LOGGER(trace, "Got end of data from an input port");
                 handleEndOfData();
@@ -494,11 +695,11 @@ namespace Clypsalot
             switch (result)
             {
                 case ObjectProcessResult::finished:
-                    state(ObjectState::waiting);
                     return ObjectProcessResult::finished;
 
                 case ObjectProcessResult::blocked:
-                    FATAL_ERROR("Blocked state is not yet implemented");
+                    OBJECT_LOGGER(trace, "Blocked in process()");
+                    return ObjectProcessResult::blocked;
 
                 case ObjectProcessResult::endOfData:
                     OBJECT_LOGGER(trace, "Got end of data from process()");
@@ -519,6 +720,28 @@ namespace Clypsalot
         FATAL_ERROR("Should never reach this point");
     }
 
+    ObjectProcessResult Object::execute()
+    {
+        assert(haveLock());
+
+        const auto result = _execute();
+
+        if (result != ObjectProcessResult::endOfData)
+        {
+            try
+            {
+                state(ObjectState::waiting);
+            }
+            catch (const std::exception& e)
+            {
+                fault(e.what());
+                throw;
+            }
+        }
+
+        return result;
+    }
+
     void Object::pause()
     {
         assert(m_mutex.haveLock());
@@ -954,35 +1177,142 @@ namespace Clypsalot
     // the job sits in the queue and is processing.
     void scheduleObject(const SharedObject object)
     {
-        assert(object->haveLock());
+        scheduleObject(*object);
+    }
 
-        object->schedule();
+    /**
+     * @brief Schedule the Object for execution in the thread queue.
+     *
+     * The job only holds a pointer to the Object which keeps it small enough to not need any
+     * memory allocated. This is safe because an Object that is scheduled or executing can not
+     * be paused, unlinked or destroyed until it is waiting again.
+     */
+    void scheduleObject(Object& object)
+    {
+        assert(object.haveLock());
+
+        object.schedule();
+
+        const auto scheduled = &object;
 
-        threadQueuePost([object]
+        threadQueuePost([scheduled]
         {
-            LOGGER(trace, "Executing ", *object, " from inside the thread queue.");
+            Object::executeScheduled(*scheduled);
+        });
+    }
 
-            std::unique_lock lock(*object);
-            const auto result = object->execute();
+    /**
+     * @brief Schedule the Object if it is ready or have it checked again once it is done executing.
+     *
+     * This is how something outside of the scheduler such as a completed IoRequest resumes an
+     * Object that is waiting on it. The Object must be locked.
+     */
+    void wakeObject(Object& object)
+    {
+        assert(object.haveLock());
 
-            if (result == ObjectProcessResult::blocked)
-            {
-                return;
-            }
+        if (object.m_state == ObjectState::executing)
+        {
+            object.m_recheckReady = true;
+        }
+        else if (object.ready())
+        {
+            scheduleObject(object);
+        }
+    }
+
+    /*
+     * The steady state path through here does not allocate memory or change any reference
+     * counts. After process() finishes the Object stays in the executing state while the
+     * neighbours are checked which keeps the neighbours and the list of them valid without
+     * holding the lock of this Object. Neighbours are only try locked during that time because
+     * another thread could be holding a neighbour lock while it waits for this Object to stop
+     * executing. Those neighbours get checked after this Object is waiting again. The list of
+     * them is reserved the first time a thread executes an Object.
+     */
+    void Object::executeScheduled(Object& object)
+    {
+        thread_local std::vector<SharedObject> deferred;
+        std::unique_lock lock(object);
+
+        if (deferred.capacity() == 0) deferred.reserve(16);
+
+        LOGGER(trace, "Executing ", object, " from inside the thread queue.");
+
+        object.m_recheckReady = false;
+
+        const auto result = object._execute();
+
+        // Processing the last of the data leaves the end of the data to handle and nothing else
+        // is going to wake the Object for that.
+        if (result == ObjectProcessResult::finished && object.endOfData()) object.m_recheckReady = true;
+
+        // Nothing was consumed or produced so there is no reason to check the neighbours. The
+        // Object is woken up by whatever it is blocked on.
+        if (result == ObjectProcessResult::blocked)
+        {
+            object.state(ObjectState::waiting);
+            return;
+        }
 
-            auto checkObjects = object->linkedObjects();
+        if (result == ObjectProcessResult::endOfData)
+        {
+            // The Object is shutdown so nothing stops the neighbours from being unlinked once
+            // the lock is released.
+            auto checkObjects = object.linkedObjects();
             lock.unlock();
 
             for (const auto& check : checkObjects)
             {
                 std::scoped_lock checkLock(*check);
 
-                if (check->ready())
-                {
-                    scheduleObject(check);
-                }
+                wakeObject(*check);
             }
-        });
+
+            return;
+        }
+
+        lock.unlock();
+
+        for (const auto neighbour : object.m_neighbours)
+        {
+            std::unique_lock checkLock(*neighbour, std::try_to_lock);
+
+            if (! checkLock.owns_lock())
+            {
+                if (auto shared = neighbour->weak_from_this().lock()) deferred.push_back(std::move(shared));
+                continue;
+            }
+
+            wakeObject(*neighbour);
+        }
+
+        lock.lock();
+        object.state(ObjectState::waiting);
+
+        if (deferred.empty())
+        {
+            if (object.m_recheckReady && object.ready()) scheduleObject(object);
+            return;
+        }
+
+        const auto self = object.weak_from_this().lock();
+        lock.unlock();
+
+        for (const auto& check : deferred)
+        {
+            std::scoped_lock checkLock(*check);
+
+            wakeObject(*check);
+        }
+
+        deferred.clear();
+
+        if (self)
+        {
+            std::scoped_lock selfLock(*self);
+            if (self->m_recheckReady && self->ready()) scheduleObject(*self);
+        }
     }
 
     bool stopObject(const SharedObject& object)
@@ -20,6 +20,7 @@
 
 #include <clypsalot/event.hxx>
 #include <clypsalot/forward.hxx>
+#include <clypsalot/property.hxx>
 
 /// @file
 namespace Clypsalot
@@ -77,6 +78,10 @@ namespace Clypsalot
 
     class Object : public Lockable, public Eventful, public std::enable_shared_from_this<Object>
     {
+        friend Port;
+        friend void scheduleObject(Object& object);
+        friend void wakeObject(Object& object);
+
         public:
         using Id = std::size_t;
 
@@ -84,9 +89,18 @@ namespace Clypsalot
         const Id m_id;
         const std::string& m_kind;
         ObjectState m_state = ObjectState::initializing;
+        std::vector<Property*> m_propertyHandles;
+        std::unique_ptr<Automation> m_automation;
+        std::vector<PortLink*> m_links;
+        std::vector<Object*> m_neighbours;
+        bool m_recheckReady = false;
 
+        static void executeScheduled(Object& object);
         void state(const ObjectState newState);
         void shutdown();
+        void updateLinks() noexcept;
+        ObjectProcessResult _execute();
+        void configure(const ObjectConfig& config, const PropertyValues& values);
 
         protected:
         std::condition_variable_any m_condVar;
@@ -97,14 +111,19 @@ namespace Clypsalot
         std::map<std::string, bool> m_userInputPortTypes;
 
         bool endOfData() const noexcept;
+        bool portsReady() const noexcept;
         void fault(const std::string& message) noexcept;
         virtual ObjectProcessResult process() = 0;
         virtual void handleInit(const ObjectConfig& config);
         virtual void handleConfigure(const ObjectConfig& config);
         virtual void handleEndOfData() noexcept;
+        virtual void handleLinked(const PortLink& in_link);
         Property& addProperty(const PropertyConfig& config);
         void addProperties(const PropertyList& list);
         size_t& propertySizeRef(const std::string& name);
+        float& propertyRealRef(const std::string& name);
+        void enableAutomation(const size_t capacity);
+        Automation& automation();
         OutputPort& addOutput(OutputPort* output);
         InputPort& addInput(InputPort* input);
 
@@ -150,14 +169,21 @@ namespace Clypsalot
         const std::string& kind() const noexcept;
         ObjectState state() const noexcept;
         virtual bool ready() const noexcept;
-        std::vector<PortLink*> links() const noexcept;
+        const std::vector<PortLink*>& links() const noexcept;
+        const std::vector<Object*>& neighbours() const noexcept;
         std::vector<SharedObject> linkedObjects() const noexcept;
         const std::map<std::string, Property>& properties() const noexcept;
         bool hasProperty(const std::string& name) const noexcept;
         Property& property(const std::string& name);
+        Property::Handle propertyHandle(const std::string& name) const;
+        Property& property(const Property::Handle handle);
+        void applyProperties(const PropertyValues& values);
+        bool automate(const AutomationEvent& event);
         void wait(const std::function<bool ()> tester);
         void init(const ObjectConfig& config = {});
         void configure(const ObjectConfig& config = {});
+        void configure(const PropertyValues& values);
+        PropertyValues compileConfig(const ObjectConfig& config) const;
         void start();
         void schedule();
         ObjectProcessResult execute();
@@ -225,6 +251,8 @@ namespace Clypsalot
             for (const auto& linked : linkedObjects)
             {
                 locks.emplace_back(*linked);
+                // The scheduler reads the links of an executing Object with out holding its lock.
+                linked->wait([&linked] { return linked->state() != ObjectState::executing; });
             }
 
             unlinkPorts(ports);
@@ -256,6 +284,8 @@ namespace Clypsalot
     bool pauseObject(const SharedObject& object);
     bool startObject(const SharedObject& object);
     void scheduleObject(const SharedObject object);
+    void scheduleObject(Object& object);
+    void wakeObject(Object& object);
     bool stopObject(const SharedObject& object);
     bool validateStateChange(const ObjectState oldState, const ObjectState newState) noexcept;
     std::string formatStateChange(const ObjectState oldState, const ObjectState newState) noexcept;
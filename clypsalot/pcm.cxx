@@ -0,0 +1,1509 @@
+/* Copyright 2023 Tyler Riddle
+ *
+ * This file is part of Clypsalot. Clypsalot is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU Lesser General Public License as published by the Free Software Foundation, either version 3 of the License,
+ * or (at your option) any later version. Clypsalot is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along with Clypsalot. If not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <utility>
+
+#include <clypsalot/capture.hxx>
+#include <clypsalot/convert.hxx>
+#include <clypsalot/error.hxx>
+#include <clypsalot/macros.hxx>
+#include <clypsalot/mix.hxx>
+#include <clypsalot/object.hxx>
+#include <clypsalot/pcm.hxx>
+#include <clypsalot/resample.hxx>
+#include <clypsalot/transpose.hxx>
+#include <clypsalot/util.hxx>
+
+/// @file
+namespace Clypsalot
+{
+    const std::string PcmPortType::typeName = "pcm";
+    const PcmPortType PcmPortType::singleton = PcmPortType();
+
+    [[noreturn]] static void pcmLinkedError(const Port& in_port)
+    {
+        throw RuntimeError(makeString("Can not change the settings of a linked PCM port: ", in_port.name()));
+    }
+
+    static std::size_t negotiate(const char* in_what, const std::size_t in_output, const std::size_t in_input)
+    {
+        if (in_output != 0 && in_input != 0 && in_output != in_input)
+        {
+            throw ValueError(makeString("PCM ports do not agree on the ", in_what, ": ", in_output, " != ", in_input));
+        }
+
+        const auto value = in_output ? in_output : in_input;
+
+        if (value == 0) throw ValueError(makeString("Neither PCM port sets the ", in_what));
+
+        return value;
+    }
+
+    static void pcmMatrixRangeError(const std::size_t in_output, const std::size_t in_input)
+    {
+        throw ValueError(makeString("PCM matrix has no gain for output ", in_output, " and input ", in_input));
+    }
+
+    PcmMatrix PcmMatrix::identity(const std::size_t in_channels)
+    {
+        PcmMatrix matrix(in_channels, in_channels);
+
+        for (std::size_t channel = 0; channel < in_channels; channel++)
+        {
+            matrix.gain(channel, channel, 1);
+        }
+
+        return matrix;
+    }
+
+    /**
+     * @brief The matrix used for a link when the input does not give one.
+     *
+     * Mono is copied to every output and every input is averaged into a mono output. 5.1 in the
+     * order L R C LFE Ls Rs is folded down to stereo with the center and surrounds at -3 dB and
+     * the LFE dropped. Any other pair of counts maps each channel to the channel with the same
+     * index and drops or silences the rest.
+     */
+    PcmMatrix PcmMatrix::standard(const std::size_t in_inputs, const std::size_t in_outputs)
+    {
+        PcmMatrix matrix(in_inputs, in_outputs);
+
+        if (in_inputs == 1)
+        {
+            for (std::size_t output = 0; output < in_outputs; output++)
+            {
+                matrix.gain(output, 0, 1);
+            }
+        }
+        else if (in_outputs == 1)
+        {
+            for (std::size_t input = 0; input < in_inputs; input++)
+            {
+                matrix.gain(0, input, 1.0f / in_inputs);
+            }
+        }
+        else if (in_inputs == 6 && in_outputs == 2)
+        {
+            constexpr float minus3dB = 0.70710678f;
+
+            matrix.gain(0, 0, 1);
+            matrix.gain(0, 2, minus3dB);
+            matrix.gain(0, 4, minus3dB);
+            matrix.gain(1, 1, 1);
+            matrix.gain(1, 2, minus3dB);
+            matrix.gain(1, 5, minus3dB);
+        }
+        else
+        {
+            for (std::size_t channel = 0; channel < std::min(in_inputs, in_outputs); channel++)
+            {
+                matrix.gain(channel, channel, 1);
+            }
+        }
+
+        return matrix;
+    }
+
+    /// @brief Create a matrix with every gain set to 0.
+    PcmMatrix::PcmMatrix(const std::size_t in_inputs, const std::size_t in_outputs) :
+        m_inputs(in_inputs),
+        m_outputs(in_outputs),
+        m_gains(in_inputs * in_outputs, 0.0f)
+    { }
+
+    bool PcmMatrix::empty() const noexcept
+    {
+        return m_gains.empty();
+    }
+
+    std::size_t PcmMatrix::inputs() const noexcept
+    {
+        return m_inputs;
+    }
+
+    std::size_t PcmMatrix::outputs() const noexcept
+    {
+        return m_outputs;
+    }
+
+    /// @throws ValueError if either channel is out of range.
+    float PcmMatrix::gain(const std::size_t in_output, const std::size_t in_input) const
+    {
+        if (in_output >= m_outputs || in_input >= m_inputs) pcmMatrixRangeError(in_output, in_input);
+
+        return m_gains[in_output * m_inputs + in_input];
+    }
+
+    /// @throws ValueError if either channel is out of range.
+    void PcmMatrix::gain(const std::size_t in_output, const std::size_t in_input, const float in_gain)
+    {
+        if (in_output >= m_outputs || in_input >= m_inputs) pcmMatrixRangeError(in_output, in_input);
+
+        m_gains[in_output * m_inputs + in_input] = in_gain;
+    }
+
+    /// @brief The gains from every input into one output.
+    const float* PcmMatrix::row(const std::size_t in_output) const noexcept
+    {
+        assert(in_output < m_outputs);
+
+        return m_gains.data() + in_output * m_inputs;
+    }
+
+    bool PcmMatrix::isIdentity() const noexcept
+    {
+        return *this == identity(m_inputs);
+    }
+
+    static std::size_t pcmPoolCapacity(const PcmConfig& in_config) noexcept
+    {
+        // Every link can hold depth blocks which all come from the same pool.
+        return std::max(PcmBufferPool::defaultCapacity, in_config.depth * 2 + 2);
+    }
+
+    /// @brief The number of bytes a buffer with the given settings needs for its samples.
+    std::size_t PcmBuffer::storageBytes(const PcmFormat in_format, const std::size_t in_channels, const std::size_t in_frames, const PcmLayout in_layout) noexcept
+    {
+        const auto sampleSize = pcmSampleSize(in_format);
+        const auto alignedSamples = pcmAlignment / sampleSize;
+        const auto stride = (in_frames + alignedSamples - 1) / alignedSamples * alignedSamples;
+        const auto lanes = pcmLanes(in_layout);
+        const auto channels = (in_channels + lanes - 1) / lanes * lanes;
+
+        return channels * stride * sampleSize;
+    }
+
+    PcmBuffer::PcmBuffer(const PcmFormat in_format, const std::size_t in_channels, const std::size_t in_frames, const PcmLayout in_layout) :
+        PcmBuffer(in_format, in_channels, in_frames, nullptr, in_layout)
+    {
+        if (bytes() == 0) return;
+
+        m_data = static_cast<std::byte*>(::operator new(bytes(), std::align_val_t(pcmAlignment)));
+        m_owner = true;
+        clear();
+    }
+
+    /**
+     * @brief Place a buffer in storage that is not owned by the buffer.
+     *
+     * The storage must be aligned to pcmAlignment, hold at least storageBytes() bytes and outlive
+     * the buffer. It is not cleared.
+     */
+    PcmBuffer::PcmBuffer(const PcmFormat in_format, const std::size_t in_channels, const std::size_t in_frames, std::byte* in_storage, const PcmLayout in_layout) noexcept :
+        m_format(in_format),
+        m_channels(in_channels),
+        m_frames(in_frames),
+        m_layout(in_layout),
+        m_data(in_storage)
+    {
+        const auto alignedSamples = pcmAlignment / pcmSampleSize(m_format);
+
+        assert(reinterpret_cast<std::uintptr_t>(in_storage) % pcmAlignment == 0);
+
+        m_stride = (m_frames + alignedSamples - 1) / alignedSamples * alignedSamples;
+    }
+
+    PcmBuffer::PcmBuffer(PcmBuffer&& in_other) noexcept
+    {
+        *this = std::move(in_other);
+    }
+
+    PcmBuffer::~PcmBuffer() noexcept
+    {
+        if (m_owner) ::operator delete(m_data, std::align_val_t(pcmAlignment));
+    }
+
+    PcmBuffer& PcmBuffer::operator=(PcmBuffer&& in_other) noexcept
+    {
+        std::swap(m_format, in_other.m_format);
+        std::swap(m_channels, in_other.m_channels);
+        std::swap(m_frames, in_other.m_frames);
+        std::swap(m_stride, in_other.m_stride);
+        std::swap(m_layout, in_other.m_layout);
+        std::swap(m_data, in_other.m_data);
+        std::swap(m_owner, in_other.m_owner);
+
+        return *this;
+    }
+
+    PcmFormat PcmBuffer::format() const noexcept
+    {
+        return m_format;
+    }
+
+    std::size_t PcmBuffer::channels() const noexcept
+    {
+        return m_channels;
+    }
+
+    /// @brief The number of frames the buffer was allocated to hold.
+    std::size_t PcmBuffer::frames() const noexcept
+    {
+        return m_frames;
+    }
+
+    /// @brief The distance in samples between the start of each channel of a planar buffer. A
+    /// group of a grouped buffer is lanes() times as long.
+    std::size_t PcmBuffer::stride() const noexcept
+    {
+        return m_stride;
+    }
+
+    PcmLayout PcmBuffer::layout() const noexcept
+    {
+        return m_layout;
+    }
+
+    /// @brief The number of channels interleaved in each group or 1 for a planar buffer.
+    std::size_t PcmBuffer::lanes() const noexcept
+    {
+        return pcmLanes(m_layout);
+    }
+
+    /// @brief The number of groups including a partly filled last group or the number of
+    /// channels for a planar buffer.
+    std::size_t PcmBuffer::groups() const noexcept
+    {
+        return (m_channels + lanes() - 1) / lanes();
+    }
+
+    // Both layouts are a series of aligned rows which are channels in a planar buffer and groups
+    // in a grouped one.
+    std::size_t PcmBuffer::rows() const noexcept
+    {
+        return groups();
+    }
+
+    std::size_t PcmBuffer::rowSamples() const noexcept
+    {
+        return m_stride * lanes();
+    }
+
+    std::size_t PcmBuffer::bytes() const noexcept
+    {
+        return rows() * rowSamples() * pcmSampleSize(m_format);
+    }
+
+    void PcmBuffer::clear() noexcept
+    {
+        if (m_data != nullptr) std::memset(m_data, 0, bytes());
+    }
+
+    /// @brief Copy the first frames of every channel from a buffer with the same format, channels
+    /// and layout.
+    void PcmBuffer::copy(const PcmBuffer& in_source, const std::size_t in_frames) noexcept
+    {
+        assert(in_source.m_format == m_format);
+        assert(in_source.m_channels == m_channels);
+        assert(in_source.m_layout == m_layout);
+        assert(in_frames <= m_frames && in_frames <= in_source.m_frames);
+
+        const auto sampleSize = pcmSampleSize(m_format);
+        const auto rowBytes = rowSamples() * sampleSize;
+        const auto sourceRowBytes = in_source.rowSamples() * sampleSize;
+
+        for (std::size_t row = 0; row < rows(); row++)
+        {
+            std::memcpy(m_data + row * rowBytes, in_source.m_data + row * sourceRowBytes, in_frames * lanes() * sampleSize);
+        }
+    }
+
+    /// @brief Allocate a new buffer with the same settings and a copy of all the samples.
+    PcmBuffer PcmBuffer::clone() const
+    {
+        PcmBuffer buffer(m_format, m_channels, m_frames, m_layout);
+
+        if (m_data != nullptr) std::memcpy(buffer.m_data, m_data, bytes());
+
+        return buffer;
+    }
+
+    std::byte* PcmBuffer::channelData(const std::size_t in_channel) noexcept
+    {
+        assert(m_layout == PcmLayout::planar);
+        assert(in_channel < m_channels);
+
+        return m_data + in_channel * m_stride * pcmSampleSize(m_format);
+    }
+
+    const std::byte* PcmBuffer::channelData(const std::size_t in_channel) const noexcept
+    {
+        assert(m_layout == PcmLayout::planar);
+        assert(in_channel < m_channels);
+
+        return m_data + in_channel * m_stride * pcmSampleSize(m_format);
+    }
+
+    std::byte* PcmBuffer::groupData(const std::size_t in_group) noexcept
+    {
+        assert(m_layout != PcmLayout::planar);
+        assert(in_group < groups());
+
+        return m_data + in_group * rowSamples() * pcmSampleSize(m_format);
+    }
+
+    const std::byte* PcmBuffer::groupData(const std::size_t in_group) const noexcept
+    {
+        assert(m_layout != PcmLayout::planar);
+        assert(in_group < groups());
+
+        return m_data + in_group * rowSamples() * pcmSampleSize(m_format);
+    }
+
+    SharedPcmBuffer::SharedPcmBuffer(PcmBlock* in_block) noexcept :
+        m_block(in_block)
+    {
+        if (m_block != nullptr) m_block->references.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    SharedPcmBuffer::SharedPcmBuffer(const SharedPcmBuffer& in_other) noexcept :
+        SharedPcmBuffer(in_other.m_block)
+    { }
+
+    SharedPcmBuffer::SharedPcmBuffer(SharedPcmBuffer&& in_other) noexcept :
+        m_block(std::exchange(in_other.m_block, nullptr))
+    { }
+
+    SharedPcmBuffer::~SharedPcmBuffer() noexcept
+    {
+        reset();
+    }
+
+    SharedPcmBuffer& SharedPcmBuffer::operator=(const SharedPcmBuffer& in_other) noexcept
+    {
+        if (m_block != in_other.m_block) *this = SharedPcmBuffer(in_other);
+        return *this;
+    }
+
+    SharedPcmBuffer& SharedPcmBuffer::operator=(SharedPcmBuffer&& in_other) noexcept
+    {
+        if (this != &in_other)
+        {
+            reset();
+            m_block = std::exchange(in_other.m_block, nullptr);
+        }
+
+        return *this;
+    }
+
+    SharedPcmBuffer::operator bool() const noexcept
+    {
+        return m_block != nullptr;
+    }
+
+    const PcmBuffer& SharedPcmBuffer::operator*() const noexcept
+    {
+        return buffer();
+    }
+
+    const PcmBuffer* SharedPcmBuffer::operator->() const noexcept
+    {
+        return &buffer();
+    }
+
+    const PcmBuffer& SharedPcmBuffer::buffer() const noexcept
+    {
+        assert(m_block != nullptr);
+
+        return m_block->buffer;
+    }
+
+    /// @brief Write access to the samples which is only allowed while this is the only handle.
+    PcmBuffer& SharedPcmBuffer::writable() noexcept
+    {
+        assert(useCount() == 1);
+        assert(! borrowed());
+
+        return m_block->buffer;
+    }
+
+    /// @brief The number of valid frames in the block.
+    std::size_t SharedPcmBuffer::frames() const noexcept
+    {
+        assert(m_block != nullptr);
+
+        return m_block->frames;
+    }
+
+    void SharedPcmBuffer::frames(const std::size_t in_frames) noexcept
+    {
+        assert(useCount() == 1);
+        assert(in_frames <= m_block->buffer.frames());
+
+        m_block->frames = in_frames;
+    }
+
+    /**
+     * @brief True if the producer said every sample of the valid frames is zero.
+     *
+     * The samples are still there so a consumer that does not look at the flag gets the right
+     * result. A consumer that does can skip the work it would do on silence.
+     */
+    bool SharedPcmBuffer::silent() const noexcept
+    {
+        assert(m_block != nullptr);
+
+        return m_block->silent;
+    }
+
+    void SharedPcmBuffer::silent(const bool in_silent) noexcept
+    {
+        assert(useCount() == 1);
+
+        m_block->silent = in_silent;
+    }
+
+    long SharedPcmBuffer::useCount() const noexcept
+    {
+        if (m_block == nullptr) return 0;
+        return m_block->references.load(std::memory_order_acquire);
+    }
+
+    /// @brief True if the samples belong to something other than the pool of the block.
+    bool SharedPcmBuffer::borrowed() const noexcept
+    {
+        return m_block != nullptr && m_block->owner != nullptr;
+    }
+
+    bool SharedPcmBuffer::shares(const SharedPcmBuffer& in_other) const noexcept
+    {
+        return m_block != nullptr && m_block == in_other.m_block;
+    }
+
+    PcmBuffer SharedPcmBuffer::clone() const
+    {
+        return buffer().clone();
+    }
+
+    void SharedPcmBuffer::reset() noexcept
+    {
+        const auto block = std::exchange(m_block, nullptr);
+
+        if (block == nullptr) return;
+        if (block->references.fetch_sub(1, std::memory_order_acq_rel) != 1) return;
+
+        // The block holds the only guaranteed reference to the pool so it has to be moved out
+        // before the block is handed back.
+        const auto pool = std::move(block->pool);
+        pool->recycle(block);
+    }
+
+    std::shared_ptr<PcmBufferPool> PcmBufferPool::make(const PcmConfig& in_config, const std::size_t in_capacity)
+    {
+        return std::make_shared<PcmBufferPool>(in_config, in_capacity);
+    }
+
+    /**
+     * @brief Create a pool and the storage for every block it can hold.
+     * @throws RuntimeError if the memory for the blocks can not be mapped.
+     */
+    PcmBufferPool::PcmBufferPool(const PcmConfig& in_config, const std::size_t in_capacity) :
+        m_config(in_config),
+        m_free(in_capacity),
+        m_blocks(new PcmBlock[m_free.capacity()])
+    {
+        const auto blockBytes = PcmBuffer::storageBytes(m_config.format, m_config.channels, m_config.blockSize, m_config.layout);
+
+        m_memory = PageMapping(blockBytes * capacity());
+
+        for (std::size_t i = 0; i < capacity(); i++)
+        {
+            auto& block = m_blocks[i];
+
+            block.buffer = PcmBuffer(m_config.format, m_config.channels, m_config.blockSize, m_memory.data() + i * blockBytes, m_config.layout);
+            m_free.push(&block);
+        }
+    }
+
+    void PcmBufferPool::recycle(PcmBlock* in_block) noexcept
+    {
+        in_block->frames = 0;
+        in_block->silent = false;
+
+        if (in_block->owner)
+        {
+            const auto blockBytes = PcmBuffer::storageBytes(m_config.format, m_config.channels, m_config.blockSize, m_config.layout);
+            const auto storage = m_memory.data() + (in_block - m_blocks.get()) * blockBytes;
+
+            in_block->buffer = PcmBuffer(m_config.format, m_config.channels, m_config.blockSize, storage, m_config.layout);
+            in_block->owner.reset();
+        }
+
+        m_inFlight.fetch_sub(1, std::memory_order_relaxed);
+
+        if (! m_free.push(in_block)) FATAL_ERROR("PCM buffer pool free list overflowed");
+    }
+
+    const PcmConfig& PcmBufferPool::config() const noexcept
+    {
+        return m_config;
+    }
+
+    /// @brief The largest number of blocks that can be in flight at once.
+    std::size_t PcmBufferPool::capacity() const noexcept
+    {
+        return m_free.capacity();
+    }
+
+    /// @brief The number of blocks that are not in flight.
+    std::size_t PcmBufferPool::available() const noexcept
+    {
+        return m_free.size();
+    }
+
+    /// @brief The number of blocks that have been acquired and not yet released.
+    std::size_t PcmBufferPool::inFlight() const noexcept
+    {
+        return m_inFlight.load(std::memory_order_relaxed);
+    }
+
+    /// @brief The largest number of blocks that have been in flight at once.
+    std::size_t PcmBufferPool::highWater() const noexcept
+    {
+        return m_highWater.load(std::memory_order_relaxed);
+    }
+
+    /// @brief The mapping that holds the samples of every block.
+    const PageMapping& PcmBufferPool::memory() const noexcept
+    {
+        return m_memory;
+    }
+
+    /**
+     * @brief Take a block out of the pool for writing.
+     * @throws RuntimeError if every block the pool can hold is already in flight.
+     */
+    SharedPcmBuffer PcmBufferPool::acquire()
+    {
+        auto block = tryAcquire();
+
+        if (! block) throw RuntimeError(makeString("PCM buffer pool is exhausted; capacity=", capacity()));
+
+        return block;
+    }
+
+    /// @brief Take a block out of the pool for writing or get an empty handle if every block is
+    /// in flight.
+    SharedPcmBuffer PcmBufferPool::tryAcquire() noexcept
+    {
+        PcmBlock* block = nullptr;
+
+        if (! m_free.pop(block)) return SharedPcmBuffer();
+
+        const auto inFlight = m_inFlight.fetch_add(1, std::memory_order_relaxed) + 1;
+        auto highWater = m_highWater.load(std::memory_order_relaxed);
+
+        while (inFlight > highWater && ! m_highWater.compare_exchange_weak(highWater, inFlight, std::memory_order_relaxed));
+
+        block->pool = shared_from_this();
+
+        return SharedPcmBuffer(block);
+    }
+
+    /**
+     * @brief Take a block out of the pool that points at samples stored somewhere else or get an
+     * empty handle if every block is in flight.
+     * @param in_storage Samples laid out the way a buffer with the settings of the pool would
+     * lay them out. It must be aligned to pcmAlignment.
+     * @param in_owner Keeps the storage alive until the block goes back to the pool.
+     *
+     * Borrowed blocks are read only so they are never handed to an output in place.
+     */
+    SharedPcmBuffer PcmBufferPool::tryBorrow(const std::byte* in_storage, std::shared_ptr<const void> in_owner) noexcept
+    {
+        auto block = tryAcquire();
+
+        if (! block) return block;
+
+        auto& inner = *block.m_block;
+
+        // The storage is never written through the buffer because writable() refuses borrowed
+        // blocks.
+        inner.buffer = PcmBuffer(m_config.format, m_config.channels, m_config.blockSize, const_cast<std::byte*>(in_storage), m_config.layout);
+        inner.owner = std::move(in_owner);
+
+        return block;
+    }
+
+    PcmPortType::PcmPortType() :
+        PortType(typeName)
+    { }
+
+    /**
+     * @brief Negotiate the link settings and create the link.
+     * @throws TypeError if either port is not a PCM port.
+     * @throws ValueError if the ports want different block sizes, if neither port sets the
+     * channel count or block size or if the input has a matrix that does not fit the channels.
+     * @throws RuntimeError if the input port already has a link.
+     *
+     * An output that already has links must keep the settings of those links so the same block
+     * can be delivered to every input. When the input wants a different channel count, rate or
+     * sample format than the output the link mixes, resamples or converts the blocks and when it
+     * wants a different layout the link transposes them.
+     */
+    PortLink* PcmPortType::makeLink(OutputPort& from, InputPort& to) const
+    {
+        auto output = dynamic_cast<PcmOutputPort*>(&from);
+        auto input = dynamic_cast<PcmInputPort*>(&to);
+
+        if (output == nullptr || input == nullptr)
+        {
+            throw TypeError("Incompatible port types when creating a link");
+        }
+
+        if (input->links().size() > 0)
+        {
+            throw RuntimeError(makeString("PCM input port can only have one link: ", input->name()));
+        }
+
+        auto outputConfig = output->m_config;
+
+        if (output->links().size() > 0)
+        {
+            outputConfig = dynamic_cast<const PcmPortLink*>(output->links().front())->config();
+        }
+
+        const auto& inputConfig = input->config();
+        PcmConfig config;
+
+        config.format = outputConfig.format;
+        config.channels = outputConfig.channels ? outputConfig.channels : inputConfig.channels;
+
+        if (config.channels == 0) throw ValueError("Neither PCM port sets the channel count");
+
+        config.blockSize = negotiate("block size", outputConfig.blockSize, inputConfig.blockSize);
+        config.depth = std::max({ outputConfig.depth, inputConfig.depth, static_cast<std::size_t>(1) });
+        config.rate = outputConfig.rate ? outputConfig.rate : inputConfig.rate;
+        config.layout = outputConfig.layout;
+
+        if (! output->m_pool || output->m_pool->config() != config)
+        {
+            output->m_pending.reset();
+            output->m_pool = PcmBufferPool::make(config, pcmPoolCapacity(config));
+        }
+
+        auto link = std::make_unique<PcmPortLink>(*output, *input, config);
+
+        // The link is not one of the links of the output yet so the blocks it holds are added
+        // to what the existing links hold when the pool is sized.
+        for (const auto port : input->parent().outputs())
+        {
+            const auto pcmOutput = dynamic_cast<const PcmOutputPort*>(port);
+
+            if (pcmOutput != nullptr && pcmOutput->m_inPlace == input) link->inPlaceBlocks(pcmOutput->chainBlocks());
+        }
+
+        std::vector<const PcmOutputPort*> visited;
+
+        output->sizePool(config.depth + 2 + link->inPlaceBlocks(), visited);
+
+        return link.release();
+    }
+
+    /**
+     * @param in_config The settings of the blocks the output delivers.
+     * @throws ValueError if the matrix of the input does not fit the channels or if the rates
+     * need a resampler with too many phases.
+     *
+     * The channel count, sample format, rate, layout, dither, matrix and resampler quality of the
+     * input port decide what the link does to the blocks. Mixing and resampling are done in
+     * planar float32 so other formats are converted on the way in and out and grouped blocks are
+     * transposed on the way in and out. The channels are mixed before they are resampled.
+     */
+    PcmPortLink::PcmPortLink(PcmOutputPort& in_from, PcmInputPort& in_to, const PcmConfig& in_config) :
+        RingPortLink(in_from, in_to, in_config.depth),
+        m_config(in_config),
+        m_inputConfig(in_config)
+    {
+        const auto& wanted = in_to.config();
+        const auto resample = m_config.rate != 0 && wanted.rate != 0 && wanted.rate != m_config.rate;
+
+        m_inputConfig.format = wanted.format;
+        m_inputConfig.layout = wanted.layout;
+        if (wanted.channels != 0) m_inputConfig.channels = wanted.channels;
+        if (wanted.rate != 0) m_inputConfig.rate = wanted.rate;
+
+        m_matrix = in_to.matrix();
+
+        if (m_matrix.empty() && m_inputConfig.channels != m_config.channels)
+        {
+            m_matrix = PcmMatrix::standard(m_config.channels, m_inputConfig.channels);
+        }
+
+        if (! m_matrix.empty() && (m_matrix.inputs() != m_config.channels || m_matrix.outputs() != m_inputConfig.channels))
+        {
+            throw ValueError(makeString("PCM link matrix must be ", m_inputConfig.channels, "x", m_config.channels, ": ", in_to.name()));
+        }
+
+        auto format = m_config.format;
+        auto layout = m_config.layout;
+
+        if ((! m_matrix.empty() || resample || format != m_inputConfig.format) && layout != PcmLayout::planar)
+        {
+            m_unpacker = std::make_unique<PcmTransposer>(format, layout, PcmLayout::planar);
+            m_unpacked = PcmBuffer(format, m_config.channels, m_config.blockSize);
+            layout = PcmLayout::planar;
+        }
+
+        const auto pack = layout != m_inputConfig.layout;
+
+        if ((! m_matrix.empty() || resample) && format != PcmFormat::float32)
+        {
+            m_sourceConverter = std::make_unique<PcmConverter>(format, PcmFormat::float32);
+            m_sourceScratch = PcmBuffer(PcmFormat::float32, m_config.channels, m_config.blockSize);
+            format = PcmFormat::float32;
+        }
+
+        if (! m_matrix.empty())
+        {
+            m_mixer = std::make_unique<PcmMixer>(m_matrix);
+            if (resample || format != m_inputConfig.format || pack) m_mixed = PcmBuffer(PcmFormat::float32, m_inputConfig.channels, m_config.blockSize);
+        }
+
+        if (resample)
+        {
+            m_resampler = std::make_unique<PcmResampler>(m_config.rate, m_inputConfig.rate, m_inputConfig.channels, m_config.blockSize, in_to.resamplerQuality());
+            m_inputConfig.blockSize = m_resampler->maxOutput(m_config.blockSize);
+            if (format != m_inputConfig.format || pack) m_resampled = PcmBuffer(PcmFormat::float32, m_inputConfig.channels, m_inputConfig.blockSize);
+        }
+
+        if (format != m_inputConfig.format)
+        {
+            m_converter = std::make_unique<PcmConverter>(format, m_inputConfig.format, in_to.dither());
+            if (pack) m_converted = PcmBuffer(m_inputConfig.format, m_inputConfig.channels, m_inputConfig.blockSize);
+        }
+
+        if (pack) m_packer = std::make_unique<PcmTransposer>(m_inputConfig.format, layout, m_inputConfig.layout);
+        if (m_mixer || m_resampler || m_converter || m_packer) m_pool = PcmBufferPool::make(m_inputConfig, pcmPoolCapacity(m_inputConfig));
+    }
+
+    PcmPortLink::~PcmPortLink() noexcept = default;
+
+    /// @brief The settings of the blocks delivered by the output.
+    const PcmConfig& PcmPortLink::config() const noexcept
+    {
+        return m_config;
+    }
+
+    /// @brief The settings of the blocks the input receives. The block size is the most frames
+    /// a block can hold.
+    const PcmConfig& PcmPortLink::inputConfig() const noexcept
+    {
+        return m_inputConfig;
+    }
+
+    /// @brief The converter that produces the format of the input or nullptr if there is none.
+    const PcmConverter* PcmPortLink::converter() const noexcept
+    {
+        return m_converter.get();
+    }
+
+    /// @brief The mixer used by the link or nullptr if the channels are passed through.
+    const PcmMixer* PcmPortLink::mixer() const noexcept
+    {
+        return m_mixer.get();
+    }
+
+    /// @brief The resampler used by the link or nullptr if the rates match.
+    const PcmResampler* PcmPortLink::resampler() const noexcept
+    {
+        return m_resampler.get();
+    }
+
+    /// @brief The transposer that produces the layout of the input or nullptr if the layouts
+    /// match.
+    const PcmTransposer* PcmPortLink::transposer() const noexcept
+    {
+        return m_packer.get();
+    }
+
+    /// @brief The most recently set matrix which may not have reached the mixer yet.
+    PcmMatrix PcmPortLink::matrix() const
+    {
+        std::scoped_lock lock(m_matrixMutex);
+        return m_matrix;
+    }
+
+    /**
+     * @brief Change the gains of the mixer.
+     * @throws RuntimeError if the link does not mix.
+     * @throws ValueError if the matrix is a different size than the one the link was made with.
+     *
+     * This is safe to call from any thread. The mixer picks up the new matrix at the start of the
+     * next block it delivers so a block is never mixed with two different matrices.
+     */
+    void PcmPortLink::matrix(const PcmMatrix& in_matrix)
+    {
+        if (! m_mixer) throw RuntimeError("PCM link does not have a mixer");
+
+        std::scoped_lock lock(m_matrixMutex);
+
+        if (in_matrix.inputs() != m_matrix.inputs() || in_matrix.outputs() != m_matrix.outputs())
+        {
+            throw ValueError(makeString("PCM link matrix must be ", m_matrix.outputs(), "x", m_matrix.inputs()));
+        }
+
+        m_matrix = in_matrix;
+        m_matrixChanged.store(true, std::memory_order_release);
+    }
+
+    // The matrix is only copied into the mixer when the lock is free so delivering a block never
+    // waits on a thread that is setting a matrix; the change is picked up by a later block.
+    void PcmPortLink::updateMatrix() noexcept
+    {
+        if (! m_matrixChanged.load(std::memory_order_acquire)) return;
+
+        std::unique_lock lock(m_matrixMutex, std::try_to_lock);
+
+        if (! lock.owns_lock()) return;
+
+        m_mixer->matrix(m_matrix);
+        m_matrixChanged.store(false, std::memory_order_relaxed);
+    }
+
+    /// @brief The delay the link adds in frames at the rate of the input.
+    double PcmPortLink::latency() const noexcept
+    {
+        return m_resampler ? m_resampler->latency() : 0;
+    }
+
+    /**
+     * @brief The most blocks from the output that the objects past the input can hold on to
+     * because they process the input in place.
+     *
+     * Blocks only travel past a link that passes them through so this is 0 when the link
+     * processes them into blocks from a pool of its own.
+     */
+    std::size_t PcmPortLink::inPlaceBlocks() const noexcept
+    {
+        if (m_pool) return 0;
+
+        return m_inPlaceBlocks.load(std::memory_order_relaxed);
+    }
+
+    /// @brief Set when the output the input is processed in place into is linked.
+    void PcmPortLink::inPlaceBlocks(const std::size_t in_blocks) noexcept
+    {
+        m_inPlaceBlocks.store(in_blocks, std::memory_order_relaxed);
+    }
+
+    /// @brief True if the link has room for another block and can process it if needed.
+    bool PcmPortLink::ready() const noexcept
+    {
+        if (full()) return false;
+        return ! m_pool || m_pool->available() > 0;
+    }
+
+    // Captures record the blocks of the output before the link changes them.
+    std::unique_ptr<LinkCapture> PcmPortLink::makeCapture(const std::filesystem::path& in_path, const std::size_t in_ringSize) const
+    {
+        return std::make_unique<LinkCapture>(in_path, CaptureInfo { CaptureKind::pcm, m_config }, in_ringSize);
+    }
+
+    /// @brief Queue a block for the input mixing, resampling, converting and transposing it first
+    /// if needed.
+    void PcmPortLink::deliver(const SharedPcmBuffer& in_block) noexcept
+    {
+        assert(ready());
+
+        if (const auto recording = capture()) recording->record(*in_block, in_block.frames());
+
+        if (! m_pool)
+        {
+            push(in_block);
+            return;
+        }
+
+        auto processed = m_pool->tryAcquire();
+        auto frames = in_block.frames();
+        const PcmBuffer* current = &*in_block;
+
+        assert(processed);
+
+        if (m_unpacker)
+        {
+            m_unpacker->process(*current, m_unpacked, frames);
+            current = &m_unpacked;
+        }
+
+        if (m_sourceConverter)
+        {
+            m_sourceConverter->convert(*current, m_sourceScratch, frames);
+            current = &m_sourceScratch;
+        }
+
+        if (m_mixer)
+        {
+            auto& mixed = m_resampler || m_converter || m_packer ? m_mixed : processed.writable();
+
+            updateMatrix();
+            m_mixer->process(*current, mixed, frames);
+            current = &mixed;
+        }
+
+        if (m_resampler)
+        {
+            auto& resampled = m_converter || m_packer ? m_resampled : processed.writable();
+
+            frames = m_resampler->process(*current, frames, resampled);
+            current = &resampled;
+        }
+
+        if (m_converter)
+        {
+            auto& converted = m_packer ? m_converted : processed.writable();
+
+            m_converter->convert(*current, converted, frames);
+            current = &converted;
+        }
+
+        if (m_packer) m_packer->process(*current, processed.writable(), frames);
+
+        // Silence stays silent unless the resampler is still ringing from earlier blocks or
+        // dither is added to it.
+        const auto dithered = m_converter && m_converter->dither() != PcmDither::none;
+
+        processed.frames(frames);
+        processed.silent(in_block.silent() && ! m_resampler && ! dithered);
+        push(std::move(processed));
+    }
+
+    PcmOutputPort::PcmOutputPort(const std::string& in_name, Object& in_parent) :
+        OutputPort(in_name, PcmPortType::singleton, in_parent)
+    { }
+
+    const PcmConfig& PcmOutputPort::config() const noexcept
+    {
+        assert(m_parent.haveLock());
+
+        return m_config;
+    }
+
+    /// @throws RuntimeError if the port has links.
+    void PcmOutputPort::config(const PcmConfig& in_config)
+    {
+        assert(m_parent.haveLock());
+
+        if (portLinks.size() > 0) pcmLinkedError(*this);
+
+        m_config = in_config;
+    }
+
+    /**
+     * @brief The pool the blocks of the port come from.
+     * @throws RuntimeError if the port has never been linked.
+     */
+    PcmBufferPool& PcmOutputPort::pool() const
+    {
+        assert(m_parent.haveLock());
+
+        if (! m_pool) throw RuntimeError(makeString("PCM output port has not been linked: ", m_name));
+
+        return *m_pool;
+    }
+
+    /// @brief The input the port processes in place or nullptr if there is none.
+    PcmInputPort* PcmOutputPort::inPlace() const noexcept
+    {
+        assert(m_parent.haveLock());
+
+        return m_inPlace;
+    }
+
+    /**
+     * @brief Declare that the parent Object processes an input in place into this output.
+     * @param in_input The input or nullptr to go back to normal processing.
+     * @throws ValueError if the input does not belong to the same Object.
+     *
+     * While an in place input is set buffer() always returns a block that already holds the
+     * samples of the next block from the input and the input block is consumed. When the input
+     * link was the only holder of its block that block is handed through to the output with out
+     * copying anything. Otherwise the samples are copied into a block from the pool.
+     */
+    void PcmOutputPort::inPlace(PcmInputPort* in_input)
+    {
+        assert(m_parent.haveLock());
+
+        if (in_input != nullptr && &in_input->parent() != &m_parent)
+        {
+            throw ValueError(makeString("In place input must belong to the same object: ", in_input->name()));
+        }
+
+        m_inPlace = in_input;
+
+        std::vector<const PcmOutputPort*> visited;
+
+        sizePool(0, visited);
+    }
+
+    /// @brief True if the current block was handed through from the in place input instead of
+    /// being copied.
+    bool PcmOutputPort::aliased() const noexcept
+    {
+        assert(m_parent.haveLock());
+
+        return m_aliased;
+    }
+
+    /**
+     * The most blocks of the pool that can be in flight at once: the block being written plus,
+     * for the link that holds on to the most, the blocks it queues, the block its input is
+     * reading and the blocks the objects past the input keep when they process it in place.
+     * Every link shares the same blocks so the links are not added together.
+     */
+    std::size_t PcmOutputPort::chainBlocks() const noexcept
+    {
+        std::size_t blocks = 0;
+
+        for (const auto link : portLinks)
+        {
+            const auto pcmLink = static_cast<const PcmPortLink*>(link);
+
+            blocks = std::max(blocks, pcmLink->config().depth + 1 + pcmLink->inPlaceBlocks());
+        }
+
+        return blocks + 1;
+    }
+
+    // The in place input block is handed through with out using the pool when nothing else
+    // references it.
+    bool PcmOutputPort::willAlias() const noexcept
+    {
+        if (m_inPlace == nullptr || ! m_inPlace->ready()) return false;
+
+        const auto& block = m_inPlace->block();
+
+        return block.useCount() == 1 && ! block.borrowed() && block->frames() == m_pool->config().blockSize;
+    }
+
+    /**
+     * Blocks handed through in place travel down the chain instead of returning to the pool so
+     * the pool is replaced with a larger one when the chain after the port grows. The blocks of
+     * the old pool keep it alive until they come back. How many blocks the chain holds is told
+     * to the link of the in place input and the pool of the output before it is sized again the
+     * same way. This allocates so it is only done when ports are linked or the in place input
+     * changes and never while the Object is processing.
+     */
+    void PcmOutputPort::sizePool(const std::size_t in_blocks, std::vector<const PcmOutputPort*>& io_visited)
+    {
+        if (! m_pool) return;
+
+        // A feedback loop of in place objects would grow the pools forever.
+        if (std::find(io_visited.begin(), io_visited.end(), this) != io_visited.end()) return;
+
+        io_visited.push_back(this);
+
+        const auto blocks = std::max(in_blocks, chainBlocks());
+
+        if (m_pool->capacity() < blocks) m_pool = PcmBufferPool::make(m_pool->config(), blocks);
+        if (m_inPlace == nullptr || m_inPlace->links().size() != 1) return;
+
+        const auto link = static_cast<PcmPortLink*>(m_inPlace->links().front());
+        auto& upstream = static_cast<PcmOutputPort&>(link->from());
+
+        link->inPlaceBlocks(blocks);
+
+        if (upstream.m_parent.haveLock())
+        {
+            upstream.sizePool(0, io_visited);
+            return;
+        }
+
+        std::scoped_lock lock(upstream.m_parent);
+        upstream.sizePool(0, io_visited);
+    }
+
+    void PcmOutputPort::takeInPlace()
+    {
+        auto& input = *m_inPlace;
+
+        if (! input.ready()) throw RuntimeError(makeString("In place input is not ready: ", input.name()));
+
+        auto block = input.block();
+        const auto& config = pool().config();
+
+        if (block->format() != config.format || block->channels() != config.channels || block->layout() != config.layout)
+        {
+            throw ValueError(makeString("In place input does not match the output: ", input.name()));
+        }
+
+        input.consume();
+
+        // With the input consumed the handle here is the only reference left if no other link
+        // shared the block so nothing else can see the samples change.
+        if (block.useCount() == 1 && ! block.borrowed() && block->frames() == config.blockSize)
+        {
+            m_pending = std::move(block);
+            m_aliased = true;
+            return;
+        }
+
+        m_pending = pool().acquire();
+        m_pending.writable().copy(*block, block.frames());
+        m_pending.frames(block.frames());
+        m_aliased = false;
+    }
+
+    /**
+     * @brief The buffer the parent Object writes the next block into.
+     * @throws RuntimeError if the port has never been linked, the pool is exhausted or the in
+     * place input is not ready.
+     *
+     * A block is taken from the pool or from the in place input the first time this is called
+     * after a commit().
+     */
+    PcmBuffer& PcmOutputPort::buffer()
+    {
+        assert(m_parent.haveLock());
+
+        if (! m_pending)
+        {
+            if (m_inPlace != nullptr)
+            {
+                takeInPlace();
+            }
+            else
+            {
+                m_pending = pool().acquire();
+                m_aliased = false;
+            }
+        }
+
+        return m_pending.writable();
+    }
+
+    /**
+     * @brief Deliver the first frames of the buffer to every link.
+     * @param in_silent True if every sample of the frames is zero so the objects downstream can
+     * skip work. The samples must still be zeroed.
+     *
+     * Every link gets a reference to the same block so the samples are never copied no matter
+     * how many links there are. Links to inputs that want another sample format convert it.
+     */
+    void PcmOutputPort::commit(const std::size_t in_frames, const bool in_silent) noexcept
+    {
+        assert(m_parent.haveLock());
+        assert(ready());
+        assert(m_pending);
+
+        m_pending.frames(in_frames);
+        m_pending.silent(in_silent);
+
+        for (const auto link : portLinks)
+        {
+            static_cast<PcmPortLink*>(link)->deliver(m_pending);
+        }
+
+        m_pending.reset();
+    }
+
+    /**
+     * @brief Deliver samples that are stored somewhere else with out copying them.
+     * @param in_storage Samples laid out the way the blocks of the port lay them out which must
+     * be aligned to pcmAlignment and stay valid while in_owner is alive.
+     * @throws RuntimeError if the port has never been linked or the pool is exhausted.
+     */
+    void PcmOutputPort::commit(const std::byte* in_storage, const std::shared_ptr<const void>& in_owner, const std::size_t in_frames)
+    {
+        assert(m_parent.haveLock());
+        assert(! m_pending);
+        assert(reinterpret_cast<std::uintptr_t>(in_storage) % pcmAlignment == 0);
+
+        auto& blocks = pool();
+
+        m_pending = blocks.tryBorrow(in_storage, in_owner);
+
+        if (! m_pending) throw RuntimeError(makeString("PCM buffer pool is exhausted; capacity=", blocks.capacity()));
+
+        m_aliased = false;
+        commit(in_frames);
+    }
+
+    bool PcmOutputPort::ready() const noexcept
+    {
+        assert(m_parent.haveLock());
+
+        if (portLinks.size() == 0) return false;
+
+        for (const auto link : portLinks)
+        {
+            if (! static_cast<const PcmPortLink*>(link)->ready()) return false;
+        }
+
+        // The pool is as large as the chain needs so it can only run out while blocks are still
+        // on their way down the chain and the port waits for them to come back.
+        if (m_pending || m_pool->available() > 0) return true;
+
+        return willAlias();
+    }
+
+    PcmInputPort::PcmInputPort(const std::string& in_name, Object& in_parent) :
+        InputPort(in_name, PcmPortType::singleton, in_parent)
+    { }
+
+    PcmPortLink& PcmInputPort::link() const noexcept
+    {
+        assert(portLinks.size() == 1);
+
+        return *static_cast<PcmPortLink*>(portLinks.front());
+    }
+
+    const PcmConfig& PcmInputPort::config() const noexcept
+    {
+        assert(m_parent.haveLock());
+
+        return m_config;
+    }
+
+    /// @throws RuntimeError if the port has links.
+    void PcmInputPort::config(const PcmConfig& in_config)
+    {
+        assert(m_parent.haveLock());
+
+        if (portLinks.size() > 0) pcmLinkedError(*this);
+
+        m_config = in_config;
+    }
+
+    PcmDither PcmInputPort::dither() const noexcept
+    {
+        assert(m_parent.haveLock());
+
+        return m_dither;
+    }
+
+    /**
+     * @brief Set the dither used when the link has to convert samples to a lower resolution.
+     * @throws RuntimeError if the port has links.
+     */
+    void PcmInputPort::dither(const PcmDither in_dither)
+    {
+        assert(m_parent.haveLock());
+
+        if (portLinks.size() > 0) pcmLinkedError(*this);
+
+        m_dither = in_dither;
+    }
+
+    PcmResamplerQuality PcmInputPort::resamplerQuality() const noexcept
+    {
+        assert(m_parent.haveLock());
+
+        return m_resamplerQuality;
+    }
+
+    /**
+     * @brief Set the quality of the resampler used when the link has to change the sample rate.
+     * @throws RuntimeError if the port has links.
+     */
+    void PcmInputPort::resamplerQuality(const PcmResamplerQuality in_quality)
+    {
+        assert(m_parent.haveLock());
+
+        if (portLinks.size() > 0) pcmLinkedError(*this);
+
+        m_resamplerQuality = in_quality;
+    }
+
+    const PcmMatrix& PcmInputPort::matrix() const noexcept
+    {
+        assert(m_parent.haveLock());
+
+        return m_matrix;
+    }
+
+    /**
+     * @brief Set the matrix used to mix the channels of the output into the channels of this port.
+     * @throws RuntimeError if the port has links.
+     *
+     * A link is created with a mixer if the input has a matrix or if the ports want different
+     * channel counts. With out a matrix the mixer uses PcmMatrix::standard().
+     */
+    void PcmInputPort::matrix(const PcmMatrix& in_matrix)
+    {
+        assert(m_parent.haveLock());
+
+        if (portLinks.size() > 0) pcmLinkedError(*this);
+
+        m_matrix = in_matrix;
+    }
+
+    /**
+     * @brief The block delivered by the link. Only valid while the port is ready.
+     *
+     * The block is shared with every other input linked to the same output. Keeping a copy of
+     * the handle keeps the samples alive after consume().
+     */
+    const SharedPcmBuffer& PcmInputPort::block() const noexcept
+    {
+        assert(m_parent.haveLock());
+
+        assert(link().front() != nullptr);
+
+        return *link().front();
+    }
+
+    /// @brief The read only samples delivered by the link. Only valid while the port is ready.
+    const PcmBuffer& PcmInputPort::buffer() const noexcept
+    {
+        assert(m_parent.haveLock());
+
+        return block().buffer();
+    }
+
+    std::size_t PcmInputPort::frames() const noexcept
+    {
+        assert(m_parent.haveLock());
+
+        return block().frames();
+    }
+
+    /// @brief True if the output said the frames of the block are all zero.
+    bool PcmInputPort::silent() const noexcept
+    {
+        assert(m_parent.haveLock());
+
+        return block().silent();
+    }
+
+    /// @brief Release the block so the output can deliver the next one.
+    void PcmInputPort::consume() noexcept
+    {
+        assert(m_parent.haveLock());
+
+        link().pop();
+    }
+
+    bool PcmInputPort::ready() const noexcept
+    {
+        assert(m_parent.haveLock());
+
+        if (portLinks.size() == 0) return false;
+
+        return ! link().empty();
+    }
+
+    std::size_t pcmSampleSize(const PcmFormat in_format) noexcept
+    {
+        switch (in_format)
+        {
+            case PcmFormat::int16: return sizeof(std::int16_t);
+            case PcmFormat::int24: return sizeof(std::int32_t);
+            case PcmFormat::int32: return sizeof(std::int32_t);
+            case PcmFormat::float32: return sizeof(float);
+            case PcmFormat::float64: return sizeof(double);
+        }
+
+        FATAL_ERROR(makeString("Unhandled PcmFormat value: ", static_cast<int>(in_format)));
+    }
+
+    std::size_t pcmLanes(const PcmLayout in_layout) noexcept
+    {
+        switch (in_layout)
+        {
+            case PcmLayout::planar: return 1;
+            case PcmLayout::grouped4: return 4;
+            case PcmLayout::grouped8: return 8;
+        }
+
+        FATAL_ERROR(makeString("Unhandled PcmLayout value: ", static_cast<int>(in_layout)));
+    }
+
+    /// @throws ValueError if the name is not what toString() gives for one of the formats.
+    PcmFormat stringToPcmFormat(const std::string& in_name)
+    {
+        for (const auto format : { PcmFormat::int16, PcmFormat::int24, PcmFormat::int32, PcmFormat::float32, PcmFormat::float64 })
+        {
+            if (toString(format) == in_name) return format;
+        }
+
+        throw ValueError(makeString("Unknown PCM format: ", in_name));
+    }
+
+    std::string toString(const PcmFormat in_format) noexcept
+    {
+        switch (in_format)
+        {
+            case PcmFormat::int16: return "int16";
+            case PcmFormat::int24: return "int24";
+            case PcmFormat::int32: return "int32";
+            case PcmFormat::float32: return "float32";
+            case PcmFormat::float64: return "float64";
+        }
+
+        FATAL_ERROR(makeString("Unhandled PcmFormat value: ", static_cast<int>(in_format)));
+    }
+
+    std::string toString(const PcmLayout in_layout) noexcept
+    {
+        switch (in_layout)
+        {
+            case PcmLayout::planar: return "planar";
+            case PcmLayout::grouped4: return "grouped4";
+            case PcmLayout::grouped8: return "grouped8";
+        }
+
+        FATAL_ERROR(makeString("Unhandled PcmLayout value: ", static_cast<int>(in_layout)));
+    }
+
+    std::string toString(const PcmDither in_dither) noexcept
+    {
+        switch (in_dither)
+        {
+            case PcmDither::none: return "none";
+            case PcmDither::rectangular: return "rectangular";
+            case PcmDither::triangular: return "triangular";
+        }
+
+        FATAL_ERROR(makeString("Unhandled PcmDither value: ", static_cast<int>(in_dither)));
+    }
+
+    std::string toString(const PcmResamplerQuality in_quality) noexcept
+    {
+        switch (in_quality)
+        {
+            case PcmResamplerQuality::fast: return "fast";
+            case PcmResamplerQuality::balanced: return "balanced";
+            case PcmResamplerQuality::best: return "best";
+        }
+
+        FATAL_ERROR(makeString("Unhandled PcmResamplerQuality value: ", static_cast<int>(in_quality)));
+    }
+
+    std::ostream& operator<<(std::ostream& in_os, const PcmFormat in_format) noexcept
+    {
+        in_os << toString(in_format);
+        return in_os;
+    }
+
+    std::ostream& operator<<(std::ostream& in_os, const PcmLayout in_layout) noexcept
+    {
+        in_os << toString(in_layout);
+        return in_os;
+    }
+
+    std::ostream& operator<<(std::ostream& in_os, const PcmDither in_dither) noexcept
+    {
+        in_os << toString(in_dither);
+        return in_os;
+    }
+
+    std::ostream& operator<<(std::ostream& in_os, const PcmResamplerQuality in_quality) noexcept
+    {
+        in_os << toString(in_quality);
+        return in_os;
+    }
+}
@@ -0,0 +1,477 @@
+/* Copyright 2023 Tyler Riddle
+ *
+ * This file is part of Clypsalot. Clypsalot is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU Lesser General Public License as published by the Free Software Foundation, either version 3 of the License,
+ * or (at your option) any later version. Clypsalot is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along with Clypsalot. If not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cassert>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include <clypsalot/forward.hxx>
+#include <clypsalot/memory.hxx>
+#include <clypsalot/port.hxx>
+#include <clypsalot/queue.hxx>
+
+/// @file
+namespace Clypsalot
+{
+    /**
+     * @brief The sample formats a PCM port can carry.
+     *
+     * int24 samples are stored right justified and sign extended in 32 bits. Integer samples
+     * map to the range [-1, 1) of the float formats.
+     */
+    enum class PcmFormat : uint_fast8_t
+    {
+        int16,
+        int24,
+        int32,
+        float32,
+        float64,
+    };
+
+    /**
+     * @brief How the channels of a PcmBuffer are arranged in memory.
+     *
+     * Planar buffers store every channel in its own aligned run of samples. Grouped buffers split
+     * the channels into groups of 4 or 8 and interleave the channels of a group frame by frame so
+     * a single vector load gets one frame of every channel in the group. Objects that process
+     * many channels in lockstep can ask for the group width that matches the vector registers of
+     * the CPU. Channels that are needed to fill the last group are padding and stay zeroed.
+     */
+    enum class PcmLayout : uint_fast8_t
+    {
+        planar,
+        grouped4,
+        grouped8,
+    };
+
+    /**
+     * @brief The noise added when a conversion drops resolution.
+     *
+     * The noise is measured in steps of the least significant bit of the destination format.
+     * Rectangular noise is uniform over one step and triangular noise is the sum of two of those
+     * which removes the dependence of the error on the signal.
+     */
+    enum class PcmDither : uint_fast8_t
+    {
+        none,
+        rectangular,
+        triangular,
+    };
+
+    /**
+     * @brief Trade offs between the cost, latency and accuracy of a PcmResampler.
+     *
+     * Each step up doubles the number of filter taps for every output sample which doubles the
+     * cost and the latency and gives a sharper and deeper stop band.
+     */
+    enum class PcmResamplerQuality : uint_fast8_t
+    {
+        fast,
+        balanced,
+        best,
+    };
+
+    template <typename T>
+    concept PcmSample = std::same_as<T, std::int16_t> || std::same_as<T, std::int32_t> || std::same_as<T, float> || std::same_as<T, double>;
+
+    /// @brief The alignment in bytes of every channel in a PcmBuffer. This is the size of a cache
+    /// line and is large enough for any SIMD instruction set.
+    constexpr std::size_t pcmAlignment = 64;
+
+    template <PcmSample T>
+    constexpr PcmFormat pcmFormat() noexcept
+    {
+        if constexpr (std::same_as<T, std::int16_t>) return PcmFormat::int16;
+        else if constexpr (std::same_as<T, std::int32_t>) return PcmFormat::int32;
+        else if constexpr (std::same_as<T, float>) return PcmFormat::float32;
+        else return PcmFormat::float64;
+    }
+
+    /// @brief True if samples of the format are stored as T.
+    template <PcmSample T>
+    constexpr bool pcmStores(const PcmFormat in_format) noexcept
+    {
+        if (std::same_as<T, std::int32_t> && in_format == PcmFormat::int24) return true;
+        return in_format == pcmFormat<T>();
+    }
+
+    /**
+     * @brief The settings of a PCM port or link.
+     *
+     * A channel count or block size of 0 on a port means the port will accept whatever the port
+     * on the other side of the link wants; a link between ports that want different channel counts
+     * mixes the channels with a PcmMatrix. The depth is the number of blocks a link can hold;
+     * the link gets the larger of the depths the ports ask for and at least 1. The rate is the
+     * sample rate in Hz and 0 means it is not known; a link between ports that know different
+     * rates resamples. The output decides the layout and a link to an input that wants another
+     * layout transposes the blocks.
+     */
+    struct PcmConfig
+    {
+        PcmFormat format = PcmFormat::float32;
+        std::size_t channels = 0;
+        std::size_t blockSize = 0;
+        std::size_t depth = 0;
+        std::size_t rate = 0;
+        PcmLayout layout = PcmLayout::planar;
+
+        bool operator==(const PcmConfig&) const noexcept = default;
+    };
+
+    /**
+     * @brief The gain from every input channel to every output channel of a link.
+     *
+     * An empty matrix means the link picks a standard one for the channel counts of the ports.
+     */
+    class PcmMatrix
+    {
+        std::size_t m_inputs = 0;
+        std::size_t m_outputs = 0;
+        std::vector<float> m_gains;
+
+        public:
+        static PcmMatrix identity(const std::size_t in_channels);
+        static PcmMatrix standard(const std::size_t in_inputs, const std::size_t in_outputs);
+        PcmMatrix() noexcept = default;
+        PcmMatrix(const std::size_t in_inputs, const std::size_t in_outputs);
+        bool operator==(const PcmMatrix&) const noexcept = default;
+        bool empty() const noexcept;
+        std::size_t inputs() const noexcept;
+        std::size_t outputs() const noexcept;
+        float gain(const std::size_t in_output, const std::size_t in_input) const;
+        void gain(const std::size_t in_output, const std::size_t in_input, const float in_gain);
+        const float* row(const std::size_t in_output) const noexcept;
+        bool isIdentity() const noexcept;
+    };
+
+    /**
+     * @brief Sample storage with every channel or group of channels aligned to pcmAlignment.
+     *
+     * The number of frames stored for each channel is padded up to a multiple of the alignment
+     * so SIMD loops can always process whole vectors with out a scalar tail. The padding is
+     * zeroed when the buffer is allocated. The channels of a planar buffer are reached with
+     * channel() and the groups of a grouped buffer with group(). A buffer can also be placed
+     * in storage that belongs to something else in which case the storage must outlive the
+     * buffer.
+     */
+    class PcmBuffer
+    {
+        PcmFormat m_format = PcmFormat::float32;
+        std::size_t m_channels = 0;
+        std::size_t m_frames = 0;
+        std::size_t m_stride = 0;
+        PcmLayout m_layout = PcmLayout::planar;
+        std::byte* m_data = nullptr;
+        bool m_owner = false;
+
+        std::size_t rows() const noexcept;
+        std::size_t rowSamples() const noexcept;
+
+        public:
+        static std::size_t storageBytes(const PcmFormat in_format, const std::size_t in_channels, const std::size_t in_frames, const PcmLayout in_layout = PcmLayout::planar) noexcept;
+        PcmBuffer() noexcept = default;
+        PcmBuffer(const PcmFormat in_format, const std::size_t in_channels, const std::size_t in_frames, const PcmLayout in_layout = PcmLayout::planar);
+        PcmBuffer(const PcmFormat in_format, const std::size_t in_channels, const std::size_t in_frames, std::byte* in_storage, const PcmLayout in_layout = PcmLayout::planar) noexcept;
+        PcmBuffer(const PcmBuffer&) = delete;
+        PcmBuffer(PcmBuffer&& in_other) noexcept;
+        ~PcmBuffer() noexcept;
+        void operator=(const PcmBuffer&) = delete;
+        PcmBuffer& operator=(PcmBuffer&& in_other) noexcept;
+        PcmFormat format() const noexcept;
+        std::size_t channels() const noexcept;
+        std::size_t frames() const noexcept;
+        std::size_t stride() const noexcept;
+        PcmLayout layout() const noexcept;
+        std::size_t lanes() const noexcept;
+        std::size_t groups() const noexcept;
+        std::size_t bytes() const noexcept;
+        void clear() noexcept;
+        void copy(const PcmBuffer& in_source, const std::size_t in_frames) noexcept;
+        PcmBuffer clone() const;
+        std::byte* channelData(const std::size_t in_channel) noexcept;
+        const std::byte* channelData(const std::size_t in_channel) const noexcept;
+        std::byte* groupData(const std::size_t in_group) noexcept;
+        const std::byte* groupData(const std::size_t in_group) const noexcept;
+
+        template <PcmSample T>
+        T* channel(const std::size_t in_channel) noexcept
+        {
+            assert(pcmStores<T>(m_format));
+            assert(m_layout == PcmLayout::planar);
+            assert(in_channel < m_channels);
+
+            return reinterpret_cast<T*>(m_data) + in_channel * m_stride;
+        }
+
+        template <PcmSample T>
+        const T* channel(const std::size_t in_channel) const noexcept
+        {
+            assert(pcmStores<T>(m_format));
+            assert(m_layout == PcmLayout::planar);
+            assert(in_channel < m_channels);
+
+            return reinterpret_cast<const T*>(m_data) + in_channel * m_stride;
+        }
+
+        /// @brief The frames of a group of a grouped buffer with the samples of the channels in
+        /// the group next to each other.
+        template <PcmSample T>
+        T* group(const std::size_t in_group) noexcept
+        {
+            assert(pcmStores<T>(m_format));
+            assert(in_group < groups());
+
+            return reinterpret_cast<T*>(m_data) + in_group * m_stride * lanes();
+        }
+
+        template <PcmSample T>
+        const T* group(const std::size_t in_group) const noexcept
+        {
+            assert(pcmStores<T>(m_format));
+            assert(in_group < groups());
+
+            return reinterpret_cast<const T*>(m_data) + in_group * m_stride * lanes();
+        }
+    };
+
+    /// @brief A PcmBuffer owned by a PcmBufferPool along with the number of valid frames in it.
+    /// A borrowed block points at storage that is kept alive by the owner instead.
+    struct PcmBlock
+    {
+        PcmBuffer buffer;
+        std::size_t frames = 0;
+        // Every sample of the valid frames is zero.
+        bool silent = false;
+        std::atomic_size_t references = 0;
+        std::shared_ptr<PcmBufferPool> pool;
+        std::shared_ptr<const void> owner;
+    };
+
+    /**
+     * @brief A reference counted handle to a block from a PcmBufferPool.
+     *
+     * Copying the handle only changes a reference count. The block goes back to its pool when
+     * the last handle is released. Every holder sees the samples as read only; a handle can only
+     * write to the block while it is the only reference to it. A consumer that wants to change
+     * the samples has to clone() them into a buffer of its own.
+     */
+    class SharedPcmBuffer
+    {
+        friend PcmBufferPool;
+
+        PcmBlock* m_block = nullptr;
+
+        public:
+        SharedPcmBuffer() noexcept = default;
+        explicit SharedPcmBuffer(PcmBlock* in_block) noexcept;
+        SharedPcmBuffer(const SharedPcmBuffer& in_other) noexcept;
+        SharedPcmBuffer(SharedPcmBuffer&& in_other) noexcept;
+        ~SharedPcmBuffer() noexcept;
+        SharedPcmBuffer& operator=(const SharedPcmBuffer& in_other) noexcept;
+        SharedPcmBuffer& operator=(SharedPcmBuffer&& in_other) noexcept;
+        explicit operator bool() const noexcept;
+        const PcmBuffer& operator*() const noexcept;
+        const PcmBuffer* operator->() const noexcept;
+        const PcmBuffer& buffer() const noexcept;
+        PcmBuffer& writable() noexcept;
+        std::size_t frames() const noexcept;
+        void frames(const std::size_t in_frames) noexcept;
+        bool silent() const noexcept;
+        void silent(const bool in_silent) noexcept;
+        long useCount() const noexcept;
+        bool borrowed() const noexcept;
+        bool shares(const SharedPcmBuffer& in_other) const noexcept;
+        PcmBuffer clone() const;
+        void reset() noexcept;
+    };
+
+    /**
+     * @brief Recycles the blocks that carry samples out of a PcmOutputPort.
+     *
+     * The samples of every block the pool can hold are placed in a single PageMapping when the
+     * pool is created, which happens when the output is linked, so acquiring and releasing blocks
+     * is lock free and never allocates. Blocks that are in flight keep the pool alive.
+     */
+    class PcmBufferPool : public std::enable_shared_from_this<PcmBufferPool>
+    {
+        friend SharedPcmBuffer;
+
+        const PcmConfig m_config;
+        BoundedQueue<PcmBlock*> m_free;
+        const std::unique_ptr<PcmBlock[]> m_blocks;
+        PageMapping m_memory;
+        std::atomic_size_t m_inFlight = 0;
+        std::atomic_size_t m_highWater = 0;
+
+        void recycle(PcmBlock* in_block) noexcept;
+
+        public:
+        static constexpr std::size_t defaultCapacity = 8;
+
+        static std::shared_ptr<PcmBufferPool> make(const PcmConfig& in_config, const std::size_t in_capacity = defaultCapacity);
+        PcmBufferPool(const PcmConfig& in_config, const std::size_t in_capacity);
+        PcmBufferPool(const PcmBufferPool&) = delete;
+        void operator=(const PcmBufferPool&) = delete;
+        const PcmConfig& config() const noexcept;
+        std::size_t capacity() const noexcept;
+        std::size_t available() const noexcept;
+        std::size_t inFlight() const noexcept;
+        std::size_t highWater() const noexcept;
+        const PageMapping& memory() const noexcept;
+        SharedPcmBuffer acquire();
+        SharedPcmBuffer tryAcquire() noexcept;
+        SharedPcmBuffer tryBorrow(const std::byte* in_storage, std::shared_ptr<const void> in_owner) noexcept;
+    };
+
+    class PcmPortType : public PortType
+    {
+        public:
+        static const std::string typeName;
+        static const PcmPortType singleton;
+
+        PcmPortType();
+        virtual PortLink* makeLink(OutputPort& from, InputPort& to) const override;
+    };
+
+    /**
+     * @brief A link that carries blocks of PCM samples.
+     *
+     * The settings of the link are negotiated between the ports when it is created and do not
+     * change afterwards. The output pushes a reference to its block into every link so all of
+     * them share the same samples. The input reads the oldest block and pops it when done.
+     *
+     * When the input wants a different channel count, sample rate, sample format or layout the
+     * link mixes, resamples, converts and transposes every block into one from a pool of its own
+     * as it is delivered. A resampled block holds however many frames the resampler produced
+     * for the block from the output.
+     */
+    class PcmPortLink : public RingPortLink<SharedPcmBuffer>
+    {
+        const PcmConfig m_config;
+        PcmConfig m_inputConfig;
+        std::unique_ptr<PcmTransposer> m_unpacker;
+        std::unique_ptr<PcmConverter> m_sourceConverter;
+        std::unique_ptr<PcmMixer> m_mixer;
+        std::unique_ptr<PcmResampler> m_resampler;
+        std::unique_ptr<PcmConverter> m_converter;
+        std::unique_ptr<PcmTransposer> m_packer;
+        PcmBuffer m_unpacked;
+        PcmBuffer m_sourceScratch;
+        PcmBuffer m_mixed;
+        PcmBuffer m_resampled;
+        PcmBuffer m_converted;
+        std::shared_ptr<PcmBufferPool> m_pool;
+        mutable std::mutex m_matrixMutex;
+        PcmMatrix m_matrix;
+        std::atomic_bool m_matrixChanged = false;
+        std::atomic_size_t m_inPlaceBlocks = 0;
+
+        void updateMatrix() noexcept;
+
+        protected:
+        virtual std::unique_ptr<LinkCapture> makeCapture(const std::filesystem::path& in_path, const std::size_t in_ringSize) const override;
+
+        public:
+        PcmPortLink(PcmOutputPort& in_from, PcmInputPort& in_to, const PcmConfig& in_config);
+        ~PcmPortLink() noexcept;
+        const PcmConfig& config() const noexcept;
+        const PcmConfig& inputConfig() const noexcept;
+        const PcmConverter* converter() const noexcept;
+        const PcmMixer* mixer() const noexcept;
+        const PcmResampler* resampler() const noexcept;
+        const PcmTransposer* transposer() const noexcept;
+        PcmMatrix matrix() const;
+        void matrix(const PcmMatrix& in_matrix);
+        double latency() const noexcept;
+        std::size_t inPlaceBlocks() const noexcept;
+        void inPlaceBlocks(const std::size_t in_blocks) noexcept;
+        bool ready() const noexcept;
+        void deliver(const SharedPcmBuffer& in_block) noexcept;
+    };
+
+    class PcmOutputPort : public OutputPort
+    {
+        friend PcmPortType;
+
+        PcmConfig m_config;
+        std::shared_ptr<PcmBufferPool> m_pool;
+        SharedPcmBuffer m_pending;
+        PcmInputPort* m_inPlace = nullptr;
+        bool m_aliased = false;
+
+        std::size_t chainBlocks() const noexcept;
+        bool willAlias() const noexcept;
+        void sizePool(const std::size_t in_blocks, std::vector<const PcmOutputPort*>& io_visited);
+        void takeInPlace();
+
+        public:
+        PcmOutputPort(const std::string& in_name, Object& in_parent);
+        const PcmConfig& config() const noexcept;
+        void config(const PcmConfig& in_config);
+        PcmInputPort* inPlace() const noexcept;
+        void inPlace(PcmInputPort* in_input);
+        bool aliased() const noexcept;
+        PcmBufferPool& pool() const;
+        PcmBuffer& buffer();
+        void commit(const std::size_t in_frames, const bool in_silent = false) noexcept;
+        void commit(const std::byte* in_storage, const std::shared_ptr<const void>& in_owner, const std::size_t in_frames);
+        virtual bool ready() const noexcept override;
+    };
+
+    class PcmInputPort : public InputPort
+    {
+        PcmConfig m_config;
+        PcmDither m_dither = PcmDither::none;
+        PcmResamplerQuality m_resamplerQuality = PcmResamplerQuality::balanced;
+        PcmMatrix m_matrix;
+
+        PcmPortLink& link() const noexcept;
+
+        public:
+        PcmInputPort(const std::string& in_name, Object& in_parent);
+        const PcmConfig& config() const noexcept;
+        void config(const PcmConfig& in_config);
+        PcmDither dither() const noexcept;
+        void dither(const PcmDither in_dither);
+        PcmResamplerQuality resamplerQuality() const noexcept;
+        void resamplerQuality(const PcmResamplerQuality in_quality);
+        const PcmMatrix& matrix() const noexcept;
+        void matrix(const PcmMatrix& in_matrix);
+        const SharedPcmBuffer& block() const noexcept;
+        const PcmBuffer& buffer() const noexcept;
+        std::size_t frames() const noexcept;
+        bool silent() const noexcept;
+        void consume() noexcept;
+        virtual bool ready() const noexcept override;
+    };
+
+    std::size_t pcmSampleSize(const PcmFormat in_format) noexcept;
+    std::size_t pcmLanes(const PcmLayout in_layout) noexcept;
+    PcmFormat stringToPcmFormat(const std::string& in_name);
+    std::string toString(const PcmFormat in_format) noexcept;
+    std::string toString(const PcmLayout in_layout) noexcept;
+    std::string toString(const PcmDither in_dither) noexcept;
+    std::string toString(const PcmResamplerQuality in_quality) noexcept;
+    std::ostream& operator<<(std::ostream& in_os, const PcmFormat in_format) noexcept;
+    std::ostream& operator<<(std::ostream& in_os, const PcmLayout in_layout) noexcept;
+    std::ostream& operator<<(std::ostream& in_os, const PcmDither in_dither) noexcept;
+    std::ostream& operator<<(std::ostream& in_os, const PcmResamplerQuality in_quality) noexcept;
+}
@@ -0,0 +1,715 @@
+/* Copyright 2023 Tyler Riddle
+ *
+ * This file is part of Clypsalot. Clypsalot is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU Lesser General Public License as published by the Free Software Foundation, either version 3 of the License,
+ * or (at your option) any later version. Clypsalot is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along with Clypsalot. If not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+
+
+#include <algorithm>
+#include <cassert>
+#include <cerrno>
+#include <csignal>
+#include <cstring>
+
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/ioctl.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include <clypsalot/error.hxx>
+#include <clypsalot/logger.hxx>
+#include <clypsalot/pipe.hxx>
+#include <clypsalot/property.hxx>
+#include <clypsalot/util.hxx>
+
+/// @file
+namespace Clypsalot
+{
+    const std::string PipeSourceObject::kindName = "Pipe Source";
+    const std::string PipeSinkObject::kindName = "Pipe Sink";
+    static const std::string filePropertyName = "File";
+    static const std::string descriptorPropertyName = "Descriptor";
+    static const std::string blockSizePropertyName = "Block Size";
+    static const std::string formatPropertyName = "Format";
+    static const std::string channelsPropertyName = "Channels";
+    static const std::string sampleRatePropertyName = "Sample Rate";
+    static const std::string bufferSizePropertyName = "Buffer Size";
+    static const std::string splicePropertyName = "Splice";
+    static const std::string bytesWrittenPropertyName = "Bytes Written";
+    static const PropertyList pipeProperties = {
+        { filePropertyName, PropertyType::file, Property::Configurable, nullptr },
+        // Used instead of the File property when it is not negative such as 0 for stdin. The
+        // descriptor is duplicated so the original stays open.
+        { descriptorPropertyName, PropertyType::integer, Property::Configurable, -1 },
+    };
+    static const PropertyList pipeSourceProperties = {
+        { blockSizePropertyName, PropertyType::size, Property::Configurable, 256 },
+        { formatPropertyName, PropertyType::string, Property::Configurable, "float32" },
+        { channelsPropertyName, PropertyType::size, Property::Configurable | Property::Required, nullptr },
+        { sampleRatePropertyName, PropertyType::size, Property::Configurable, 0 },
+    };
+    static const PropertyList pipeSinkProperties = {
+        { formatPropertyName, PropertyType::string, Property::Configurable, "float32" },
+        // The size of the staging ring in bytes.
+        { bufferSizePropertyName, PropertyType::size, Property::Configurable, 1024 * 1024 },
+        { splicePropertyName, PropertyType::boolean, Property::Configurable, false },
+        // Updated every time a block is processed.
+        { bytesWrittenPropertyName, PropertyType::size, Property::NoFlags, 0 },
+    };
+
+    PipeObject::PipeObject(const std::string& in_kind) :
+        Object(in_kind)
+    {
+        std::scoped_lock lock(*this);
+
+        addProperties(pipeProperties);
+
+        m_poll.complete = pollComplete;
+        m_poll.context = this;
+    }
+
+    // The subclass has to stop waiting before it is destroyed because the completion uses it.
+    PipeObject::~PipeObject() noexcept
+    {
+        assert(! m_waiting);
+
+        closeDescriptor();
+    }
+
+    void PipeObject::pollComplete(IoRequest& io_request) noexcept
+    {
+        auto& object = *static_cast<PipeObject*>(io_request.context);
+        std::scoped_lock lock(object);
+
+        object.m_waiting = false;
+        object.m_waitDone.notify_all();
+
+        // A wait that finished while it was being cancelled must not start another one.
+        if (io_request.result != -ECANCELED && ! object.m_stopping) object.handleReady();
+    }
+
+    /**
+     * @throws ValueError if neither the File nor the Descriptor property is set.
+     * @throws RuntimeError if the descriptor can not be opened or duplicated.
+     *
+     * Files are opened with out blocking so opening a FIFO for reading does not wait for a writer
+     * and opening one for writing fails if there is no reader.
+     */
+    void PipeObject::openDescriptor(const int in_flags)
+    {
+        assert(haveLock());
+        assert(m_fd < 0);
+
+        const auto descriptor = property(descriptorPropertyName).integerValue();
+
+        if (descriptor >= 0)
+        {
+            m_fd = fcntl(descriptor, F_DUPFD_CLOEXEC, 0);
+
+            if (m_fd < 0) throw RuntimeError(makeString("Could not duplicate descriptor ", descriptor, ": ", std::strerror(errno)));
+        }
+        else
+        {
+            const auto& file = property(filePropertyName);
+
+            if (! file.defined())
+            {
+                throw ValueError(makeString("Property is required: ", filePropertyName, " or ", descriptorPropertyName));
+            }
+
+            const auto path = file.fileValue();
+
+            m_fd = open(path.c_str(), in_flags | O_NONBLOCK | O_CLOEXEC, 0644);
+
+            if (m_fd < 0) throw RuntimeError(makeString("Could not open ", path, ": ", std::strerror(errno)));
+        }
+
+        m_nowait = true;
+    }
+
+    void PipeObject::closeDescriptor() noexcept
+    {
+        if (m_fd < 0) return;
+
+        close(m_fd);
+        m_fd = -1;
+    }
+
+    /**
+     * @brief Wait for the descriptor to be ready with out blocking the thread.
+     * @throws RuntimeError if the IoService is full.
+     *
+     * The Object is not ready until the descriptor is and then handleReady() is called. Nothing
+     * is waited for while stopWaiting() is.
+     */
+    void PipeObject::waitFor(const IoOperation in_operation)
+    {
+        assert(haveLock());
+        assert(! m_waiting);
+
+        if (m_stopping) return;
+
+        m_poll.operation = in_operation;
+        m_poll.fd = m_fd;
+
+        if (! ioService().submit(m_poll)) throw RuntimeError("The I/O service is full");
+
+        m_waiting = true;
+    }
+
+    /*
+     * Cancel the wait and block until it is over. The wait can finish normally before the cancel
+     * reaches it so handleReady() is not called and no new wait is started until this returns.
+     */
+    void PipeObject::stopWaiting() noexcept
+    {
+        assert(haveLock());
+
+        if (! m_waiting) return;
+
+        m_stopping = true;
+        ioService().cancel(m_poll);
+        m_waitDone.wait(*this, [this] { return ! m_waiting; });
+        m_stopping = false;
+    }
+
+    bool PipeObject::waiting() const noexcept
+    {
+        assert(haveLock());
+
+        return m_waiting;
+    }
+
+    /// @brief Called with the lock held once the descriptor is ready. The default wakes the Object.
+    void PipeObject::handleReady() noexcept
+    {
+        wakeObject(*this);
+    }
+
+    bool PipeObject::ready() const noexcept
+    {
+        return ! m_waiting && Object::ready();
+    }
+
+    std::shared_ptr<PipeSourceObject> PipeSourceObject::make()
+    {
+        return _makeObject<PipeSourceObject>(kindName);
+    }
+
+    PipeSourceObject::PipeSourceObject(const std::string& in_kind) :
+        PipeObject(in_kind)
+    {
+        std::scoped_lock lock(*this);
+
+        addProperties(pipeSourceProperties);
+
+        m_blockSize = &propertySizeRef(blockSizePropertyName);
+        m_output = static_cast<PcmOutputPort*>(&addOutput<PcmOutputPort>("output"));
+    }
+
+    PipeSourceObject::~PipeSourceObject() noexcept
+    {
+        std::scoped_lock lock(*this);
+
+        stopWaiting();
+    }
+
+    /*
+     * Read as much as there is with out blocking. Descriptors that do not support RWF_NOWAIT are
+     * polled first instead which is enough for anything that is not a regular file.
+     */
+    std::ptrdiff_t PipeSourceObject::readNow(std::byte* out_data, const std::size_t in_bytes) noexcept
+    {
+        iovec vector { out_data, in_bytes };
+
+        while (true)
+        {
+            ssize_t result;
+
+            if (m_nowait)
+            {
+                result = preadv2(m_fd, &vector, 1, -1, RWF_NOWAIT);
+            }
+            else
+            {
+                pollfd descriptor { m_fd, POLLIN, 0 };
+
+                result = poll(&descriptor, 1, 0);
+
+                if (result == 0) return -EAGAIN;
+                if (result > 0) result = read(m_fd, out_data, in_bytes);
+            }
+
+            if (result >= 0) return result;
+            if (errno == EINTR) continue;
+
+            if (errno == EOPNOTSUPP && m_nowait)
+            {
+                m_nowait = false;
+                continue;
+            }
+
+            return -errno;
+        }
+    }
+
+    /**
+     * @throws ValueError if the Channels property is not set or the format is unknown.
+     * @throws RuntimeError if the descriptor can not be opened.
+     */
+    void PipeSourceObject::handleConfigure(const ObjectConfig& in_config)
+    {
+        assert(haveLock());
+
+        PipeObject::handleConfigure(in_config);
+        stopWaiting();
+        closeDescriptor();
+
+        const auto& channels = property(channelsPropertyName);
+
+        if (! channels.defined() || channels.sizeValue() == 0)
+        {
+            throw ValueError(makeString("Property is required: ", channelsPropertyName));
+        }
+
+        if (*m_blockSize == 0) throw ValueError(makeString(blockSizePropertyName, " must not be 0"));
+
+        m_info = {};
+        m_info.format = stringToPcmFormat(property(formatPropertyName).stringValue());
+        m_info.sampleSize = m_info.format == PcmFormat::int24 ? 3 : pcmSampleSize(m_info.format);
+        m_info.channels = channels.sizeValue();
+        m_info.rate = property(sampleRatePropertyName).sizeValue();
+
+        auto layout = pcmFileLayout(m_info.channels);
+
+        m_direct = m_info.sampleSize == pcmSampleSize(m_info.format) && (m_info.channels == 1 || layout != PcmLayout::planar);
+
+        if (! m_direct) layout = PcmLayout::planar;
+
+        auto config = m_output->config();
+
+        config.format = m_info.format;
+        config.channels = m_info.channels;
+        config.blockSize = *m_blockSize;
+        config.rate = m_info.rate;
+        config.layout = layout;
+        m_output->config(config);
+
+        m_staging.resize(m_direct ? 0 : *m_blockSize * m_info.frameSize());
+        openDescriptor(O_RDONLY);
+        m_primed = false;
+        m_filled = 0;
+        m_frames = 0;
+    }
+
+    /*
+     * The first read waits for the descriptor to be readable because a FIFO with no writer yet
+     * reads as the end of the stream. A block is only delivered once it is full or the stream
+     * ended. Until then the frames that were read wait in the pending block of the port.
+     */
+    ObjectProcessResult PipeSourceObject::process()
+    {
+        assert(haveLock());
+
+        if (! m_primed)
+        {
+            m_primed = true;
+            waitFor(IoOperation::readable);
+            return ObjectProcessResult::blocked;
+        }
+
+        auto& buffer = m_output->buffer();
+        const auto frameSize = m_info.frameSize();
+        const auto blockBytes = buffer.frames() * frameSize;
+        std::byte* data = m_staging.data();
+        auto end = false;
+
+        if (m_direct) data = buffer.layout() == PcmLayout::planar ? buffer.channelData(0) : buffer.groupData(0);
+
+        while (m_filled < blockBytes)
+        {
+            const auto result = readNow(data + m_filled, blockBytes - m_filled);
+
+            if (result > 0)
+            {
+                m_filled += result;
+            }
+            else if (result == 0)
+            {
+                end = true;
+                break;
+            }
+            else if (result == -EAGAIN)
+            {
+                waitFor(IoOperation::readable);
+                return ObjectProcessResult::blocked;
+            }
+            else
+            {
+                throw RuntimeError(makeString("Could not read from the pipe: ", std::strerror(-result)));
+            }
+        }
+
+        const auto frames = m_filled / frameSize;
+
+        if (frames > 0)
+        {
+            if (! m_direct) readPcmFrames(buffer, m_staging.data(), m_info, frames);
+
+            m_output->commit(frames);
+            m_frames += frames;
+        }
+
+        if (m_filled % frameSize != 0) OBJECT_LOGGER(debug, "Dropping a partial frame at the end of the stream");
+
+        m_filled = 0;
+
+        // Like the file source the end of the data is only given once every frame was delivered.
+        // Reading again at the end of the stream reads nothing again.
+        return end && frames == 0 ? ObjectProcessResult::endOfData : ObjectProcessResult::finished;
+    }
+
+    const PcmFileInfo& PipeSourceObject::info() const noexcept
+    {
+        assert(haveLock());
+
+        return m_info;
+    }
+
+    /// @brief True if the stream is read straight into the blocks.
+    bool PipeSourceObject::direct() const noexcept
+    {
+        assert(haveLock());
+
+        return m_direct;
+    }
+
+    /// @brief The number of frames that have been delivered.
+    std::size_t PipeSourceObject::frames() const noexcept
+    {
+        assert(haveLock());
+
+        return m_frames;
+    }
+
+    std::shared_ptr<PipeSinkObject> PipeSinkObject::make()
+    {
+        return _makeObject<PipeSinkObject>(kindName);
+    }
+
+    PipeSinkObject::PipeSinkObject(const std::string& in_kind) :
+        PipeObject(in_kind)
+    {
+        std::scoped_lock lock(*this);
+
+        addProperties(pipeSinkProperties);
+
+        m_bytesWritten = &propertySizeRef(bytesWrittenPropertyName);
+        m_input = static_cast<PcmInputPort*>(&addInput<PcmInputPort>("input"));
+    }
+
+    // Whatever the reader has not taken yet is dropped.
+    PipeSinkObject::~PipeSinkObject() noexcept
+    {
+        std::scoped_lock lock(*this);
+
+        stopWaiting();
+    }
+
+    // Interleave the block at the end of the ring.
+    void PipeSinkObject::stage(const PcmBuffer& in_buffer, const std::size_t in_frames) noexcept
+    {
+        const auto bytes = in_frames * m_info.frameSize();
+        const auto position = m_staged % m_ring.bytes();
+        const auto contiguous = m_ring.bytes() - position;
+
+        assert(m_ring.bytes() - (m_staged - m_released) >= bytes);
+
+        if (bytes <= contiguous)
+        {
+            writePcmFrames(m_ring.data() + position, in_buffer, m_info, in_frames);
+        }
+        else
+        {
+            writePcmFrames(m_scratch.data(), in_buffer, m_info, in_frames);
+            std::memcpy(m_ring.data() + position, m_scratch.data(), contiguous);
+            std::memcpy(m_ring.data(), m_scratch.data() + contiguous, bytes - contiguous);
+        }
+
+        m_staged += bytes;
+    }
+
+    /*
+     * Hand as much of the ring to the pipe as it takes with out blocking. SIGPIPE is blocked while
+     * doing so and a pending one is taken back so a reader that went away only ends the stream
+     * instead of the process.
+     *
+     * The bytes that were written can be reused right away. The bytes that were spliced can only
+     * be reused once they are no longer in the pipe.
+     */
+    void PipeSinkObject::send()
+    {
+        sigset_t pipeSignal;
+        sigset_t previous;
+        auto error = 0;
+
+        sigemptyset(&pipeSignal);
+        sigaddset(&pipeSignal, SIGPIPE);
+        pthread_sigmask(SIG_BLOCK, &pipeSignal, &previous);
+
+        while (m_sent < m_staged)
+        {
+            const auto position = m_sent % m_ring.bytes();
+            iovec vector { m_ring.data() + position, std::min(m_staged - m_sent, m_ring.bytes() - position) };
+            ssize_t result;
+
+            if (m_splice)
+            {
+                result = vmsplice(m_fd, &vector, 1, SPLICE_F_NONBLOCK);
+            }
+            else if (m_nowait)
+            {
+                result = pwritev2(m_fd, &vector, 1, -1, RWF_NOWAIT);
+            }
+            else
+            {
+                pollfd descriptor { m_fd, POLLOUT, 0 };
+
+                result = poll(&descriptor, 1, 0);
+
+                if (result == 0) break;
+                if (result > 0) result = write(m_fd, vector.iov_base, vector.iov_len);
+            }
+
+            if (result > 0)
+            {
+                m_sent += result;
+                continue;
+            }
+
+            if (result < 0 && errno == EINTR) continue;
+
+            if (result < 0 && errno == EOPNOTSUPP && m_nowait && ! m_splice)
+            {
+                m_nowait = false;
+                continue;
+            }
+
+            if (result < 0 && errno != EAGAIN) error = errno;
+
+            break;
+        }
+
+        if (error == EPIPE)
+        {
+            const timespec zero { 0, 0 };
+
+            sigtimedwait(&pipeSignal, nullptr, &zero);
+        }
+
+        pthread_sigmask(SIG_SETMASK, &previous, nullptr);
+
+        if (! m_splice)
+        {
+            m_released = m_sent;
+        }
+        else if (int unread = 0; ioctl(m_fd, FIONREAD, &unread) == 0)
+        {
+            m_released = std::max(m_released, m_sent - std::min(static_cast<std::size_t>(unread), m_sent));
+        }
+
+        *m_bytesWritten = m_sent;
+
+        if (error == EPIPE)
+        {
+            OBJECT_LOGGER(verbose, "The reader closed the pipe");
+            m_broken = true;
+        }
+        else if (error != 0)
+        {
+            throw RuntimeError(makeString("Could not write to the pipe: ", std::strerror(error)));
+        }
+    }
+
+    // Keep writing as the pipe has room and close it once everything is written.
+    void PipeSinkObject::drain() noexcept
+    {
+        assert(haveLock());
+
+        m_draining = true;
+
+        try
+        {
+            if (m_fd >= 0) send();
+            if (m_fd >= 0 && m_sent < m_staged && ! m_broken) return waitFor(IoOperation::writable);
+        }
+        catch (const std::exception& e)
+        {
+            OBJECT_LOGGER(error, "Could not finish the stream: ", e.what());
+        }
+
+        closeDescriptor();
+    }
+
+    /**
+     * @throws ValueError if the format is unknown.
+     * @throws RuntimeError if the descriptor can not be opened.
+     */
+    void PipeSinkObject::handleConfigure(const ObjectConfig& in_config)
+    {
+        assert(haveLock());
+
+        PipeObject::handleConfigure(in_config);
+        stopWaiting();
+        closeDescriptor();
+
+        auto config = m_input->config();
+
+        config.format = stringToPcmFormat(property(formatPropertyName).stringValue());
+        config.layout = PcmLayout::planar;
+        m_input->config(config);
+
+        m_info = {};
+        m_info.format = config.format;
+        m_info.sampleSize = config.format == PcmFormat::int24 ? 3 : pcmSampleSize(config.format);
+
+        openDescriptor(O_WRONLY | O_CREAT | O_TRUNC);
+
+        struct stat status;
+
+        m_splice = property(splicePropertyName).booleanValue();
+
+        if (m_splice && (fstat(m_fd, &status) != 0 || ! S_ISFIFO(status.st_mode)))
+        {
+            OBJECT_LOGGER(debug, "The descriptor is not a pipe; using writes instead of vmsplice()");
+            m_splice = false;
+        }
+
+        m_ring = PageMapping();
+        m_scratch.clear();
+        m_draining = false;
+        m_broken = false;
+        m_staged = 0;
+        m_sent = 0;
+        m_released = 0;
+        *m_bytesWritten = 0;
+    }
+
+    // The Object is stopped before the descriptor can be closed so a reader that sees the end of
+    // the stream also sees the Object stopped.
+    void PipeSinkObject::handleEndOfData() noexcept
+    {
+        PipeObject::handleEndOfData();
+        drain();
+    }
+
+    void PipeSinkObject::handleReady() noexcept
+    {
+        if (m_draining) return drain();
+
+        try
+        {
+            send();
+            if (! m_broken && m_sent < m_staged) waitFor(IoOperation::writable);
+        }
+        catch (const std::exception& e)
+        {
+            OBJECT_LOGGER(error, "Could not write to the pipe: ", e.what());
+        }
+
+        wakeObject(*this);
+    }
+
+    /*
+     * The link decides the channels and the size of the blocks. A spliced ring is larger than the
+     * pipe so it is only ever full when the pipe is too.
+     */
+    void PipeSinkObject::handleLinked(const PortLink& in_link)
+    {
+        assert(haveLock());
+
+        PipeObject::handleLinked(in_link);
+
+        if (&in_link.to() != m_input) return;
+
+        const auto& config = static_cast<const PcmPortLink&>(in_link).inputConfig();
+        int pipeSize = 0;
+
+        m_info.channels = config.channels;
+        m_info.rate = config.rate;
+
+        const auto blockBytes = config.blockSize * m_info.frameSize();
+        auto ringSize = std::max(property(bufferSizePropertyName).sizeValue(), 2 * blockBytes);
+
+        if (m_splice && (pipeSize = fcntl(m_fd, F_GETPIPE_SZ)) > 0) ringSize += pipeSize;
+
+        // A ring that is large enough is kept so what is staged survives being linked again.
+        if (m_ring.bytes() < ringSize) m_ring = PageMapping(ringSize);
+        if (m_scratch.size() < blockBytes) m_scratch.resize(blockBytes);
+    }
+
+    /*
+     * A block is only taken from the input once the ring has room for it. If it does not the
+     * Object blocks until the pipe can take more. Whatever the pipe does not take right away is
+     * written once it has room even if no more blocks arrive.
+     */
+    ObjectProcessResult PipeSinkObject::process()
+    {
+        assert(haveLock());
+
+        const auto& buffer = m_input->buffer();
+        const auto frames = m_input->frames();
+
+        assert(m_ring.bytes() > 0);
+
+        send();
+
+        if (m_broken) return ObjectProcessResult::endOfData;
+
+        if (m_ring.bytes() - (m_staged - m_released) < frames * m_info.frameSize())
+        {
+            waitFor(IoOperation::writable);
+            return ObjectProcessResult::blocked;
+        }
+
+        stage(buffer, frames);
+        m_input->consume();
+        send();
+
+        if (m_broken) return ObjectProcessResult::endOfData;
+        if (m_sent < m_staged) waitFor(IoOperation::writable);
+
+        return ObjectProcessResult::finished;
+    }
+
+    const PcmFileInfo& PipeSinkObject::info() const noexcept
+    {
+        assert(haveLock());
+
+        return m_info;
+    }
+
+    /// @brief True if the ring is handed to the pipe with vmsplice().
+    bool PipeSinkObject::splice() const noexcept
+    {
+        assert(haveLock());
+
+        return m_splice;
+    }
+
+    /// @brief True once the descriptor was closed at the end of the stream.
+    bool PipeSinkObject::closed() const noexcept
+    {
+        assert(haveLock());
+
+        return m_fd < 0;
+    }
+}
@@ -0,0 +1,145 @@
+/* Copyright 2023 Tyler Riddle
+ *
+ * This file is part of Clypsalot. Clypsalot is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU Lesser General Public License as published by the Free Software Foundation, either version 3 of the License,
+ * or (at your option) any later version. Clypsalot is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along with Clypsalot. If not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#include <condition_variable>
+#include <memory>
+#include <vector>
+
+#include <clypsalot/io.hxx>
+#include <clypsalot/memory.hxx>
+#include <clypsalot/object.hxx>
+#include <clypsalot/pcm.hxx>
+#include <clypsalot/wav.hxx>
+
+/// @file
+namespace Clypsalot
+{
+    /**
+     * @brief The part of the pipe objects that owns the descriptor and waits for it to be ready.
+     *
+     * The descriptor is a pipe, FIFO, socket or terminal that is opened from the File property or
+     * duplicated from the Descriptor property. Reads and writes are only ever tried with out
+     * blocking. When the descriptor is not ready the Object submits a readable or writable
+     * IoRequest, returns ObjectProcessResult::blocked and is woken once the descriptor is ready.
+     */
+    class PipeObject : public Object
+    {
+        IoRequest m_poll;
+        bool m_waiting = false;
+        bool m_stopping = false;
+        std::condition_variable_any m_waitDone;
+
+        static void pollComplete(IoRequest& io_request) noexcept;
+
+        protected:
+        int m_fd = -1;
+        bool m_nowait = true;
+
+        void openDescriptor(const int in_flags);
+        void closeDescriptor() noexcept;
+        void waitFor(const IoOperation in_operation);
+        void stopWaiting() noexcept;
+        bool waiting() const noexcept;
+        virtual void handleReady() noexcept;
+
+        public:
+        PipeObject(const std::string& in_kind);
+        virtual ~PipeObject() noexcept;
+        virtual bool ready() const noexcept override;
+    };
+
+    /**
+     * @brief Read raw interleaved PCM from a pipe.
+     *
+     * Streams with 1, 4 or 8 channels in the format of the port are read straight into the blocks
+     * which have the matching planar, grouped4 or grouped8 layout. Other streams are read into a
+     * block sized buffer and deinterleaved. The end of the stream is the end of the data.
+     */
+    class PipeSourceObject : public PipeObject
+    {
+        std::size_t* m_blockSize = nullptr;
+        PcmOutputPort* m_output = nullptr;
+        PcmFileInfo m_info;
+        std::vector<std::byte> m_staging;
+        bool m_direct = false;
+        bool m_primed = false;
+        std::size_t m_filled = 0;
+        std::size_t m_frames = 0;
+
+        std::ptrdiff_t readNow(std::byte* out_data, const std::size_t in_bytes) noexcept;
+
+        protected:
+        virtual void handleConfigure(const ObjectConfig& in_config) override;
+        virtual ObjectProcessResult process() override;
+
+        public:
+        static const std::string kindName;
+
+        static std::shared_ptr<PipeSourceObject> make();
+        PipeSourceObject(const std::string& in_kind);
+        virtual ~PipeSourceObject() noexcept;
+        const PcmFileInfo& info() const noexcept;
+        bool direct() const noexcept;
+        std::size_t frames() const noexcept;
+    };
+
+    /**
+     * @brief Write raw interleaved PCM to a pipe.
+     *
+     * Blocks are interleaved into a staging ring that is drained whenever the pipe has room. With
+     * the Splice property the pages of the ring are handed to a pipe with vmsplice() instead of
+     * being copied and the ring only reuses them once the reader has taken them out of the pipe.
+     * That is only safe if the reader copies the data which is true for read() but not for a
+     * reader that splices the pages on to a socket.
+     *
+     * At the end of the data the rest of the ring is written as the pipe has room and then the
+     * descriptor is closed so the reader sees the end of the stream.
+     */
+    class PipeSinkObject : public PipeObject
+    {
+        std::size_t* m_bytesWritten = nullptr;
+        PcmInputPort* m_input = nullptr;
+        PcmFileInfo m_info;
+        PageMapping m_ring;
+        std::vector<std::byte> m_scratch;
+        bool m_splice = false;
+        bool m_draining = false;
+        bool m_broken = false;
+        std::size_t m_staged = 0;
+        std::size_t m_sent = 0;
+        std::size_t m_released = 0;
+
+        void stage(const PcmBuffer& in_buffer, const std::size_t in_frames) noexcept;
+        void send();
+        void drain() noexcept;
+
+        protected:
+        virtual void handleConfigure(const ObjectConfig& in_config) override;
+        virtual void handleEndOfData() noexcept override;
+        virtual void handleLinked(const PortLink& in_link) override;
+        virtual void handleReady() noexcept override;
+        virtual ObjectProcessResult process() override;
+
+        public:
+        static const std::string kindName;
+
+        static std::shared_ptr<PipeSinkObject> make();
+        PipeSinkObject(const std::string& in_kind);
+        virtual ~PipeSinkObject() noexcept;
+        const PcmFileInfo& info() const noexcept;
+        bool splice() const noexcept;
+        bool closed() const noexcept;
+    };
+}
@@ -12,6 +12,7 @@
 
 #include <cassert>
 
+#include <clypsalot/capture.hxx>
 #include <clypsalot/error.hxx>
 #include <clypsalot/logger.hxx>
 #include <clypsalot/macros.hxx>
@@ -51,6 +52,9 @@ namespace Clypsalot
         m_to(in_to)
     { }
 
+    // Destroying the capture finishes the file.
+    PortLink::~PortLink() noexcept = default;
+
     bool PortLink::operator==(const PortLink& rhs)
     {
         if (m_from == rhs.m_from && m_to == rhs.m_to) return true;
@@ -72,16 +76,55 @@ namespace Clypsalot
         return m_to;
     }
 
+    // The release pairs with the acquire in endOfData() so everything the output delivered
+    // before setting the flag is visible to the input once it sees the flag.
     void PortLink::setEndOfData() noexcept
     {
-        std::scoped_lock lock(m_mutex);
-        m_endOfDataFlag = true;
+        m_endOfDataFlag.store(true, std::memory_order_release);
     }
 
     bool PortLink::endOfData() const noexcept
     {
-        std::scoped_lock lock(m_mutex);
-        return m_endOfDataFlag;
+        return m_endOfDataFlag.load(std::memory_order_acquire);
+    }
+
+    /// @throws TypeError because the link does not carry anything that can be captured.
+    std::unique_ptr<LinkCapture> PortLink::makeCapture(const std::filesystem::path&, const std::size_t) const
+    {
+        throw TypeError(makeString("Link can not be captured: ", *this));
+    }
+
+    /// @brief The capture that is recording the link or nullptr. Only the parent of the output may
+    /// record into it.
+    LinkCapture* PortLink::capture() const noexcept
+    {
+        return m_capture.get();
+    }
+
+    /**
+     * @brief Record everything the output delivers to a capture file until stopCapture().
+     * @param in_ringSize The bytes buffered between the output and the thread writing the file or
+     * 0 for LinkCapture::defaultRingSize.
+     * @throws TypeError if the port type does not support captures.
+     * @throws RuntimeError if the file can not be created.
+     *
+     * The parent of the output must be locked. A capture that was already running is finished
+     * first.
+     */
+    void PortLink::startCapture(const std::filesystem::path& in_path, const std::size_t in_ringSize)
+    {
+        assert(m_from.parent().haveLock());
+
+        m_capture.reset();
+        m_capture = makeCapture(in_path, in_ringSize > 0 ? in_ringSize : LinkCapture::defaultRingSize);
+    }
+
+    /// @brief Finish the capture file. The parent of the output must be locked.
+    void PortLink::stopCapture() noexcept
+    {
+        assert(m_from.parent().haveLock());
+
+        m_capture.reset();
     }
 
     Port::Port(const std::string& in_name, const PortType& in_type, Object& in_parent) :
@@ -155,6 +198,8 @@ namespace Clypsalot
         if (findLink(link->from(), link->to())) throw DuplicateLinkError(link->from(), link->to());
 
         portLinks.push_back(link);
+        m_parent.updateLinks();
+        m_parent.handleLinked(*link);
     }
 
     void Port::removeLink(const PortLink* link)
@@ -169,6 +214,7 @@ namespace Clypsalot
             if (*i == link)
             {
                 i = portLinks.erase(i);
+                m_parent.updateLinks();
                 return;
             }
             else
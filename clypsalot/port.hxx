@@ -12,11 +12,15 @@
 
 #pragma once
 
+#include <atomic>
+#include <filesystem>
+#include <memory>
 #include <vector>
 #include <string>
 
 #include <clypsalot/forward.hxx>
 #include <clypsalot/port.hxx>
+#include <clypsalot/queue.hxx>
 #include <clypsalot/thread.hxx>
 
 namespace Clypsalot
@@ -34,18 +38,31 @@ namespace Clypsalot
         virtual PortLink* makeLink(OutputPort& from, InputPort& to) const = 0;
     };
 
-    class PortLink : protected Lockable
+    /**
+     * @brief The connection between an OutputPort and an InputPort.
+     *
+     * The parent of the output is the only writer and the parent of the input is the only reader
+     * of a link so the state shared between them is kept in atomics instead of behind a lock.
+     *
+     * Links of port types that carry data can record what the output delivers to a capture file
+     * which can be played back with a ReplayObject.
+     */
+    class PortLink
     {
-        bool m_endOfDataFlag = false;
+        std::atomic_bool m_endOfDataFlag = false;
         // FIXME The output and input ports should be std::weak_ptr
         OutputPort& m_from;
         InputPort& m_to;
+        std::unique_ptr<LinkCapture> m_capture;
+
+        protected:
+        virtual std::unique_ptr<LinkCapture> makeCapture(const std::filesystem::path& in_path, const std::size_t in_ringSize) const;
 
         public:
         static std::string toString(const PortLink& link) noexcept;
         PortLink(OutputPort& in_from, InputPort& in_to);
         PortLink(const PortLink&) = delete;
-        virtual ~PortLink() = default;
+        virtual ~PortLink() noexcept;
         void operator=(const PortLink&) = delete;
         bool operator==(const PortLink& rhs);
         bool operator!=(const PortLink& rhs);
@@ -53,6 +70,68 @@ namespace Clypsalot
         InputPort& to() const noexcept;
         void setEndOfData() noexcept;
         bool endOfData() const noexcept;
+        LinkCapture* capture() const noexcept;
+        void startCapture(const std::filesystem::path& in_path, const std::size_t in_ringSize = 0);
+        void stopCapture() noexcept;
+    };
+
+    /**
+     * @brief A link that carries values in a lock free single producer single consumer ring.
+     *
+     * This is the base for links of port types that carry data. The output pushes values and
+     * the input reads and pops them. The number of occupied slots is what the ports use to
+     * decide if they are ready.
+     */
+    template <RingValue T>
+    class RingPortLink : public PortLink
+    {
+        RingBuffer<T> m_ring;
+
+        public:
+        RingPortLink(OutputPort& in_from, InputPort& in_to, const std::size_t in_slots) :
+            PortLink(in_from, in_to),
+            m_ring(in_slots)
+        { }
+
+        std::size_t slots() const noexcept
+        {
+            return m_ring.capacity();
+        }
+
+        std::size_t size() const noexcept
+        {
+            return m_ring.size();
+        }
+
+        bool empty() const noexcept
+        {
+            return m_ring.empty();
+        }
+
+        bool full() const noexcept
+        {
+            return m_ring.full();
+        }
+
+        bool push(T in_value) noexcept
+        {
+            return m_ring.push(std::move(in_value));
+        }
+
+        T* front() noexcept
+        {
+            return m_ring.front();
+        }
+
+        const T* front() const noexcept
+        {
+            return m_ring.front();
+        }
+
+        bool pop() noexcept
+        {
+            return m_ring.pop();
+        }
     };
 
     class Port
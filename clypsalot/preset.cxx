@@ -0,0 +1,104 @@
+/* Copyright 2023 Tyler Riddle
+ *
+ * This file is part of Clypsalot. Clypsalot is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU Lesser General Public License as published by the Free Software Foundation, either version 3 of the License,
+ * or (at your option) any later version. Clypsalot is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along with Clypsalot. If not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <cassert>
+
+#include <clypsalot/error.hxx>
+#include <clypsalot/object.hxx>
+#include <clypsalot/preset.hxx>
+#include <clypsalot/util.hxx>
+
+/// @file
+namespace Clypsalot
+{
+    PresetBlock& Preset::block(const SharedObject& in_object)
+    {
+        const auto position = std::lower_bound(m_blocks.begin(), m_blocks.end(), in_object->id(),
+            [](const PresetBlock& lhs, const Object::Id rhs) { return lhs.object->id() < rhs; });
+
+        if (position != m_blocks.end() && position->object == in_object) return *position;
+
+        return *m_blocks.insert(position, { in_object, {} });
+    }
+
+    /**
+     * @brief Add a property value to the Preset.
+     * @throws KeyError if the Object does not have the property.
+     * @throws ImmutableError if the property is not public mutable.
+     *
+     * The value is converted to the type of the property now so conversion errors are thrown
+     * here instead of during recall. Adding the same property again replaces the value.
+     */
+    void Preset::add(const SharedObject& in_object, const std::string& in_property, const std::any& in_value)
+    {
+        assert(in_object->haveLock());
+
+        const auto handle = in_object->propertyHandle(in_property);
+        const auto& property = in_object->property(handle);
+
+        if (! property.hasFlag(Property::PublicMutable))
+        {
+            throw ImmutableError(makeString("Property ", in_property, " is not mutable"));
+        }
+
+        auto value = property.convert(in_value);
+        auto& values = block(in_object).values;
+
+        for (auto& [existingHandle, existingValue] : values)
+        {
+            if (existingHandle == handle)
+            {
+                existingValue = std::move(value);
+                return;
+            }
+        }
+
+        values.emplace_back(handle, std::move(value));
+    }
+
+    /// @brief Add the current value of every defined public mutable property of the Object.
+    void Preset::capture(const SharedObject& in_object)
+    {
+        assert(in_object->haveLock());
+
+        auto& values = block(in_object).values;
+
+        values.clear();
+
+        for (const auto& [name, property] : in_object->properties())
+        {
+            if (property.hasFlag(Property::PublicMutable) && property.defined())
+            {
+                values.emplace_back(in_object->propertyHandle(name), property.variant());
+            }
+        }
+    }
+
+    const std::vector<PresetBlock>& Preset::blocks() const noexcept
+    {
+        return m_blocks;
+    }
+
+    /// @brief The number of property values in the Preset.
+    std::size_t Preset::size() const noexcept
+    {
+        std::size_t total = 0;
+
+        for (const auto& block : m_blocks)
+        {
+            total += block.values.size();
+        }
+
+        return total;
+    }
+}
@@ -0,0 +1,51 @@
+/* Copyright 2023 Tyler Riddle
+ *
+ * This file is part of Clypsalot. Clypsalot is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU Lesser General Public License as published by the Free Software Foundation, either version 3 of the License,
+ * or (at your option) any later version. Clypsalot is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along with Clypsalot. If not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <vector>
+
+#include <clypsalot/forward.hxx>
+#include <clypsalot/property.hxx>
+
+/// @file
+namespace Clypsalot
+{
+    /// @brief The values a Preset applies to a single Object.
+    struct PresetBlock
+    {
+        SharedObject object;
+        PropertyValues values;
+    };
+
+    /**
+     * @brief A scene of property values for many objects that is compiled ahead of time.
+     *
+     * Every value is checked and converted when it is added so recalling the Preset with
+     * Network::recall() does no string lookups or std::any conversions. It still allocates the
+     * list of locks and the list of paused objects with an entry for each Object and copies string
+     * and array values into their properties so it is not meant for a processing thread. The
+     * blocks are kept in Object id order which is the order recall() locks the objects in.
+     */
+    class Preset
+    {
+        std::vector<PresetBlock> m_blocks;
+
+        PresetBlock& block(const SharedObject& in_object);
+
+        public:
+        void add(const SharedObject& in_object, const std::string& in_property, const std::any& in_value);
+        void capture(const SharedObject& in_object);
+        const std::vector<PresetBlock>& blocks() const noexcept;
+        std::size_t size() const noexcept;
+    };
+}
@@ -29,13 +29,23 @@ namespace Clypsalot
         switch (in_config.type)
         {
             case PropertyType::boolean: m_container = false; break;
+            case PropertyType::doubleArray: m_container = DoubleArrayType(); break;
+            case PropertyType::doubleTable: m_container = DoubleTableType(); break;
             case PropertyType::file: m_container = std::filesystem::path(); break;
             case PropertyType::integer: m_container = static_cast<IntegerType>(0); break;
+            case PropertyType::integerArray: m_container = IntegerArrayType(); break;
             case PropertyType::real: m_container = static_cast<RealType>(0); break;
+            case PropertyType::realArray: m_container = RealArrayType(); break;
+            case PropertyType::realTable: m_container = RealTableType(); break;
             case PropertyType::size: m_container = static_cast<SizeType>(0); break;
             case PropertyType::string: m_container = std::string(); break;
         }
 
+        if (hasFlag(Automatable) && ! propertyTypeIsScalar(m_type))
+        {
+            throw TypeError(makeString("Property ", m_name, " is ", m_type, " and can not be automated"));
+        }
+
         if (in_config.initial.type() != typeid(nullptr))
         {
             set(in_config.initial);
@@ -83,20 +93,60 @@ namespace Clypsalot
         return m_container;
     }
 
-    void Property::set(const std::any& in_value)
+    /**
+     * @brief Set the value from a Variant that already holds the type of the Property.
+     * @throws TypeError if the Variant holds a different type.
+     *
+     * This skips the conversions anyValue() does so it is the cheap way to apply values that
+     * were converted ahead of time with convert().
+     */
+    void Property::variant(const Variant& in_value)
     {
         assert(m_parent.haveLock());
 
+        enforcePublicMutable();
+        assign(in_value);
+    }
+
+    /// @brief Convert a value to the type of the Property with out changing the Property.
+    Property::Variant Property::convert(const std::any& in_value) const
+    {
         switch (m_type)
         {
-            case PropertyType::boolean: m_container = anyToBool(in_value); break;
-            case PropertyType::file: m_container = anyToPath(in_value); break;
-            case PropertyType::integer: m_container = anyToInt(in_value); break;
-            case PropertyType::real: m_container = anyToFloat(in_value); break;
-            case PropertyType::size: m_container = anyToSize(in_value); break;
-            case PropertyType::string: m_container = anyToString(in_value); break;
+            case PropertyType::boolean: return anyToBool(in_value);
+            case PropertyType::doubleArray: return anyToArray<double>(in_value);
+            case PropertyType::doubleTable: return anyToTable<double>(in_value);
+            case PropertyType::file: return anyToPath(in_value);
+            case PropertyType::integer: return anyToInt(in_value);
+            case PropertyType::integerArray: return anyToArray<int>(in_value);
+            case PropertyType::real: return anyToFloat(in_value);
+            case PropertyType::realArray: return anyToArray<float>(in_value);
+            case PropertyType::realTable: return anyToTable<float>(in_value);
+            case PropertyType::size: return anyToSize(in_value);
+            case PropertyType::string: return anyToString(in_value);
+        }
+
+        FATAL_ERROR(makeString("Unhandled PropertyType value: ", m_type));
+    }
+
+    void Property::assign(const Variant& in_value)
+    {
+        assert(m_parent.haveLock());
+
+        if (in_value.index() != m_container.index())
+        {
+            throw TypeError(makeString("Property ", m_name, " is not of the type held by the variant"));
         }
 
+        m_container = in_value;
+        m_hasValue = true;
+    }
+
+    void Property::set(const std::any& in_value)
+    {
+        assert(m_parent.haveLock());
+
+        m_container = convert(in_value);
         m_hasValue = true;
     }
 
@@ -150,6 +200,64 @@ namespace Clypsalot
         m_hasValue = true;
     }
 
+    Property::DoubleArrayType& Property::doubleArrayRef()
+    {
+        assert(m_parent.haveLock());
+
+        enforceType(PropertyType::doubleArray);
+
+        return std::get<DoubleArrayType>(m_container);
+    }
+
+    Property::DoubleArrayType Property::doubleArrayValue() const
+    {
+        assert(m_parent.haveLock());
+
+        enforceType(PropertyType::doubleArray);
+        enforceDefined();
+
+        return std::get<DoubleArrayType>(m_container);
+    }
+
+    void Property::doubleArrayValue(const DoubleArrayType& in_value)
+    {
+        assert(m_parent.haveLock());
+
+        enforcePublicMutable();
+
+        doubleArrayRef() = in_value;
+        m_hasValue = true;
+    }
+
+    Property::DoubleTableType& Property::doubleTableRef()
+    {
+        assert(m_parent.haveLock());
+
+        enforceType(PropertyType::doubleTable);
+
+        return std::get<DoubleTableType>(m_container);
+    }
+
+    Property::DoubleTableType Property::doubleTableValue() const
+    {
+        assert(m_parent.haveLock());
+
+        enforceType(PropertyType::doubleTable);
+        enforceDefined();
+
+        return std::get<DoubleTableType>(m_container);
+    }
+
+    void Property::doubleTableValue(const DoubleTableType& in_value)
+    {
+        assert(m_parent.haveLock());
+
+        enforcePublicMutable();
+
+        doubleTableRef() = in_value;
+        m_hasValue = true;
+    }
+
     Property::FileType& Property::fileRef()
     {
         assert(m_parent.haveLock());
@@ -208,6 +316,35 @@ namespace Clypsalot
         m_hasValue = true;
     }
 
+    Property::IntegerArrayType& Property::integerArrayRef()
+    {
+        assert(m_parent.haveLock());
+
+        enforceType(PropertyType::integerArray);
+
+        return std::get<IntegerArrayType>(m_container);
+    }
+
+    Property::IntegerArrayType Property::integerArrayValue() const
+    {
+        assert(m_parent.haveLock());
+
+        enforceType(PropertyType::integerArray);
+        enforceDefined();
+
+        return std::get<IntegerArrayType>(m_container);
+    }
+
+    void Property::integerArrayValue(const IntegerArrayType& in_value)
+    {
+        assert(m_parent.haveLock());
+
+        enforcePublicMutable();
+
+        integerArrayRef() = in_value;
+        m_hasValue = true;
+    }
+
     Property::RealType& Property::realRef()
     {
         assert(m_parent.haveLock());
@@ -237,6 +374,64 @@ namespace Clypsalot
         m_hasValue = true;
     }
 
+    Property::RealArrayType& Property::realArrayRef()
+    {
+        assert(m_parent.haveLock());
+
+        enforceType(PropertyType::realArray);
+
+        return std::get<RealArrayType>(m_container);
+    }
+
+    Property::RealArrayType Property::realArrayValue() const
+    {
+        assert(m_parent.haveLock());
+
+        enforceType(PropertyType::realArray);
+        enforceDefined();
+
+        return std::get<RealArrayType>(m_container);
+    }
+
+    void Property::realArrayValue(const RealArrayType& in_value)
+    {
+        assert(m_parent.haveLock());
+
+        enforcePublicMutable();
+
+        realArrayRef() = in_value;
+        m_hasValue = true;
+    }
+
+    Property::RealTableType& Property::realTableRef()
+    {
+        assert(m_parent.haveLock());
+
+        enforceType(PropertyType::realTable);
+
+        return std::get<RealTableType>(m_container);
+    }
+
+    Property::RealTableType Property::realTableValue() const
+    {
+        assert(m_parent.haveLock());
+
+        enforceType(PropertyType::realTable);
+        enforceDefined();
+
+        return std::get<RealTableType>(m_container);
+    }
+
+    void Property::realTableValue(const RealTableType& in_value)
+    {
+        assert(m_parent.haveLock());
+
+        enforcePublicMutable();
+
+        realTableRef() = in_value;
+        m_hasValue = true;
+    }
+
     Property::SizeType& Property::sizeRef()
     {
         assert(m_parent.haveLock());
@@ -302,9 +497,14 @@ namespace Clypsalot
         switch (m_type)
         {
             case PropertyType::boolean: return std::any(booleanValue());
+            case PropertyType::doubleArray: return std::any(doubleArrayValue());
+            case PropertyType::doubleTable: return std::any(doubleTableValue());
             case PropertyType::file: return std::any(fileValue());
             case PropertyType::integer: return std::any(integerValue());
+            case PropertyType::integerArray: return std::any(integerArrayValue());
             case PropertyType::real: return std::any(realValue());
+            case PropertyType::realArray: return std::any(realArrayValue());
+            case PropertyType::realTable: return std::any(realTableValue());
             case PropertyType::size: return std::any(sizeValue());
             case PropertyType::string: return std::any(stringValue());
         }
@@ -322,9 +522,14 @@ namespace Clypsalot
     std::string toString(const Property::Variant& in_variant) noexcept
     {
         if (std::holds_alternative<Property::BooleanType>(in_variant)) return makeString(std::get<Property::BooleanType>(in_variant));
+        if (std::holds_alternative<Property::DoubleArrayType>(in_variant)) return toString(std::get<Property::DoubleArrayType>(in_variant));
+        if (std::holds_alternative<Property::DoubleTableType>(in_variant)) return toString(std::get<Property::DoubleTableType>(in_variant));
         if (std::holds_alternative<Property::FileType>(in_variant)) return std::get<Property::FileType>(in_variant);
         if (std::holds_alternative<Property::IntegerType>(in_variant)) return std::to_string(std::get<Property::IntegerType>(in_variant));
+        if (std::holds_alternative<Property::IntegerArrayType>(in_variant)) return toString(std::get<Property::IntegerArrayType>(in_variant));
         if (std::holds_alternative<Property::RealType>(in_variant)) return std::to_string(std::get<Property::RealType>(in_variant));
+        if (std::holds_alternative<Property::RealArrayType>(in_variant)) return toString(std::get<Property::RealArrayType>(in_variant));
+        if (std::holds_alternative<Property::RealTableType>(in_variant)) return toString(std::get<Property::RealTableType>(in_variant));
         if (std::holds_alternative<Property::SizeType>(in_variant)) return std::to_string(std::get<Property::SizeType>(in_variant));
         if (std::holds_alternative<Property::StringType>(in_variant)) return std::get<Property::StringType>(in_variant);
 
@@ -336,9 +541,14 @@ namespace Clypsalot
         switch (in_type)
         {
             case PropertyType::boolean: return "boolean";
+            case PropertyType::doubleArray: return "double array";
+            case PropertyType::doubleTable: return "double table";
             case PropertyType::file: return "file";
             case PropertyType::integer: return "integer";
+            case PropertyType::integerArray: return "integer array";
             case PropertyType::real: return "real";
+            case PropertyType::realArray: return "real array";
+            case PropertyType::realTable: return "real table";
             case PropertyType::size: return "size";
             case PropertyType::string: return "string";
         }
@@ -346,6 +556,27 @@ namespace Clypsalot
         FATAL_ERROR(makeString("Unhandled PropertyType value: ", static_cast<int>(in_type)));
     }
 
+    /// @brief True if the type holds a single number which is what automation requires.
+    bool propertyTypeIsScalar(const PropertyType in_type) noexcept
+    {
+        switch (in_type)
+        {
+            case PropertyType::boolean: return true;
+            case PropertyType::integer: return true;
+            case PropertyType::real: return true;
+            case PropertyType::size: return true;
+            case PropertyType::doubleArray: return false;
+            case PropertyType::doubleTable: return false;
+            case PropertyType::file: return false;
+            case PropertyType::integerArray: return false;
+            case PropertyType::realArray: return false;
+            case PropertyType::realTable: return false;
+            case PropertyType::string: return false;
+        }
+
+        FATAL_ERROR(makeString("Unhandled PropertyType value: ", static_cast<int>(in_type)));
+    }
+
     std::ostream& operator<<(std::ostream& in_os, const PropertyType& in_rhs) noexcept
     {
         in_os << toString(in_rhs);
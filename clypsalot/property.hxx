@@ -18,6 +18,8 @@
 #include <string>
 #include <variant>
 
+#include <clypsalot/array.hxx>
+
 #include <clypsalot/forward.hxx>
 
 namespace Clypsalot
@@ -25,22 +27,34 @@ namespace Clypsalot
     enum class PropertyType : uint_fast8_t
     {
         boolean,
+        doubleArray,
+        doubleTable,
         file,
         integer,
+        integerArray,
         real,
+        realArray,
+        realTable,
         size,
         string
     };
 
     class Property
     {
+        friend Automation;
         friend Object;
 
         public:
+        using Handle = std::size_t;
         using BooleanType = bool;
+        using DoubleArrayType = SharedArray<double>;
+        using DoubleTableType = SharedTable<double>;
         using FileType = std::filesystem::path;
         using IntegerType = int;
+        using IntegerArrayType = SharedArray<int>;
         using RealType = float;
+        using RealArrayType = SharedArray<float>;
+        using RealTableType = SharedTable<float>;
         using SizeType = size_t;
         using StringType = std::string;
         using Flags = uint_fast8_t;
@@ -48,9 +62,14 @@ namespace Clypsalot
         using Variant = std::variant
         <
             BooleanType,
+            DoubleArrayType,
+            DoubleTableType,
             FileType,
             IntegerType,
+            IntegerArrayType,
             RealType,
+            RealArrayType,
+            RealTableType,
             SizeType,
             StringType
         >;
@@ -61,6 +80,7 @@ namespace Clypsalot
             Configurable = 1 << 0,
             Required = 1 << 1,
             PublicMutable = 1 << 2,
+            Automatable = 1 << 3,
         };
 
         const Lockable& m_parent;
@@ -72,14 +92,20 @@ namespace Clypsalot
 
         protected:
         void set(const std::any& in_value);
+        void assign(const Variant& in_value);
         void defined(const bool in_defined);
         void enforcePublicMutable() const;
         void enforceType(const PropertyType in_enforceType) const;
         void enforceDefined() const;
         BooleanType& booleanRef();
+        DoubleArrayType& doubleArrayRef();
+        DoubleTableType& doubleTableRef();
         FileType& fileRef();
         IntegerType& integerRef();
+        IntegerArrayType& integerArrayRef();
         RealType& realRef();
+        RealArrayType& realArrayRef();
+        RealTableType& realTableRef();
         SizeType& sizeRef();
         StringType& stringRef();
 
@@ -93,15 +119,27 @@ namespace Clypsalot
         bool hasFlag(const Flags in_flags) const noexcept;
         bool defined() const noexcept;
         Variant variant() const noexcept;
+        void variant(const Variant& in_value);
+        Variant convert(const std::any& in_value) const;
         std::string valueToString() const;
         BooleanType booleanValue() const;
         void booleanValue(const BooleanType in_value);
+        DoubleArrayType doubleArrayValue() const;
+        void doubleArrayValue(const DoubleArrayType& in_value);
+        DoubleTableType doubleTableValue() const;
+        void doubleTableValue(const DoubleTableType& in_value);
         FileType fileValue() const;
         void fileValue(const FileType& in_value);
         IntegerType integerValue() const;
         void integerValue(const IntegerType in_value);
+        IntegerArrayType integerArrayValue() const;
+        void integerArrayValue(const IntegerArrayType& in_value);
         RealType realValue() const;
         void realValue(const RealType in_value);
+        RealArrayType realArrayValue() const;
+        void realArrayValue(const RealArrayType& in_value);
+        RealTableType realTableValue() const;
+        void realTableValue(const RealTableType& in_value);
         SizeType sizeValue() const;
         void sizeValue(const SizeType in_value);
         StringType stringValue() const;
@@ -110,6 +148,10 @@ namespace Clypsalot
         void anyValue(const std::any& in_value);
     };
 
+    /// @brief Property values that have been resolved to handles and converted to the type of
+    /// each Property so they can be applied with out any lookups or conversions.
+    using PropertyValues = std::vector<std::pair<Property::Handle, Property::Variant>>;
+
     struct PropertyConfig
     {
         const std::string name;
@@ -122,5 +164,6 @@ namespace Clypsalot
     // with types that can be set in it.
     std::string toString(const Property::Variant& in_variant) noexcept;
     std::string toString(const PropertyType in_type) noexcept;
+    bool propertyTypeIsScalar(const PropertyType in_type) noexcept;
     std::ostream& operator<<(std::ostream& in_os, const PropertyType& in_rhs) noexcept;
 }
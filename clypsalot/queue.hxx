@@ -0,0 +1,240 @@
+/* Copyright 2023 Tyler Riddle
+ *
+ * This file is part of Clypsalot. Clypsalot is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU Lesser General Public License as published by the Free Software Foundation, either version 3 of the License,
+ * or (at your option) any later version. Clypsalot is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along with Clypsalot. If not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <concepts>
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+
+/// @file
+namespace Clypsalot
+{
+    /// @brief The size used to keep atomics that are written by different threads from sharing
+    /// a cache line.
+    static constexpr std::size_t cacheLineSize = 64;
+
+    template <typename T>
+    concept QueueValue = std::is_nothrow_default_constructible_v<T> && std::is_nothrow_copy_assignable_v<T>;
+
+    /**
+     * @brief A bounded lock free queue that supports any number of producers and consumers.
+     *
+     * This is the array based queue by Dmitry Vyukov. Every slot carries a sequence number which
+     * tells producers and consumers if the slot is ready for them so neither side ever has to take
+     * a lock or allocate memory after construction. The capacity is rounded up to a power of two.
+     * push() and pop() fail instead of blocking when the queue is full or empty.
+     */
+    template <QueueValue T>
+    class BoundedQueue
+    {
+        struct Slot
+        {
+            std::atomic<std::size_t> sequence;
+            T value;
+        };
+
+        const std::size_t m_mask;
+        const std::unique_ptr<Slot[]> m_slots;
+        alignas(cacheLineSize) std::atomic<std::size_t> m_pushPosition = 0;
+        alignas(cacheLineSize) std::atomic<std::size_t> m_popPosition = 0;
+
+        public:
+        BoundedQueue(const std::size_t in_capacity) :
+            m_mask(std::bit_ceil(std::max(in_capacity, static_cast<std::size_t>(2))) - 1),
+            m_slots(new Slot[m_mask + 1])
+        {
+            for (std::size_t i = 0; i <= m_mask; i++)
+            {
+                m_slots[i].sequence.store(i, std::memory_order_relaxed);
+            }
+        }
+
+        BoundedQueue(const BoundedQueue&) = delete;
+        void operator=(const BoundedQueue&) = delete;
+
+        std::size_t capacity() const noexcept
+        {
+            return m_mask + 1;
+        }
+
+        /// @brief The number of values in the queue. This is only a snapshot when other threads
+        /// are using the queue.
+        std::size_t size() const noexcept
+        {
+            const auto pushed = m_pushPosition.load(std::memory_order_acquire);
+            const auto popped = m_popPosition.load(std::memory_order_acquire);
+
+            return pushed > popped ? pushed - popped : 0;
+        }
+
+        bool push(const T& in_value) noexcept
+        {
+            auto position = m_pushPosition.load(std::memory_order_relaxed);
+
+            while (true)
+            {
+                auto& slot = m_slots[position & m_mask];
+                const auto sequence = slot.sequence.load(std::memory_order_acquire);
+                const auto difference = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(position);
+
+                if (difference == 0)
+                {
+                    if (m_pushPosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+                    {
+                        slot.value = in_value;
+                        slot.sequence.store(position + 1, std::memory_order_release);
+                        return true;
+                    }
+                }
+                else if (difference < 0)
+                {
+                    return false;
+                }
+                else
+                {
+                    position = m_pushPosition.load(std::memory_order_relaxed);
+                }
+            }
+        }
+
+        bool pop(T& out_value) noexcept
+        {
+            auto position = m_popPosition.load(std::memory_order_relaxed);
+
+            while (true)
+            {
+                auto& slot = m_slots[position & m_mask];
+                const auto sequence = slot.sequence.load(std::memory_order_acquire);
+                const auto difference = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(position + 1);
+
+                if (difference == 0)
+                {
+                    if (m_popPosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+                    {
+                        out_value = slot.value;
+                        slot.sequence.store(position + m_mask + 1, std::memory_order_release);
+                        return true;
+                    }
+                }
+                else if (difference < 0)
+                {
+                    return false;
+                }
+                else
+                {
+                    position = m_popPosition.load(std::memory_order_relaxed);
+                }
+            }
+        }
+    };
+
+    template <typename T>
+    concept RingValue = std::is_nothrow_default_constructible_v<T> && std::is_nothrow_move_assignable_v<T>;
+
+    /**
+     * @brief A bounded lock free queue with exactly one producer and one consumer.
+     *
+     * The producer only writes the tail position and the consumer only writes the head position
+     * so each side needs a single acquire load and release store per operation. The capacity is
+     * exact instead of being rounded. A popped slot is reset to a default constructed value so
+     * anything it referenced is released by the consumer.
+     */
+    template <RingValue T>
+    class RingBuffer
+    {
+        const std::size_t m_capacity;
+        const std::unique_ptr<T[]> m_slots;
+        alignas(cacheLineSize) std::atomic<std::size_t> m_head = 0;
+        alignas(cacheLineSize) std::atomic<std::size_t> m_tail = 0;
+
+        public:
+        RingBuffer(const std::size_t in_capacity) :
+            m_capacity(std::max(in_capacity, static_cast<std::size_t>(1))),
+            m_slots(new T[m_capacity])
+        { }
+
+        RingBuffer(const RingBuffer&) = delete;
+        void operator=(const RingBuffer&) = delete;
+
+        std::size_t capacity() const noexcept
+        {
+            return m_capacity;
+        }
+
+        /// @brief The number of values in the queue. Exact when called by the producer or the
+        /// consumer except that the other side may have changed it by the time it is used.
+        std::size_t size() const noexcept
+        {
+            const auto head = m_head.load(std::memory_order_acquire);
+            const auto tail = m_tail.load(std::memory_order_acquire);
+
+            return tail - head;
+        }
+
+        bool empty() const noexcept
+        {
+            return size() == 0;
+        }
+
+        bool full() const noexcept
+        {
+            return size() == m_capacity;
+        }
+
+        /// @brief Add a value to the queue. Only the producer may call this.
+        bool push(T in_value) noexcept
+        {
+            const auto tail = m_tail.load(std::memory_order_relaxed);
+
+            if (tail - m_head.load(std::memory_order_acquire) == m_capacity) return false;
+
+            m_slots[tail % m_capacity] = std::move(in_value);
+            m_tail.store(tail + 1, std::memory_order_release);
+
+            return true;
+        }
+
+        /// @brief The oldest value in the queue or nullptr if it is empty. Only the consumer may
+        /// call this.
+        T* front() noexcept
+        {
+            const auto head = m_head.load(std::memory_order_relaxed);
+
+            if (head == m_tail.load(std::memory_order_acquire)) return nullptr;
+
+            return &m_slots[head % m_capacity];
+        }
+
+        const T* front() const noexcept
+        {
+            return const_cast<RingBuffer*>(this)->front();
+        }
+
+        /// @brief Remove the oldest value from the queue. Only the consumer may call this.
+        bool pop() noexcept
+        {
+            const auto head = m_head.load(std::memory_order_relaxed);
+
+            if (head == m_tail.load(std::memory_order_acquire)) return false;
+
+            m_slots[head % m_capacity] = T();
+            m_head.store(head + 1, std::memory_order_release);
+
+            return true;
+        }
+    };
+}
@@ -0,0 +1,244 @@
+/* Copyright 2023 Tyler Riddle
+ *
+ * This file is part of Clypsalot. Clypsalot is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU Lesser General Public License as published by the Free Software Foundation, either version 3 of the License,
+ * or (at your option) any later version. Clypsalot is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along with Clypsalot. If not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <cassert>
+#include <cerrno>
+#include <cstring>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <clypsalot/error.hxx>
+#include <clypsalot/logger.hxx>
+#include <clypsalot/property.hxx>
+#include <clypsalot/recorder.hxx>
+#include <clypsalot/util.hxx>
+
+/// @file
+namespace Clypsalot
+{
+    const std::string RecorderObject::kindName = "Recorder";
+    static const std::string filePropertyName = "File";
+    static const std::string formatPropertyName = "Format";
+    static const std::string ringSizePropertyName = "Ring Size";
+    static const std::string directPropertyName = "Direct I/O";
+    static const std::string ringFillPropertyName = "Ring Fill";
+    static const std::string overrunsPropertyName = "Overruns";
+    static const PropertyList recorderProperties = {
+        { filePropertyName, PropertyType::file, Property::Configurable | Property::Required, nullptr },
+        { formatPropertyName, PropertyType::string, Property::Configurable, "float32" },
+        // In bytes which is about 2.7 seconds of 64 channel float32 at 96 kHz.
+        { ringSizePropertyName, PropertyType::size, Property::Configurable, 64 * 1024 * 1024 },
+        { directPropertyName, PropertyType::boolean, Property::Configurable, false },
+        // Updated every time a block is processed.
+        { ringFillPropertyName, PropertyType::size, Property::NoFlags, 0 },
+        { overrunsPropertyName, PropertyType::size, Property::NoFlags, 0 },
+    };
+    // O_DIRECT needs the offsets and sizes of writes to be multiples of the logical block size of
+    // the file system which is never more than a page.
+    static constexpr std::size_t directAlignment = 4096;
+
+    static std::size_t roundUp(const std::size_t in_value, const std::size_t in_multiple) noexcept
+    {
+        return (in_value + in_multiple - 1) / in_multiple * in_multiple;
+    }
+
+    std::shared_ptr<RecorderObject> RecorderObject::make()
+    {
+        return _makeObject<RecorderObject>(kindName);
+    }
+
+    RecorderObject::RecorderObject(const std::string& in_kind) :
+        Object(in_kind),
+        m_header(wavHeaderSize)
+    {
+        std::scoped_lock lock(*this);
+
+        addProperties(recorderProperties);
+
+        m_ringFill = &propertySizeRef(ringFillPropertyName);
+        m_overruns = &propertySizeRef(overrunsPropertyName);
+        m_input = static_cast<PcmInputPort*>(&addInput<PcmInputPort>("input"));
+    }
+
+    RecorderObject::~RecorderObject() noexcept
+    {
+        stopWriter();
+    }
+
+    // Write the final header and close the file.
+    void RecorderObject::writerFinished(void* io_context, const std::size_t in_position) noexcept
+    {
+        auto& recorder = *static_cast<RecorderObject*>(io_context);
+        auto& writer = *recorder.m_writer;
+        const auto dataBytes = in_position - wavHeaderSize;
+        auto info = recorder.m_info;
+
+        info.frames = info.channels > 0 ? dataBytes / info.frameSize() : 0;
+        info.container = writeWavHeader(recorder.m_header.data(), info);
+
+        if (const auto error = writeAt(recorder.m_fd, recorder.m_header.data(), wavHeaderSize, 0)) writer.fail(error);
+        else if (ftruncate(recorder.m_fd, in_position) != 0) writer.fail(errno);
+
+        close(recorder.m_fd);
+        recorder.m_fd = -1;
+    }
+
+    // Drain the ring and wait for the file to be finished.
+    void RecorderObject::stopWriter() noexcept
+    {
+        if (! m_writer) return;
+
+        m_writer->finish(true);
+        m_writer->wait();
+    }
+
+    /**
+     * @throws ValueError if the File property is not set or the format is unknown.
+     * @throws RuntimeError if the file can not be created.
+     *
+     * The file is created with a placeholder header right away so any problem with it is found
+     * here instead of by the writer.
+     */
+    void RecorderObject::handleConfigure(const ObjectConfig& in_config)
+    {
+        assert(haveLock());
+
+        Object::handleConfigure(in_config);
+        stopWriter();
+
+        const auto& file = property(filePropertyName);
+
+        if (! file.defined()) throw ValueError(makeString("Property is required: ", filePropertyName));
+
+        auto config = m_input->config();
+
+        config.format = stringToPcmFormat(property(formatPropertyName).stringValue());
+        config.layout = PcmLayout::planar;
+        m_input->config(config);
+
+        m_info = {};
+        m_info.format = config.format;
+        m_info.sampleSize = config.format == PcmFormat::int24 ? 3 : pcmSampleSize(config.format);
+
+        const auto path = file.fileValue();
+        const auto flags = O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC;
+
+        m_direct = property(directPropertyName).booleanValue();
+        m_fd = open(path.c_str(), flags | (m_direct ? O_DIRECT : 0), 0644);
+
+        // File systems such as tmpfs do not support O_DIRECT.
+        if (m_fd < 0 && m_direct && errno == EINVAL)
+        {
+            OBJECT_LOGGER(debug, "O_DIRECT is not supported for ", path, "; using buffered writes");
+            m_direct = false;
+            m_fd = open(path.c_str(), flags, 0644);
+        }
+
+        if (m_fd < 0) throw RuntimeError(makeString("Could not create ", path, ": ", std::strerror(errno)));
+
+        writeWavHeader(m_header.data(), m_info);
+
+        if (const auto error = writeAt(m_fd, m_header.data(), wavHeaderSize, 0))
+        {
+            close(m_fd);
+            m_fd = -1;
+            throw RuntimeError(makeString("Could not write to ", path, ": ", std::strerror(error)));
+        }
+
+        const auto ringSize = roundUp(std::max(property(ringSizePropertyName).sizeValue(), 2 * writeSize), writeSize);
+
+        // The ring storage past the data is still mapped so a short direct write can be padded out
+        // and the file truncated afterwards.
+        m_writer = std::make_unique<RingWriter>(m_fd, ringSize, wavHeaderSize, writeSize, m_direct ? directAlignment : 1, writerFinished, this);
+        m_interleaved.clear();
+        *m_ringFill = 0;
+        *m_overruns = 0;
+    }
+
+    // The link decides the channels and the size of the blocks.
+    void RecorderObject::handleLinked(const PortLink& in_link)
+    {
+        assert(haveLock());
+
+        Object::handleLinked(in_link);
+
+        if (&in_link.to() != m_input) return;
+
+        const auto& config = static_cast<const PcmPortLink&>(in_link).inputConfig();
+
+        m_info.channels = config.channels;
+        m_info.rate = config.rate;
+        m_interleaved.resize(config.blockSize * m_info.frameSize());
+    }
+
+    ObjectProcessResult RecorderObject::process()
+    {
+        assert(haveLock());
+
+        if (const auto error = m_writer->error())
+        {
+            throw RuntimeError(makeString("Could not write the recording: ", std::strerror(error)));
+        }
+
+        const auto& buffer = m_input->buffer();
+        const auto frames = m_input->frames();
+
+        assert(frames * m_info.frameSize() <= m_interleaved.size());
+
+        writePcmFrames(m_interleaved.data(), buffer, m_info, frames);
+
+        auto& ring = m_writer->ring();
+
+        if (! ring.write(m_interleaved.data(), frames * m_info.frameSize())) (*m_overruns)++;
+
+        m_writer->commit();
+        *m_ringFill = ring.size();
+        m_input->consume();
+
+        return ObjectProcessResult::finished;
+    }
+
+    /*
+     * The rest of the ring is written and the file finished by the completions so this does not
+     * wait on the disk. If the IoService is full that is left for when the Object is configured
+     * again or destroyed.
+     */
+    void RecorderObject::handleEndOfData() noexcept
+    {
+        if (m_writer) m_writer->finish(false);
+
+        Object::handleEndOfData();
+    }
+
+    const PcmFileInfo& RecorderObject::info() const noexcept
+    {
+        assert(haveLock());
+
+        return m_info;
+    }
+
+    /// @brief True if the file was opened with O_DIRECT so writes skip the page cache.
+    bool RecorderObject::direct() const noexcept
+    {
+        assert(haveLock());
+
+        return m_direct;
+    }
+
+    /// @brief The bytes in the ring right now. Safe to call from any thread.
+    std::size_t RecorderObject::ringFill() const noexcept
+    {
+        return m_writer ? m_writer->ring().size() : 0;
+    }
+}
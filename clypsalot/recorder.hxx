@@ -0,0 +1,70 @@
+/* Copyright 2023 Tyler Riddle
+ *
+ * This file is part of Clypsalot. Clypsalot is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU Lesser General Public License as published by the Free Software Foundation, either version 3 of the License,
+ * or (at your option) any later version. Clypsalot is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along with Clypsalot. If not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include <clypsalot/io.hxx>
+#include <clypsalot/memory.hxx>
+#include <clypsalot/object.hxx>
+#include <clypsalot/pcm.hxx>
+#include <clypsalot/wav.hxx>
+
+/// @file
+namespace Clypsalot
+{
+    /**
+     * @brief Record the samples it is given to a WAV file.
+     *
+     * Processing only interleaves the block into a ByteRing. The ring is drained with large writes
+     * submitted to the IoService so a slow disk never holds up the audio threads. When the ring is
+     * too full for a block the block is dropped and counted as an overrun. The header is written
+     * once the recording is finished which happens at the end of the data or when the Object is
+     * configured again or destroyed. Recordings that outgrow RIFF are written as RF64.
+     */
+    class RecorderObject : public Object
+    {
+        std::size_t* m_ringFill = nullptr;
+        std::size_t* m_overruns = nullptr;
+        PcmInputPort* m_input = nullptr;
+        PcmFileInfo m_info;
+        PageMapping m_header;
+        std::vector<std::byte> m_interleaved;
+        int m_fd = -1;
+        bool m_direct = false;
+        std::unique_ptr<RingWriter> m_writer;
+
+        static void writerFinished(void* io_context, const std::size_t in_position) noexcept;
+        void stopWriter() noexcept;
+
+        protected:
+        virtual void handleConfigure(const ObjectConfig& in_config) override;
+        virtual void handleEndOfData() noexcept override;
+        virtual void handleLinked(const PortLink& in_link) override;
+        virtual ObjectProcessResult process() override;
+
+        public:
+        static const std::string kindName;
+        /// @brief The least that is written to the file at a time. The ring size is rounded up to a
+        /// multiple.
+        static constexpr std::size_t writeSize = 1024 * 1024;
+
+        static std::shared_ptr<RecorderObject> make();
+        RecorderObject(const std::string& in_kind);
+        virtual ~RecorderObject() noexcept;
+        const PcmFileInfo& info() const noexcept;
+        bool direct() const noexcept;
+        std::size_t ringFill() const noexcept;
+    };
+}
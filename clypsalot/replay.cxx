@@ -0,0 +1,251 @@
+/* Copyright 2023 Tyler Riddle
+ *
+ * This file is part of Clypsalot. Clypsalot is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU Lesser General Public License as published by the Free Software Foundation, either version 3 of the License,
+ * or (at your option) any later version. Clypsalot is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along with Clypsalot. If not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+
+
+#include <cassert>
+#include <cerrno>
+#include <cstring>
+
+#include <clypsalot/control.hxx>
+#include <clypsalot/error.hxx>
+#include <clypsalot/logger.hxx>
+#include <clypsalot/macros.hxx>
+#include <clypsalot/pcm.hxx>
+#include <clypsalot/property.hxx>
+#include <clypsalot/replay.hxx>
+#include <clypsalot/util.hxx>
+
+/// @file
+namespace Clypsalot
+{
+    const std::string ReplayObject::kindName = "Link Replay";
+    static const std::string filePropertyName = "File";
+    static const std::string realTimePropertyName = "Real Time";
+    static const std::string recordsPropertyName = "Records";
+    static const std::string outputName = "output";
+    static const PropertyList replayProperties = {
+        { filePropertyName, PropertyType::file, Property::Configurable | Property::Required, nullptr },
+        { realTimePropertyName, PropertyType::boolean, Property::Configurable, false },
+        // The number of records delivered since the Object was configured.
+        { recordsPropertyName, PropertyType::size, Property::NoFlags, 0 },
+    };
+
+    std::shared_ptr<ReplayObject> ReplayObject::make()
+    {
+        return _makeObject<ReplayObject>(kindName);
+    }
+
+    ReplayObject::ReplayObject(const std::string& in_kind) :
+        Object(in_kind)
+    {
+        std::scoped_lock lock(*this);
+
+        addProperties(replayProperties);
+
+        m_records = &propertySizeRef(recordsPropertyName);
+        m_sleep.operation = IoOperation::sleep;
+        m_sleep.complete = sleepComplete;
+        m_sleep.context = this;
+    }
+
+    ReplayObject::~ReplayObject() noexcept
+    {
+        std::scoped_lock lock(*this);
+
+        stopSleeping();
+    }
+
+    void ReplayObject::sleepComplete(IoRequest& io_request) noexcept
+    {
+        auto& object = *static_cast<ReplayObject*>(io_request.context);
+        std::scoped_lock lock(object);
+
+        object.m_sleeping = false;
+        object.m_sleepDone.notify_all();
+
+        if (io_request.result != -ECANCELED) wakeObject(object);
+    }
+
+    // Cancel the sleep and block until it is over.
+    void ReplayObject::stopSleeping() noexcept
+    {
+        assert(haveLock());
+
+        if (! m_sleeping) return;
+
+        ioService().cancel(m_sleep);
+        m_sleepDone.wait(*this, [this] { return ! m_sleeping; });
+    }
+
+    /// @throws RuntimeError if the Object was not configured.
+    const CaptureInfo& ReplayObject::info() const
+    {
+        assert(haveLock());
+
+        if (! m_reader) throw RuntimeError("The replay has not been configured");
+
+        return m_reader->info();
+    }
+
+    bool ReplayObject::ready() const noexcept
+    {
+        return ! m_sleeping && Object::ready();
+    }
+
+    /**
+     * @throws ValueError if the file is not a capture or the output is already a port of another
+     * type than what the file captured.
+     * @throws RuntimeError if the file can not be read.
+     */
+    void ReplayObject::handleConfigure(const ObjectConfig& in_config)
+    {
+        assert(haveLock());
+
+        Object::handleConfigure(in_config);
+        stopSleeping();
+
+        const auto& file = property(filePropertyName);
+
+        if (! file.defined()) throw ValueError(makeString("Property is required: ", filePropertyName));
+
+        auto reader = std::make_unique<CaptureReader>(file.fileValue());
+        const auto& info = reader->info();
+
+        switch (info.kind)
+        {
+            case CaptureKind::pcm:
+                if (m_controlOutput != nullptr) throw ValueError("The output of the replay is a control port");
+                if (m_pcmOutput == nullptr) m_pcmOutput = static_cast<PcmOutputPort*>(&addOutput<PcmOutputPort>(outputName));
+
+                m_pcmOutput->config(info.config);
+                break;
+
+            case CaptureKind::control:
+                if (m_pcmOutput != nullptr) throw ValueError("The output of the replay is a PCM port");
+                if (m_controlOutput == nullptr) m_controlOutput = static_cast<ControlOutputPort*>(&addOutput<ControlOutputPort>(outputName));
+                break;
+        }
+
+        OBJECT_LOGGER(debug, "Opened ", info.kind, " capture; records=", reader->records(), " dropped=", reader->dropped());
+
+        m_reader = std::move(reader);
+        m_realTime = property(realTimePropertyName).booleanValue();
+        m_haveRecord = false;
+        m_started = false;
+        *m_records = 0;
+    }
+
+    // The record stays current until it has been delivered.
+    bool ReplayObject::nextRecord() noexcept
+    {
+        if (! m_haveRecord) m_haveRecord = m_reader->next(m_record);
+
+        if (m_haveRecord && ! m_started)
+        {
+            m_start = Clock::now();
+            m_firstTime = m_record.time;
+            m_started = true;
+        }
+
+        return m_haveRecord;
+    }
+
+    /**
+     * @brief Sleep until the time of the current record if it is not here yet.
+     * @return false if there is no need to sleep.
+     * @throws RuntimeError if the IoService is full.
+     */
+    bool ReplayObject::sleep()
+    {
+        assert(haveLock());
+        assert(m_haveRecord);
+
+        if (! m_realTime) return false;
+
+        const auto deadline = m_start + std::chrono::nanoseconds(m_record.time - m_firstTime);
+
+        if (Clock::now() >= deadline) return false;
+
+        m_sleep.offset = std::chrono::nanoseconds(deadline.time_since_epoch()).count();
+
+        if (! ioService().submit(m_sleep)) throw RuntimeError("The I/O service is full");
+
+        m_sleeping = true;
+        return true;
+    }
+
+    /// @throws RuntimeError if a record does not fit the blocks of the capture.
+    ObjectProcessResult ReplayObject::processPcm()
+    {
+        if (! nextRecord()) return ObjectProcessResult::endOfData;
+        if (sleep()) return ObjectProcessResult::blocked;
+
+        auto& buffer = m_pcmOutput->buffer();
+        const auto frames = m_record.count;
+        const auto planar = buffer.layout() == PcmLayout::planar;
+        const auto rows = planar ? buffer.channels() : buffer.groups();
+        const auto rowBytes = frames * buffer.lanes() * pcmSampleSize(buffer.format());
+
+        if (frames > buffer.frames() || m_record.bytes != rows * rowBytes) throw RuntimeError("Capture record does not fit the blocks");
+
+        for (std::size_t row = 0; row < rows; row++)
+        {
+            std::memcpy(planar ? buffer.channelData(row) : buffer.groupData(row), m_record.data + row * rowBytes, rowBytes);
+        }
+
+        m_pcmOutput->commit(frames);
+        m_haveRecord = false;
+        ++*m_records;
+
+        return nextRecord() ? ObjectProcessResult::finished : ObjectProcessResult::endOfData;
+    }
+
+    // Every event that is due goes out at once until a link is full.
+    ObjectProcessResult ReplayObject::processControl()
+    {
+        std::size_t sent = 0;
+
+        while (nextRecord())
+        {
+            ControlEvent event;
+
+            if (m_record.bytes != sizeof(event)) throw RuntimeError("Capture record is not a control event");
+            if (sleep() || ! m_controlOutput->push(*reinterpret_cast<const ControlEvent*>(std::memcpy(&event, m_record.data, sizeof(event)))))
+            {
+                return sent > 0 ? ObjectProcessResult::finished : ObjectProcessResult::blocked;
+            }
+
+            m_haveRecord = false;
+            ++*m_records;
+            sent++;
+        }
+
+        return ObjectProcessResult::endOfData;
+    }
+
+    /*
+     * The end of the data is returned along with the last record so nothing has to wake the
+     * Object again to find it. The inputs on the other side process what was delivered first.
+     */
+    ObjectProcessResult ReplayObject::process()
+    {
+        assert(haveLock());
+
+        switch (m_reader->info().kind)
+        {
+            case CaptureKind::pcm: return processPcm();
+            case CaptureKind::control: return processControl();
+        }
+
+        FATAL_ERROR(makeString("Unhandled CaptureKind value: ", m_reader->info().kind));
+    }
+}
@@ -0,0 +1,77 @@
+/* Copyright 2023 Tyler Riddle
+ *
+ * This file is part of Clypsalot. Clypsalot is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU Lesser General Public License as published by the Free Software Foundation, either version 3 of the License,
+ * or (at your option) any later version. Clypsalot is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along with Clypsalot. If not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+
+#include <clypsalot/capture.hxx>
+#include <clypsalot/io.hxx>
+#include <clypsalot/object.hxx>
+
+/// @file
+namespace Clypsalot
+{
+    /**
+     * @brief Play back a capture file made by PortLink::startCapture().
+     *
+     * The Object gets an output named output of the port type that was captured when it is first
+     * configured. The blocks or events come out with the settings the captured output had so a
+     * link to the same kind of input does the same work it did when the capture was made.
+     *
+     * Records are delivered as fast as they are taken unless Real Time is set in which case each
+     * record waits for its time relative to the first record with a sleep submitted to the
+     * IoService.
+     */
+    class ReplayObject : public Object
+    {
+        using Clock = std::chrono::steady_clock;
+
+        std::size_t* m_records = nullptr;
+        std::unique_ptr<CaptureReader> m_reader;
+        PcmOutputPort* m_pcmOutput = nullptr;
+        ControlOutputPort* m_controlOutput = nullptr;
+        bool m_realTime = false;
+        CaptureRecord m_record;
+        bool m_haveRecord = false;
+        bool m_started = false;
+        Clock::time_point m_start;
+        std::uint64_t m_firstTime = 0;
+        IoRequest m_sleep;
+        bool m_sleeping = false;
+        std::condition_variable_any m_sleepDone;
+
+        static void sleepComplete(IoRequest& io_request) noexcept;
+        void stopSleeping() noexcept;
+        bool nextRecord() noexcept;
+        bool sleep();
+        ObjectProcessResult processPcm();
+        ObjectProcessResult processControl();
+
+        protected:
+        virtual void handleConfigure(const ObjectConfig& in_config) override;
+        virtual ObjectProcessResult process() override;
+
+        public:
+        static const std::string kindName;
+
+        static std::shared_ptr<ReplayObject> make();
+        ReplayObject(const std::string& in_kind);
+        virtual ~ReplayObject() noexcept;
+        const CaptureInfo& info() const;
+        virtual bool ready() const noexcept override;
+    };
+}
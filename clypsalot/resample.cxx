@@ -0,0 +1,302 @@
+/* Copyright 2023 Tyler Riddle
+ *
+ * This file is part of Clypsalot. Clypsalot is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU Lesser General Public License as published by the Free Software Foundation, either version 3 of the License,
+ * or (at your option) any later version. Clypsalot is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along with Clypsalot. If not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstring>
+#include <numbers>
+#include <numeric>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define CLYPSALOT_X86_KERNELS
+#include <immintrin.h>
+#endif
+
+#include <clypsalot/error.hxx>
+#include <clypsalot/macros.hxx>
+#include <clypsalot/resample.hxx>
+#include <clypsalot/util.hxx>
+
+/// @file
+namespace Clypsalot
+{
+    struct ResamplerPreset
+    {
+        std::size_t taps;
+        double beta;
+    };
+
+    static ResamplerPreset resamplerPreset(const PcmResamplerQuality in_quality) noexcept
+    {
+        switch (in_quality)
+        {
+            case PcmResamplerQuality::fast: return { 16, 5.0 };
+            case PcmResamplerQuality::balanced: return { 32, 8.0 };
+            case PcmResamplerQuality::best: return { 64, 12.0 };
+        }
+
+        FATAL_ERROR(makeString("Unhandled PcmResamplerQuality value: ", static_cast<int>(in_quality)));
+    }
+
+    static double sinc(const double in_value) noexcept
+    {
+        if (in_value == 0) return 1;
+
+        const auto x = std::numbers::pi * in_value;
+
+        return std::sin(x) / x;
+    }
+
+    static float dotScalar(const float* in_coefficients, const float* in_samples, const std::size_t in_taps) noexcept
+    {
+        float sum = 0;
+
+        for (std::size_t i = 0; i < in_taps; i++)
+        {
+            sum += in_coefficients[i] * in_samples[i];
+        }
+
+        return sum;
+    }
+
+#ifdef CLYPSALOT_X86_KERNELS
+    // The number of taps is always a multiple of 8 so there is no scalar tail.
+
+    __attribute__((target("sse2")))
+    static float dotSse2(const float* in_coefficients, const float* in_samples, const std::size_t in_taps) noexcept
+    {
+        auto first = _mm_setzero_ps();
+        auto second = _mm_setzero_ps();
+
+        for (std::size_t i = 0; i < in_taps; i += 8)
+        {
+            first = _mm_add_ps(first, _mm_mul_ps(_mm_loadu_ps(in_coefficients + i), _mm_loadu_ps(in_samples + i)));
+            second = _mm_add_ps(second, _mm_mul_ps(_mm_loadu_ps(in_coefficients + i + 4), _mm_loadu_ps(in_samples + i + 4)));
+        }
+
+        auto sum = _mm_add_ps(first, second);
+
+        sum = _mm_add_ps(sum, _mm_movehl_ps(sum, sum));
+        sum = _mm_add_ss(sum, _mm_shuffle_ps(sum, sum, 1));
+
+        return _mm_cvtss_f32(sum);
+    }
+
+    __attribute__((target("avx2")))
+    static float dotAvx2(const float* in_coefficients, const float* in_samples, const std::size_t in_taps) noexcept
+    {
+        auto sum = _mm256_setzero_ps();
+
+        for (std::size_t i = 0; i < in_taps; i += 8)
+        {
+            sum = _mm256_add_ps(sum, _mm256_mul_ps(_mm256_loadu_ps(in_coefficients + i), _mm256_loadu_ps(in_samples + i)));
+        }
+
+        auto half = _mm_add_ps(_mm256_castps256_ps128(sum), _mm256_extractf128_ps(sum, 1));
+
+        half = _mm_add_ps(half, _mm_movehl_ps(half, half));
+        half = _mm_add_ss(half, _mm_shuffle_ps(half, half, 1));
+
+        return _mm_cvtss_f32(half);
+    }
+#endif
+
+    /**
+     * @brief Design the filter and allocate the history of every channel.
+     * @param in_maxFrames The largest number of frames that will be given to process().
+     * @param in_level The highest level of vector instructions to use. It is limited to what the
+     * CPU supports.
+     * @throws ValueError if a rate, the channel count or the maximum frames is zero or if the
+     * ratio of the rates needs more than maxPhases phases.
+     */
+    PcmResampler::PcmResampler(const std::size_t in_inRate, const std::size_t in_outRate, const std::size_t in_channels, const std::size_t in_maxFrames, const PcmResamplerQuality in_quality, const SimdLevel in_level) :
+        m_inRate(in_inRate),
+        m_outRate(in_outRate),
+        m_channels(in_channels),
+        m_maxFrames(in_maxFrames),
+        m_quality(in_quality)
+    {
+        if (m_inRate == 0 || m_outRate == 0) throw ValueError("Sample rates must be greater than zero");
+        if (m_channels == 0) throw ValueError("Resampler channel count must be greater than zero");
+        if (m_maxFrames == 0) throw ValueError("Resampler maximum frames must be greater than zero");
+
+        const auto divisor = std::gcd(m_inRate, m_outRate);
+
+        m_up = m_outRate / divisor;
+        m_down = m_inRate / divisor;
+
+        if (m_up > maxPhases)
+        {
+            throw ValueError(makeString("Resampling from ", m_inRate, " to ", m_outRate, " needs too many phases: ", m_up));
+        }
+
+        const auto preset = resamplerPreset(m_quality);
+        const auto length = m_up * preset.taps;
+        const auto center = (length - 1) / 2.0;
+        const auto attenuation = preset.beta / 0.1102 + 8.7;
+        const auto transition = (attenuation - 8) / (14.36 * preset.taps);
+        // The cutoff is in cycles per input sample and sits in the middle of the transition band
+        // so the stop band starts at the lower of the two Nyquist frequencies.
+        const auto cutoff = std::max(0.5 * std::min(1.0, static_cast<double>(m_up) / m_down) - transition / 2, 0.05);
+        const auto scaledCutoff = cutoff / m_up;
+        const auto windowScale = std::cyl_bessel_i(0.0, preset.beta);
+        std::vector<double> filter(length);
+        double total = 0;
+
+        for (std::size_t n = 0; n < length; n++)
+        {
+            const auto offset = (n - center) / center;
+            const auto window = std::cyl_bessel_i(0.0, preset.beta * std::sqrt(std::max(0.0, 1 - offset * offset))) / windowScale;
+
+            filter[n] = 2 * scaledCutoff * sinc(2 * scaledCutoff * (n - center)) * window;
+            total += filter[n];
+        }
+
+        m_taps = preset.taps;
+        m_coefficients.resize(length);
+
+        // Each phase is stored oldest sample first so it lines up with the history.
+        for (std::size_t phase = 0; phase < m_up; phase++)
+        {
+            for (std::size_t tap = 0; tap < m_taps; tap++)
+            {
+                m_coefficients[phase * m_taps + m_taps - 1 - tap] = filter[phase + tap * m_up] * m_up / total;
+            }
+        }
+
+        m_work.resize(m_channels * (m_taps - 1 + m_maxFrames));
+
+        [[maybe_unused]] const auto level = std::min(in_level, simdLevel());
+
+        m_dot = dotScalar;
+
+#ifdef CLYPSALOT_X86_KERNELS
+        if (level >= SimdLevel::avx2)
+        {
+            m_dot = dotAvx2;
+            m_level = SimdLevel::avx2;
+        }
+        else if (level >= SimdLevel::sse2)
+        {
+            m_dot = dotSse2;
+            m_level = SimdLevel::sse2;
+        }
+#endif
+    }
+
+    float* PcmResampler::work(const std::size_t in_channel) noexcept
+    {
+        return m_work.data() + in_channel * (m_taps - 1 + m_maxFrames);
+    }
+
+    std::size_t PcmResampler::inRate() const noexcept
+    {
+        return m_inRate;
+    }
+
+    std::size_t PcmResampler::outRate() const noexcept
+    {
+        return m_outRate;
+    }
+
+    std::size_t PcmResampler::channels() const noexcept
+    {
+        return m_channels;
+    }
+
+    PcmResamplerQuality PcmResampler::quality() const noexcept
+    {
+        return m_quality;
+    }
+
+    SimdLevel PcmResampler::level() const noexcept
+    {
+        return m_level;
+    }
+
+    /// @brief The number of phases of the filter which is the L of the L/M ratio.
+    std::size_t PcmResampler::phases() const noexcept
+    {
+        return m_up;
+    }
+
+    /// @brief The number of filter taps used for every output sample.
+    std::size_t PcmResampler::taps() const noexcept
+    {
+        return m_taps;
+    }
+
+    /// @brief The largest number of frames process() can write for the given input.
+    std::size_t PcmResampler::maxOutput(const std::size_t in_frames) const noexcept
+    {
+        return (in_frames * m_up + m_down - 1) / m_down + 1;
+    }
+
+    /// @brief The delay of the filter in frames at the output rate.
+    double PcmResampler::latency() const noexcept
+    {
+        return (m_up * m_taps - 1) / (2.0 * m_down);
+    }
+
+    /// @brief Forget the history so the next block starts from silence.
+    void PcmResampler::reset() noexcept
+    {
+        std::fill(m_work.begin(), m_work.end(), 0.0f);
+        m_phase = 0;
+        m_position = 0;
+    }
+
+    /**
+     * @brief Resample a block of every channel.
+     * @return The number of frames written which is at most maxOutput(in_frames).
+     */
+    std::size_t PcmResampler::process(const PcmBuffer& in_source, const std::size_t in_frames, PcmBuffer& out_dest) noexcept
+    {
+        assert(in_source.format() == PcmFormat::float32 && out_dest.format() == PcmFormat::float32);
+        assert(in_source.channels() == m_channels && out_dest.channels() == m_channels);
+        assert(in_frames <= m_maxFrames && in_frames <= in_source.frames());
+        assert(out_dest.frames() >= maxOutput(in_frames));
+
+        const auto history = m_taps - 1;
+        auto phase = m_phase;
+        auto position = m_position;
+        std::size_t produced = 0;
+
+        for (std::size_t channel = 0; channel < m_channels; channel++)
+        {
+            const auto samples = work(channel);
+            const auto output = out_dest.channel<float>(channel);
+
+            std::memcpy(samples + history, in_source.channel<float>(channel), in_frames * sizeof(float));
+
+            phase = m_phase;
+            position = m_position;
+            produced = 0;
+
+            while (position < in_frames)
+            {
+                output[produced++] = m_dot(m_coefficients.data() + phase * m_taps, samples + position, m_taps);
+                phase += m_down;
+                position += phase / m_up;
+                phase %= m_up;
+            }
+
+            std::memmove(samples, samples + in_frames, history * sizeof(float));
+        }
+
+        m_phase = phase;
+        m_position = position - in_frames;
+
+        return produced;
+    }
+}
@@ -0,0 +1,78 @@
+/* Copyright 2023 Tyler Riddle
+ *
+ * This file is part of Clypsalot. Clypsalot is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU Lesser General Public License as published by the Free Software Foundation, either version 3 of the License,
+ * or (at your option) any later version. Clypsalot is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along with Clypsalot. If not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <clypsalot/pcm.hxx>
+#include <clypsalot/simd.hxx>
+
+/// @file
+namespace Clypsalot
+{
+    /**
+     * @brief Changes the sample rate of float32 PCM with a polyphase FIR filter.
+     *
+     * The ratio between the rates is reduced to L/M and the filter is a Kaiser windowed sinc with
+     * a phase for each of the L positions an output sample can fall between two input samples.
+     * Every output sample is a dot product of one phase with the most recent input samples which
+     * is done with vector instructions when the CPU has them. The history of every channel is
+     * kept between calls so blocks can be any size up to the size given when the resampler is
+     * created. All the memory is allocated by the constructor.
+     */
+    class PcmResampler
+    {
+        public:
+        using DotKernel = float (*)(const float* in_coefficients, const float* in_samples, const std::size_t in_taps) noexcept;
+
+        /// @brief The largest number of phases a resampler will create.
+        static constexpr std::size_t maxPhases = 2048;
+
+        private:
+        const std::size_t m_inRate;
+        const std::size_t m_outRate;
+        const std::size_t m_channels;
+        const std::size_t m_maxFrames;
+        const PcmResamplerQuality m_quality;
+        std::size_t m_up = 0;
+        std::size_t m_down = 0;
+        std::size_t m_taps = 0;
+        std::vector<float> m_coefficients;
+        std::vector<float> m_work;
+        std::size_t m_phase = 0;
+        std::size_t m_position = 0;
+        SimdLevel m_level = SimdLevel::scalar;
+        DotKernel m_dot = nullptr;
+
+        float* work(const std::size_t in_channel) noexcept;
+
+        public:
+        PcmResampler(const std::size_t in_inRate, const std::size_t in_outRate, const std::size_t in_channels, const std::size_t in_maxFrames, const PcmResamplerQuality in_quality = PcmResamplerQuality::balanced, const SimdLevel in_level = simdLevel());
+        PcmResampler(const PcmResampler&) = delete;
+        void operator=(const PcmResampler&) = delete;
+        std::size_t inRate() const noexcept;
+        std::size_t outRate() const noexcept;
+        std::size_t channels() const noexcept;
+        PcmResamplerQuality quality() const noexcept;
+        SimdLevel level() const noexcept;
+        std::size_t phases() const noexcept;
+        std::size_t taps() const noexcept;
+        std::size_t maxOutput(const std::size_t in_frames) const noexcept;
+        double latency() const noexcept;
+        void reset() noexcept;
+        std::size_t process(const PcmBuffer& in_source, const std::size_t in_frames, PcmBuffer& out_dest) noexcept;
+    };
+
+}
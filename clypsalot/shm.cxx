@@ -0,0 +1,870 @@
+/* Copyright 2023 Tyler Riddle
+ *
+ * This file is part of Clypsalot. Clypsalot is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU Lesser General Public License as published by the Free Software Foundation, either version 3 of the License,
+ * or (at your option) any later version. Clypsalot is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along with Clypsalot. If not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cerrno>
+#include <climits>
+#include <cstring>
+#include <functional>
+#include <new>
+
+#include <fcntl.h>
+#include <linux/futex.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <clypsalot/error.hxx>
+#include <clypsalot/property.hxx>
+#include <clypsalot/queue.hxx>
+#include <clypsalot/shm.hxx>
+#include <clypsalot/util.hxx>
+
+/// @file
+namespace Clypsalot
+{
+    /*
+     * The sequence words are the futexes. A side that changed its position bumps the sequence
+     * and only makes the wake system call if the count of waiters says something could be
+     * sleeping on it.
+     */
+    struct ShmRingHeader
+    {
+        alignas(cacheLineSize) std::atomic_uint64_t written = 0;
+        std::atomic_uint32_t dataSequence = 0;
+        std::atomic_uint32_t dataWaiters = 0;
+        alignas(cacheLineSize) std::atomic_uint64_t read = 0;
+        std::atomic_uint32_t spaceSequence = 0;
+        std::atomic_uint32_t spaceWaiters = 0;
+        alignas(cacheLineSize) std::atomic_uint64_t xruns = 0;
+    };
+
+    struct ShmDeviceHeader
+    {
+        std::uint32_t magic = 0;
+        std::uint32_t version = 0;
+        std::uint32_t format = 0;
+        std::uint32_t channels = 0;
+        std::uint64_t rate = 0;
+        std::uint64_t period = 0;
+        std::uint64_t periods = 0;
+        std::atomic_uint32_t closed = 0;
+        alignas(cacheLineSize) std::atomic_uint64_t latency = 0;
+        std::atomic_uint64_t maxLatency = 0;
+        ShmRingHeader capture;
+        ShmRingHeader playback;
+    };
+
+    // The header is shared between processes so the atomics have to work with out a lock.
+    static_assert(std::atomic_uint64_t::is_always_lock_free);
+    static_assert(std::atomic_uint32_t::is_always_lock_free);
+
+    const std::string ShmSourceObject::kindName = "Shared Memory Source";
+    const std::string ShmSinkObject::kindName = "Shared Memory Sink";
+    static constexpr std::uint32_t shmDeviceMagic = 0x50594c43;
+    static const std::string devicePropertyName = "Device";
+    static const std::string blockSizePropertyName = "Block Size";
+    static const std::string overrunsPropertyName = "Overruns";
+    static const std::string underrunsPropertyName = "Underruns";
+    static const PropertyList shmProperties = {
+        // The name of the POSIX shared memory segment of the audio server.
+        { devicePropertyName, PropertyType::string, Property::Configurable | Property::Required, nullptr },
+    };
+    static const PropertyList shmSourceProperties = {
+        // 0 uses the period of the device.
+        { blockSizePropertyName, PropertyType::size, Property::Configurable, 0 },
+        // Updated every time a block is processed.
+        { overrunsPropertyName, PropertyType::size, Property::NoFlags, 0 },
+    };
+    static const PropertyList shmSinkProperties = {
+        // Updated every time a block is processed.
+        { underrunsPropertyName, PropertyType::size, Property::NoFlags, 0 },
+    };
+
+    static std::size_t roundUp(const std::size_t in_value, const std::size_t in_multiple) noexcept
+    {
+        return (in_value + in_multiple - 1) / in_multiple * in_multiple;
+    }
+
+    static std::size_t pageSize() noexcept
+    {
+        static const auto size = static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+        return size;
+    }
+
+    static std::size_t ringBytes(const ShmDeviceConfig& in_config) noexcept
+    {
+        return roundUp(in_config.period * in_config.periods * in_config.channels * pcmSampleSize(in_config.format), pageSize());
+    }
+
+    // The header is followed by the samples of the capture ring and then the playback ring.
+    static std::size_t deviceBytes(const ShmDeviceConfig& in_config) noexcept
+    {
+        return roundUp(sizeof(ShmDeviceHeader), pageSize()) + 2 * ringBytes(in_config);
+    }
+
+    // The names of segments start with a slash which is added if it is missing.
+    static std::string segmentName(const std::string& in_name)
+    {
+        if (in_name.empty()) throw ValueError("The name of a shared memory device must not be empty");
+        if (in_name.front() == '/') return in_name;
+
+        return "/" + in_name;
+    }
+
+    static void futexWake(std::atomic_uint32_t& io_word) noexcept
+    {
+        syscall(SYS_futex, &io_word, FUTEX_WAKE, INT_MAX, nullptr, nullptr, 0);
+    }
+
+    static void signal(std::atomic_uint32_t& io_sequence, const std::atomic_uint32_t& in_waiters) noexcept
+    {
+        io_sequence.fetch_add(1);
+
+        if (in_waiters.load() > 0) futexWake(io_sequence);
+    }
+
+    /*
+     * Registering as a waiter before reading the sequence means the other side either sees the
+     * waiter and wakes the futex or changed the sequence before it was read in which case the
+     * position it published is seen here too.
+     */
+    static bool prepareWait(std::atomic_uint32_t& io_sequence, std::atomic_uint32_t& io_waiters, const std::function<bool()>& in_ready, IoRequest& out_request) noexcept
+    {
+        io_waiters.fetch_add(1);
+
+        const auto sequence = io_sequence.load();
+
+        if (in_ready())
+        {
+            io_waiters.fetch_sub(1);
+            return false;
+        }
+
+        out_request.operation = IoOperation::futexWait;
+        out_request.data = reinterpret_cast<std::byte*>(&io_sequence);
+        out_request.offset = sequence;
+
+        return true;
+    }
+
+    static bool wait(std::atomic_uint32_t& io_sequence, std::atomic_uint32_t& io_waiters, const std::function<bool()>& in_ready, const std::chrono::nanoseconds in_timeout) noexcept
+    {
+        const auto deadline = std::chrono::steady_clock::now() + in_timeout;
+
+        while (true)
+        {
+            IoRequest request;
+
+            if (! prepareWait(io_sequence, io_waiters, in_ready, request)) return true;
+
+            const auto remaining = deadline - std::chrono::steady_clock::now();
+
+            if (remaining <= std::chrono::nanoseconds::zero())
+            {
+                io_waiters.fetch_sub(1);
+                return false;
+            }
+
+            const auto seconds = std::chrono::duration_cast<std::chrono::seconds>(remaining);
+            const timespec timeout { static_cast<time_t>(seconds.count()), static_cast<long>((remaining - seconds).count()) };
+
+            syscall(SYS_futex, &io_sequence, FUTEX_WAIT, static_cast<std::uint32_t>(request.offset), &timeout, nullptr, 0);
+            io_waiters.fetch_sub(1);
+        }
+    }
+
+    ShmRing::ShmRing(ShmRingHeader* in_header, std::byte* in_data, const std::size_t in_capacity, const std::size_t in_frameSize) noexcept :
+        m_header(in_header),
+        m_data(in_data),
+        m_capacity(in_capacity),
+        m_frameSize(in_frameSize)
+    { }
+
+    /// @brief The number of frames the ring holds.
+    std::size_t ShmRing::capacity() const noexcept
+    {
+        return m_capacity;
+    }
+
+    std::size_t ShmRing::frameSize() const noexcept
+    {
+        return m_frameSize;
+    }
+
+    /// @brief The number of frames that can be read.
+    std::size_t ShmRing::readable() const noexcept
+    {
+        return m_header->written.load(std::memory_order_acquire) - m_header->read.load(std::memory_order_acquire);
+    }
+
+    /// @brief The number of frames that can be written.
+    std::size_t ShmRing::writable() const noexcept
+    {
+        return m_capacity - readable();
+    }
+
+    std::uint64_t ShmRing::xruns() const noexcept
+    {
+        return m_header->xruns.load(std::memory_order_relaxed);
+    }
+
+    void ShmRing::countXrun() noexcept
+    {
+        m_header->xruns.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief The frames that can be read with out wrapping around.
+     * @param out_frames Set to the number of frames at the returned pointer.
+     *
+     * Only the consumer may call this and consume().
+     */
+    const std::byte* ShmRing::readPointer(std::size_t& out_frames) const noexcept
+    {
+        const auto offset = m_header->read.load(std::memory_order_relaxed) % m_capacity;
+
+        out_frames = std::min(readable(), m_capacity - offset);
+        return m_data + offset * m_frameSize;
+    }
+
+    void ShmRing::consume(const std::size_t in_frames) noexcept
+    {
+        assert(in_frames <= readable());
+
+        m_header->read.fetch_add(in_frames, std::memory_order_release);
+        signal(m_header->spaceSequence, m_header->spaceWaiters);
+    }
+
+    /**
+     * @brief The room that can be written to with out wrapping around.
+     * @param out_frames Set to the number of frames at the returned pointer.
+     *
+     * Only the producer may call this and produce().
+     */
+    std::byte* ShmRing::writePointer(std::size_t& out_frames) const noexcept
+    {
+        const auto offset = m_header->written.load(std::memory_order_relaxed) % m_capacity;
+
+        out_frames = std::min(writable(), m_capacity - offset);
+        return m_data + offset * m_frameSize;
+    }
+
+    void ShmRing::produce(const std::size_t in_frames) noexcept
+    {
+        assert(in_frames <= writable());
+
+        m_header->written.fetch_add(in_frames, std::memory_order_release);
+        signal(m_header->dataSequence, m_header->dataWaiters);
+    }
+
+    /// @brief Copy out up to the given number of frames and return how many there were.
+    std::size_t ShmRing::read(std::byte* out_data, const std::size_t in_frames) noexcept
+    {
+        std::size_t done = 0;
+
+        while (done < in_frames)
+        {
+            std::size_t frames;
+            const auto data = readPointer(frames);
+
+            frames = std::min(frames, in_frames - done);
+
+            if (frames == 0) break;
+
+            std::memcpy(out_data + done * m_frameSize, data, frames * m_frameSize);
+            done += frames;
+            m_header->read.fetch_add(frames, std::memory_order_release);
+        }
+
+        if (done > 0) signal(m_header->spaceSequence, m_header->spaceWaiters);
+
+        return done;
+    }
+
+    /// @brief Copy in up to the given number of frames and return how many there was room for.
+    std::size_t ShmRing::write(const std::byte* in_data, const std::size_t in_frames) noexcept
+    {
+        std::size_t done = 0;
+
+        while (done < in_frames)
+        {
+            std::size_t frames;
+            const auto data = writePointer(frames);
+
+            frames = std::min(frames, in_frames - done);
+
+            if (frames == 0) break;
+
+            std::memcpy(data, in_data + done * m_frameSize, frames * m_frameSize);
+            done += frames;
+            m_header->written.fetch_add(frames, std::memory_order_release);
+        }
+
+        if (done > 0) signal(m_header->dataSequence, m_header->dataWaiters);
+
+        return done;
+    }
+
+    /// @brief Block the thread until the frames can be read or the timeout passes.
+    bool ShmRing::waitReadable(const std::size_t in_frames, const std::chrono::nanoseconds in_timeout) noexcept
+    {
+        return wait(m_header->dataSequence, m_header->dataWaiters, [&] { return readable() >= in_frames; }, in_timeout);
+    }
+
+    /// @brief Block the thread until the frames can be written or the timeout passes.
+    bool ShmRing::waitWritable(const std::size_t in_frames, const std::chrono::nanoseconds in_timeout) noexcept
+    {
+        return wait(m_header->spaceSequence, m_header->spaceWaiters, [&] { return writable() >= in_frames; }, in_timeout);
+    }
+
+    /**
+     * @brief Set up a futex wait for the frames to be readable with out blocking.
+     * @return false if the frames are already there. Otherwise out_request is made in to a
+     * futex wait for an IoService and finishReadableWait() must be called once it completes or
+     * fails to be submitted.
+     */
+    bool ShmRing::prepareReadableWait(const std::size_t in_frames, IoRequest& out_request) noexcept
+    {
+        return prepareWait(m_header->dataSequence, m_header->dataWaiters, [&] { return readable() >= in_frames; }, out_request);
+    }
+
+    /// @brief Like prepareReadableWait() but for room to write the frames.
+    bool ShmRing::prepareWritableWait(const std::size_t in_frames, IoRequest& out_request) noexcept
+    {
+        return prepareWait(m_header->spaceSequence, m_header->spaceWaiters, [&] { return writable() >= in_frames; }, out_request);
+    }
+
+    void ShmRing::finishReadableWait() noexcept
+    {
+        m_header->dataWaiters.fetch_sub(1);
+    }
+
+    void ShmRing::finishWritableWait() noexcept
+    {
+        m_header->spaceWaiters.fetch_sub(1);
+    }
+
+    // Wake every waiter on both sides such as when the device is closed.
+    void ShmRing::wakeAll() noexcept
+    {
+        m_header->dataSequence.fetch_add(1);
+        m_header->spaceSequence.fetch_add(1);
+        futexWake(m_header->dataSequence);
+        futexWake(m_header->spaceSequence);
+    }
+
+    /**
+     * @brief Create the segment of a device.
+     * @throws ValueError if the config is not usable.
+     * @throws RuntimeError if the segment already exists or can not be created.
+     *
+     * The segment is removed again when the instance is destroyed.
+     */
+    ShmDevice::ShmDevice(const std::string& in_name, const ShmDeviceConfig& in_config) :
+        m_name(segmentName(in_name)),
+        m_config(in_config)
+    {
+        if (m_config.channels == 0) throw ValueError("A shared memory device needs at least one channel");
+        if (m_config.rate == 0) throw ValueError("A shared memory device needs a sample rate");
+        if (m_config.period == 0) throw ValueError("The period of a shared memory device must not be 0");
+        if (m_config.periods < 2) throw ValueError("A shared memory device needs at least 2 periods");
+
+        const auto fd = shm_open(m_name.c_str(), O_RDWR | O_CREAT | O_EXCL | O_CLOEXEC, 0600);
+
+        if (fd < 0) throw RuntimeError(makeString("Could not create shared memory device ", m_name, ": ", std::strerror(errno)));
+
+        const auto bytes = deviceBytes(m_config);
+
+        try
+        {
+            if (ftruncate(fd, bytes) != 0) throw RuntimeError(makeString("Could not size shared memory device ", m_name, ": ", std::strerror(errno)));
+
+            map(fd, bytes);
+        }
+        catch (...)
+        {
+            ::close(fd);
+            shm_unlink(m_name.c_str());
+            throw;
+        }
+
+        ::close(fd);
+
+        new (m_header) ShmDeviceHeader;
+        m_header->version = version;
+        m_header->format = static_cast<std::uint32_t>(m_config.format);
+        m_header->channels = m_config.channels;
+        m_header->rate = m_config.rate;
+        m_header->period = m_config.period;
+        m_header->periods = m_config.periods;
+        m_owner = true;
+        attachRings();
+
+        // The magic number goes in last so a device that is still being set up is not opened.
+        std::atomic_ref(m_header->magic).store(shmDeviceMagic, std::memory_order_release);
+    }
+
+    /**
+     * @brief Open the segment of a device that was created by the audio server.
+     * @throws RuntimeError if there is no such segment or it is not a device.
+     */
+    ShmDevice::ShmDevice(const std::string& in_name) :
+        m_name(segmentName(in_name))
+    {
+        const auto fd = shm_open(m_name.c_str(), O_RDWR | O_CLOEXEC, 0);
+
+        if (fd < 0) throw RuntimeError(makeString("Could not open shared memory device ", m_name, ": ", std::strerror(errno)));
+
+        struct stat status;
+
+        try
+        {
+            if (fstat(fd, &status) != 0) throw RuntimeError(makeString("Could not stat shared memory device ", m_name, ": ", std::strerror(errno)));
+            if (static_cast<std::size_t>(status.st_size) < sizeof(ShmDeviceHeader)) throw RuntimeError(makeString("Not a shared memory device: ", m_name));
+
+            map(fd, status.st_size);
+        }
+        catch (...)
+        {
+            ::close(fd);
+            throw;
+        }
+
+        ::close(fd);
+
+        std::string error;
+
+        if (std::atomic_ref(m_header->magic).load(std::memory_order_acquire) != shmDeviceMagic)
+        {
+            error = makeString("Not a shared memory device: ", m_name);
+        }
+        else if (m_header->version != version)
+        {
+            error = makeString("Shared memory device ", m_name, " has version ", m_header->version, " instead of ", version);
+        }
+        else
+        {
+            m_config.format = static_cast<PcmFormat>(m_header->format);
+            m_config.channels = m_header->channels;
+            m_config.rate = m_header->rate;
+            m_config.period = m_header->period;
+            m_config.periods = m_header->periods;
+
+            if (deviceBytes(m_config) > m_bytes) error = makeString("Shared memory device ", m_name, " is truncated");
+        }
+
+        if (! error.empty())
+        {
+            munmap(m_header, m_bytes);
+            throw RuntimeError(error);
+        }
+
+        attachRings();
+    }
+
+    ShmDevice::~ShmDevice() noexcept
+    {
+        if (m_owner)
+        {
+            close();
+            shm_unlink(m_name.c_str());
+        }
+
+        munmap(m_header, m_bytes);
+    }
+
+    void ShmDevice::map(const int in_fd, const std::size_t in_bytes)
+    {
+        const auto data = mmap(nullptr, in_bytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, in_fd, 0);
+
+        if (data == MAP_FAILED) throw RuntimeError(makeString("Could not map shared memory device ", m_name, ": ", std::strerror(errno)));
+
+        m_header = static_cast<ShmDeviceHeader*>(data);
+        m_bytes = in_bytes;
+    }
+
+    void ShmDevice::attachRings() noexcept
+    {
+        const auto data = reinterpret_cast<std::byte*>(m_header) + roundUp(sizeof(ShmDeviceHeader), pageSize());
+        const auto capacity = m_config.period * m_config.periods;
+        const auto frameSize = m_config.channels * pcmSampleSize(m_config.format);
+
+        m_capture = ShmRing(&m_header->capture, data, capacity, frameSize);
+        m_playback = ShmRing(&m_header->playback, data + ringBytes(m_config), capacity, frameSize);
+    }
+
+    const std::string& ShmDevice::name() const noexcept
+    {
+        return m_name;
+    }
+
+    const ShmDeviceConfig& ShmDevice::config() const noexcept
+    {
+        return m_config;
+    }
+
+    /// @brief How the frames are stored in the rings.
+    PcmFileInfo ShmDevice::info() const noexcept
+    {
+        PcmFileInfo info;
+
+        info.format = m_config.format;
+        info.sampleSize = pcmSampleSize(m_config.format);
+        info.channels = m_config.channels;
+        info.rate = m_config.rate;
+
+        return info;
+    }
+
+    /// @brief The frames the server captured for the engine.
+    ShmRing& ShmDevice::capture() noexcept
+    {
+        return m_capture;
+    }
+
+    /// @brief The frames the engine gives the server to play.
+    ShmRing& ShmDevice::playback() noexcept
+    {
+        return m_playback;
+    }
+
+    bool ShmDevice::closed() const noexcept
+    {
+        return m_header->closed.load() != 0;
+    }
+
+    /// @brief Tell the other side the device is going away and wake anything that waits on it.
+    void ShmDevice::close() noexcept
+    {
+        m_header->closed.store(1);
+        m_capture.wakeAll();
+        m_playback.wakeAll();
+    }
+
+    /// @brief Record a measured round trip from the capture ring back out of the playback ring.
+    void ShmDevice::reportLatency(const std::uint64_t in_frames) noexcept
+    {
+        m_header->latency.store(in_frames, std::memory_order_relaxed);
+
+        auto max = m_header->maxLatency.load(std::memory_order_relaxed);
+
+        while (in_frames > max && ! m_header->maxLatency.compare_exchange_weak(max, in_frames, std::memory_order_relaxed));
+    }
+
+    /// @brief The last round trip in frames that was reported or 0 if none was.
+    std::uint64_t ShmDevice::latency() const noexcept
+    {
+        return m_header->latency.load(std::memory_order_relaxed);
+    }
+
+    std::uint64_t ShmDevice::maxLatency() const noexcept
+    {
+        return m_header->maxLatency.load(std::memory_order_relaxed);
+    }
+
+    ShmObject::ShmObject(const std::string& in_kind) :
+        Object(in_kind)
+    {
+        std::scoped_lock lock(*this);
+
+        addProperties(shmProperties);
+
+        m_wait.complete = waitComplete;
+        m_wait.context = this;
+    }
+
+    // The subclass has to stop waiting before it is destroyed because the completion uses it.
+    ShmObject::~ShmObject() noexcept
+    {
+        assert(! m_waiting);
+    }
+
+    void ShmObject::waitComplete(IoRequest& io_request) noexcept
+    {
+        auto& object = *static_cast<ShmObject*>(io_request.context);
+        std::scoped_lock lock(object);
+
+        if (object.m_waitReadable) object.m_waitRing->finishReadableWait();
+        else object.m_waitRing->finishWritableWait();
+
+        object.m_waitRing = nullptr;
+        object.m_waiting = false;
+        object.m_waitDone.notify_all();
+
+        if (io_request.result != -ECANCELED) wakeObject(object);
+    }
+
+    /**
+     * @throws ValueError if the Device property is not set.
+     * @throws RuntimeError if the device can not be opened.
+     */
+    void ShmObject::openDevice()
+    {
+        assert(haveLock());
+
+        const auto& name = property(devicePropertyName);
+
+        if (! name.defined()) throw ValueError(makeString("Property is required: ", devicePropertyName));
+
+        m_device = std::make_unique<ShmDevice>(name.stringValue());
+    }
+
+    void ShmObject::closeDevice() noexcept
+    {
+        assert(haveLock());
+        assert(! m_waiting);
+
+        m_device.reset();
+    }
+
+    /**
+     * @brief Wait for the frames or the room for them with out blocking the thread.
+     * @return false if there is no need to wait any more.
+     * @throws RuntimeError if the IoService is full.
+     */
+    bool ShmObject::waitFor(ShmRing& in_ring, const bool in_readable, const std::size_t in_frames)
+    {
+        assert(haveLock());
+        assert(! m_waiting);
+
+        const auto prepared = in_readable ? in_ring.prepareReadableWait(in_frames, m_wait) : in_ring.prepareWritableWait(in_frames, m_wait);
+
+        if (! prepared) return false;
+
+        if (! ioService().submit(m_wait))
+        {
+            if (in_readable) in_ring.finishReadableWait();
+            else in_ring.finishWritableWait();
+
+            throw RuntimeError("The I/O service is full");
+        }
+
+        m_waitRing = &in_ring;
+        m_waitReadable = in_readable;
+        m_waiting = true;
+
+        return true;
+    }
+
+    // Cancel the wait and block until it is over.
+    void ShmObject::stopWaiting() noexcept
+    {
+        assert(haveLock());
+
+        if (! m_waiting) return;
+
+        ioService().cancel(m_wait);
+        m_waitDone.wait(*this, [this] { return ! m_waiting; });
+    }
+
+    bool ShmObject::ready() const noexcept
+    {
+        return ! m_waiting && Object::ready();
+    }
+
+    /// @throws RuntimeError if the Object was not configured.
+    ShmDevice& ShmObject::device() const
+    {
+        assert(haveLock());
+
+        if (! m_device) throw RuntimeError("The shared memory device is not open");
+
+        return *m_device;
+    }
+
+    std::shared_ptr<ShmSourceObject> ShmSourceObject::make()
+    {
+        return _makeObject<ShmSourceObject>(kindName);
+    }
+
+    ShmSourceObject::ShmSourceObject(const std::string& in_kind) :
+        ShmObject(in_kind)
+    {
+        std::scoped_lock lock(*this);
+
+        addProperties(shmSourceProperties);
+
+        m_blockSize = &propertySizeRef(blockSizePropertyName);
+        m_overruns = &propertySizeRef(overrunsPropertyName);
+        m_output = static_cast<PcmOutputPort*>(&addOutput<PcmOutputPort>("output"));
+    }
+
+    ShmSourceObject::~ShmSourceObject() noexcept
+    {
+        std::scoped_lock lock(*this);
+
+        stopWaiting();
+    }
+
+    /**
+     * @throws ValueError if the block size is larger than the ring.
+     * @throws RuntimeError if the device can not be opened.
+     *
+     * The output takes the format, channels and rate of the device. Devices with 1, 4 or 8
+     * channels are copied straight in to planar, grouped4 or grouped8 blocks.
+     */
+    void ShmSourceObject::handleConfigure(const ObjectConfig& in_config)
+    {
+        assert(haveLock());
+
+        ShmObject::handleConfigure(in_config);
+        stopWaiting();
+        closeDevice();
+        openDevice();
+
+        m_info = m_device->info();
+
+        const auto blockSize = *m_blockSize > 0 ? *m_blockSize : m_device->config().period;
+
+        if (blockSize > m_device->capture().capacity())
+        {
+            throw ValueError(makeString(blockSizePropertyName, " is larger than the ring of ", m_device->name()));
+        }
+
+        auto config = m_output->config();
+
+        config.format = m_info.format;
+        config.channels = m_info.channels;
+        config.blockSize = blockSize;
+        config.rate = m_info.rate;
+        config.layout = pcmFileLayout(m_info.channels);
+        m_output->config(config);
+
+        *m_overruns = m_device->capture().xruns();
+    }
+
+    // Once the server closed the device the rest of the ring is delivered and then the data ends.
+    ObjectProcessResult ShmSourceObject::process()
+    {
+        assert(haveLock());
+
+        auto& ring = m_device->capture();
+        auto& buffer = m_output->buffer();
+        auto frames = buffer.frames();
+
+        if (ring.readable() < frames)
+        {
+            if (m_device->closed())
+            {
+                frames = ring.readable();
+                if (frames == 0) return ObjectProcessResult::endOfData;
+            }
+            else if (waitFor(ring, true, frames))
+            {
+                return ObjectProcessResult::blocked;
+            }
+        }
+
+        for (std::size_t done = 0; done < frames;)
+        {
+            std::size_t available;
+            const auto data = ring.readPointer(available);
+            const auto chunk = std::min(available, frames - done);
+
+            readPcmFrames(buffer, data, m_info, chunk, done);
+            ring.consume(chunk);
+            done += chunk;
+        }
+
+        m_output->commit(frames);
+        *m_overruns = ring.xruns();
+
+        return ObjectProcessResult::finished;
+    }
+
+    std::shared_ptr<ShmSinkObject> ShmSinkObject::make()
+    {
+        return _makeObject<ShmSinkObject>(kindName);
+    }
+
+    ShmSinkObject::ShmSinkObject(const std::string& in_kind) :
+        ShmObject(in_kind)
+    {
+        std::scoped_lock lock(*this);
+
+        addProperties(shmSinkProperties);
+
+        m_underruns = &propertySizeRef(underrunsPropertyName);
+        m_input = static_cast<PcmInputPort*>(&addInput<PcmInputPort>("input"));
+    }
+
+    ShmSinkObject::~ShmSinkObject() noexcept
+    {
+        std::scoped_lock lock(*this);
+
+        stopWaiting();
+    }
+
+    /**
+     * @throws RuntimeError if the device can not be opened.
+     *
+     * The input takes the format and channels of the device so a link with other channels mixes
+     * them.
+     */
+    void ShmSinkObject::handleConfigure(const ObjectConfig& in_config)
+    {
+        assert(haveLock());
+
+        ShmObject::handleConfigure(in_config);
+        stopWaiting();
+        closeDevice();
+        openDevice();
+
+        m_info = m_device->info();
+
+        auto config = m_input->config();
+
+        config.format = m_info.format;
+        config.channels = m_info.channels;
+        config.layout = PcmLayout::planar;
+        m_input->config(config);
+
+        *m_underruns = m_device->playback().xruns();
+    }
+
+    /// @throws RuntimeError if a block is larger than the ring.
+    ObjectProcessResult ShmSinkObject::process()
+    {
+        assert(haveLock());
+
+        auto& ring = m_device->playback();
+        const auto& buffer = m_input->buffer();
+        const auto frames = m_input->frames();
+
+        assert(buffer.channels() == m_info.channels);
+
+        if (m_device->closed()) return ObjectProcessResult::endOfData;
+        if (frames > ring.capacity()) throw RuntimeError(makeString("Blocks are larger than the ring of ", m_device->name()));
+        if (ring.writable() < frames && waitFor(ring, false, frames)) return ObjectProcessResult::blocked;
+
+        for (std::size_t done = 0; done < frames;)
+        {
+            std::size_t available;
+            const auto data = ring.writePointer(available);
+            const auto chunk = std::min(available, frames - done);
+
+            writePcmFrames(data, buffer, m_info, chunk, done);
+            ring.produce(chunk);
+            done += chunk;
+        }
+
+        m_input->consume();
+        *m_underruns = ring.xruns();
+
+        return ObjectProcessResult::finished;
+    }
+}
@@ -0,0 +1,198 @@
+/* Copyright 2023 Tyler Riddle
+ *
+ * This file is part of Clypsalot. Clypsalot is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU Lesser General Public License as published by the Free Software Foundation, either version 3 of the License,
+ * or (at your option) any later version. Clypsalot is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along with Clypsalot. If not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include <clypsalot/io.hxx>
+#include <clypsalot/object.hxx>
+#include <clypsalot/pcm.hxx>
+#include <clypsalot/wav.hxx>
+
+/// @file
+namespace Clypsalot
+{
+    struct ShmDeviceHeader;
+    struct ShmRingHeader;
+
+    /**
+     * @brief A single producer single consumer ring of interleaved frames in shared memory.
+     *
+     * The producer and the consumer can be in different processes. Positions count the frames
+     * since the ring was created and never wrap so the fill is the difference between them. A
+     * side that has to wait sleeps on a futex that the other side only wakes when something is
+     * waiting on it so moving frames does not make any system calls.
+     */
+    class ShmRing
+    {
+        ShmRingHeader* m_header = nullptr;
+        std::byte* m_data = nullptr;
+        std::size_t m_capacity = 0;
+        std::size_t m_frameSize = 0;
+
+        public:
+        ShmRing() noexcept = default;
+        ShmRing(ShmRingHeader* in_header, std::byte* in_data, const std::size_t in_capacity, const std::size_t in_frameSize) noexcept;
+        std::size_t capacity() const noexcept;
+        std::size_t frameSize() const noexcept;
+        std::size_t readable() const noexcept;
+        std::size_t writable() const noexcept;
+        std::uint64_t xruns() const noexcept;
+        void countXrun() noexcept;
+        const std::byte* readPointer(std::size_t& out_frames) const noexcept;
+        void consume(const std::size_t in_frames) noexcept;
+        std::byte* writePointer(std::size_t& out_frames) const noexcept;
+        void produce(const std::size_t in_frames) noexcept;
+        std::size_t read(std::byte* out_data, const std::size_t in_frames) noexcept;
+        std::size_t write(const std::byte* in_data, const std::size_t in_frames) noexcept;
+        bool waitReadable(const std::size_t in_frames, const std::chrono::nanoseconds in_timeout) noexcept;
+        bool waitWritable(const std::size_t in_frames, const std::chrono::nanoseconds in_timeout) noexcept;
+        bool prepareReadableWait(const std::size_t in_frames, IoRequest& out_request) noexcept;
+        bool prepareWritableWait(const std::size_t in_frames, IoRequest& out_request) noexcept;
+        void finishReadableWait() noexcept;
+        void finishWritableWait() noexcept;
+        void wakeAll() noexcept;
+    };
+
+    struct ShmDeviceConfig
+    {
+        PcmFormat format = PcmFormat::float32;
+        std::size_t channels = 2;
+        std::size_t rate = 48000;
+        /// @brief The number of frames the device moves at a time.
+        std::size_t period = 256;
+        /// @brief The capacity of each ring in periods.
+        std::size_t periods = 4;
+    };
+
+    /**
+     * @brief A pair of rings in a POSIX shared memory segment between the engine and an audio
+     * server on the same machine.
+     *
+     * The server creates the segment, writes what it captured to capture() and plays what it
+     * reads from playback() once every period. The engine opens the segment by name. Samples are
+     * interleaved and stored like they are in a PcmBuffer so 24 bit samples take 4 bytes.
+     *
+     * Each ring counts its own xruns: the server counts an overrun on the capture ring when the
+     * engine did not make room in time and an underrun on the playback ring when the engine did
+     * not deliver in time.
+     */
+    class ShmDevice
+    {
+        std::string m_name;
+        bool m_owner = false;
+        ShmDeviceHeader* m_header = nullptr;
+        std::size_t m_bytes = 0;
+        ShmDeviceConfig m_config;
+        ShmRing m_capture;
+        ShmRing m_playback;
+
+        void map(const int in_fd, const std::size_t in_bytes);
+        void attachRings() noexcept;
+
+        public:
+        static constexpr std::uint32_t version = 1;
+
+        ShmDevice(const std::string& in_name, const ShmDeviceConfig& in_config);
+        explicit ShmDevice(const std::string& in_name);
+        ShmDevice(const ShmDevice&) = delete;
+        ~ShmDevice() noexcept;
+        void operator=(const ShmDevice&) = delete;
+        const std::string& name() const noexcept;
+        const ShmDeviceConfig& config() const noexcept;
+        PcmFileInfo info() const noexcept;
+        ShmRing& capture() noexcept;
+        ShmRing& playback() noexcept;
+        bool closed() const noexcept;
+        void close() noexcept;
+        void reportLatency(const std::uint64_t in_frames) noexcept;
+        std::uint64_t latency() const noexcept;
+        std::uint64_t maxLatency() const noexcept;
+    };
+
+    /**
+     * @brief The part of the shared memory objects that opens the device and waits on its rings.
+     *
+     * When a ring does not have enough frames or room the Object submits a futex wait to the
+     * IoService, returns ObjectProcessResult::blocked and is woken by the server.
+     */
+    class ShmObject : public Object
+    {
+        IoRequest m_wait;
+        ShmRing* m_waitRing = nullptr;
+        bool m_waitReadable = false;
+        bool m_waiting = false;
+        std::condition_variable_any m_waitDone;
+
+        static void waitComplete(IoRequest& io_request) noexcept;
+
+        protected:
+        std::unique_ptr<ShmDevice> m_device;
+
+        void openDevice();
+        void closeDevice() noexcept;
+        bool waitFor(ShmRing& in_ring, const bool in_readable, const std::size_t in_frames);
+        void stopWaiting() noexcept;
+
+        public:
+        ShmObject(const std::string& in_kind);
+        virtual ~ShmObject() noexcept;
+        virtual bool ready() const noexcept override;
+        ShmDevice& device() const;
+    };
+
+    /// @brief Deliver what the audio server captured.
+    class ShmSourceObject : public ShmObject
+    {
+        std::size_t* m_blockSize = nullptr;
+        std::size_t* m_overruns = nullptr;
+        PcmOutputPort* m_output = nullptr;
+        PcmFileInfo m_info;
+
+        protected:
+        virtual void handleConfigure(const ObjectConfig& in_config) override;
+        virtual ObjectProcessResult process() override;
+
+        public:
+        static const std::string kindName;
+
+        static std::shared_ptr<ShmSourceObject> make();
+        ShmSourceObject(const std::string& in_kind);
+        virtual ~ShmSourceObject() noexcept;
+    };
+
+    /// @brief Hand blocks to the audio server to play.
+    class ShmSinkObject : public ShmObject
+    {
+        std::size_t* m_underruns = nullptr;
+        PcmInputPort* m_input = nullptr;
+        PcmFileInfo m_info;
+
+        protected:
+        virtual void handleConfigure(const ObjectConfig& in_config) override;
+        virtual ObjectProcessResult process() override;
+
+        public:
+        static const std::string kindName;
+
+        static std::shared_ptr<ShmSinkObject> make();
+        ShmSinkObject(const std::string& in_kind);
+        virtual ~ShmSinkObject() noexcept;
+    };
+}
@@ -0,0 +1,79 @@
+/* Copyright 2023 Tyler Riddle
+ *
+ * This file is part of Clypsalot. Clypsalot is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU Lesser General Public License as published by the Free Software Foundation, either version 3 of the License,
+ * or (at your option) any later version. Clypsalot is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along with Clypsalot. If not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+#include <clypsalot/error.hxx>
+#include <clypsalot/macros.hxx>
+#include <clypsalot/simd.hxx>
+#include <clypsalot/util.hxx>
+
+/// @file
+namespace Clypsalot
+{
+    static SimdLevel detectSimdLevel() noexcept
+    {
+#if defined(__x86_64__) || defined(__i386__)
+        __builtin_cpu_init();
+
+        if (__builtin_cpu_supports("avx512f")) return SimdLevel::avx512;
+        if (__builtin_cpu_supports("avx2")) return SimdLevel::avx2;
+        if (__builtin_cpu_supports("sse2")) return SimdLevel::sse2;
+#endif
+
+        return SimdLevel::scalar;
+    }
+
+    DenormalGuard::DenormalGuard() noexcept
+    {
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__SSE__)
+        m_csr = _mm_getcsr();
+        // Flush to zero and denormals are zero.
+        _mm_setcsr(m_csr | 0x8040);
+#endif
+    }
+
+    DenormalGuard::~DenormalGuard() noexcept
+    {
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__SSE__)
+        _mm_setcsr(m_csr);
+#endif
+    }
+
+    /// @brief The best level the CPU running the process supports.
+    SimdLevel simdLevel() noexcept
+    {
+        static const auto level = detectSimdLevel();
+        return level;
+    }
+
+    std::string toString(const SimdLevel in_level) noexcept
+    {
+        switch (in_level)
+        {
+            case SimdLevel::scalar: return "scalar";
+            case SimdLevel::sse2: return "sse2";
+            case SimdLevel::avx2: return "avx2";
+            case SimdLevel::avx512: return "avx512";
+        }
+
+        FATAL_ERROR(makeString("Unhandled SimdLevel value: ", static_cast<int>(in_level)));
+    }
+
+    std::ostream& operator<<(std::ostream& in_os, const SimdLevel in_level) noexcept
+    {
+        in_os << toString(in_level);
+        return in_os;
+    }
+}
@@ -0,0 +1,56 @@
+/* Copyright 2023 Tyler Riddle
+ *
+ * This file is part of Clypsalot. Clypsalot is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU Lesser General Public License as published by the Free Software Foundation, either version 3 of the License,
+ * or (at your option) any later version. Clypsalot is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along with Clypsalot. If not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+
+/// @file
+namespace Clypsalot
+{
+    /**
+     * @brief The vector instruction sets that hand written kernels are provided for.
+     *
+     * The levels are ordered so a CPU that supports a level also supports every level below it.
+     */
+    enum class SimdLevel : uint_fast8_t
+    {
+        scalar,
+        sse2,
+        avx2,
+        avx512,
+    };
+
+    /**
+     * @brief Flushes denormals to zero for as long as the instance exists.
+     *
+     * Recursive filters and envelope followers decay into denormals when the input goes quiet
+     * which is very slow on most CPUs. Kernels that can do that create one of these on the stack
+     * while they run.
+     */
+    class DenormalGuard
+    {
+        unsigned int m_csr = 0;
+
+        public:
+        DenormalGuard() noexcept;
+        DenormalGuard(const DenormalGuard&) = delete;
+        ~DenormalGuard() noexcept;
+        void operator=(const DenormalGuard&) = delete;
+    };
+
+    SimdLevel simdLevel() noexcept;
+    std::string toString(const SimdLevel in_level) noexcept;
+    std::ostream& operator<<(std::ostream& in_os, const SimdLevel in_level) noexcept;
+}
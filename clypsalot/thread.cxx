@@ -10,6 +10,7 @@
  * <https://www.gnu.org/licenses/>.
  */
 
+#include <algorithm>
 #include <cassert>
 
 #include <clypsalot/error.hxx>
@@ -419,9 +420,9 @@ namespace Clypsalot
             LOGGER(trace, "Worker thread is starting a loop iteration");
             m_workerCondVar.wait(lock, [&]
             {
-                if (m_jobs.size() > 0)
+                if (m_jobsCount > 0)
                 {
-                    LOGGER(trace, "Worker thread has a job to do; jobs=", m_jobs.size());
+                    LOGGER(trace, "Worker thread has a job to do; jobs=", m_jobsCount);
                     return true;
                 }
 
@@ -443,12 +444,10 @@ namespace Clypsalot
                 return;
             }
 
-            if (m_jobs.size() > 0)
+            if (m_jobsCount > 0)
             {
-                LOGGER(trace, "Taking job from thread queue; jobs=", m_jobs.size());
-                auto job = m_jobs.front();
-
-                m_jobs.pop_front();
+                LOGGER(trace, "Taking job from thread queue; jobs=", m_jobsCount);
+                auto job = popJob();
 
                 lock.unlock();
                 LOGGER(trace, "Executing job from queue");
@@ -532,12 +531,51 @@ namespace Clypsalot
     {
         std::scoped_lock lock(m_mutex);
 
-        m_jobs.push_back(job);
+        pushJob(job);
         // TODO Until more condition variables are added to handle the case of removing threads
         // all waiting threads need to be notified because more threads could be waiting
         // on the condition variable than just threads waiting for a job.
         m_workerCondVar.notify_one();
-        LOGGER(trace, "Added job to thread queue; jobs=", m_jobs.size());
+        LOGGER(trace, "Added job to thread queue; jobs=", m_jobsCount);
+    }
+
+    /*
+     * The jobs are kept in a ring buffer that only grows so once the queue has seen its largest
+     * backlog posting and taking jobs does not allocate memory.
+     */
+    void ThreadQueue::pushJob(const JobType& job)
+    {
+        assert(m_mutex.haveLock());
+
+        if (m_jobsCount == m_jobs.size())
+        {
+            std::vector<JobType> jobs(std::max<size_t>(m_jobs.size() * 2, 16));
+
+            for (size_t i = 0; i < m_jobsCount; i++)
+            {
+                jobs[i] = std::move(m_jobs[(m_jobsHead + i) % m_jobs.size()]);
+            }
+
+            m_jobs = std::move(jobs);
+            m_jobsHead = 0;
+        }
+
+        m_jobs[(m_jobsHead + m_jobsCount) % m_jobs.size()] = job;
+        m_jobsCount++;
+    }
+
+    ThreadQueue::JobType ThreadQueue::popJob() noexcept
+    {
+        assert(m_mutex.haveLock());
+        assert(m_jobsCount > 0);
+
+        auto job = std::move(m_jobs[m_jobsHead]);
+
+        m_jobs[m_jobsHead] = nullptr;
+        m_jobsHead = (m_jobsHead + 1) % m_jobs.size();
+        m_jobsCount--;
+
+        return job;
     }
 
     void initThreadQueue(const size_t numThreads)
@@ -16,7 +16,6 @@
 #include <condition_variable>
 #include <functional>
 #include <future>
-#include <list>
 #include <shared_mutex>
 #include <thread>
 #include <map>
@@ -178,10 +177,14 @@ namespace Clypsalot
         std::condition_variable_any m_workerCondVar;
         std::vector<std::thread> m_workers;
         std::vector<std::thread::id> m_joinQueue;
-        std::list<JobType> m_jobs;
+        std::vector<JobType> m_jobs;
+        size_t m_jobsHead = 0;
+        size_t m_jobsCount = 0;
 
         void adjustThreads();
         void worker();
+        void pushJob(const JobType& job);
+        JobType popJob() noexcept;
 
         public:
         ThreadQueue(const size_t threads);
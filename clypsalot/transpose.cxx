@@ -0,0 +1,386 @@
+/* Copyright 2023 Tyler Riddle
+ *
+ * This file is part of Clypsalot. Clypsalot is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU Lesser General Public License as published by the Free Software Foundation, either version 3 of the License,
+ * or (at your option) any later version. Clypsalot is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along with Clypsalot. If not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define CLYPSALOT_X86_KERNELS
+#include <immintrin.h>
+#endif
+
+#include <clypsalot/error.hxx>
+#include <clypsalot/macros.hxx>
+#include <clypsalot/transpose.hxx>
+#include <clypsalot/util.hxx>
+
+/// @file
+namespace Clypsalot
+{
+    using Sample32 = std::uint32_t;
+
+    // The most channels a group can hold.
+    constexpr std::size_t maxLanes = 8;
+
+    static void packFrames(const std::byte* const* in_planes, std::byte* out_group, const std::size_t in_lanes, const std::size_t in_begin, const std::size_t in_end) noexcept
+    {
+        for (std::size_t frame = in_begin; frame < in_end; frame++)
+        {
+            for (std::size_t lane = 0; lane < in_lanes; lane++)
+            {
+                std::memcpy(out_group + (frame * in_lanes + lane) * sizeof(Sample32), in_planes[lane] + frame * sizeof(Sample32), sizeof(Sample32));
+            }
+        }
+    }
+
+    static void unpackFrames(const std::byte* in_group, std::byte* const* out_planes, const std::size_t in_lanes, const std::size_t in_begin, const std::size_t in_end) noexcept
+    {
+        for (std::size_t frame = in_begin; frame < in_end; frame++)
+        {
+            for (std::size_t lane = 0; lane < in_lanes; lane++)
+            {
+                std::memcpy(out_planes[lane] + frame * sizeof(Sample32), in_group + (frame * in_lanes + lane) * sizeof(Sample32), sizeof(Sample32));
+            }
+        }
+    }
+
+    static void packScalar(const std::byte* const* in_planes, std::byte* out_group, const std::size_t in_lanes, const std::size_t in_frames) noexcept
+    {
+        packFrames(in_planes, out_group, in_lanes, 0, in_frames);
+    }
+
+    static void unpackScalar(const std::byte* in_group, std::byte* const* out_planes, const std::size_t in_lanes, const std::size_t in_frames) noexcept
+    {
+        unpackFrames(in_group, out_planes, in_lanes, 0, in_frames);
+    }
+
+#ifdef CLYPSALOT_X86_KERNELS
+    // The shuffles only move bits so 32 bit integer samples survive being treated as floats.
+    __attribute__((target("sse2")))
+    static void packSse2(const std::byte* const* in_planes, std::byte* out_group, const std::size_t in_lanes, const std::size_t in_frames) noexcept
+    {
+        const auto group = reinterpret_cast<float*>(out_group);
+        std::size_t frame = 0;
+
+        for (; frame + 4 <= in_frames; frame += 4)
+        {
+            for (std::size_t quad = 0; quad < in_lanes; quad += 4)
+            {
+                auto row0 = _mm_loadu_ps(reinterpret_cast<const float*>(in_planes[quad]) + frame);
+                auto row1 = _mm_loadu_ps(reinterpret_cast<const float*>(in_planes[quad + 1]) + frame);
+                auto row2 = _mm_loadu_ps(reinterpret_cast<const float*>(in_planes[quad + 2]) + frame);
+                auto row3 = _mm_loadu_ps(reinterpret_cast<const float*>(in_planes[quad + 3]) + frame);
+
+                _MM_TRANSPOSE4_PS(row0, row1, row2, row3);
+                _mm_storeu_ps(group + frame * in_lanes + quad, row0);
+                _mm_storeu_ps(group + (frame + 1) * in_lanes + quad, row1);
+                _mm_storeu_ps(group + (frame + 2) * in_lanes + quad, row2);
+                _mm_storeu_ps(group + (frame + 3) * in_lanes + quad, row3);
+            }
+        }
+
+        packFrames(in_planes, out_group, in_lanes, frame, in_frames);
+    }
+
+    __attribute__((target("sse2")))
+    static void unpackSse2(const std::byte* in_group, std::byte* const* out_planes, const std::size_t in_lanes, const std::size_t in_frames) noexcept
+    {
+        const auto group = reinterpret_cast<const float*>(in_group);
+        std::size_t frame = 0;
+
+        for (; frame + 4 <= in_frames; frame += 4)
+        {
+            for (std::size_t quad = 0; quad < in_lanes; quad += 4)
+            {
+                auto row0 = _mm_loadu_ps(group + frame * in_lanes + quad);
+                auto row1 = _mm_loadu_ps(group + (frame + 1) * in_lanes + quad);
+                auto row2 = _mm_loadu_ps(group + (frame + 2) * in_lanes + quad);
+                auto row3 = _mm_loadu_ps(group + (frame + 3) * in_lanes + quad);
+
+                _MM_TRANSPOSE4_PS(row0, row1, row2, row3);
+                _mm_storeu_ps(reinterpret_cast<float*>(out_planes[quad]) + frame, row0);
+                _mm_storeu_ps(reinterpret_cast<float*>(out_planes[quad + 1]) + frame, row1);
+                _mm_storeu_ps(reinterpret_cast<float*>(out_planes[quad + 2]) + frame, row2);
+                _mm_storeu_ps(reinterpret_cast<float*>(out_planes[quad + 3]) + frame, row3);
+            }
+        }
+
+        unpackFrames(in_group, out_planes, in_lanes, frame, in_frames);
+    }
+
+    __attribute__((target("avx2")))
+    static void transpose8x8(__m256* io_rows) noexcept
+    {
+        __m256 pairs[8];
+        __m256 quads[8];
+
+        for (std::size_t i = 0; i < 8; i += 2)
+        {
+            pairs[i] = _mm256_unpacklo_ps(io_rows[i], io_rows[i + 1]);
+            pairs[i + 1] = _mm256_unpackhi_ps(io_rows[i], io_rows[i + 1]);
+        }
+
+        for (std::size_t i = 0; i < 8; i += 4)
+        {
+            quads[i] = _mm256_shuffle_ps(pairs[i], pairs[i + 2], _MM_SHUFFLE(1, 0, 1, 0));
+            quads[i + 1] = _mm256_shuffle_ps(pairs[i], pairs[i + 2], _MM_SHUFFLE(3, 2, 3, 2));
+            quads[i + 2] = _mm256_shuffle_ps(pairs[i + 1], pairs[i + 3], _MM_SHUFFLE(1, 0, 1, 0));
+            quads[i + 3] = _mm256_shuffle_ps(pairs[i + 1], pairs[i + 3], _MM_SHUFFLE(3, 2, 3, 2));
+        }
+
+        for (std::size_t i = 0; i < 4; i++)
+        {
+            io_rows[i] = _mm256_permute2f128_ps(quads[i], quads[i + 4], 0x20);
+            io_rows[i + 4] = _mm256_permute2f128_ps(quads[i], quads[i + 4], 0x31);
+        }
+    }
+
+    __attribute__((target("avx2")))
+    static void packAvx2(const std::byte* const* in_planes, std::byte* out_group, const std::size_t in_lanes, const std::size_t in_frames) noexcept
+    {
+        assert(in_lanes == 8);
+
+        const auto group = reinterpret_cast<float*>(out_group);
+        __m256 rows[8];
+        std::size_t frame = 0;
+
+        for (; frame + 8 <= in_frames; frame += 8)
+        {
+            for (std::size_t lane = 0; lane < 8; lane++)
+            {
+                rows[lane] = _mm256_loadu_ps(reinterpret_cast<const float*>(in_planes[lane]) + frame);
+            }
+
+            transpose8x8(rows);
+
+            for (std::size_t i = 0; i < 8; i++)
+            {
+                _mm256_storeu_ps(group + (frame + i) * 8, rows[i]);
+            }
+        }
+
+        packFrames(in_planes, out_group, in_lanes, frame, in_frames);
+    }
+
+    __attribute__((target("avx2")))
+    static void unpackAvx2(const std::byte* in_group, std::byte* const* out_planes, const std::size_t in_lanes, const std::size_t in_frames) noexcept
+    {
+        assert(in_lanes == 8);
+
+        const auto group = reinterpret_cast<const float*>(in_group);
+        __m256 rows[8];
+        std::size_t frame = 0;
+
+        for (; frame + 8 <= in_frames; frame += 8)
+        {
+            for (std::size_t i = 0; i < 8; i++)
+            {
+                rows[i] = _mm256_loadu_ps(group + (frame + i) * 8);
+            }
+
+            transpose8x8(rows);
+
+            for (std::size_t lane = 0; lane < 8; lane++)
+            {
+                _mm256_storeu_ps(reinterpret_cast<float*>(out_planes[lane]) + frame, rows[lane]);
+            }
+        }
+
+        unpackFrames(in_group, out_planes, in_lanes, frame, in_frames);
+    }
+#endif
+
+    // Where a channel starts in a buffer and the distance in bytes between its frames.
+    struct ChannelSpan
+    {
+        std::size_t offset = 0;
+        std::size_t step = 0;
+    };
+
+    static ChannelSpan channelSpan(const PcmBuffer& in_buffer, const std::size_t in_channel) noexcept
+    {
+        const auto sampleSize = pcmSampleSize(in_buffer.format());
+        const auto lanes = in_buffer.lanes();
+        const auto row = in_channel / lanes;
+
+        return { (row * in_buffer.stride() * lanes + in_channel % lanes) * sampleSize, lanes * sampleSize };
+    }
+
+    template <std::size_t SampleSize>
+    static void transposeChannels(const PcmBuffer& in_source, PcmBuffer& out_dest, const std::size_t in_first, const std::size_t in_frames) noexcept
+    {
+        const auto source = in_source.bytes() ? in_source.layout() == PcmLayout::planar ? in_source.channelData(0) : in_source.groupData(0) : nullptr;
+        const auto dest = out_dest.bytes() ? out_dest.layout() == PcmLayout::planar ? out_dest.channelData(0) : out_dest.groupData(0) : nullptr;
+        const auto channels = out_dest.groups() * out_dest.lanes();
+
+        for (auto channel = in_first; channel < channels; channel++)
+        {
+            const auto to = channelSpan(out_dest, channel);
+
+            if (channel >= out_dest.channels())
+            {
+                for (std::size_t frame = 0; frame < in_frames; frame++)
+                {
+                    std::memset(dest + to.offset + frame * to.step, 0, SampleSize);
+                }
+
+                continue;
+            }
+
+            const auto from = channelSpan(in_source, channel);
+
+            for (std::size_t frame = 0; frame < in_frames; frame++)
+            {
+                std::memcpy(dest + to.offset + frame * to.step, source + from.offset + frame * from.step, SampleSize);
+            }
+        }
+    }
+
+    /**
+     * @param in_level The highest level of vector instructions to use. It is limited to what the
+     * CPU supports.
+     */
+    PcmTransposer::PcmTransposer(const PcmFormat in_format, const PcmLayout in_from, const PcmLayout in_to, const SimdLevel in_level) :
+        m_format(in_format),
+        m_from(in_from),
+        m_to(in_to)
+    {
+        // Only moves between planar and grouped 32 bit samples have kernels.
+        if (pcmSampleSize(m_format) != sizeof(Sample32) || m_from == m_to) return;
+        if (m_from != PcmLayout::planar && m_to != PcmLayout::planar) return;
+
+        [[maybe_unused]] const auto level = std::min(in_level, simdLevel());
+        [[maybe_unused]] const auto lanes = pcmLanes(m_from == PcmLayout::planar ? m_to : m_from);
+
+        m_pack = packScalar;
+        m_unpack = unpackScalar;
+
+#ifdef CLYPSALOT_X86_KERNELS
+        if (level >= SimdLevel::avx2 && lanes == 8)
+        {
+            m_pack = packAvx2;
+            m_unpack = unpackAvx2;
+            m_level = SimdLevel::avx2;
+        }
+        else if (level >= SimdLevel::sse2)
+        {
+            m_pack = packSse2;
+            m_unpack = unpackSse2;
+            m_level = SimdLevel::sse2;
+        }
+#endif
+    }
+
+    PcmFormat PcmTransposer::format() const noexcept
+    {
+        return m_format;
+    }
+
+    PcmLayout PcmTransposer::from() const noexcept
+    {
+        return m_from;
+    }
+
+    PcmLayout PcmTransposer::to() const noexcept
+    {
+        return m_to;
+    }
+
+    /// @brief The level of the vector instructions in use.
+    SimdLevel PcmTransposer::level() const noexcept
+    {
+        return m_level;
+    }
+
+    /// @brief Transpose the first frames of every channel into a buffer with the same format and
+    /// channels.
+    void PcmTransposer::process(const PcmBuffer& in_source, PcmBuffer& out_dest, const std::size_t in_frames) noexcept
+    {
+        assert(in_source.format() == m_format && out_dest.format() == m_format);
+        assert(in_source.layout() == m_from && out_dest.layout() == m_to);
+        assert(in_source.channels() == out_dest.channels());
+        assert(in_frames <= in_source.frames() && in_frames <= out_dest.frames());
+
+        if (m_from == m_to)
+        {
+            out_dest.copy(in_source, in_frames);
+            return;
+        }
+
+        std::size_t channel = 0;
+
+        if (m_pack != nullptr)
+        {
+            const auto& grouped = m_from == PcmLayout::planar ? out_dest : in_source;
+            const auto lanes = grouped.lanes();
+
+            for (; channel + lanes <= in_source.channels(); channel += lanes)
+            {
+                const auto group = channel / lanes;
+
+                if (m_from == PcmLayout::planar)
+                {
+                    std::array<const std::byte*, maxLanes> planes;
+
+                    for (std::size_t lane = 0; lane < lanes; lane++)
+                    {
+                        planes[lane] = in_source.channelData(channel + lane);
+                    }
+
+                    m_pack(planes.data(), out_dest.groupData(group), lanes, in_frames);
+                }
+                else
+                {
+                    std::array<std::byte*, maxLanes> planes;
+
+                    for (std::size_t lane = 0; lane < lanes; lane++)
+                    {
+                        planes[lane] = out_dest.channelData(channel + lane);
+                    }
+
+                    m_unpack(in_source.groupData(group), planes.data(), lanes, in_frames);
+                }
+            }
+        }
+
+        switch (pcmSampleSize(m_format))
+        {
+            case 2: transposeChannels<2>(in_source, out_dest, channel, in_frames); return;
+            case 4: transposeChannels<4>(in_source, out_dest, channel, in_frames); return;
+            case 8: transposeChannels<8>(in_source, out_dest, channel, in_frames); return;
+        }
+
+        FATAL_ERROR(makeString("Unhandled PcmFormat value: ", m_format));
+    }
+
+    /**
+     * @brief The layout whose groups fill a vector register of 32 bit samples at the given level.
+     *
+     * There is no layout as wide as an AVX-512 register so kernels at that level work on two
+     * grouped8 groups at once.
+     */
+    PcmLayout pcmSimdLayout(const SimdLevel in_level) noexcept
+    {
+        switch (in_level)
+        {
+            case SimdLevel::scalar: return PcmLayout::planar;
+            case SimdLevel::sse2: return PcmLayout::grouped4;
+            case SimdLevel::avx2: return PcmLayout::grouped8;
+            case SimdLevel::avx512: return PcmLayout::grouped8;
+        }
+
+        FATAL_ERROR(makeString("Unhandled SimdLevel value: ", in_level));
+    }
+}
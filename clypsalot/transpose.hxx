@@ -0,0 +1,57 @@
+/* Copyright 2023 Tyler Riddle
+ *
+ * This file is part of Clypsalot. Clypsalot is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU Lesser General Public License as published by the Free Software Foundation, either version 3 of the License,
+ * or (at your option) any later version. Clypsalot is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along with Clypsalot. If not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <cstddef>
+
+#include <clypsalot/pcm.hxx>
+#include <clypsalot/simd.hxx>
+
+/// @file
+namespace Clypsalot
+{
+    /**
+     * @brief Moves the samples of a PcmBuffer into a buffer with another PcmLayout.
+     *
+     * Transposing only moves samples so the result is bit exact for every format. Whole groups
+     * of 32 bit samples going to or from the planar layout are transposed 4 by 4 or 8 by 8 in
+     * vector registers when the CPU can; everything else goes one sample at a time. The padding
+     * channels of a grouped destination are written with zeros.
+     */
+    class PcmTransposer
+    {
+        public:
+        using PackKernel = void (*)(const std::byte* const* in_planes, std::byte* out_group, const std::size_t in_lanes, const std::size_t in_frames) noexcept;
+        using UnpackKernel = void (*)(const std::byte* in_group, std::byte* const* out_planes, const std::size_t in_lanes, const std::size_t in_frames) noexcept;
+
+        private:
+        const PcmFormat m_format;
+        const PcmLayout m_from;
+        const PcmLayout m_to;
+        SimdLevel m_level = SimdLevel::scalar;
+        PackKernel m_pack = nullptr;
+        UnpackKernel m_unpack = nullptr;
+
+        public:
+        PcmTransposer(const PcmFormat in_format, const PcmLayout in_from, const PcmLayout in_to, const SimdLevel in_level = simdLevel());
+        PcmTransposer(const PcmTransposer&) = delete;
+        void operator=(const PcmTransposer&) = delete;
+        PcmFormat format() const noexcept;
+        PcmLayout from() const noexcept;
+        PcmLayout to() const noexcept;
+        SimdLevel level() const noexcept;
+        void process(const PcmBuffer& in_source, PcmBuffer& out_dest, const std::size_t in_frames) noexcept;
+    };
+
+    PcmLayout pcmSimdLayout(const SimdLevel in_level = simdLevel()) noexcept;
+}
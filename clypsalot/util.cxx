@@ -5,7 +5,8 @@
 #include <clypsalot/error.hxx>
 #include <clypsalot/util.hxx>
 
-// This macro isn't very efficient but these conversions don't happen a lot
+// This macro isn't very efficient so the type a conversion returns is checked first. Code that
+// converts a lot of values should use Property::convert() once and then the typed values.
 #define RETURN_ANY(any, typeName)\
     if (any.type() == typeid(typeName)) return std::any_cast<typeName>(any);\
     if (any.type() == typeid(const typeName)) return std::any_cast<const typeName>(any);
@@ -102,9 +103,9 @@ namespace Clypsalot
     {
         enforceValue(value);
 
+        RETURN_ANY(value, int);
         RETURN_ANY(value, float);
         RETURN_ANY(value, double);
-        RETURN_ANY(value, int);
         RETURN_ANY(value, unsigned long);
 
         if (anyIsStringType(value))
@@ -119,10 +120,10 @@ namespace Clypsalot
     {
         enforceValue(value);
 
+        RETURN_ANY(value, unsigned long);
+        RETURN_ANY(value, int);
         RETURN_ANY(value, float);
         RETURN_ANY(value, double);
-        RETURN_ANY(value, int);
-        RETURN_ANY(value, unsigned long);
 
         if (anyIsStringType(value))
         {
@@ -0,0 +1,366 @@
+/* Copyright 2023 Tyler Riddle
+ *
+ * This file is part of Clypsalot. Clypsalot is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU Lesser General Public License as published by the Free Software Foundation, either version 3 of the License,
+ * or (at your option) any later version. Clypsalot is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along with Clypsalot. If not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+
+#include <clypsalot/error.hxx>
+#include <clypsalot/macros.hxx>
+#include <clypsalot/util.hxx>
+#include <clypsalot/wav.hxx>
+
+/// @file
+namespace Clypsalot
+{
+    static constexpr std::uint16_t wavePcm = 1;
+    static constexpr std::uint16_t waveFloat = 3;
+    static constexpr std::uint16_t waveExtensible = 0xfffe;
+    // RF64 puts this in the 32 bit sizes and keeps the real ones in the ds64 chunk.
+    static constexpr std::uint32_t rf64Size = 0xffffffff;
+
+    static constexpr std::size_t ds64Size = 28;
+    static constexpr std::size_t extensibleFormatSize = 40;
+    // Every WAVE sub format GUID ends with these bytes after the format tag.
+    static constexpr unsigned char guidTail[] = { 0x00, 0x00, 0x00, 0x00, 0x10, 0x00, 0x80, 0x00, 0x00, 0xaa, 0x00, 0x38, 0x9b, 0x71 };
+
+    static bool hasTag(const std::byte* in_data, const char* in_tag) noexcept
+    {
+        return std::memcmp(in_data, in_tag, 4) == 0;
+    }
+
+    // The fields of a WAV file are little endian no matter what the host is.
+    static std::uint64_t readLittle(const std::byte* in_data, const std::size_t in_bytes) noexcept
+    {
+        std::uint64_t value = 0;
+
+        for (std::size_t i = 0; i < in_bytes; i++)
+        {
+            value |= static_cast<std::uint64_t>(in_data[i]) << (i * 8);
+        }
+
+        return value;
+    }
+
+    static std::byte* writeTag(std::byte* out_data, const char* in_tag) noexcept
+    {
+        std::memcpy(out_data, in_tag, 4);
+        return out_data + 4;
+    }
+
+    static std::byte* writeLittle(std::byte* out_data, const std::uint64_t in_value, const std::size_t in_bytes) noexcept
+    {
+        for (std::size_t i = 0; i < in_bytes; i++)
+        {
+            out_data[i] = static_cast<std::byte>(in_value >> (i * 8));
+        }
+
+        return out_data + in_bytes;
+    }
+
+    static void setSampleFormat(PcmFileInfo& io_info, const std::uint16_t in_tag, const std::size_t in_bits)
+    {
+        if (in_tag == wavePcm && in_bits == 16) io_info.format = PcmFormat::int16;
+        else if (in_tag == wavePcm && in_bits == 24) io_info.format = PcmFormat::int24;
+        else if (in_tag == wavePcm && in_bits == 32) io_info.format = PcmFormat::int32;
+        else if (in_tag == waveFloat && in_bits == 32) io_info.format = PcmFormat::float32;
+        else if (in_tag == waveFloat && in_bits == 64) io_info.format = PcmFormat::float64;
+        else throw ValueError(makeString("Unsupported WAV sample format: tag=", in_tag, " bits=", in_bits));
+
+        io_info.sampleSize = in_bits / 8;
+    }
+
+    std::size_t PcmFileInfo::frameSize() const noexcept
+    {
+        return sampleSize * channels;
+    }
+
+    /// @brief The layout that holds an interleaved frame as is or planar if there is none.
+    PcmLayout pcmFileLayout(const std::size_t in_channels) noexcept
+    {
+        if (in_channels == pcmLanes(PcmLayout::grouped4)) return PcmLayout::grouped4;
+        if (in_channels == pcmLanes(PcmLayout::grouped8)) return PcmLayout::grouped8;
+        return PcmLayout::planar;
+    }
+
+    static std::int32_t unpackInt24(const std::byte* in_data) noexcept
+    {
+        const auto value = static_cast<std::uint32_t>(in_data[0]) << 8
+            | static_cast<std::uint32_t>(in_data[1]) << 16
+            | static_cast<std::uint32_t>(in_data[2]) << 24;
+
+        return static_cast<std::int32_t>(value) >> 8;
+    }
+
+    template <std::size_t Size>
+    static void copyStrided(std::byte* out_data, const std::size_t in_outStride, const std::byte* in_data, const std::size_t in_inStride, const std::size_t in_count) noexcept
+    {
+        for (std::size_t i = 0; i < in_count; i++)
+        {
+            std::memcpy(out_data + i * in_outStride, in_data + i * in_inStride, Size);
+        }
+    }
+
+    // The sample size is known at compile time for every format so each copy is a single move
+    // instead of a call in to memcpy().
+    static void copyStrided(std::byte* out_data, const std::size_t in_outStride, const std::byte* in_data, const std::size_t in_inStride, const std::size_t in_size, const std::size_t in_count) noexcept
+    {
+        if (in_size == in_outStride && in_size == in_inStride)
+        {
+            std::memcpy(out_data, in_data, in_size * in_count);
+            return;
+        }
+
+        switch (in_size)
+        {
+            case 1: return copyStrided<1>(out_data, in_outStride, in_data, in_inStride, in_count);
+            case 2: return copyStrided<2>(out_data, in_outStride, in_data, in_inStride, in_count);
+            case 3: return copyStrided<3>(out_data, in_outStride, in_data, in_inStride, in_count);
+            case 4: return copyStrided<4>(out_data, in_outStride, in_data, in_inStride, in_count);
+            case 8: return copyStrided<8>(out_data, in_outStride, in_data, in_inStride, in_count);
+        }
+
+        for (std::size_t i = 0; i < in_count; i++)
+        {
+            std::memcpy(out_data + i * in_outStride, in_data + i * in_inStride, in_size);
+        }
+    }
+
+    /**
+     * @brief Copy interleaved frames into a block.
+     *
+     * A block with the layout from pcmFileLayout() takes the frames as they are. Otherwise the
+     * block must be planar and the frames are deinterleaved. The frames go in to the block
+     * starting at the frame in_offset.
+     */
+    void readPcmFrames(PcmBuffer& out_buffer, const std::byte* in_data, const PcmFileInfo& in_info, const std::size_t in_frames, const std::size_t in_offset) noexcept
+    {
+        const auto sampleSize = pcmSampleSize(in_info.format);
+        const auto frameSize = in_info.frameSize();
+
+        if (out_buffer.layout() != PcmLayout::planar)
+        {
+            assert(in_info.channels == out_buffer.lanes());
+            assert(in_info.sampleSize == sampleSize);
+
+            std::memcpy(out_buffer.groupData(0) + in_offset * frameSize, in_data, in_frames * frameSize);
+            return;
+        }
+
+        for (std::size_t channel = 0; channel < in_info.channels; channel++)
+        {
+            auto destination = out_buffer.channelData(channel) + in_offset * sampleSize;
+            auto source = in_data + channel * in_info.sampleSize;
+
+            if (in_info.sampleSize == sampleSize)
+            {
+                copyStrided(destination, sampleSize, source, frameSize, sampleSize, in_frames);
+            }
+            else
+            {
+                assert(in_info.format == PcmFormat::int24);
+
+                const auto samples = reinterpret_cast<std::int32_t*>(destination);
+
+                for (std::size_t frame = 0; frame < in_frames; frame++)
+                {
+                    samples[frame] = unpackInt24(source + frame * frameSize);
+                }
+            }
+        }
+    }
+
+    /**
+     * @brief Interleave the frames of a planar block.
+     *
+     * Packed 24 bit samples are the low 3 bytes of the 32 bit samples on a little endian host.
+     * The frames are taken from the block starting at the frame in_offset.
+     */
+    void writePcmFrames(std::byte* out_data, const PcmBuffer& in_buffer, const PcmFileInfo& in_info, const std::size_t in_frames, const std::size_t in_offset) noexcept
+    {
+        const auto sampleSize = pcmSampleSize(in_info.format);
+        const auto frameSize = in_info.frameSize();
+
+        assert(in_buffer.layout() == PcmLayout::planar);
+
+        for (std::size_t channel = 0; channel < in_info.channels; channel++)
+        {
+            const auto source = in_buffer.channelData(channel) + in_offset * sampleSize;
+            const auto destination = out_data + channel * in_info.sampleSize;
+
+            copyStrided(destination, frameSize, source, sampleSize, in_info.sampleSize, in_frames);
+        }
+    }
+
+    /// @brief True if the data starts with a RIFF or RF64 WAVE header.
+    bool isWavFile(const std::byte* in_data, const std::size_t in_bytes) noexcept
+    {
+        if (in_bytes < 12) return false;
+        if (! hasTag(in_data, "RIFF") && ! hasTag(in_data, "RF64")) return false;
+
+        return hasTag(in_data + 8, "WAVE");
+    }
+
+    /**
+     * @brief Find the samples in a WAV or RF64 file.
+     * @throws ValueError if the file is not WAV, is missing the format or data chunks or stores
+     * samples in a format that is not supported.
+     *
+     * A data chunk that claims to be longer than the file is cut short to what is there so a
+     * recording that was not finished can still be read.
+     */
+    PcmFileInfo readWavInfo(const std::byte* in_data, const std::size_t in_bytes)
+    {
+        if (! isWavFile(in_data, in_bytes)) throw ValueError("Not a WAV file");
+
+        PcmFileInfo info;
+        std::size_t dataBytes = 0;
+        std::uint64_t rf64DataBytes = 0;
+        bool haveFormat = false;
+        bool haveData = false;
+
+        info.container = hasTag(in_data, "RF64") ? PcmFileContainer::rf64 : PcmFileContainer::wav;
+
+        for (std::size_t offset = 12; offset + 8 <= in_bytes && ! haveData;)
+        {
+            const auto chunk = in_data + offset;
+            const auto size = static_cast<std::size_t>(readLittle(chunk + 4, 4));
+            const auto body = chunk + 8;
+            const auto available = in_bytes - offset - 8;
+
+            if (hasTag(chunk, "ds64") && available >= 24)
+            {
+                rf64DataBytes = readLittle(body + 8, 8);
+            }
+            else if (hasTag(chunk, "fmt ") && available >= 16 && size >= 16)
+            {
+                auto tag = static_cast<std::uint16_t>(readLittle(body, 2));
+                const auto blockAlign = static_cast<std::size_t>(readLittle(body + 12, 2));
+                const auto bits = static_cast<std::size_t>(readLittle(body + 14, 2));
+
+                info.channels = readLittle(body + 2, 2);
+                info.rate = readLittle(body + 4, 4);
+
+                // The sub format GUID starts with the tag the format would have had.
+                if (tag == waveExtensible && size >= 40 && available >= 40) tag = static_cast<std::uint16_t>(readLittle(body + 24, 2));
+
+                setSampleFormat(info, tag, bits);
+
+                if (info.channels == 0 || blockAlign != info.frameSize())
+                {
+                    throw ValueError(makeString("Invalid WAV block alignment: ", blockAlign));
+                }
+
+                haveFormat = true;
+            }
+            else if (hasTag(chunk, "data"))
+            {
+                info.dataOffset = offset + 8;
+                dataBytes = size == rf64Size && info.container == PcmFileContainer::rf64 ? rf64DataBytes : size;
+                haveData = true;
+            }
+
+            offset += 8 + size + (size & 1);
+        }
+
+        if (! haveFormat) throw ValueError("WAV file has no format chunk");
+        if (! haveData) throw ValueError("WAV file has no data chunk");
+
+        dataBytes = std::min(dataBytes, in_bytes - info.dataOffset);
+        info.frames = dataBytes / info.frameSize();
+
+        return info;
+    }
+
+    /**
+     * @brief Fill in a header of wavHeaderSize bytes for samples that follow it.
+     * @return The container that was needed for the amount of samples.
+     *
+     * The header is RIFF unless the samples are too large for its 32 bit sizes in which case it is
+     * RF64. Both have room for the ds64 chunk so a recording can be finished either way with out
+     * moving the samples. The format is always WAVE_FORMAT_EXTENSIBLE because the others can not
+     * describe more than two channels. The format and sample size of the info are written as is
+     * so 24 bit samples have to be packed.
+     */
+    PcmFileContainer writeWavHeader(std::byte* out_header, const PcmFileInfo& in_info) noexcept
+    {
+        const std::uint64_t dataBytes = in_info.frames * in_info.frameSize();
+        const std::uint64_t riffBytes = wavHeaderSize - 8 + dataBytes;
+        const auto rf64 = riffBytes > rf64Size;
+        const auto isFloat = in_info.format == PcmFormat::float32 || in_info.format == PcmFormat::float64;
+        const auto bits = in_info.sampleSize * 8;
+        auto position = out_header;
+
+        std::memset(out_header, 0, wavHeaderSize);
+
+        position = writeTag(position, rf64 ? "RF64" : "RIFF");
+        position = writeLittle(position, rf64 ? rf64Size : riffBytes, 4);
+        position = writeTag(position, "WAVE");
+
+        position = writeTag(position, rf64 ? "ds64" : "JUNK");
+        position = writeLittle(position, ds64Size, 4);
+
+        if (rf64)
+        {
+            writeLittle(position, riffBytes, 8);
+            writeLittle(position + 8, dataBytes, 8);
+            writeLittle(position + 16, in_info.frames, 8);
+        }
+
+        position += ds64Size;
+
+        position = writeTag(position, "fmt ");
+        position = writeLittle(position, extensibleFormatSize, 4);
+        position = writeLittle(position, waveExtensible, 2);
+        position = writeLittle(position, in_info.channels, 2);
+        position = writeLittle(position, in_info.rate, 4);
+        position = writeLittle(position, in_info.rate * in_info.frameSize(), 4);
+        position = writeLittle(position, in_info.frameSize(), 2);
+        position = writeLittle(position, bits, 2);
+        position = writeLittle(position, 22, 2);
+        position = writeLittle(position, bits, 2);
+        // No speaker positions are given for the channels.
+        position = writeLittle(position, 0, 4);
+        // The sub format GUID is KSDATAFORMAT_SUBTYPE_PCM or KSDATAFORMAT_SUBTYPE_IEEE_FLOAT.
+        position = writeLittle(position, isFloat ? waveFloat : wavePcm, 2);
+        std::memcpy(position, guidTail, sizeof(guidTail));
+        position += sizeof(guidTail);
+
+        const auto dataHeader = out_header + wavHeaderSize - 8;
+
+        position = writeTag(position, "JUNK");
+        writeLittle(position, dataHeader - position - 4, 4);
+
+        position = writeTag(dataHeader, "data");
+        writeLittle(position, rf64 ? rf64Size : dataBytes, 4);
+
+        return rf64 ? PcmFileContainer::rf64 : PcmFileContainer::wav;
+    }
+
+    std::string toString(const PcmFileContainer in_container) noexcept
+    {
+        switch (in_container)
+        {
+            case PcmFileContainer::raw: return "raw";
+            case PcmFileContainer::wav: return "wav";
+            case PcmFileContainer::rf64: return "rf64";
+        }
+
+        FATAL_ERROR(makeString("Unhandled PcmFileContainer value: ", static_cast<int>(in_container)));
+    }
+
+    std::ostream& operator<<(std::ostream& in_os, const PcmFileContainer in_container) noexcept
+    {
+        in_os << toString(in_container);
+        return in_os;
+    }
+}
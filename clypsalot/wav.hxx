@@ -0,0 +1,66 @@
+/* Copyright 2023 Tyler Riddle
+ *
+ * This file is part of Clypsalot. Clypsalot is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU Lesser General Public License as published by the Free Software Foundation, either version 3 of the License,
+ * or (at your option) any later version. Clypsalot is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along with Clypsalot. If not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+
+#include <clypsalot/pcm.hxx>
+
+/// @file
+namespace Clypsalot
+{
+    enum class PcmFileContainer : uint_fast8_t
+    {
+        /// @brief Samples with no header whose settings have to be given by the user.
+        raw,
+        wav,
+        /// @brief The 64 bit extension of WAV for files larger than 4 GiB.
+        rf64,
+    };
+
+    /**
+     * @brief Where the samples of a PCM file are and how they are stored.
+     *
+     * The samples are interleaved frame by frame. The sample size is the number of bytes each
+     * sample takes in the file which is 3 for packed 24 bit samples and otherwise matches the
+     * format.
+     */
+    struct PcmFileInfo
+    {
+        PcmFileContainer container = PcmFileContainer::raw;
+        PcmFormat format = PcmFormat::float32;
+        std::size_t sampleSize = 0;
+        std::size_t channels = 0;
+        std::size_t rate = 0;
+        std::size_t dataOffset = 0;
+        std::size_t frames = 0;
+
+        std::size_t frameSize() const noexcept;
+    };
+
+    /// @brief The size of the header written by writeWavHeader(). The samples start right after it
+    /// so they are page aligned.
+    constexpr std::size_t wavHeaderSize = 4096;
+
+    PcmLayout pcmFileLayout(const std::size_t in_channels) noexcept;
+    void readPcmFrames(PcmBuffer& out_buffer, const std::byte* in_data, const PcmFileInfo& in_info, const std::size_t in_frames, const std::size_t in_offset = 0) noexcept;
+    void writePcmFrames(std::byte* out_data, const PcmBuffer& in_buffer, const PcmFileInfo& in_info, const std::size_t in_frames, const std::size_t in_offset = 0) noexcept;
+    bool isWavFile(const std::byte* in_data, const std::size_t in_bytes) noexcept;
+    PcmFileInfo readWavInfo(const std::byte* in_data, const std::size_t in_bytes);
+    PcmFileContainer writeWavHeader(std::byte* out_header, const PcmFileInfo& in_info) noexcept;
+    std::string toString(const PcmFileContainer in_container) noexcept;
+    std::ostream& operator<<(std::ostream& in_os, const PcmFileContainer in_container) noexcept;
+}
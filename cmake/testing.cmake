@@ -14,6 +14,7 @@ include(CTest)
 set(CLYPSALOT_TEST_BIN_TARGET tests)
 set(CLYPSALOT_VALIDATION_TARGET validate)
 set(CLYPSALOT_MEM_VALIDATION_TARGET memcheck)
+set(CLYPSALOT_BENCHMARK_TARGET benchmarks)
 
 # Target to build all test programs
 add_custom_target(${CLYPSALOT_TEST_BIN_TARGET})
@@ -23,6 +24,10 @@ add_custom_target(${CLYPSALOT_VALIDATION_TARGET} ctest -j ${PARALLEL_LEVEL})
 # Target to run the tests under valgrind/other memory usage validator
 add_custom_target(${CLYPSALOT_MEM_VALIDATION_TARGET} ctest -T memcheck -j ${PARALLEL_LEVEL})
 
+# Target to build all the benchmark programs. Benchmarks are not tests so they are not run by
+# ctest; run the programs from the bin directory.
+add_custom_target(${CLYPSALOT_BENCHMARK_TARGET})
+
 add_dependencies(${CLYPSALOT_VALIDATION_TARGET} ${CLYPSALOT_TEST_BIN_TARGET})
 add_dependencies(${CLYPSALOT_MEM_VALIDATION_TARGET} ${CLYPSALOT_TEST_BIN_TARGET})
 
@@ -43,3 +48,22 @@ function(add_clypsalot_test type name)
     add_dependencies(${TEST_TYPE_TARGET} ${TEST_TARGET})
     add_test(NAME ${TEST_TARGET} COMMAND ${TEST_NAME})
 endfunction()
+
+function(add_clypsalot_benchmark name)
+    set(BENCHMARK_NAME benchmark-${name})
+
+    add_executable(${BENCHMARK_NAME} EXCLUDE_FROM_ALL benchmark/${name}.cxx)
+    target_link_libraries(${BENCHMARK_NAME} PUBLIC ${CLYPSALOT_TEST_LIB_TARGET})
+    add_dependencies(${CLYPSALOT_BENCHMARK_TARGET} ${BENCHMARK_NAME})
+endfunction()
+
+# Programs that help with testing by hand such as stand ins for outside processes. They are built
+# with the tests.
+function(add_clypsalot_tool name)
+    set(TOOL_NAME tool-${name})
+
+    add_executable(${TOOL_NAME} EXCLUDE_FROM_ALL tool/${name}.cxx)
+    set_target_properties(${TOOL_NAME} PROPERTIES OUTPUT_NAME "${name}")
+    target_link_libraries(${TOOL_NAME} PUBLIC ${CLYPSALOT_TEST_LIB_TARGET})
+    add_dependencies(${CLYPSALOT_TEST_BIN_TARGET} ${TOOL_NAME})
+endfunction()
@@ -20,6 +20,7 @@
 #include <QString>
 
 #include <clypsalot/error.hxx>
+#include <clypsalot/io.hxx>
 #include <clypsalot/logging.hxx>
 #include <clypsalot/macros.hxx>
 #include <clypsalot/module.hxx>
@@ -63,6 +64,7 @@ int main(int argc, char *argv[])
     application.setPalette(darkTheme());
     initMetaTypes();
     initThreadQueue(args.value(threadsArg).toUInt());
+    initIoService();
 
     openWindow(MainWindow::instance());
     if (args.isSet(showLogWindowArg)) openWindow(LogWindow::instance());
@@ -99,6 +101,8 @@ static void shutdown()
     MainWindow::instance()->workArea()->stopObjects();
     LOGGER(debug, "Shutting down thread queue");
     shutdownThreadQueue();
+    LOGGER(debug, "Shutting down I/O service");
+    shutdownIoService();
     LOGGER(debug, "Done shutting down");
 }
 
@@ -83,6 +83,7 @@ void MainWindow::loadModules()
     std::thread([this]
     {
         statusMessage("Loading modules");
+        Clypsalot::importModule(Clypsalot::builtinModuleDescriptor());
         Clypsalot::importModule(Clypsalot::testModuleDescriptor());
         statusMessage("Modules loaded");
     }).detach();
@@ -32,9 +32,15 @@ void ObjectPropertiesEditor::addProperty(const QString& name, const Clypsalot::P
     switch (type)
     {
         case Clypsalot::PropertyType::boolean: widget = new BooleanComboBox(this); break;
+        // Arrays and tables are edited as text like [1, 2, 3] or [[1, 2], [3, 4]]
+        case Clypsalot::PropertyType::doubleArray: widget = new StringLineEdit(this); break;
+        case Clypsalot::PropertyType::doubleTable: widget = new StringLineEdit(this); break;
         case Clypsalot::PropertyType::file: widget = new StringLineEdit(this); break;
         case Clypsalot::PropertyType::integer: widget = new IntegerLineEdit(this); break;
+        case Clypsalot::PropertyType::integerArray: widget = new StringLineEdit(this); break;
         case Clypsalot::PropertyType::real: widget = new RealLineEdit(this); break;
+        case Clypsalot::PropertyType::realArray: widget = new StringLineEdit(this); break;
+        case Clypsalot::PropertyType::realTable: widget = new StringLineEdit(this); break;
         case Clypsalot::PropertyType::size: widget = new SizeLineEdit(this); break;
         case Clypsalot::PropertyType::string: widget = new StringLineEdit(this); break;
     }
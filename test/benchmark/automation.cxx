@@ -0,0 +1,131 @@
+/* Copyright 2023 Tyler Riddle
+ *
+ * This file is part of Clypsalot. Clypsalot is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation, either version 3 of the License,
+ * or (at your option) any later version. Clypsalot is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with Clypsalot. If not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include <clypsalot/automation.hxx>
+
+#include "test/lib/benchmark.hxx"
+#include "test/module/object.hxx"
+
+using namespace Clypsalot;
+
+static constexpr size_t totalEvents = 1000000;
+static constexpr size_t periodFrames = 64;
+static constexpr size_t eventSpacing = 4;
+
+static const PropertyList benchmarkProperties = {
+    { "Gain", PropertyType::real, Property::Automatable | Property::PublicMutable, 1.0 },
+};
+
+static std::shared_ptr<TestObject> makeBenchmarkObject()
+{
+    auto object = TestObject::make();
+    std::unique_lock lock(*object);
+
+    object->publicAddProperties(benchmarkProperties);
+    object->publicEnableAutomation(4096);
+    object->configure();
+
+    return object;
+}
+
+// Events are pushed from a control thread while the processing thread consumes them one period
+// at a time and renders the automated gain the way a processing Object would.
+static void benchmarkAutomationQueue()
+{
+    auto object = makeBenchmarkObject();
+    const auto gain = [&object] { std::unique_lock lock(*object); return object->propertyHandle("Gain"); }();
+    std::atomic_bool producerDone = false;
+    std::vector<float> values(periodFrames);
+    BenchmarkTimer timer;
+
+    std::thread producer([&]
+    {
+        for (size_t i = 0; i < totalEvents; i++)
+        {
+            const AutomationEvent event = { (i % (periodFrames / eventSpacing)) * eventSpacing, gain, static_cast<double>(i % 100), AutomationCurve::linear, eventSpacing };
+
+            while (! object->automate(event)) std::this_thread::yield();
+        }
+
+        producerDone = true;
+    });
+
+    // Every event offset is inside of a single period so the period after the producer finished
+    // applies all the remaining events.
+    while (true)
+    {
+        const bool lastPeriod = producerDone;
+        std::unique_lock lock(*object);
+        auto& automation = object->publicAutomation();
+        size_t frame = 0;
+
+        automation.beginPeriod(periodFrames);
+
+        while (frame < periodFrames)
+        {
+            const auto next = automation.apply(frame);
+
+            automation.lane(gain).render(values.data() + frame, frame, next);
+            frame = next;
+        }
+
+        automation.endPeriod();
+
+        if (lastPeriod) break;
+    }
+
+    producer.join();
+    benchmarkResult("Lock free automation events", totalEvents, "events", timer.seconds());
+}
+
+// The baseline is a control thread that takes the Object lock for every change.
+static void benchmarkLockedProperty()
+{
+    auto object = makeBenchmarkObject();
+    std::atomic_bool producerDone = false;
+    BenchmarkTimer timer;
+
+    std::thread producer([&]
+    {
+        for (size_t i = 0; i < totalEvents; i++)
+        {
+            std::unique_lock lock(*object);
+            object->property("Gain").realValue(static_cast<double>(i % 100));
+        }
+
+        producerDone = true;
+    });
+
+    while (! producerDone)
+    {
+        std::unique_lock lock(*object);
+        volatile auto value = object->property("Gain").realValue();
+        (void)value;
+    }
+
+    producer.join();
+    benchmarkResult("Locked property changes", totalEvents, "events", timer.seconds());
+}
+
+int main(int argc, char* argv[])
+{
+    initBenchmark(argc, argv);
+
+    benchmarkAutomationQueue();
+    benchmarkLockedProperty();
+
+    return 0;
+}
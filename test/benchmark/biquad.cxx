@@ -0,0 +1,83 @@
+/* Copyright 2023 Tyler Riddle
+ *
+ * This file is part of Clypsalot. Clypsalot is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation, either version 3 of the License,
+ * or (at your option) any later version. Clypsalot is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with Clypsalot. If not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+
+#include <cmath>
+
+#include <clypsalot/biquad.hxx>
+#include <clypsalot/util.hxx>
+
+#include "test/lib/benchmark.hxx"
+
+using namespace Clypsalot;
+
+static constexpr double sampleRate = 48000;
+static constexpr std::size_t periodFrames = 256;
+static constexpr std::size_t totalPeriods = 1000;
+
+/*
+ * Filter a period at a time in place like the equalizer does and report how many channel bands
+ * one core can keep up with at 48 kHz.
+ */
+static void benchmarkCascade(const std::size_t in_channels, const std::size_t in_bands, const SimdLevel in_level)
+{
+    BiquadCascade cascade(in_channels, in_bands, in_level);
+
+    // Levels the CPU does not have fall back to one it does which was already measured.
+    if (cascade.level() != in_level) return;
+
+    PcmBuffer buffer(PcmFormat::float32, in_channels, periodFrames, cascade.layout());
+
+    for (std::size_t band = 0; band < in_bands; band++)
+    {
+        cascade.coefficients(band, designBiquad(BiquadType::peak, sampleRate, 100 * std::pow(1.8, band), band % 2 ? 3 : -3, 1));
+    }
+
+    for (std::size_t group = 0; group < buffer.groups(); group++)
+    {
+        const auto samples = buffer.group<float>(group);
+
+        for (std::size_t sample = 0; sample < periodFrames * buffer.lanes(); sample++) samples[sample] = std::sin(sample * 0.01f + group);
+    }
+
+    cascade.process(buffer, buffer, periodFrames);
+
+    BenchmarkTimer timer;
+
+    for (std::size_t period = 0; period < totalPeriods; period++)
+    {
+        cascade.process(buffer, buffer, periodFrames);
+    }
+
+    const auto seconds = timer.seconds();
+    const auto realTime = totalPeriods * periodFrames / sampleRate / seconds;
+    const auto name = makeString(in_channels, " channels ", in_bands, " bands ", in_level);
+
+    benchmarkResult(name, totalPeriods * periodFrames * in_channels * in_bands, "band samples", seconds, { { realTime, "x real time" } });
+}
+
+int main(int argc, char* argv[])
+{
+    initBenchmark(argc, argv);
+
+    for (const auto channels : { 8, 64 })
+    {
+        for (const auto bands : { 4, 8 })
+        {
+            for (const auto level : { SimdLevel::scalar, SimdLevel::sse2, SimdLevel::avx2, SimdLevel::avx512 })
+            {
+                benchmarkCascade(channels, bands, level);
+            }
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,121 @@
+/* Copyright 2023 Tyler Riddle
+ *
+ * This file is part of Clypsalot. Clypsalot is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation, either version 3 of the License,
+ * or (at your option) any later version. Clypsalot is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with Clypsalot. If not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+
+#include <filesystem>
+#include <string>
+
+#include <clypsalot/capture.hxx>
+#include <clypsalot/catalog.hxx>
+#include <clypsalot/io.hxx>
+#include <clypsalot/pcm.hxx>
+#include <clypsalot/util.hxx>
+
+#include "test/lib/benchmark.hxx"
+#include "test/module/object.hxx"
+
+using namespace Clypsalot;
+
+static constexpr std::size_t blockSize = 256;
+static constexpr std::size_t totalBlocks = 20000;
+
+static std::filesystem::path capturePath()
+{
+    return std::filesystem::temp_directory_path() / "clypsalot-benchmark.capture";
+}
+
+/*
+ * Moves blocks across a link with and with out a capture on it. The difference is what leaving a
+ * capture on costs the thread that delivers the blocks since the file is written by another one.
+ */
+static void benchmarkCapture(const std::size_t in_channels, const bool in_capture)
+{
+    auto source = TestObject::make();
+    auto sink = TestObject::make();
+    std::scoped_lock lock(*source, *sink);
+    auto& output = source->publicAddOutput<PcmOutputPort>("output");
+    auto& input = sink->publicAddInput<PcmInputPort>("input");
+
+    output.config({ PcmFormat::float32, in_channels, blockSize, 0, 48000 });
+    source->configure();
+    sink->configure();
+
+    const auto link = linkPorts(output, input);
+
+    if (in_capture) link->startCapture(capturePath(), 64 * 1024 * 1024);
+
+    BenchmarkTimer timer;
+
+    for (std::size_t block = 0; block < totalBlocks; block++)
+    {
+        output.buffer();
+        output.commit(blockSize);
+        input.consume();
+    }
+
+    const auto seconds = timer.seconds();
+    const auto dropped = in_capture ? link->capture()->dropped() : 0;
+
+    link->stopCapture();
+    unlinkPorts(output, input);
+    benchmarkResult(makeString(in_channels, " channels", in_capture ? " captured" : "", dropped > 0 ? " (dropped)" : ""), totalBlocks, "blocks", seconds);
+}
+
+// Feed the last capture back through a link as fast as it can be read.
+static void benchmarkReplay(const std::size_t in_channels)
+{
+    auto replay = objectCatalog().make("Link Replay");
+    auto sink = TestObject::make();
+    std::scoped_lock lock(*replay, *sink);
+    auto& input = sink->publicAddInput<PcmInputPort>("input");
+
+    replay->configure({ { "File", capturePath() } });
+    sink->configure();
+    linkPorts(replay->output("output"), input);
+    replay->start();
+
+    BenchmarkTimer timer;
+    std::size_t blocks = 0;
+
+    while (true)
+    {
+        replay->schedule();
+
+        const auto result = replay->execute();
+
+        input.consume();
+        blocks++;
+
+        if (result == ObjectProcessResult::endOfData) break;
+    }
+
+    const auto seconds = timer.seconds();
+
+    unlinkPorts(replay->output("output"), input);
+    benchmarkResult(makeString(in_channels, " channels replayed"), blocks, "blocks", seconds);
+}
+
+int main(int argc, char* argv[])
+{
+    initBenchmark(argc, argv);
+    initIoService();
+
+    for (const auto channels : { 2, 8, 64 })
+    {
+        benchmarkCapture(channels, false);
+        benchmarkCapture(channels, true);
+        benchmarkReplay(channels);
+    }
+
+    std::filesystem::remove(capturePath());
+    shutdownIoService();
+    return 0;
+}
@@ -0,0 +1,127 @@
+/* Copyright 2023 Tyler Riddle
+ *
+ * This file is part of Clypsalot. Clypsalot is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation, either version 3 of the License,
+ * or (at your option) any later version. Clypsalot is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with Clypsalot. If not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+
+#include <vector>
+
+#include "test/lib/benchmark.hxx"
+#include "test/module/object.hxx"
+
+using namespace Clypsalot;
+
+static constexpr size_t totalObjects = 10000;
+
+static const PropertyList benchmarkProperties = {
+    { "Channels", PropertyType::size, Property::Configurable, nullptr },
+    { "Sample Rate", PropertyType::size, Property::Configurable, nullptr },
+    { "Gain", PropertyType::real, Property::Configurable, nullptr },
+    { "Pan", PropertyType::real, Property::Configurable, nullptr },
+    { "Offset", PropertyType::integer, Property::Configurable, nullptr },
+    { "Bypass", PropertyType::boolean, Property::Configurable, nullptr },
+    { "Label", PropertyType::string, Property::Configurable, nullptr },
+    { "Impulse", PropertyType::file, Property::Configurable, nullptr },
+};
+
+static const ObjectConfig benchmarkConfig = {
+    { "Channels", 2 },
+    { "Sample Rate", 48000 },
+    { "Gain", 0.5 },
+    { "Pan", -0.25 },
+    { "Offset", 12 },
+    { "Bypass", false },
+    { "Label", "benchmark" },
+    { "Impulse", "/dev/null" },
+};
+
+static std::vector<std::shared_ptr<TestObject>> makeObjects()
+{
+    std::vector<std::shared_ptr<TestObject>> objects;
+
+    objects.reserve(totalObjects);
+
+    for (size_t i = 0; i < totalObjects; i++)
+    {
+        auto object = TestObject::make();
+        std::scoped_lock lock(*object);
+
+        object->publicAddProperties(benchmarkProperties);
+        objects.push_back(object);
+    }
+
+    return objects;
+}
+
+static void benchmarkAnyConfig()
+{
+    auto objects = makeObjects();
+    BenchmarkTimer timer;
+
+    for (const auto& object : objects)
+    {
+        std::scoped_lock lock(*object);
+        object->configure(benchmarkConfig);
+    }
+
+    benchmarkResult("Configure with ObjectConfig", totalObjects, "objects", timer.seconds());
+}
+
+static void benchmarkTypedConfig()
+{
+    auto objects = makeObjects();
+    BenchmarkTimer timer;
+    const auto values = [&objects]
+    {
+        std::scoped_lock lock(*objects.front());
+        objects.front()->init();
+        return objects.front()->compileConfig(benchmarkConfig);
+    }();
+
+    for (const auto& object : objects)
+    {
+        std::scoped_lock lock(*object);
+        if (object->state() == ObjectState::initializing) object->init();
+        object->configure(values);
+    }
+
+    benchmarkResult("Configure with PropertyValues", totalObjects, "objects", timer.seconds());
+}
+
+static void benchmarkStartup()
+{
+    BenchmarkTimer timer;
+    auto objects = makeObjects();
+    const auto values = [&objects]
+    {
+        std::scoped_lock lock(*objects.front());
+        objects.front()->init();
+        return objects.front()->compileConfig(benchmarkConfig);
+    }();
+
+    for (const auto& object : objects)
+    {
+        std::scoped_lock lock(*object);
+        if (object->state() == ObjectState::initializing) object->init();
+        object->configure(values);
+    }
+
+    benchmarkResult("Create and configure", totalObjects, "objects", timer.seconds());
+}
+
+int main(int argc, char* argv[])
+{
+    initBenchmark(argc, argv);
+
+    benchmarkAnyConfig();
+    benchmarkTypedConfig();
+    benchmarkStartup();
+
+    return 0;
+}
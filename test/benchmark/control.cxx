@@ -0,0 +1,204 @@
+/* Copyright 2023 Tyler Riddle
+ *
+ * This file is part of Clypsalot. Clypsalot is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation, either version 3 of the License,
+ * or (at your option) any later version. Clypsalot is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with Clypsalot. If not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include <clypsalot/control.hxx>
+#include <clypsalot/thread.hxx>
+
+#include "test/lib/benchmark.hxx"
+#include "test/module/object.hxx"
+
+using namespace Clypsalot;
+
+static constexpr std::size_t totalHops = 10;
+static constexpr std::size_t totalEvents = 250000;
+static constexpr std::size_t eventsPerPeriod = 64;
+
+// The first object makes events, the last one counts them and every one in between passes them on.
+class ControlHopObject : public TestObject
+{
+    ControlInputPort* m_input = nullptr;
+    ControlOutputPort* m_output = nullptr;
+    std::size_t m_remaining = 0;
+    std::atomic_size_t m_received = 0;
+
+    public:
+    static std::shared_ptr<ControlHopObject> make()
+    {
+        return _makeObject<ControlHopObject>(kindName);
+    }
+
+    ControlHopObject(const std::string& in_kind) :
+        TestObject(in_kind)
+    { }
+
+    void addPorts(const bool in_input, const bool in_output)
+    {
+        if (in_input) m_input = &publicAddInput<ControlInputPort>("input");
+        if (in_output) m_output = &publicAddOutput<ControlOutputPort>("output");
+    }
+
+    ControlInputPort& input() const noexcept
+    {
+        return *m_input;
+    }
+
+    ControlOutputPort& output() const noexcept
+    {
+        return *m_output;
+    }
+
+    void remaining(const std::size_t in_remaining) noexcept
+    {
+        m_remaining = in_remaining;
+    }
+
+    std::size_t received() const noexcept
+    {
+        return m_received.load(std::memory_order_acquire);
+    }
+
+    void hop() noexcept
+    {
+        if (m_input == nullptr)
+        {
+            for (std::size_t i = 0; i < eventsPerPeriod && m_remaining > 0; i++)
+            {
+                if (! m_output->push({ static_cast<std::uint32_t>(i), static_cast<std::uint32_t>(m_remaining), 1, ControlEventKind::trigger })) break;
+                m_remaining--;
+            }
+
+            return;
+        }
+
+        std::size_t received = 0;
+
+        while (const auto event = m_input->front())
+        {
+            if (m_output != nullptr && ! m_output->push(*event)) break;
+
+            m_input->pop();
+            received++;
+        }
+
+        m_received.fetch_add(received, std::memory_order_release);
+    }
+
+    virtual ObjectProcessResult process() override
+    {
+        hop();
+        return ObjectProcessResult::finished;
+    }
+};
+
+static std::vector<std::shared_ptr<ControlHopObject>> makeChain()
+{
+    std::vector<std::shared_ptr<ControlHopObject>> chain;
+
+    for (std::size_t i = 0; i <= totalHops; i++)
+    {
+        auto object = ControlHopObject::make();
+        std::scoped_lock lock(*object);
+
+        object->addPorts(i > 0, i < totalHops);
+        object->configure();
+
+        if (i == 0) object->remaining(totalEvents);
+
+        if (i > 0)
+        {
+            std::scoped_lock previousLock(*chain.back());
+            linkPorts(chain.back()->output(), object->input());
+        }
+
+        chain.push_back(object);
+    }
+
+    return chain;
+}
+
+static void unlinkChain(const std::vector<std::shared_ptr<ControlHopObject>>& in_chain)
+{
+    for (std::size_t i = 1; i < in_chain.size(); i++)
+    {
+        std::scoped_lock lock(*in_chain[i - 1], *in_chain[i]);
+        unlinkPorts(in_chain[i - 1]->output(), in_chain[i]->input());
+    }
+}
+
+// Moves the events along the chain from a single thread which is the cost of the queues alone.
+static void benchmarkDirect()
+{
+    const auto chain = makeChain();
+    BenchmarkTimer timer;
+
+    while (chain.back()->received() < totalEvents)
+    {
+        for (const auto& object : chain)
+        {
+            std::scoped_lock lock(*object);
+            object->hop();
+        }
+    }
+
+    benchmarkResult("Control events over 10 hops direct", totalEvents, "events", timer.seconds());
+    unlinkChain(chain);
+}
+
+// Lets the scheduler run every object when its ports are ready.
+static void benchmarkScheduled()
+{
+    const auto chain = makeChain();
+    BenchmarkTimer timer;
+
+    for (auto i = chain.rbegin(); i != chain.rend(); i++)
+    {
+        std::scoped_lock lock(**i);
+        startObject(*i);
+    }
+
+    while (chain.back()->received() < totalEvents)
+    {
+        std::this_thread::sleep_for(std::chrono::microseconds(100));
+    }
+
+    const auto seconds = timer.seconds();
+
+    for (const auto& object : chain)
+    {
+        std::scoped_lock lock(*object);
+        stopObject(object);
+    }
+
+    benchmarkResult("Control events over 10 hops scheduled", totalEvents, "events", seconds);
+    unlinkChain(chain);
+}
+
+int main(int argc, char* argv[])
+{
+    initBenchmark(argc, argv);
+    initThreadQueue(std::max(std::thread::hardware_concurrency(), 2U));
+
+    benchmarkDirect();
+    benchmarkScheduled();
+
+    shutdownThreadQueue();
+
+    return 0;
+}
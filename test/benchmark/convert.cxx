@@ -0,0 +1,67 @@
+/* Copyright 2023 Tyler Riddle
+ *
+ * This file is part of Clypsalot. Clypsalot is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation, either version 3 of the License,
+ * or (at your option) any later version. Clypsalot is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with Clypsalot. If not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+
+#include <vector>
+
+#include <clypsalot/convert.hxx>
+#include <clypsalot/util.hxx>
+
+#include "test/lib/benchmark.hxx"
+
+using namespace Clypsalot;
+
+static constexpr std::size_t totalSamples = 1024 * 1024;
+static constexpr std::size_t totalPasses = 20;
+
+static void benchmarkConversion(const PcmFormat in_from, const PcmFormat in_to, const SimdLevel in_level)
+{
+    PcmConverter converter(in_from, in_to, PcmDither::none, in_level);
+
+    // Levels the CPU does not have fall back to one it does which was already measured.
+    if (converter.level() != in_level) return;
+
+    PcmBuffer source(in_from, 1, totalSamples);
+    PcmBuffer dest(in_to, 1, totalSamples);
+
+    converter.convert(source, dest, totalSamples);
+
+    BenchmarkTimer timer;
+
+    for (std::size_t pass = 0; pass < totalPasses; pass++)
+    {
+        converter.convert(source, dest, totalSamples);
+    }
+
+    const auto seconds = timer.seconds();
+    const auto bytes = static_cast<double>(totalPasses * totalSamples * (pcmSampleSize(in_from) + pcmSampleSize(in_to)));
+    const auto name = makeString(in_from, " -> ", in_to, " ", in_level);
+
+    benchmarkResult(name, bytes / 1e9, "GB", seconds);
+}
+
+int main(int argc, char* argv[])
+{
+    initBenchmark(argc, argv);
+
+    const std::vector<PcmFormat> formats = { PcmFormat::int16, PcmFormat::int24, PcmFormat::int32, PcmFormat::float64 };
+
+    for (const auto format : formats)
+    {
+        for (const auto level : { SimdLevel::scalar, SimdLevel::sse2, SimdLevel::avx2 })
+        {
+            benchmarkConversion(format, PcmFormat::float32, level);
+            benchmarkConversion(PcmFormat::float32, format, level);
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,101 @@
+/* Copyright 2023 Tyler Riddle
+ *
+ * This file is part of Clypsalot. Clypsalot is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation, either version 3 of the License,
+ * or (at your option) any later version. Clypsalot is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with Clypsalot. If not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+
+#include <clypsalot/convolution.hxx>
+#include <clypsalot/pcm.hxx>
+#include <clypsalot/thread.hxx>
+#include <clypsalot/util.hxx>
+
+#include "test/lib/benchmark.hxx"
+
+using namespace Clypsalot;
+
+static constexpr double sampleRate = 48000;
+static constexpr std::size_t totalChannels = 2;
+static constexpr std::size_t periodFrames = 256;
+static constexpr std::size_t totalPeriods = 400;
+
+/*
+ * Convolve a period at a time like the convolver object does with the tail on the ThreadQueue
+ * and report the mean and the worst time a period takes along with the budget a period has at
+ * 48 kHz. The mean is the wall clock time of the whole run so with a single core it includes
+ * the tail jobs. The worst case includes waiting for a tail job which only happens when the
+ * CPU is too busy to finish one in time.
+ */
+static void benchmarkConvolver(const double in_seconds, const SimdLevel in_level)
+{
+    const auto length = static_cast<std::size_t>(in_seconds * sampleRate);
+    PcmBuffer impulse(PcmFormat::float32, 1, length);
+    std::uint32_t seed = 1;
+
+    for (std::size_t frame = 0; frame < length; frame++)
+    {
+        seed = seed * 1664525 + 1013904223;
+        impulse.channel<float>(0)[frame] = static_cast<std::int32_t>(seed) / 2147483648.0f * std::exp(-6.0f * frame / length);
+    }
+
+    PcmConvolver convolver(impulse, length, totalChannels, periodFrames, true, in_level);
+
+    // Levels the CPU does not have fall back to one it does which was already measured.
+    if (convolver.level() != in_level) return;
+
+    PcmBuffer buffer(PcmFormat::float32, totalChannels, periodFrames);
+    double worst = 0;
+    BenchmarkTimer total;
+
+    for (std::size_t period = 0; period < totalPeriods; period++)
+    {
+        for (std::size_t channel = 0; channel < totalChannels; channel++)
+        {
+            for (std::size_t frame = 0; frame < periodFrames; frame++) buffer.channel<float>(channel)[frame] = std::sin((period * periodFrames + frame) * 0.01f);
+        }
+
+        BenchmarkTimer timer;
+
+        convolver.process(buffer, periodFrames);
+        worst = std::max(worst, timer.seconds());
+    }
+
+    const auto seconds = total.seconds();
+    const auto budget = periodFrames / sampleRate;
+    const auto name = makeString(totalChannels, " channels ", in_seconds, " s impulse ", in_level);
+
+    benchmarkResult(name, totalPeriods, "periods", seconds, {
+        { seconds / totalPeriods * 1e6, "us mean", 1 },
+        { worst * 1e6, "us worst", 1 },
+        { budget * 1e6, "us budget", 1 },
+        { static_cast<double>(convolver.tailPartitions()), "tail partitions" },
+    });
+}
+
+int main(int argc, char* argv[])
+{
+    initBenchmark(argc, argv);
+    initThreadQueue(0);
+
+    for (const auto seconds : { 0.1, 0.5, 1.0, 2.0, 5.0, 10.0 })
+    {
+        for (const auto level : { SimdLevel::scalar, SimdLevel::sse2, SimdLevel::avx2 })
+        {
+            benchmarkConvolver(seconds, level);
+        }
+    }
+
+    shutdownThreadQueue();
+
+    return 0;
+}
@@ -0,0 +1,220 @@
+/* Copyright 2023 Tyler Riddle
+ *
+ * This file is part of Clypsalot. Clypsalot is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation, either version 3 of the License,
+ * or (at your option) any later version. Clypsalot is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with Clypsalot. If not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+
+#include <atomic>
+#include <cmath>
+#include <cstdlib>
+#include <new>
+#include <string>
+#include <vector>
+
+#include <clypsalot/dynamics.hxx>
+#include <clypsalot/util.hxx>
+
+#include "test/lib/benchmark.hxx"
+
+using namespace Clypsalot;
+
+static std::atomic_size_t allocations = 0;
+
+void* operator new(const std::size_t size)
+{
+    allocations++;
+
+    if (const auto pointer = std::malloc(size ? size : 1)) return pointer;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* pointer) noexcept
+{
+    std::free(pointer);
+}
+
+void operator delete(void* pointer, const std::size_t) noexcept
+{
+    std::free(pointer);
+}
+
+static constexpr double sampleRate = 48000;
+static constexpr std::size_t totalChannels = 64;
+static constexpr std::size_t periodFrames = 256;
+static constexpr std::size_t totalPeriods = 1000;
+
+static void fill(PcmBuffer& out_buffer)
+{
+    for (std::size_t group = 0; group < out_buffer.groups(); group++)
+    {
+        const auto samples = out_buffer.group<float>(group);
+
+        for (std::size_t sample = 0; sample < periodFrames * out_buffer.lanes(); sample++) samples[sample] = std::sin(sample * 0.01f + group);
+    }
+}
+
+static void report(const std::string& in_name, const double in_seconds, const std::size_t in_allocated)
+{
+    const auto realTime = totalPeriods * periodFrames / sampleRate / in_seconds;
+
+    benchmarkResult(in_name, totalPeriods * periodFrames * totalChannels, "samples", in_seconds, { { realTime, "x real time" }, { static_cast<double>(in_allocated), "allocations" } });
+}
+
+/*
+ * Compress a period at a time in place like the compressor object does and report how many
+ * times faster than real time it runs at 48 kHz along with the allocations made while processing.
+ */
+static void benchmarkCompressor(const CompressorDetector in_detector, const std::size_t in_lookahead, const SimdLevel in_level)
+{
+    PcmCompressor compressor(totalChannels, sampleRate, in_lookahead, in_level);
+
+    // Levels the CPU does not have fall back to one it does which was already measured.
+    if (compressor.level() != in_level) return;
+
+    PcmBuffer buffer(PcmFormat::float32, totalChannels, periodFrames, compressor.layout());
+    CompressorSettings settings;
+
+    settings.detector = in_detector;
+    compressor.settings(settings);
+    fill(buffer);
+    compressor.process(buffer, periodFrames);
+
+    const auto before = allocations.load();
+    BenchmarkTimer timer;
+
+    for (std::size_t period = 0; period < totalPeriods; period++)
+    {
+        compressor.process(buffer, periodFrames);
+    }
+
+    const auto seconds = timer.seconds();
+    const auto allocated = allocations.load() - before;
+
+    report(makeString(totalChannels, " channels ", in_detector, " lookahead=", in_lookahead, " ", in_level), seconds, allocated);
+}
+
+/*
+ * The obvious gate that works one channel at a time with branches and the state in doubles. It
+ * is what the vectorized kernels are measured against.
+ */
+static void benchmarkGateReference(const GateSettings& in_settings)
+{
+    struct Channel
+    {
+        double gain = 0;
+        bool open = false;
+        double hold = 0;
+    };
+
+    const auto& s = in_settings;
+    const auto open = std::pow(10.0, s.threshold / 20.0);
+    const auto close = std::pow(10.0, (s.threshold - s.hysteresis) / 20.0);
+    const auto holdFrames = std::round(s.hold * sampleRate / 1000);
+    const auto attackStep = 1000 / (s.attack * sampleRate);
+    const auto releaseStep = 1000 / (s.release * sampleRate);
+    PcmBuffer buffer(PcmFormat::float32, totalChannels, periodFrames, PcmLayout::planar);
+    std::vector<Channel> channels(totalChannels);
+
+    fill(buffer);
+
+    const auto before = allocations.load();
+    BenchmarkTimer timer;
+
+    for (std::size_t period = 0; period < totalPeriods; period++)
+    {
+        for (std::size_t channel = 0; channel < totalChannels; channel++)
+        {
+            auto& state = channels[channel];
+            const auto samples = buffer.channel<float>(channel);
+
+            for (std::size_t frame = 0; frame < periodFrames; frame++)
+            {
+                const auto level = std::abs(samples[frame]);
+
+                if (level >= close) state.hold = holdFrames;
+                else if (state.hold > 0) state.hold--;
+
+                if (level >= open) state.open = true;
+                else if (level < close && state.hold <= 0) state.open = false;
+
+                if (state.open) state.gain = std::min(state.gain + attackStep, 1.0);
+                else state.gain = std::max(state.gain - releaseStep, 0.0);
+
+                samples[frame] *= state.gain;
+            }
+        }
+    }
+
+    const auto seconds = timer.seconds();
+    const auto allocated = allocations.load() - before;
+
+    report(makeString(totalChannels, " channels gate reference"), seconds, allocated);
+}
+
+/*
+ * Gate a period at a time in place like the gate object does. With silent input the gate is
+ * closed and the kernels are skipped which is what a gated channel costs.
+ */
+static void benchmarkGate(const GateSettings& in_settings, const bool in_silent, const SimdLevel in_level)
+{
+    PcmGate gate(totalChannels, sampleRate, in_level);
+
+    if (gate.level() != in_level) return;
+
+    PcmBuffer buffer(PcmFormat::float32, totalChannels, periodFrames, gate.layout());
+
+    gate.settings(in_settings);
+    gate.reset();
+    if (! in_silent) fill(buffer);
+    gate.process(buffer, periodFrames, in_silent);
+
+    const auto before = allocations.load();
+    BenchmarkTimer timer;
+
+    for (std::size_t period = 0; period < totalPeriods; period++)
+    {
+        gate.process(buffer, periodFrames, in_silent);
+    }
+
+    const auto seconds = timer.seconds();
+    const auto allocated = allocations.load() - before;
+
+    report(makeString(totalChannels, " channels gate", in_silent ? " silent " : " ", in_level), seconds, allocated);
+}
+
+int main(int argc, char* argv[])
+{
+    initBenchmark(argc, argv);
+
+    for (const auto detector : { CompressorDetector::peak, CompressorDetector::rms })
+    {
+        // 5 ms of lookahead at 48 kHz.
+        for (const auto lookahead : { 0, 240 })
+        {
+            for (const auto level : { SimdLevel::scalar, SimdLevel::sse2, SimdLevel::avx2 })
+            {
+                benchmarkCompressor(detector, lookahead, level);
+            }
+        }
+    }
+
+    GateSettings gate;
+
+    benchmarkGateReference(gate);
+
+    for (const auto silent : { false, true })
+    {
+        for (const auto level : { SimdLevel::scalar, SimdLevel::sse2, SimdLevel::avx2 })
+        {
+            benchmarkGate(gate, silent, level);
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,125 @@
+/* Copyright 2023 Tyler Riddle
+ *
+ * This file is part of Clypsalot. Clypsalot is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation, either version 3 of the License,
+ * or (at your option) any later version. Clypsalot is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with Clypsalot. If not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+
+#include <vector>
+
+#include <clypsalot/pcm.hxx>
+
+#include "test/lib/benchmark.hxx"
+#include "test/module/object.hxx"
+
+using namespace Clypsalot;
+
+static constexpr size_t totalPeriods = 20000;
+static constexpr PcmConfig benchmarkConfig = { PcmFormat::float32, 8, 256 };
+
+// The consumers only touch the start and end of every channel so the time measured is dominated
+// by moving the block to them instead of by what they do with it.
+static float touchBuffer(const PcmBuffer& buffer, const size_t frames)
+{
+    float sum = 0;
+
+    for (size_t channel = 0; channel < buffer.channels(); channel++)
+    {
+        const auto samples = buffer.channel<float>(channel);
+
+        sum += samples[0] + samples[frames - 1];
+    }
+
+    return sum;
+}
+
+static void benchmarkFanOut(const size_t consumers, const bool copy)
+{
+    auto source = TestObject::make();
+    auto sink = TestObject::make();
+    std::scoped_lock lock(*source, *sink);
+    auto& output = source->publicAddOutput<PcmOutputPort>("output");
+    std::vector<PcmInputPort*> inputs;
+    std::vector<PcmBuffer> copies;
+    float sum = 0;
+
+    output.config(benchmarkConfig);
+
+    for (size_t i = 0; i < consumers; i++)
+    {
+        inputs.push_back(&sink->publicAddInput<PcmInputPort>("input " + std::to_string(i)));
+        copies.emplace_back(benchmarkConfig.format, benchmarkConfig.channels, benchmarkConfig.blockSize);
+    }
+
+    source->configure();
+    sink->configure();
+
+    for (const auto input : inputs)
+    {
+        linkPorts(output, *input);
+    }
+
+    BenchmarkTimer timer;
+
+    for (size_t period = 0; period < totalPeriods; period++)
+    {
+        auto& buffer = output.buffer();
+
+        for (size_t channel = 0; channel < buffer.channels(); channel++)
+        {
+            auto samples = buffer.channel<float>(channel);
+
+            for (size_t frame = 0; frame < benchmarkConfig.blockSize; frame++)
+            {
+                samples[frame] = period + frame;
+            }
+        }
+
+        output.commit(benchmarkConfig.blockSize);
+
+        for (size_t i = 0; i < consumers; i++)
+        {
+            if (copy)
+            {
+                copies[i].copy(inputs[i]->buffer(), inputs[i]->frames());
+                sum += touchBuffer(copies[i], inputs[i]->frames());
+            }
+            else
+            {
+                sum += touchBuffer(inputs[i]->buffer(), inputs[i]->frames());
+            }
+
+            inputs[i]->consume();
+        }
+    }
+
+    const auto seconds = timer.seconds();
+    const auto bytes = static_cast<double>(totalPeriods) * consumers * benchmarkConfig.channels * benchmarkConfig.blockSize * sizeof(float);
+    const auto name = std::string("Fan-out 1 to ") + std::to_string(consumers) + (copy ? " copied" : " shared");
+
+    // Printing what the consumers read keeps the reads from being optimized away.
+    benchmarkResult(name, bytes / 1e6, "MB delivered", seconds, { { sum, "checksum" } });
+
+    for (const auto input : inputs)
+    {
+        unlinkPorts(output, *input);
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    initBenchmark(argc, argv);
+
+    for (const auto consumers : { 1, 2, 4, 8, 16 })
+    {
+        benchmarkFanOut(consumers, true);
+        benchmarkFanOut(consumers, false);
+    }
+
+    return 0;
+}
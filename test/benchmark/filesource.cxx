@@ -0,0 +1,189 @@
+/* Copyright 2023 Tyler Riddle
+ *
+ * This file is part of Clypsalot. Clypsalot is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation, either version 3 of the License,
+ * or (at your option) any later version. Clypsalot is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with Clypsalot. If not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <clypsalot/filesource.hxx>
+#include <clypsalot/pcm.hxx>
+#include <clypsalot/thread.hxx>
+#include <clypsalot/util.hxx>
+
+#include "test/lib/benchmark.hxx"
+#include "test/module/object.hxx"
+
+using namespace Clypsalot;
+
+static constexpr std::size_t fileBytes = 8 * 1024 * 1024;
+static constexpr std::size_t blockSize = 256;
+
+// Reads every sample it is given so the pages of the file are really touched.
+class FileSinkObject : public TestObject
+{
+    PcmInputPort* m_input = nullptr;
+    std::atomic_size_t m_frames = 0;
+    float m_sum = 0;
+
+    public:
+    static std::shared_ptr<FileSinkObject> make()
+    {
+        return _makeObject<FileSinkObject>(kindName);
+    }
+
+    FileSinkObject(const std::string& in_kind) :
+        TestObject(in_kind)
+    {
+        std::scoped_lock lock(*this);
+
+        m_input = &publicAddInput<PcmInputPort>("input");
+    }
+
+    PcmInputPort& input() const noexcept
+    {
+        return *m_input;
+    }
+
+    std::size_t frames() const noexcept
+    {
+        return m_frames.load(std::memory_order_acquire);
+    }
+
+    virtual ObjectProcessResult process() override
+    {
+        const auto& buffer = m_input->buffer();
+        const auto frames = m_input->frames();
+
+        if (buffer.layout() == PcmLayout::planar)
+        {
+            for (std::size_t channel = 0; channel < buffer.channels(); channel++)
+            {
+                const auto samples = buffer.channel<float>(channel);
+                for (std::size_t frame = 0; frame < frames; frame++) m_sum += samples[frame];
+            }
+        }
+        else
+        {
+            const auto samples = buffer.group<float>(0);
+            for (std::size_t sample = 0; sample < frames * buffer.lanes(); sample++) m_sum += samples[sample];
+        }
+
+        m_input->consume();
+        m_frames.fetch_add(frames, std::memory_order_release);
+
+        return ObjectProcessResult::finished;
+    }
+};
+
+struct BenchmarkFile
+{
+    const std::filesystem::path path;
+
+    BenchmarkFile(const std::size_t in_number, const std::size_t in_channels) :
+        path(std::filesystem::temp_directory_path() / makeString("clypsalot-benchmark-", in_number, "-", in_channels, ".raw"))
+    {
+        std::vector<float> samples(fileBytes / sizeof(float));
+        std::ofstream file(path, std::ios::binary);
+
+        for (std::size_t sample = 0; sample < samples.size(); sample++) samples[sample] = sample % 1024;
+
+        file.write(reinterpret_cast<const char*>(samples.data()), fileBytes);
+    }
+
+    ~BenchmarkFile()
+    {
+        std::filesystem::remove(path);
+    }
+};
+
+/*
+ * Plays raw float32 files through the scheduler with every source feeding its own sink. The files
+ * were just written so they come from the page cache and this measures mapping, readahead and
+ * delivering the blocks. 8 channel files are delivered with out copying and stereo files are
+ * deinterleaved into blocks from the pool.
+ */
+static void benchmarkSources(const std::size_t in_sources, const std::size_t in_channels)
+{
+    std::vector<std::unique_ptr<BenchmarkFile>> files;
+    std::vector<std::shared_ptr<FileSourceObject>> sources;
+    std::vector<std::shared_ptr<FileSinkObject>> sinks;
+    const auto framesPerFile = fileBytes / sizeof(float) / in_channels;
+
+    for (std::size_t i = 0; i < in_sources; i++)
+    {
+        files.push_back(std::make_unique<BenchmarkFile>(i, in_channels));
+
+        auto source = FileSourceObject::make();
+        auto sink = FileSinkObject::make();
+        std::scoped_lock lock(*source, *sink);
+
+        source->configure({ { "File", files.back()->path }, { "Channels", in_channels }, { "Block Size", blockSize } });
+        sink->configure();
+        linkPorts(source->output("output"), sink->input());
+
+        sources.push_back(source);
+        sinks.push_back(sink);
+    }
+
+    BenchmarkTimer timer;
+
+    for (std::size_t i = 0; i < in_sources; i++)
+    {
+        std::scoped_lock lock(*sources[i], *sinks[i]);
+        startObject(sinks[i]);
+        startObject(sources[i]);
+    }
+
+    for (const auto& sink : sinks)
+    {
+        while (sink->frames() < framesPerFile) std::this_thread::sleep_for(std::chrono::microseconds(100));
+    }
+
+    const auto seconds = timer.seconds();
+
+    for (std::size_t i = 0; i < in_sources; i++)
+    {
+        std::scoped_lock lock(*sources[i], *sinks[i]);
+        stopObject(sources[i]);
+        stopObject(sinks[i]);
+        unlinkPorts(sources[i]->output("output"), sinks[i]->input());
+    }
+
+    const auto name = makeString(in_sources, " file sources with ", in_channels, " channels");
+
+    const auto bytes = static_cast<double>(in_sources * fileBytes);
+
+    benchmarkResult(name, bytes / 1e9, "GB", seconds);
+}
+
+int main(int argc, char* argv[])
+{
+    initBenchmark(argc, argv);
+    initThreadQueue(std::max(std::thread::hardware_concurrency(), 2U));
+
+    for (const auto sources : { 1, 4, 16 })
+    {
+        benchmarkSources(sources, 8);
+        benchmarkSources(sources, 2);
+    }
+
+    shutdownThreadQueue();
+
+    return 0;
+}
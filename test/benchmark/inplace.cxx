@@ -0,0 +1,177 @@
+/* Copyright 2023 Tyler Riddle
+ *
+ * This file is part of Clypsalot. Clypsalot is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation, either version 3 of the License,
+ * or (at your option) any later version. Clypsalot is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with Clypsalot. If not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <vector>
+
+#include <clypsalot/pcm.hxx>
+
+#include "test/lib/benchmark.hxx"
+#include "test/module/object.hxx"
+
+using namespace Clypsalot;
+
+static constexpr size_t totalStages = 20;
+static constexpr size_t totalPeriods = 2000;
+static constexpr PcmConfig benchmarkConfig = { PcmFormat::float32, 8, 256 };
+
+struct Stage
+{
+    std::shared_ptr<TestObject> object;
+    PcmInputPort* input = nullptr;
+    PcmOutputPort* output = nullptr;
+};
+
+struct Chain
+{
+    std::shared_ptr<TestObject> source;
+    PcmOutputPort* sourceOutput = nullptr;
+    std::vector<Stage> stages;
+    std::shared_ptr<TestObject> sink;
+    PcmInputPort* sinkInput = nullptr;
+};
+
+static Chain makeChain(const bool inPlace)
+{
+    Chain chain;
+
+    chain.source = TestObject::make();
+    chain.sink = TestObject::make();
+
+    {
+        std::scoped_lock lock(*chain.source, *chain.sink);
+
+        chain.sourceOutput = &chain.source->publicAddOutput<PcmOutputPort>("output");
+        chain.sourceOutput->config(benchmarkConfig);
+        chain.sinkInput = &chain.sink->publicAddInput<PcmInputPort>("input");
+        chain.source->configure();
+        chain.sink->configure();
+    }
+
+    auto previousObject = chain.source;
+    auto previousOutput = chain.sourceOutput;
+
+    for (size_t i = 0; i < totalStages; i++)
+    {
+        Stage stage;
+
+        stage.object = TestObject::make();
+
+        std::scoped_lock lock(*previousObject, *stage.object);
+
+        stage.input = &stage.object->publicAddInput<PcmInputPort>("input");
+        stage.output = &stage.object->publicAddOutput<PcmOutputPort>("output");
+        stage.output->config(benchmarkConfig);
+        if (inPlace) stage.output->inPlace(stage.input);
+        stage.object->configure();
+        linkPorts(*previousOutput, *stage.input);
+
+        previousObject = stage.object;
+        previousOutput = stage.output;
+        chain.stages.push_back(stage);
+    }
+
+    std::scoped_lock lock(*previousObject, *chain.sink);
+    linkPorts(*previousOutput, *chain.sinkInput);
+
+    return chain;
+}
+
+static void applyGain(PcmBuffer& out_buffer, const PcmBuffer& in_buffer)
+{
+    for (size_t channel = 0; channel < out_buffer.channels(); channel++)
+    {
+        const auto input = in_buffer.channel<float>(channel);
+        auto output = out_buffer.channel<float>(channel);
+
+        for (size_t frame = 0; frame < benchmarkConfig.blockSize; frame++)
+        {
+            output[frame] = input[frame] * 0.5f;
+        }
+    }
+}
+
+// Runs one period through the chain and records the start of every buffer that was read or
+// written.
+static void runPeriod(Chain& chain, const bool inPlace, std::vector<const void*>& out_touched)
+{
+    {
+        std::scoped_lock lock(*chain.source);
+        auto& buffer = chain.sourceOutput->buffer();
+
+        out_touched.push_back(buffer.channel<float>(0));
+        chain.sourceOutput->commit(benchmarkConfig.blockSize);
+    }
+
+    for (auto& stage : chain.stages)
+    {
+        std::scoped_lock lock(*stage.object);
+
+        if (inPlace)
+        {
+            auto& buffer = stage.output->buffer();
+
+            applyGain(buffer, buffer);
+            out_touched.push_back(buffer.channel<float>(0));
+        }
+        else
+        {
+            auto& buffer = stage.output->buffer();
+
+            applyGain(buffer, stage.input->buffer());
+            out_touched.push_back(stage.input->buffer().channel<float>(0));
+            out_touched.push_back(buffer.channel<float>(0));
+            stage.input->consume();
+        }
+
+        stage.output->commit(benchmarkConfig.blockSize);
+    }
+
+    std::scoped_lock lock(*chain.sink);
+    out_touched.push_back(chain.sinkInput->buffer().channel<float>(0));
+    chain.sinkInput->consume();
+}
+
+static void benchmarkChain(const bool inPlace)
+{
+    auto chain = makeChain(inPlace);
+    std::vector<const void*> touched;
+    const auto blockBytes = benchmarkConfig.channels * benchmarkConfig.blockSize * sizeof(float);
+
+    touched.reserve(totalStages * 2 + 2);
+
+    BenchmarkTimer timer;
+
+    for (size_t period = 0; period < totalPeriods; period++)
+    {
+        touched.clear();
+        runPeriod(chain, inPlace, touched);
+    }
+
+    const auto seconds = timer.seconds();
+
+    std::sort(touched.begin(), touched.end());
+    const auto distinct = std::unique(touched.begin(), touched.end()) - touched.begin();
+    const auto name = std::string(inPlace ? "20 stage chain in place" : "20 stage chain copied");
+
+    benchmarkResult(name, totalPeriods, "periods", seconds, { { static_cast<double>(distinct * blockBytes), "bytes touched per period" } });
+}
+
+int main(int argc, char* argv[])
+{
+    initBenchmark(argc, argv);
+
+    benchmarkChain(false);
+    benchmarkChain(true);
+
+    return 0;
+}
@@ -0,0 +1,193 @@
+/* Copyright 2023 Tyler Riddle
+ *
+ * This file is part of Clypsalot. Clypsalot is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation, either version 3 of the License,
+ * or (at your option) any later version. Clypsalot is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with Clypsalot. If not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <clypsalot/io.hxx>
+#include <clypsalot/util.hxx>
+
+#include "test/lib/benchmark.hxx"
+
+using namespace Clypsalot;
+using Clock = std::chrono::steady_clock;
+
+static constexpr std::size_t fileSize = 64 * 1024 * 1024;
+static constexpr std::size_t readSize = 4096;
+static constexpr std::size_t totalReads = 200000;
+static constexpr std::size_t users = 16;
+
+// The offset of a read spread over the whole file.
+static std::size_t readOffset(const std::size_t in_read) noexcept
+{
+    return (in_read * 2654435761 % (fileSize / readSize)) * readSize;
+}
+
+static void printResult(const std::string& in_name, const double in_latency, const double in_seconds)
+{
+    benchmarkResult(in_name, totalReads, "reads", in_seconds, { { in_latency * 1e6, "us latency", 2 } });
+}
+
+/*
+ * Every user is like an Object that keeps one read in flight and submits the next one from the
+ * completion of the last one.
+ */
+struct User
+{
+    IoService* service = nullptr;
+    std::atomic_size_t* remaining = nullptr;
+    std::atomic_size_t* finished = nullptr;
+    IoRequest request;
+    Clock::time_point submitted;
+    double latency = 0;
+    std::vector<std::byte> buffer = std::vector<std::byte>(readSize);
+
+    bool next() noexcept
+    {
+        const auto left = remaining->fetch_sub(1);
+
+        if (left == 0 || left > totalReads) return false;
+
+        request.offset = readOffset(left);
+        submitted = Clock::now();
+
+        return service->submit(request);
+    }
+
+    static void complete(IoRequest& io_request) noexcept
+    {
+        auto& user = *static_cast<User*>(io_request.context);
+
+        user.latency += std::chrono::duration<double>(Clock::now() - user.submitted).count();
+
+        if (user.next()) return;
+
+        user.finished->fetch_add(1);
+        user.finished->notify_all();
+    }
+};
+
+static void benchmarkService(const int in_fd, const IoBackend in_backend)
+{
+    const auto service = in_backend == IoBackend::uring ? IoService::make(in_backend) : std::make_unique<ThreadIoService>(IoService::defaultDepth);
+    std::atomic_size_t remaining = totalReads;
+    std::atomic_size_t finished = 0;
+    std::vector<User> all(users);
+    double latency = 0;
+
+    BenchmarkTimer timer;
+
+    for (auto& user : all)
+    {
+        user.service = service.get();
+        user.remaining = &remaining;
+        user.finished = &finished;
+        user.request = { IoOperation::read, in_fd, user.buffer.data(), readSize, 0, User::complete, &user };
+
+        if (! user.next()) finished++;
+    }
+
+    for (auto count = finished.load(); count < users; count = finished.load())
+    {
+        finished.wait(count);
+    }
+
+    const auto seconds = timer.seconds();
+
+    for (const auto& user : all)
+    {
+        latency += user.latency;
+    }
+
+    printResult(makeString(service->backend(), " service"), latency / totalReads, seconds);
+}
+
+// Every user has a thread of its own that does blocking reads.
+static void benchmarkThreads(const int in_fd)
+{
+    std::atomic_size_t remaining = totalReads;
+    std::vector<double> latencies(users);
+    std::vector<std::thread> threads;
+    double latency = 0;
+
+    BenchmarkTimer timer;
+
+    for (std::size_t user = 0; user < users; user++)
+    {
+        threads.emplace_back([&, user]
+        {
+            std::vector<std::byte> buffer(readSize);
+
+            while (true)
+            {
+                const auto left = remaining.fetch_sub(1);
+
+                if (left == 0 || left > totalReads) return;
+
+                const auto start = Clock::now();
+
+                if (pread(in_fd, buffer.data(), readSize, readOffset(left)) != readSize) return;
+
+                latencies[user] += std::chrono::duration<double>(Clock::now() - start).count();
+            }
+        });
+    }
+
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+
+    const auto seconds = timer.seconds();
+
+    for (const auto value : latencies)
+    {
+        latency += value;
+    }
+
+    printResult("blocking thread per user", latency / totalReads, seconds);
+}
+
+/*
+ * Random 4 KiB reads from a file in the page cache by 16 users at once which is the cost of the
+ * I/O path itself instead of the disk. The latency is from submitting a read to its completion.
+ */
+int main(int argc, char* argv[])
+{
+    initBenchmark(argc, argv);
+
+    const auto path = std::filesystem::temp_directory_path() / "clypsalot-benchmark-io.bin";
+    const auto fd = open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    std::vector<std::byte> chunk(1024 * 1024, std::byte(1));
+
+    for (std::size_t written = 0; written < fileSize; written += chunk.size())
+    {
+        if (pwrite(fd, chunk.data(), chunk.size(), written) != static_cast<ssize_t>(chunk.size())) return 1;
+    }
+
+    benchmarkService(fd, IoBackend::uring);
+    benchmarkService(fd, IoBackend::threads);
+    benchmarkThreads(fd);
+
+    close(fd);
+    std::filesystem::remove(path);
+
+    return 0;
+}
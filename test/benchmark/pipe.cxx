@@ -0,0 +1,158 @@
+/* Copyright 2023 Tyler Riddle
+ *
+ * This file is part of Clypsalot. Clypsalot is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation, either version 3 of the License,
+ * or (at your option) any later version. Clypsalot is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with Clypsalot. If not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <signal.h>
+#include <spawn.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <clypsalot/io.hxx>
+#include <clypsalot/object.hxx>
+#include <clypsalot/pcm.hxx>
+#include <clypsalot/pipe.hxx>
+#include <clypsalot/port.hxx>
+#include <clypsalot/property.hxx>
+#include <clypsalot/thread.hxx>
+#include <clypsalot/util.hxx>
+
+#include "test/lib/benchmark.hxx"
+
+using namespace Clypsalot;
+
+static constexpr std::size_t streamBytes = 256 * 1024 * 1024;
+static constexpr std::size_t chunkSize = 64 * 1024;
+
+// Feed the stream into one pipe and take it out of another while the thing in the middle runs.
+static double measure(const int in_writer, const int in_reader)
+{
+    const std::vector<std::byte> chunk(chunkSize, std::byte(1));
+    BenchmarkTimer timer;
+
+    std::thread writer([&]
+    {
+        for (std::size_t written = 0; written < streamBytes; written += chunkSize)
+        {
+            if (write(in_writer, chunk.data(), chunk.size()) != static_cast<ssize_t>(chunk.size())) break;
+        }
+
+        close(in_writer);
+    });
+
+    std::vector<std::byte> buffer(chunkSize);
+    std::size_t total = 0;
+
+    while (true)
+    {
+        const auto result = read(in_reader, buffer.data(), buffer.size());
+
+        if (result <= 0) break;
+
+        total += result;
+    }
+
+    writer.join();
+    close(in_reader);
+
+    if (total != streamBytes) throw RuntimeError(makeString("Only got ", total, " of ", streamBytes, " bytes"));
+
+    return timer.seconds();
+}
+
+static void report(const std::string& in_name, const double in_seconds)
+{
+    benchmarkResult(in_name, streamBytes / 1e9, "GB", in_seconds);
+}
+
+static void benchmarkCat()
+{
+    int in[2];
+    int out[2];
+    posix_spawn_file_actions_t actions;
+    pid_t pid;
+    char name[] = "cat";
+    char* arguments[] = { name, nullptr };
+
+    if (pipe(in) != 0 || pipe(out) != 0) throw RuntimeError("Could not create the pipes");
+
+    posix_spawn_file_actions_init(&actions);
+    posix_spawn_file_actions_adddup2(&actions, in[0], STDIN_FILENO);
+    posix_spawn_file_actions_adddup2(&actions, out[1], STDOUT_FILENO);
+    posix_spawn_file_actions_addclose(&actions, in[1]);
+    posix_spawn_file_actions_addclose(&actions, out[0]);
+
+    if (posix_spawnp(&pid, name, &actions, nullptr, arguments, environ) != 0) throw RuntimeError("Could not run cat");
+
+    posix_spawn_file_actions_destroy(&actions);
+    close(in[0]);
+    close(out[1]);
+
+    const auto seconds = measure(in[1], out[0]);
+
+    waitpid(pid, nullptr, 0);
+    report("cat", seconds);
+}
+
+static void benchmarkObjects(const std::size_t in_channels, const bool in_splice)
+{
+    int in[2];
+    int out[2];
+
+    if (pipe(in) != 0 || pipe(out) != 0) throw RuntimeError("Could not create the pipes");
+
+    auto source = PipeSourceObject::make();
+    auto sink = PipeSinkObject::make();
+    bool direct = false;
+
+    {
+        std::scoped_lock lock(*source, *sink);
+
+        source->configure({ { "Descriptor", in[0] }, { "Channels", in_channels }, { "Block Size", 4096 } });
+        sink->configure({ { "Descriptor", out[1] }, { "Splice", in_splice } });
+        direct = source->direct();
+        linkPorts(source->output("output"), sink->input("input"));
+        startObject(source);
+        startObject(sink);
+    }
+
+    close(in[0]);
+    close(out[1]);
+
+    const auto seconds = measure(in[1], out[0]);
+    const auto name = makeString("source to sink ", in_channels, " channels", direct ? " direct" : "", in_splice ? " vmsplice" : "");
+
+    report(name, seconds);
+}
+
+int main(int argc, char* argv[])
+{
+    initBenchmark(argc, argv);
+    initThreadQueue(std::max(std::thread::hardware_concurrency(), 2U));
+    initIoService();
+
+    benchmarkCat();
+
+    for (const auto channels : { 1, 2, 8 })
+    {
+        benchmarkObjects(channels, false);
+        benchmarkObjects(channels, true);
+    }
+
+    shutdownIoService();
+    shutdownThreadQueue();
+
+    return 0;
+}
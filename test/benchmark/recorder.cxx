@@ -0,0 +1,113 @@
+/* Copyright 2023 Tyler Riddle
+ *
+ * This file is part of Clypsalot. Clypsalot is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation, either version 3 of the License,
+ * or (at your option) any later version. Clypsalot is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with Clypsalot. If not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+
+#include <chrono>
+#include <filesystem>
+#include <string>
+#include <thread>
+
+#include <clypsalot/io.hxx>
+#include <clypsalot/pcm.hxx>
+#include <clypsalot/recorder.hxx>
+#include <clypsalot/util.hxx>
+
+#include "test/lib/benchmark.hxx"
+#include "test/module/object.hxx"
+
+using namespace Clypsalot;
+
+static constexpr std::size_t totalChannels = 64;
+static constexpr std::size_t sampleRate = 96000;
+static constexpr std::size_t blockSize = 256;
+static constexpr std::size_t audioSeconds = 8;
+static constexpr std::size_t ringSize = 64 * 1024 * 1024;
+
+/*
+ * Records 64 channels of float32 at 96 kHz as fast as the writer can take it. Blocks are only
+ * held back while the ring is more than half full so the result is the rate the writer sustains
+ * and how many times faster than real time that is. Nothing should ever be dropped.
+ */
+static void benchmarkRecorder(const std::filesystem::path& in_directory, const bool in_direct)
+{
+    const auto path = in_directory / "clypsalot-benchmark-recorder.wav";
+    const auto totalBlocks = audioSeconds * sampleRate / blockSize;
+    auto source = TestObject::make();
+    auto recorder = RecorderObject::make();
+    std::size_t overruns = 0;
+    bool direct = false;
+    PcmOutputPort* output = nullptr;
+
+    {
+        std::scoped_lock lock(*source, *recorder);
+
+        output = &source->publicAddOutput<PcmOutputPort>("output");
+
+        output->config({ PcmFormat::float32, totalChannels, blockSize, 0, sampleRate });
+        source->configure();
+        recorder->configure({ { "File", path }, { "Direct I/O", in_direct }, { "Ring Size", ringSize } });
+        linkPorts(*output, static_cast<PcmInputPort&>(recorder->input("input")));
+        recorder->start();
+    }
+
+    BenchmarkTimer timer;
+
+    for (std::size_t block = 0; block < totalBlocks; block++)
+    {
+        while (recorder->ringFill() > ringSize / 2) std::this_thread::sleep_for(std::chrono::microseconds(100));
+
+        std::scoped_lock lock(*source, *recorder);
+        auto& buffer = output->buffer();
+
+        for (std::size_t channel = 0; channel < totalChannels; channel++)
+        {
+            buffer.channel<float>(channel)[0] = block;
+        }
+
+        output->commit(blockSize);
+        recorder->schedule();
+        recorder->execute();
+    }
+
+    {
+        std::scoped_lock lock(*source, *recorder);
+
+        overruns = recorder->property("Overruns").sizeValue();
+        direct = recorder->direct();
+        stopObject(recorder);
+        unlinkPorts(*output, static_cast<PcmInputPort&>(recorder->input("input")));
+    }
+
+    // Destroying the recorder waits for the writer to finish the file.
+    recorder.reset();
+
+    const auto seconds = timer.seconds();
+    const auto bytes = static_cast<double>(std::filesystem::file_size(path));
+    const auto name = makeString(in_directory.string(), direct ? " direct" : " buffered");
+
+    std::filesystem::remove(path);
+
+    benchmarkResult(name, bytes / 1e9, "GB", seconds, { { audioSeconds / seconds, "x real time", 2 }, { static_cast<double>(overruns), "overruns" } });
+}
+
+int main(int argc, char* argv[])
+{
+    initBenchmark(argc, argv);
+    initIoService();
+
+    if (std::filesystem::is_directory("/dev/shm")) benchmarkRecorder("/dev/shm", false);
+
+    benchmarkRecorder(std::filesystem::temp_directory_path(), false);
+    benchmarkRecorder(std::filesystem::temp_directory_path(), true);
+
+    shutdownIoService();
+    return 0;
+}
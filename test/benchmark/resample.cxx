@@ -0,0 +1,69 @@
+/* Copyright 2023 Tyler Riddle
+ *
+ * This file is part of Clypsalot. Clypsalot is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation, either version 3 of the License,
+ * or (at your option) any later version. Clypsalot is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with Clypsalot. If not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+
+#include <vector>
+
+#include <clypsalot/resample.hxx>
+#include <clypsalot/util.hxx>
+
+#include "test/lib/benchmark.hxx"
+
+using namespace Clypsalot;
+
+static constexpr std::size_t totalChannels = 8;
+static constexpr std::size_t blockSize = 256;
+static constexpr std::size_t totalBlocks = 400;
+
+static void benchmarkResampler(const std::size_t inRate, const std::size_t outRate, const PcmResamplerQuality quality, const SimdLevel level)
+{
+    PcmResampler resampler(inRate, outRate, totalChannels, blockSize, quality, level);
+
+    // Levels the CPU does not have fall back to one it does which was already measured.
+    if (resampler.level() != level) return;
+
+    PcmBuffer input(PcmFormat::float32, totalChannels, blockSize);
+    PcmBuffer output(PcmFormat::float32, totalChannels, resampler.maxOutput(blockSize));
+    std::size_t produced = 0;
+
+    BenchmarkTimer timer;
+
+    for (std::size_t block = 0; block < totalBlocks; block++)
+    {
+        produced += resampler.process(input, blockSize, output);
+    }
+
+    const auto seconds = timer.seconds();
+
+    // The count is per channel so it can be compared with the output rate to see how many
+    // channels one core can resample in real time.
+    benchmarkResult(makeString(inRate, " -> ", outRate, " ", quality, " ", level), produced * totalChannels, "frames", seconds);
+}
+
+int main(int argc, char* argv[])
+{
+    initBenchmark(argc, argv);
+
+    const std::vector<std::pair<std::size_t, std::size_t>> rates = { { 44100, 48000 }, { 48000, 44100 }, { 96000, 48000 } };
+
+    for (const auto& [inRate, outRate] : rates)
+    {
+        for (const auto quality : { PcmResamplerQuality::fast, PcmResamplerQuality::balanced, PcmResamplerQuality::best })
+        {
+            for (const auto level : { SimdLevel::scalar, SimdLevel::sse2, SimdLevel::avx2 })
+            {
+                benchmarkResampler(inRate, outRate, quality, level);
+            }
+        }
+    }
+
+    return 0;
+}
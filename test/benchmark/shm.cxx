@@ -0,0 +1,143 @@
+/* Copyright 2023 Tyler Riddle
+ *
+ * This file is part of Clypsalot. Clypsalot is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation, either version 3 of the License,
+ * or (at your option) any later version. Clypsalot is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with Clypsalot. If not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <unistd.h>
+
+#include <clypsalot/io.hxx>
+#include <clypsalot/object.hxx>
+#include <clypsalot/port.hxx>
+#include <clypsalot/shm.hxx>
+#include <clypsalot/thread.hxx>
+#include <clypsalot/util.hxx>
+
+#include "test/lib/benchmark.hxx"
+#include "test/lib/loopback.hxx"
+
+using namespace Clypsalot;
+
+static constexpr std::size_t streamFrames = 64 * 1024 * 1024;
+
+static std::string deviceName(const std::string& in_name)
+{
+    return "clypsalot-benchmark-" + std::to_string(getpid()) + "-" + in_name;
+}
+
+// Move frames through a ring between two threads that sleep on the futexes when it is empty or full.
+static void benchmarkRing(const std::size_t in_period)
+{
+    ShmDevice device(deviceName("ring"), { PcmFormat::float32, 2, 48000, in_period, 4 });
+    ShmDevice other(device.name());
+    const auto frameSize = device.capture().frameSize();
+    const std::vector<std::byte> period(in_period * frameSize);
+    BenchmarkTimer timer;
+
+    std::thread writer([&]
+    {
+        auto& ring = other.capture();
+
+        for (std::size_t frames = 0; frames < streamFrames; frames += in_period)
+        {
+            ring.waitWritable(in_period, std::chrono::seconds(10));
+            ring.write(period.data(), in_period);
+        }
+    });
+
+    auto& ring = device.capture();
+    std::vector<std::byte> buffer(in_period * frameSize);
+
+    for (std::size_t frames = 0; frames < streamFrames; frames += in_period)
+    {
+        ring.waitReadable(in_period, std::chrono::seconds(10));
+        ring.read(buffer.data(), in_period);
+    }
+
+    writer.join();
+
+    const auto seconds = timer.seconds();
+
+    benchmarkResult(makeString("ring ", in_period, " frame periods"), streamFrames * frameSize / 1e9, "GB", seconds);
+}
+
+// Run a source linked to a sink against a loopback device in real time and report the round trip.
+static void benchmarkLoopback(const std::size_t in_period, const std::size_t in_seconds)
+{
+    LoopbackDevice loopback(deviceName("loopback"), { PcmFormat::float32, 2, 48000, in_period, 4 });
+    auto& device = loopback.device();
+    auto source = ShmSourceObject::make();
+    auto sink = ShmSinkObject::make();
+
+    {
+        std::scoped_lock lock(*source, *sink);
+
+        source->configure({ { "Device", device.name() } });
+        sink->configure({ { "Device", device.name() } });
+        linkPorts(source->output("output"), sink->input("input"));
+        startObject(source);
+        startObject(sink);
+    }
+
+    BenchmarkTimer timer;
+
+    loopback.start();
+    std::this_thread::sleep_for(std::chrono::seconds(in_seconds));
+    loopback.stop();
+
+    const auto seconds = timer.seconds();
+
+    while (true)
+    {
+        {
+            std::scoped_lock lock(*sink);
+            if (sink->state() == ObjectState::stopped) break;
+        }
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    const auto rate = static_cast<double>(device.config().rate);
+
+    // The loopback clocks a period at a time at the sample rate.
+    benchmarkResult(makeString("loopback ", in_period, " frame periods"), seconds * rate / in_period, "periods", seconds, {
+        { device.latency() / rate * 1000, "ms latency", 3 },
+        { device.maxLatency() / rate * 1000, "ms max", 3 },
+        { static_cast<double>(device.capture().xruns()), "overruns" },
+        { static_cast<double>(device.playback().xruns()), "underruns" },
+    });
+}
+
+int main(int argc, char* argv[])
+{
+    initBenchmark(argc, argv);
+    initThreadQueue(std::max(std::thread::hardware_concurrency(), 2U));
+    initIoService();
+
+    for (const auto period : { 64, 256, 1024 })
+    {
+        benchmarkRing(period);
+    }
+
+    for (const auto period : { 64, 128, 256 })
+    {
+        benchmarkLoopback(period, 3);
+    }
+
+    shutdownIoService();
+    shutdownThreadQueue();
+
+    return 0;
+}
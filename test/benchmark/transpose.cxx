@@ -0,0 +1,66 @@
+/* Copyright 2023 Tyler Riddle
+ *
+ * This file is part of Clypsalot. Clypsalot is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation, either version 3 of the License,
+ * or (at your option) any later version. Clypsalot is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with Clypsalot. If not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+
+
+
+#include <clypsalot/transpose.hxx>
+#include <clypsalot/util.hxx>
+
+#include "test/lib/benchmark.hxx"
+
+using namespace Clypsalot;
+
+static constexpr std::size_t totalChannels = 16;
+static constexpr std::size_t totalFrames = 64 * 1024;
+static constexpr std::size_t totalPasses = 20;
+
+static void benchmarkTranspose(const PcmLayout in_from, const PcmLayout in_to, const SimdLevel in_level)
+{
+    PcmTransposer transposer(PcmFormat::float32, in_from, in_to, in_level);
+
+    // Levels the CPU does not have fall back to one it does which was already measured.
+    if (transposer.level() != in_level) return;
+
+    PcmBuffer source(PcmFormat::float32, totalChannels, totalFrames, in_from);
+    PcmBuffer dest(PcmFormat::float32, totalChannels, totalFrames, in_to);
+
+    transposer.process(source, dest, totalFrames);
+
+    BenchmarkTimer timer;
+
+    for (std::size_t pass = 0; pass < totalPasses; pass++)
+    {
+        transposer.process(source, dest, totalFrames);
+    }
+
+    const auto seconds = timer.seconds();
+    const auto bytes = static_cast<double>(totalPasses * totalChannels * totalFrames * sizeof(float) * 2);
+    const auto name = makeString(in_from, " -> ", in_to, " ", in_level);
+
+    benchmarkResult(name, bytes / 1e9, "GB", seconds);
+}
+
+int main(int argc, char* argv[])
+{
+    initBenchmark(argc, argv);
+
+    for (const auto layout : { PcmLayout::grouped4, PcmLayout::grouped8 })
+    {
+        for (const auto level : { SimdLevel::scalar, SimdLevel::sse2, SimdLevel::avx2 })
+        {
+            benchmarkTranspose(PcmLayout::planar, layout, level);
+            benchmarkTranspose(layout, PcmLayout::planar, level);
+        }
+    }
+
+    return 0;
+}
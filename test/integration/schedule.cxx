@@ -0,0 +1,209 @@
+/* Copyright 2023 Tyler Riddle
+ *
+ * This file is part of Clypsalot. Clypsalot is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation, either version 3 of the License,
+ * or (at your option) any later version. Clypsalot is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with Clypsalot. If not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <cstdlib>
+#include <new>
+#include <thread>
+
+#include <clypsalot/object.hxx>
+#include <clypsalot/pcm.hxx>
+#include <clypsalot/port.hxx>
+#include <clypsalot/property.hxx>
+
+#include "test/lib/test.hxx"
+#include "test/module/object.hxx"
+#include "test/module/port.hxx"
+
+using namespace Clypsalot;
+
+static std::atomic_size_t allocations = 0;
+
+void* operator new(const std::size_t size)
+{
+    allocations++;
+
+    if (const auto pointer = std::malloc(size ? size : 1)) return pointer;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* pointer) noexcept
+{
+    std::free(pointer);
+}
+
+void operator delete(void* pointer, const std::size_t) noexcept
+{
+    std::free(pointer);
+}
+
+TEST_MAIN_FUNCTION
+
+static std::size_t processCount(ProcessingTestObject& object, const Property::Handle handle)
+{
+    std::scoped_lock lock(object);
+    return object.property(handle).sizeValue();
+}
+
+static void waitForProcessCount(ProcessingTestObject& object, const Property::Handle handle, const std::size_t count)
+{
+    BOOST_REQUIRE(waitUntil([&] { return processCount(object, handle) >= count; }));
+}
+
+// Counts the blocks it consumes and how many were consumed when the end of the data was handled.
+class DrainingSinkObject : public TestObject
+{
+    protected:
+    virtual void handleEndOfData() noexcept override
+    {
+        blocksAtEnd = blocks;
+        ended = true;
+        TestObject::handleEndOfData();
+    }
+
+    public:
+    PcmInputPort* input = nullptr;
+    std::size_t blocks = 0;
+    std::size_t blocksAtEnd = 0;
+    bool ended = false;
+
+    DrainingSinkObject(const std::string& in_kind) :
+        TestObject(in_kind)
+    {
+        std::scoped_lock lock(*this);
+
+        input = &publicAddInput<PcmInputPort>("input");
+    }
+
+    virtual ObjectProcessResult process() override
+    {
+        assert(haveLock());
+
+        input->consume();
+        blocks++;
+
+        return ObjectProcessResult::finished;
+    }
+};
+
+TEST_CASE(Schedule_end_of_data_after_delivered_blocks)
+{
+    const std::string kind = "Test::Draining Sink";
+    auto source = TestObject::make();
+    auto sink = _makeObject<DrainingSinkObject>(kind);
+
+    {
+        std::scoped_lock lock(*source, *sink);
+        auto& output = source->publicAddOutput<PcmOutputPort>("output");
+
+        output.config({ PcmFormat::float32, 1, 16, 4 });
+        source->configure();
+        sink->configure();
+        linkPorts(output, *sink->input);
+
+        for (std::size_t block = 0; block < 3; block++)
+        {
+            output.buffer();
+            output.commit(16);
+        }
+
+        // The sink only starts once the end of the data is already there so the blocks before it
+        // have to be processed first and nothing but the scheduler is left to run the sink again
+        // after the last one.
+        output.setEndOfData();
+        startObject(sink);
+    }
+
+    BOOST_REQUIRE(waitUntil(*sink, [&] { return sink->ended; }));
+
+    std::scoped_lock lock(*sink);
+
+    BOOST_CHECK(sink->blocks == 3);
+    BOOST_CHECK(sink->blocksAtEnd == 3);
+    BOOST_CHECK(sink->state() == ObjectState::stopped);
+}
+
+TEST_CASE(Schedule_steady_state_does_not_allocate)
+{
+    auto source = ProcessingTestObject::make();
+    auto sink = ProcessingTestObject::make();
+    Property::Handle counter;
+
+    {
+        std::scoped_lock lock(*source, *sink);
+
+        auto& output = source->publicAddOutput<PTestOutputPort>("output");
+        auto& input = sink->publicAddInput<PTestInputPort>("input");
+
+        source->configure();
+        sink->configure();
+        linkPorts(output, input);
+        counter = sink->propertyHandle("Process Counter");
+        startObject(source);
+        startObject(sink);
+    }
+
+    waitForProcessCount(*sink, counter, 1000);
+
+    const auto before = allocations.load();
+    const auto processed = processCount(*sink, counter);
+
+    waitForProcessCount(*sink, counter, processed + 10000);
+
+    const auto after = allocations.load();
+
+    {
+        std::scoped_lock lock(*source);
+        stopObject(source);
+    }
+
+    {
+        std::scoped_lock lock(*sink);
+        stopObject(sink);
+    }
+
+    BOOST_CHECK_EQUAL(after - before, 0);
+}
+
+TEST_CASE(Schedule_pcm_transfer_does_not_allocate)
+{
+    auto source = TestObject::make();
+    auto sink = TestObject::make();
+    std::scoped_lock lock(*source, *sink);
+    auto& output = source->publicAddOutput<PcmOutputPort>("output");
+    auto& input = sink->publicAddInput<PcmInputPort>("input");
+
+    output.config({ PcmFormat::float32, 8, 256 });
+    source->configure();
+    sink->configure();
+
+    const auto before = allocations.load();
+
+    linkPorts(output, input);
+
+    // Every block is created when the output is linked.
+    BOOST_CHECK(allocations.load() > before);
+
+    const auto linked = allocations.load();
+
+    for (std::size_t period = 0; period < 1000; period++)
+    {
+        output.buffer().channel<float>(0)[0] = period;
+        output.commit(256);
+        input.consume();
+    }
+
+    BOOST_CHECK_EQUAL(allocations.load() - linked, 0);
+    BOOST_CHECK(output.pool().highWater() == 1);
+}
@@ -0,0 +1,69 @@
+/* Copyright 2023 Tyler Riddle
+ *
+ * This file is part of Clypsalot. Clypsalot is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU Lesser General Public License as published by the Free Software Foundation, either version 3 of the License,
+ * or (at your option) any later version. Clypsalot is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along with Clypsalot. If not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+
+#include <iomanip>
+#include <iostream>
+
+#include <clypsalot/logger.hxx>
+#include <clypsalot/module.hxx>
+
+#include "test/lib/benchmark.hxx"
+#include "test/module/module.hxx"
+
+namespace Clypsalot
+{
+    BenchmarkTimer::BenchmarkTimer() :
+        m_start(Clock::now())
+    { }
+
+    void BenchmarkTimer::restart() noexcept
+    {
+        m_start = Clock::now();
+    }
+
+    double BenchmarkTimer::seconds() const noexcept
+    {
+        return std::chrono::duration<double>(Clock::now() - m_start).count();
+    }
+
+    void initBenchmark(int argc, char* argv[])
+    {
+        auto& consoleDestination = logEngine().makeDestination<ConsoleDestination>(LogSeverity::info);
+
+        if (argc == 2)
+        {
+            consoleDestination.severity(logSeverity(argv[1]));
+        }
+
+        importModule(builtinModuleDescriptor());
+        importModule(testModuleDescriptor());
+    }
+
+    /**
+     * @brief Print a line of results.
+     *
+     * Every benchmark prints with this so the output lines up. The rate is the count per second
+     * and is followed by the columns and then the time it took.
+     */
+    void benchmarkResult(const std::string& name, const double count, const std::string& unit, const double seconds, const std::vector<BenchmarkColumn>& columns)
+    {
+        std::cout << std::left << std::setw(40) << name << std::right << std::fixed << std::setprecision(2)
+            << std::setw(16) << count / seconds << " " << unit << "/s";
+
+        for (const auto& column : columns)
+        {
+            std::cout << std::setprecision(column.precision) << std::setw(12) << column.value << " " << column.unit;
+        }
+
+        std::cout << std::setprecision(6) << std::setw(14) << seconds << " s" << std::endl;
+    }
+}
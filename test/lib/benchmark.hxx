@@ -0,0 +1,44 @@
+/* Copyright 2023 Tyler Riddle
+ *
+ * This file is part of Clypsalot. Clypsalot is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU Lesser General Public License as published by the Free Software Foundation, either version 3 of the License,
+ * or (at your option) any later version. Clypsalot is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along with Clypsalot. If not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+namespace Clypsalot
+{
+    /// @brief Measures the wall clock time of a benchmark.
+    class BenchmarkTimer
+    {
+        using Clock = std::chrono::steady_clock;
+
+        Clock::time_point m_start;
+
+        public:
+        BenchmarkTimer();
+        void restart() noexcept;
+        double seconds() const noexcept;
+    };
+
+    /// @brief A value printed after the rate of a benchmark result such as a latency or a count.
+    struct BenchmarkColumn
+    {
+        double value = 0;
+        std::string unit;
+        int precision = 0;
+    };
+
+    void initBenchmark(int argc, char* argv[]);
+    void benchmarkResult(const std::string& name, const double count, const std::string& unit, const double seconds, const std::vector<BenchmarkColumn>& columns = {});
+}
@@ -0,0 +1,152 @@
+/* Copyright 2023 Tyler Riddle
+ *
+ * This file is part of Clypsalot. Clypsalot is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation, either version 3 of the License,
+ * or (at your option) any later version. Clypsalot is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with Clypsalot. If not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+
+#include <chrono>
+#include <cstring>
+#include <limits>
+#include <vector>
+
+#include <clypsalot/error.hxx>
+#include <clypsalot/macros.hxx>
+#include <clypsalot/util.hxx>
+
+#include "test/lib/loopback.hxx"
+
+namespace Clypsalot
+{
+    static void writeImpulse(std::byte* out_sample, const PcmFormat in_format) noexcept
+    {
+        switch (in_format)
+        {
+            case PcmFormat::int16:
+            {
+                const auto value = std::numeric_limits<std::int16_t>::max();
+                std::memcpy(out_sample, &value, sizeof(value));
+                return;
+            }
+            case PcmFormat::int24:
+            {
+                const std::int32_t value = 0x7fffff;
+                std::memcpy(out_sample, &value, sizeof(value));
+                return;
+            }
+            case PcmFormat::int32:
+            {
+                const auto value = std::numeric_limits<std::int32_t>::max();
+                std::memcpy(out_sample, &value, sizeof(value));
+                return;
+            }
+            case PcmFormat::float32:
+            {
+                const float value = 1;
+                std::memcpy(out_sample, &value, sizeof(value));
+                return;
+            }
+            case PcmFormat::float64:
+            {
+                const double value = 1;
+                std::memcpy(out_sample, &value, sizeof(value));
+                return;
+            }
+        }
+
+        FATAL_ERROR(makeString("Unhandled PcmFormat value: ", in_format));
+    }
+
+    static bool isSilent(const std::byte* in_sample, const std::size_t in_size) noexcept
+    {
+        for (std::size_t i = 0; i < in_size; i++)
+        {
+            if (in_sample[i] != std::byte(0)) return false;
+        }
+
+        return true;
+    }
+
+    LoopbackDevice::LoopbackDevice(const std::string& in_name, const ShmDeviceConfig& in_config) :
+        m_device(in_name, in_config)
+    { }
+
+    LoopbackDevice::~LoopbackDevice() noexcept
+    {
+        stop();
+    }
+
+    ShmDevice& LoopbackDevice::device() noexcept
+    {
+        return m_device;
+    }
+
+    /// @throws RuntimeError if the clock is already running.
+    void LoopbackDevice::start()
+    {
+        if (m_running.exchange(true)) throw RuntimeError("The loopback device is already running");
+
+        m_thread = std::thread([this] { run(); });
+    }
+
+    /// @brief Stop the clock and close the device which ends the streams of the objects using it.
+    void LoopbackDevice::stop() noexcept
+    {
+        m_running = false;
+
+        if (m_thread.joinable()) m_thread.join();
+
+        m_device.close();
+    }
+
+    /*
+     * The impulses are on every multiple of the rate so the latency of an impulse read back is
+     * its position in the stream modulo the rate as long as the round trip is less than a second.
+     * Playback is read before the period is captured like a device that has to play a period
+     * before it can capture the next one which makes the shortest round trip one period.
+     */
+    void LoopbackDevice::run() noexcept
+    {
+        using Clock = std::chrono::steady_clock;
+
+        const auto& config = m_device.config();
+        const auto sampleSize = pcmSampleSize(config.format);
+        auto& capture = m_device.capture();
+        auto& playback = m_device.playback();
+        std::vector<std::byte> period(config.period * capture.frameSize());
+        const auto begin = Clock::now();
+        std::uint64_t frame = 0;
+        bool playing = false;
+
+        while (m_running)
+        {
+            const auto played = playback.read(period.data(), config.period);
+
+            if (played == config.period) playing = true;
+            else if (playing) playback.countXrun();
+
+            for (std::size_t i = 0; i < played; i++)
+            {
+                if (! isSilent(period.data() + i * playback.frameSize(), sampleSize)) m_device.reportLatency((frame + i) % config.rate);
+            }
+
+            std::fill(period.begin(), period.end(), std::byte(0));
+
+            for (std::size_t i = 0; i < config.period; i++)
+            {
+                if ((frame + i) % config.rate == 0) writeImpulse(period.data() + i * capture.frameSize(), config.format);
+            }
+
+            if (capture.writable() < config.period) capture.countXrun();
+            else capture.write(period.data(), config.period);
+
+            frame += config.period;
+            std::this_thread::sleep_until(begin + std::chrono::nanoseconds(frame * 1000000000 / config.rate));
+        }
+    }
+}
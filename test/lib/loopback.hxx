@@ -0,0 +1,49 @@
+/* Copyright 2023 Tyler Riddle
+ *
+ * This file is part of Clypsalot. Clypsalot is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation, either version 3 of the License,
+ * or (at your option) any later version. Clypsalot is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with Clypsalot. If not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <thread>
+
+#include <clypsalot/shm.hxx>
+
+namespace Clypsalot
+{
+    /**
+     * @brief Stands in for an audio server by clocking a ShmDevice at its sample rate and playing
+     * what it captured back to itself.
+     *
+     * Every period the clock writes a period of silence with an impulse on the first channel once
+     * a second to the capture ring and reads a period from the playback ring. When the impulse
+     * comes back out of the playback ring the distance is reported as the latency of the device.
+     * A capture ring with out room for a period counts an overrun and a playback ring with out a
+     * whole period counts an underrun once playback has started.
+     */
+    class LoopbackDevice
+    {
+        ShmDevice m_device;
+        std::atomic_bool m_running = false;
+        std::thread m_thread;
+
+        void run() noexcept;
+
+        public:
+        LoopbackDevice(const std::string& in_name, const ShmDeviceConfig& in_config = ShmDeviceConfig());
+        ~LoopbackDevice() noexcept;
+        ShmDevice& device() noexcept;
+        void start();
+        void stop() noexcept;
+    };
+}
@@ -13,6 +13,7 @@
 #include <boost/test/unit_test.hpp>
 
 #include <clypsalot/error.hxx>
+#include <clypsalot/io.hxx>
 #include <clypsalot/logger.hxx>
 #include <clypsalot/macros.hxx>
 #include <clypsalot/module.hxx>
@@ -29,10 +30,12 @@ namespace Clypsalot
         GlobalFixture()
         {
             initThreadQueue(0);
+            initIoService();
         }
 
         ~GlobalFixture()
         {
+            shutdownIoService();
             shutdownThreadQueue();
         }
     };
@@ -82,6 +85,7 @@ namespace Clypsalot
             consoleDestination.severity(logSeverity(argv[1]));
         }
 
+        importModule(builtinModuleDescriptor());
         importModule(testModuleDescriptor());
 
         BOOST_TEST_GLOBAL_FIXTURE(GlobalFixture);
@@ -13,6 +13,9 @@
 #pragma once
 
 #include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
 
 #include <clypsalot/catalog.hxx>
 #include <clypsalot/network.hxx>
@@ -42,9 +45,38 @@ namespace Clypsalot
         ~TestCaseFixture();
     };
 
+    /// @brief How long waitUntil() polls before giving up.
+    constexpr std::chrono::seconds waitTimeout { 10 };
+
     int runTests(int argc, char* argv[]);
     bool initBoostUnitTest();
 
+    /**
+     * @brief Poll a condition every millisecond until it holds.
+     * @return false if the timeout passed first so the test fails instead of hanging.
+     */
+    template <typename T>
+    bool waitUntil(const T& in_condition, const std::chrono::milliseconds in_timeout = waitTimeout)
+    {
+        const auto deadline = std::chrono::steady_clock::now() + in_timeout;
+
+        while (! in_condition())
+        {
+            if (std::chrono::steady_clock::now() >= deadline) return false;
+
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+
+        return true;
+    }
+
+    /// @brief Poll a condition with the Object locked while it is checked.
+    template <typename T>
+    bool waitUntil(Object& in_object, const T& in_condition, const std::chrono::milliseconds in_timeout = waitTimeout)
+    {
+        return waitUntil([&] { std::scoped_lock lock(in_object); return in_condition(); }, in_timeout);
+    }
+
     template <std::derived_from<Object> T>
     std::shared_ptr<T> makeTestObject(const std::string& kind)
     {
@@ -46,6 +46,20 @@ namespace Clypsalot
         addProperties(list);
     }
 
+    void TestObject::publicEnableAutomation(const size_t capacity)
+    {
+        assert(m_mutex.haveLock());
+
+        enableAutomation(capacity);
+    }
+
+    Automation& TestObject::publicAutomation()
+    {
+        assert(m_mutex.haveLock());
+
+        return automation();
+    }
+
     ObjectProcessResult TestObject::process()
     {
 
@@ -24,6 +24,8 @@ namespace Clypsalot
         static std::shared_ptr<TestObject> make();
         TestObject(const std::string& kind);
         void publicAddProperties(const PropertyList& list);
+        void publicEnableAutomation(const size_t capacity);
+        Automation& publicAutomation();
 
         template <std::derived_from<OutputPort> T, typename... Args>
         T& publicAddOutput(Args... args)
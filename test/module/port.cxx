@@ -163,15 +163,11 @@ namespace Clypsalot
 
     bool PTestPortLink::dirty() const noexcept
     {
-        std::scoped_lock lock(m_mutex);
-
-        return m_dirtyFlag;
+        return m_dirtyFlag.load(std::memory_order_acquire);
     }
 
     void PTestPortLink::dirty(const bool isDirty) noexcept
     {
-        std::scoped_lock lock(m_mutex);
-
-        m_dirtyFlag = isDirty;
+        m_dirtyFlag.store(isDirty, std::memory_order_release);
     }
 }
@@ -12,6 +12,8 @@
 
 #pragma once
 
+#include <atomic>
+
 #include <clypsalot/port.hxx>
 
 namespace Clypsalot
@@ -78,7 +80,7 @@ namespace Clypsalot
 
     class PTestPortLink : public PortLink
     {
-        bool m_dirtyFlag = false;
+        std::atomic_bool m_dirtyFlag = false;
 
         public:
         PTestPortLink(PTestOutputPort& from, PTestInputPort& to);
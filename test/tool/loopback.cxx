@@ -0,0 +1,73 @@
+/* Copyright 2023 Tyler Riddle
+ *
+ * This file is part of Clypsalot. Clypsalot is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation, either version 3 of the License,
+ * or (at your option) any later version. Clypsalot is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with Clypsalot. If not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Create a shared memory device and clock it like an audio server would so the engine can be run
+ * against it with out any audio hardware. What the engine plays is looped back to what it
+ * captures and the round trip is measured with an impulse once a second.
+ *
+ * loopback <name> [rate] [channels] [period] [seconds]
+ */
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <thread>
+
+#include <clypsalot/error.hxx>
+
+#include "test/lib/loopback.hxx"
+
+using namespace Clypsalot;
+
+int main(int argc, char* argv[])
+{
+    if (argc < 2 || argc > 6)
+    {
+        std::cerr << "Usage: " << argv[0] << " <name> [rate] [channels] [period] [seconds]" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    ShmDeviceConfig config;
+    std::size_t seconds = 10;
+
+    try
+    {
+        if (argc > 2) config.rate = std::stoul(argv[2]);
+        if (argc > 3) config.channels = std::stoul(argv[3]);
+        if (argc > 4) config.period = std::stoul(argv[4]);
+        if (argc > 5) seconds = std::stoul(argv[5]);
+
+        LoopbackDevice loopback(argv[1], config);
+        auto& device = loopback.device();
+
+        std::cout << "Device " << device.name() << ": " << config.rate << " Hz, " << config.channels << " channels, "
+            << config.period << " frame periods" << std::endl;
+
+        loopback.start();
+
+        for (std::size_t second = 0; second < seconds; second++)
+        {
+            std::this_thread::sleep_for(std::chrono::seconds(1));
+            std::cout << "Latency " << device.latency() << " frames, max " << device.maxLatency() << " frames, "
+                << device.capture().xruns() << " overruns, " << device.playback().xruns() << " underruns" << std::endl;
+        }
+    }
+    catch (const std::exception& error)
+    {
+        std::cerr << error.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
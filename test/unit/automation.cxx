@@ -0,0 +1,265 @@
+/* Copyright 2023 Tyler Riddle
+ *
+ * This file is part of Clypsalot. Clypsalot is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation, either version 3 of the License,
+ * or (at your option) any later version. Clypsalot is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with Clypsalot. If not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+
+#include <cmath>
+#include <thread>
+#include <vector>
+
+#include <clypsalot/automation.hxx>
+#include <clypsalot/error.hxx>
+#include <clypsalot/queue.hxx>
+
+#include "test/lib/test.hxx"
+#include "test/module/object.hxx"
+
+using namespace Clypsalot;
+
+TEST_MAIN_FUNCTION
+
+static const PropertyList automationProperties = {
+    { "Gain", PropertyType::real, Property::Automatable, 1.0 },
+    { "Name", PropertyType::string, Property::NoFlags, "test" },
+    { "Steps", PropertyType::integer, Property::Automatable, 0 },
+};
+
+static std::shared_ptr<TestObject> makeAutomatedObject(const size_t capacity = 16)
+{
+    auto object = TestObject::make();
+    std::unique_lock lock(*object);
+
+    object->publicAddProperties(automationProperties);
+    object->publicEnableAutomation(capacity);
+    object->configure();
+
+    return object;
+}
+
+static bool near(const double lhs, const double rhs)
+{
+    return std::fabs(lhs - rhs) < 1e-9;
+}
+
+TEST_CASE(BoundedQueue_push_pop)
+{
+    BoundedQueue<int> queue(3);
+    int value = 0;
+
+    BOOST_CHECK(queue.capacity() == 4);
+    BOOST_CHECK(! queue.pop(value));
+
+    for (int i = 0; i < 4; i++)
+    {
+        BOOST_CHECK(queue.push(i));
+    }
+
+    BOOST_CHECK(! queue.push(4));
+    BOOST_CHECK(queue.size() == 4);
+
+    for (int i = 0; i < 4; i++)
+    {
+        BOOST_CHECK(queue.pop(value));
+        BOOST_CHECK(value == i);
+    }
+
+    BOOST_CHECK(! queue.pop(value));
+    BOOST_CHECK(queue.size() == 0);
+}
+
+TEST_CASE(BoundedQueue_threads)
+{
+    static constexpr size_t producers = 4;
+    static constexpr size_t valuesPerProducer = 10000;
+    BoundedQueue<size_t> queue(64);
+    std::vector<std::thread> threads;
+    size_t received = 0;
+    size_t sum = 0;
+
+    for (size_t i = 0; i < producers; i++)
+    {
+        threads.emplace_back([&queue]
+        {
+            for (size_t value = 1; value <= valuesPerProducer; value++)
+            {
+                while (! queue.push(value)) std::this_thread::yield();
+            }
+        });
+    }
+
+    while (received < producers * valuesPerProducer)
+    {
+        size_t value;
+
+        if (queue.pop(value))
+        {
+            sum += value;
+            received++;
+        }
+    }
+
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+
+    BOOST_CHECK(sum == producers * valuesPerProducer * (valuesPerProducer + 1) / 2);
+}
+
+TEST_CASE(Automation_interpolate)
+{
+    BOOST_CHECK(near(interpolateLinear(0, 10, 0.5), 5));
+    BOOST_CHECK(near(interpolateExponential(1, 100, 0.5), 10));
+    BOOST_CHECK(near(interpolateExponential(0, 10, 0.5), 5));
+    BOOST_CHECK(near(interpolateExponential(-1, 1, 0.25), -0.5));
+}
+
+TEST_CASE(Property_automatable_type)
+{
+    auto object = TestObject::make();
+    std::unique_lock lock(*object);
+
+    BOOST_CHECK_THROW(object->publicAddProperties({{ "File", PropertyType::file, Property::Automatable, nullptr }}), TypeError);
+    object->stop();
+}
+
+TEST_CASE(Object_automate)
+{
+    auto object = TestObject::make();
+
+    BOOST_CHECK_THROW(object->automate({}), RuntimeError);
+
+    object = makeAutomatedObject();
+    std::unique_lock lock(*object);
+    const auto gain = object->propertyHandle("Gain");
+    const auto name = object->propertyHandle("Name");
+
+    BOOST_CHECK(&object->property(gain) == &object->property("Gain"));
+    BOOST_CHECK_THROW(object->propertyHandle("Missing"), KeyError);
+    BOOST_CHECK_THROW(object->automate({ 0, name, 1, AutomationCurve::step, 0 }), KeyError);
+    BOOST_CHECK(object->automate({ 0, gain, 2, AutomationCurve::step, 0 }));
+
+    object->stop();
+}
+
+TEST_CASE(Automation_step)
+{
+    auto object = makeAutomatedObject();
+    std::unique_lock lock(*object);
+    auto& automation = object->publicAutomation();
+    const auto steps = object->propertyHandle("Steps");
+
+    BOOST_CHECK(object->automate({ 10, steps, 3, AutomationCurve::step, 0 }));
+    BOOST_CHECK(object->automate({ 5, steps, 2, AutomationCurve::step, 0 }));
+
+    automation.beginPeriod(16);
+    BOOST_CHECK(automation.apply(0) == 5);
+    BOOST_CHECK(automation.lane(steps).value(0) == 0);
+    BOOST_CHECK(automation.apply(5) == 10);
+    BOOST_CHECK(automation.lane(steps).value(5) == 2);
+    BOOST_CHECK(automation.apply(10) == 16);
+    BOOST_CHECK(automation.lane(steps).value(10) == 3);
+    automation.endPeriod();
+
+    BOOST_CHECK(object->property("Steps").integerValue() == 3);
+
+    object->stop();
+}
+
+TEST_CASE(Automation_carry_over)
+{
+    auto object = makeAutomatedObject();
+    std::unique_lock lock(*object);
+    auto& automation = object->publicAutomation();
+    const auto gain = object->propertyHandle("Gain");
+
+    BOOST_CHECK(object->automate({ 20, gain, 4, AutomationCurve::step, 0 }));
+
+    automation.beginPeriod(16);
+    BOOST_CHECK(automation.apply(0) == 16);
+    automation.endPeriod();
+    BOOST_CHECK(object->property("Gain").realValue() == 1);
+
+    automation.beginPeriod(16);
+    BOOST_CHECK(automation.apply(0) == 4);
+    BOOST_CHECK(automation.apply(4) == 16);
+    BOOST_CHECK(automation.lane(gain).value(4) == 4);
+    automation.endPeriod();
+    BOOST_CHECK(object->property("Gain").realValue() == 4);
+
+    object->stop();
+}
+
+TEST_CASE(Automation_linear_ramp)
+{
+    auto object = makeAutomatedObject();
+    std::unique_lock lock(*object);
+    auto& automation = object->publicAutomation();
+    const auto gain = object->propertyHandle("Gain");
+    std::vector<float> values(8);
+
+    // Ramp from 1 to 3 over 16 frames which spans two periods
+    BOOST_CHECK(object->automate({ 0, gain, 3, AutomationCurve::linear, 16 }));
+
+    automation.beginPeriod(8);
+    automation.apply(0);
+    BOOST_CHECK(automation.lane(gain).ramping());
+    BOOST_CHECK(near(automation.lane(gain).value(4), 1.5));
+    automation.lane(gain).render(values.data(), 0, 8);
+    BOOST_CHECK(near(values[0], 1));
+    BOOST_CHECK(near(values[4], 1.5));
+    automation.endPeriod();
+    BOOST_CHECK(near(object->property("Gain").realValue(), 2));
+
+    automation.beginPeriod(8);
+    automation.apply(0);
+    BOOST_CHECK(near(automation.lane(gain).value(4), 2.5));
+    automation.endPeriod();
+    BOOST_CHECK(! automation.lane(gain).ramping());
+    BOOST_CHECK(near(object->property("Gain").realValue(), 3));
+
+    object->stop();
+}
+
+TEST_CASE(Automation_exponential_ramp)
+{
+    auto object = makeAutomatedObject();
+    std::unique_lock lock(*object);
+    auto& automation = object->publicAutomation();
+    const auto gain = object->propertyHandle("Gain");
+    std::vector<float> values(16);
+
+    BOOST_CHECK(object->automate({ 0, gain, 100, AutomationCurve::exponential, 8 }));
+
+    automation.beginPeriod(16);
+    automation.apply(0);
+    BOOST_CHECK(near(automation.lane(gain).value(4), 10));
+    automation.lane(gain).render(values.data(), 0, 16);
+    BOOST_CHECK(std::fabs(values[4] - 10) < 1e-4);
+    BOOST_CHECK(values[8] == 100);
+    BOOST_CHECK(values[15] == 100);
+    automation.endPeriod();
+    BOOST_CHECK(near(object->property("Gain").realValue(), 100));
+
+    object->stop();
+}
+
+TEST_CASE(Automation_queue_full)
+{
+    auto object = makeAutomatedObject(2);
+    std::unique_lock lock(*object);
+    const auto gain = object->propertyHandle("Gain");
+
+    BOOST_CHECK(object->automate({ 0, gain, 1, AutomationCurve::step, 0 }));
+    BOOST_CHECK(object->automate({ 0, gain, 2, AutomationCurve::step, 0 }));
+    BOOST_CHECK(! object->automate({ 0, gain, 3, AutomationCurve::step, 0 }));
+
+    object->stop();
+}
@@ -0,0 +1,367 @@
+/* Copyright 2023 Tyler Riddle
+ *
+ * This file is part of Clypsalot. Clypsalot is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation, either version 3 of the License,
+ * or (at your option) any later version. Clypsalot is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with Clypsalot. If not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+
+#include <chrono>
+#include <cmath>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include <clypsalot/biquad.hxx>
+#include <clypsalot/catalog.hxx>
+#include <clypsalot/equalizer.hxx>
+#include <clypsalot/error.hxx>
+#include <clypsalot/pcm.hxx>
+#include <clypsalot/property.hxx>
+
+#include "test/lib/test.hxx"
+#include "test/module/object.hxx"
+
+using namespace Clypsalot;
+
+TEST_MAIN_FUNCTION
+
+// 301 frames leaves a tail for every vector width.
+static constexpr std::size_t frames = 301;
+static constexpr double rate = 48000;
+
+static std::vector<BiquadCoefficients> testBands()
+{
+    return {
+        designBiquad(BiquadType::highPass, rate, 40, 0, 0.707),
+        designBiquad(BiquadType::lowShelf, rate, 200, 4, 0.707),
+        designBiquad(BiquadType::peak, rate, 1000, -6, 2),
+        designBiquad(BiquadType::notch, rate, 3000, 0, 4),
+        designBiquad(BiquadType::highShelf, rate, 8000, -3, 0.707),
+        designBiquad(BiquadType::lowPass, rate, 16000, 0, 0.707),
+    };
+}
+
+static float& sample(PcmBuffer& in_buffer, const std::size_t in_channel, const std::size_t in_frame)
+{
+    if (in_buffer.layout() == PcmLayout::planar) return in_buffer.channel<float>(in_channel)[in_frame];
+
+    const auto lanes = in_buffer.lanes();
+
+    return in_buffer.group<float>(in_channel / lanes)[in_frame * lanes + in_channel % lanes];
+}
+
+static void fillNoise(PcmBuffer& out_buffer, const std::size_t in_channels, const unsigned in_seed)
+{
+    std::mt19937 generator(in_seed);
+    std::uniform_real_distribution<float> distribution(-1, 1);
+
+    for (std::size_t frame = 0; frame < frames; frame++)
+    {
+        for (std::size_t channel = 0; channel < in_channels; channel++) sample(out_buffer, channel, frame) = distribution(generator);
+    }
+}
+
+// Transposed direct form II in double precision with the coefficients optionally rounded to the
+// floats the kernels use.
+static std::vector<double> reference(const std::vector<BiquadCoefficients>& in_bands, const std::vector<double>& in_input, const bool in_round)
+{
+    auto output = in_input;
+
+    for (auto band : in_bands)
+    {
+        if (in_round)
+        {
+            for (auto coefficient : { &band.b0, &band.b1, &band.b2, &band.a1, &band.a2 }) *coefficient = static_cast<float>(*coefficient);
+        }
+
+        double s1 = 0;
+        double s2 = 0;
+
+        for (auto& sample : output)
+        {
+            const auto x = sample;
+            const auto y = band.b0 * x + s1;
+
+            s1 = band.b1 * x + s2 - band.a1 * y;
+            s2 = band.b2 * x - band.a2 * y;
+            sample = y;
+        }
+    }
+
+    return output;
+}
+
+TEST_CASE(Biquad_design)
+{
+    const auto peak = designBiquad(BiquadType::peak, rate, 1000, 6, 1);
+    const auto lowPass = designBiquad(BiquadType::lowPass, rate, 1000, 0, std::sqrt(0.5));
+    const auto highPass = designBiquad(BiquadType::highPass, rate, 1000, 0, std::sqrt(0.5));
+    const auto lowShelf = designBiquad(BiquadType::lowShelf, rate, 1000, 6, std::sqrt(0.5));
+    const auto highShelf = designBiquad(BiquadType::highShelf, rate, 1000, -6, std::sqrt(0.5));
+    const auto notch = designBiquad(BiquadType::notch, rate, 1000, 0, 1);
+    const auto decibels = [](const BiquadCoefficients& coefficients, const double frequency) {
+        return 20 * std::log10(biquadMagnitude(coefficients, rate, frequency));
+    };
+
+    BOOST_CHECK(std::abs(decibels(peak, 1000) - 6) < 1e-6);
+    BOOST_CHECK(std::abs(decibels(peak, 20000)) < 0.1);
+    BOOST_CHECK(std::abs(decibels(lowPass, 1000) + 3.0103) < 1e-3);
+    BOOST_CHECK(std::abs(decibels(lowPass, 10)) < 1e-3);
+    BOOST_CHECK(std::abs(decibels(highPass, 1000) + 3.0103) < 1e-3);
+    BOOST_CHECK(decibels(highPass, 10) < -60);
+    BOOST_CHECK(std::abs(decibels(lowShelf, 10) - 6) < 0.01);
+    BOOST_CHECK(std::abs(decibels(lowShelf, 20000)) < 0.01);
+    BOOST_CHECK(std::abs(decibels(highShelf, 20000) + 6) < 0.01);
+    BOOST_CHECK(biquadMagnitude(notch, rate, 1000) < 1e-9);
+    BOOST_CHECK(designBiquad(BiquadType::peak, rate, 1000, 0, 1).identity());
+    BOOST_CHECK(designBiquad(BiquadType::lowShelf, rate, 1000, 0, 1).identity());
+    BOOST_CHECK(! lowPass.identity());
+    BOOST_CHECK(stringToBiquadType("highShelf") == BiquadType::highShelf);
+    BOOST_CHECK_THROW(stringToBiquadType("bandPass"), ValueError);
+    BOOST_CHECK_THROW(designBiquad(BiquadType::peak, rate, 24000, 6, 1), ValueError);
+    BOOST_CHECK_THROW(designBiquad(BiquadType::peak, rate, 1000, 6, 0), ValueError);
+    BOOST_CHECK_THROW(designBiquad(BiquadType::peak, 0, 1000, 6, 1), ValueError);
+    BOOST_CHECK_THROW(BiquadCascade(0, 1), ValueError);
+}
+
+// Channel counts that leave whole groups, pairs of groups and single groups for every level.
+TEST_CASE(BiquadCascade_reference)
+{
+    const auto bands = testBands();
+
+    for (const auto channels : { 1, 3, 8, 13, 24, 40 })
+    {
+        for (const auto level : { SimdLevel::scalar, SimdLevel::sse2, SimdLevel::avx2, SimdLevel::avx512 })
+        {
+            BiquadCascade cascade(channels, bands.size(), level);
+            PcmBuffer input(PcmFormat::float32, channels, frames, cascade.layout());
+            PcmBuffer output(PcmFormat::float32, channels, frames, cascade.layout());
+            double error = 0;
+            double designError = 0;
+
+            for (std::size_t band = 0; band < bands.size(); band++) cascade.coefficients(band, bands[band]);
+
+            fillNoise(input, channels, channels);
+            cascade.process(input, output, frames);
+
+            for (std::size_t channel = 0; channel < static_cast<std::size_t>(channels); channel++)
+            {
+                std::vector<double> samples(frames);
+
+                for (std::size_t frame = 0; frame < frames; frame++) samples[frame] = sample(input, channel, frame);
+
+                const auto expected = reference(bands, samples, true);
+                const auto designed = reference(bands, samples, false);
+
+                for (std::size_t frame = 0; frame < frames; frame++)
+                {
+                    error = std::max(error, std::abs(sample(output, channel, frame) - expected[frame]));
+                    designError = std::max(designError, std::abs(sample(output, channel, frame) - designed[frame]));
+                }
+            }
+
+            // The float state of the 40 Hz high pass is where most of the error comes from.
+            BOOST_CHECK_MESSAGE(error < 5e-4, "channels=" << channels << " level=" << level << " error=" << error);
+            BOOST_CHECK_MESSAGE(designError < 1e-3, "channels=" << channels << " level=" << level << " error=" << designError);
+        }
+    }
+}
+
+// The kernels do the same operations in the same order at every level.
+TEST_CASE(BiquadCascade_levels_match)
+{
+    constexpr std::size_t channels = 21;
+    const auto bands = testBands();
+    std::vector<std::vector<float>> results;
+
+    for (const auto level : { SimdLevel::scalar, SimdLevel::sse2, SimdLevel::avx2, SimdLevel::avx512 })
+    {
+        BiquadCascade cascade(channels, bands.size(), level);
+        PcmBuffer buffer(PcmFormat::float32, channels, frames, cascade.layout());
+        std::vector<float> result;
+
+        for (std::size_t band = 0; band < bands.size(); band++) cascade.coefficients(band, bands[band]);
+
+        // Two blocks in place so the state carries over.
+        for (std::size_t block = 0; block < 2; block++)
+        {
+            fillNoise(buffer, channels, block);
+            cascade.process(buffer, buffer, frames);
+
+            for (std::size_t channel = 0; channel < channels; channel++)
+            {
+                for (std::size_t frame = 0; frame < frames; frame++) result.push_back(sample(buffer, channel, frame));
+            }
+        }
+
+        results.push_back(result);
+    }
+
+    for (const auto& result : results) BOOST_CHECK(result == results.front());
+}
+
+TEST_CASE(BiquadCascade_identity)
+{
+    BiquadCascade cascade(5, 3);
+    PcmBuffer input(PcmFormat::float32, 5, frames, cascade.layout());
+    PcmBuffer output(PcmFormat::float32, 5, frames, cascade.layout());
+
+    fillNoise(input, 5, 1);
+    cascade.process(input, output, frames);
+
+    for (std::size_t frame = 0; frame < frames; frame++) BOOST_CHECK(sample(output, 4, frame) == sample(input, 4, frame));
+
+    // Reset clears the state.
+    cascade.coefficients(1, designBiquad(BiquadType::lowPass, rate, 100, 0, 1));
+    cascade.process(input, output, frames);
+
+    const auto first = sample(output, 2, frames - 1);
+
+    cascade.reset();
+    cascade.process(input, output, frames);
+    BOOST_CHECK(sample(output, 2, frames - 1) == first);
+    BOOST_CHECK(cascade.coefficients(0).identity());
+}
+
+TEST_CASE(EqualizerObject_configure)
+{
+    auto equalizer = objectCatalog().make(EqualizerObject::kindName);
+    std::scoped_lock lock(*equalizer);
+    const auto cascade = [&] () -> const BiquadCascade& { return static_cast<EqualizerObject&>(*equalizer).cascade(); };
+
+    equalizer->configure({
+        { "Channels", 6 },
+        { "Bands", 2 },
+        { "Band 1 Type", "lowShelf" },
+        { "Band 1 Frequency", 100 },
+        { "Band 1 Gain", 6 },
+    });
+
+    BOOST_CHECK(cascade().bands() == 2);
+    BOOST_CHECK(cascade().channels() == 6);
+    BOOST_CHECK(cascade().coefficients(0) == designBiquad(BiquadType::lowShelf, rate, 100, 6, 0.707f));
+    BOOST_CHECK(cascade().coefficients(1).identity());
+    BOOST_CHECK(equalizer->property("Band 2 Type").stringValue() == "peak");
+    BOOST_CHECK(equalizer->property("Band 2 Frequency").realValue() == 10000);
+}
+
+TEST_CASE(EqualizerObject_typed_configure)
+{
+    auto prototype = objectCatalog().make(EqualizerObject::kindName);
+    auto equalizer = objectCatalog().make(EqualizerObject::kindName);
+    std::scoped_lock lock(*prototype, *equalizer);
+    const auto cascade = [&] () -> const BiquadCascade& { return static_cast<EqualizerObject&>(*equalizer).cascade(); };
+
+    prototype->init({{ "Bands", 8 }});
+    equalizer->init({{ "Bands", 8 }});
+
+    const auto values = prototype->compileConfig({
+        { "Channels", 2 },
+        { "Band 5 Gain", 3 },
+    });
+
+    equalizer->configure(values);
+
+    BOOST_CHECK(equalizer->state() == ObjectState::paused);
+    BOOST_CHECK(equalizer->property("Bands").sizeValue() == 8);
+    BOOST_CHECK(equalizer->property("Band 5 Gain").realValue() == 3);
+    BOOST_CHECK(cascade().bands() == 8);
+    BOOST_CHECK(cascade().channels() == 2);
+    BOOST_CHECK(cascade().coefficients(0).identity());
+    BOOST_CHECK(! cascade().coefficients(4).identity());
+}
+
+TEST_CASE(EqualizerObject_process)
+{
+    constexpr std::size_t channels = 6;
+    constexpr std::size_t blockSize = 128;
+    auto equalizer = EqualizerObject::make();
+    auto source = TestObject::make();
+    auto sink = TestObject::make();
+    std::unique_lock equalizerLock(*equalizer, std::defer_lock);
+    std::unique_lock sourceLock(*source, std::defer_lock);
+    std::unique_lock sinkLock(*sink, std::defer_lock);
+    std::lock(equalizerLock, sourceLock, sinkLock);
+    auto& output = source->publicAddOutput<PcmOutputPort>("output");
+    auto& input = sink->publicAddInput<PcmInputPort>("input");
+    auto& equalizerInput = static_cast<PcmInputPort&>(equalizer->input("input"));
+    auto& equalizerOutput = static_cast<PcmOutputPort&>(equalizer->output("output"));
+
+    output.config({ PcmFormat::float32, channels, blockSize, 0, 48000 });
+    input.config({ PcmFormat::float32, 0, 0, 0, 0 });
+    source->configure();
+    sink->configure();
+    equalizer->configure({ { "Channels", channels }, { "Bands", 2 }, { "Block Size", blockSize } });
+    linkPorts(output, equalizerInput);
+    linkPorts(equalizerOutput, input);
+    equalizer->start();
+
+    // Run a block of a constant through the equalizer and give back the last sample of the last channel.
+    const auto block = [&](const float in_value) {
+        auto& buffer = output.buffer();
+
+        for (std::size_t channel = 0; channel < channels; channel++)
+        {
+            for (std::size_t frame = 0; frame < blockSize; frame++) buffer.channel<float>(channel)[frame] = in_value;
+        }
+
+        output.commit(blockSize);
+        equalizer->schedule();
+        BOOST_REQUIRE(equalizer->execute() == ObjectProcessResult::finished);
+        BOOST_REQUIRE(input.frames() == blockSize);
+
+        const auto result = input.buffer().channel<float>(channels - 1)[blockSize - 1];
+
+        input.consume();
+
+        return result;
+    };
+
+    BOOST_CHECK(block(0.5f) == 0.5f);
+
+    // The change is noticed by the next period which still uses the old coefficients.
+    equalizer->property("Band 2 Type").anyValue(std::string("lowShelf"));
+    equalizer->property("Band 2 Frequency").anyValue(200.0f);
+    equalizer->property("Band 2 Gain").anyValue(6.0f);
+    BOOST_CHECK(block(0.5f) == 0.5f);
+
+    equalizerLock.unlock();
+    BOOST_REQUIRE(waitUntil(*equalizer, [&] { return ! equalizer->updating(); }));
+    equalizerLock.lock();
+
+    for (std::size_t period = 0; period < 50; period++) block(0.5f);
+
+    BOOST_CHECK(equalizer->cascade().coefficients(1) == designBiquad(BiquadType::lowShelf, rate, 200, 6, 0.707f));
+    BOOST_CHECK(std::abs(block(0.5f) - 0.5f * std::pow(10.0f, 6.0f / 20)) < 1e-3f);
+
+    // A band that can not be designed is logged once and the current coefficients are kept.
+    const auto coefficients = equalizer->cascade().coefficients(1);
+
+    equalizer->property("Band 2 Frequency").anyValue(30000.0f);
+    block(0.5f);
+    block(0.5f);
+    BOOST_CHECK(! equalizer->updating());
+    BOOST_CHECK(equalizer->state() == ObjectState::waiting);
+    BOOST_CHECK(equalizer->cascade().coefficients(1) == coefficients);
+    BOOST_CHECK(severeLogEvents == 1);
+    severeLogEvents = 0;
+
+    equalizer->property("Band 2 Frequency").anyValue(400.0f);
+    block(0.5f);
+    BOOST_CHECK(equalizer->updating());
+
+    equalizerLock.unlock();
+    BOOST_REQUIRE(waitUntil(*equalizer, [&] { return ! equalizer->updating(); }));
+    equalizerLock.lock();
+    block(0.5f);
+    BOOST_CHECK(equalizer->cascade().coefficients(1) == designBiquad(BiquadType::lowShelf, rate, 400, 6, 0.707f));
+
+    stopObject(equalizer);
+    unlinkPorts(output, equalizerInput);
+    unlinkPorts(equalizerOutput, input);
+}
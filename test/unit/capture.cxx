@@ -0,0 +1,355 @@
+/* Copyright 2023 Tyler Riddle
+ *
+ * This file is part of Clypsalot. Clypsalot is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation, either version 3 of the License,
+ * or (at your option) any later version. Clypsalot is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with Clypsalot. If not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+
+#include <chrono>
+#include <cstddef>
+#include <cstring>
+#include <filesystem>
+#include <thread>
+
+#include <clypsalot/capture.hxx>
+#include <clypsalot/catalog.hxx>
+#include <clypsalot/control.hxx>
+#include <clypsalot/pcm.hxx>
+#include <clypsalot/property.hxx>
+#include <clypsalot/replay.hxx>
+
+#include "test/lib/test.hxx"
+#include "test/module/object.hxx"
+
+using namespace Clypsalot;
+
+TEST_MAIN_FUNCTION
+
+static constexpr std::size_t blockSize = 64;
+static constexpr std::size_t blocks = 20;
+
+static float sampleValue(const std::size_t in_channel, const std::size_t in_frame) noexcept
+{
+    return static_cast<float>(in_channel * 1000 + in_frame);
+}
+
+// The number of frames in each block changes so short blocks are covered too.
+static std::size_t blockFrames(const std::size_t in_block) noexcept
+{
+    return blockSize - in_block % 3;
+}
+
+static float& sample(PcmBuffer& in_buffer, const std::size_t in_channel, const std::size_t in_frame) noexcept
+{
+    if (in_buffer.layout() == PcmLayout::planar) return in_buffer.channel<float>(in_channel)[in_frame];
+
+    const auto lanes = in_buffer.lanes();
+    return in_buffer.group<float>(in_channel / lanes)[in_frame * lanes + in_channel % lanes];
+}
+
+static float sample(const PcmBuffer& in_buffer, const std::size_t in_channel, const std::size_t in_frame) noexcept
+{
+    return sample(const_cast<PcmBuffer&>(in_buffer), in_channel, in_frame);
+}
+
+static std::filesystem::path capturePath(const char* in_name)
+{
+    return std::filesystem::temp_directory_path() / makeString("clypsalot-test-", in_name, ".capture");
+}
+
+static void capturePcm(const std::filesystem::path& in_path, const PcmConfig& in_config, const std::size_t in_ringSize = 0)
+{
+    auto source = TestObject::make();
+    auto sink = TestObject::make();
+    std::scoped_lock lock(*source, *sink);
+    auto& output = source->publicAddOutput<PcmOutputPort>("output");
+    auto& input = sink->publicAddInput<PcmInputPort>("input");
+    std::size_t frame = 0;
+
+    output.config(in_config);
+    input.config({ in_config.format, 0, 0, 0, 0, in_config.layout });
+    source->configure();
+    sink->configure();
+
+    auto link = linkPorts(output, input);
+
+    link->startCapture(in_path, in_ringSize);
+
+    for (std::size_t block = 0; block < blocks; block++)
+    {
+        auto& buffer = output.buffer();
+        const auto frames = blockFrames(block);
+
+        for (std::size_t channel = 0; channel < in_config.channels; channel++)
+        {
+            for (std::size_t i = 0; i < frames; i++) sample(buffer, channel, i) = sampleValue(channel, frame + i);
+        }
+
+        output.commit(frames);
+        input.consume();
+        frame += frames;
+    }
+
+    BOOST_CHECK(link->capture()->records() + link->capture()->dropped() == blocks);
+    link->stopCapture();
+    BOOST_CHECK(link->capture() == nullptr);
+    unlinkPorts(output, input);
+}
+
+static void checkPcmCapture(const PcmConfig& in_config)
+{
+    const auto path = capturePath("pcm");
+
+    capturePcm(path, in_config);
+
+    CaptureReader reader(path);
+    CaptureRecord record;
+    std::size_t frame = 0;
+    std::size_t mismatches = 0;
+    std::uint64_t time = 0;
+    const auto sampleSize = pcmSampleSize(in_config.format);
+    const auto lanes = pcmLanes(in_config.layout);
+
+    BOOST_CHECK(reader.info().kind == CaptureKind::pcm);
+    BOOST_CHECK(reader.info().config == in_config);
+    BOOST_CHECK(reader.records() == blocks);
+    BOOST_CHECK(reader.dropped() == 0);
+
+    for (std::size_t block = 0; block < blocks; block++)
+    {
+        BOOST_REQUIRE(reader.next(record));
+        BOOST_CHECK(record.count == blockFrames(block));
+        BOOST_CHECK(record.time >= time);
+        BOOST_CHECK(record.bytes == in_config.channels * record.count * sampleSize);
+
+        for (std::size_t channel = 0; channel < in_config.channels; channel++)
+        {
+            for (std::size_t i = 0; i < record.count; i++)
+            {
+                // The rows are channels when planar or groups of lanes channels.
+                const auto offset = (channel / lanes * record.count * lanes + i * lanes + channel % lanes) * sampleSize;
+                float value;
+
+                std::memcpy(&value, record.data + offset, sizeof(value));
+                if (value != sampleValue(channel, frame + i)) mismatches++;
+            }
+        }
+
+        frame += record.count;
+        time = record.time;
+    }
+
+    BOOST_CHECK(mismatches == 0);
+    BOOST_CHECK(! reader.next(record));
+    reader.rewind();
+    BOOST_CHECK(reader.next(record));
+    BOOST_CHECK(record.count == blockFrames(0));
+    std::filesystem::remove(path);
+}
+
+TEST_CASE(Capture_pcm)
+{
+    checkPcmCapture({ PcmFormat::float32, 1, blockSize, 0, 48000 });
+    checkPcmCapture({ PcmFormat::float32, 6, blockSize, 0, 44100 });
+    checkPcmCapture({ PcmFormat::float32, 8, blockSize, 0, 96000, PcmLayout::grouped4 });
+    checkPcmCapture({ PcmFormat::float32, 8, blockSize, 0, 96000, PcmLayout::grouped8 });
+}
+
+// A ring that can not hold a single block drops every record instead of blocking the output.
+TEST_CASE(Capture_drops)
+{
+    const auto path = capturePath("drops");
+
+    capturePcm(path, { PcmFormat::float32, 64, blockSize, 0, 48000 }, 1024);
+
+    CaptureReader reader(path);
+    CaptureRecord record;
+
+    BOOST_CHECK(reader.records() == 0);
+    BOOST_CHECK(reader.dropped() == blocks);
+    BOOST_CHECK(! reader.next(record));
+    std::filesystem::remove(path);
+}
+
+// A ring that holds a few records at a time is written out many times while recording.
+TEST_CASE(Capture_small_ring)
+{
+    const auto path = capturePath("small-ring");
+
+    capturePcm(path, { PcmFormat::float32, 1, blockSize, 0, 48000 }, 4096);
+
+    CaptureReader reader(path);
+    CaptureRecord record;
+    std::size_t records = 0;
+
+    BOOST_CHECK(reader.records() + reader.dropped() == blocks);
+
+    while (reader.next(record))
+    {
+        BOOST_CHECK(record.bytes == record.count * sizeof(float));
+        records++;
+    }
+
+    BOOST_CHECK(records == reader.records());
+    std::filesystem::remove(path);
+}
+
+// Control events are captured with the time they were pushed.
+static void captureControl(const std::filesystem::path& in_path, const std::size_t in_events, const std::chrono::milliseconds in_gap)
+{
+    auto source = TestObject::make();
+    auto sink = TestObject::make();
+    std::scoped_lock lock(*source, *sink);
+    auto& output = source->publicAddOutput<ControlOutputPort>("output");
+    auto& input = sink->publicAddInput<ControlInputPort>("input");
+
+    source->configure();
+    sink->configure();
+
+    auto link = linkPorts(output, input);
+
+    link->startCapture(in_path);
+
+    for (std::size_t event = 0; event < in_events; event++)
+    {
+        if (event > 0) std::this_thread::sleep_for(in_gap);
+
+        BOOST_CHECK(output.push({ static_cast<std::uint32_t>(event), 7, event * 0.5f, ControlEventKind::parameter, 1 }));
+        input.pop();
+    }
+
+    link->stopCapture();
+    unlinkPorts(output, input);
+}
+
+TEST_CASE(Capture_control)
+{
+    const auto path = capturePath("control");
+
+    captureControl(path, 10, std::chrono::milliseconds(0));
+
+    CaptureReader reader(path);
+    CaptureRecord record;
+    ControlEvent event;
+
+    BOOST_CHECK(reader.info().kind == CaptureKind::control);
+    BOOST_CHECK(reader.records() == 10);
+
+    for (std::size_t i = 0; i < 10; i++)
+    {
+        BOOST_REQUIRE(reader.next(record));
+        BOOST_REQUIRE(record.bytes == sizeof(event));
+        std::memcpy(&event, record.data, sizeof(event));
+        BOOST_CHECK(event.offset == i);
+        BOOST_CHECK(event.target == 7);
+        BOOST_CHECK(event.value == i * 0.5f);
+        BOOST_CHECK(event.kind == ControlEventKind::parameter);
+    }
+
+    BOOST_CHECK(! reader.next(record));
+    std::filesystem::remove(path);
+}
+
+TEST_CASE(Replay_catalog)
+{
+    BOOST_CHECK(dynamic_cast<ReplayObject*>(objectCatalog().make(ReplayObject::kindName).get()) != nullptr);
+}
+
+TEST_CASE(Replay_pcm)
+{
+    const auto path = capturePath("replay");
+    const PcmConfig config = { PcmFormat::float32, 8, blockSize, 0, 48000, PcmLayout::grouped4 };
+
+    capturePcm(path, config);
+
+    auto replay = objectCatalog().make(ReplayObject::kindName);
+    auto sink = TestObject::make();
+    std::scoped_lock lock(*replay, *sink);
+    auto& input = sink->publicAddInput<PcmInputPort>("input");
+    std::size_t frame = 0;
+    std::size_t mismatches = 0;
+
+    input.config({ PcmFormat::float32, 0, 0, 0, 0, PcmLayout::grouped4 });
+    replay->configure({ { "File", path } });
+    sink->configure();
+
+    auto& output = static_cast<PcmOutputPort&>(replay->output("output"));
+
+    BOOST_CHECK(output.config() == config);
+    linkPorts(output, input);
+    replay->start();
+
+    for (std::size_t block = 0; block < blocks; block++)
+    {
+        const auto last = block + 1 == blocks;
+
+        replay->schedule();
+        BOOST_REQUIRE(replay->execute() == (last ? ObjectProcessResult::endOfData : ObjectProcessResult::finished));
+        BOOST_REQUIRE(input.frames() == blockFrames(block));
+
+        for (std::size_t channel = 0; channel < config.channels; channel++)
+        {
+            for (std::size_t i = 0; i < input.frames(); i++)
+            {
+                if (sample(input.buffer(), channel, i) != sampleValue(channel, frame + i)) mismatches++;
+            }
+        }
+
+        frame += input.frames();
+        input.consume();
+    }
+
+    BOOST_CHECK(mismatches == 0);
+    BOOST_CHECK(replay->property("Records").sizeValue() == blocks);
+    BOOST_CHECK(replay->state() == ObjectState::stopped);
+    unlinkPorts(output, input);
+    std::filesystem::remove(path);
+}
+
+// Real time replay keeps the gaps between the events instead of sending them all at once.
+TEST_CASE(Replay_real_time)
+{
+    const auto path = capturePath("real-time");
+    const auto gap = std::chrono::milliseconds(20);
+    constexpr std::size_t events = 5;
+
+    captureControl(path, events, gap);
+
+    auto replay = ReplayObject::make();
+    auto sink = TestObject::make();
+    auto& input = [&] () -> ControlInputPort&
+    {
+        std::scoped_lock lock(*replay, *sink);
+        auto& port = sink->publicAddInput<ControlInputPort>("input");
+
+        replay->configure({ { "File", path }, { "Real Time", true } });
+        sink->configure();
+        linkPorts(replay->output("output"), port);
+
+        return port;
+    }();
+
+    const auto start = std::chrono::steady_clock::now();
+
+    {
+        std::scoped_lock lock(*replay);
+        startObject(replay);
+    }
+
+    BOOST_REQUIRE(waitUntil(*replay, [&] { return replay->state() == ObjectState::stopped; }));
+
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+
+    std::scoped_lock lock(*replay, *sink);
+
+    BOOST_CHECK(elapsed >= gap * (events - 1));
+    BOOST_CHECK(input.size() == events);
+    BOOST_CHECK(replay->property("Records").sizeValue() == events);
+    unlinkPorts(replay->output("output"), input);
+    std::filesystem::remove(path);
+}
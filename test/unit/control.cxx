@@ -0,0 +1,134 @@
+/* Copyright 2023 Tyler Riddle
+ *
+ * This file is part of Clypsalot. Clypsalot is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation, either version 3 of the License,
+ * or (at your option) any later version. Clypsalot is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with Clypsalot. If not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+
+#include <clypsalot/catalog.hxx>
+#include <clypsalot/control.hxx>
+#include <clypsalot/error.hxx>
+#include <clypsalot/pcm.hxx>
+
+#include "test/lib/test.hxx"
+#include "test/module/object.hxx"
+
+using namespace Clypsalot;
+
+TEST_MAIN_FUNCTION
+
+TEST_CASE(ControlPortType_catalog)
+{
+    BOOST_CHECK(&portTypeCatalog().instance(ControlPortType::typeName) == &ControlPortType::singleton);
+}
+
+TEST_CASE(ControlPortType_link)
+{
+    auto source = TestObject::make();
+    auto sink = TestObject::make();
+    std::scoped_lock lock(*source, *sink);
+    auto& output = source->publicAddOutput<ControlOutputPort>("output");
+    auto& input = sink->publicAddInput<ControlInputPort>("input");
+    auto& other = sink->publicAddInput<ControlInputPort>("other");
+    auto& pcm = sink->publicAddInput<PcmInputPort>("pcm");
+
+    output.capacity(4);
+    other.capacity(16);
+    source->configure();
+    sink->configure();
+
+    BOOST_CHECK_THROW(ControlPortType::singleton.makeLink(output, pcm), TypeError);
+
+    auto link = dynamic_cast<ControlPortLink*>(linkPorts(output, input));
+    auto otherLink = dynamic_cast<ControlPortLink*>(linkPorts(output, other));
+
+    BOOST_CHECK(link->slots() == 4);
+    BOOST_CHECK(otherLink->slots() == 16);
+    BOOST_CHECK_THROW(output.capacity(8), RuntimeError);
+    BOOST_CHECK_THROW(ControlPortType::singleton.makeLink(output, input), RuntimeError);
+}
+
+TEST_CASE(ControlPort_events)
+{
+    auto source = TestObject::make();
+    auto sink = TestObject::make();
+    std::scoped_lock lock(*source, *sink);
+    auto& output = source->publicAddOutput<ControlOutputPort>("output");
+    auto& first = sink->publicAddInput<ControlInputPort>("first");
+    auto& second = sink->publicAddInput<ControlInputPort>("second");
+
+    first.capacity(2);
+    source->configure();
+    sink->configure();
+
+    BOOST_CHECK(output.ready());
+    BOOST_CHECK(output.push({ 0, 60, 0.5, ControlEventKind::noteOn }));
+    BOOST_CHECK(first.front() == nullptr);
+
+    linkPorts(output, first);
+    linkPorts(output, second);
+
+    BOOST_CHECK(first.ready() == false);
+    BOOST_CHECK(output.push({ 10, 60, 0.5, ControlEventKind::noteOn }));
+    BOOST_CHECK(output.push({ 20, 60, 0, ControlEventKind::noteOff }));
+    BOOST_CHECK(output.ready() == false);
+    BOOST_CHECK(output.push({ 30, 3, 1, ControlEventKind::parameter }) == false);
+    BOOST_CHECK(first.ready());
+    BOOST_CHECK(first.size() == 2);
+    BOOST_CHECK(second.size() == 2);
+    BOOST_CHECK(first.front()->offset == 10);
+    BOOST_CHECK(first.front()->kind == ControlEventKind::noteOn);
+    BOOST_CHECK(first.next(10) == nullptr);
+    BOOST_CHECK(first.next(11)->target == 60);
+
+    first.pop();
+
+    BOOST_CHECK(output.ready());
+    BOOST_CHECK(first.front()->kind == ControlEventKind::noteOff);
+    BOOST_CHECK(second.front()->kind == ControlEventKind::noteOn);
+    first.pop();
+    BOOST_CHECK(first.ready() == false);
+    BOOST_CHECK(first.next(100) == nullptr);
+
+    unlinkPorts(output, first);
+    unlinkPorts(output, second);
+}
+
+TEST_CASE(ControlPort_readiness)
+{
+    auto source = TestObject::make();
+    auto sink = TestObject::make();
+    std::unique_lock lock(*source, std::defer_lock);
+    std::unique_lock sinkLock(*sink, std::defer_lock);
+    std::lock(lock, sinkLock);
+    auto& output = source->publicAddOutput<ControlOutputPort>("output");
+    auto& input = sink->publicAddInput<ControlInputPort>("input");
+
+    source->configure();
+    sink->configure();
+    linkPorts(output, input);
+    sink->start();
+
+    // An Object that only takes events is not run until one arrives.
+    BOOST_CHECK(sink->ready() == false);
+    output.push({ 0, 0, 1, ControlEventKind::trigger });
+    BOOST_CHECK(sink->ready() == true);
+    input.pop();
+    BOOST_CHECK(sink->ready() == false);
+    input.optional(true);
+    BOOST_CHECK(sink->ready() == true);
+
+    stopObject(sink);
+    unlinkPorts(output, input);
+}
+
+TEST_CASE(ControlEventKind_toString)
+{
+    BOOST_CHECK(toString(ControlEventKind::noteOff) == "note off");
+    BOOST_CHECK(makeString(ControlEventKind::parameter) == "parameter");
+}
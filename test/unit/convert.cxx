@@ -0,0 +1,151 @@
+/* Copyright 2023 Tyler Riddle
+ *
+ * This file is part of Clypsalot. Clypsalot is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation, either version 3 of the License,
+ * or (at your option) any later version. Clypsalot is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with Clypsalot. If not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include <clypsalot/convert.hxx>
+
+#include "test/lib/test.hxx"
+
+using namespace Clypsalot;
+
+TEST_MAIN_FUNCTION
+
+static const std::vector<PcmFormat> allFormats = {
+    PcmFormat::int16, PcmFormat::int24, PcmFormat::int32, PcmFormat::float32, PcmFormat::float64
+};
+
+static const std::vector<SimdLevel> allLevels = { SimdLevel::scalar, SimdLevel::sse2, SimdLevel::avx2 };
+
+// A test signal that covers the whole range of the format and goes past it for the float formats
+// so clipping is exercised.
+static PcmBuffer makeSignal(const PcmFormat in_format, const std::size_t in_frames)
+{
+    PcmBuffer buffer(in_format, 1, in_frames);
+
+    for (std::size_t frame = 0; frame < in_frames; frame++)
+    {
+        const auto value = std::sin(frame * 0.37) * 1.25;
+
+        switch (in_format)
+        {
+            case PcmFormat::int16: buffer.channel<std::int16_t>(0)[frame] = std::clamp(value, -1.0, 1.0) * 32767; break;
+            case PcmFormat::int24: buffer.channel<std::int32_t>(0)[frame] = std::clamp(value, -1.0, 1.0) * 8388607; break;
+            case PcmFormat::int32: buffer.channel<std::int32_t>(0)[frame] = std::clamp(value, -1.0, 1.0) * 2147483647; break;
+            case PcmFormat::float32: buffer.channel<float>(0)[frame] = value; break;
+            case PcmFormat::float64: buffer.channel<double>(0)[frame] = value; break;
+        }
+    }
+
+    return buffer;
+}
+
+TEST_CASE(PcmConverter_levels_agree)
+{
+    // 101 frames leaves a tail for every vector width.
+    constexpr std::size_t frames = 101;
+
+    for (const auto from : allFormats)
+    {
+        const auto source = makeSignal(from, frames);
+
+        for (const auto to : allFormats)
+        {
+            PcmBuffer expected(to, 1, frames);
+
+            PcmConverter(from, to, PcmDither::none, SimdLevel::scalar).convert(source, expected, frames);
+
+            for (const auto level : allLevels)
+            {
+                PcmBuffer actual(to, 1, frames);
+                PcmConverter converter(from, to, PcmDither::none, level);
+
+                BOOST_CHECK(converter.level() <= level);
+                converter.convert(source, actual, frames);
+                BOOST_CHECK_MESSAGE(std::memcmp(expected.channelData(0), actual.channelData(0), frames * pcmSampleSize(to)) == 0,
+                    from << " -> " << to << " at " << converter.level());
+            }
+        }
+    }
+}
+
+TEST_CASE(PcmConverter_values)
+{
+    PcmBuffer floats(PcmFormat::float32, 1, 6);
+    PcmBuffer shorts(PcmFormat::int16, 1, 6);
+    PcmBuffer words(PcmFormat::int32, 1, 6);
+    PcmBuffer back(PcmFormat::float32, 1, 6);
+    const float values[] = { 0, 0.5f, -0.5f, 1, -1, 2 };
+
+    std::memcpy(floats.channel<float>(0), values, sizeof(values));
+    PcmConverter(PcmFormat::float32, PcmFormat::int16).convert(floats, shorts, 6);
+    PcmConverter(PcmFormat::float32, PcmFormat::int32).convert(floats, words, 6);
+    PcmConverter(PcmFormat::int16, PcmFormat::float32).convert(shorts, back, 6);
+
+    const std::int16_t expectedShorts[] = { 0, 16384, -16384, 32767, -32768, 32767 };
+    const std::int32_t expectedWords[] = { 0, 1073741824, -1073741824, 2147483647, -2147483647 - 1, 2147483647 };
+
+    for (std::size_t i = 0; i < 6; i++)
+    {
+        BOOST_CHECK_EQUAL(shorts.channel<std::int16_t>(0)[i], expectedShorts[i]);
+        BOOST_CHECK_EQUAL(words.channel<std::int32_t>(0)[i], expectedWords[i]);
+    }
+
+    BOOST_CHECK_EQUAL(back.channel<float>(0)[1], 0.5f);
+    BOOST_CHECK_EQUAL(back.channel<float>(0)[4], -1.0f);
+}
+
+TEST_CASE(PcmConverter_dither)
+{
+    constexpr std::size_t frames = 4096;
+
+    BOOST_CHECK(pcmDitherApplies(PcmFormat::float32, PcmFormat::int16));
+    BOOST_CHECK(pcmDitherApplies(PcmFormat::int32, PcmFormat::int24));
+    BOOST_CHECK(! pcmDitherApplies(PcmFormat::int16, PcmFormat::int32));
+    BOOST_CHECK(! pcmDitherApplies(PcmFormat::float64, PcmFormat::float32));
+    BOOST_CHECK(PcmConverter(PcmFormat::int16, PcmFormat::float32, PcmDither::triangular).dither() == PcmDither::none);
+
+    PcmBuffer silence(PcmFormat::float32, 1, frames);
+
+    silence.clear();
+
+    for (const auto dither : { PcmDither::rectangular, PcmDither::triangular })
+    {
+        for (const auto level : allLevels)
+        {
+            PcmBuffer output(PcmFormat::int16, 1, frames);
+            PcmConverter converter(PcmFormat::float32, PcmFormat::int16, dither, level);
+            double sum = 0;
+            std::size_t nonZero = 0;
+
+            converter.convert(silence, output, frames);
+
+            for (std::size_t frame = 0; frame < frames; frame++)
+            {
+                const auto sample = output.channel<std::int16_t>(0)[frame];
+
+                BOOST_CHECK(sample >= -1 && sample <= 1);
+                sum += sample;
+                if (sample != 0) nonZero++;
+            }
+
+            BOOST_CHECK(std::abs(sum / frames) < 0.05);
+
+            // Rectangular noise never reaches half a step so silence stays silent.
+            if (dither == PcmDither::triangular) BOOST_CHECK(nonZero > frames / 8);
+            else BOOST_CHECK(nonZero == 0);
+        }
+    }
+}
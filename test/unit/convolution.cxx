@@ -0,0 +1,315 @@
+/* Copyright 2023 Tyler Riddle
+ *
+ * This file is part of Clypsalot. Clypsalot is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation, either version 3 of the License,
+ * or (at your option) any later version. Clypsalot is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with Clypsalot. If not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <numbers>
+#include <vector>
+
+#include <clypsalot/catalog.hxx>
+#include <clypsalot/convolution.hxx>
+#include <clypsalot/convolver.hxx>
+#include <clypsalot/error.hxx>
+#include <clypsalot/fft.hxx>
+#include <clypsalot/pcm.hxx>
+#include <clypsalot/property.hxx>
+#include <clypsalot/wav.hxx>
+
+#include "test/lib/test.hxx"
+#include "test/module/object.hxx"
+
+using namespace Clypsalot;
+
+TEST_MAIN_FUNCTION
+
+static const auto allLevels = { SimdLevel::scalar, SimdLevel::sse2, SimdLevel::avx2, SimdLevel::avx512 };
+
+// Deterministic noise in [-1, 1).
+static float noise(std::uint32_t& io_state)
+{
+    io_state = io_state * 1664525 + 1013904223;
+    return static_cast<std::int32_t>(io_state) / 2147483648.0f;
+}
+
+// A decaying noise burst like a room.
+static std::vector<float> makeImpulse(const std::size_t in_length, std::uint32_t in_seed)
+{
+    std::vector<float> impulse(in_length);
+
+    for (std::size_t frame = 0; frame < in_length; frame++) impulse[frame] = noise(in_seed) * std::exp(-3.0f * frame / in_length);
+
+    return impulse;
+}
+
+TEST_CASE(RealFft_reference)
+{
+    for (const std::size_t size : { 4, 8, 32, 256, 2048 })
+    {
+        std::uint32_t seed = 1;
+        std::vector<float> samples(size);
+        std::vector<std::vector<float>> results;
+
+        for (auto& sample : samples) sample = noise(seed);
+
+        for (const auto level : allLevels)
+        {
+            RealFft fft(size, level);
+            std::vector<float> real(fft.bins());
+            std::vector<float> imaginary(fft.bins());
+            std::vector<float> roundTrip(size);
+            double error = 0;
+            double roundTripError = 0;
+
+            BOOST_REQUIRE(fft.bins() == size / 2 + 1);
+            fft.forward(samples.data(), real.data(), imaginary.data());
+
+            for (std::size_t bin = 0; bin < fft.bins(); bin++)
+            {
+                double expectedReal = 0;
+                double expectedImaginary = 0;
+
+                for (std::size_t n = 0; n < size; n++)
+                {
+                    const auto angle = -2 * std::numbers::pi * bin * n / size;
+
+                    expectedReal += samples[n] * std::cos(angle);
+                    expectedImaginary += samples[n] * std::sin(angle);
+                }
+
+                error = std::max({ error, std::abs(real[bin] - expectedReal), std::abs(imaginary[bin] - expectedImaginary) });
+            }
+
+            fft.inverse(real.data(), imaginary.data(), roundTrip.data());
+
+            for (std::size_t n = 0; n < size; n++) roundTripError = std::max(roundTripError, std::abs(roundTrip[n] / size - static_cast<double>(samples[n])));
+
+            BOOST_CHECK_MESSAGE(error < 1e-5 * size, "size=" << size << " level=" << level << " error=" << error);
+            BOOST_CHECK_MESSAGE(roundTripError < 1e-6, "size=" << size << " level=" << level << " round trip error=" << roundTripError);
+
+            real.insert(real.end(), imaginary.begin(), imaginary.end());
+            results.push_back(real);
+        }
+
+        // Every level rounds the same way.
+        for (const auto& result : results) BOOST_CHECK(result == results.front());
+    }
+
+    BOOST_CHECK_THROW(RealFft(2), ValueError);
+    BOOST_CHECK_THROW(RealFft(48), ValueError);
+}
+
+TEST_CASE(RealFft_multiplyAdd)
+{
+    for (const auto level : allLevels)
+    {
+        RealFft fft(32, level);
+        std::vector<float> a(fft.bins() * 2);
+        std::vector<float> b(fft.bins() * 2);
+        std::vector<float> sum(fft.bins() * 2, 1.0f);
+
+        for (std::size_t bin = 0; bin < fft.bins(); bin++)
+        {
+            a[bin] = bin;
+            a[fft.bins() + bin] = 1;
+            b[bin] = 2;
+            b[fft.bins() + bin] = -1.0f * bin;
+        }
+
+        fft.multiplyAdd(a.data(), a.data() + fft.bins(), b.data(), b.data() + fft.bins(), sum.data(), sum.data() + fft.bins());
+
+        // (k + i)(2 - ik) = 3k + i(2 - k^2)
+        for (std::size_t bin = 0; bin < fft.bins(); bin++)
+        {
+            BOOST_CHECK(sum[bin] == 1.0f + 3.0f * bin);
+            BOOST_CHECK(sum[fft.bins() + bin] == 1.0f + 2.0f - 1.0f * bin * bin);
+        }
+    }
+}
+
+TEST_CASE(PcmConvolver_reference)
+{
+    constexpr std::size_t channels = 3;
+    constexpr std::size_t blockSize = 32;
+    constexpr std::size_t blocks = 150;
+
+    // Shorter than one block, only head partitions and both head and tail partitions.
+    for (const std::size_t length : { 20, 300, 3000 })
+    {
+        for (const std::size_t impulseChannels : { std::size_t(1), channels })
+        {
+            PcmBuffer impulse(PcmFormat::float32, impulseChannels, length);
+            std::vector<std::vector<float>> results;
+
+            for (std::size_t channel = 0; channel < impulseChannels; channel++)
+            {
+                const auto samples = makeImpulse(length, channel + 7);
+
+                std::copy(samples.begin(), samples.end(), impulse.channel<float>(channel));
+            }
+
+            for (const auto background : { true, false })
+            {
+                for (const auto level : allLevels)
+                {
+                    PcmConvolver convolver(impulse, length, channels, blockSize, background, level);
+                    PcmBuffer buffer(PcmFormat::float32, channels, blockSize);
+                    std::vector<std::vector<float>> input(channels);
+                    std::vector<float> result;
+                    std::uint32_t seed = 99;
+                    double error = 0;
+
+                    BOOST_CHECK(convolver.tailPartitions() == (length > blockSize * PcmConvolver::tailRatio * 2 ? 10 : 0));
+
+                    for (std::size_t block = 0; block < blocks; block++)
+                    {
+                        // A short block is followed by silence until the end of the block.
+                        const auto frames = block % 7 == 3 ? blockSize / 2 : blockSize;
+
+                        for (std::size_t channel = 0; channel < channels; channel++)
+                        {
+                            for (std::size_t frame = 0; frame < blockSize; frame++)
+                            {
+                                const auto value = frame < frames ? noise(seed) : 0.0f;
+
+                                if (frame < frames) buffer.channel<float>(channel)[frame] = value;
+                                input[channel].push_back(value);
+                            }
+                        }
+
+                        convolver.process(buffer, frames);
+
+                        for (std::size_t channel = 0; channel < channels; channel++)
+                        {
+                            for (std::size_t frame = 0; frame < frames; frame++)
+                            {
+                                const auto position = block * blockSize + frame;
+                                const auto taps = impulse.channel<float>(impulseChannels == 1 ? 0 : channel);
+                                double expected = 0;
+
+                                for (std::size_t tap = 0; tap < length && tap <= position; tap++) expected += taps[tap] * static_cast<double>(input[channel][position - tap]);
+
+                                error = std::max(error, std::abs(buffer.channel<float>(channel)[frame] - expected));
+                                result.push_back(buffer.channel<float>(channel)[frame]);
+                            }
+                        }
+                    }
+
+                    BOOST_CHECK_MESSAGE(error < 1e-4, "length=" << length << " impulseChannels=" << impulseChannels << " background=" << background << " level=" << level << " error=" << error);
+
+                    results.push_back(result);
+                }
+            }
+
+            // Every level rounds the same way and the jobs do not change the result.
+            for (const auto& result : results) BOOST_CHECK(result == results.front());
+        }
+    }
+}
+
+TEST_CASE(ConvolverObject_process)
+{
+    constexpr std::size_t channels = 2;
+    constexpr std::size_t blockSize = 64;
+    constexpr std::size_t length = 3001;
+    const auto path = std::filesystem::temp_directory_path() / "clypsalot-test-impulse.wav";
+    std::vector<float> impulse(length);
+    PcmFileInfo info;
+
+    // Taps in the head and in the last tail partition.
+    impulse[0] = 0.5f;
+    impulse[10] = -0.125f;
+    impulse[3000] = 0.25f;
+    info.format = PcmFormat::float32;
+    info.sampleSize = sizeof(float);
+    info.channels = 1;
+    info.rate = 48000;
+    info.dataOffset = wavHeaderSize;
+    info.frames = length;
+
+    {
+        std::vector<std::byte> header(wavHeaderSize);
+        std::ofstream file(path, std::ios::binary);
+
+        writeWavHeader(header.data(), info);
+        file.write(reinterpret_cast<const char*>(header.data()), header.size());
+        file.write(reinterpret_cast<const char*>(impulse.data()), impulse.size() * sizeof(float));
+    }
+
+    auto convolver = objectCatalog().make(ConvolverObject::kindName);
+    auto source = TestObject::make();
+    auto sink = TestObject::make();
+    std::scoped_lock lock(*convolver, *source, *sink);
+    auto& output = source->publicAddOutput<PcmOutputPort>("output");
+    auto& input = sink->publicAddInput<PcmInputPort>("input");
+
+    output.config({ PcmFormat::float32, channels, blockSize, 0, 48000 });
+    input.config({ PcmFormat::float32, 0, 0, 0, 0 });
+    source->configure();
+    sink->configure();
+    convolver->configure({
+        { "Channels", channels },
+        { "Block Size", blockSize },
+        { "Impulse", path },
+    });
+
+    std::filesystem::remove(path);
+
+    BOOST_CHECK(convolver->property("Impulse Length").sizeValue() == length);
+    BOOST_CHECK(static_cast<ConvolverObject&>(*convolver).convolver().tailPartitions() == 4);
+
+    auto& convolverInput = static_cast<PcmInputPort&>(convolver->input("input"));
+    auto& convolverOutput = static_cast<PcmOutputPort&>(convolver->output("output"));
+
+    linkPorts(output, convolverInput);
+    linkPorts(convolverOutput, input);
+    convolver->start();
+
+    std::vector<float> received;
+
+    for (std::size_t period = 0; period < 60; period++)
+    {
+        auto& buffer = output.buffer();
+
+        // A click on the second channel.
+        for (std::size_t channel = 0; channel < channels; channel++)
+        {
+            for (std::size_t frame = 0; frame < blockSize; frame++) buffer.channel<float>(channel)[frame] = period == 0 && frame == 5 && channel == 1 ? 1.0f : 0.0f;
+        }
+
+        output.commit(blockSize);
+        convolver->schedule();
+        BOOST_REQUIRE(convolver->execute() == ObjectProcessResult::finished);
+        BOOST_REQUIRE(input.frames() == blockSize);
+
+        for (std::size_t frame = 0; frame < blockSize; frame++)
+        {
+            BOOST_CHECK(std::abs(input.buffer().channel<float>(0)[frame]) < 1e-6f);
+            received.push_back(input.buffer().channel<float>(1)[frame]);
+        }
+
+        input.consume();
+    }
+
+    for (std::size_t frame = 0; frame < received.size(); frame++)
+    {
+        const auto expected = frame >= 5 && frame - 5 < length ? impulse[frame - 5] : 0.0f;
+
+        BOOST_CHECK_MESSAGE(std::abs(received[frame] - expected) < 1e-6f, "frame=" << frame << " received=" << received[frame]);
+    }
+
+    stopObject(convolver);
+    unlinkPorts(output, convolverInput);
+    unlinkPorts(convolverOutput, input);
+}
@@ -0,0 +1,682 @@
+/* Copyright 2023 Tyler Riddle
+ *
+ * This file is part of Clypsalot. Clypsalot is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation, either version 3 of the License,
+ * or (at your option) any later version. Clypsalot is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with Clypsalot. If not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+
+#include <atomic>
+#include <cmath>
+#include <cstdlib>
+#include <new>
+#include <vector>
+
+#include <clypsalot/catalog.hxx>
+#include <clypsalot/compressor.hxx>
+#include <clypsalot/dynamics.hxx>
+#include <clypsalot/error.hxx>
+#include <clypsalot/gate.hxx>
+#include <clypsalot/pcm.hxx>
+#include <clypsalot/property.hxx>
+
+#include "test/lib/test.hxx"
+#include "test/module/object.hxx"
+
+using namespace Clypsalot;
+
+static std::atomic_size_t allocations = 0;
+
+void* operator new(const std::size_t size)
+{
+    allocations++;
+
+    if (const auto pointer = std::malloc(size ? size : 1)) return pointer;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* pointer) noexcept
+{
+    std::free(pointer);
+}
+
+void operator delete(void* pointer, const std::size_t) noexcept
+{
+    std::free(pointer);
+}
+
+TEST_MAIN_FUNCTION
+
+static constexpr double rate = 48000;
+static const auto allLevels = { SimdLevel::scalar, SimdLevel::sse2, SimdLevel::avx2, SimdLevel::avx512 };
+
+static float& sample(PcmBuffer& in_buffer, const std::size_t in_channel, const std::size_t in_frame)
+{
+    if (in_buffer.layout() == PcmLayout::planar) return in_buffer.channel<float>(in_channel)[in_frame];
+
+    const auto lanes = in_buffer.lanes();
+
+    return in_buffer.group<float>(in_channel / lanes)[in_frame * lanes + in_channel % lanes];
+}
+
+// Bursts of a sine that are louder on the higher channels.
+static float signal(const std::size_t in_channel, const std::size_t in_frame)
+{
+    const auto burst = (in_frame / 500) % 2 ? 1.0f : 0.05f;
+
+    return burst * (0.2f + 0.1f * in_channel) * std::sin(in_frame * 0.05f + in_channel);
+}
+
+static float decibels(const double in_gain)
+{
+    return 20 * std::log10(in_gain);
+}
+
+// A compressor in double precision with the exact curve and the library's log10() and pow().
+static std::vector<double> reference(const CompressorSettings& in_settings, const std::vector<double>& in_input)
+{
+    const auto coefficient = [](const double milliseconds) { return milliseconds > 0 ? std::exp(-1000 / (milliseconds * rate)) : 0; };
+    const auto& s = in_settings;
+    const auto attack = coefficient(s.attack);
+    const auto release = coefficient(s.release);
+    const auto rms = coefficient(s.rmsWindow);
+    std::vector<double> output;
+    double envelope = 0;
+    double power = 0;
+
+    for (const auto x : in_input)
+    {
+        power = x * x + rms * (power - x * x);
+
+        const auto level = s.detector == CompressorDetector::rms ? 10 * std::log10(std::max(power, 1e-20)) : 20 * std::log10(std::max(std::abs(x), 1e-20));
+        const auto over = level - s.threshold;
+        const auto ratioFactor = 1 - 1.0 / s.ratio;
+        double target = 0;
+
+        if (2 * over >= s.knee) target = ratioFactor * over;
+        else if (2 * over > -s.knee) target = ratioFactor * (over + s.knee / 2) * (over + s.knee / 2) / (2 * s.knee);
+
+        envelope = target + (target > envelope ? attack : release) * (envelope - target);
+        output.push_back(x * std::pow(10, (s.makeup - envelope) / 20));
+    }
+
+    return output;
+}
+
+// A gate that works one channel at a time with the same arithmetic as the kernels.
+static std::vector<float> gateReference(const GateSettings& in_settings, const std::vector<float>& in_input)
+{
+    const auto& s = in_settings;
+    const auto floor = std::pow(10.0f, s.range / 20);
+    const auto step = [&](const float milliseconds) { return milliseconds > 0 ? static_cast<float>((1 - floor) / (milliseconds * rate / 1000)) : INFINITY; };
+    const auto open = std::pow(10.0f, s.threshold / 20);
+    const auto close = std::pow(10.0f, (s.threshold - s.hysteresis) / 20);
+    const auto holdFrames = std::round(s.hold * rate / 1000);
+    std::vector<float> output;
+    auto gain = floor;
+    auto isOpen = false;
+    double hold = 0;
+
+    for (const auto x : in_input)
+    {
+        const auto level = std::abs(x);
+
+        if (level >= close) hold = holdFrames;
+        else if (hold > 0) hold--;
+
+        isOpen = level >= open || (isOpen && (level >= close || hold > 0));
+
+        const auto target = isOpen ? 1.0f : floor;
+
+        if (target > gain) gain = std::min(gain + step(s.attack), target);
+        else gain = std::max(gain - step(s.release), target);
+
+        output.push_back(x * gain);
+    }
+
+    return output;
+}
+
+TEST_CASE(PcmCompressor_static_curve)
+{
+    constexpr std::size_t channels = 3;
+    constexpr std::size_t frames = 64;
+    // Attack and release of 0 follow the curve with out smoothing.
+    const auto instant = [](const float threshold, const float ratio, const float knee, const float makeup) {
+        CompressorSettings settings;
+
+        settings.threshold = threshold;
+        settings.ratio = ratio;
+        settings.knee = knee;
+        settings.makeup = makeup;
+        settings.attack = 0;
+        settings.release = 0;
+        settings.rmsWindow = 0;
+
+        return settings;
+    };
+    // The input is -6.02 dB.
+    const struct
+    {
+        CompressorSettings settings;
+        float gain;
+    } cases[] = {
+        { instant(-20, 4, 0, 0), -0.75f * (decibels(0.5) + 20) },
+        { instant(-20, 4, 6, 0), -0.75f * (decibels(0.5) + 20) },
+        { instant(-8, 4, 6, 0), -0.75f * std::pow(decibels(0.5) + 8 + 3, 2.0f) / 12 },
+        { instant(0, 4, 6, 3), 3 },
+        { instant(-20, 1000, 0, 0), -0.999f * (decibels(0.5) + 20) },
+    };
+
+    for (const auto level : allLevels)
+    {
+        for (const auto detector : { CompressorDetector::peak, CompressorDetector::rms })
+        {
+            for (const auto& test : cases)
+            {
+                PcmCompressor compressor(channels, rate, 0, level);
+                PcmBuffer buffer(PcmFormat::float32, channels, frames, compressor.layout());
+                auto settings = test.settings;
+
+                settings.detector = detector;
+                compressor.settings(settings);
+
+                for (std::size_t channel = 0; channel < channels; channel++)
+                {
+                    for (std::size_t frame = 0; frame < frames; frame++) sample(buffer, channel, frame) = channel == 1 ? -0.5f : 0.5f;
+                }
+
+                compressor.process(buffer, frames);
+
+                const auto output = std::abs(sample(buffer, 1, frames - 1));
+
+                BOOST_CHECK_MESSAGE(std::abs(decibels(output / 0.5f) - test.gain) < 1e-3f, "level=" << level << " detector=" << detector << " gain=" << decibels(output / 0.5f) << " expected=" << test.gain);
+                BOOST_CHECK(std::abs(compressor.gainReduction() - std::max(-test.gain, 0.0f)) < 1e-3f);
+            }
+        }
+    }
+
+    BOOST_CHECK_THROW(PcmCompressor(0, rate, 0), ValueError);
+    BOOST_CHECK_THROW(PcmCompressor(1, 0, 0), ValueError);
+    BOOST_CHECK_THROW(PcmCompressor(1, rate, 0).settings(instant(-20, 0.5f, 0, 0)), ValueError);
+    BOOST_CHECK_THROW(PcmCompressor(1, rate, 0).settings(instant(-20, 4, -1, 0)), ValueError);
+    BOOST_CHECK(stringToCompressorDetector("rms") == CompressorDetector::rms);
+    BOOST_CHECK_THROW(stringToCompressorDetector("loudness"), ValueError);
+}
+
+// Channel counts that leave a partly filled group for every level.
+TEST_CASE(PcmCompressor_reference)
+{
+    constexpr std::size_t frames = 3000;
+    constexpr std::size_t blockSize = 256;
+
+    for (const auto detector : { CompressorDetector::peak, CompressorDetector::rms })
+    {
+        CompressorSettings settings;
+        std::vector<std::vector<float>> results;
+
+        settings.detector = detector;
+        settings.attack = 1;
+        settings.release = 20;
+        settings.makeup = 2;
+
+        for (const auto channels : { 1, 5, 13 })
+        {
+            for (const auto level : allLevels)
+            {
+                PcmCompressor compressor(channels, rate, 0, level);
+                PcmBuffer buffer(PcmFormat::float32, channels, blockSize, compressor.layout());
+                std::vector<float> result;
+                double error = 0;
+
+                compressor.settings(settings);
+
+                for (std::size_t block = 0; block * blockSize < frames; block++)
+                {
+                    const auto count = std::min(blockSize, frames - block * blockSize);
+
+                    for (std::size_t channel = 0; channel < static_cast<std::size_t>(channels); channel++)
+                    {
+                        for (std::size_t frame = 0; frame < count; frame++) sample(buffer, channel, frame) = signal(channel, block * blockSize + frame);
+                    }
+
+                    compressor.process(buffer, count);
+
+                    for (std::size_t channel = 0; channel < static_cast<std::size_t>(channels); channel++)
+                    {
+                        for (std::size_t frame = 0; frame < count; frame++) result.push_back(sample(buffer, channel, frame));
+                    }
+                }
+
+                for (std::size_t channel = 0; channel < static_cast<std::size_t>(channels); channel++)
+                {
+                    std::vector<double> input;
+
+                    for (std::size_t frame = 0; frame < frames; frame++) input.push_back(signal(channel, frame));
+
+                    const auto expected = reference(settings, input);
+
+                    for (std::size_t frame = 0; frame < frames; frame++)
+                    {
+                        const auto block = frame / blockSize;
+                        const auto count = std::min(blockSize, frames - block * blockSize);
+                        const auto actual = result[block * blockSize * channels + channel * count + frame % blockSize];
+
+                        error = std::max(error, std::abs(actual - expected[frame]));
+                    }
+                }
+
+                BOOST_CHECK_MESSAGE(error < 1e-5, "channels=" << channels << " level=" << level << " detector=" << detector << " error=" << error);
+
+                if (channels == 13) results.push_back(result);
+            }
+        }
+
+        // Every level rounds the same way.
+        for (const auto& result : results) BOOST_CHECK(result == results.front());
+    }
+}
+
+TEST_CASE(PcmCompressor_lookahead)
+{
+    constexpr std::size_t channels = 6;
+    constexpr std::size_t lookahead = 16;
+    // Blocks that are not a multiple of the delay so it wraps in the middle of a block.
+    constexpr std::size_t blockSize = 10;
+
+    for (const auto level : allLevels)
+    {
+        PcmCompressor compressor(channels, rate, lookahead, level);
+        PcmBuffer buffer(PcmFormat::float32, channels, blockSize, compressor.layout());
+        std::size_t mismatches = 0;
+
+        BOOST_CHECK(compressor.latency() == lookahead);
+
+        // Nothing is over the threshold so the output is the delayed input.
+        for (std::size_t block = 0; block < 10; block++)
+        {
+            for (std::size_t channel = 0; channel < channels; channel++)
+            {
+                for (std::size_t frame = 0; frame < blockSize; frame++) sample(buffer, channel, frame) = signal(channel, block * blockSize + frame) * 0.1f;
+            }
+
+            compressor.process(buffer, blockSize);
+
+            for (std::size_t channel = 0; channel < channels; channel++)
+            {
+                for (std::size_t frame = 0; frame < blockSize; frame++)
+                {
+                    const auto position = block * blockSize + frame;
+                    const auto expected = position < lookahead ? 0.0f : signal(channel, position - lookahead) * 0.1f;
+
+                    if (sample(buffer, channel, frame) != expected) mismatches++;
+                }
+            }
+        }
+
+        BOOST_CHECK(mismatches == 0);
+
+        compressor.reset();
+        compressor.process(buffer, blockSize);
+        BOOST_CHECK(sample(buffer, 0, 0) == 0);
+    }
+}
+
+TEST_CASE(PcmCompressor_sidechain)
+{
+    constexpr std::size_t channels = 2;
+    constexpr std::size_t frames = 64;
+    PcmCompressor compressor(channels, rate, 0);
+    PcmBuffer key(PcmFormat::float32, channels, frames, compressor.layout());
+    PcmBuffer buffer(PcmFormat::float32, channels, frames, compressor.layout());
+    CompressorSettings settings;
+
+    settings.threshold = -20;
+    settings.knee = 0;
+    settings.attack = 0;
+    compressor.settings(settings);
+
+    // A quiet signal is reduced by as much as a loud key is over the threshold.
+    for (std::size_t frame = 0; frame < frames; frame++)
+    {
+        sample(key, 0, frame) = 1;
+        sample(key, 1, frame) = 0;
+        sample(buffer, 0, frame) = 0.01f;
+        sample(buffer, 1, frame) = 0.01f;
+    }
+
+    compressor.process(key, buffer, frames);
+    BOOST_CHECK(std::abs(decibels(sample(buffer, 0, frames - 1) / 0.01f) + 15) < 1e-3f);
+    BOOST_CHECK(sample(buffer, 1, frames - 1) == 0.01f);
+    BOOST_CHECK(std::abs(compressor.gainReduction() - 15) < 1e-3f);
+}
+
+TEST_CASE(CompressorObject_process)
+{
+    constexpr std::size_t channels = 8;
+    constexpr std::size_t blockSize = 128;
+    constexpr std::size_t periods = 100;
+    auto compressor = objectCatalog().make(CompressorObject::kindName);
+    auto source = TestObject::make();
+    auto sink = TestObject::make();
+    std::scoped_lock lock(*compressor, *source, *sink);
+    auto& output = source->publicAddOutput<PcmOutputPort>("output");
+    auto& key = source->publicAddOutput<PcmOutputPort>("key");
+    auto& input = sink->publicAddInput<PcmInputPort>("input");
+
+    output.config({ PcmFormat::float32, channels, blockSize, 0, 48000 });
+    key.config({ PcmFormat::float32, channels, blockSize, 0, 48000 });
+    input.config({ PcmFormat::float32, 0, 0, 0, 0 });
+    source->configure();
+    sink->configure();
+    compressor->configure({
+        { "Channels", channels },
+        { "Block Size", blockSize },
+        { "Sidechain", true },
+        { "Lookahead", 1 },
+        { "Threshold", -20 },
+        { "Knee", 0 },
+        { "Attack", 0 },
+    });
+
+    BOOST_CHECK(compressor->property("Latency").sizeValue() == 48);
+    BOOST_CHECK(static_cast<CompressorObject&>(*compressor).latency() == 48);
+
+    auto& compressorInput = static_cast<PcmInputPort&>(compressor->input("input"));
+    auto& sidechainInput = static_cast<PcmInputPort&>(compressor->input("sidechain"));
+    auto& compressorOutput = static_cast<PcmOutputPort&>(compressor->output("output"));
+
+    linkPorts(output, compressorInput);
+    linkPorts(key, sidechainInput);
+    linkPorts(compressorOutput, input);
+    compressor->start();
+
+    std::size_t mismatches = 0;
+    std::size_t before = 0;
+
+    for (std::size_t period = 0; period < periods; period++)
+    {
+        auto& buffer = output.buffer();
+        auto& keyBuffer = key.buffer();
+
+        // The key goes over the threshold by 20 dB half way through.
+        for (std::size_t channel = 0; channel < channels; channel++)
+        {
+            for (std::size_t frame = 0; frame < blockSize; frame++)
+            {
+                buffer.channel<float>(channel)[frame] = 0.25f;
+                keyBuffer.channel<float>(channel)[frame] = period < periods / 2 ? 0.01f : 1;
+            }
+        }
+
+        output.commit(blockSize);
+        key.commit(blockSize);
+
+        // Wait until every block has been created once.
+        if (period == 1) before = allocations.load();
+
+        compressor->schedule();
+        BOOST_REQUIRE(compressor->execute() == ObjectProcessResult::finished);
+        BOOST_REQUIRE(input.frames() == blockSize);
+
+        const auto expected = period < periods / 2 ? 0.25f : 0.25f * std::pow(10.0f, -15.0f / 20);
+
+        if (std::abs(input.buffer().channel<float>(channels - 1)[blockSize - 1] - expected) > 1e-4f) mismatches++;
+
+        input.consume();
+    }
+
+    BOOST_CHECK_EQUAL(allocations.load() - before, 0);
+    BOOST_CHECK(mismatches == 0);
+    BOOST_CHECK(std::abs(compressor->property("Gain Reduction").realValue() - 15) < 1e-3f);
+
+    // A control that is not valid is logged once and the current settings are kept.
+    const auto settings = static_cast<CompressorObject&>(*compressor).compressor().settings();
+
+    compressor->property("Ratio").anyValue(0.5f);
+
+    for (std::size_t period = 0; period < 2; period++)
+    {
+        output.buffer();
+        key.buffer();
+        output.commit(blockSize);
+        key.commit(blockSize);
+        compressor->schedule();
+        BOOST_REQUIRE(compressor->execute() == ObjectProcessResult::finished);
+        input.consume();
+    }
+
+    BOOST_CHECK(static_cast<CompressorObject&>(*compressor).compressor().settings() == settings);
+    BOOST_CHECK(severeLogEvents == 1);
+    severeLogEvents = 0;
+
+    stopObject(compressor);
+    unlinkPorts(output, compressorInput);
+    unlinkPorts(key, sidechainInput);
+    unlinkPorts(compressorOutput, input);
+}
+
+TEST_CASE(PcmGate_reference)
+{
+    constexpr std::size_t frames = 4000;
+    constexpr std::size_t blockSize = 256;
+
+    for (const auto range : { -INFINITY, -30.0f })
+    {
+        GateSettings settings;
+        std::vector<std::vector<float>> results;
+
+        settings.threshold = -20;
+        settings.attack = 1;
+        settings.hold = 5;
+        settings.release = 3;
+        settings.range = range;
+
+        for (const auto channels : { 1, 5, 13 })
+        {
+            for (const auto level : allLevels)
+            {
+                PcmGate gate(channels, rate, level);
+                PcmBuffer buffer(PcmFormat::float32, channels, blockSize, gate.layout());
+                std::vector<float> result;
+                double error = 0;
+
+                gate.settings(settings);
+                gate.reset();
+
+                for (std::size_t block = 0; block * blockSize < frames; block++)
+                {
+                    const auto count = std::min(blockSize, frames - block * blockSize);
+
+                    for (std::size_t channel = 0; channel < static_cast<std::size_t>(channels); channel++)
+                    {
+                        for (std::size_t frame = 0; frame < count; frame++) sample(buffer, channel, frame) = signal(channel, block * blockSize + frame);
+                    }
+
+                    gate.process(buffer, count);
+
+                    for (std::size_t channel = 0; channel < static_cast<std::size_t>(channels); channel++)
+                    {
+                        for (std::size_t frame = 0; frame < count; frame++) result.push_back(sample(buffer, channel, frame));
+                    }
+                }
+
+                for (std::size_t channel = 0; channel < static_cast<std::size_t>(channels); channel++)
+                {
+                    std::vector<float> input;
+
+                    for (std::size_t frame = 0; frame < frames; frame++) input.push_back(signal(channel, frame));
+
+                    const auto expected = gateReference(settings, input);
+
+                    for (std::size_t frame = 0; frame < frames; frame++)
+                    {
+                        const auto block = frame / blockSize;
+                        const auto count = std::min(blockSize, frames - block * blockSize);
+                        const auto actual = result[block * blockSize * channels + channel * count + frame % blockSize];
+
+                        error = std::max(error, static_cast<double>(std::abs(actual - expected[frame])));
+                    }
+                }
+
+                BOOST_CHECK_MESSAGE(error < 1e-6, "channels=" << channels << " level=" << level << " range=" << range << " error=" << error);
+
+                if (channels == 13) results.push_back(result);
+            }
+        }
+
+        // Every level rounds the same way.
+        for (const auto& result : results) BOOST_CHECK(result == results.front());
+    }
+}
+
+TEST_CASE(PcmGate_hysteresis_hold)
+{
+    PcmGate gate(1, rate);
+    PcmBuffer buffer(PcmFormat::float32, 1, 256, gate.layout());
+    GateSettings settings;
+    const auto run = [&](const float value, const std::size_t frames, const bool silent = false)
+    {
+        for (std::size_t frame = 0; frame < frames; frame++) sample(buffer, 0, frame) = value;
+        gate.process(buffer, frames, silent);
+    };
+
+    // Opens at 0.1 and closes below about 0.05 after holding for 48 frames.
+    settings.threshold = -20;
+    settings.hysteresis = 6;
+    settings.attack = 0;
+    settings.hold = 1;
+    settings.release = 0;
+    gate.settings(settings);
+    gate.reset();
+
+    BOOST_CHECK(gate.silent());
+    BOOST_CHECK_THROW(gate.settings({ -20, -1 }), ValueError);
+    BOOST_CHECK_THROW(gate.settings({ -20, 6, 1, 50, 100, 3 }), ValueError);
+    BOOST_CHECK_THROW(gate.settings({ INFINITY }), ValueError);
+
+    run(0.08f, 100);
+    BOOST_CHECK(sample(buffer, 0, 99) == 0);
+    BOOST_CHECK(gate.silent());
+
+    run(0.2f, 100);
+    BOOST_CHECK(sample(buffer, 0, 0) == 0.2f);
+    BOOST_CHECK(! gate.silent());
+
+    // Between the close and open levels the gate stays open for as long as the signal does.
+    run(0.08f, 256);
+    BOOST_CHECK(sample(buffer, 0, 255) == 0.08f);
+
+    run(0.01f, 100);
+    BOOST_CHECK(sample(buffer, 0, 46) == 0.01f);
+    BOOST_CHECK(sample(buffer, 0, 47) == 0);
+    BOOST_CHECK(! gate.silent());
+
+    run(0.01f, 100);
+    BOOST_CHECK(sample(buffer, 0, 0) == 0);
+    BOOST_CHECK(gate.silent());
+
+    // Silent input to a closed gate is not touched.
+    sample(buffer, 0, 0) = 1;
+    gate.process(buffer, 1, true);
+    BOOST_CHECK(sample(buffer, 0, 0) == 1);
+    BOOST_CHECK(gate.silent());
+
+    // A gate that only attenuates is never silent.
+    settings.range = -40;
+    gate.settings(settings);
+    run(0, 100, true);
+    BOOST_CHECK(! gate.silent());
+}
+
+TEST_CASE(GateObject_process)
+{
+    constexpr std::size_t channels = 10;
+    constexpr std::size_t blockSize = 128;
+    auto gate = objectCatalog().make(GateObject::kindName);
+    auto source = TestObject::make();
+    auto sink = TestObject::make();
+    std::scoped_lock lock(*gate, *source, *sink);
+    auto& output = source->publicAddOutput<PcmOutputPort>("output");
+    auto& input = sink->publicAddInput<PcmInputPort>("input");
+
+    output.config({ PcmFormat::float32, channels, blockSize, 0, 48000 });
+    input.config({ PcmFormat::float32, 0, 0, 0, 0 });
+    source->configure();
+    sink->configure();
+    gate->configure({
+        { "Channels", channels },
+        { "Block Size", blockSize },
+        { "Threshold", -20 },
+        { "Hold", 1 },
+        { "Release", 2 },
+    });
+
+    auto& gateInput = static_cast<PcmInputPort&>(gate->input("input"));
+    auto& gateOutput = static_cast<PcmOutputPort&>(gate->output("output"));
+
+    linkPorts(output, gateInput);
+    linkPorts(gateOutput, input);
+    gate->start();
+
+    std::size_t before = 0;
+    std::vector<bool> silent;
+
+    // A loud signal, then quiet noise the gate closes on and then true silence.
+    for (std::size_t period = 0; period < 12; period++)
+    {
+        const auto value = period < 4 ? 0.5f : period < 8 ? 0.001f : 0.0f;
+        auto& buffer = output.buffer();
+
+        for (std::size_t channel = 0; channel < channels; channel++)
+        {
+            for (std::size_t frame = 0; frame < blockSize; frame++) buffer.channel<float>(channel)[frame] = value;
+        }
+
+        output.commit(blockSize, value == 0);
+
+        if (period == 1) before = allocations.load();
+
+        gate->schedule();
+        BOOST_REQUIRE(gate->execute() == ObjectProcessResult::finished);
+        BOOST_REQUIRE(input.frames() == blockSize);
+
+        if (input.silent()) BOOST_CHECK(input.buffer().channel<float>(channels - 1)[blockSize - 1] == 0);
+
+        silent.push_back(input.silent());
+        input.consume();
+    }
+
+    BOOST_CHECK_EQUAL(allocations.load() - before, 0);
+
+    // The hold and release take 144 frames so the gate is closed from the second quiet period.
+    const std::vector<bool> expected = { false, false, false, false, false, false, true, true, true, true, true, true };
+
+    BOOST_CHECK(silent == expected);
+
+    // A control that is not valid is logged once and the current settings are kept.
+    const auto settings = static_cast<GateObject&>(*gate).gate().settings();
+
+    gate->property("Attack").anyValue(-1.0f);
+
+    for (std::size_t period = 0; period < 2; period++)
+    {
+        output.buffer();
+        output.commit(blockSize);
+        gate->schedule();
+        BOOST_REQUIRE(gate->execute() == ObjectProcessResult::finished);
+        input.consume();
+    }
+
+    BOOST_CHECK(static_cast<GateObject&>(*gate).gate().settings() == settings);
+    BOOST_CHECK(severeLogEvents == 1);
+    severeLogEvents = 0;
+
+    stopObject(gate);
+    unlinkPorts(output, gateInput);
+    unlinkPorts(gateOutput, input);
+}
@@ -0,0 +1,319 @@
+/* Copyright 2023 Tyler Riddle
+ *
+ * This file is part of Clypsalot. Clypsalot is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation, either version 3 of the License,
+ * or (at your option) any later version. Clypsalot is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with Clypsalot. If not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <clypsalot/catalog.hxx>
+#include <clypsalot/error.hxx>
+#include <clypsalot/filesource.hxx>
+#include <clypsalot/pcm.hxx>
+#include <clypsalot/property.hxx>
+#include <clypsalot/util.hxx>
+#include <clypsalot/wav.hxx>
+
+#include "test/lib/test.hxx"
+#include "test/module/object.hxx"
+
+using namespace Clypsalot;
+
+TEST_MAIN_FUNCTION
+
+using Bytes = std::vector<std::byte>;
+
+static void append(Bytes& io_bytes, const std::string& in_tag)
+{
+    for (const auto character : in_tag) io_bytes.push_back(static_cast<std::byte>(character));
+}
+
+static void append(Bytes& io_bytes, const std::uint64_t in_value, const std::size_t in_size)
+{
+    for (std::size_t i = 0; i < in_size; i++) io_bytes.push_back(static_cast<std::byte>(in_value >> (i * 8)));
+}
+
+static void appendFormat(Bytes& io_bytes, const std::uint16_t in_tag, const std::size_t in_channels, const std::size_t in_bits)
+{
+    append(io_bytes, "fmt ");
+    append(io_bytes, 16, 4);
+    append(io_bytes, in_tag, 2);
+    append(io_bytes, in_channels, 2);
+    append(io_bytes, 48000, 4);
+    append(io_bytes, 48000 * in_channels * in_bits / 8, 4);
+    append(io_bytes, in_channels * in_bits / 8, 2);
+    append(io_bytes, in_bits, 2);
+}
+
+// A WAV file with the samples starting at the given offset which must leave room for the header.
+static Bytes makeWav(const std::uint16_t in_tag, const std::size_t in_channels, const std::size_t in_bits, const Bytes& in_samples, const std::size_t in_dataOffset = 44)
+{
+    Bytes bytes;
+
+    append(bytes, "RIFF");
+    append(bytes, 0, 4);
+    append(bytes, "WAVE");
+    appendFormat(bytes, in_tag, in_channels, in_bits);
+
+    if (in_dataOffset > 44)
+    {
+        append(bytes, "JUNK");
+        append(bytes, in_dataOffset - 44 - 8, 4);
+        bytes.resize(in_dataOffset - 8);
+    }
+
+    append(bytes, "data");
+    append(bytes, in_samples.size(), 4);
+    bytes.insert(bytes.end(), in_samples.begin(), in_samples.end());
+
+    return bytes;
+}
+
+template <typename T>
+static Bytes samplesToBytes(const std::vector<T>& in_samples)
+{
+    Bytes bytes(in_samples.size() * sizeof(T));
+
+    std::memcpy(bytes.data(), in_samples.data(), bytes.size());
+    return bytes;
+}
+
+struct TempFile
+{
+    const std::filesystem::path path;
+
+    TempFile(const Bytes& in_bytes) :
+        path(std::filesystem::temp_directory_path() / ("clypsalot-filesource-" + std::to_string(reinterpret_cast<std::uintptr_t>(this))))
+    {
+        std::ofstream file(path, std::ios::binary);
+
+        file.write(reinterpret_cast<const char*>(in_bytes.data()), in_bytes.size());
+    }
+
+    ~TempFile()
+    {
+        std::filesystem::remove(path);
+    }
+};
+
+static ObjectProcessResult step(Object& io_object)
+{
+    io_object.schedule();
+    return io_object.execute();
+}
+
+TEST_CASE(FileSource_catalog)
+{
+    auto object = objectCatalog().make(FileSourceObject::kindName);
+
+    BOOST_CHECK(dynamic_cast<FileSourceObject*>(object.get()) != nullptr);
+}
+
+TEST_CASE(WavInfo_read)
+{
+    const auto wav = makeWav(3, 2, 32, Bytes(10 * 8 + 3));
+    const auto info = readWavInfo(wav.data(), wav.size());
+
+    BOOST_CHECK(isWavFile(wav.data(), wav.size()));
+    BOOST_CHECK(info.container == PcmFileContainer::wav);
+    BOOST_CHECK(info.format == PcmFormat::float32);
+    BOOST_CHECK(info.channels == 2);
+    BOOST_CHECK(info.rate == 48000);
+    BOOST_CHECK(info.dataOffset == 44);
+    BOOST_CHECK(info.frames == 10);
+
+    auto packed = makeWav(1, 1, 24, Bytes(6));
+    BOOST_CHECK(readWavInfo(packed.data(), packed.size()).format == PcmFormat::int24);
+    BOOST_CHECK(readWavInfo(packed.data(), packed.size()).sampleSize == 3);
+
+    // The size of the data chunk says more than is in the file.
+    packed.resize(packed.size() - 3);
+    BOOST_CHECK(readWavInfo(packed.data(), packed.size()).frames == 1);
+
+    const auto unsupported = makeWav(1, 1, 8, Bytes(4));
+    BOOST_CHECK_THROW(readWavInfo(unsupported.data(), unsupported.size()), ValueError);
+    BOOST_CHECK_THROW(readWavInfo(wav.data(), 40), ValueError);
+    BOOST_CHECK(isWavFile(wav.data() + 4, wav.size() - 4) == false);
+}
+
+TEST_CASE(WavInfo_rf64)
+{
+    Bytes bytes;
+
+    append(bytes, "RF64");
+    append(bytes, 0xffffffff, 4);
+    append(bytes, "WAVE");
+    append(bytes, "ds64");
+    append(bytes, 28, 4);
+    append(bytes, 0, 8);
+    append(bytes, 4 * 6, 8);
+    append(bytes, 6, 8);
+    append(bytes, 0, 4);
+    // An extensible format chunk with the PCM sub format.
+    append(bytes, "fmt ");
+    append(bytes, 40, 4);
+    append(bytes, 0xfffe, 2);
+    append(bytes, 2, 2);
+    append(bytes, 48000, 4);
+    append(bytes, 48000 * 4, 4);
+    append(bytes, 4, 2);
+    append(bytes, 16, 2);
+    append(bytes, 22, 2);
+    append(bytes, 16, 2);
+    append(bytes, 3, 4);
+    append(bytes, 1, 2);
+    bytes.resize(bytes.size() + 14);
+    append(bytes, "data");
+    append(bytes, 0xffffffff, 4);
+    bytes.resize(bytes.size() + 4 * 6 + 4);
+
+    const auto info = readWavInfo(bytes.data(), bytes.size());
+
+    BOOST_CHECK(info.container == PcmFileContainer::rf64);
+    BOOST_CHECK(info.format == PcmFormat::int16);
+    BOOST_CHECK(info.frames == 6);
+    BOOST_CHECK(makeString(info.container) == "rf64");
+}
+
+TEST_CASE(FileSource_copy)
+{
+    std::vector<std::int16_t> samples;
+
+    for (std::int16_t frame = 0; frame < 20; frame++)
+    {
+        samples.push_back(frame);
+        samples.push_back(-frame);
+    }
+
+    TempFile file(makeWav(1, 2, 16, samplesToBytes(samples)));
+    auto source = FileSourceObject::make();
+    auto sink = TestObject::make();
+    std::scoped_lock lock(*source, *sink);
+    auto& input = sink->publicAddInput<PcmInputPort>("input");
+
+    input.config({ PcmFormat::int16 });
+    source->configure({ { "File", file.path }, { "Block Size", 8 } });
+    sink->configure();
+
+    BOOST_CHECK(source->zeroCopy() == false);
+    BOOST_CHECK(source->info().frames == 20);
+
+    linkPorts(source->output("output"), input);
+    source->start();
+
+    for (const std::size_t frames : { 8, 8, 4 })
+    {
+        const auto offset = source->position();
+
+        BOOST_CHECK(source->ready());
+        BOOST_CHECK(step(*source) == ObjectProcessResult::finished);
+        BOOST_CHECK(input.frames() == frames);
+        BOOST_CHECK(input.block().borrowed() == false);
+
+        const auto& buffer = input.buffer();
+
+        for (std::size_t frame = 0; frame < frames; frame++)
+        {
+            BOOST_CHECK(buffer.channel<std::int16_t>(0)[frame] == static_cast<std::int16_t>(offset + frame));
+            BOOST_CHECK(buffer.channel<std::int16_t>(1)[frame] == -static_cast<std::int16_t>(offset + frame));
+        }
+
+        input.consume();
+    }
+
+    BOOST_CHECK(step(*source) == ObjectProcessResult::endOfData);
+}
+
+TEST_CASE(FileSource_zero_copy)
+{
+    std::vector<float> samples;
+
+    for (std::size_t sample = 0; sample < 8 * 40; sample++) samples.push_back(sample);
+
+    TempFile file(makeWav(3, 8, 32, samplesToBytes(samples), 128));
+    auto source = FileSourceObject::make();
+    auto sink = TestObject::make();
+    std::scoped_lock lock(*source, *sink);
+    auto& input = sink->publicAddInput<PcmInputPort>("input");
+
+    input.config({ PcmFormat::float32, 0, 0, 0, 0, PcmLayout::grouped8 });
+    source->configure({ { "File", file.path }, { "Block Size", 16 } });
+    sink->configure();
+
+    BOOST_CHECK(source->zeroCopy());
+
+    auto& output = static_cast<PcmOutputPort&>(source->output("output"));
+
+    BOOST_CHECK(output.config().layout == PcmLayout::grouped8);
+
+    linkPorts(output, input);
+    source->start();
+
+    for (const std::size_t frames : { 16, 16, 8 })
+    {
+        const auto offset = source->position();
+
+        BOOST_CHECK(step(*source) == ObjectProcessResult::finished);
+        BOOST_CHECK(input.frames() == frames);
+        // The short block at the end is copied.
+        BOOST_CHECK(input.block().borrowed() == (frames == 16));
+
+        const auto group = input.buffer().group<float>(0);
+
+        for (std::size_t sample = 0; sample < frames * 8; sample++)
+        {
+            BOOST_CHECK(group[sample] == offset * 8 + sample);
+        }
+
+        input.consume();
+    }
+
+    BOOST_CHECK(output.pool().inFlight() == 0);
+    BOOST_CHECK(step(*source) == ObjectProcessResult::endOfData);
+}
+
+TEST_CASE(FileSource_raw)
+{
+    Bytes bytes(4);
+
+    for (const std::int32_t sample : { 1, -1, 0x7fffff, -0x800000, 256, -256 })
+    {
+        append(bytes, static_cast<std::uint32_t>(sample), 3);
+    }
+
+    TempFile file(bytes);
+    auto source = FileSourceObject::make();
+    auto sink = TestObject::make();
+    std::scoped_lock lock(*source, *sink);
+    auto& input = sink->publicAddInput<PcmInputPort>("input");
+
+    input.config({ PcmFormat::int24 });
+    source->configure({ { "File", file.path }, { "Format", "int24" }, { "Channels", 2 }, { "Data Offset", 4 } });
+    sink->configure();
+
+    BOOST_CHECK(source->info().container == PcmFileContainer::raw);
+    BOOST_CHECK(source->info().frames == 3);
+
+    linkPorts(source->output("output"), input);
+    source->start();
+
+    BOOST_CHECK(step(*source) == ObjectProcessResult::finished);
+    BOOST_CHECK(input.frames() == 3);
+    BOOST_CHECK(input.buffer().channel<std::int32_t>(0)[1] == 0x7fffff);
+    BOOST_CHECK(input.buffer().channel<std::int32_t>(1)[1] == -0x800000);
+    BOOST_CHECK(input.buffer().channel<std::int32_t>(1)[0] == -1);
+    BOOST_CHECK(input.buffer().channel<std::int32_t>(1)[2] == -256);
+
+    input.consume();
+}
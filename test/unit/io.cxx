@@ -0,0 +1,437 @@
+/* Copyright 2023 Tyler Riddle
+ *
+ * This file is part of Clypsalot. Clypsalot is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation, either version 3 of the License,
+ * or (at your option) any later version. Clypsalot is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with Clypsalot. If not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <clypsalot/error.hxx>
+#include <clypsalot/io.hxx>
+#include <clypsalot/object.hxx>
+
+#include "test/lib/test.hxx"
+#include "test/module/object.hxx"
+
+using namespace Clypsalot;
+
+TEST_MAIN_FUNCTION
+
+struct Completion
+{
+    std::atomic_size_t count = 0;
+};
+
+static void countCompletion(IoRequest& io_request) noexcept
+{
+    auto& completion = *static_cast<Completion*>(io_request.context);
+
+    completion.count++;
+    completion.count.notify_all();
+}
+
+static void waitForCompletions(Completion& in_completion, const std::size_t in_count)
+{
+    for (auto count = in_completion.count.load(); count < in_count; count = in_completion.count.load())
+    {
+        in_completion.count.wait(count);
+    }
+}
+
+static std::unique_ptr<IoService> makeService(const IoBackend in_backend, const std::size_t in_depth)
+{
+    if (in_backend == IoBackend::threads) return std::make_unique<ThreadIoService>(in_depth);
+
+    try
+    {
+        return std::make_unique<UringIoService>(in_depth);
+    }
+    catch (const RuntimeError&)
+    {
+        return nullptr;
+    }
+}
+
+// Write blocks to a file out of order and read them back.
+static void checkReadWrite(const IoBackend in_backend)
+{
+    const auto service = makeService(in_backend, 16);
+
+    if (! service) return;
+
+    BOOST_CHECK(service->backend() == in_backend);
+
+    const auto path = std::filesystem::temp_directory_path() / "clypsalot-io.bin";
+    const auto fd = open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    constexpr std::size_t blocks = 8;
+    constexpr std::size_t blockSize = 4096;
+    std::vector<std::byte> written(blocks * blockSize);
+    std::vector<std::byte> read(blocks * blockSize);
+    IoRequest requests[blocks];
+    Completion completion;
+
+    BOOST_REQUIRE(fd >= 0);
+
+    for (std::size_t i = 0; i < written.size(); i++)
+    {
+        written[i] = static_cast<std::byte>(i * 7 % 251);
+    }
+
+    for (std::size_t block = 0; block < blocks; block++)
+    {
+        const auto position = (block * 5 % blocks) * blockSize;
+
+        requests[block] = { IoOperation::write, fd, written.data() + position, blockSize, position, countCompletion, &completion };
+        BOOST_REQUIRE(service->submit(requests[block]));
+    }
+
+    waitForCompletions(completion, blocks);
+
+    for (std::size_t block = 0; block < blocks; block++)
+    {
+        BOOST_CHECK(requests[block].result == blockSize);
+        requests[block].operation = IoOperation::read;
+        requests[block].data = read.data() + requests[block].offset;
+        BOOST_REQUIRE(service->submit(requests[block]));
+    }
+
+    waitForCompletions(completion, 2 * blocks);
+
+    BOOST_CHECK(service->inFlight() == 0);
+    BOOST_CHECK(std::memcmp(written.data(), read.data(), written.size()) == 0);
+
+    // Errors come back as negative errno values.
+    requests[0].fd = -1;
+    BOOST_REQUIRE(service->submit(requests[0]));
+    waitForCompletions(completion, 2 * blocks + 1);
+    BOOST_CHECK(requests[0].result == -EBADF);
+
+    close(fd);
+    std::filesystem::remove(path);
+}
+
+// A read from an empty pipe stays in flight until something is written to the pipe.
+static void checkDepth(const IoBackend in_backend)
+{
+    const auto service = makeService(in_backend, 1);
+
+    if (! service) return;
+
+    int pipeFds[2];
+    std::byte buffer[16];
+    IoRequest request { IoOperation::read, -1, buffer, sizeof(buffer), IoRequest::currentOffset, countCompletion, nullptr };
+    IoRequest extra = request;
+    Completion completion;
+
+    BOOST_REQUIRE(pipe(pipeFds) == 0);
+
+    request.fd = pipeFds[0];
+    request.context = &completion;
+    extra.fd = pipeFds[0];
+    extra.context = &completion;
+
+    BOOST_REQUIRE(service->submit(request));
+    BOOST_CHECK(! service->submit(extra));
+    BOOST_CHECK(service->inFlight() == 1);
+    BOOST_CHECK(write(pipeFds[1], "hello", 5) == 5);
+
+    waitForCompletions(completion, 1);
+
+    BOOST_CHECK(request.result == 5);
+    BOOST_CHECK(std::memcmp(buffer, "hello", 5) == 0);
+    BOOST_CHECK(service->submit(extra));
+    BOOST_CHECK(write(pipeFds[1], "!", 1) == 1);
+
+    waitForCompletions(completion, 2);
+
+    close(pipeFds[0]);
+    close(pipeFds[1]);
+}
+
+// A sleep completes once its time has passed or when it is canceled.
+static void checkSleep(const IoBackend in_backend)
+{
+    const auto service = makeService(in_backend, 2);
+
+    if (! service) return;
+
+    using Clock = std::chrono::steady_clock;
+
+    const auto deadline = Clock::now() + std::chrono::milliseconds(20);
+    const auto nanoseconds = [] (const Clock::time_point in_time) { return std::chrono::nanoseconds(in_time.time_since_epoch()).count(); };
+    IoRequest request { IoOperation::sleep, -1, nullptr, 0, static_cast<std::size_t>(nanoseconds(deadline)), countCompletion, nullptr };
+    IoRequest forever = request;
+    Completion completion;
+
+    request.context = &completion;
+    forever.context = &completion;
+    forever.offset = nanoseconds(Clock::now() + std::chrono::hours(1));
+
+    BOOST_REQUIRE(service->submit(request));
+    BOOST_REQUIRE(service->submit(forever));
+    waitForCompletions(completion, 1);
+
+    BOOST_CHECK(Clock::now() >= deadline);
+    BOOST_CHECK(request.result == 0);
+
+    BOOST_CHECK(service->cancel(forever));
+    waitForCompletions(completion, 2);
+    BOOST_CHECK(forever.result == -ECANCELED);
+}
+
+// A futex wait completes when the word is woken, right away if the word already changed or
+// when it is canceled.
+static void checkFutex(IoService& io_service)
+{
+    alignas(4) std::uint32_t word = 0;
+    const auto data = reinterpret_cast<std::byte*>(&word);
+    IoRequest request { IoOperation::futexWait, -1, data, 0, 0, countCompletion, nullptr };
+    IoRequest stale = request;
+    IoRequest canceled = request;
+    Completion completion;
+
+    request.context = &completion;
+    stale.context = &completion;
+    stale.offset = 1;
+    canceled.context = &completion;
+
+    BOOST_REQUIRE(io_service.submit(stale));
+    waitForCompletions(completion, 1);
+    BOOST_CHECK(stale.result == -EAGAIN);
+
+    BOOST_REQUIRE(io_service.submit(request));
+    BOOST_REQUIRE(io_service.submit(canceled));
+    BOOST_CHECK(io_service.cancel(canceled));
+    waitForCompletions(completion, 2);
+    BOOST_CHECK(canceled.result == -ECANCELED);
+
+    std::atomic_ref(word).store(1);
+
+    // The waiter may not have reached the kernel yet in which case it sees the new value.
+    while (completion.count.load() < 3)
+    {
+        syscall(SYS_futex, &word, FUTEX_WAKE, 1, nullptr, nullptr, 0);
+        std::this_thread::yield();
+    }
+
+    BOOST_CHECK(request.result == 0 || request.result == -EAGAIN);
+    BOOST_CHECK(io_service.inFlight() == 0);
+}
+
+TEST_CASE(IoService_uring)
+{
+    checkReadWrite(IoBackend::uring);
+    checkDepth(IoBackend::uring);
+    checkSleep(IoBackend::uring);
+
+    if (const auto service = makeService(IoBackend::uring, 4)) checkFutex(*service);
+}
+
+// Kernels that io_uring can not wait on futexes with still use it for everything else.
+TEST_CASE(IoService_uring_threaded_futex)
+{
+    std::unique_ptr<UringIoService> service;
+
+    try
+    {
+        service = std::make_unique<UringIoService>(4, false);
+    }
+    catch (const RuntimeError&)
+    {
+        return;
+    }
+
+    BOOST_CHECK(service->backend() == IoBackend::uring);
+    BOOST_CHECK(service->threadedFutexWait());
+    checkFutex(*service);
+}
+
+TEST_CASE(IoService_threads)
+{
+    checkReadWrite(IoBackend::threads);
+    checkDepth(IoBackend::threads);
+    checkSleep(IoBackend::threads);
+    checkFutex(*makeService(IoBackend::threads, 4));
+}
+
+TEST_CASE(IoService_make)
+{
+    const auto service = IoService::make(IoBackend::threads, 4);
+
+    BOOST_CHECK(service->backend() == IoBackend::threads);
+    BOOST_CHECK(service->depth() == 4);
+    BOOST_CHECK(ioService().depth() == IoService::defaultDepth);
+}
+
+static void recordPosition(void* io_context, const std::size_t in_position) noexcept
+{
+    *static_cast<std::size_t*>(io_context) = in_position;
+}
+
+// Everything that goes through the ring ends up in the file after the starting position.
+TEST_CASE(RingWriter_write)
+{
+    const auto path = std::filesystem::temp_directory_path() / "clypsalot-ring-writer.bin";
+    const auto fd = open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    constexpr std::size_t start = 4096;
+    constexpr std::size_t pieces = 100;
+    constexpr std::size_t pieceSize = 1000;
+    std::vector<std::byte> written(pieces * pieceSize);
+    std::vector<std::byte> read(written.size());
+    std::size_t end = 0;
+
+    BOOST_REQUIRE(fd >= 0);
+
+    for (std::size_t i = 0; i < written.size(); i++)
+    {
+        written[i] = static_cast<std::byte>(i * 7 % 251);
+    }
+
+    {
+        RingWriter writer(fd, 16 * 4096, start, 4 * 4096, 4096, recordPosition, &end);
+
+        for (std::size_t piece = 0; piece < pieces; piece++)
+        {
+            while (! writer.ring().write(written.data() + piece * pieceSize, pieceSize))
+            {
+                std::this_thread::yield();
+            }
+
+            writer.commit();
+        }
+
+        writer.finish(true);
+        writer.wait();
+
+        BOOST_CHECK(writer.error() == 0);
+        BOOST_CHECK(writer.position() == start + written.size());
+        BOOST_CHECK(writer.ring().size() == 0);
+    }
+
+    BOOST_CHECK(end == start + written.size());
+    BOOST_CHECK(pread(fd, read.data(), read.size(), start) == static_cast<ssize_t>(read.size()));
+    BOOST_CHECK(std::memcmp(written.data(), read.data(), written.size()) == 0);
+
+    close(fd);
+    std::filesystem::remove(path);
+}
+
+/*
+ * Reads a pipe by blocking until the read completes. The completion wakes the Object so it is
+ * processed again without anything else scheduling it.
+ */
+class PipeReaderObject : public TestObject
+{
+    IoRequest m_request;
+    std::byte m_buffer[16];
+    bool m_pending = false;
+    bool m_complete = false;
+
+    static void readComplete(IoRequest& io_request) noexcept
+    {
+        auto& object = *static_cast<PipeReaderObject*>(io_request.context);
+        std::scoped_lock lock(object);
+
+        object.m_pending = false;
+        object.m_complete = true;
+        wakeObject(object);
+    }
+
+    public:
+    std::size_t blocks = 0;
+    std::size_t reads = 0;
+
+    static std::shared_ptr<PipeReaderObject> make(const int in_fd)
+    {
+        auto object = _makeObject<PipeReaderObject>(TestObject::kindName);
+
+        object->m_request = { IoOperation::read, in_fd, object->m_buffer, sizeof(m_buffer), IoRequest::currentOffset, readComplete, object.get() };
+        return object;
+    }
+
+    PipeReaderObject(const std::string& in_kind) :
+        TestObject(in_kind)
+    { }
+
+    bool pending() const noexcept
+    {
+        return m_pending;
+    }
+
+    virtual bool ready() const noexcept override
+    {
+        return ! m_pending && TestObject::ready();
+    }
+
+    virtual ObjectProcessResult process() override
+    {
+        if (m_complete)
+        {
+            m_complete = false;
+            reads++;
+            return ObjectProcessResult::finished;
+        }
+
+        if (! ioService().submit(m_request)) return ObjectProcessResult::finished;
+
+        m_pending = true;
+        blocks++;
+        return ObjectProcessResult::blocked;
+    }
+};
+
+TEST_CASE(Object_blocked_on_io)
+{
+    int pipeFds[2];
+
+    BOOST_REQUIRE(pipe(pipeFds) == 0);
+
+    auto object = PipeReaderObject::make(pipeFds[0]);
+
+    {
+        std::scoped_lock lock(*object);
+
+        object->configure();
+        startObject(object);
+    }
+
+    BOOST_REQUIRE(waitUntil(*object, [&] { return object->pending() && object->state() == ObjectState::waiting; }));
+
+    {
+        std::scoped_lock lock(*object);
+
+        BOOST_CHECK(object->blocks == 1);
+        BOOST_CHECK(! object->ready());
+    }
+
+    BOOST_CHECK(write(pipeFds[1], "x", 1) == 1);
+    BOOST_REQUIRE(waitUntil(*object, [&] { return object->reads == 1 && object->state() == ObjectState::waiting; }));
+
+    {
+        std::scoped_lock lock(*object);
+
+        BOOST_CHECK(object->blocks == 1);
+        stopObject(object);
+    }
+
+    close(pipeFds[0]);
+    close(pipeFds[1]);
+}
@@ -0,0 +1,105 @@
+/* Copyright 2023 Tyler Riddle
+ *
+ * This file is part of Clypsalot. Clypsalot is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation, either version 3 of the License,
+ * or (at your option) any later version. Clypsalot is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with Clypsalot. If not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#include <clypsalot/memory.hxx>
+
+#include "test/lib/test.hxx"
+
+using namespace Clypsalot;
+
+TEST_MAIN_FUNCTION
+
+TEST_CASE(PageMapping_small)
+{
+    const auto before = memoryStatistics();
+
+    {
+        PageMapping mapping(100);
+
+        BOOST_CHECK(mapping.data() != nullptr);
+        BOOST_CHECK(mapping.bytes() >= 100);
+        BOOST_CHECK(mapping.kind() == PageKind::normal);
+        BOOST_CHECK(mapping.data()[99] == std::byte(0));
+
+        const auto during = memoryStatistics();
+
+        BOOST_CHECK(during.mappings == before.mappings + 1);
+        BOOST_CHECK(during.bytes == before.bytes + mapping.bytes());
+    }
+
+    BOOST_CHECK(memoryStatistics().mappings == before.mappings);
+    BOOST_CHECK(memoryStatistics().bytes == before.bytes);
+}
+
+TEST_CASE(PageMapping_huge)
+{
+    PageMapping mapping(hugePageSize + 1);
+
+    BOOST_CHECK(mapping.bytes() == 2 * hugePageSize);
+    BOOST_CHECK(reinterpret_cast<std::uintptr_t>(mapping.data()) % hugePageSize == 0);
+    mapping.data()[mapping.bytes() - 1] = std::byte(1);
+
+    const auto statistics = memoryStatistics();
+
+    if (mapping.kind() == PageKind::huge) BOOST_CHECK(statistics.hugeBytes >= mapping.bytes());
+    else if (mapping.kind() == PageKind::transparent) BOOST_CHECK(statistics.transparentBytes >= mapping.bytes());
+
+    PageMapping moved(std::move(mapping));
+
+    BOOST_CHECK(mapping.data() == nullptr);
+    BOOST_CHECK(moved.data()[moved.bytes() - 1] == std::byte(1));
+}
+
+TEST_CASE(PageMapping_empty)
+{
+    PageMapping mapping(0);
+
+    BOOST_CHECK(mapping.data() == nullptr);
+    BOOST_CHECK(mapping.bytes() == 0);
+}
+
+TEST_CASE(ByteRing_wrap)
+{
+    ByteRing ring(1);
+    std::vector<std::byte> bytes(ring.capacity() / 2 + 10, std::byte(1));
+
+    BOOST_CHECK(ring.capacity() > 0);
+    BOOST_CHECK(reinterpret_cast<std::uintptr_t>(ring.peek().data()) % 64 == 0);
+    BOOST_CHECK(ring.write(bytes.data(), bytes.size()));
+    // Writes are all or nothing.
+    BOOST_CHECK(ring.write(bytes.data(), bytes.size()) == false);
+    BOOST_CHECK(ring.size() == bytes.size());
+
+    ring.consume(bytes.size());
+    std::fill(bytes.begin(), bytes.end(), std::byte(2));
+
+    BOOST_CHECK(ring.write(bytes.data(), bytes.size()));
+    BOOST_CHECK(ring.space() == ring.capacity() - bytes.size());
+
+    // The write wrapped around so it is read in two pieces.
+    auto first = ring.peek();
+
+    BOOST_CHECK(first.size() == ring.capacity() - bytes.size());
+    BOOST_CHECK(first.back() == std::byte(2));
+    ring.consume(first.size());
+
+    auto second = ring.peek();
+
+    BOOST_CHECK(second.size() == 20);
+    BOOST_CHECK(second.data() == first.data() - (ring.capacity() - first.size()));
+    ring.consume(second.size());
+    BOOST_CHECK(ring.size() == 0);
+}
@@ -0,0 +1,86 @@
+/* Copyright 2023 Tyler Riddle
+ *
+ * This file is part of Clypsalot. Clypsalot is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation, either version 3 of the License,
+ * or (at your option) any later version. Clypsalot is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with Clypsalot. If not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+
+#include <cmath>
+
+#include <clypsalot/error.hxx>
+#include <clypsalot/mix.hxx>
+
+#include "test/lib/test.hxx"
+
+using namespace Clypsalot;
+
+TEST_MAIN_FUNCTION
+
+TEST_CASE(PcmMatrix_standard)
+{
+    BOOST_CHECK(PcmMatrix::identity(3).isIdentity());
+    BOOST_CHECK(PcmMatrix::standard(4, 4).isIdentity());
+    BOOST_CHECK(PcmMatrix::standard(1, 2).gain(1, 0) == 1);
+    BOOST_CHECK(PcmMatrix::standard(4, 1).gain(0, 3) == 0.25f);
+    BOOST_CHECK(PcmMatrix::standard(6, 2).gain(0, 3) == 0);
+    BOOST_CHECK(PcmMatrix::standard(6, 2).gain(1, 5) > 0.7f);
+    BOOST_CHECK(PcmMatrix::standard(2, 3).gain(2, 0) == 0);
+    BOOST_CHECK(PcmMatrix().empty());
+    BOOST_CHECK_THROW(PcmMatrix(2, 2).gain(2, 0), ValueError);
+    BOOST_CHECK_THROW(PcmMatrix(2, 2).gain(0, 2, 1), ValueError);
+    BOOST_CHECK_THROW(PcmMixer{ PcmMatrix() }, ValueError);
+}
+
+TEST_CASE(PcmMixer_process)
+{
+    // 37 frames leaves a tail for every vector width.
+    constexpr std::size_t frames = 37;
+    PcmBuffer input(PcmFormat::float32, 3, frames);
+    PcmMatrix matrix(3, 3);
+
+    for (std::size_t channel = 0; channel < 3; channel++)
+    {
+        for (std::size_t frame = 0; frame < frames; frame++)
+        {
+            input.channel<float>(channel)[frame] = std::sin(frame * 0.1 + channel);
+        }
+    }
+
+    // Output 0 is a copy, output 1 is a scaled copy, output 2 is a mix of all the inputs.
+    matrix.gain(0, 2, 1);
+    matrix.gain(1, 0, -0.5f);
+    matrix.gain(2, 0, 0.25f);
+    matrix.gain(2, 1, 0.5f);
+    matrix.gain(2, 2, 0.75f);
+
+    for (const auto level : { SimdLevel::scalar, SimdLevel::sse2, SimdLevel::avx2 })
+    {
+        PcmMixer mixer(matrix, level);
+        PcmBuffer output(PcmFormat::float32, 3, frames);
+
+        BOOST_CHECK(mixer.routes() == 5);
+        mixer.process(input, output, frames);
+
+        for (std::size_t frame = 0; frame < frames; frame++)
+        {
+            const auto in0 = input.channel<float>(0)[frame];
+            const auto in1 = input.channel<float>(1)[frame];
+            const auto in2 = input.channel<float>(2)[frame];
+
+            BOOST_CHECK(output.channel<float>(0)[frame] == in2);
+            BOOST_CHECK(output.channel<float>(1)[frame] == in0 * -0.5f);
+            BOOST_CHECK(std::abs(output.channel<float>(2)[frame] - (in0 * 0.25f + in1 * 0.5f + in2 * 0.75f)) < 1e-6f);
+        }
+
+        mixer.matrix(PcmMatrix(3, 3));
+        BOOST_CHECK(mixer.routes() == 0);
+        mixer.process(input, output, frames);
+        BOOST_CHECK(output.channel<float>(2)[frames - 1] == 0);
+        BOOST_CHECK_THROW(mixer.matrix(PcmMatrix(2, 3)), ValueError);
+    }
+}
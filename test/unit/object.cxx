@@ -10,6 +10,7 @@
  * <https://www.gnu.org/licenses/>.
  */
 
+#include <clypsalot/error.hxx>
 #include <clypsalot/logger.hxx>
 #include <clypsalot/macros.hxx>
 #include <clypsalot/property.hxx>
@@ -58,3 +59,35 @@ TEST_CASE(Object_properties)
 
     object->stop();
 }
+
+TEST_CASE(Object_typed_configure)
+{
+    auto prototype = TestObject::make();
+    auto object = TestObject::make();
+    std::scoped_lock lock(*prototype, *object);
+    static const PropertyList configProperties = {
+        { "size", PropertyType::size, Property::Configurable, nullptr },
+        { "name", PropertyType::string, Property::Configurable, nullptr },
+    };
+
+    prototype->publicAddProperties(configProperties);
+    object->publicAddProperties(configProperties);
+
+    BOOST_CHECK_THROW(prototype->compileConfig({{ "size", 10 }}), ObjectStateError);
+    prototype->init();
+    object->init();
+
+    const auto values = prototype->compileConfig({{ "size", 10 }, { "name", "typed" }});
+
+    BOOST_CHECK(values.size() == 2);
+    BOOST_CHECK(std::get<Property::SizeType>(values[0].second) == 10);
+    BOOST_CHECK_THROW(prototype->compileConfig({{ "missing", 1 }}), KeyError);
+
+    object->configure(values);
+    BOOST_CHECK(object->state() == ObjectState::paused);
+    BOOST_CHECK(object->property("size").sizeValue() == 10);
+    BOOST_CHECK(object->property("name").stringValue() == "typed");
+
+    prototype->stop();
+    object->stop();
+}
@@ -0,0 +1,747 @@
+/* Copyright 2023 Tyler Riddle
+ *
+ * This file is part of Clypsalot. Clypsalot is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation, either version 3 of the License,
+ * or (at your option) any later version. Clypsalot is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with Clypsalot. If not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <vector>
+
+#include <clypsalot/catalog.hxx>
+#include <clypsalot/convert.hxx>
+#include <clypsalot/error.hxx>
+#include <clypsalot/mix.hxx>
+#include <clypsalot/pcm.hxx>
+#include <clypsalot/resample.hxx>
+#include <clypsalot/transpose.hxx>
+
+#include "test/lib/test.hxx"
+#include "test/module/object.hxx"
+
+using namespace Clypsalot;
+
+TEST_MAIN_FUNCTION
+
+static bool isAligned(const void* pointer)
+{
+    return reinterpret_cast<std::uintptr_t>(pointer) % pcmAlignment == 0;
+}
+
+TEST_CASE(PcmBuffer_layout)
+{
+    PcmBuffer floats(PcmFormat::float32, 3, 100);
+    PcmBuffer doubles(PcmFormat::float64, 2, 100);
+    PcmBuffer empty;
+
+    BOOST_CHECK(floats.frames() == 100);
+    BOOST_CHECK(floats.stride() == 112);
+    BOOST_CHECK(floats.bytes() == 3 * 112 * sizeof(float));
+    BOOST_CHECK(doubles.stride() == 104);
+    BOOST_CHECK(empty.bytes() == 0);
+
+    for (std::size_t channel = 0; channel < floats.channels(); channel++)
+    {
+        BOOST_CHECK(isAligned(floats.channel<float>(channel)));
+        BOOST_CHECK(floats.channel<float>(channel)[floats.stride() - 1] == 0);
+    }
+
+    for (std::size_t channel = 0; channel < doubles.channels(); channel++)
+    {
+        BOOST_CHECK(isAligned(doubles.channel<double>(channel)));
+    }
+
+    empty = std::move(floats);
+    BOOST_CHECK(empty.channels() == 3);
+    BOOST_CHECK(floats.channels() == 0);
+}
+
+TEST_CASE(PcmPortType_negotiate)
+{
+    auto source = TestObject::make();
+    auto sink = TestObject::make();
+    std::scoped_lock lock(*source, *sink);
+    auto& output = source->publicAddOutput<PcmOutputPort>("output");
+    auto& input = sink->publicAddInput<PcmInputPort>("input");
+
+    BOOST_CHECK(&portTypeCatalog().instance(PcmPortType::typeName) == &PcmPortType::singleton);
+
+    output.config({ PcmFormat::float32, 2, 0 });
+    input.config({ PcmFormat::float32, 0, 128 });
+    source->configure();
+    sink->configure();
+
+    auto link = dynamic_cast<PcmPortLink*>(linkPorts(output, input));
+
+    BOOST_CHECK(link->config() == PcmConfig({ PcmFormat::float32, 2, 128, 1 }));
+    BOOST_CHECK(output.buffer().channels() == 2);
+    BOOST_CHECK(output.buffer().frames() == 128);
+    BOOST_CHECK_THROW(output.config({ PcmFormat::float32, 1, 0 }), RuntimeError);
+    BOOST_CHECK_THROW(input.config({ PcmFormat::float32, 1, 0 }), RuntimeError);
+}
+
+TEST_CASE(PcmPortType_negotiate_errors)
+{
+    auto source = TestObject::make();
+    auto sink = TestObject::make();
+    std::scoped_lock lock(*source, *sink);
+    auto& output = source->publicAddOutput<PcmOutputPort>("output");
+    auto& input = sink->publicAddInput<PcmInputPort>("input");
+    auto& type = PcmPortType::singleton;
+
+    BOOST_CHECK_THROW(type.makeLink(output, input), ValueError);
+
+    output.config({ PcmFormat::float32, 2, 64 });
+    input.config({ PcmFormat::float32, 2, 32 });
+    BOOST_CHECK_THROW(type.makeLink(output, input), ValueError);
+
+    input.config({ PcmFormat::float32, 1, 64 });
+    input.matrix(PcmMatrix(3, 1));
+    BOOST_CHECK_THROW(type.makeLink(output, input), ValueError);
+
+    input.matrix(PcmMatrix());
+    input.config({ PcmFormat::float32, 2, 64 });
+    source->configure();
+    sink->configure();
+    linkPorts(output, input);
+
+    BOOST_CHECK_THROW(type.makeLink(output, input), RuntimeError);
+}
+
+TEST_CASE(PcmPort_transfer)
+{
+    auto source = TestObject::make();
+    auto sink = TestObject::make();
+    std::scoped_lock lock(*source, *sink);
+    auto& output = source->publicAddOutput<PcmOutputPort>("output");
+    auto& input = sink->publicAddInput<PcmInputPort>("input");
+
+    output.config({ PcmFormat::float32, 2, 16 });
+    source->configure();
+    sink->configure();
+    linkPorts(output, input);
+
+    BOOST_CHECK(output.ready());
+    BOOST_CHECK(! input.ready());
+
+    for (std::size_t channel = 0; channel < 2; channel++)
+    {
+        auto samples = output.buffer().channel<float>(channel);
+
+        for (std::size_t frame = 0; frame < 16; frame++)
+        {
+            samples[frame] = channel * 100 + frame;
+        }
+    }
+
+    output.commit(10);
+
+    BOOST_CHECK(! output.ready());
+    BOOST_CHECK(input.ready());
+    BOOST_CHECK(input.frames() == 10);
+    BOOST_CHECK(input.buffer().channel<float>(0)[9] == 9);
+    BOOST_CHECK(input.buffer().channel<float>(1)[9] == 109);
+    BOOST_CHECK(input.buffer().frames() == 16);
+
+    input.consume();
+
+    BOOST_CHECK(output.ready());
+    BOOST_CHECK(! input.ready());
+}
+
+TEST_CASE(PcmPort_fan_out)
+{
+    auto source = TestObject::make();
+    auto sink = TestObject::make();
+    std::scoped_lock lock(*source, *sink);
+    auto& output = source->publicAddOutput<PcmOutputPort>("output");
+    std::vector<PcmInputPort*> inputs;
+
+    output.config({ PcmFormat::float32, 1, 32 });
+
+    for (const auto name : { "input 1", "input 2", "input 3" })
+    {
+        inputs.push_back(&sink->publicAddInput<PcmInputPort>(name));
+    }
+
+    source->configure();
+    sink->configure();
+
+    for (const auto input : inputs)
+    {
+        linkPorts(output, *input);
+    }
+
+    output.buffer().channel<float>(0)[0] = 1;
+    output.commit(32);
+
+    const auto& block = inputs.front()->block();
+
+    BOOST_CHECK(block.useCount() == 3);
+    BOOST_CHECK(output.pool().inFlight() == 1);
+
+    for (const auto input : inputs)
+    {
+        BOOST_CHECK(input->block().shares(block));
+        BOOST_CHECK(input->buffer().channel<float>(0)[0] == 1);
+    }
+
+    auto copy = block.clone();
+
+    copy.channel<float>(0)[0] = 2;
+    BOOST_CHECK(inputs.back()->buffer().channel<float>(0)[0] == 1);
+
+    auto kept = inputs.back()->block();
+
+    for (const auto input : inputs)
+    {
+        input->consume();
+    }
+
+    BOOST_CHECK(output.ready());
+    BOOST_CHECK(kept.useCount() == 1);
+    BOOST_CHECK(output.pool().inFlight() == 1);
+
+    output.buffer();
+    BOOST_CHECK(output.pool().inFlight() == 2);
+    BOOST_CHECK(output.pool().highWater() == 2);
+
+    kept.reset();
+    BOOST_CHECK(output.pool().inFlight() == 1);
+    BOOST_CHECK(output.pool().available() == output.pool().capacity() - 1);
+}
+
+TEST_CASE(PcmBufferPool_recycle)
+{
+    auto pool = PcmBufferPool::make({ PcmFormat::float64, 2, 64 }, 2);
+    auto first = pool->acquire();
+    auto second = pool->acquire();
+
+    BOOST_CHECK(pool->capacity() == 2);
+    BOOST_CHECK(pool->memory().bytes() >= 2 * first->bytes());
+    BOOST_CHECK(first.buffer().format() == PcmFormat::float64);
+    BOOST_CHECK(first.buffer().channels() == 2);
+    BOOST_CHECK_THROW(pool->acquire(), RuntimeError);
+
+    const auto data = first->channel<double>(0);
+
+    first.reset();
+    BOOST_CHECK(pool->available() == 1);
+
+    auto third = pool->acquire();
+
+    BOOST_CHECK(third->channel<double>(0) == data);
+    BOOST_CHECK(pool->inFlight() == 2);
+    BOOST_CHECK(pool->highWater() == 2);
+
+    // Blocks that are in flight keep the pool alive.
+    pool.reset();
+    second.reset();
+    third.reset();
+}
+
+TEST_CASE(PcmPort_depth)
+{
+    auto source = TestObject::make();
+    auto sink = TestObject::make();
+    std::scoped_lock lock(*source, *sink);
+    auto& output = source->publicAddOutput<PcmOutputPort>("output");
+    auto& input = sink->publicAddInput<PcmInputPort>("input");
+
+    output.config({ PcmFormat::float32, 1, 8, 3 });
+    input.config({ PcmFormat::float32, 0, 0, 2 });
+    source->configure();
+    sink->configure();
+
+    auto link = dynamic_cast<PcmPortLink*>(linkPorts(output, input));
+
+    BOOST_CHECK(link->slots() == 3);
+
+    for (std::size_t block = 0; block < 3; block++)
+    {
+        BOOST_CHECK(output.ready());
+        output.buffer().channel<float>(0)[0] = block;
+        output.commit(block + 1);
+        BOOST_CHECK(link->size() == block + 1);
+    }
+
+    BOOST_CHECK(! output.ready());
+
+    for (std::size_t block = 0; block < 3; block++)
+    {
+        BOOST_CHECK(input.ready());
+        BOOST_CHECK(input.frames() == block + 1);
+        BOOST_CHECK(input.buffer().channel<float>(0)[0] == block);
+        input.consume();
+        BOOST_CHECK(output.ready());
+    }
+
+    BOOST_CHECK(! input.ready());
+    BOOST_CHECK(output.pool().inFlight() == 0);
+    BOOST_CHECK(output.pool().highWater() == 3);
+}
+
+
+TEST_CASE(PcmPort_in_place)
+{
+    auto source = TestObject::make();
+    auto filter = TestObject::make();
+    auto sink = TestObject::make();
+    std::scoped_lock lock(*source, *filter, *sink);
+    auto& sourceOutput = source->publicAddOutput<PcmOutputPort>("output");
+    auto& filterInput = filter->publicAddInput<PcmInputPort>("input");
+    auto& filterOutput = filter->publicAddOutput<PcmOutputPort>("output");
+    auto& sinkInput = sink->publicAddInput<PcmInputPort>("input 1");
+    auto& otherInput = sink->publicAddInput<PcmInputPort>("input 2");
+
+    BOOST_CHECK_THROW(filterOutput.inPlace(&sinkInput), ValueError);
+
+    sourceOutput.config({ PcmFormat::float32, 1, 16 });
+    filterOutput.config({ PcmFormat::float32, 1, 16 });
+    filterOutput.inPlace(&filterInput);
+
+    for (const auto& object : { source, filter, sink })
+    {
+        object->configure();
+    }
+
+    linkPorts(sourceOutput, filterInput);
+    linkPorts(filterOutput, sinkInput);
+
+    sourceOutput.buffer().channel<float>(0)[0] = 1;
+    sourceOutput.commit(16);
+
+    const auto data = filterInput.buffer().channel<float>(0);
+    auto& aliased = filterOutput.buffer();
+
+    BOOST_CHECK(filterOutput.aliased());
+    BOOST_CHECK(! filterInput.ready());
+    BOOST_CHECK(aliased.channel<float>(0) == data);
+    aliased.channel<float>(0)[0] *= 2;
+    filterOutput.commit(16);
+
+    BOOST_CHECK(sinkInput.buffer().channel<float>(0)[0] == 2);
+    sinkInput.consume();
+
+    // A second consumer of the source block means the filter has to copy it.
+    linkPorts(sourceOutput, otherInput);
+    sourceOutput.buffer().channel<float>(0)[0] = 3;
+    sourceOutput.commit(16);
+
+    auto& copied = filterOutput.buffer();
+
+    BOOST_CHECK(! filterOutput.aliased());
+    BOOST_CHECK(copied.channel<float>(0) != otherInput.buffer().channel<float>(0));
+    BOOST_CHECK(copied.channel<float>(0)[0] == 3);
+    copied.channel<float>(0)[0] *= 2;
+    filterOutput.commit(16);
+
+    BOOST_CHECK(sinkInput.buffer().channel<float>(0)[0] == 6);
+    BOOST_CHECK(otherInput.buffer().channel<float>(0)[0] == 3);
+}
+
+static void poolChain(const bool in_sinkFirst)
+{
+    auto source = TestObject::make();
+    auto filter = TestObject::make();
+    auto sink = TestObject::make();
+    std::scoped_lock lock(*source, *filter, *sink);
+    auto& sourceOutput = source->publicAddOutput<PcmOutputPort>("output");
+    auto& filterInput = filter->publicAddInput<PcmInputPort>("input");
+    auto& filterOutput = filter->publicAddOutput<PcmOutputPort>("output");
+    auto& sinkInput = sink->publicAddInput<PcmInputPort>("input");
+    constexpr std::size_t sinkDepth = 12;
+
+    sourceOutput.config({ PcmFormat::float32, 1, 16 });
+    filterOutput.config({ PcmFormat::float32, 1, 16 });
+    sinkInput.config({ PcmFormat::float32, 0, 0, sinkDepth });
+    filterOutput.inPlace(&filterInput);
+
+    for (const auto& object : { source, filter, sink })
+    {
+        object->configure();
+    }
+
+    if (in_sinkFirst) linkPorts(filterOutput, sinkInput);
+    linkPorts(sourceOutput, filterInput);
+    if (! in_sinkFirst) linkPorts(filterOutput, sinkInput);
+
+    // Every block is handed down to the sink so the pool of the source is sized past its
+    // default capacity to fill the deeper link after the filter when the ports are linked.
+    auto& pool = sourceOutput.pool();
+    const auto capacity = pool.capacity();
+
+    BOOST_CHECK(capacity > PcmBufferPool::defaultCapacity);
+
+    for (std::size_t block = 0; block < sinkDepth; block++)
+    {
+        BOOST_REQUIRE(sourceOutput.ready());
+        sourceOutput.buffer().channel<float>(0)[0] = block;
+        sourceOutput.commit(16);
+
+        BOOST_REQUIRE(filterOutput.ready());
+        filterOutput.buffer();
+        BOOST_CHECK(filterOutput.aliased());
+        filterOutput.commit(16);
+    }
+
+    // Processing only takes blocks from the pool that was there before.
+    BOOST_CHECK(&sourceOutput.pool() == &pool);
+    BOOST_CHECK(pool.capacity() == capacity);
+    BOOST_CHECK(! filterOutput.ready());
+
+    for (std::size_t block = 0; block < sinkDepth; block++)
+    {
+        BOOST_CHECK(sinkInput.buffer().channel<float>(0)[0] == block);
+        sinkInput.consume();
+    }
+
+    BOOST_CHECK(filterOutput.ready());
+}
+
+TEST_CASE(PcmPort_pool_chain)
+{
+    poolChain(false);
+    poolChain(true);
+}
+
+TEST_CASE(PcmPort_in_place_mismatch)
+{
+    auto source = TestObject::make();
+    auto filter = TestObject::make();
+    auto sink = TestObject::make();
+    std::scoped_lock lock(*source, *filter, *sink);
+    auto& sourceOutput = source->publicAddOutput<PcmOutputPort>("output");
+    auto& filterInput = filter->publicAddInput<PcmInputPort>("input");
+    auto& filterOutput = filter->publicAddOutput<PcmOutputPort>("output");
+    auto& sinkInput = sink->publicAddInput<PcmInputPort>("input");
+
+    sourceOutput.config({ PcmFormat::float32, 1, 16 });
+    filterOutput.config({ PcmFormat::float32, 2, 16 });
+    filterOutput.inPlace(&filterInput);
+
+    for (const auto& object : { source, filter, sink })
+    {
+        object->configure();
+    }
+
+    linkPorts(sourceOutput, filterInput);
+    linkPorts(filterOutput, sinkInput);
+
+    sourceOutput.buffer().channel<float>(0)[0] = 1;
+    sourceOutput.commit(16);
+
+    // A rejected hand off leaves the block with the input.
+    BOOST_CHECK_THROW(filterOutput.buffer(), ValueError);
+    BOOST_CHECK(filterInput.ready());
+    BOOST_CHECK(filterInput.buffer().channel<float>(0)[0] == 1);
+}
+
+TEST_CASE(PcmPort_pool_exhausted)
+{
+    auto source = TestObject::make();
+    auto sink = TestObject::make();
+    std::scoped_lock lock(*source, *sink);
+    auto& output = source->publicAddOutput<PcmOutputPort>("output");
+    auto& input = sink->publicAddInput<PcmInputPort>("input");
+    std::vector<SharedPcmBuffer> held;
+
+    output.config({ PcmFormat::float32, 1, 16 });
+    source->configure();
+    sink->configure();
+    linkPorts(output, input);
+
+    // Blocks kept past the link never come back so the output has to wait instead of failing
+    // to get a buffer.
+    while (output.ready())
+    {
+        output.buffer();
+        output.commit(16);
+        held.push_back(input.block());
+        input.consume();
+    }
+
+    BOOST_CHECK(held.size() == output.pool().capacity());
+    BOOST_CHECK(output.pool().available() == 0);
+
+    held.pop_back();
+    BOOST_CHECK(output.ready());
+}
+
+TEST_CASE(PcmPort_convert)
+{
+    auto source = TestObject::make();
+    auto sink = TestObject::make();
+    std::scoped_lock lock(*source, *sink);
+    auto& output = source->publicAddOutput<PcmOutputPort>("output");
+    auto& same = sink->publicAddInput<PcmInputPort>("input 1");
+    auto& narrow = sink->publicAddInput<PcmInputPort>("input 2");
+
+    output.config({ PcmFormat::float32, 2, 16 });
+    narrow.config({ PcmFormat::int16, 0, 0 });
+    narrow.dither(PcmDither::triangular);
+    source->configure();
+    sink->configure();
+
+    auto sameLink = dynamic_cast<PcmPortLink*>(linkPorts(output, same));
+    auto narrowLink = dynamic_cast<PcmPortLink*>(linkPorts(output, narrow));
+
+    BOOST_CHECK(sameLink->converter() == nullptr);
+    BOOST_CHECK(narrowLink->converter() != nullptr);
+    BOOST_CHECK(narrowLink->inputConfig().format == PcmFormat::int16);
+    BOOST_CHECK(narrowLink->converter()->dither() == PcmDither::triangular);
+    BOOST_CHECK_THROW(narrow.dither(PcmDither::none), RuntimeError);
+
+    auto& buffer = output.buffer();
+
+    for (std::size_t channel = 0; channel < 2; channel++)
+    {
+        for (std::size_t frame = 0; frame < 16; frame++)
+        {
+            buffer.channel<float>(channel)[frame] = channel ? 0.5f : -1.0f;
+        }
+    }
+
+    output.commit(16);
+
+    BOOST_CHECK(same.buffer().format() == PcmFormat::float32);
+    BOOST_CHECK(narrow.buffer().format() == PcmFormat::int16);
+    BOOST_CHECK(narrow.frames() == 16);
+
+    for (std::size_t frame = 0; frame < 16; frame++)
+    {
+        BOOST_CHECK(narrow.buffer().channel<std::int16_t>(0)[frame] >= -32768);
+        BOOST_CHECK(narrow.buffer().channel<std::int16_t>(0)[frame] <= -32767);
+        BOOST_CHECK(std::abs(narrow.buffer().channel<std::int16_t>(1)[frame] - 16384) <= 1);
+    }
+}
+
+TEST_CASE(PcmPort_resample)
+{
+    auto source = TestObject::make();
+    auto sink = TestObject::make();
+    std::scoped_lock lock(*source, *sink);
+    auto& output = source->publicAddOutput<PcmOutputPort>("output");
+    auto& input = sink->publicAddInput<PcmInputPort>("input");
+
+    output.config({ PcmFormat::int16, 2, 64, 0, 44100 });
+    input.config({ PcmFormat::float32, 0, 0, 0, 48000 });
+    input.resamplerQuality(PcmResamplerQuality::fast);
+    source->configure();
+    sink->configure();
+
+    auto link = dynamic_cast<PcmPortLink*>(linkPorts(output, input));
+
+    BOOST_CHECK(link->resampler() != nullptr);
+    BOOST_CHECK(link->resampler()->quality() == PcmResamplerQuality::fast);
+    BOOST_CHECK(link->latency() > 0);
+    BOOST_CHECK(link->inputConfig().rate == 48000);
+    BOOST_CHECK(link->inputConfig().blockSize >= 70);
+
+    std::size_t received = 0;
+
+    for (std::size_t block = 0; block < 10; block++)
+    {
+        auto& buffer = output.buffer();
+
+        for (std::size_t channel = 0; channel < 2; channel++)
+        {
+            for (std::size_t frame = 0; frame < 64; frame++)
+            {
+                buffer.channel<std::int16_t>(channel)[frame] = 16384;
+            }
+        }
+
+        output.commit(64);
+        received += input.frames();
+
+        // A constant signal comes through at the same level once the filter has filled.
+        if (block > 2) BOOST_CHECK(std::abs(input.buffer().channel<float>(1)[0] - 0.5f) < 0.01f);
+
+        input.consume();
+    }
+
+    BOOST_CHECK(received >= 640 * 48000 / 44100 - 1 && received <= 640 * 48000 / 44100 + 1);
+}
+
+TEST_CASE(PcmPort_mix)
+{
+    auto source = TestObject::make();
+    auto sink = TestObject::make();
+    std::scoped_lock lock(*source, *sink);
+    auto& output = source->publicAddOutput<PcmOutputPort>("output");
+    auto& stereo = sink->publicAddInput<PcmInputPort>("stereo");
+    auto& center = sink->publicAddInput<PcmInputPort>("center");
+    auto& same = sink->publicAddInput<PcmInputPort>("same");
+    PcmMatrix pickCenter(6, 1);
+
+    pickCenter.gain(0, 2, 1);
+    output.config({ PcmFormat::float32, 6, 32 });
+    stereo.config({ PcmFormat::int16, 2, 0 });
+    center.config({ PcmFormat::float32, 1, 0 });
+    center.matrix(pickCenter);
+    source->configure();
+    sink->configure();
+
+    auto stereoLink = dynamic_cast<PcmPortLink*>(linkPorts(output, stereo));
+    auto centerLink = dynamic_cast<PcmPortLink*>(linkPorts(output, center));
+    auto sameLink = dynamic_cast<PcmPortLink*>(linkPorts(output, same));
+
+    BOOST_CHECK(stereoLink->mixer() != nullptr);
+    BOOST_CHECK(stereoLink->matrix() == PcmMatrix::standard(6, 2));
+    BOOST_CHECK(stereoLink->inputConfig().channels == 2);
+    BOOST_CHECK(centerLink->mixer()->routes() == 1);
+    BOOST_CHECK(sameLink->mixer() == nullptr);
+    BOOST_CHECK_THROW(sameLink->matrix(PcmMatrix::identity(6)), RuntimeError);
+    BOOST_CHECK_THROW(centerLink->matrix(PcmMatrix(6, 2)), ValueError);
+
+    auto send = [&]()
+    {
+        auto& buffer = output.buffer();
+
+        for (std::size_t channel = 0; channel < 6; channel++)
+        {
+            for (std::size_t frame = 0; frame < 32; frame++)
+            {
+                buffer.channel<float>(channel)[frame] = 0.1f * (channel + 1);
+            }
+        }
+
+        output.commit(32);
+    };
+
+    send();
+
+    // L + 0.707 C + 0.707 Ls = 0.1 + 0.707 * (0.3 + 0.5)
+    BOOST_CHECK(std::abs(stereo.buffer().channel<std::int16_t>(0)[31] - std::lround((0.1 + 0.70710678 * 0.8) * 32768)) <= 1);
+    BOOST_CHECK(center.buffer().channel<float>(0)[0] == 0.3f);
+    BOOST_CHECK(same.buffer().channels() == 6);
+
+    for (const auto input : { &stereo, &center, &same })
+    {
+        input->consume();
+    }
+
+    // A new matrix takes effect at the next block.
+    PcmMatrix pickLfe(6, 1);
+
+    pickLfe.gain(0, 3, 0.5f);
+    centerLink->matrix(pickLfe);
+    BOOST_CHECK(centerLink->matrix() == pickLfe);
+    send();
+    BOOST_CHECK(center.buffer().channel<float>(0)[0] == 0.2f);
+}
+
+TEST_CASE(PcmPort_layout)
+{
+    auto source = TestObject::make();
+    auto sink = TestObject::make();
+    std::scoped_lock lock(*source, *sink);
+    auto& output = source->publicAddOutput<PcmOutputPort>("output");
+    auto& planar = sink->publicAddInput<PcmInputPort>("planar");
+    auto& grouped = sink->publicAddInput<PcmInputPort>("grouped");
+    auto& converted = sink->publicAddInput<PcmInputPort>("converted");
+    auto& mixed = sink->publicAddInput<PcmInputPort>("mixed");
+    PcmConfig config{ PcmFormat::float32, 10, 32 };
+    PcmConfig convertedConfig{ PcmFormat::int16, 0, 0 };
+    PcmConfig mixedConfig{ PcmFormat::float32, 2, 0 };
+
+    config.layout = PcmLayout::grouped8;
+    convertedConfig.layout = PcmLayout::grouped4;
+    mixedConfig.layout = PcmLayout::grouped4;
+    output.config(config);
+    grouped.config({ PcmFormat::float32, 0, 0, 0, 0, PcmLayout::grouped8 });
+    converted.config(convertedConfig);
+    mixed.config(mixedConfig);
+    source->configure();
+    sink->configure();
+
+    auto planarLink = dynamic_cast<PcmPortLink*>(linkPorts(output, planar));
+    auto groupedLink = dynamic_cast<PcmPortLink*>(linkPorts(output, grouped));
+    auto convertedLink = dynamic_cast<PcmPortLink*>(linkPorts(output, converted));
+    auto mixedLink = dynamic_cast<PcmPortLink*>(linkPorts(output, mixed));
+
+    BOOST_CHECK(planarLink->transposer() != nullptr);
+    BOOST_CHECK(groupedLink->transposer() == nullptr);
+    BOOST_CHECK(convertedLink->transposer()->from() == PcmLayout::planar);
+    BOOST_CHECK(mixedLink->inputConfig().layout == PcmLayout::grouped4);
+
+    auto& buffer = output.buffer();
+
+    BOOST_CHECK(buffer.layout() == PcmLayout::grouped8);
+
+    for (std::size_t channel = 0; channel < 10; channel++)
+    {
+        for (std::size_t frame = 0; frame < 32; frame++)
+        {
+            buffer.group<float>(channel / 8)[frame * 8 + channel % 8] = (channel + 1) / 16.0f;
+        }
+    }
+
+    output.commit(32);
+
+    BOOST_CHECK(planar.buffer().channel<float>(9)[31] == 10 / 16.0f);
+    BOOST_CHECK(grouped.buffer().group<float>(1)[5 * 8 + 1] == 10 / 16.0f);
+    BOOST_CHECK(converted.buffer().group<std::int16_t>(2)[3 * 4 + 1] == 10 * 2048);
+    BOOST_CHECK(converted.buffer().group<std::int16_t>(2)[3 * 4 + 2] == 0);
+
+    // Stereo fold down of 10 channels is the diagonal so the left channel is channel 0.
+    BOOST_CHECK(mixed.buffer().group<float>(0)[4 * 4] == 1 / 16.0f);
+    BOOST_CHECK(mixed.buffer().group<float>(0)[4 * 4 + 1] == 2 / 16.0f);
+    BOOST_CHECK(mixed.buffer().group<float>(0)[4 * 4 + 2] == 0);
+}
+
+TEST_CASE(PcmPort_silent)
+{
+    auto source = TestObject::make();
+    auto sink = TestObject::make();
+    std::scoped_lock lock(*source, *sink);
+    auto& output = source->publicAddOutput<PcmOutputPort>("output");
+    auto& same = sink->publicAddInput<PcmInputPort>("input 1");
+    auto& converted = sink->publicAddInput<PcmInputPort>("input 2");
+    auto& dithered = sink->publicAddInput<PcmInputPort>("input 3");
+    auto& resampled = sink->publicAddInput<PcmInputPort>("input 4");
+
+    output.config({ PcmFormat::float32, 2, 64, 0, 48000 });
+    converted.config({ PcmFormat::int16, 0, 0 });
+    dithered.config({ PcmFormat::int16, 0, 0 });
+    dithered.dither(PcmDither::triangular);
+    resampled.config({ PcmFormat::float32, 0, 0, 0, 44100 });
+    source->configure();
+    sink->configure();
+    linkPorts(output, same);
+    linkPorts(output, converted);
+    linkPorts(output, dithered);
+    linkPorts(output, resampled);
+
+    for (const auto silent : { true, false, true })
+    {
+        auto& buffer = output.buffer();
+
+        for (std::size_t channel = 0; channel < 2; channel++)
+        {
+            std::fill_n(buffer.channel<float>(channel), 64, silent ? 0.0f : 0.5f);
+        }
+
+        output.commit(64, silent);
+
+        // Silence survives a format change but not dither or a resampler that still rings.
+        BOOST_CHECK(same.silent() == silent);
+        BOOST_CHECK(converted.silent() == silent);
+        BOOST_CHECK(! dithered.silent());
+        BOOST_CHECK(! resampled.silent());
+
+        same.consume();
+        converted.consume();
+        dithered.consume();
+        resampled.consume();
+    }
+}
@@ -0,0 +1,294 @@
+/* Copyright 2023 Tyler Riddle
+ *
+ * This file is part of Clypsalot. Clypsalot is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation, either version 3 of the License,
+ * or (at your option) any later version. Clypsalot is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with Clypsalot. If not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+
+#include <chrono>
+#include <cstddef>
+#include <filesystem>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <clypsalot/catalog.hxx>
+#include <clypsalot/error.hxx>
+#include <clypsalot/pcm.hxx>
+#include <clypsalot/pipe.hxx>
+#include <clypsalot/property.hxx>
+
+#include "test/lib/test.hxx"
+#include "test/module/object.hxx"
+
+using namespace Clypsalot;
+
+TEST_MAIN_FUNCTION
+
+using Bytes = std::vector<std::byte>;
+
+struct Pipe
+{
+    int reader = -1;
+    int writer = -1;
+
+    Pipe()
+    {
+        int fds[2];
+
+        BOOST_REQUIRE(pipe(fds) == 0);
+        reader = fds[0];
+        writer = fds[1];
+    }
+
+    ~Pipe()
+    {
+        closeReader();
+        closeWriter();
+    }
+
+    void closeReader()
+    {
+        if (reader >= 0) close(reader);
+        reader = -1;
+    }
+
+    void closeWriter()
+    {
+        if (writer >= 0) close(writer);
+        writer = -1;
+    }
+};
+
+static Bytes randomBytes(const std::size_t in_bytes)
+{
+    std::mt19937 generator(in_bytes);
+    Bytes bytes(in_bytes);
+
+    for (auto& byte : bytes) byte = static_cast<std::byte>(generator());
+
+    return bytes;
+}
+
+// Write everything in small pieces with pauses so the source has to wait for the pipe.
+static void writeAll(const int in_fd, const Bytes& in_bytes)
+{
+    std::size_t written = 0;
+
+    while (written < in_bytes.size())
+    {
+        const auto result = write(in_fd, in_bytes.data() + written, std::min<std::size_t>(in_bytes.size() - written, 3000));
+
+        BOOST_REQUIRE(result > 0);
+        written += result;
+
+        if (written % 4 == 0) std::this_thread::sleep_for(std::chrono::microseconds(100));
+    }
+}
+
+static Bytes readAll(const int in_fd)
+{
+    Bytes bytes;
+    std::byte buffer[4096];
+
+    while (true)
+    {
+        const auto result = read(in_fd, buffer, sizeof(buffer));
+
+        BOOST_REQUIRE(result >= 0);
+
+        if (result == 0) return bytes;
+
+        bytes.insert(bytes.end(), buffer, buffer + result);
+    }
+}
+
+/*
+ * Send a stream from one pipe to another through a source linked to a sink which are run by the
+ * scheduler. The stream ends when the test closes the pipe going in and the sink closes the pipe
+ * going out.
+ */
+static void roundTrip(const PcmFormat in_format, const std::size_t in_channels, const bool in_splice, const bool in_direct)
+{
+    const auto sampleSize = in_format == PcmFormat::int24 ? 3 : pcmSampleSize(in_format);
+    // Not a whole number of blocks or pipe buffers.
+    const auto input = randomBytes(sampleSize * in_channels * 100003);
+    Pipe in;
+    Pipe out;
+    auto source = PipeSourceObject::make();
+    auto sink = PipeSinkObject::make();
+
+    {
+        std::scoped_lock lock(*source, *sink);
+
+        source->configure({
+            { "Descriptor", in.reader },
+            { "Format", toString(in_format) },
+            { "Channels", in_channels },
+            { "Block Size", 500 },
+        });
+
+        sink->configure({
+            { "Descriptor", out.writer },
+            { "Format", toString(in_format) },
+            { "Buffer Size", 8192 },
+            { "Splice", in_splice },
+        });
+
+        BOOST_CHECK(source->direct() == in_direct);
+        BOOST_CHECK(sink->splice() == in_splice);
+        linkPorts(source->output("output"), sink->input("input"));
+    }
+
+    // Both objects have their own descriptors.
+    in.closeReader();
+    out.closeWriter();
+
+    Bytes output;
+    std::thread reader([&] { output = readAll(out.reader); });
+
+    {
+        std::scoped_lock lock(*source, *sink);
+
+        startObject(source);
+        startObject(sink);
+    }
+
+    writeAll(in.writer, input);
+    in.closeWriter();
+    reader.join();
+
+    BOOST_CHECK(output == input);
+    BOOST_REQUIRE(waitUntil(*sink, [&] { return sink->state() == ObjectState::stopped; }));
+
+    std::scoped_lock lock(*source, *sink);
+
+    BOOST_CHECK(source->state() == ObjectState::stopped);
+    BOOST_CHECK(source->frames() == 100003);
+    BOOST_CHECK(sink->closed());
+    BOOST_CHECK(sink->property("Bytes Written").sizeValue() == input.size());
+}
+
+TEST_CASE(Pipe_catalog)
+{
+    BOOST_CHECK(dynamic_cast<PipeSourceObject*>(objectCatalog().make(PipeSourceObject::kindName).get()) != nullptr);
+    BOOST_CHECK(dynamic_cast<PipeSinkObject*>(objectCatalog().make(PipeSinkObject::kindName).get()) != nullptr);
+}
+
+TEST_CASE(Pipe_round_trip)
+{
+    for (const auto splice : { false, true })
+    {
+        roundTrip(PcmFormat::float32, 1, splice, true);
+        roundTrip(PcmFormat::float32, 2, splice, false);
+        roundTrip(PcmFormat::int16, 8, splice, true);
+        roundTrip(PcmFormat::int24, 4, splice, false);
+    }
+}
+
+TEST_CASE(Pipe_fifo)
+{
+    const auto path = std::filesystem::temp_directory_path() / "clypsalot-test-pipe.fifo";
+
+    std::filesystem::remove(path);
+    BOOST_REQUIRE(mkfifo(path.c_str(), 0600) == 0);
+
+    auto source = PipeSourceObject::make();
+    auto sink = PipeSinkObject::make();
+    std::scoped_lock lock(*source, *sink);
+
+    // The reader has to be opened first because a FIFO can not be opened for writing with out
+    // blocking until there is one.
+    source->configure({ { "File", path }, { "Channels", 1 } });
+    sink->configure({ { "File", path }, { "Splice", true } });
+    BOOST_CHECK(sink->splice());
+
+    sink->stop();
+    source->stop();
+    std::filesystem::remove(path);
+}
+
+TEST_CASE(PipeSink_reader_closed)
+{
+    Pipe out;
+    auto source = TestObject::make();
+    auto sink = PipeSinkObject::make();
+    std::scoped_lock lock(*source, *sink);
+    auto& output = source->publicAddOutput<PcmOutputPort>("output");
+
+    output.config({ PcmFormat::float32, 2, 256 });
+    source->configure();
+    sink->configure({ { "Descriptor", out.writer } });
+    linkPorts(output, sink->input("input"));
+    sink->start();
+    out.closeReader();
+    output.buffer();
+    output.commit(256);
+    sink->schedule();
+
+    // The reader going away ends the stream instead of raising SIGPIPE.
+    BOOST_CHECK(sink->execute() == ObjectProcessResult::endOfData);
+    BOOST_CHECK(sink->closed());
+}
+
+TEST_CASE(PipeSink_destroy_while_writing)
+{
+    // The reader slowly takes some of what fills the pipe while the sink is being destroyed so
+    // the waits of the sink keep finishing and starting again while it stops waiting.
+    for (std::size_t iteration = 0; iteration < 100; iteration++)
+    {
+        Pipe out;
+        auto source = TestObject::make();
+        auto sink = PipeSinkObject::make();
+        std::byte fill[4096] = {};
+
+        BOOST_REQUIRE(fcntl(out.writer, F_SETFL, O_NONBLOCK) == 0);
+        while (write(out.writer, fill, sizeof(fill)) > 0) { }
+
+        {
+            std::scoped_lock lock(*source, *sink);
+            auto& output = source->publicAddOutput<PcmOutputPort>("output");
+
+            output.config({ PcmFormat::float32, 2, 4096 });
+            source->configure();
+            sink->configure({ { "Descriptor", out.writer } });
+            linkPorts(output, sink->input("input"));
+            sink->start();
+            output.buffer();
+            output.commit(4096);
+            sink->schedule();
+            BOOST_CHECK(sink->execute() == ObjectProcessResult::finished);
+        }
+
+        out.closeWriter();
+
+        // The reader stops before the sink has written everything so a wait that was started
+        // again would never finish.
+        std::thread reader([&]
+        {
+            std::size_t bytes = 0;
+
+            while (bytes < 4 * sizeof(fill))
+            {
+                const auto result = read(out.reader, fill, sizeof(fill));
+
+                BOOST_REQUIRE(result > 0);
+                bytes += result;
+                std::this_thread::sleep_for(std::chrono::microseconds(20));
+            }
+        });
+
+        std::this_thread::sleep_for(std::chrono::microseconds(iteration * 3));
+        sink.reset();
+        reader.join();
+    }
+}
@@ -10,6 +10,8 @@
  * <https://www.gnu.org/licenses/>.
  */
 
+#include <thread>
+
 #include <clypsalot/macros.hxx>
 #include <clypsalot/port.hxx>
 #include <clypsalot/util.hxx>
@@ -279,3 +281,80 @@ TEST_CASE(readiness)
     BOOST_CHECK(output.ready() == true);
     BOOST_CHECK(input.ready() == true);
 }
+
+TEST_CASE(RingBuffer_push_pop)
+{
+    RingBuffer<int> ring(3);
+
+    BOOST_CHECK(ring.capacity() == 3);
+    BOOST_CHECK(ring.empty());
+    BOOST_CHECK(ring.front() == nullptr);
+    BOOST_CHECK(! ring.pop());
+
+    for (int round = 0; round < 3; round++)
+    {
+        for (int i = 0; i < 3; i++)
+        {
+            BOOST_CHECK(ring.push(round * 10 + i));
+        }
+
+        BOOST_CHECK(ring.full());
+        BOOST_CHECK(! ring.push(99));
+
+        for (int i = 0; i < 3; i++)
+        {
+            BOOST_CHECK(*ring.front() == round * 10 + i);
+            BOOST_CHECK(ring.pop());
+        }
+
+        BOOST_CHECK(ring.size() == 0);
+    }
+}
+
+TEST_CASE(RingBuffer_threads)
+{
+    static constexpr size_t totalValues = 100000;
+    RingBuffer<size_t> ring(16);
+    bool ordered = true;
+
+    std::thread consumer([&ring, &ordered]
+    {
+        for (size_t expected = 1; expected <= totalValues; expected++)
+        {
+            while (ring.front() == nullptr) std::this_thread::yield();
+
+            if (*ring.front() != expected) ordered = false;
+            ring.pop();
+        }
+    });
+
+    for (size_t value = 1; value <= totalValues; value++)
+    {
+        while (! ring.push(value)) std::this_thread::yield();
+    }
+
+    consumer.join();
+
+    BOOST_CHECK(ordered);
+    BOOST_CHECK(ring.empty());
+}
+
+TEST_CASE(PortLink_endOfData)
+{
+    auto object1 = TestObject::make();
+    auto object2 = TestObject::make();
+    std::scoped_lock lock(*object1, *object2);
+    auto& output = object1->publicAddOutput<MTestOutputPort>("output");
+    auto& input = object2->publicAddInput<MTestInputPort>("input");
+
+    object1->configure();
+    object2->configure();
+
+    auto link = linkPorts(output, input);
+
+    BOOST_CHECK(! link->endOfData());
+    BOOST_CHECK(! input.endOfData());
+    output.setEndOfData();
+    BOOST_CHECK(link->endOfData());
+    BOOST_CHECK(input.endOfData());
+}
@@ -0,0 +1,144 @@
+/* Copyright 2023 Tyler Riddle
+ *
+ * This file is part of Clypsalot. Clypsalot is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation, either version 3 of the License,
+ * or (at your option) any later version. Clypsalot is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with Clypsalot. If not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+
+#include <vector>
+
+#include <clypsalot/error.hxx>
+#include <clypsalot/network.hxx>
+#include <clypsalot/preset.hxx>
+
+#include "test/lib/test.hxx"
+#include "test/module/object.hxx"
+#include "test/module/port.hxx"
+
+using namespace Clypsalot;
+
+TEST_MAIN_FUNCTION
+
+static const PropertyList presetProperties = {
+    { "Gain", PropertyType::real, Property::PublicMutable, 1.0 },
+    { "Mode", PropertyType::string, Property::PublicMutable, "clean" },
+    { "Fixed", PropertyType::integer, Property::NoFlags, 1 },
+};
+
+static std::shared_ptr<TestObject> makePresetObject(Network& network, const bool withInput = false)
+{
+    auto object = makeTestObject<TestObject>(network, TEST_OBJECT_KIND);
+    std::unique_lock lock(*object);
+
+    object->publicAddProperties(presetProperties);
+    if (withInput) object->publicAddInput<MTestInputPort>("input");
+    object->configure();
+
+    return object;
+}
+
+TEST_CASE(Preset_add)
+{
+    Network network;
+    auto object = makePresetObject(network);
+    std::unique_lock lock(*object);
+    Preset preset;
+
+    preset.add(object, "Gain", 0.5);
+    preset.add(object, "Mode", "drive");
+    preset.add(object, "Gain", 0.25);
+
+    BOOST_CHECK(preset.size() == 2);
+    BOOST_CHECK(preset.blocks().size() == 1);
+    BOOST_CHECK(std::get<Property::RealType>(preset.blocks()[0].values[0].second) == 0.25f);
+    BOOST_CHECK_THROW(preset.add(object, "Missing", 1), KeyError);
+    BOOST_CHECK_THROW(preset.add(object, "Fixed", 2), ImmutableError);
+    BOOST_CHECK_THROW(preset.add(object, "Gain", std::vector<int>()), ValueError);
+    BOOST_CHECK(object->property("Gain").realValue() == 1);
+}
+
+TEST_CASE(Preset_capture)
+{
+    Network network;
+    auto object = makePresetObject(network);
+    std::unique_lock lock(*object);
+    Preset preset;
+
+    preset.capture(object);
+    BOOST_CHECK(preset.size() == 2);
+
+    object->property("Gain").realValue(2);
+    lock.unlock();
+
+    network.recall(preset);
+
+    lock.lock();
+    BOOST_CHECK(object->property("Gain").realValue() == 1);
+}
+
+TEST_CASE(Network_recall)
+{
+    Network network;
+    auto object1 = makePresetObject(network, true);
+    auto object2 = makePresetObject(network);
+    Preset preset;
+
+    {
+        // Add the objects out of id order to make sure the blocks are sorted
+        std::scoped_lock lock(*object1, *object2);
+        preset.add(object2, "Mode", "drive");
+        preset.add(object1, "Gain", 3);
+        preset.add(object2, "Gain", 4);
+
+        object1->start();
+    }
+
+    BOOST_CHECK(preset.blocks()[0].object == object1);
+    BOOST_CHECK(preset.blocks()[1].object == object2);
+
+    network.recall(preset);
+
+    std::scoped_lock lock(*object1, *object2);
+    BOOST_CHECK(object1->state() == ObjectState::waiting);
+    BOOST_CHECK(object2->state() == ObjectState::paused);
+    BOOST_CHECK(object1->property("Gain").realValue() == 3);
+    BOOST_CHECK(object1->property("Mode").stringValue() == "clean");
+    BOOST_CHECK(object2->property("Gain").realValue() == 4);
+    BOOST_CHECK(object2->property("Mode").stringValue() == "drive");
+}
+
+TEST_CASE(Network_recall_foreign_object)
+{
+    Network network;
+    auto object = TestObject::make();
+    Preset preset;
+
+    {
+        std::scoped_lock lock(*object);
+        object->publicAddProperties(presetProperties);
+        object->configure();
+        preset.add(object, "Gain", 2);
+    }
+
+    BOOST_CHECK_THROW(network.recall(preset), RuntimeError);
+}
+
+TEST_CASE(Property_variant)
+{
+    auto object = TestObject::make();
+    std::scoped_lock lock(*object);
+
+    object->publicAddProperties(presetProperties);
+
+    auto& gain = object->property("Gain");
+
+    gain.variant(gain.convert(5));
+    BOOST_CHECK(gain.realValue() == 5);
+    BOOST_CHECK_THROW(gain.variant(Property::Variant(std::string("5"))), TypeError);
+    BOOST_CHECK_THROW(object->property("Fixed").variant(1), ImmutableError);
+}
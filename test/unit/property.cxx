@@ -13,6 +13,7 @@
 #include <map>
 #include <string>
 
+#include <clypsalot/error.hxx>
 #include <clypsalot/property.hxx>
 #include <clypsalot/thread.hxx>
 
@@ -46,3 +47,87 @@ TEST_CASE(Property_flags)
     BOOST_CHECK(! (mutableFlagProperty.flags() & Property::Configurable));
     BOOST_CHECK(! mutableFlagProperty.hasFlag(Property::Configurable));
 }
+
+TEST_CASE(Property_array)
+{
+    PropertyHost properties;
+    std::lock_guard lock(properties);
+    auto& coefficients = properties.addProperty({"coefficients", PropertyType::realArray, Property::PublicMutable, nullptr });
+    const Property::RealArrayType values = { 1, 2, 3 };
+
+    BOOST_CHECK(! coefficients.defined());
+    coefficients.realArrayValue(values);
+
+    // Taking the value shares the buffer and the view stays the same after the property changes
+    auto view = coefficients.realArrayValue();
+    BOOST_CHECK(view.shares(values));
+    coefficients.anyValue(std::vector<double>{ 4, 5 });
+    BOOST_CHECK(view.size() == 3);
+    BOOST_CHECK(view[2] == 3);
+    BOOST_CHECK(coefficients.realArrayValue() == Property::RealArrayType({ 4, 5 }));
+
+    coefficients.anyValue("[6, 7.5, 8]");
+    BOOST_CHECK(coefficients.realArrayValue() == Property::RealArrayType({ 6, 7.5, 8 }));
+    BOOST_CHECK(coefficients.valueToString() == "[6, 7.5, 8]");
+    BOOST_CHECK_THROW(coefficients.anyValue("[1, two]"), ValueError);
+    BOOST_CHECK_THROW(coefficients.realValue(), TypeError);
+}
+
+TEST_CASE(Property_table)
+{
+    PropertyHost properties;
+    std::lock_guard lock(properties);
+    auto& bands = properties.addProperty({"bands", PropertyType::doubleTable, Property::PublicMutable, nullptr });
+
+    bands.anyValue("[[100, 0.7], [1000, 1.4], [10000, 0.7]]");
+
+    const auto table = bands.doubleTableValue();
+
+    BOOST_CHECK(table.rows() == 3);
+    BOOST_CHECK(table.columns() == 2);
+    BOOST_CHECK(table.at(1, 0) == 1000);
+    BOOST_CHECK(table.row(2)[1] == 0.7);
+    BOOST_CHECK(bands.valueToString() == "[[100, 0.7], [1000, 1.4], [10000, 0.7]]");
+
+    bands.anyValue("1 2; 3 4");
+    BOOST_CHECK(bands.doubleTableValue() == Property::DoubleTableType({{ 1, 2 }, { 3, 4 }}));
+    BOOST_CHECK_THROW(bands.anyValue(std::vector<std::vector<double>>{{ 1, 2 }, { 3 }}), ValueError);
+    BOOST_CHECK_THROW(Property::DoubleTableType(std::vector<double>{ 1, 2, 3 }, 2), ValueError);
+}
+
+TEST_CASE(Property_array_not_automatable)
+{
+    PropertyHost properties;
+    std::lock_guard lock(properties);
+
+    BOOST_CHECK_THROW(properties.addProperty({"array", PropertyType::integerArray, Property::Automatable, nullptr }), TypeError);
+}
+
+TEST_CASE(SharedArray_memory)
+{
+    const auto before = arrayMemoryStats();
+
+    {
+        std::vector<float> values(1024, 0.5f);
+        Property::RealArrayType first(values);
+        Property::RealArrayType second(values);
+        Property::RealTableType table(values, 32);
+        const auto stats = arrayMemoryStats();
+
+        // Identical values share a single buffer even when they are used by different types
+        BOOST_CHECK(first.shares(second));
+        BOOST_CHECK(first.shares(table));
+        BOOST_CHECK(stats.buffers == before.buffers + 1);
+        BOOST_CHECK(stats.bytes == before.bytes + values.size() * sizeof(float));
+        BOOST_CHECK(stats.sharedBuffers == before.sharedBuffers + 2);
+        BOOST_CHECK(stats.sharedBytes == before.sharedBytes + 2 * values.size() * sizeof(float));
+
+        values[0] = 1;
+        Property::RealArrayType third(values);
+        BOOST_CHECK(! third.shares(first));
+        BOOST_CHECK(arrayMemoryStats().buffers == before.buffers + 2);
+    }
+
+    BOOST_CHECK(arrayMemoryStats().buffers == before.buffers);
+    BOOST_CHECK(arrayMemoryStats().bytes == before.bytes);
+}
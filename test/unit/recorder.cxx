@@ -0,0 +1,288 @@
+/* Copyright 2023 Tyler Riddle
+ *
+ * This file is part of Clypsalot. Clypsalot is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation, either version 3 of the License,
+ * or (at your option) any later version. Clypsalot is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with Clypsalot. If not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <clypsalot/catalog.hxx>
+#include <clypsalot/memory.hxx>
+#include <clypsalot/pcm.hxx>
+#include <clypsalot/property.hxx>
+#include <clypsalot/recorder.hxx>
+#include <clypsalot/wav.hxx>
+
+#include "test/lib/test.hxx"
+#include "test/module/object.hxx"
+
+using namespace Clypsalot;
+
+TEST_MAIN_FUNCTION
+
+static constexpr std::size_t blockSize = 256;
+// A ring of a few writes holds a small part of a second of 64 channels at 96 kHz so the writes
+// have to keep up with the blocks.
+static constexpr std::size_t sustainedRingSize = 4 * RecorderObject::writeSize;
+static constexpr std::size_t sustainedSeconds = 3;
+static constexpr std::size_t sustainedBlocks = sustainedSeconds * 96000 / blockSize;
+
+static float sampleValue(const std::size_t in_channel, const std::size_t in_frame) noexcept
+{
+    return static_cast<float>(in_channel * 1000 + in_frame % 997);
+}
+
+/*
+ * Record the given number of blocks at the rate of the config and return whether the file was
+ * opened with O_DIRECT. The recorder is destroyed before returning so the file is finished.
+ */
+static bool record(const std::filesystem::path& in_path, const PcmConfig& in_config, const std::size_t in_blocks, const bool in_direct, const std::size_t in_ringSize)
+{
+    auto source = TestObject::make();
+    auto recorder = RecorderObject::make();
+    std::unique_lock sourceLock(*source, std::defer_lock);
+    std::unique_lock recorderLock(*recorder, std::defer_lock);
+    std::lock(sourceLock, recorderLock);
+    auto& output = source->publicAddOutput<PcmOutputPort>("output");
+
+    output.config(in_config);
+    source->configure();
+    recorder->configure({ { "File", in_path }, { "Format", toString(in_config.format) }, { "Direct I/O", in_direct }, { "Ring Size", in_ringSize } });
+    linkPorts(output, static_cast<PcmInputPort&>(recorder->input("input")));
+    recorder->start();
+
+    const auto start = std::chrono::steady_clock::now();
+    const auto period = std::chrono::duration<double>(static_cast<double>(blockSize) / in_config.rate);
+
+    for (std::size_t block = 0; block < in_blocks; block++)
+    {
+        std::this_thread::sleep_until(start + std::chrono::duration_cast<std::chrono::steady_clock::duration>(block * period));
+
+        auto& buffer = output.buffer();
+
+        for (std::size_t channel = 0; channel < in_config.channels; channel++)
+        {
+            for (std::size_t frame = 0; frame < blockSize; frame++)
+            {
+                const auto value = sampleValue(channel, block * blockSize + frame);
+
+                if (in_config.format == PcmFormat::float32) buffer.channel<float>(channel)[frame] = value;
+                else buffer.channel<std::int32_t>(channel)[frame] = -static_cast<std::int32_t>(value) * 256;
+            }
+        }
+
+        output.commit(blockSize);
+        recorder->schedule();
+        BOOST_CHECK(recorder->execute() == ObjectProcessResult::finished);
+    }
+
+    // The recording is many times the size of the ring so nothing is dropped only if the writes
+    // keep up.
+    BOOST_CHECK(recorder->property("Overruns").sizeValue() == 0);
+    BOOST_CHECK(recorder->property("Ring Fill").sizeValue() == recorder->ringFill());
+
+    const auto direct = recorder->direct();
+
+    stopObject(recorder);
+    unlinkPorts(output, static_cast<PcmInputPort&>(recorder->input("input")));
+    recorderLock.unlock();
+    recorder.reset();
+
+    return direct;
+}
+
+static void checkRecording(const std::filesystem::path& in_path, const PcmConfig& in_config, const std::size_t in_blocks)
+{
+    const FileMapping file(in_path);
+    const auto info = readWavInfo(file.data(), file.bytes());
+    const auto frames = in_blocks * blockSize;
+
+    BOOST_CHECK(info.container == PcmFileContainer::wav);
+    BOOST_CHECK(info.format == in_config.format);
+    BOOST_CHECK(info.channels == in_config.channels);
+    BOOST_CHECK(info.rate == in_config.rate);
+    BOOST_CHECK(info.dataOffset == wavHeaderSize);
+    BOOST_CHECK(info.frames == frames);
+    BOOST_CHECK(file.bytes() == wavHeaderSize + frames * info.frameSize());
+
+    std::size_t mismatches = 0;
+
+    for (const auto frame : { std::size_t(0), frames / 3, frames - 1 })
+    {
+        for (std::size_t channel = 0; channel < in_config.channels; channel++)
+        {
+            const auto sample = file.data() + info.dataOffset + frame * info.frameSize() + channel * info.sampleSize;
+
+            if (in_config.format == PcmFormat::float32)
+            {
+                float value;
+                std::memcpy(&value, sample, sizeof(value));
+                if (value != sampleValue(channel, frame)) mismatches++;
+            }
+            else
+            {
+                std::int32_t value = 0;
+                std::memcpy(&value, sample, 3);
+                if ((value << 8) >> 8 != -static_cast<std::int32_t>(sampleValue(channel, frame)) * 256) mismatches++;
+            }
+        }
+    }
+
+    BOOST_CHECK(mismatches == 0);
+}
+
+// True if files in the directory can be opened with O_DIRECT.
+static bool supportsDirect(const std::filesystem::path& in_directory)
+{
+    const auto path = in_directory / "clypsalot-recorder-direct";
+    const auto fd = open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC | O_DIRECT, 0644);
+
+    if (fd < 0) return false;
+
+    close(fd);
+    std::filesystem::remove(path);
+
+    return true;
+}
+
+static void recordAndCheck(const std::filesystem::path& in_directory, const PcmConfig& in_config, const std::size_t in_blocks, const bool in_direct, const std::size_t in_ringSize = sustainedRingSize)
+{
+    const auto path = in_directory / "clypsalot-recorder.wav";
+    const auto direct = record(path, in_config, in_blocks, in_direct, in_ringSize);
+
+    BOOST_CHECK(direct == (in_direct && supportsDirect(in_directory)));
+    checkRecording(path, in_config, in_blocks);
+    std::filesystem::remove(path);
+}
+
+TEST_CASE(Recorder_catalog)
+{
+    auto object = objectCatalog().make(RecorderObject::kindName);
+
+    BOOST_CHECK(dynamic_cast<RecorderObject*>(object.get()) != nullptr);
+}
+
+// Several seconds of 64 channels at 96 kHz in real time through a ring of a few writes.
+TEST_CASE(Recorder_tmpfs)
+{
+    const std::filesystem::path shm = "/dev/shm";
+
+    if (! std::filesystem::is_directory(shm)) return;
+
+    // tmpfs only supports O_DIRECT on newer kernels so on older ones this also covers falling
+    // back to buffered writes.
+    recordAndCheck(shm, { PcmFormat::float32, 64, blockSize, 0, 96000 }, sustainedBlocks, true);
+}
+
+TEST_CASE(Recorder_disk)
+{
+    const auto directory = std::filesystem::temp_directory_path();
+
+    recordAndCheck(directory, { PcmFormat::float32, 64, blockSize, 0, 96000 }, sustainedBlocks, true);
+    recordAndCheck(directory, { PcmFormat::float32, 64, blockSize, 0, 96000 }, sustainedBlocks, false);
+}
+
+TEST_CASE(Recorder_int24)
+{
+    recordAndCheck(std::filesystem::temp_directory_path(), { PcmFormat::int24, 3, blockSize, 0, 44100 }, 5, false);
+}
+
+TEST_CASE(WavHeader_rf64)
+{
+    PageMapping header(wavHeaderSize);
+    PcmFileInfo info;
+
+    info.format = PcmFormat::float32;
+    info.sampleSize = 4;
+    info.channels = 64;
+    info.rate = 96000;
+    info.frames = 96000 * 3600;
+
+    BOOST_CHECK(writeWavHeader(header.data(), info) == PcmFileContainer::rf64);
+
+    // Only the header is there so none of the frames are.
+    const auto read = readWavInfo(header.data(), wavHeaderSize);
+
+    BOOST_CHECK(read.container == PcmFileContainer::rf64);
+    BOOST_CHECK(read.channels == 64);
+    BOOST_CHECK(read.dataOffset == wavHeaderSize);
+    BOOST_CHECK(read.frames == 0);
+
+    info.frames = 96000;
+    BOOST_CHECK(writeWavHeader(header.data(), info) == PcmFileContainer::wav);
+}
+
+// Frames written out of a planar block read back the same way into a planar block or as they
+// are into a block with the layout of the file.
+TEST_CASE(PcmFrames_round_trip)
+{
+    constexpr std::size_t frames = 37;
+
+    for (const auto format : { PcmFormat::float32, PcmFormat::int24 })
+    {
+        for (const std::size_t channels : { 1, 3, 4, 8 })
+        {
+            PcmFileInfo info;
+            PcmBuffer planar(format, channels, frames);
+            PcmBuffer readBack(format, channels, frames);
+
+            info.format = format;
+            info.sampleSize = format == PcmFormat::int24 ? 3 : 4;
+            info.channels = channels;
+
+            std::vector<std::byte> data(frames * info.frameSize());
+
+            for (std::size_t channel = 0; channel < channels; channel++)
+            {
+                for (std::size_t frame = 0; frame < frames; frame++)
+                {
+                    // Negative values check that 24 bit samples are sign extended.
+                    if (format == PcmFormat::float32) planar.channel<float>(channel)[frame] = sampleValue(channel, frame);
+                    else planar.channel<std::int32_t>(channel)[frame] = static_cast<std::int32_t>(sampleValue(channel, frame)) - 4000;
+                }
+            }
+
+            writePcmFrames(data.data(), planar, info, frames);
+            readPcmFrames(readBack, data.data(), info, frames);
+
+            for (std::size_t channel = 0; channel < channels; channel++)
+            {
+                BOOST_CHECK(std::memcmp(planar.channelData(channel), readBack.channelData(channel), frames * pcmSampleSize(format)) == 0);
+            }
+
+            const auto layout = pcmFileLayout(channels);
+
+            if (layout == PcmLayout::planar || format != PcmFormat::float32) continue;
+
+            PcmBuffer grouped(format, channels, frames, layout);
+            std::size_t mismatches = 0;
+
+            readPcmFrames(grouped, data.data(), info, frames);
+
+            for (std::size_t channel = 0; channel < channels; channel++)
+            {
+                for (std::size_t frame = 0; frame < frames; frame++)
+                {
+                    if (grouped.group<float>(0)[frame * channels + channel] != sampleValue(channel, frame)) mismatches++;
+                }
+            }
+
+            BOOST_CHECK(mismatches == 0);
+        }
+    }
+}
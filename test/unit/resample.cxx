@@ -0,0 +1,109 @@
+/* Copyright 2023 Tyler Riddle
+ *
+ * This file is part of Clypsalot. Clypsalot is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation, either version 3 of the License,
+ * or (at your option) any later version. Clypsalot is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with Clypsalot. If not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+
+#include <cmath>
+#include <numbers>
+#include <vector>
+
+#include <clypsalot/error.hxx>
+#include <clypsalot/resample.hxx>
+
+#include "test/lib/test.hxx"
+
+using namespace Clypsalot;
+
+TEST_MAIN_FUNCTION
+
+static constexpr double sineFrequency = 1000;
+
+/**
+ * Resample a sine in blocks and compare the output with the sine computed directly at the output
+ * rate and delayed by the latency of the resampler. The result is the signal to error ratio in dB.
+ */
+static double resampleSine(const std::size_t inRate, const std::size_t outRate, const PcmResamplerQuality quality, const SimdLevel level)
+{
+    constexpr std::size_t blockSize = 97;
+    constexpr std::size_t totalBlocks = 200;
+    PcmResampler resampler(inRate, outRate, 1, blockSize, quality, level);
+    PcmBuffer input(PcmFormat::float32, 1, blockSize);
+    PcmBuffer output(PcmFormat::float32, 1, resampler.maxOutput(blockSize));
+    const auto delay = resampler.latency() / outRate;
+    const auto settle = static_cast<std::size_t>(resampler.latency() * 2);
+    std::size_t inFrame = 0;
+    std::size_t outFrame = 0;
+    double signal = 0;
+    double error = 0;
+
+    for (std::size_t block = 0; block < totalBlocks; block++)
+    {
+        for (std::size_t frame = 0; frame < blockSize; frame++)
+        {
+            input.channel<float>(0)[frame] = std::sin(2 * std::numbers::pi * sineFrequency * inFrame++ / inRate);
+        }
+
+        const auto produced = resampler.process(input, blockSize, output);
+
+        BOOST_CHECK(produced <= resampler.maxOutput(blockSize));
+
+        for (std::size_t frame = 0; frame < produced; frame++, outFrame++)
+        {
+            if (outFrame < settle) continue;
+
+            const auto expected = std::sin(2 * std::numbers::pi * sineFrequency * (static_cast<double>(outFrame) / outRate - delay));
+            const auto difference = output.channel<float>(0)[frame] - expected;
+
+            signal += expected * expected;
+            error += difference * difference;
+        }
+    }
+
+    // The number of frames produced tracks the ratio of the rates.
+    BOOST_CHECK(std::abs(static_cast<double>(outFrame) - static_cast<double>(inFrame) * outRate / inRate) <= 1);
+
+    return 10 * std::log10(signal / error);
+}
+
+TEST_CASE(PcmResampler_accuracy)
+{
+    const std::vector<std::pair<std::size_t, std::size_t>> rates = { { 44100, 48000 }, { 48000, 44100 }, { 96000, 44100 }, { 48000, 96000 } };
+    const std::vector<std::pair<PcmResamplerQuality, double>> qualities = {
+        { PcmResamplerQuality::fast, 55 }, { PcmResamplerQuality::balanced, 80 }, { PcmResamplerQuality::best, 110 }
+    };
+
+    for (const auto& [inRate, outRate] : rates)
+    {
+        for (const auto& [quality, minimum] : qualities)
+        {
+            for (const auto level : { SimdLevel::scalar, SimdLevel::sse2, SimdLevel::avx2 })
+            {
+                const auto ratio = resampleSine(inRate, outRate, quality, level);
+
+                BOOST_CHECK_MESSAGE(ratio > minimum, inRate << " -> " << outRate << " " << quality << " " << level << ": " << ratio << " dB");
+            }
+        }
+    }
+}
+
+TEST_CASE(PcmResampler_settings)
+{
+    PcmResampler resampler(44100, 48000, 2, 64, PcmResamplerQuality::fast);
+
+    BOOST_CHECK(resampler.phases() == 160);
+    BOOST_CHECK(resampler.taps() == 16);
+    BOOST_CHECK(resampler.latency() > 0);
+    BOOST_CHECK(PcmResampler(44100, 48000, 2, 64, PcmResamplerQuality::best).latency() > resampler.latency());
+
+    BOOST_CHECK_THROW(PcmResampler(0, 48000, 1, 64), ValueError);
+    BOOST_CHECK_THROW(PcmResampler(44100, 48000, 0, 64), ValueError);
+    BOOST_CHECK_THROW(PcmResampler(44100, 48000, 1, 0), ValueError);
+    BOOST_CHECK_THROW(PcmResampler(44100, 48001, 1, 64), ValueError);
+}
@@ -0,0 +1,224 @@
+/* Copyright 2023 Tyler Riddle
+ *
+ * This file is part of Clypsalot. Clypsalot is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation, either version 3 of the License,
+ * or (at your option) any later version. Clypsalot is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with Clypsalot. If not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+
+#include <chrono>
+#include <cstddef>
+#include <numeric>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <unistd.h>
+
+#include <clypsalot/catalog.hxx>
+#include <clypsalot/error.hxx>
+#include <clypsalot/pcm.hxx>
+#include <clypsalot/property.hxx>
+#include <clypsalot/shm.hxx>
+
+#include "test/lib/loopback.hxx"
+#include "test/lib/test.hxx"
+#include "test/module/object.hxx"
+
+using namespace Clypsalot;
+
+TEST_MAIN_FUNCTION
+
+static std::string deviceName(const std::string& in_name)
+{
+    return "clypsalot-test-" + std::to_string(getpid()) + "-" + in_name;
+}
+
+TEST_CASE(Shm_catalog)
+{
+    BOOST_CHECK(dynamic_cast<ShmSourceObject*>(objectCatalog().make(ShmSourceObject::kindName).get()) != nullptr);
+    BOOST_CHECK(dynamic_cast<ShmSinkObject*>(objectCatalog().make(ShmSinkObject::kindName).get()) != nullptr);
+}
+
+TEST_CASE(ShmRing_wrap)
+{
+    ShmDevice device(deviceName("wrap"), { PcmFormat::int32, 1, 48000, 4, 2 });
+    auto& ring = device.capture();
+    std::vector<std::int32_t> input(8);
+    std::vector<std::int32_t> output(8);
+    std::size_t frames;
+
+    std::iota(input.begin(), input.end(), 1);
+    BOOST_CHECK(ring.capacity() == 8);
+    BOOST_CHECK(ring.frameSize() == 4);
+
+    BOOST_CHECK(ring.write(reinterpret_cast<std::byte*>(input.data()), 8) == 8);
+    BOOST_CHECK(ring.writable() == 0);
+    BOOST_CHECK(ring.write(reinterpret_cast<std::byte*>(input.data()), 1) == 0);
+    BOOST_CHECK(ring.read(reinterpret_cast<std::byte*>(output.data()), 5) == 5);
+    BOOST_CHECK(std::equal(output.begin(), output.begin() + 5, input.begin()));
+
+    // Wrap around to the start of the ring.
+    BOOST_CHECK(ring.write(reinterpret_cast<std::byte*>(input.data()), 8) == 5);
+    ring.writePointer(frames);
+    BOOST_CHECK(frames == 0);
+    ring.readPointer(frames);
+    BOOST_CHECK(frames == 3);
+    BOOST_CHECK(ring.readable() == 8);
+
+    BOOST_CHECK(ring.read(reinterpret_cast<std::byte*>(output.data()), 8) == 8);
+    BOOST_CHECK((output == std::vector<std::int32_t> { 6, 7, 8, 1, 2, 3, 4, 5 }));
+    BOOST_CHECK(ring.readable() == 0);
+}
+
+TEST_CASE(ShmDevice_open)
+{
+    const auto name = deviceName("open");
+    auto created = std::make_unique<ShmDevice>(name, ShmDeviceConfig { PcmFormat::int24, 3, 44100, 128, 3 });
+
+    {
+        ShmDevice opened(name);
+        const std::int32_t frame[] = { 1, -2, 3 };
+        std::int32_t copy[3] = { };
+
+        BOOST_CHECK(opened.name() == "/" + name);
+        BOOST_CHECK(opened.config().format == PcmFormat::int24);
+        BOOST_CHECK(opened.config().channels == 3);
+        BOOST_CHECK(opened.config().rate == 44100);
+        BOOST_CHECK(opened.capture().capacity() == 384);
+        BOOST_CHECK(opened.info().sampleSize == 4);
+
+        BOOST_CHECK(created->capture().write(reinterpret_cast<const std::byte*>(frame), 1) == 1);
+        BOOST_CHECK(opened.capture().read(reinterpret_cast<std::byte*>(copy), 1) == 1);
+        BOOST_CHECK(std::equal(copy, copy + 3, frame));
+
+        opened.playback().countXrun();
+        BOOST_CHECK(created->playback().xruns() == 1);
+
+        opened.reportLatency(300);
+        opened.reportLatency(200);
+        BOOST_CHECK(created->latency() == 200);
+        BOOST_CHECK(created->maxLatency() == 300);
+
+        BOOST_CHECK(! opened.closed());
+        created->close();
+        BOOST_CHECK(opened.closed());
+    }
+
+    BOOST_CHECK_THROW(ShmDevice(name, ShmDeviceConfig()), RuntimeError);
+
+    // The segment goes away with the device that created it.
+    created.reset();
+    BOOST_CHECK_THROW(ShmDevice { name }, RuntimeError);
+}
+
+TEST_CASE(ShmRing_wait)
+{
+    ShmDevice device(deviceName("wait"), { PcmFormat::float32, 2, 48000, 64, 2 });
+    ShmDevice other(device.name());
+    auto& ring = device.playback();
+    const std::vector<float> period(128);
+
+    BOOST_CHECK(! ring.waitReadable(64, std::chrono::milliseconds(10)));
+    BOOST_CHECK(ring.waitWritable(128, std::chrono::milliseconds(10)));
+
+    std::thread writer([&]
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        other.playback().write(reinterpret_cast<const std::byte*>(period.data()), 32);
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        other.playback().write(reinterpret_cast<const std::byte*>(period.data()), 32);
+    });
+
+    BOOST_CHECK(ring.waitReadable(64, std::chrono::seconds(10)));
+    BOOST_CHECK(ring.readable() == 64);
+    writer.join();
+
+    ring.write(reinterpret_cast<const std::byte*>(period.data()), 64);
+    BOOST_CHECK(! ring.waitWritable(1, std::chrono::milliseconds(10)));
+}
+
+/*
+ * Run a source linked to a sink with the scheduler against a loopback device so the captured
+ * impulses are played back and measured.
+ */
+static void loopback(const PcmFormat in_format, const std::size_t in_channels)
+{
+    LoopbackDevice loopback(deviceName("loopback"), { in_format, in_channels, 48000, 2048, 4 });
+    auto& device = loopback.device();
+    auto source = ShmSourceObject::make();
+    auto sink = ShmSinkObject::make();
+
+    {
+        std::scoped_lock lock(*source, *sink);
+
+        source->configure({ { "Device", device.name() } });
+        sink->configure({ { "Device", device.name() } });
+        BOOST_CHECK(static_cast<PcmOutputPort&>(source->output("output")).config().blockSize == 2048);
+        linkPorts(source->output("output"), sink->input("input"));
+        startObject(source);
+        startObject(sink);
+    }
+
+    loopback.start();
+
+    BOOST_REQUIRE(waitUntil([&] { return device.maxLatency() != 0; }));
+
+    // Closing the device ends the stream.
+    loopback.stop();
+    BOOST_REQUIRE(waitUntil(*sink, [&] { return sink->state() == ObjectState::stopped; }));
+
+    std::scoped_lock lock(*source, *sink);
+
+    BOOST_CHECK(source->state() == ObjectState::stopped);
+    BOOST_CHECK(device.latency() >= 2048);
+    BOOST_CHECK(device.latency() < 4 * 2048);
+    BOOST_CHECK(source->property("Overruns").sizeValue() == device.capture().xruns());
+    BOOST_CHECK(sink->property("Underruns").sizeValue() == device.playback().xruns());
+}
+
+TEST_CASE(Shm_loopback)
+{
+    loopback(PcmFormat::float32, 2);
+    loopback(PcmFormat::int16, 1);
+    loopback(PcmFormat::int24, 8);
+}
+
+TEST_CASE(ShmSource_block_size)
+{
+    ShmDevice device(deviceName("block"), { PcmFormat::float32, 1, 48000, 64, 4 });
+    auto source = ShmSourceObject::make();
+    auto sink = TestObject::make();
+    std::scoped_lock lock(*source, *sink);
+    auto& input = sink->publicAddInput<PcmInputPort>("input");
+    const std::vector<float> frames { 1, 2, 3, 4, 5, 6, 7, 8, 9, 10 };
+
+    source->configure({ { "Device", device.name() }, { "Block Size", 4 } });
+    sink->configure();
+    linkPorts(source->output("output"), input);
+    source->start();
+    device.capture().write(reinterpret_cast<const std::byte*>(frames.data()), 10);
+
+    for (std::size_t block = 0; block < 2; block++)
+    {
+        source->schedule();
+        BOOST_CHECK(source->execute() == ObjectProcessResult::finished);
+        BOOST_CHECK(input.frames() == 4);
+        BOOST_CHECK(input.buffer().channel<float>(0)[0] == 1 + block * 4);
+        input.consume();
+    }
+
+    // The rest is delivered once the server closes the device.
+    device.close();
+    source->schedule();
+    BOOST_CHECK(source->execute() == ObjectProcessResult::finished);
+    BOOST_CHECK(input.frames() == 2);
+    BOOST_CHECK(input.buffer().channel<float>(0)[1] == 10);
+    input.consume();
+    source->schedule();
+    BOOST_CHECK(source->execute() == ObjectProcessResult::endOfData);
+}
@@ -0,0 +1,131 @@
+/* Copyright 2023 Tyler Riddle
+ *
+ * This file is part of Clypsalot. Clypsalot is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation, either version 3 of the License,
+ * or (at your option) any later version. Clypsalot is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with Clypsalot. If not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+
+#include <cstring>
+
+#include <clypsalot/transpose.hxx>
+
+#include "test/lib/test.hxx"
+
+using namespace Clypsalot;
+
+TEST_MAIN_FUNCTION
+
+static const auto levels = { SimdLevel::scalar, SimdLevel::sse2, SimdLevel::avx2 };
+
+// A distinct bit pattern for every sample so any misplaced sample is noticed.
+static std::int32_t pattern(const std::size_t in_channel, const std::size_t in_frame)
+{
+    return static_cast<std::int32_t>(in_channel * 100000 + in_frame + 1);
+}
+
+TEST_CASE(PcmBuffer_layout)
+{
+    PcmBuffer planar(PcmFormat::float32, 3, 10);
+    PcmBuffer grouped(PcmFormat::float32, 11, 10, PcmLayout::grouped8);
+
+    BOOST_CHECK(planar.layout() == PcmLayout::planar);
+    BOOST_CHECK(planar.lanes() == 1);
+    BOOST_CHECK(planar.groups() == 3);
+    BOOST_CHECK(grouped.lanes() == 8);
+    BOOST_CHECK(grouped.groups() == 2);
+    BOOST_CHECK(grouped.bytes() == PcmBuffer::storageBytes(PcmFormat::float32, 11, 10, PcmLayout::grouped8));
+    BOOST_CHECK(grouped.bytes() == 16 * grouped.stride() * sizeof(float));
+    BOOST_CHECK(grouped.group<float>(1) - grouped.group<float>(0) == static_cast<std::ptrdiff_t>(grouped.stride() * 8));
+    BOOST_CHECK(reinterpret_cast<std::uintptr_t>(grouped.group<float>(1)) % pcmAlignment == 0);
+    BOOST_CHECK(pcmSimdLayout(SimdLevel::avx2) == PcmLayout::grouped8);
+    BOOST_CHECK(pcmSimdLayout(SimdLevel::avx512) == PcmLayout::grouped8);
+    BOOST_CHECK(pcmSimdLayout(SimdLevel::scalar) == PcmLayout::planar);
+}
+
+TEST_CASE(PcmTransposer_round_trip)
+{
+    constexpr std::size_t frames = 37;
+
+    for (const auto channels : { 1, 4, 8, 11, 16 })
+    {
+        for (const auto layout : { PcmLayout::grouped4, PcmLayout::grouped8 })
+        {
+            for (const auto level : levels)
+            {
+                PcmTransposer pack(PcmFormat::int32, PcmLayout::planar, layout, level);
+                PcmTransposer unpack(PcmFormat::int32, layout, PcmLayout::planar, level);
+                PcmBuffer source(PcmFormat::int32, channels, frames);
+                PcmBuffer grouped(PcmFormat::int32, channels, frames, layout);
+                PcmBuffer dest(PcmFormat::int32, channels, frames);
+                const auto lanes = grouped.lanes();
+                bool placed = true;
+                bool padded = true;
+                bool restored = true;
+
+                for (std::size_t channel = 0; channel < std::size_t(channels); channel++)
+                {
+                    for (std::size_t frame = 0; frame < frames; frame++)
+                    {
+                        source.channel<std::int32_t>(channel)[frame] = pattern(channel, frame);
+                    }
+                }
+
+                // Garbage in the padding channels must be overwritten with zeros.
+                std::memset(grouped.group<std::int32_t>(0), 0xff, grouped.bytes());
+                pack.process(source, grouped, frames);
+                unpack.process(grouped, dest, frames);
+
+                for (std::size_t channel = 0; channel < grouped.groups() * lanes; channel++)
+                {
+                    const auto group = grouped.group<std::int32_t>(channel / lanes);
+
+                    for (std::size_t frame = 0; frame < frames; frame++)
+                    {
+                        const auto sample = group[frame * lanes + channel % lanes];
+
+                        if (channel >= std::size_t(channels))
+                        {
+                            padded = padded && sample == 0;
+                            continue;
+                        }
+
+                        placed = placed && sample == pattern(channel, frame);
+                        restored = restored && dest.channel<std::int32_t>(channel)[frame] == pattern(channel, frame);
+                    }
+                }
+
+                BOOST_CHECK(placed);
+                BOOST_CHECK(padded);
+                BOOST_CHECK(restored);
+            }
+        }
+    }
+}
+
+TEST_CASE(PcmTransposer_formats)
+{
+    constexpr std::size_t frames = 21;
+    PcmBuffer source(PcmFormat::int16, 5, frames, PcmLayout::grouped4);
+    PcmBuffer wide(PcmFormat::int16, 5, frames, PcmLayout::grouped8);
+    PcmBuffer dest(PcmFormat::int16, 5, frames);
+
+    for (std::size_t channel = 0; channel < 5; channel++)
+    {
+        for (std::size_t frame = 0; frame < frames; frame++)
+        {
+            source.group<std::int16_t>(channel / 4)[frame * 4 + channel % 4] = channel * 100 + frame;
+        }
+    }
+
+    PcmTransposer(PcmFormat::int16, PcmLayout::grouped4, PcmLayout::grouped8).process(source, wide, frames);
+    PcmTransposer(PcmFormat::int16, PcmLayout::grouped8, PcmLayout::planar).process(wide, dest, frames);
+
+    BOOST_CHECK(wide.group<std::int16_t>(0)[3 * 8 + 4] == 403);
+    BOOST_CHECK(dest.channel<std::int16_t>(2)[7] == 207);
+    BOOST_CHECK(dest.channel<std::int16_t>(4)[20] == 420);
+}